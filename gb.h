@@ -1,4 +1,4 @@
-/* gb.h - v0.26d - Ginger Bill's C Helper Library - public domain
+/* gb.h - v0.46  - Ginger Bill's C Helper Library - public domain
                  - no warranty implied; use at your own risk
 
 	This is a single header file with a bunch of useful stuff
@@ -58,6 +58,27 @@ TODOS
 	- More date & time functions
 
 VERSION HISTORY
+	0.46  - SIMD UTF-8 validation & counting, gb_utf8_to_utf16/gb_utf16_to_utf8 with error offsets
+	0.45a - Fix gb_scratch_allocator overlapping allocations, wrapping and freeing
+	0.45  - rdtsc profiler: per thread ring buffers, frame summaries & Chrome trace export
+	0.44  - Geometric gbString growth, gb_string_reserve, gb_string_make_in_buffer & gbStringInterner
+	0.43  - Shortest round trip float formatting, correctly rounded gb_str_to_f64, %e, gb_string_append_f64s
+	0.42  - gbFileWriter/gbFileReader buffered streams; gb_fprintf without a static buffer
+	0.41  - Parallel algorithms: gb_parallel_for/reduce, sums, prefix sums & gb_sort_parallel
+	0.40  - Radix sort: single counting pass, pairs, signed/float keys & parallel version
+	0.39  - pdqsort for gb_sort & GB_SORT_PROC_GEN typed sorts
+	0.38  - gbTrackingAllocator & gb_allocator_stats
+	0.37  - Virtual memory backed gbArena; gb_vm_reserve/commit/decommit/release
+	0.36  - TLSF mode for gbFreeList (default) & gb_free_list_stats
+	0.35  - gbCachedAllocator - Thread safe allocator with per-thread caches
+	0.34  - Lock-free gbSpscQueue & gbMpmcQueue; gbFastSemaphore & gb_futex_*; Spin lock backoff
+	0.33  - gbJobSystem; gbAffinity for Linux; Fix gb_thread_current_id on Linux x86-64 and gbMutex ownership
+	0.32  - gbAsyncFileQueue for asynchronous reads and writes
+	0.31  - gb_file_map/gb_file_unmap and mapped gb_file_read_contents
+	0.30  - Slicing-by-8/PCLMUL/ARMv8 CRCs, streaming hash states and gb_murmur64 tail fix
+	0.29  - SSE2/AVX2/NEON memory procs with runtime dispatch and gb_cpu_features
+	0.28  - Incremental rehashing for GB_TABLE and fix GB_TABLE rehash reading the wrong entries
+	0.27  - Open addressing hash table (GB_TABLE_OA)
 	0.26d - Minor changes to how gbFile works
 	0.26c - gb_str_to_f* fix
 	0.26b - Minor fixes
@@ -150,7 +171,7 @@ extern "C" {
 	#endif
 #endif
 
-#if defined(_WIN64) || defined(__x86_64__) || defined(_M_X64) || defined(__64BIT__) || defined(__powerpc64__) || defined(__ppc64__)
+#if defined(_WIN64) || defined(__x86_64__) || defined(_M_X64) || defined(__64BIT__) || defined(__powerpc64__) || defined(__ppc64__) || defined(__aarch64__)
 	#ifndef GB_ARCH_64_BIT
 	#define GB_ARCH_64_BIT 1
 	#endif
@@ -223,7 +244,7 @@ extern "C" {
 	#define GB_CACHE_LINE_SIZE 128
 	#endif
 
-#elif defined(__arm__)
+#elif defined(__arm__) || defined(__aarch64__)
 	#ifndef GB_CPU_ARM
 	#define GB_CPU_ARM 1
 	#endif
@@ -301,6 +322,10 @@ extern "C" {
 	#if !defined(GB_SYSTEM_OSX)
 		#include <sys/sendfile.h>
 	#endif
+	#if defined(GB_SYSTEM_LINUX)
+		#include <linux/futex.h>
+		#include <sys/syscall.h>
+	#endif
 	#include <sys/stat.h>
 	#include <sys/time.h>
 	#include <sys/types.h>
@@ -323,6 +348,32 @@ extern "C" {
 #include <semaphore.h>
 #endif
 
+// NOTE(bill): Define GB_NO_SIMD to only use the scalar code paths
+#if !defined(GB_NO_SIMD)
+	#if defined(GB_CPU_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+		#ifndef GB_SIMD_SSE2
+		#define GB_SIMD_SSE2 1
+		#endif
+		// NOTE(bill): AVX2 code is only ever called after checking gb_cpu_features()
+		#if defined(GB_COMPILER_MSVC) || defined(__clang__) || (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+			#ifndef GB_SIMD_AVX2
+			#define GB_SIMD_AVX2 1
+			#endif
+		#endif
+	#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+		#ifndef GB_SIMD_NEON
+		#define GB_SIMD_NEON 1
+		#endif
+	#endif
+#endif
+
+#if defined(GB_CPU_X86) && !defined(GB_COMPILER_MSVC)
+	#include <immintrin.h> // NOTE(bill): _mm_pause, _mm_mfence, etc. and the SIMD kernels
+#endif
+#if defined(GB_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
 
 ////////////////////////////////////////////////////////////////
 //
@@ -800,6 +851,33 @@ GB_DEF void        gb_memswap   (void *i, void *j, isize size);
 GB_DEF void const *gb_memchr    (void const *data, u8 byte_value, isize size);
 GB_DEF void const *gb_memrchr   (void const *data, u8 byte_value, isize size);
 
+// NOTE(bill): Size in bytes at which the x86 memcopy/memset switch to `rep movsb`/`rep stosb` (if ERMS is supported)
+#ifndef GB_MEMORY_REP_THRESHOLD
+#define GB_MEMORY_REP_THRESHOLD 2048
+#endif
+
+
+typedef enum gbCpuFeatureFlag {
+	gbCpuFeature_SSE2     = GB_BIT(0),
+	gbCpuFeature_SSE3     = GB_BIT(1),
+	gbCpuFeature_SSSE3    = GB_BIT(2),
+	gbCpuFeature_SSE41    = GB_BIT(3),
+	gbCpuFeature_SSE42    = GB_BIT(4),
+	gbCpuFeature_POPCNT   = GB_BIT(5),
+	gbCpuFeature_PCLMUL   = GB_BIT(6),
+	gbCpuFeature_AVX      = GB_BIT(7),
+	gbCpuFeature_AVX2     = GB_BIT(8),
+	gbCpuFeature_BMI2     = GB_BIT(9),
+	gbCpuFeature_ERMS     = GB_BIT(10), // NOTE(bill): Enhanced `rep movsb`/`rep stosb`
+
+	gbCpuFeature_NEON     = GB_BIT(16),
+	gbCpuFeature_ArmCRC32 = GB_BIT(17),
+} gbCpuFeatureFlag;
+
+// NOTE(bill): Detected on the first call (CPUID/hwcaps) and cached
+// The AVX flags are only set if the OS saves the YMM registers
+GB_DEF u32 gb_cpu_features(void);
+
 
 // NOTE(bill): Very similar to doing `*cast(T *)(&u)`
 #ifndef GB_BIT_CAST
@@ -852,7 +930,7 @@ GB_DEF i32  gb_atomic32_exchanged       (gbAtomic32 volatile *a, i32 desired);
 GB_DEF i32  gb_atomic32_fetch_add       (gbAtomic32 volatile *a, i32 operand);
 GB_DEF i32  gb_atomic32_fetch_and       (gbAtomic32 volatile *a, i32 operand);
 GB_DEF i32  gb_atomic32_fetch_or        (gbAtomic32 volatile *a, i32 operand);
-GB_DEF b32  gb_atomic32_spin_lock       (gbAtomic32 volatile *a, isize time_out); // NOTE(bill): time_out = -1 as default
+GB_DEF b32  gb_atomic32_spin_lock       (gbAtomic32 volatile *a, isize time_out); // NOTE(bill): time_out = -1 as default; Backs off exponentially
 GB_DEF void gb_atomic32_spin_unlock     (gbAtomic32 volatile *a);
 GB_DEF b32  gb_atomic32_try_acquire_lock(gbAtomic32 volatile *a);
 
@@ -905,6 +983,41 @@ GB_DEF void gb_semaphore_release(gbSemaphore *s); // NOTE(bill): gb_semaphore_po
 GB_DEF void gb_semaphore_wait   (gbSemaphore *s);
 
 
+// NOTE(bill): Futex - Wait on an address until it is woken and no longer equal to `expected`
+// Uses futex on Linux and WaitOnAddress on Windows 8+ (link with Synchronization.lib)
+#if defined(GB_SYSTEM_LINUX) || (defined(GB_SYSTEM_WINDOWS) && defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602))
+#define GB_HAS_FUTEX 1
+
+GB_DEF void gb_futex_wait     (gbAtomic32 volatile *a, i32 expected); // NOTE(bill): May wake spuriously
+GB_DEF void gb_futex_signal   (gbAtomic32 volatile *a);
+GB_DEF void gb_futex_broadcast(gbAtomic32 volatile *a);
+#endif
+
+
+// NOTE(bill): Fast Semaphore
+// Spins for a little while before it parks the thread, and only enters the kernel on post when
+// there is a thread parked. Parks on a futex where available, otherwise on a gbSemaphore.
+#ifndef GB_FAST_SEMAPHORE_SPIN_COUNT
+#define GB_FAST_SEMAPHORE_SPIN_COUNT 256
+#endif
+
+typedef struct gbFastSemaphore {
+	gbAtomic32  count; // NOTE(bill): When negative, it is the number of parked threads
+#if defined(GB_HAS_FUTEX)
+	gbAtomic32  wake_count;
+#else
+	gbSemaphore semaphore;
+#endif
+} gbFastSemaphore;
+
+GB_DEF void gb_fast_semaphore_init    (gbFastSemaphore *s);
+GB_DEF void gb_fast_semaphore_destroy (gbFastSemaphore *s);
+GB_DEF void gb_fast_semaphore_post    (gbFastSemaphore *s, i32 count);
+GB_DEF void gb_fast_semaphore_release (gbFastSemaphore *s); // NOTE(bill): gb_fast_semaphore_post(s, 1)
+GB_DEF void gb_fast_semaphore_wait    (gbFastSemaphore *s);
+GB_DEF b32  gb_fast_semaphore_try_wait(gbFastSemaphore *s);
+
+
 // Mutex
 // TODO(bill): Should this be replaced with a CRITICAL_SECTION on win32 or is the better?
 typedef struct gbMutex {
@@ -1004,7 +1117,17 @@ typedef struct gbAffinity {
 } gbAffinity;
 
 #elif defined(GB_SYSTEM_LINUX)
-#error TODO(bill): Implement gbAffinity for linux
+typedef struct gbAffinity {
+	b32   is_accurate;
+	isize core_count;
+	isize thread_count;
+	isize threads_per_core; // NOTE(bill): The most of any core
+
+	#define GB_LINUX_MAX_THREADS 256
+	u16   core_cpus[GB_LINUX_MAX_THREADS];
+	u16   core_first[GB_LINUX_MAX_THREADS+1];
+} gbAffinity;
+
 #else
 #error TODO(bill): Unknown system
 #endif
@@ -1017,6 +1140,7 @@ GB_DEF isize gb_affinity_thread_count_for_core(gbAffinity *a, isize core);
 
 
 
+
 ////////////////////////////////////////////////////////////////
 //
 // Virtual Memory
@@ -1035,6 +1159,13 @@ GB_DEF gbVirtualMemory gb_vm_trim       (gbVirtualMemory vm, isize lead_size, is
 GB_DEF b32             gb_vm_purge      (gbVirtualMemory vm);
 GB_DEF isize gb_virtual_memory_page_size(isize *alignment_out);
 
+// NOTE(bill): Reserve address space and commit it page by page. All the addresses and sizes given to
+// commit & decommit must be page aligned.
+GB_DEF gbVirtualMemory gb_vm_reserve (void *addr, isize size); // NOTE(bill): No access and no physical memory until committed, data is NULL on failure
+GB_DEF b32             gb_vm_commit  (gbVirtualMemory vm);     // NOTE(bill): Makes reserved pages readable & writable
+GB_DEF b32             gb_vm_decommit(gbVirtualMemory vm);     // NOTE(bill): Gives the pages back to the OS but keeps them reserved
+GB_DEF b32             gb_vm_release (gbVirtualMemory vm);     // NOTE(bill): Frees a whole reservation from gb_vm_reserve
+
 
 
 
@@ -1118,17 +1249,41 @@ GB_DEF GB_ALLOCATOR_PROC(gb_heap_allocator_proc);
 //
 // Arena Allocator
 //
+// NOTE(bill): A virtual arena reserves `total_size` bytes of address space up front and only commits the
+// pages as they are needed so it can be made large without using any more physical memory.
+// The pages stay committed up to a high water mark plus `commit_retain` bytes, so an arena which
+// is reset every frame or request does not decommit and commit its pages again each time.
+// When it shrinks (gb_temp_arena_memory_end & free all) the mark decays 1/GB_ARENA_COMMIT_DECAY of
+// the way towards what is in use, so the memory of an odd spike is given back over time.
+// Optional guard pages either side of it catch overruns.
+
+#ifndef GB_ARENA_COMMIT_SIZE
+#define GB_ARENA_COMMIT_SIZE (64*1024) // NOTE(bill): Granularity of commits, must be a multiple of the page size
+#endif
+
+#ifndef GB_ARENA_COMMIT_DECAY
+#define GB_ARENA_COMMIT_DECAY 64
+#endif
+
 typedef struct gbArena {
 	gbAllocator backing;
 	void *      physical_start;
-	isize       total_size;
+	isize       total_size; // NOTE(bill): The reserved size for a virtual arena
 	isize       total_allocated;
 	isize       temp_count;
+
+	// NOTE(bill): Virtual arenas only
+	gbVirtualMemory reservation; // NOTE(bill): Including the guard pages
+	isize           total_committed;
+	isize           commit_retain;
+	isize           commit_mark; // NOTE(bill): The decaying high water mark the pages are kept committed to
+	isize           high_water_mark;
 } gbArena;
 
 GB_DEF void gb_arena_init_from_memory   (gbArena *arena, void *start, isize size);
 GB_DEF void gb_arena_init_from_allocator(gbArena *arena, gbAllocator backing, isize size);
 GB_DEF void gb_arena_init_sub           (gbArena *arena, gbArena *parent_arena, isize size);
+GB_DEF b32  gb_arena_init_virtual       (gbArena *arena, isize reserve_size, b32 guard_pages);
 GB_DEF void gb_arena_free               (gbArena *arena);
 
 GB_DEF isize gb_arena_alignment_of  (gbArena *arena, isize alignment);
@@ -1202,10 +1357,20 @@ GB_DEF void                gb_allocation_header_fill(gbAllocationHeader *header,
 //
 
 // IMPORTANT TODO(bill): Thoroughly test the free list allocator!
-// NOTE(bill): This is a very shitty free list as it just picks the first free block not the best size
-// as I am just being lazy. Also, I will probably remove it later; it's only here because why not?!
+// NOTE(bill): There are two modes:
+//   gbFreeListMode_Tlsf     - Two-Level Segregated Fit. Free blocks are kept in lists by size class
+//                             with bitmaps of the non-empty lists so alloc and free are O(1). Free
+//                             blocks are coalesced with their neighbours using boundary tags.
+//                             The control structure (~4KiB on 32-bit, ~8KiB on 64-bit) lives at the
+//                             start of the memory region.
+//   gbFreeListMode_FirstFit - Picks the first free block which fits; alloc and free are O(free blocks)
 //
-// NOTE(bill): I may also complete remove this if I completely implement a fixed heap allocator
+// gb_free_list_init uses gbFreeListMode_Tlsf unless the region is too small for its control structure.
+
+typedef enum gbFreeListMode {
+	gbFreeListMode_Tlsf,
+	gbFreeListMode_FirstFit,
+} gbFreeListMode;
 
 typedef struct gbFreeListBlock gbFreeListBlock;
 struct gbFreeListBlock {
@@ -1216,15 +1381,29 @@ struct gbFreeListBlock {
 typedef struct gbFreeList {
 	void *           physical_start;
 	isize            total_size;
+	gbFreeListMode   mode;
 
-	gbFreeListBlock *curr_block;
+	gbFreeListBlock *curr_block;   // NOTE(bill): gbFreeListMode_FirstFit
+	void *           tlsf_control; // NOTE(bill): gbFreeListMode_Tlsf
 
 	isize            total_allocated;
 	isize            allocation_count;
 } gbFreeList;
 
+typedef struct gbFreeListStats {
+	isize total_free;
+	isize largest_free_block;
+	isize free_block_count;
+	isize total_allocated;
+	isize allocation_count;
+	f32   fragmentation; // NOTE(bill): 1 - largest_free_block/total_free, 0 when all the free memory is in one block
+} gbFreeListStats;
+
 GB_DEF void gb_free_list_init               (gbFreeList *fl, void *start, isize size);
 GB_DEF void gb_free_list_init_from_allocator(gbFreeList *fl, gbAllocator backing, isize size);
+GB_DEF void gb_free_list_init_mode          (gbFreeList *fl, void *start, isize size, gbFreeListMode mode);
+
+GB_DEF gbFreeListStats gb_free_list_stats(gbFreeList const *fl); // NOTE(bill): O(free blocks)
 
 // Allocation Types: alloc, free, free_all, resize
 GB_DEF gbAllocator gb_free_list_allocator(gbFreeList *fl);
@@ -1243,7 +1422,7 @@ typedef struct gbScratchMemory {
 	void *free_point;
 } gbScratchMemory;
 
-GB_DEF void gb_scratch_memory_init     (gbScratchMemory *s, void *start, isize size);
+GB_DEF void gb_scratch_memory_init     (gbScratchMemory *s, void *start, isize size); // NOTE(bill): Trims the buffer to gbAllocationHeader alignment
 GB_DEF b32  gb_scratch_memory_is_in_use(gbScratchMemory *s, void *ptr);
 
 
@@ -1256,6 +1435,236 @@ GB_DEF GB_ALLOCATOR_PROC(gb_scratch_allocator_proc);
 // TODO(bill): General heap allocator. Maybe a TCMalloc like clone?
 
 
+
+//
+// Cached Allocator - Thread Safe with Per-Thread Caches
+//
+// NOTE(bill): A general purpose allocator which may be shared between threads. Small allocations are
+// rounded up to one of the size classes and served from a per-thread cache without any locking.
+// A cache gets and returns blocks to the central pool of a size class in batches; the central pool
+// carves new blocks out of GB_CACHED_ALLOCATOR_SPAN_SIZE aligned spans. As the header of a span says
+// which size class it is, a block may be freed from any thread and it just goes to that thread's cache.
+// Large allocations (and alignments above 64) go straight to the backing allocator with a small header
+// in front of them. Frees tell the two apart with a table of the allocator's spans.
+//
+// The backing allocator is only ever called with a lock held so it need not be thread safe.
+// The memory of the spans is only given back with gb_cached_allocator_destroy.
+// NOTE(bill): Call gb_cached_allocator_flush_thread before a thread exits to return its cached blocks
+
+#ifndef GB_CACHED_ALLOCATOR_MAX_THREADS
+#define GB_CACHED_ALLOCATOR_MAX_THREADS 64
+#endif
+
+#ifndef GB_CACHED_ALLOCATOR_SPAN_SIZE
+#define GB_CACHED_ALLOCATOR_SPAN_SIZE 65536 // NOTE(bill): Must be a power of two
+#endif
+
+#ifndef GB_CACHED_ALLOCATOR_SPANS_PER_CHUNK
+#define GB_CACHED_ALLOCATOR_SPANS_PER_CHUNK 16
+#endif
+
+#ifndef GB_CACHED_ALLOCATOR_THREAD_SLOTS
+#define GB_CACHED_ALLOCATOR_THREAD_SLOTS 8 // NOTE(bill): Per thread, allocators sharing a slot take the slow path
+#endif
+
+#define GB_CACHED_ALLOCATOR_MAX_SMALL_SIZE 16384
+#define GB_CACHED_ALLOCATOR_CLASS_COUNT    36
+
+typedef struct gbCachedAllocatorBlock gbCachedAllocatorBlock;
+struct gbCachedAllocatorBlock {
+	gbCachedAllocatorBlock *next;
+	gbCachedAllocatorBlock *next_batch;
+};
+
+typedef struct gbCachedAllocatorBin {
+	gbCachedAllocatorBlock *head;
+	isize                   count;
+} gbCachedAllocatorBin;
+
+typedef struct gbCachedAllocatorCache {
+	gbCachedAllocatorBin bins[GB_CACHED_ALLOCATOR_CLASS_COUNT];
+	struct gbCachedAllocator *owner;
+	u64                       thread; // NOTE(bill): Unique for the life of the program, never a reused thread id
+} gbCachedAllocatorCache;
+
+typedef struct gbCachedAllocatorSpanTable gbCachedAllocatorSpanTable;
+
+typedef struct gbCachedAllocatorCentral {
+	gbAtomic32              lock;
+	gbCachedAllocatorBlock *batches;
+	u8 *                    span_cursor;
+	u8 *                    span_end;
+	u8                      padding[GB_CACHE_LINE_SIZE - 4*gb_size_of(void *)];
+} gbCachedAllocatorCentral;
+
+typedef struct gbCachedAllocator {
+	gbAllocator backing;
+	u64         id;   // NOTE(bill): Never reused so a stale thread slot can not match a newer allocator
+	gbAtomic32  lock; // NOTE(bill): Guards the backing allocator, the chunks, the span table and adding caches
+	void *      chunks;
+	gbAtomicPtr span_table;
+	u8 *        chunk_cursor;
+	u8 *        chunk_end;
+
+	gbCachedAllocatorCache *caches[GB_CACHED_ALLOCATOR_MAX_THREADS];
+	gbAtomic32              cache_count;
+
+	gbAtomic64  large_allocated; // NOTE(bill): Bytes
+	gbAtomic64  chunk_allocated; // NOTE(bill): Bytes
+
+	u16 class_sizes  [GB_CACHED_ALLOCATOR_CLASS_COUNT];
+	u16 class_batches[GB_CACHED_ALLOCATOR_CLASS_COUNT];
+	u8  class_lookup [GB_CACHED_ALLOCATOR_MAX_SMALL_SIZE/16 + 1];
+
+	gbCachedAllocatorCentral centrals[GB_CACHED_ALLOCATOR_CLASS_COUNT];
+} gbCachedAllocator;
+
+GB_DEF void gb_cached_allocator_init        (gbCachedAllocator *ca, gbAllocator backing);
+GB_DEF void gb_cached_allocator_destroy     (gbCachedAllocator *ca);
+GB_DEF void gb_cached_allocator_flush_thread(gbCachedAllocator *ca); // NOTE(bill): Returns the calling thread's cached blocks
+
+// Allocation Types: alloc, free, resize
+GB_DEF gbAllocator gb_cached_allocator(gbCachedAllocator *ca);
+GB_DEF GB_ALLOCATOR_PROC(gb_cached_allocator_proc);
+
+
+////////////////////////////////////////////////////////////////
+//
+// Lock-free Queues
+//
+// NOTE(bill): Bounded ring queues of fixed size elements; the capacity is rounded up to a power of two
+// Push and pop copy the element and return false if the queue is full or empty respectively.
+// The producer and consumer indices live on their own cache lines.
+//
+// gbSpscQueue - Single Producer, Single Consumer
+// gbMpmcQueue - Multiple Producer, Multiple Consumer (Dmitry Vyukov's bounded queue where every
+//               cell has a sequence number)
+//
+
+typedef struct gbSpscQueue {
+	u8 *        buffer;
+	isize       element_size;
+	i64         mask;
+	gbAllocator allocator;
+	u8          padding0[GB_CACHE_LINE_SIZE];
+
+	gbAtomic64  head;        // NOTE(bill): Written by the consumer
+	i64         cached_tail; // NOTE(bill): The consumer's copy of tail
+	u8          padding1[GB_CACHE_LINE_SIZE - 2*gb_size_of(i64)];
+
+	gbAtomic64  tail;        // NOTE(bill): Written by the producer
+	i64         cached_head; // NOTE(bill): The producer's copy of head
+	u8          padding2[GB_CACHE_LINE_SIZE - 2*gb_size_of(i64)];
+} gbSpscQueue;
+
+GB_DEF void  gb_spsc_queue_init   (gbSpscQueue *q, gbAllocator a, isize capacity, isize element_size);
+GB_DEF void  gb_spsc_queue_destroy(gbSpscQueue *q);
+GB_DEF b32   gb_spsc_queue_push   (gbSpscQueue *q, void const *element);
+GB_DEF b32   gb_spsc_queue_pop    (gbSpscQueue *q, void *element);
+GB_DEF isize gb_spsc_queue_count  (gbSpscQueue *q); // NOTE(bill): Only approximate when called by neither end
+
+
+typedef struct gbMpmcQueue {
+	u8 *        cells;
+	isize       cell_size;
+	isize       element_size;
+	i64         mask;
+	gbAllocator allocator;
+	u8          padding0[GB_CACHE_LINE_SIZE];
+
+	gbAtomic64  head;
+	u8          padding1[GB_CACHE_LINE_SIZE - gb_size_of(i64)];
+
+	gbAtomic64  tail;
+	u8          padding2[GB_CACHE_LINE_SIZE - gb_size_of(i64)];
+} gbMpmcQueue;
+
+GB_DEF void  gb_mpmc_queue_init   (gbMpmcQueue *q, gbAllocator a, isize capacity, isize element_size);
+GB_DEF void  gb_mpmc_queue_destroy(gbMpmcQueue *q);
+GB_DEF b32   gb_mpmc_queue_push   (gbMpmcQueue *q, void const *element);
+GB_DEF b32   gb_mpmc_queue_pop    (gbMpmcQueue *q, void *element);
+GB_DEF isize gb_mpmc_queue_count  (gbMpmcQueue *q); // NOTE(bill): Approximate
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Job System
+//
+// NOTE(bill): Work-stealing job system
+// Every worker thread (and the thread which calls gb_job_system_init, which is worker 0) owns a
+// Chase-Lev deque. Jobs are pushed to and popped from the bottom of the current thread's deque
+// and idle workers steal from the top of the others. Each worker is pinned to its own core.
+//
+// A gbJobCounter is the number of unfinished jobs attached to it. It is how dependencies are
+// expressed: gb_job_system_wait runs other jobs until the counter reaches zero, so it may be
+// called from within a job too. Jobs may only be submitted from threads of the job system.
+//
+// NOTE(bill): A job which cannot be pushed because the deque is full is run immediately
+
+#ifndef GB_JOB_DEQUE_SIZE
+#define GB_JOB_DEQUE_SIZE 4096 // NOTE(bill): Must be a power of two
+#endif
+
+#ifndef GB_JOB_MAX_WORKERS
+#define GB_JOB_MAX_WORKERS 64
+#endif
+
+#define GB_JOB_PROC(name) void name(void *data)
+typedef GB_JOB_PROC(gbJobProc);
+
+typedef struct gbJobCounter {
+	gbAtomic32 count;
+} gbJobCounter;
+
+typedef struct gbJob {
+	gbJobProc *   proc;
+	void *        data;
+	gbJobCounter *counter;
+} gbJob;
+
+typedef struct gbJobDeque {
+	gbAtomic64 top; // NOTE(bill): Stolen from by the other workers
+	u8         top_padding[GB_CACHE_LINE_SIZE - gb_size_of(gbAtomic64)];
+	gbAtomic64 bottom; // NOTE(bill): Only written by its owner
+	u8         bottom_padding[GB_CACHE_LINE_SIZE - gb_size_of(gbAtomic64)];
+	gbJob      jobs[GB_JOB_DEQUE_SIZE];
+} gbJobDeque;
+
+typedef struct gbJobSystem gbJobSystem;
+
+typedef struct gbJobWorker {
+	gbJobSystem *system;
+	gbJobDeque * deque;
+	isize        index;
+	u32          steal_seed;
+	gbThread     thread;
+} gbJobWorker;
+
+struct gbJobSystem {
+	gbAllocator allocator;
+	gbAffinity  affinity;
+	gbJobWorker workers[GB_JOB_MAX_WORKERS];
+	isize       worker_count;
+
+	gbMutex         sleep_mutex;
+	gbFastSemaphore sleep_semaphore;
+	gbAtomic32  sleeping_count;
+	gbAtomic32  is_running;
+};
+
+// NOTE(bill): worker_count <= 0 uses one worker per core
+GB_DEF void  gb_job_system_init        (gbJobSystem *js, isize worker_count, gbAllocator a);
+GB_DEF void  gb_job_system_destroy     (gbJobSystem *js);
+GB_DEF isize gb_job_system_worker_index(gbJobSystem *js); // NOTE(bill): -1 if not a worker of this job system
+
+GB_DEF void  gb_job_system_run         (gbJobSystem *js, gbJobProc *proc, void *data, gbJobCounter *counter); // NOTE(bill): counter may be NULL
+GB_DEF void  gb_job_system_run_jobs    (gbJobSystem *js, gbJob *jobs, isize job_count, gbJobCounter *counter);
+GB_DEF void  gb_job_system_wait        (gbJobSystem *js, gbJobCounter *counter);
+GB_DEF b32   gb_job_system_try_run_one (gbJobSystem *js); // NOTE(bill): Runs a single pending job, if any
+
+
+
 ////////////////////////////////////////////////////////////////
 //
 // Sort & Search
@@ -1281,19 +1690,230 @@ GB_DEF GB_COMPARE_PROC_PTR(gb_f32_cmp  (isize offset));
 GB_DEF GB_COMPARE_PROC_PTR(gb_f64_cmp  (isize offset));
 GB_DEF GB_COMPARE_PROC_PTR(gb_char_cmp (isize offset));
 
-// TODO(bill): Better sorting algorithms
-// NOTE(bill): Uses quick sort for large arrays but insertion sort for small
+// NOTE(bill): Pattern-defeating quick sort (pdqsort): insertion sort for small ranges, a heap sort
+// fallback when partitions keep going bad (never quadratic) and linear time on sorted input.
+// It is not stable.
 #define gb_sort_array(array, count, compare_proc) gb_sort(array, count, gb_size_of(*(array)), compare_proc)
 GB_DEF void gb_sort(void *base, isize count, isize size, gbCompareProc compare_proc);
 
-// NOTE(bill): the count of temp == count of items
-#define gb_radix_sort(Type) gb_radix_sort_##Type
-#define GB_RADIX_SORT_PROC(Type) void gb_radix_sort(Type)(Type *items, Type *temp, isize count)
+// NOTE(bill): Typed sorts without the callback, the comparison is inlined and the items are moved
+// by value. `less` is a function-like macro (or procedure) returning a < b.
+// Generate it in one translation unit and declare it with GB_SORT_PROC elsewhere e.g.
+//
+//	#define thing_less(a, b) ((a).key < (b).key)
+//	GB_SORT_PROC_GEN(sort_things, Thing, thing_less);
+//	sort_things(things, count);
+//
+#define GB_SORT_PROC(name, Type) void name(Type *items, isize count)
+#define GB_SORT_LESS(a, b) ((a) < (b))
 
-GB_DEF GB_RADIX_SORT_PROC(u8);
-GB_DEF GB_RADIX_SORT_PROC(u16);
-GB_DEF GB_RADIX_SORT_PROC(u32);
-GB_DEF GB_RADIX_SORT_PROC(u64);
+#ifndef GB_SORT_INSERTION_THRESHOLD
+#define GB_SORT_INSERTION_THRESHOLD 24
+#endif
+#define GB_SORT_NINTHER_THRESHOLD       128
+#define GB_SORT_PARTIAL_INSERTION_LIMIT 8
+
+GB_DEF GB_SORT_PROC(gb_sort_i32,   i32);
+GB_DEF GB_SORT_PROC(gb_sort_i64,   i64);
+GB_DEF GB_SORT_PROC(gb_sort_u32,   u32);
+GB_DEF GB_SORT_PROC(gb_sort_u64,   u64);
+GB_DEF GB_SORT_PROC(gb_sort_isize, isize);
+GB_DEF GB_SORT_PROC(gb_sort_f32,   f32);
+GB_DEF GB_SORT_PROC(gb_sort_f64,   f64);
+
+#define GB_SORT_PROC_GEN(name, Type, less) \
+gb_internal void name##__insertion_sort(Type *items, isize count) { \
+	isize i, j; \
+	for (i = 1; i < count; i++) { \
+		Type value = items[i]; \
+		for (j = i; j > 0 && less(value, items[j-1]); j--) \
+			items[j] = items[j-1]; \
+		items[j] = value; \
+	} \
+} \
+gb_internal b32 name##__partial_insertion_sort(Type *items, isize count) { \
+	isize i, j, moved = 0; \
+	for (i = 1; i < count; i++) { \
+		if (less(items[i], items[i-1])) { \
+			Type value = items[i]; \
+			j = i; \
+			do { items[j] = items[j-1]; j--; } while (j > 0 && less(value, items[j-1])); \
+			items[j] = value; \
+			moved += i-j; \
+			if (moved > GB_SORT_PARTIAL_INSERTION_LIMIT) \
+				return false; \
+		} \
+	} \
+	return true; \
+} \
+gb_internal void name##__sift_down(Type *items, isize i, isize count) { \
+	Type value = items[i]; \
+	for (;;) { \
+		isize child = 2*i + 1; \
+		if (child >= count) break; \
+		if (child+1 < count && less(items[child], items[child+1])) child++; \
+		if (!less(value, items[child])) break; \
+		items[i] = items[child]; \
+		i = child; \
+	} \
+	items[i] = value; \
+} \
+gb_internal void name##__heap_sort(Type *items, isize count) { \
+	isize i; \
+	for (i = count/2; i-- > 0; ) \
+		name##__sift_down(items, i, count); \
+	for (i = count-1; i > 0; i--) { \
+		gb_swap(Type, items[0], items[i]); \
+		name##__sift_down(items, 0, i); \
+	} \
+} \
+gb_internal void name##__sort3(Type *items, isize i, isize j, isize k) { \
+	if (less(items[j], items[i])) gb_swap(Type, items[i], items[j]); \
+	if (less(items[k], items[j])) { \
+		gb_swap(Type, items[j], items[k]); \
+		if (less(items[j], items[i])) gb_swap(Type, items[i], items[j]); \
+	} \
+} \
+gb_internal isize name##__partition_right(Type *items, isize count, b32 *already_partitioned) { \
+	Type pivot = items[0]; \
+	isize first = 0, last = count; \
+	while (less(items[++first], pivot)) {} \
+	if (first == 1) { \
+		while (first < last && !less(items[--last], pivot)) {} \
+	} else { \
+		while (!less(items[--last], pivot)) {} \
+	} \
+	*already_partitioned = first >= last; \
+	while (first < last) { \
+		gb_swap(Type, items[first], items[last]); \
+		while (less(items[++first], pivot)) {} \
+		while (!less(items[--last], pivot)) {} \
+	} \
+	items[0] = items[first-1]; \
+	items[first-1] = pivot; \
+	return first-1; \
+} \
+gb_internal isize name##__partition_left(Type *items, isize count) { \
+	Type pivot = items[0]; \
+	isize first = 0, last = count; \
+	while (less(pivot, items[--last])) {} \
+	if (last+1 == count) { \
+		while (first < last && !less(pivot, items[++first])) {} \
+	} else { \
+		while (!less(pivot, items[++first])) {} \
+	} \
+	while (first < last) { \
+		gb_swap(Type, items[first], items[last]); \
+		while (less(pivot, items[--last])) {} \
+		while (!less(pivot, items[++first])) {} \
+	} \
+	items[0] = items[last]; \
+	items[last] = pivot; \
+	return last; \
+} \
+gb_internal void name##__loop(Type *items, isize count, isize bad_allowed, b32 leftmost) { \
+	for (;;) { \
+		isize half, pivot, left_count, right_count; \
+		b32 already_partitioned = false; \
+		if (count < GB_SORT_INSERTION_THRESHOLD) { \
+			name##__insertion_sort(items, count); \
+			return; \
+		} \
+		half = count/2; \
+		if (count > GB_SORT_NINTHER_THRESHOLD) { \
+			name##__sort3(items, 0, half, count-1); \
+			name##__sort3(items, 1, half-1, count-2); \
+			name##__sort3(items, 2, half+1, count-3); \
+			name##__sort3(items, half-1, half, half+1); \
+			gb_swap(Type, items[0], items[half]); \
+		} else { \
+			name##__sort3(items, half, 0, count-1); \
+		} \
+		if (!leftmost && !less(items[-1], items[0])) { \
+			pivot = name##__partition_left(items, count); \
+			items += pivot+1; \
+			count -= pivot+1; \
+			continue; \
+		} \
+		pivot = name##__partition_right(items, count, &already_partitioned); \
+		left_count  = pivot; \
+		right_count = count - pivot - 1; \
+		if (left_count < count/8 || right_count < count/8) { \
+			if (--bad_allowed == 0) { \
+				name##__heap_sort(items, count); \
+				return; \
+			} \
+			if (left_count >= GB_SORT_INSERTION_THRESHOLD) { \
+				gb_swap(Type, items[0], items[left_count/4]); \
+				gb_swap(Type, items[pivot-1], items[pivot-left_count/4]); \
+			} \
+			if (right_count >= GB_SORT_INSERTION_THRESHOLD) { \
+				gb_swap(Type, items[pivot+1], items[pivot+1+right_count/4]); \
+				gb_swap(Type, items[count-1], items[count-right_count/4]); \
+			} \
+		} else if (already_partitioned && \
+		           name##__partial_insertion_sort(items, left_count) && \
+		           name##__partial_insertion_sort(items+pivot+1, right_count)) { \
+			return; \
+		} \
+		name##__loop(items, left_count, bad_allowed, leftmost); \
+		items += pivot+1; \
+		count = right_count; \
+		leftmost = false; \
+	} \
+} \
+GB_SORT_PROC(name, Type) { \
+	isize bad_allowed = 1; \
+	while ((cast(isize)1 << bad_allowed) < count) bad_allowed++; \
+	name##__loop(items, count, bad_allowed, true); \
+}
+
+
+// NOTE(bill): LSD radix sorts, the count of temp == count of items and the result is in items
+// Every digit histogram is counted in one pass and passes where all the items share the digit are
+// skipped. Signed and floating point keys are flipped to sort as unsigned integers (-0 < +0).
+// The pairs version moves a u32 value (e.g. an index) along with each key, it is stable.
+// The parallel version splits the passes across the job system, it must be called from one of
+// its threads. values/temp_values may be NULL. Small counts are sorted on the calling thread.
+#define gb_radix_sort(Type)          gb_radix_sort_##Type
+#define gb_radix_sort_pairs(Type)    gb_radix_sort_pairs_##Type
+#define gb_radix_sort_parallel(Type) gb_radix_sort_parallel_##Type
+#define GB_RADIX_SORT_PROC(Type)          void gb_radix_sort(Type)(Type *items, Type *temp, isize count)
+#define GB_RADIX_SORT_PAIRS_PROC(Type)    void gb_radix_sort_pairs(Type)(Type *keys, u32 *values, Type *temp_keys, u32 *temp_values, isize count)
+#define GB_RADIX_SORT_PARALLEL_PROC(Type) void gb_radix_sort_parallel(Type)(gbJobSystem *js, Type *items, Type *temp, u32 *values, u32 *temp_values, isize count)
+
+#ifndef GB_RADIX_SORT_PARALLEL_THRESHOLD
+#define GB_RADIX_SORT_PARALLEL_THRESHOLD 65536
+#endif
+#define GB_RADIX_SORT_MAX_JOBS 16
+
+#define GB__RADIX_SORT_DECLS(Type) \
+	GB_DEF GB_RADIX_SORT_PROC(Type); \
+	GB_DEF GB_RADIX_SORT_PAIRS_PROC(Type); \
+	GB_DEF GB_RADIX_SORT_PARALLEL_PROC(Type)
+
+GB__RADIX_SORT_DECLS(u8);
+GB__RADIX_SORT_DECLS(u16);
+GB__RADIX_SORT_DECLS(u32);
+GB__RADIX_SORT_DECLS(u64);
+GB__RADIX_SORT_DECLS(i8);
+GB__RADIX_SORT_DECLS(i16);
+GB__RADIX_SORT_DECLS(i32);
+GB__RADIX_SORT_DECLS(i64);
+GB__RADIX_SORT_DECLS(f32);
+GB__RADIX_SORT_DECLS(f64);
+
+// NOTE(bill): Defines gb_radix_sort(Type) for any other unsigned integer type (e.g. usize) by
+// sorting it as the built in unsigned type of the same size
+#define GB_RADIX_SORT_PROC_GEN(Type) GB_RADIX_SORT_PROC(Type) { \
+	switch (gb_size_of(Type)) { \
+	case 1: gb_radix_sort(u8) (cast(u8  *)items, cast(u8  *)temp, count); break; \
+	case 2: gb_radix_sort(u16)(cast(u16 *)items, cast(u16 *)temp, count); break; \
+	case 4: gb_radix_sort(u32)(cast(u32 *)items, cast(u32 *)temp, count); break; \
+	case 8: gb_radix_sort(u64)(cast(u64 *)items, cast(u64 *)temp, count); break; \
+	default: GB_PANIC("GB_RADIX_SORT_PROC_GEN: Unsupported type size %td", gb_size_of(Type)); \
+	} \
+}
 
 
 // NOTE(bill): Returns index or -1 if not found
@@ -1306,6 +1926,71 @@ GB_DEF void gb_shuffle(void *base, isize count, isize size);
 #define gb_reverse_array(array, count) gb_reverse(array, count, gb_size_of(*(array)))
 GB_DEF void gb_reverse(void *base, isize count, isize size);
 
+
+
+////////////////////////////////////////////////////////////////
+//
+// Parallel Algorithms
+//
+// NOTE(bill): Bulk operations over index ranges on a gbJobSystem. They must be called from one
+// of its threads and the calling thread helps until they are done. They work on plain pointers
+// so a gbArray(Type) or gbBuffer(Type) is passed as is, with gb_array_count/gb_buffer_count.
+// Small ranges (or a single worker) just run on the calling thread.
+//
+
+#ifndef GB_PARALLEL_MAX_CHUNKS
+#define GB_PARALLEL_MAX_CHUNKS 256
+#endif
+#ifndef GB_PARALLEL_MIN_CHUNK_SIZE
+#define GB_PARALLEL_MIN_CHUNK_SIZE 8192 // NOTE(bill): Items per chunk for the sums/scans
+#endif
+#ifndef GB_PARALLEL_SORT_THRESHOLD
+#define GB_PARALLEL_SORT_THRESHOLD 16384
+#endif
+
+#define GB_PARALLEL_FOR_PROC(name) void name(void *data, isize start, isize end)
+typedef GB_PARALLEL_FOR_PROC(gbParallelForProc);
+
+// NOTE(bill): Calls proc on [start, end) in pieces of grain_size, each piece is claimed by
+// whichever worker is free so uneven work balances out. grain_size <= 0 picks one.
+GB_DEF void gb_parallel_for(gbJobSystem *js, isize start, isize end, isize grain_size, gbParallelForProc *proc, void *data);
+
+// NOTE(bill): reduce_proc folds [start, end) into partial (result_size bytes) and combine_proc folds
+// other into result. result must hold the identity (e.g. 0 for a sum) on entry; the partials start
+// as a copy of it and are combined in order so the result is deterministic.
+#define GB_PARALLEL_REDUCE_PROC(name)  void name(void *data, isize start, isize end, void *partial)
+#define GB_PARALLEL_COMBINE_PROC(name) void name(void *data, void *result, void const *other)
+typedef GB_PARALLEL_REDUCE_PROC(gbParallelReduceProc);
+typedef GB_PARALLEL_COMBINE_PROC(gbParallelCombineProc);
+
+GB_DEF void gb_parallel_reduce(gbJobSystem *js, isize start, isize end, isize grain_size,
+                               void *result, isize result_size,
+                               gbParallelReduceProc *reduce_proc, gbParallelCombineProc *combine_proc, void *data);
+
+// NOTE(bill): The prefix sum is in place and returns the total
+#define gb_parallel_sum(Type)        gb_parallel_sum_##Type
+#define gb_parallel_prefix_sum(Type) gb_parallel_prefix_sum_##Type
+#define GB_PARALLEL_SUM_PROC(Type)        Type gb_parallel_sum(Type)(gbJobSystem *js, Type const *items, isize count)
+#define GB_PARALLEL_PREFIX_SUM_PROC(Type) Type gb_parallel_prefix_sum(Type)(gbJobSystem *js, Type *items, isize count, b32 exclusive)
+
+#define GB__PARALLEL_SUM_DECLS(Type) \
+	GB_DEF GB_PARALLEL_SUM_PROC(Type); \
+	GB_DEF GB_PARALLEL_PREFIX_SUM_PROC(Type)
+
+GB__PARALLEL_SUM_DECLS(i32);
+GB__PARALLEL_SUM_DECLS(i64);
+GB__PARALLEL_SUM_DECLS(u32);
+GB__PARALLEL_SUM_DECLS(u64);
+GB__PARALLEL_SUM_DECLS(isize);
+GB__PARALLEL_SUM_DECLS(f32);
+GB__PARALLEL_SUM_DECLS(f64);
+
+// NOTE(bill): Sample sort, the items are split into buckets by sampled splitters and the buckets
+// are sorted with gb_sort in parallel. It needs count*(size+1) bytes from the job system's allocator.
+// Like gb_sort, it is not stable.
+#define gb_sort_array_parallel(js, array, count, compare_proc) gb_sort_parallel(js, array, count, gb_size_of(*(array)), compare_proc)
+GB_DEF void gb_sort_parallel(gbJobSystem *js, void *base, isize count, isize size, gbCompareProc compare_proc);
+
 ////////////////////////////////////////////////////////////////
 //
 // Char Functions
@@ -1355,6 +2040,12 @@ GB_DEF f64   gb_str_to_f64(char const *str, char **end_ptr);
 GB_DEF void  gb_i64_to_str(i64 value, char *string, i32 base);
 GB_DEF void  gb_u64_to_str(u64 value, char *string, i32 base);
 
+// NOTE(bill): The shortest form which reads back as the same value, 1e-4 <= |x| < 1e17 in fixed
+// notation and exponent notation otherwise. Returns the length, `string` needs GB_FLOAT_STR_MAX bytes
+#define GB_FLOAT_STR_MAX 32
+GB_DEF isize gb_f64_to_str(f64 value, char *string);
+GB_DEF isize gb_f32_to_str(f32 value, char *string);
+
 
 ////////////////////////////////////////////////////////////////
 //
@@ -1362,10 +2053,22 @@ GB_DEF void  gb_u64_to_str(u64 value, char *string, i32 base);
 //
 //
 
-// NOTE(bill): Does not check if utf-8 string is valid
+// NOTE(bill): Number of codepoints, -1 if the string is not valid utf-8
 GB_DEF isize gb_utf8_strlen (u8 const *str);
 GB_DEF isize gb_utf8_strnlen(u8 const *str, isize max_len);
 
+// NOTE(bill): Returns the offset of the first byte of the first invalid sequence (overlong, surrogate,
+// > GB_RUNE_MAX, stray continuation or cut short by `len`), `len` if all of `str` is valid
+GB_DEF isize gb_utf8_validate(u8 const *str, isize len);
+// NOTE(bill): Number of codepoints in `len` bytes, does not check if utf-8 string is valid
+GB_DEF isize gb_utf8_count   (u8 const *str, isize len);
+
+// NOTE(bill): UTF-16 with surrogate pairs, no terminating zero is read or written. Returns the number
+// of code units written or -1 if the input is invalid or `out` is too small, in which case
+// `error_offset` (if not NULL) is set to the offset of the first code unit which was not converted
+GB_DEF isize gb_utf8_to_utf16(u16 *out, isize out_len, u8 const *str, isize len, isize *error_offset);
+GB_DEF isize gb_utf16_to_utf8(u8 *out, isize out_len, u16 const *str, isize len, isize *error_offset);
+
 // NOTE(bill): Windows doesn't handle 8 bit filenames well ('cause Micro$hit)
 GB_DEF u16 *gb_utf8_to_ucs2    (u16 *buffer, isize len, u8 const *str);
 GB_DEF u8 * gb_ucs2_to_utf8    (u8 *buffer, isize len, u16 const *str);
@@ -1480,12 +2183,21 @@ typedef struct gbStringHeader {
 	gbAllocator allocator;
 	isize       length;
 	isize       capacity;
+	b32         in_buffer; // NOTE(bill): The memory is the buffer given to gb_string_make_in_buffer and is not freed
 } gbStringHeader;
 
 #define GB_STRING_HEADER(str) (cast(gbStringHeader *)(str) - 1)
 
+// NOTE(bill): The capacity to grow to when appending, the string is never grown by less than it needs
+#ifndef GB_STRING_GROW_FORMULA
+#define GB_STRING_GROW_FORMULA(x) (2*(x) + 8)
+#endif
+
 GB_DEF gbString gb_string_make           (gbAllocator a, char const *str);
 GB_DEF gbString gb_string_make_length    (gbAllocator a, void const *str, isize num_bytes);
+// NOTE(bill): The string starts in `buffer` (e.g. on the stack) and only allocates from `a` once it
+// outgrows it. If it does not fit to begin with, it is the same as gb_string_make
+GB_DEF gbString gb_string_make_in_buffer (gbAllocator a, void *buffer, isize buffer_size, char const *str);
 GB_DEF void     gb_string_free           (gbString str);
 GB_DEF gbString gb_string_duplicate      (gbAllocator a, gbString const str);
 GB_DEF isize    gb_string_length         (gbString const str);
@@ -1496,12 +2208,18 @@ GB_DEF gbString gb_string_append         (gbString str, gbString const other);
 GB_DEF gbString gb_string_append_length  (gbString str, void const *other, isize num_bytes);
 GB_DEF gbString gb_string_appendc        (gbString str, char const *other);
 GB_DEF gbString gb_string_set            (gbString str, char const *cstr);
-GB_DEF gbString gb_string_make_space_for (gbString str, isize add_len);
+GB_DEF gbString gb_string_make_space_for (gbString str, isize add_len); // NOTE(bill): Grows by GB_STRING_GROW_FORMULA
+GB_DEF gbString gb_string_reserve        (gbString str, isize capacity); // NOTE(bill): Grows to exactly `capacity`
 GB_DEF isize    gb_string_allocation_size(gbString const str);
 GB_DEF b32      gb_string_are_equal      (gbString const lhs, gbString const rhs);
 GB_DEF gbString gb_string_trim           (gbString str, char const *cut_set);
 GB_DEF gbString gb_string_trim_space     (gbString str); // Whitespace ` \t\r\n\v\f`
 
+// NOTE(bill): Appends each value in its shortest form (see gb_f64_to_str) with `separator` (may be NULL)
+// between them
+GB_DEF gbString gb_string_append_f64s    (gbString str, f64 const *values, isize count, char const *separator);
+GB_DEF gbString gb_string_append_f32s    (gbString str, f32 const *values, isize count, char const *separator);
+
 
 
 ////////////////////////////////////////////////////////////////
@@ -1732,6 +2450,68 @@ GB_EXTERN u32 gb_murmur32_seed(void const *data, isize len, u32 seed);
 GB_EXTERN u64 gb_murmur64_seed(void const *data, isize len, u64 seed);
 
 
+// NOTE(bill): Streaming versions for hashing data in chunks (e.g. as a file is read)
+// `*_final` gives the same result as hashing all the data at once with the procedures above
+// The FNV states are shared by the normal and `a` variants but do not mix the two
+//
+// IMPORTANT NOTE(bill): murmur64 mixes the length in first so the total length must be known up front
+
+typedef struct gbAdler32  { u32 a, b; }   gbAdler32;
+typedef struct gbCrc32    { u32 state; }  gbCrc32;
+typedef struct gbCrc64    { u64 state; }  gbCrc64;
+typedef struct gbFnv32    { u32 hash; }   gbFnv32;
+typedef struct gbFnv64    { u64 hash; }   gbFnv64;
+
+typedef struct gbMurmur32 {
+	u32   hash;
+	u8    tail[4];
+	isize tail_len;
+	isize len;
+} gbMurmur32;
+
+typedef struct gbMurmur64 {
+#if defined(GB_ARCH_64_BIT)
+	u64   hash;
+#else
+	u32   h1, h2;
+#endif
+	u8    tail[8];
+	isize tail_len;
+	isize len;
+	isize total_len;
+} gbMurmur64;
+
+GB_EXTERN void gb_adler32_init  (gbAdler32 *s);
+GB_EXTERN void gb_adler32_update(gbAdler32 *s, void const *data, isize len);
+GB_EXTERN u32  gb_adler32_final (gbAdler32 *s);
+
+GB_EXTERN void gb_crc32_init  (gbCrc32 *s);
+GB_EXTERN void gb_crc32_update(gbCrc32 *s, void const *data, isize len);
+GB_EXTERN u32  gb_crc32_final (gbCrc32 *s);
+
+GB_EXTERN void gb_crc64_init  (gbCrc64 *s);
+GB_EXTERN void gb_crc64_update(gbCrc64 *s, void const *data, isize len);
+GB_EXTERN u64  gb_crc64_final (gbCrc64 *s);
+
+GB_EXTERN void gb_fnv32_init   (gbFnv32 *s);
+GB_EXTERN void gb_fnv32_update (gbFnv32 *s, void const *data, isize len);
+GB_EXTERN void gb_fnv32a_update(gbFnv32 *s, void const *data, isize len);
+GB_EXTERN u32  gb_fnv32_final  (gbFnv32 *s);
+
+GB_EXTERN void gb_fnv64_init   (gbFnv64 *s);
+GB_EXTERN void gb_fnv64_update (gbFnv64 *s, void const *data, isize len);
+GB_EXTERN void gb_fnv64a_update(gbFnv64 *s, void const *data, isize len);
+GB_EXTERN u64  gb_fnv64_final  (gbFnv64 *s);
+
+GB_EXTERN void gb_murmur32_init  (gbMurmur32 *s, u32 seed);
+GB_EXTERN void gb_murmur32_update(gbMurmur32 *s, void const *data, isize len);
+GB_EXTERN u32  gb_murmur32_final (gbMurmur32 *s);
+
+GB_EXTERN void gb_murmur64_init  (gbMurmur64 *s, isize total_len, u64 seed);
+GB_EXTERN void gb_murmur64_update(gbMurmur64 *s, void const *data, isize len);
+GB_EXTERN u64  gb_murmur64_final (gbMurmur64 *s);
+
+
 ////////////////////////////////////////////////////////////////
 //
 // Instantiated Hash Table
@@ -1749,6 +2529,11 @@ GB_EXTERN u64 gb_murmur64_seed(void const *data, isize len, u64 seed);
 //
 // NOTE(bill): I really wish C had decent metaprogramming capabilities (and no I don't mean C++'s templates either)
 //
+// Incremental rehashing (opt-in): initialize with GB_JOIN2(FUNC,init_incremental)(h, a, rehash_step)
+// When the table grows, the old bucket array is kept and `rehash_step` old buckets are moved to the new
+// bucket array on each `get`/`set` rather than relinking every entry in one call.
+// A `rehash_step` of 4 or more guarantees the move is completed before the next grow is needed.
+//
 
 typedef struct gbHashTableFindResult {
 	isize hash_index;
@@ -1770,9 +2555,13 @@ typedef struct GB_JOIN2(NAME,Entry) { \
 typedef struct NAME { \
 	gbArray(isize) hashes; \
 	gbArray(GB_JOIN2(NAME,Entry)) entries; \
+	gbArray(isize) old_hashes; /* NOTE(bill): Only non-NULL during an incremental rehash */ \
+	isize migrate_index; \
+	isize rehash_step; \
 } NAME; \
 \
 PREFIX void                  GB_JOIN2(FUNC,init)       (NAME *h, gbAllocator a); \
+PREFIX void                  GB_JOIN2(FUNC,init_incremental)(NAME *h, gbAllocator a, isize rehash_step); \
 PREFIX void                  GB_JOIN2(FUNC,destroy)    (NAME *h); \
 PREFIX VALUE *               GB_JOIN2(FUNC,get)        (NAME *h, u64 key); \
 PREFIX void                  GB_JOIN2(FUNC,set)        (NAME *h, u64 key, VALUE value); \
@@ -1787,11 +2576,21 @@ PREFIX void                  GB_JOIN2(FUNC,rehash)     (NAME *h, isize new_count
 void GB_JOIN2(FUNC,init)(NAME *h, gbAllocator a) { \
 	gb_array_init(h->hashes,  a); \
 	gb_array_init(h->entries, a); \
+	h->old_hashes    = NULL; \
+	h->migrate_index = 0; \
+	h->rehash_step   = 0; \
+} \
+\
+void GB_JOIN2(FUNC,init_incremental)(NAME *h, gbAllocator a, isize rehash_step) { \
+	GB_JOIN2(FUNC,init)(h, a); \
+	h->rehash_step = rehash_step; \
 } \
 \
 void GB_JOIN2(FUNC,destroy)(NAME *h) { \
-	if (h->entries) gb_array_free(h->entries); \
-	if (h->hashes)  gb_array_free(h->hashes); \
+	if (h->old_hashes) gb_array_free(h->old_hashes); \
+	if (h->entries)    gb_array_free(h->entries); \
+	if (h->hashes)     gb_array_free(h->hashes); \
+	h->old_hashes = NULL; \
 } \
 \
 gb_internal isize GB_JOIN2(FUNC,_add_entry)(NAME *h, u64 key) { \
@@ -1804,8 +2603,44 @@ gb_internal isize GB_JOIN2(FUNC,_add_entry)(NAME *h, u64 key) { \
 	return index; \
 } \
 \
+gb_internal void GB_JOIN2(FUNC,_link)(NAME *h, isize entry_index) { \
+	GB_JOIN2(NAME,Entry) *e = &h->entries[entry_index]; \
+	isize hash_index = e->key % gb_array_count(h->hashes); \
+	e->next = h->hashes[hash_index]; \
+	h->hashes[hash_index] = entry_index; \
+} \
+\
+gb_internal void GB_JOIN2(FUNC,_migrate_bucket)(NAME *h, isize old_index) { \
+	isize i = h->old_hashes[old_index]; \
+	while (i >= 0) { \
+		isize next = h->entries[i].next; \
+		GB_JOIN2(FUNC,_link)(h, i); \
+		i = next; \
+	} \
+	h->old_hashes[old_index] = -1; \
+} \
+\
+gb_internal void GB_JOIN2(FUNC,_migrate)(NAME *h, isize bucket_count) { \
+	isize old_count; \
+	if (h->old_hashes == NULL) \
+		return; \
+	old_count = gb_array_count(h->old_hashes); \
+	while (bucket_count-- > 0 && h->migrate_index < old_count) \
+		GB_JOIN2(FUNC,_migrate_bucket)(h, h->migrate_index++); \
+	if (h->migrate_index >= old_count) { \
+		gb_array_free(h->old_hashes); \
+		h->old_hashes = NULL; \
+	} \
+} \
+\
 gb_internal gbHashTableFindResult GB_JOIN2(FUNC,_find)(NAME *h, u64 key) { \
 	gbHashTableFindResult r = {-1, -1, -1}; \
+	if (h->old_hashes) { \
+		/* NOTE(bill): Move the key's old bucket first so only the new buckets need searching */ \
+		isize old_index = key % gb_array_count(h->old_hashes); \
+		if (h->old_hashes[old_index] >= 0) \
+			GB_JOIN2(FUNC,_migrate_bucket)(h, old_index); \
+	} \
 	if (gb_array_count(h->hashes) > 0) { \
 		r.hash_index  = key % gb_array_count(h->hashes); \
 		r.entry_index = h->hashes[r.hash_index]; \
@@ -1825,41 +2660,40 @@ gb_internal b32 GB_JOIN2(FUNC,_full)(NAME *h) { \
 \
 void GB_JOIN2(FUNC,grow)(NAME *h) { \
 	isize new_count = GB_ARRAY_GROW_FORMULA(gb_array_count(h->entries)); \
-	GB_JOIN2(FUNC,rehash)(h, new_count); \
+	if (h->rehash_step <= 0 || gb_array_count(h->hashes) == 0) { \
+		GB_JOIN2(FUNC,rehash)(h, new_count); \
+		return; \
+	} \
+	/* NOTE(bill): Still moving from the last grow, finish that first */ \
+	GB_JOIN2(FUNC,_migrate)(h, ISIZE_MAX); \
+	h->old_hashes = h->hashes; \
+	h->migrate_index = 0; \
+	gb_array_init_reserve(h->hashes, gb_array_allocator(h->old_hashes), new_count); \
+	gb_array_resize(h->hashes, new_count); \
+	gb_memset(h->hashes, 0xff, gb_size_of(isize)*new_count); /* NOTE(bill): All -1 */ \
+	/* NOTE(bill): Make sure the entries do not need reallocating whilst moving */ \
+	gb_array_reserve(h->entries, cast(isize)(0.75f * new_count) + 1); \
 } \
 \
 void GB_JOIN2(FUNC,rehash)(NAME *h, isize new_count) { \
-	isize i, j; \
-	NAME nh = {0}; \
-	GB_JOIN2(FUNC,init)(&nh, gb_array_allocator(h->hashes)); \
-	gb_array_resize(nh.hashes, new_count); \
-	gb_array_reserve(nh.entries, gb_array_count(h->entries)); \
+	isize i; \
+	if (h->old_hashes) { \
+		gb_array_free(h->old_hashes); \
+		h->old_hashes = NULL; \
+	} \
+	gb_array_resize(h->hashes, new_count); \
 	for (i = 0; i < new_count; i++) \
-		nh.hashes[i] = -1; \
-	for (i = 0; i < gb_array_count(h->entries); i++) { \
-		GB_JOIN2(NAME,Entry) *e; \
-		gbHashTableFindResult fr; \
-		if (gb_array_count(nh.hashes) == 0) \
-			GB_JOIN2(FUNC,grow)(&nh); \
-		e = &nh.entries[i]; \
-		fr = GB_JOIN2(FUNC,_find)(&nh, e->key); \
-		j = GB_JOIN2(FUNC,_add_entry)(&nh, e->key); \
-		if (fr.entry_prev < 0) \
-			nh.hashes[fr.hash_index] = j; \
-		else \
-			nh.entries[fr.entry_prev].next = j; \
-		nh.entries[j].next = fr.entry_index; \
-		nh.entries[j].value = e->value; \
-		if (GB_JOIN2(FUNC,_full)(&nh)) \
-			GB_JOIN2(FUNC,grow)(&nh); \
+		h->hashes[i] = -1; \
+	if (new_count > 0) { \
+		for (i = 0; i < gb_array_count(h->entries); i++) \
+			GB_JOIN2(FUNC,_link)(h, i); \
 	} \
-	GB_JOIN2(FUNC,destroy)(h); \
-	h->hashes  = nh.hashes; \
-	h->entries = nh.entries; \
 } \
 \
 VALUE *GB_JOIN2(FUNC,get)(NAME *h, u64 key) { \
-	isize index = GB_JOIN2(FUNC,_find)(h, key).entry_index; \
+	isize index; \
+	GB_JOIN2(FUNC,_migrate)(h, h->rehash_step); \
+	index = GB_JOIN2(FUNC,_find)(h, key).entry_index; \
 	if (index >= 0) \
 		return &h->entries[index].value; \
 	return NULL; \
@@ -1870,6 +2704,7 @@ void GB_JOIN2(FUNC,set)(NAME *h, u64 key, VALUE value) { \
 	gbHashTableFindResult fr; \
 	if (gb_array_count(h->hashes) == 0) \
 		GB_JOIN2(FUNC,grow)(h); \
+	GB_JOIN2(FUNC,_migrate)(h, h->rehash_step); \
 	fr = GB_JOIN2(FUNC,_find)(h, key); \
 	if (fr.entry_index >= 0) { \
 		index = fr.entry_index; \
@@ -1888,59 +2723,285 @@ void GB_JOIN2(FUNC,set)(NAME *h, u64 key, VALUE value) { \
 
 
 
-
 ////////////////////////////////////////////////////////////////
 //
-// File Handling
+// Instantiated Open Addressing Hash Table
+//
+// Same idea as GB_TABLE but the keys, probe metadata and values are stored in separate arrays
+// and collisions are resolved with Robin Hood linear probing in a power of two sized table.
+// A lookup only touches the `metas` and `keys` arrays until the key is found.
+//
+// Hash table type and function declaration, call: GB_TABLE_OA_DECLARE(PREFIX, NAME, FUNC, VALUE)
+// Hash table function definitions, call: GB_TABLE_OA_DEFINE(NAME, FUNC, VALUE)
+//
+//     PREFIX  - a prefix for function prototypes e.g. extern, static, etc.
+//     NAME    - Name of the Hash Table
+//     FUNC    - the name will prefix function names
+//     VALUE   - the type of the value to be stored
+//
+// NOTE(bill): metas[i] == 0 means the slot is empty otherwise it is the probe distance + 1
+// To iterate: for (i = 0; i < h.capacity; i++) if (h.metas[i]) { h.keys[i], h.values[i] }
+//
+// NOTE(bill): Pointers returned by `get` are invalidated by `set`, `remove` and `reserve`
 //
 
+#ifndef GB_TABLE_OA_MAX_LOAD
+#define GB_TABLE_OA_MAX_LOAD(capacity) ((capacity) - ((capacity) >> 2)) // NOTE(bill): 75%
+#endif
 
-typedef u32 gbFileMode;
-typedef enum gbFileModeFlag {
-	gbFileMode_Read       = GB_BIT(0),
-	gbFileMode_Write      = GB_BIT(1),
-	gbFileMode_Append     = GB_BIT(2),
-	gbFileMode_Rw         = GB_BIT(3),
+#ifndef GB_TABLE_OA_MIN_CAPACITY
+#define GB_TABLE_OA_MIN_CAPACITY 16
+#endif
 
-	gbFileMode_Modes = gbFileMode_Read | gbFileMode_Write | gbFileMode_Append | gbFileMode_Rw,
-} gbFileModeFlag;
+#define GB_TABLE_OA(PREFIX, NAME, FUNC, VALUE) \
+	GB_TABLE_OA_DECLARE(PREFIX, NAME, FUNC, VALUE); \
+	GB_TABLE_OA_DEFINE(NAME, FUNC, VALUE);
 
-// NOTE(bill): Only used internally and for the file operations
-typedef enum gbSeekWhenceType {
-	gbSeekWhence_Begin   = 0,
-	gbSeekWhence_Current = 1,
-	gbSeekWhence_End     = 2,
-} gbSeekWhenceType;
+#define GB_TABLE_OA_DECLARE(PREFIX, NAME, FUNC, VALUE) \
+typedef struct NAME { \
+	gbAllocator allocator; \
+	u64 *       keys; \
+	u8 *        metas; \
+	VALUE *     values; \
+	isize       count; \
+	isize       capacity; \
+} NAME; \
+\
+PREFIX void   GB_JOIN2(FUNC,init)   (NAME *h, gbAllocator a); \
+PREFIX void   GB_JOIN2(FUNC,destroy)(NAME *h); \
+PREFIX void   GB_JOIN2(FUNC,clear)  (NAME *h); \
+PREFIX VALUE *GB_JOIN2(FUNC,get)    (NAME *h, u64 key); \
+PREFIX void   GB_JOIN2(FUNC,set)    (NAME *h, u64 key, VALUE value); \
+PREFIX b32    GB_JOIN2(FUNC,remove) (NAME *h, u64 key); \
+PREFIX void   GB_JOIN2(FUNC,reserve)(NAME *h, isize count); \
+PREFIX void   GB_JOIN2(FUNC,rehash) (NAME *h, isize new_capacity); \
 
-typedef enum gbFileError {
-	gbFileError_None,
-	gbFileError_Invalid,
-	gbFileError_Exists,
-	gbFileError_NotExists,
-	gbFileError_Permission,
-	gbFileError_TruncationFailure,
-} gbFileError;
 
-typedef union gbFileDescriptor {
-	void *  p;
-	intptr  i;
-	uintptr u;
-} gbFileDescriptor;
 
-typedef struct gbFileOperations gbFileOperations;
 
-#define GB_FILE_OPEN_PROC(name)     gbFileError name(gbFileDescriptor *fd, gbFileOperations *ops, gbFileMode mode, char const *filename)
-#define GB_FILE_READ_AT_PROC(name)  b32         name(gbFileDescriptor fd, void *buffer, isize size, i64 offset, isize *bytes_read)
-#define GB_FILE_WRITE_AT_PROC(name) b32         name(gbFileDescriptor fd, void const *buffer, isize size, i64 offset, isize *bytes_written)
-#define GB_FILE_SEEK_PROC(name)     b32         name(gbFileDescriptor fd, i64 offset, gbSeekWhenceType whence, i64 *new_offset)
-#define GB_FILE_CLOSE_PROC(name)    void        name(gbFileDescriptor fd)
-typedef GB_FILE_OPEN_PROC(gbFileOpenProc);
-typedef GB_FILE_READ_AT_PROC(gbFileReadProc);
-typedef GB_FILE_WRITE_AT_PROC(gbFileWriteProc);
-typedef GB_FILE_SEEK_PROC(gbFileSeekProc);
-typedef GB_FILE_CLOSE_PROC(gbFileCloseProc);
 
-struct gbFileOperations {
+#define GB_TABLE_OA_DEFINE(NAME, FUNC, VALUE) \
+void GB_JOIN2(FUNC,init)(NAME *h, gbAllocator a) { \
+	gb_zero_item(h); \
+	h->allocator = a; \
+} \
+\
+void GB_JOIN2(FUNC,destroy)(NAME *h) { \
+	if (h->keys)   gb_free(h->allocator, h->keys); \
+	if (h->metas)  gb_free(h->allocator, h->metas); \
+	if (h->values) gb_free(h->allocator, h->values); \
+	h->keys     = NULL; \
+	h->metas    = NULL; \
+	h->values   = NULL; \
+	h->count    = 0; \
+	h->capacity = 0; \
+} \
+\
+void GB_JOIN2(FUNC,clear)(NAME *h) { \
+	if (h->metas) gb_zero_size(h->metas, h->capacity); \
+	h->count = 0; \
+} \
+\
+gb_internal isize GB_JOIN2(FUNC,_slot)(NAME *h, u64 key) { \
+	/* NOTE(bill): Mix the bits as the capacity is a power of two and only the low bits are used */ \
+	key ^= key >> 33; \
+	key *= 0xff51afd7ed558ccdull; \
+	key ^= key >> 33; \
+	return cast(isize)(key & cast(u64)(h->capacity-1)); \
+} \
+\
+/* NOTE(bill): Returns false if the probe distance would overflow the u8 metadata */ \
+gb_internal b32 GB_JOIN2(FUNC,_insert)(NAME *h, u64 *key, VALUE *value) { \
+	isize mask  = h->capacity-1; \
+	isize index = GB_JOIN2(FUNC,_slot)(h, *key); \
+	u8 dist = 1; \
+	for (;;) { \
+		u8 m = h->metas[index]; \
+		if (m == 0) { \
+			h->keys[index]   = *key; \
+			h->values[index] = *value; \
+			h->metas[index]  = dist; \
+			h->count++; \
+			return true; \
+		} \
+		if (m < dist) { \
+			/* NOTE(bill): Robin Hood - steal the slot from the richer entry and carry it on */ \
+			gb_swap(u64,   h->keys[index],   *key); \
+			gb_swap(VALUE, h->values[index], *value); \
+			gb_swap(u8,    h->metas[index],  dist); \
+		} \
+		if (dist == U8_MAX) \
+			return false; \
+		dist++; \
+		index = (index+1) & mask; \
+	} \
+} \
+\
+void GB_JOIN2(FUNC,rehash)(NAME *h, isize new_capacity) { \
+	isize i; \
+	NAME nh = {0}; \
+	new_capacity = gb_max(new_capacity, GB_TABLE_OA_MIN_CAPACITY); \
+	GB_ASSERT(gb_is_power_of_two(new_capacity)); \
+	GB_ASSERT(GB_TABLE_OA_MAX_LOAD(new_capacity) >= h->count); \
+	nh.allocator = h->allocator; \
+	nh.capacity  = new_capacity; \
+	nh.keys   = gb_alloc_array(nh.allocator, u64,   new_capacity); \
+	nh.metas  = gb_alloc_array(nh.allocator, u8,    new_capacity); \
+	nh.values = gb_alloc_array(nh.allocator, VALUE, new_capacity); \
+	gb_zero_size(nh.metas, new_capacity); \
+	for (i = 0; i < h->capacity; i++) { \
+		if (h->metas[i]) { \
+			u64   key   = h->keys[i]; \
+			VALUE value = h->values[i]; \
+			if (!GB_JOIN2(FUNC,_insert)(&nh, &key, &value)) { \
+				/* NOTE(bill): Pathological clustering, start again with twice the room */ \
+				GB_JOIN2(FUNC,destroy)(&nh); \
+				GB_JOIN2(FUNC,rehash)(h, 2*new_capacity); \
+				return; \
+			} \
+		} \
+	} \
+	GB_JOIN2(FUNC,destroy)(h); \
+	*h = nh; \
+} \
+\
+void GB_JOIN2(FUNC,reserve)(NAME *h, isize count) { \
+	isize new_capacity = gb_max(h->capacity, GB_TABLE_OA_MIN_CAPACITY); \
+	while (GB_TABLE_OA_MAX_LOAD(new_capacity) < count) \
+		new_capacity *= 2; \
+	if (new_capacity != h->capacity) \
+		GB_JOIN2(FUNC,rehash)(h, new_capacity); \
+} \
+\
+VALUE *GB_JOIN2(FUNC,get)(NAME *h, u64 key) { \
+	if (h->count > 0) { \
+		isize mask  = h->capacity-1; \
+		isize index = GB_JOIN2(FUNC,_slot)(h, key); \
+		isize dist  = 1; \
+		/* NOTE(bill): An entry further along can never be closer to home than this key would be */ \
+		while (h->metas[index] >= dist) { \
+			if (h->metas[index] == dist && h->keys[index] == key) \
+				return &h->values[index]; \
+			dist++; \
+			index = (index+1) & mask; \
+		} \
+	} \
+	return NULL; \
+} \
+\
+void GB_JOIN2(FUNC,set)(NAME *h, u64 key, VALUE value) { \
+	VALUE *found = GB_JOIN2(FUNC,get)(h, key); \
+	if (found) { \
+		*found = value; \
+		return; \
+	} \
+	if (GB_TABLE_OA_MAX_LOAD(h->capacity) < h->count+1) \
+		GB_JOIN2(FUNC,reserve)(h, h->count+1); \
+	while (!GB_JOIN2(FUNC,_insert)(h, &key, &value)) \
+		GB_JOIN2(FUNC,rehash)(h, 2*h->capacity); \
+} \
+\
+b32 GB_JOIN2(FUNC,remove)(NAME *h, u64 key) { \
+	isize mask, index, next; \
+	VALUE *found = GB_JOIN2(FUNC,get)(h, key); \
+	if (found == NULL) \
+		return false; \
+	mask  = h->capacity-1; \
+	index = found - h->values; \
+	next  = (index+1) & mask; \
+	/* NOTE(bill): Backward shift deletion so no tombstones are needed */ \
+	while (h->metas[next] > 1) { \
+		h->keys[index]   = h->keys[next]; \
+		h->values[index] = h->values[next]; \
+		h->metas[index]  = cast(u8)(h->metas[next]-1); \
+		index = next; \
+		next  = (next+1) & mask; \
+	} \
+	h->metas[index] = 0; \
+	h->count--; \
+	return true; \
+} \
+
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// String Interning
+//
+// Each distinct string is stored once so interned strings are equal iff their pointers are.
+// NOTE(bill): The returned gbString must not be modified or freed, it lives until gb_string_interner_destroy
+//
+
+GB_TABLE_OA_DECLARE(GB_DEF, gbStringInternTable, gb__string_intern_table_, isize);
+
+typedef struct gbStringInterner {
+	gbAllocator         allocator;
+	gbStringInternTable table;   // NOTE(bill): Hash of the string -> index of the latest string with that hash
+	gbArray(gbString)   strings;
+	gbArray(isize)      next;    // NOTE(bill): Index of the previous string with the same hash or -1
+} gbStringInterner;
+
+GB_DEF void     gb_string_interner_init   (gbStringInterner *si, gbAllocator a);
+GB_DEF void     gb_string_interner_destroy(gbStringInterner *si);
+GB_DEF gbString gb_string_intern          (gbStringInterner *si, char const *str);
+GB_DEF gbString gb_string_intern_length   (gbStringInterner *si, void const *str, isize num_bytes);
+
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// File Handling
+//
+
+
+typedef u32 gbFileMode;
+typedef enum gbFileModeFlag {
+	gbFileMode_Read       = GB_BIT(0),
+	gbFileMode_Write      = GB_BIT(1),
+	gbFileMode_Append     = GB_BIT(2),
+	gbFileMode_Rw         = GB_BIT(3),
+
+	gbFileMode_Modes = gbFileMode_Read | gbFileMode_Write | gbFileMode_Append | gbFileMode_Rw,
+} gbFileModeFlag;
+
+// NOTE(bill): Only used internally and for the file operations
+typedef enum gbSeekWhenceType {
+	gbSeekWhence_Begin   = 0,
+	gbSeekWhence_Current = 1,
+	gbSeekWhence_End     = 2,
+} gbSeekWhenceType;
+
+typedef enum gbFileError {
+	gbFileError_None,
+	gbFileError_Invalid,
+	gbFileError_Exists,
+	gbFileError_NotExists,
+	gbFileError_Permission,
+	gbFileError_TruncationFailure,
+} gbFileError;
+
+typedef union gbFileDescriptor {
+	void *  p;
+	intptr  i;
+	uintptr u;
+} gbFileDescriptor;
+
+typedef struct gbFileOperations gbFileOperations;
+
+#define GB_FILE_OPEN_PROC(name)     gbFileError name(gbFileDescriptor *fd, gbFileOperations *ops, gbFileMode mode, char const *filename)
+#define GB_FILE_READ_AT_PROC(name)  b32         name(gbFileDescriptor fd, void *buffer, isize size, i64 offset, isize *bytes_read)
+#define GB_FILE_WRITE_AT_PROC(name) b32         name(gbFileDescriptor fd, void const *buffer, isize size, i64 offset, isize *bytes_written)
+#define GB_FILE_SEEK_PROC(name)     b32         name(gbFileDescriptor fd, i64 offset, gbSeekWhenceType whence, i64 *new_offset)
+#define GB_FILE_CLOSE_PROC(name)    void        name(gbFileDescriptor fd)
+typedef GB_FILE_OPEN_PROC(gbFileOpenProc);
+typedef GB_FILE_READ_AT_PROC(gbFileReadProc);
+typedef GB_FILE_WRITE_AT_PROC(gbFileWriteProc);
+typedef GB_FILE_SEEK_PROC(gbFileSeekProc);
+typedef GB_FILE_CLOSE_PROC(gbFileCloseProc);
+
+struct gbFileOperations {
 	gbFileReadProc  *read_at;
 	gbFileWriteProc *write_at;
 	gbFileSeekProc  *seek;
@@ -1966,8 +3027,6 @@ typedef struct gbFile {
 	// gbDirInfo *   dir_info; // TODO(bill): Get directory info
 } gbFile;
 
-// TODO(bill): gbAsyncFile
-
 typedef enum gbFileStandardType {
 	gbFileStandard_Input,
 	gbFileStandard_Output,
@@ -2001,14 +3060,46 @@ GB_DEF b32         gb_file_has_changed   (gbFile *file); // NOTE(bill): Changed
 // gbFileError gb_file_temp(gbFile *file);
 //
 
+
+// NOTE(bill): Read-only view of a whole file (mmap on POSIX, CreateFileMapping on Windows)
+// Only files using gbDefaultFileOperations can be mapped
+typedef enum gbFileMapHint {
+	gbFileMapHint_Normal,
+	gbFileMapHint_Sequential,
+	gbFileMapHint_Random,
+	gbFileMapHint_WillNeed, // NOTE(bill): Start reading it in now
+	gbFileMapHint_DontNeed, // NOTE(bill): Pages can be dropped (they are read back in on access)
+} gbFileMapHint;
+
+typedef struct gbFileMap {
+	void const *data;
+	isize       size;
+	void *      handle; // NOTE(bill): File mapping object on Windows
+} gbFileMap;
+
+GB_DEF b32  gb_file_map       (gbFileMap *map, gbFile *file, gbFileMapHint hint);
+GB_DEF void gb_file_unmap     (gbFileMap *map);
+GB_DEF void gb_file_map_advise(gbFileMap *map, isize offset, isize size, gbFileMapHint hint);
+
+
+typedef u32 gbFileContentsFlags;
+typedef enum gbFileContentsFlag {
+	gbFileContents_ZeroTerminate = GB_BIT(0), // NOTE(bill): Same as passing `true`
+	gbFileContents_Mapped        = GB_BIT(1), // NOTE(bill): Return a read-only mapped view rather than a heap copy
+} gbFileContentsFlag;
+
 typedef struct gbFileContents {
 	gbAllocator allocator;
-	void *      data;
+	void *      data; // NOTE(bill): Must not be written to if mapped
 	isize       size;
+	gbFileMap   map;
 } gbFileContents;
 
 
-GB_DEF gbFileContents gb_file_read_contents(gbAllocator a, b32 zero_terminate, char const *filepath);
+// NOTE(bill): gbFileContents_Mapped falls back to a heap copy if the file cannot be mapped.
+// A mapped view is only zero terminated if the file does not end on a page boundary (the rest of
+// the last page is guaranteed to be zero), otherwise it is copied too.
+GB_DEF gbFileContents gb_file_read_contents(gbAllocator a, gbFileContentsFlags flags, char const *filepath);
 GB_DEF void           gb_file_free_contents(gbFileContents *fc);
 
 
@@ -2019,6 +3110,137 @@ GB_DEF b32        gb_file_copy           (char const *existing_filename, char co
 GB_DEF b32        gb_file_move           (char const *existing_filename, char const *new_filename);
 
 
+////////////////////////////////////////////////////////////////
+//
+// Buffered File IO
+//
+// NOTE(bill): Buffered streams over a gbFile with a user supplied buffer
+// Writes are gathered in the buffer and written out when it is full, on every newline
+// (gbFileBuffer_Line) or on every call (gbFileBuffer_None). Do not forget gb_file_writer_flush.
+// The reader keeps its own offset, starting at the file's position when it is initialized.
+// Files which cannot seek (pipes, sockets, stdin) are just read in order.
+//
+
+typedef enum gbFileBufferMode {
+	gbFileBuffer_Full,
+	gbFileBuffer_Line,
+	gbFileBuffer_None,
+} gbFileBufferMode;
+
+#define GB_FILE_WRITER_MIN_CAPACITY 64
+#define GB_FILE_READER_MIN_CAPACITY 4
+
+typedef struct gbFileWriter {
+	gbFile *         file;
+	u8 *             buffer;
+	isize            capacity;
+	isize            count;
+	gbFileBufferMode mode;
+	b32              failed; // NOTE(bill): Set once a write to the file fails
+} gbFileWriter;
+
+typedef struct gbFileReader {
+	gbFile *file;
+	u8 *    buffer;
+	isize   capacity;
+	isize   start, end; // NOTE(bill): The unread bytes are buffer[start, end)
+	i64     offset;     // NOTE(bill): Of the next read from the file
+	b32     eof;
+	b32     split_line; // NOTE(bill): The last line piece did not fit in the buffer, the line goes on in the next piece
+} gbFileReader;
+
+GB_DEF void  gb_file_writer_init (gbFileWriter *w, gbFile *f, void *buffer, isize capacity, gbFileBufferMode mode); // NOTE(bill): capacity >= GB_FILE_WRITER_MIN_CAPACITY
+GB_DEF b32   gb_file_writer_write(gbFileWriter *w, void const *data, isize size);
+GB_DEF b32   gb_file_writer_flush(gbFileWriter *w);
+// NOTE(bill): gb_file_writer_printf is with the other printing procedures
+
+GB_DEF void  gb_file_reader_init     (gbFileReader *r, gbFile *f, void *buffer, isize capacity); // NOTE(bill): capacity >= GB_FILE_READER_MIN_CAPACITY
+GB_DEF isize gb_file_reader_read     (gbFileReader *r, void *data, isize size); // NOTE(bill): Returns the bytes read, less than size only at the end
+// NOTE(bill): The line (without the \n or \r\n) points into the buffer and is valid until the next read.
+// Lines which do not fit in the buffer are returned in pieces of up to capacity-1 bytes, with
+// split_line set on every piece but the last. Returns false at the end.
+GB_DEF b32   gb_file_reader_read_line(gbFileReader *r, char const **line, isize *length);
+
+
+////////////////////////////////////////////////////////////////
+//
+// Asynchronous File I/O
+//
+// NOTE(bill): Requests are run by a pool of gbThreads which call the file's own gbFileOperations
+// so custom file systems work with it too. The gbAsyncFileOp is owned by the caller and must stay
+// alive (and the buffer untouched) until the request has completed.
+// Completion can be polled with gb_async_file_op_status, waited upon with gb_async_file_op_wait
+// (which runs the request on the calling thread if no worker has picked it up yet), or handled
+// by a callback which is called from the worker thread.
+//
+
+#ifndef GB_ASYNC_FILE_MAX_THREADS
+#define GB_ASYNC_FILE_MAX_THREADS 8
+#endif
+
+typedef enum gbAsyncFileOpType {
+	gbAsyncFileOp_Read,
+	gbAsyncFileOp_Write,
+} gbAsyncFileOpType;
+
+typedef enum gbAsyncFileStatus {
+	gbAsyncFileStatus_Idle,
+	gbAsyncFileStatus_Pending,
+	gbAsyncFileStatus_Running,
+	gbAsyncFileStatus_Done,
+	gbAsyncFileStatus_Failed,
+} gbAsyncFileStatus;
+
+typedef struct gbAsyncFileOp gbAsyncFileOp;
+
+#define GB_ASYNC_FILE_CALLBACK(name) void name(gbAsyncFileOp *op, b32 succeeded)
+typedef GB_ASYNC_FILE_CALLBACK(gbAsyncFileCallback);
+
+struct gbAsyncFileOp {
+	gbAsyncFileOpType    type;
+	gbFile *             file;
+	void *               buffer; // NOTE(bill): void const * for writes
+	isize                size;
+	i64                  offset;
+	gbAsyncFileCallback *callback; // NOTE(bill): Optional
+	void *               user_data;
+
+	isize                bytes_transferred;
+	gbAtomic32           status; // NOTE(bill): gbAsyncFileStatus
+	gbAsyncFileOp *      next;
+};
+
+typedef struct gbAsyncFileQueue {
+	gbMutex         mutex;
+	gbFastSemaphore semaphore;
+	gbAsyncFileOp * head;
+	gbAsyncFileOp * tail;
+	gbAtomic32      pending_count;
+	gbAtomic32      is_running;
+
+	// NOTE(bill): Threads blocked in gb_async_file_op_wait/wait_all, woken on every completion
+	gbFastSemaphore done_semaphore;
+	gbAtomic32      waiter_count;
+
+	gbThread        threads[GB_ASYNC_FILE_MAX_THREADS];
+	isize           thread_count;
+} gbAsyncFileQueue;
+
+// NOTE(bill): thread_count <= 0 uses 2 threads
+GB_DEF void gb_async_file_queue_init    (gbAsyncFileQueue *q, isize thread_count);
+GB_DEF void gb_async_file_queue_destroy (gbAsyncFileQueue *q); // NOTE(bill): Finishes all the submitted requests first
+GB_DEF void gb_async_file_queue_wait_all(gbAsyncFileQueue *q);
+
+GB_DEF void gb_async_file_submit  (gbAsyncFileQueue *q, gbAsyncFileOp *op);
+GB_DEF void gb_async_file_read_at (gbAsyncFileQueue *q, gbAsyncFileOp *op, gbFile *file, void *buffer, isize size, i64 offset,
+                                   gbAsyncFileCallback *callback, void *user_data);
+GB_DEF void gb_async_file_write_at(gbAsyncFileQueue *q, gbAsyncFileOp *op, gbFile *file, void const *buffer, isize size, i64 offset,
+                                   gbAsyncFileCallback *callback, void *user_data);
+
+GB_DEF gbAsyncFileStatus gb_async_file_op_status(gbAsyncFileOp *op);
+GB_DEF b32               gb_async_file_op_wait  (gbAsyncFileQueue *q, gbAsyncFileOp *op); // NOTE(bill): Returns true if it succeeded
+
+
 #ifndef GB_PATH_SEPARATOR
 	#if defined(GB_SYSTEM_WINDOWS)
 		#define GB_PATH_SEPARATOR '\\'
@@ -2048,11 +3270,82 @@ GB_DEF isize gb_printf_err_va (char const *fmt, va_list va);
 GB_DEF isize gb_fprintf       (gbFile *f, char const *fmt, ...) GB_PRINTF_ARGS(2);
 GB_DEF isize gb_fprintf_va    (gbFile *f, char const *fmt, va_list va);
 
+// NOTE(bill): Formats straight into the writer's buffer, flushing it whenever it fills up,
+// so there is no limit on the length. gb_fprintf uses one with a stack buffer.
+// These return the number of bytes written.
+GB_DEF isize gb_file_writer_printf   (gbFileWriter *w, char const *fmt, ...) GB_PRINTF_ARGS(2);
+GB_DEF isize gb_file_writer_printf_va(gbFileWriter *w, char const *fmt, va_list va);
+
 GB_DEF char *gb_bprintf    (char const *fmt, ...) GB_PRINTF_ARGS(1); // NOTE(bill): A locally persisting buffer is used internally
 GB_DEF char *gb_bprintf_va (char const *fmt, va_list va);            // NOTE(bill): A locally persisting buffer is used internally
 GB_DEF isize gb_snprintf   (char *str, isize n, char const *fmt, ...) GB_PRINTF_ARGS(3);
 GB_DEF isize gb_snprintf_va(char *str, isize n, char const *fmt, va_list va);
 
+
+
+////////////////////////////////////////////////////////////////
+//
+// Allocation Tracking
+//
+// NOTE(bill): gbTrackingAllocator wraps any allocator and records the counts and bytes per allocation
+// type, the bytes in use, the peak, a power of two size histogram and per tag statistics.
+// Each allocation gets a small header so frees know their size.
+// Tags are set per thread with gb_tracking_set_tag (use string literals, they are compared by pointer
+// first) and are attributed to the allocations made while they are set.
+// With a sample_rate of N, only one in N allocations goes into the histogram and tag stats; the
+// totals are always exact. It is thread safe if the backing allocator is.
+//
+
+#ifndef GB_TRACKING_MAX_TAGS
+#define GB_TRACKING_MAX_TAGS 64
+#endif
+#define GB_TRACKING_HISTOGRAM_COUNT 32 // NOTE(bill): Bucket i holds the sizes in [2^i, 2^(i+1))
+
+typedef struct gbTrackingTag {
+	char const *name;
+	gbAtomic64  count;
+	gbAtomic64  bytes;
+	gbAtomic64  live_bytes;
+} gbTrackingTag;
+
+typedef struct gbTrackingAllocator {
+	gbAllocator   backing;
+	i32           sample_rate;
+
+	gbAtomic64    type_counts[4]; // NOTE(bill): Indexed by gbAllocationType
+	gbAtomic64    type_bytes[4];
+	gbAtomic64    total_allocated;
+	gbAtomic64    peak_allocated;
+	gbAtomic64    allocation_count;
+	gbAtomic64    sample_counter;
+	gbAtomic64    histogram[GB_TRACKING_HISTOGRAM_COUNT];
+
+	gbAtomic32    tag_lock;
+	gbAtomic32    tag_count;
+	gbTrackingTag tags[GB_TRACKING_MAX_TAGS]; // NOTE(bill): tags[0] is for untagged allocations
+} gbTrackingAllocator;
+
+GB_DEF void        gb_tracking_allocator_init (gbTrackingAllocator *ta, gbAllocator backing, i32 sample_rate); // NOTE(bill): sample_rate <= 1 samples everything
+GB_DEF void        gb_tracking_allocator_print(gbTrackingAllocator *ta, gbFile *f); // NOTE(bill): f == NULL prints to stdout
+GB_DEF char const *gb_tracking_set_tag        (char const *tag); // NOTE(bill): Returns the previous tag, NULL is untagged
+
+// Allocation Types: alloc, free, free_all, resize (whatever the backing allocator supports)
+GB_DEF gbAllocator gb_tracking_allocator(gbTrackingAllocator *ta);
+GB_DEF GB_ALLOCATOR_PROC(gb_tracking_allocator_proc);
+
+
+// NOTE(bill): Common stats for the allocators which keep them; the fields an allocator does not
+// track are 0. Supports gbArena, gbPool, gbFreeList, gbCachedAllocator and gbTrackingAllocator.
+typedef struct gbAllocatorStats {
+	i64 total_allocated;  // NOTE(bill): Bytes in use
+	i64 allocation_count; // NOTE(bill): Live allocations
+	i64 peak_allocated;
+	i64 capacity;         // NOTE(bill): Bytes it can hand out or has taken from its backing allocator
+} gbAllocatorStats;
+
+GB_DEF b32 gb_allocator_stats(gbAllocator a, gbAllocatorStats *stats); // NOTE(bill): false if the allocator keeps no stats
+
+
 ////////////////////////////////////////////////////////////////
 //
 // DLL Handling
@@ -2079,6 +3372,103 @@ GB_DEF u64  gb_utc_time_now(void); // NOTE(bill): Number of microseconds since 1
 GB_DEF void gb_sleep_ms    (u32 ms);
 
 
+////////////////////////////////////////////////////////////////
+//
+// Profiling
+//
+// NOTE(bill): #define GB_PROFILE before including gb.h to turn the GB_PROFILE_* macros (and the zones
+// inside gb.h: allocators, gb_sort, gb_file_read_contents) on, otherwise they compile to nothing.
+//
+// A zone pushes a begin and an end event (name, gb_rdtsc()) into a ring buffer owned by the calling
+// thread, so recording one is a few stores with no locks or shared cache lines. The ring buffers are
+// read without stopping the threads writing them:
+//   gb_profile_frame_end          - aggregates the zones that ended since the last call, on all threads
+//   gb_profile_write_chrome_trace - writes the events still in the ring buffers as Chrome trace JSON
+//                                   (open with chrome://tracing or ui.perfetto.dev)
+// Once a thread's ring buffer wraps, its oldest events are lost. Only the pointer to a zone name
+// is stored so it must outlive the profiler (e.g. a string literal).
+//
+//	GB_PROFILE_BEGIN("physics");
+//	...
+//	GB_PROFILE_END();
+//
+//	{ GB_PROFILE_BLOCK("render"); ... } // NOTE(bill): Ends with the scope, C++ and GCC/Clang only
+//
+//	gb_profile_print_frame(gb_profile_frame_end(), NULL);
+//
+
+#ifndef GB_PROFILE_EVENT_COUNT
+#define GB_PROFILE_EVENT_COUNT (1<<16) // NOTE(bill): Per thread, must be a power of two
+#endif
+#ifndef GB_PROFILE_MAX_ZONES
+#define GB_PROFILE_MAX_ZONES 256
+#endif
+#ifndef GB_PROFILE_MAX_DEPTH
+#define GB_PROFILE_MAX_DEPTH 64
+#endif
+
+typedef struct gbProfileEvent {
+	char const *name; // NOTE(bill): NULL for the end of a zone
+	u64         tsc;
+} gbProfileEvent;
+
+typedef struct gbProfileThread {
+	gbAtomic64              write_index; // NOTE(bill): Only the owning thread pushes events
+	u32                     thread_id;
+	struct gbProfileThread *next;
+
+	// NOTE(bill): Only used by gb_profile_frame_end
+	i64            read_index;
+	i32            depth;
+	gbProfileEvent stack[GB_PROFILE_MAX_DEPTH];
+
+	gbProfileEvent events[GB_PROFILE_EVENT_COUNT];
+} gbProfileThread;
+
+typedef struct gbProfileZone {
+	char const *name;
+	i64         count;
+	u64         total_cycles; // NOTE(bill): Includes the nested zones
+	u64         max_cycles;
+} gbProfileZone;
+
+typedef struct gbProfileFrame {
+	u64           begin_tsc, end_tsc;
+	f64           cycles_per_second;
+	i64           dropped_event_count; // NOTE(bill): Overwritten before they could be aggregated
+	isize         zone_count;
+	gbProfileZone zones[GB_PROFILE_MAX_ZONES]; // NOTE(bill): Largest total_cycles first
+} gbProfileFrame;
+
+GB_DEF void gb_profile_begin(char const *name);
+GB_DEF void gb_profile_end  (void);
+
+GB_DEF gbProfileFrame const *gb_profile_frame_end(void); // NOTE(bill): Call once per frame from one thread, valid until the next call
+GB_DEF void                  gb_profile_print_frame(gbProfileFrame const *frame, gbFile *f); // NOTE(bill): f == NULL prints to stdout
+GB_DEF b32                   gb_profile_write_chrome_trace(char const *filepath);
+GB_DEF f64                   gb_profile_cycles_per_second(void); // NOTE(bill): Measured since the first zone
+
+#if defined(GB_PROFILE)
+	#define GB_PROFILE_BEGIN(name) gb_profile_begin(name)
+	#define GB_PROFILE_END()       gb_profile_end()
+
+	#if defined(__cplusplus)
+	struct gbprivProfileBlock {
+		gbprivProfileBlock(char const *name) { gb_profile_begin(name); }
+		~gbprivProfileBlock()                { gb_profile_end(); }
+	};
+	#define GB_PROFILE_BLOCK(name) gbprivProfileBlock GB_JOIN2(gb__profile_block_, __LINE__)(name)
+	#elif defined(__GNUC__) || defined(__clang__)
+	gb_internal __inline__ void gb__profile_block_end(int *block) { gb_unused(block); gb_profile_end(); }
+	#define GB_PROFILE_BLOCK(name) int GB_JOIN2(gb__profile_block_, __LINE__) __attribute__((cleanup(gb__profile_block_end))) = (gb_profile_begin(name), 0)
+	#endif
+#else
+	#define GB_PROFILE_BEGIN(name)
+	#define GB_PROFILE_END()
+	#define GB_PROFILE_BLOCK(name)
+#endif
+
+
 ////////////////////////////////////////////////////////////////
 //
 // Miscellany
@@ -3614,69 +5004,626 @@ gb_inline isize       gb_pointer_diff     (void const *begin, void const *end) {
 gb_inline void gb_zero_size(void *ptr, isize size) { gb_memset(ptr, 0, size); }
 
 
-#if defined(_MSC_VER)
-#pragma intrinsic(__movsb)
+#if defined(GB_CPU_X86)
+gb_internal void gb__cpuid(i32 info[4], i32 leaf, i32 sub_leaf) {
+#if defined(GB_COMPILER_MSVC)
+	__cpuidex(info, leaf, sub_leaf);
+#else
+	__asm__ __volatile__("cpuid" : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3]) : "a"(leaf), "c"(sub_leaf));
 #endif
+}
 
-gb_inline void *gb_memcopy(void *dest, void const *source, isize n) {
-#if defined(_MSC_VER)
-	// TODO(bill): Is this good enough?
-	__movsb(cast(u8 *)dest, cast(u8 *)source, n);
-#elif defined(GB_CPU_X86)
-	__asm__ __volatile__("rep movsb" : "+D"(cast(u8 *)dest), "+S"(cast(u8 *)source), "+c"(n) : : "memory");
+gb_internal u64 gb__xgetbv(u32 index) {
+#if defined(GB_COMPILER_MSVC)
+	return _xgetbv(index);
 #else
-	u8 *d = cast(u8 *)dest;
-	u8 const *s = cast(u8 const *)source;
-	u32 w, x;
+	u32 lo, hi;
+	__asm__ __volatile__(".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(index));
+	return (cast(u64)hi << 32) | lo;
+#endif
+}
+#elif defined(GB_SYSTEM_LINUX) && defined(__aarch64__)
+	#include <sys/auxv.h>
+#endif
 
-	for (; cast(uintptr)s % 4 && n; n--)
-		*d++ = *s++;
+u32 gb_cpu_features(void) {
+	// NOTE(bill): The top bit marks that the features have been detected. Racing threads all compute the same value.
+	gb_local_persist u32 volatile cached = 0;
+	u32 features = cached;
+	if (features)
+		return features & ~(cast(u32)1 << 31);
 
-	if (cast(uintptr)d % 4 == 0) {
-		for (; n >= 16;
-		     s += 16, d += 16, n -= 16) {
-			*cast(u32 *)(d+ 0) = *cast(u32 *)(s+ 0);
-			*cast(u32 *)(d+ 4) = *cast(u32 *)(s+ 4);
-			*cast(u32 *)(d+ 8) = *cast(u32 *)(s+ 8);
-			*cast(u32 *)(d+12) = *cast(u32 *)(s+12);
-		}
-		if (n & 8) {
-			*cast(u32 *)(d+0) = *cast(u32 *)(s+0);
-			*cast(u32 *)(d+4) = *cast(u32 *)(s+4);
-			d += 8;
-			s += 8;
-		}
-		if (n&4) {
-			*cast(u32 *)(d+0) = *cast(u32 *)(s+0);
-			d += 4;
-			s += 4;
-		}
-		if (n&2) {
-			*d++ = *s++; *d++ = *s++;
+#if defined(GB_CPU_X86)
+	{
+		i32 info[4];
+		i32 max_leaf;
+		gb__cpuid(info, 0, 0);
+		max_leaf = info[0];
+		if (max_leaf >= 1) {
+			gb__cpuid(info, 1, 0);
+			if (info[3] & GB_BIT(26)) features |= gbCpuFeature_SSE2;
+			if (info[2] & GB_BIT(0))  features |= gbCpuFeature_SSE3;
+			if (info[2] & GB_BIT(9))  features |= gbCpuFeature_SSSE3;
+			if (info[2] & GB_BIT(19)) features |= gbCpuFeature_SSE41;
+			if (info[2] & GB_BIT(20)) features |= gbCpuFeature_SSE42;
+			if (info[2] & GB_BIT(23)) features |= gbCpuFeature_POPCNT;
+			if (info[2] & GB_BIT(1))  features |= gbCpuFeature_PCLMUL;
+			// NOTE(bill): OSXSAVE & AVX & the OS saves XMM and YMM state
+			if ((info[2] & GB_BIT(27)) && (info[2] & GB_BIT(28)) && (gb__xgetbv(0) & 6) == 6)
+				features |= gbCpuFeature_AVX;
 		}
-		if (n&1) {
-			*d = *s;
+		if (max_leaf >= 7) {
+			gb__cpuid(info, 7, 0);
+			if ((features & gbCpuFeature_AVX) && (info[1] & GB_BIT(5)))
+				features |= gbCpuFeature_AVX2;
+			if (info[1] & GB_BIT(8)) features |= gbCpuFeature_BMI2;
+			if (info[1] & GB_BIT(9)) features |= gbCpuFeature_ERMS;
 		}
-		return dest;
 	}
+#elif defined(GB_CPU_ARM)
+	#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	features |= gbCpuFeature_NEON;
+	#endif
+	#if defined(__ARM_FEATURE_CRC32)
+	features |= gbCpuFeature_ArmCRC32;
+	#elif defined(GB_SYSTEM_LINUX) && defined(__aarch64__)
+	if (getauxval(AT_HWCAP) & GB_BIT(7)) // NOTE(bill): HWCAP_CRC32
+		features |= gbCpuFeature_ArmCRC32;
+	#endif
+#endif
 
-	if (n >= 32) {
-	#if __BYTE_ORDER == __BIG_ENDIAN
-	#define LS <<
-	#define RS >>
+	cached = features | (cast(u32)1 << 31);
+	return features;
+}
+
+
+#if defined(GB_COMPILER_MSVC)
+	#define GB__TARGET_AVX2
+#else
+	#define GB__TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+gb_internal gb_inline i32 gb__ctz32(u32 x) {
+#if defined(GB_COMPILER_MSVC)
+	unsigned long index;
+	_BitScanForward(&index, x);
+	return cast(i32)index;
+#else
+	return __builtin_ctz(x);
+#endif
+}
+
+// NOTE(bill): Index of the highest set bit, x must not be 0
+#if !defined(GB_ARCH_64_BIT)
+gb_internal gb_inline i32 gb__fls32(u32 x) {
+#if defined(GB_COMPILER_MSVC)
+	unsigned long index;
+	_BitScanReverse(&index, x);
+	return cast(i32)index;
+#else
+	return 31 - __builtin_clz(x);
+#endif
+}
+#endif
+
+gb_internal gb_inline i32 gb__fls_usize(usize x) {
+#if defined(GB_ARCH_64_BIT)
+	#if defined(GB_COMPILER_MSVC)
+	unsigned long index;
+	_BitScanReverse64(&index, x);
+	return cast(i32)index;
 	#else
-	#define LS >>
-	#define RS <<
+	return 63 - __builtin_clzll(x);
 	#endif
-		switch (cast(uintptr)d % 4) {
-		case 1: {
-			w = *cast(u32 *)s;
-			*d++ = *s++;
-			*d++ = *s++;
-			*d++ = *s++;
-			n -= 3;
-			while (n > 16) {
-				x = *cast(u32 *)(s+1);
+#else
+	return gb__fls32(cast(u32)x);
+#endif
+}
+
+// NOTE(bill): Unaligned loads and stores which do not break strict aliasing, they are single moves
+gb_internal gb_inline u64 gb__load_u64(void const *p) {
+#if defined(GB_COMPILER_MSVC)
+	return *cast(u64 const *)p;
+#else
+	u64 v;
+	__builtin_memcpy(&v, p, 8);
+	return v;
+#endif
+}
+gb_internal gb_inline u32 gb__load_u32(void const *p) {
+#if defined(GB_COMPILER_MSVC)
+	return *cast(u32 const *)p;
+#else
+	u32 v;
+	__builtin_memcpy(&v, p, 4);
+	return v;
+#endif
+}
+gb_internal gb_inline void gb__store_u64(void *p, u64 v) {
+#if defined(GB_COMPILER_MSVC)
+	*cast(u64 *)p = v;
+#else
+	__builtin_memcpy(p, &v, 8);
+#endif
+}
+gb_internal gb_inline void gb__store_u32(void *p, u32 v) {
+#if defined(GB_COMPILER_MSVC)
+	*cast(u32 *)p = v;
+#else
+	__builtin_memcpy(p, &v, 4);
+#endif
+}
+
+
+#if defined(GB_SIMD_SSE2) || defined(GB_SIMD_NEON)
+// NOTE(bill): Copies of 0..16 bytes with overlapping loads and stores, no loops
+gb_internal gb_inline void gb__memcopy_16(u8 *d, u8 const *s, isize n) {
+	if (n >= 8) {
+		u64 a = gb__load_u64(s);
+		u64 b = gb__load_u64(s+n-8);
+		gb__store_u64(d,     a);
+		gb__store_u64(d+n-8, b);
+	} else if (n >= 4) {
+		u32 a = gb__load_u32(s);
+		u32 b = gb__load_u32(s+n-4);
+		gb__store_u32(d,     a);
+		gb__store_u32(d+n-4, b);
+	} else if (n > 0) {
+		u8 a = s[0], b = s[n>>1], c = s[n-1];
+		d[0]    = a;
+		d[n>>1] = b;
+		d[n-1]  = c;
+	}
+}
+
+gb_internal gb_inline void gb__memset_16(u8 *d, u8 c, isize n) {
+	if (n >= 8) {
+		u64 c64 = (cast(u64)-1)/255 * c;
+		gb__store_u64(d,     c64);
+		gb__store_u64(d+n-8, c64);
+	} else if (n >= 4) {
+		u32 c32 = (cast(u32)-1)/255 * c;
+		gb__store_u32(d,     c32);
+		gb__store_u32(d+n-4, c32);
+	} else if (n > 0) {
+		d[0] = d[n>>1] = d[n-1] = c;
+	}
+}
+#endif
+
+
+#if defined(GB_SIMD_SSE2)
+gb_internal gb_inline void gb__rep_movsb(void *dest, void const *source, isize n) {
+#if defined(GB_COMPILER_MSVC)
+	__movsb(cast(u8 *)dest, cast(u8 const *)source, n);
+#else
+	__asm__ __volatile__("rep movsb" : "+D"(dest), "+S"(source), "+c"(n) : : "memory");
+#endif
+}
+
+gb_internal gb_inline void gb__rep_stosb(void *dest, u8 c, isize n) {
+#if defined(GB_COMPILER_MSVC)
+	__stosb(cast(u8 *)dest, c, n);
+#else
+	__asm__ __volatile__("rep stosb" : "+D"(dest), "+c"(n) : "a"(c) : "memory");
+#endif
+}
+
+// NOTE(bill): The kernels are only called for n > 32
+gb_internal void *gb__memcopy_sse2(void *dest, void const *source, isize n) {
+	u8 *d = cast(u8 *)dest;
+	u8 const *s = cast(u8 const *)source;
+	u8 *d_end = d + n;
+	__m128i head, tail;
+	isize k;
+
+	if (n >= GB_MEMORY_REP_THRESHOLD && (gb_cpu_features() & gbCpuFeature_ERMS)) {
+		gb__rep_movsb(dest, source, n);
+		return dest;
+	}
+
+	head = _mm_loadu_si128(cast(__m128i const *)s);
+	tail = _mm_loadu_si128(cast(__m128i const *)(s+n-16));
+	_mm_storeu_si128(cast(__m128i *)d, head);
+
+	// NOTE(bill): Align the destination, the head store has already covered the skipped bytes
+	k = 16 - (cast(uintptr)d & 15);
+	d += k, s += k, n -= k;
+
+	for (; n > 64; d += 64, s += 64, n -= 64) {
+		__m128i a = _mm_loadu_si128(cast(__m128i const *)(s+ 0));
+		__m128i b = _mm_loadu_si128(cast(__m128i const *)(s+16));
+		__m128i c = _mm_loadu_si128(cast(__m128i const *)(s+32));
+		__m128i e = _mm_loadu_si128(cast(__m128i const *)(s+48));
+		_mm_store_si128(cast(__m128i *)(d+ 0), a);
+		_mm_store_si128(cast(__m128i *)(d+16), b);
+		_mm_store_si128(cast(__m128i *)(d+32), c);
+		_mm_store_si128(cast(__m128i *)(d+48), e);
+	}
+	for (; n > 16; d += 16, s += 16, n -= 16)
+		_mm_store_si128(cast(__m128i *)d, _mm_loadu_si128(cast(__m128i const *)s));
+
+	_mm_storeu_si128(cast(__m128i *)(d_end-16), tail);
+	return dest;
+}
+
+gb_internal void *gb__memset_sse2(void *dest, u8 c, isize n) {
+	u8 *d = cast(u8 *)dest;
+	u8 *d_end = d + n;
+	__m128i v = _mm_set1_epi8(cast(char)c);
+	isize k;
+
+	if (n >= GB_MEMORY_REP_THRESHOLD && (gb_cpu_features() & gbCpuFeature_ERMS)) {
+		gb__rep_stosb(dest, c, n);
+		return dest;
+	}
+
+	_mm_storeu_si128(cast(__m128i *)d, v);
+	k = 16 - (cast(uintptr)d & 15);
+	d += k, n -= k;
+	for (; n > 64; d += 64, n -= 64) {
+		_mm_store_si128(cast(__m128i *)(d+ 0), v);
+		_mm_store_si128(cast(__m128i *)(d+16), v);
+		_mm_store_si128(cast(__m128i *)(d+32), v);
+		_mm_store_si128(cast(__m128i *)(d+48), v);
+	}
+	for (; n > 16; d += 16, n -= 16)
+		_mm_store_si128(cast(__m128i *)d, v);
+	_mm_storeu_si128(cast(__m128i *)(d_end-16), v);
+	return dest;
+}
+
+gb_internal i32 gb__memcompare_sse2(void const *s1, void const *s2, isize n) {
+	u8 const *a = cast(u8 const *)s1;
+	u8 const *b = cast(u8 const *)s2;
+	for (; n >= 16; a += 16, b += 16, n -= 16) {
+		__m128i va = _mm_loadu_si128(cast(__m128i const *)a);
+		__m128i vb = _mm_loadu_si128(cast(__m128i const *)b);
+		u32 mask = cast(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) ^ 0xffff;
+		if (mask) {
+			i32 i = gb__ctz32(mask);
+			return a[i] - b[i];
+		}
+	}
+	for (; n > 0; a++, b++, n--) {
+		if (*a != *b)
+			return *a - *b;
+	}
+	return 0;
+}
+
+gb_internal void const *gb__memchr_sse2(void const *data, u8 c, isize n) {
+	u8 const *s = cast(u8 const *)data;
+	__m128i v = _mm_set1_epi8(cast(char)c);
+	for (; n >= 16; s += 16, n -= 16) {
+		u32 mask = cast(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(cast(__m128i const *)s), v));
+		if (mask)
+			return s + gb__ctz32(mask);
+	}
+	for (; n > 0; s++, n--) {
+		if (*s == c)
+			return s;
+	}
+	return NULL;
+}
+
+
+#if defined(GB_SIMD_AVX2)
+GB__TARGET_AVX2 gb_internal void *gb__memcopy_avx2(void *dest, void const *source, isize n) {
+	u8 *d = cast(u8 *)dest;
+	u8 const *s = cast(u8 const *)source;
+	u8 *d_end = d + n;
+	__m256i head, tail;
+	isize k;
+
+	if (n <= 64) {
+		head = _mm256_loadu_si256(cast(__m256i const *)s);
+		tail = _mm256_loadu_si256(cast(__m256i const *)(s+n-32));
+		_mm256_storeu_si256(cast(__m256i *)d, head);
+		_mm256_storeu_si256(cast(__m256i *)(d_end-32), tail);
+		return dest;
+	}
+	if (n >= GB_MEMORY_REP_THRESHOLD && (gb_cpu_features() & gbCpuFeature_ERMS)) {
+		gb__rep_movsb(dest, source, n);
+		return dest;
+	}
+
+	head = _mm256_loadu_si256(cast(__m256i const *)s);
+	tail = _mm256_loadu_si256(cast(__m256i const *)(s+n-32));
+	_mm256_storeu_si256(cast(__m256i *)d, head);
+
+	k = 32 - (cast(uintptr)d & 31);
+	d += k, s += k, n -= k;
+
+	for (; n > 128; d += 128, s += 128, n -= 128) {
+		__m256i a = _mm256_loadu_si256(cast(__m256i const *)(s+ 0));
+		__m256i b = _mm256_loadu_si256(cast(__m256i const *)(s+32));
+		__m256i c = _mm256_loadu_si256(cast(__m256i const *)(s+64));
+		__m256i e = _mm256_loadu_si256(cast(__m256i const *)(s+96));
+		_mm256_store_si256(cast(__m256i *)(d+ 0), a);
+		_mm256_store_si256(cast(__m256i *)(d+32), b);
+		_mm256_store_si256(cast(__m256i *)(d+64), c);
+		_mm256_store_si256(cast(__m256i *)(d+96), e);
+	}
+	for (; n > 32; d += 32, s += 32, n -= 32)
+		_mm256_store_si256(cast(__m256i *)d, _mm256_loadu_si256(cast(__m256i const *)s));
+
+	_mm256_storeu_si256(cast(__m256i *)(d_end-32), tail);
+	return dest;
+}
+
+GB__TARGET_AVX2 gb_internal void *gb__memset_avx2(void *dest, u8 c, isize n) {
+	u8 *d = cast(u8 *)dest;
+	u8 *d_end = d + n;
+	__m256i v = _mm256_set1_epi8(cast(char)c);
+	isize k;
+
+	if (n <= 64) {
+		_mm256_storeu_si256(cast(__m256i *)d, v);
+		_mm256_storeu_si256(cast(__m256i *)(d_end-32), v);
+		return dest;
+	}
+	if (n >= GB_MEMORY_REP_THRESHOLD && (gb_cpu_features() & gbCpuFeature_ERMS)) {
+		gb__rep_stosb(dest, c, n);
+		return dest;
+	}
+
+	_mm256_storeu_si256(cast(__m256i *)d, v);
+	k = 32 - (cast(uintptr)d & 31);
+	d += k, n -= k;
+	for (; n > 128; d += 128, n -= 128) {
+		_mm256_store_si256(cast(__m256i *)(d+ 0), v);
+		_mm256_store_si256(cast(__m256i *)(d+32), v);
+		_mm256_store_si256(cast(__m256i *)(d+64), v);
+		_mm256_store_si256(cast(__m256i *)(d+96), v);
+	}
+	for (; n > 32; d += 32, n -= 32)
+		_mm256_store_si256(cast(__m256i *)d, v);
+	_mm256_storeu_si256(cast(__m256i *)(d_end-32), v);
+	return dest;
+}
+
+GB__TARGET_AVX2 gb_internal i32 gb__memcompare_avx2(void const *s1, void const *s2, isize n) {
+	u8 const *a = cast(u8 const *)s1;
+	u8 const *b = cast(u8 const *)s2;
+	for (; n >= 32; a += 32, b += 32, n -= 32) {
+		__m256i va = _mm256_loadu_si256(cast(__m256i const *)a);
+		__m256i vb = _mm256_loadu_si256(cast(__m256i const *)b);
+		u32 mask = ~cast(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+		if (mask) {
+			i32 i = gb__ctz32(mask);
+			return a[i] - b[i];
+		}
+	}
+	return gb__memcompare_sse2(a, b, n);
+}
+
+GB__TARGET_AVX2 gb_internal void const *gb__memchr_avx2(void const *data, u8 c, isize n) {
+	u8 const *s = cast(u8 const *)data;
+	__m256i v = _mm256_set1_epi8(cast(char)c);
+	for (; n >= 32; s += 32, n -= 32) {
+		u32 mask = cast(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(cast(__m256i const *)s), v));
+		if (mask)
+			return s + gb__ctz32(mask);
+	}
+	return gb__memchr_sse2(s, c, n);
+}
+#endif
+
+
+// NOTE(bill): The kernels are picked on the first call of each and then called directly
+typedef void *      gbprivMemcopyProc   (void *dest, void const *source, isize n);
+typedef void *      gbprivMemsetProc    (void *dest, u8 c, isize n);
+typedef i32         gbprivMemcompareProc(void const *s1, void const *s2, isize n);
+typedef void const *gbprivMemchrProc    (void const *data, u8 c, isize n);
+
+gb_internal void *      gb__memcopy_resolve   (void *dest, void const *source, isize n);
+gb_internal void *      gb__memset_resolve    (void *dest, u8 c, isize n);
+gb_internal i32         gb__memcompare_resolve(void const *s1, void const *s2, isize n);
+gb_internal void const *gb__memchr_resolve    (void const *data, u8 c, isize n);
+
+gb_global gbprivMemcopyProc *   gb__memcopy_proc    = gb__memcopy_resolve;
+gb_global gbprivMemsetProc *    gb__memset_proc     = gb__memset_resolve;
+gb_global gbprivMemcompareProc *gb__memcompare_proc = gb__memcompare_resolve;
+gb_global gbprivMemchrProc *    gb__memchr_proc     = gb__memchr_resolve;
+
+gb_internal void gb__memory_procs_init(void) {
+	u32 features = gb_cpu_features();
+	gb_unused(features);
+#if defined(GB_SIMD_AVX2)
+	if (features & gbCpuFeature_AVX2) {
+		gb__memcopy_proc    = gb__memcopy_avx2;
+		gb__memset_proc     = gb__memset_avx2;
+		gb__memcompare_proc = gb__memcompare_avx2;
+		gb__memchr_proc     = gb__memchr_avx2;
+		return;
+	}
+#endif
+	gb__memcopy_proc    = gb__memcopy_sse2;
+	gb__memset_proc     = gb__memset_sse2;
+	gb__memcompare_proc = gb__memcompare_sse2;
+	gb__memchr_proc     = gb__memchr_sse2;
+}
+
+gb_internal void *gb__memcopy_resolve(void *dest, void const *source, isize n) {
+	gb__memory_procs_init();
+	return gb__memcopy_proc(dest, source, n);
+}
+gb_internal void *gb__memset_resolve(void *dest, u8 c, isize n) {
+	gb__memory_procs_init();
+	return gb__memset_proc(dest, c, n);
+}
+gb_internal i32 gb__memcompare_resolve(void const *s1, void const *s2, isize n) {
+	gb__memory_procs_init();
+	return gb__memcompare_proc(s1, s2, n);
+}
+gb_internal void const *gb__memchr_resolve(void const *data, u8 c, isize n) {
+	gb__memory_procs_init();
+	return gb__memchr_proc(data, c, n);
+}
+
+#elif defined(GB_SIMD_NEON)
+// NOTE(bill): NEON is always available on AArch64 so there is no need to dispatch
+
+// NOTE(bill): A 4 bit per byte mask of a 16 byte comparison result
+gb_internal gb_inline u64 gb__neon_mask(uint8x16_t eq) {
+	return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+}
+
+gb_internal void *gb__memcopy_proc(void *dest, void const *source, isize n) {
+	u8 *d = cast(u8 *)dest;
+	u8 const *s = cast(u8 const *)source;
+	u8 *d_end = d + n;
+	uint8x16_t tail = vld1q_u8(s+n-16);
+	for (; n > 64; d += 64, s += 64, n -= 64) {
+		uint8x16_t a = vld1q_u8(s+ 0);
+		uint8x16_t b = vld1q_u8(s+16);
+		uint8x16_t c = vld1q_u8(s+32);
+		uint8x16_t e = vld1q_u8(s+48);
+		vst1q_u8(d+ 0, a);
+		vst1q_u8(d+16, b);
+		vst1q_u8(d+32, c);
+		vst1q_u8(d+48, e);
+	}
+	for (; n > 16; d += 16, s += 16, n -= 16)
+		vst1q_u8(d, vld1q_u8(s));
+	vst1q_u8(d_end-16, tail);
+	return dest;
+}
+
+gb_internal void *gb__memset_proc(void *dest, u8 c, isize n) {
+	u8 *d = cast(u8 *)dest;
+	u8 *d_end = d + n;
+	uint8x16_t v = vdupq_n_u8(c);
+	for (; n > 64; d += 64, n -= 64) {
+		vst1q_u8(d+ 0, v);
+		vst1q_u8(d+16, v);
+		vst1q_u8(d+32, v);
+		vst1q_u8(d+48, v);
+	}
+	for (; n > 16; d += 16, n -= 16)
+		vst1q_u8(d, v);
+	vst1q_u8(d_end-16, v);
+	return dest;
+}
+
+gb_internal i32 gb__memcompare_proc(void const *s1, void const *s2, isize n) {
+	u8 const *a = cast(u8 const *)s1;
+	u8 const *b = cast(u8 const *)s2;
+	for (; n >= 16; a += 16, b += 16, n -= 16) {
+		uint8x16_t eq = vceqq_u8(vld1q_u8(a), vld1q_u8(b));
+		if (vminvq_u8(eq) != 0xff) {
+			i32 i = __builtin_ctzll(~gb__neon_mask(eq)) >> 2;
+			return a[i] - b[i];
+		}
+	}
+	for (; n > 0; a++, b++, n--) {
+		if (*a != *b)
+			return *a - *b;
+	}
+	return 0;
+}
+
+gb_internal void const *gb__memchr_proc(void const *data, u8 c, isize n) {
+	u8 const *s = cast(u8 const *)data;
+	uint8x16_t v = vdupq_n_u8(c);
+	for (; n >= 16; s += 16, n -= 16) {
+		u64 mask = gb__neon_mask(vceqq_u8(vld1q_u8(s), v));
+		if (mask)
+			return s + (__builtin_ctzll(mask) >> 2);
+	}
+	for (; n > 0; s++, n--) {
+		if (*s == c)
+			return s;
+	}
+	return NULL;
+}
+#endif
+
+
+#if defined(_MSC_VER)
+#pragma intrinsic(__movsb)
+#endif
+
+gb_inline void *gb_memcopy(void *dest, void const *source, isize n) {
+#if defined(GB_SIMD_SSE2) || defined(GB_SIMD_NEON)
+	u8 *d = cast(u8 *)dest;
+	u8 const *s = cast(u8 const *)source;
+	if (n <= 16) {
+		gb__memcopy_16(d, s, n);
+	} else if (n <= 32) {
+	#if defined(GB_SIMD_SSE2)
+		__m128i a = _mm_loadu_si128(cast(__m128i const *)s);
+		__m128i b = _mm_loadu_si128(cast(__m128i const *)(s+n-16));
+		_mm_storeu_si128(cast(__m128i *)d, a);
+		_mm_storeu_si128(cast(__m128i *)(d+n-16), b);
+	#else
+		uint8x16_t a = vld1q_u8(s);
+		uint8x16_t b = vld1q_u8(s+n-16);
+		vst1q_u8(d, a);
+		vst1q_u8(d+n-16, b);
+	#endif
+	} else {
+		gb__memcopy_proc(dest, source, n);
+	}
+#elif defined(_MSC_VER)
+	// TODO(bill): Is this good enough?
+	__movsb(cast(u8 *)dest, cast(u8 *)source, n);
+#elif defined(GB_CPU_X86)
+	__asm__ __volatile__("rep movsb" : "+D"(cast(u8 *)dest), "+S"(cast(u8 *)source), "+c"(n) : : "memory");
+#else
+	u8 *d = cast(u8 *)dest;
+	u8 const *s = cast(u8 const *)source;
+	u32 w, x;
+
+	for (; cast(uintptr)s % 4 && n; n--)
+		*d++ = *s++;
+
+	if (cast(uintptr)d % 4 == 0) {
+		for (; n >= 16;
+		     s += 16, d += 16, n -= 16) {
+			*cast(u32 *)(d+ 0) = *cast(u32 *)(s+ 0);
+			*cast(u32 *)(d+ 4) = *cast(u32 *)(s+ 4);
+			*cast(u32 *)(d+ 8) = *cast(u32 *)(s+ 8);
+			*cast(u32 *)(d+12) = *cast(u32 *)(s+12);
+		}
+		if (n & 8) {
+			*cast(u32 *)(d+0) = *cast(u32 *)(s+0);
+			*cast(u32 *)(d+4) = *cast(u32 *)(s+4);
+			d += 8;
+			s += 8;
+		}
+		if (n&4) {
+			*cast(u32 *)(d+0) = *cast(u32 *)(s+0);
+			d += 4;
+			s += 4;
+		}
+		if (n&2) {
+			*d++ = *s++; *d++ = *s++;
+		}
+		if (n&1) {
+			*d = *s;
+		}
+		return dest;
+	}
+
+	if (n >= 32) {
+	#if __BYTE_ORDER == __BIG_ENDIAN
+	#define LS <<
+	#define RS >>
+	#else
+	#define LS >>
+	#define RS <<
+	#endif
+		switch (cast(uintptr)d % 4) {
+		case 1: {
+			w = *cast(u32 *)s;
+			*d++ = *s++;
+			*d++ = *s++;
+			*d++ = *s++;
+			n -= 3;
+			while (n > 16) {
+				x = *cast(u32 *)(s+1);
 				*cast(u32 *)(d+0)  = (w LS 24) | (x RS 8);
 				w = *cast(u32 *)(s+5);
 				*cast(u32 *)(d+4)  = (x LS 24) | (w RS 8);
@@ -3797,6 +5744,25 @@ gb_inline void *gb_memmove(void *dest, void const *source, isize n) {
 }
 
 gb_inline void *gb_memset(void *dest, u8 c, isize n) {
+#if defined(GB_SIMD_SSE2) || defined(GB_SIMD_NEON)
+	u8 *d = cast(u8 *)dest;
+	if (n <= 16) {
+		gb__memset_16(d, c, n);
+	} else if (n <= 32) {
+	#if defined(GB_SIMD_SSE2)
+		__m128i v = _mm_set1_epi8(cast(char)c);
+		_mm_storeu_si128(cast(__m128i *)d, v);
+		_mm_storeu_si128(cast(__m128i *)(d+n-16), v);
+	#else
+		uint8x16_t v = vdupq_n_u8(c);
+		vst1q_u8(d, v);
+		vst1q_u8(d+n-16, v);
+	#endif
+	} else {
+		gb__memset_proc(dest, c, n);
+	}
+	return dest;
+#else
 	u8 *s = cast(u8 *)dest;
 	isize k;
 	u32 c32 = ((u32)-1)/255 * c;
@@ -3857,11 +5823,13 @@ gb_inline void *gb_memset(void *dest, u8 c, isize n) {
 	}
 
 	return dest;
+#endif
 }
 
 gb_inline i32 gb_memcompare(void const *s1, void const *s2, isize size) {
-	// TODO(bill): Heavily optimize
-
+#if defined(GB_SIMD_SSE2) || defined(GB_SIMD_NEON)
+	return gb__memcompare_proc(s1, s2, size);
+#else
 	u8 const *s1p8 = cast(u8 const *)s1;
 	u8 const *s2p8 = cast(u8 const *)s2;
 	while (size--) {
@@ -3870,6 +5838,7 @@ gb_inline i32 gb_memcompare(void const *s1, void const *s2, isize size) {
 		s1p8++, s2p8++;
 	}
 	return 0;
+#endif
 }
 
 void gb_memswap(void *i, void *j, isize size) {
@@ -3911,6 +5880,9 @@ void gb_memswap(void *i, void *j, isize size) {
 
 
 void const *gb_memchr(void const *data, u8 c, isize n) {
+#if defined(GB_SIMD_SSE2) || defined(GB_SIMD_NEON)
+	return gb__memchr_proc(data, c, n);
+#else
 	u8 const *s = cast(u8 const *)data;
 	while ((cast(uintptr)s & (sizeof(usize)-1)) &&
 	       n && *s != c) {
@@ -3933,6 +5905,7 @@ void const *gb_memchr(void const *data, u8 c, isize n) {
 	}
 
 	return n ? cast(void const *)s : NULL;
+#endif
 }
 
 
@@ -4334,12 +6307,32 @@ gb_inline i64 gb_atomic64_fetch_or(gbAtomic64 volatile *a, i64 operand) {
 #error TODO(bill): Implement Atomics for this CPU
 #endif
 
+// NOTE(bill): Exponential backoff for spinning: pause for twice as long each time until the limit
+// is reached and then give up the time slice
+#ifndef GB_SPIN_BACKOFF_LIMIT
+#define GB_SPIN_BACKOFF_LIMIT 64
+#endif
+
+gb_internal gb_inline void gb__spin_backoff(i32 *backoff) {
+	if (*backoff <= GB_SPIN_BACKOFF_LIMIT) {
+		i32 i;
+		for (i = 0; i < *backoff; i++)
+			gb_yield_thread();
+		*backoff *= 2;
+	} else {
+		gb_yield();
+	}
+}
+
 gb_inline b32 gb_atomic32_spin_lock(gbAtomic32 volatile *a, isize time_out) {
-	i32 old_value = gb_atomic32_compare_exchange(a, 1, 0);
-	i32 counter = 0;
+	i32 old_value = gb_atomic32_compare_exchange(a, 0, 1);
+	i32 counter = 0, backoff = 1;
 	while (old_value != 0 && (time_out < 0 || counter++ < time_out)) {
-		gb_yield_thread();
-		old_value = gb_atomic32_compare_exchange(a, 1, 0);
+		gb__spin_backoff(&backoff);
+		// NOTE(bill): Wait until it looks free before trying to take it again
+		if (gb_atomic32_load(a) != 0)
+			continue;
+		old_value = gb_atomic32_compare_exchange(a, 0, 1);
 		gb_mfence();
 	}
 	return old_value == 0;
@@ -4350,11 +6343,14 @@ gb_inline void gb_atomic32_spin_unlock(gbAtomic32 volatile *a) {
 }
 
 gb_inline b32 gb_atomic64_spin_lock(gbAtomic64 volatile *a, isize time_out) {
-	i64 old_value = gb_atomic64_compare_exchange(a, 1, 0);
+	i64 old_value = gb_atomic64_compare_exchange(a, 0, 1);
 	i64 counter = 0;
+	i32 backoff = 1;
 	while (old_value != 0 && (time_out < 0 || counter++ < time_out)) {
-		gb_yield_thread();
-		old_value = gb_atomic64_compare_exchange(a, 1, 0);
+		gb__spin_backoff(&backoff);
+		if (gb_atomic64_load(a) != 0)
+			continue;
+		old_value = gb_atomic64_compare_exchange(a, 0, 1);
 		gb_mfence();
 	}
 	return old_value == 0;
@@ -4368,7 +6364,7 @@ gb_inline void gb_atomic64_spin_unlock(gbAtomic64 volatile *a) {
 gb_inline b32 gb_atomic32_try_acquire_lock(gbAtomic32 volatile *a) {
 	i32 old_value;
 	gb_yield_thread();
-	old_value = gb_atomic32_compare_exchange(a, 1, 0);
+	old_value = gb_atomic32_compare_exchange(a, 0, 1);
 	gb_mfence();
 	return old_value == 0;
 }
@@ -4376,7 +6372,7 @@ gb_inline b32 gb_atomic32_try_acquire_lock(gbAtomic32 volatile *a) {
 gb_inline b32 gb_atomic64_try_acquire_lock(gbAtomic64 volatile *a) {
 	i64 old_value;
 	gb_yield_thread();
-	old_value = gb_atomic64_compare_exchange(a, 1, 0);
+	old_value = gb_atomic64_compare_exchange(a, 0, 1);
 	gb_mfence();
 	return old_value == 0;
 }
@@ -4524,21 +6520,107 @@ gb_inline void gb_semaphore_release(gbSemaphore *s) { gb_semaphore_post(s, 1); }
 #error
 #endif
 
-// NOTE(bill): THIS IS FUCKING AWESOME THAT THIS "MUTEX" IS FAST AND RECURSIVE TOO!
-// NOTE(bill): WHO THE FUCK NEEDS A NORMAL MUTEX NOW?!?!?!?!
-gb_inline void gb_mutex_init(gbMutex *m) {
-	gb_atomic32_store(&m->counter, 0);
-	gb_atomic32_store(&m->owner, gb_thread_current_id());
-	gb_semaphore_init(&m->semaphore);
-	m->recursion = 0;
-}
 
-gb_inline void gb_mutex_destroy(gbMutex *m) { gb_semaphore_destroy(&m->semaphore); }
+#if defined(GB_HAS_FUTEX)
+#if defined(GB_SYSTEM_WINDOWS)
+	gb_inline void gb_futex_wait     (gbAtomic32 volatile *a, i32 expected) { WaitOnAddress(cast(void volatile *)&a->value, &expected, gb_size_of(expected), INFINITE); }
+	gb_inline void gb_futex_signal   (gbAtomic32 volatile *a)               { WakeByAddressSingle(cast(void *)&a->value); }
+	gb_inline void gb_futex_broadcast(gbAtomic32 volatile *a)               { WakeByAddressAll(cast(void *)&a->value); }
+#else
+	gb_inline void gb_futex_wait     (gbAtomic32 volatile *a, i32 expected) { syscall(SYS_futex, &a->value, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0); }
+	gb_inline void gb_futex_signal   (gbAtomic32 volatile *a)               { syscall(SYS_futex, &a->value, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0); }
+	gb_inline void gb_futex_broadcast(gbAtomic32 volatile *a)               { syscall(SYS_futex, &a->value, FUTEX_WAKE_PRIVATE, I32_MAX, NULL, NULL, 0); }
+#endif
+#endif
 
-gb_inline void gb_mutex_lock(gbMutex *m) {
-	i32 thread_id = cast(i32)gb_thread_current_id();
-	if (gb_atomic32_fetch_add(&m->counter, 1) > 0) {
-		if (thread_id != gb_atomic32_load(&m->owner))
+
+gb_inline void gb_fast_semaphore_init(gbFastSemaphore *s) {
+	gb_atomic32_store(&s->count, 0);
+#if defined(GB_HAS_FUTEX)
+	gb_atomic32_store(&s->wake_count, 0);
+#else
+	gb_semaphore_init(&s->semaphore);
+#endif
+}
+
+gb_inline void gb_fast_semaphore_destroy(gbFastSemaphore *s) {
+#if defined(GB_HAS_FUTEX)
+	gb_unused(s);
+#else
+	gb_semaphore_destroy(&s->semaphore);
+#endif
+}
+
+gb_inline b32 gb_fast_semaphore_try_wait(gbFastSemaphore *s) {
+	i32 count = gb_atomic32_load(&s->count);
+	while (count > 0) {
+		i32 previous = gb_atomic32_compare_exchange(&s->count, count, count-1);
+		if (previous == count)
+			return true;
+		count = previous;
+	}
+	return false;
+}
+
+void gb_fast_semaphore_wait(gbFastSemaphore *s) {
+	isize spin;
+	for (spin = 0; spin < GB_FAST_SEMAPHORE_SPIN_COUNT; spin++) {
+		if (gb_fast_semaphore_try_wait(s))
+			return;
+		gb_yield_thread();
+	}
+
+	if (gb_atomic32_fetch_add(&s->count, -1) > 0)
+		return;
+
+	// NOTE(bill): Park until a post hands this thread a wake up
+#if defined(GB_HAS_FUTEX)
+	for (;;) {
+		i32 wake_count = gb_atomic32_load(&s->wake_count);
+		if (wake_count > 0) {
+			if (gb_atomic32_compare_exchange(&s->wake_count, wake_count, wake_count-1) == wake_count)
+				return;
+		} else {
+			gb_futex_wait(&s->wake_count, 0);
+		}
+	}
+#else
+	gb_semaphore_wait(&s->semaphore);
+#endif
+}
+
+void gb_fast_semaphore_post(gbFastSemaphore *s, i32 count) {
+	i32 previous = gb_atomic32_fetch_add(&s->count, count);
+	i32 wake_count = previous < 0 ? -previous : 0;
+	if (wake_count > count) wake_count = count;
+	if (wake_count > 0) {
+#if defined(GB_HAS_FUTEX)
+		gb_atomic32_fetch_add(&s->wake_count, wake_count);
+		if (wake_count == 1) gb_futex_signal(&s->wake_count);
+		else                 gb_futex_broadcast(&s->wake_count);
+#else
+		gb_semaphore_post(&s->semaphore, wake_count);
+#endif
+	}
+}
+
+gb_inline void gb_fast_semaphore_release(gbFastSemaphore *s) { gb_fast_semaphore_post(s, 1); }
+
+// NOTE(bill): THIS IS FUCKING AWESOME THAT THIS "MUTEX" IS FAST AND RECURSIVE TOO!
+// NOTE(bill): WHO THE FUCK NEEDS A NORMAL MUTEX NOW?!?!?!?!
+gb_inline void gb_mutex_init(gbMutex *m) {
+	gb_atomic32_store(&m->counter, 0);
+	gb_atomic32_store(&m->owner, 0);
+	gb_semaphore_init(&m->semaphore);
+	m->recursion = 0;
+}
+
+gb_inline void gb_mutex_destroy(gbMutex *m) { gb_semaphore_destroy(&m->semaphore); }
+
+gb_inline void gb_mutex_lock(gbMutex *m) {
+	i32 thread_id = cast(i32)gb_thread_current_id();
+	if (gb_atomic32_fetch_add(&m->counter, 1) > 0) {
+		if (thread_id != gb_atomic32_load(&m->owner))
 			gb_semaphore_wait(&m->semaphore);
 	}
 
@@ -4554,7 +6636,7 @@ gb_inline b32 gb_mutex_try_lock(gbMutex *m) {
 		i32 expected = 0;
 		if (gb_atomic32_load(&m->counter) != 0)
 			return false;
-		if (!gb_atomic32_compare_exchange(&m->counter, expected, 1))
+		if (gb_atomic32_compare_exchange(&m->counter, expected, 1) != expected)
 			return false;
 		gb_atomic32_store(&m->owner, thread_id);
 	}
@@ -4571,7 +6653,7 @@ gb_inline void gb_mutex_unlock(gbMutex *m) {
 
 	recursion = --m->recursion;
 	if (recursion == 0)
-		gb_atomic32_store(&m->owner, thread_id);
+		gb_atomic32_store(&m->owner, 0);
 
 	if (gb_atomic32_fetch_add(&m->counter, -1) > 1) {
 		if (recursion == 0)
@@ -4672,7 +6754,8 @@ gb_inline u32 gb_thread_current_id(void) {
 #elif defined(GB_ARCH_32_BIT) && defined(GB_CPU_X86)
 	__asm__("mov %%gs:0x08,%0" : "=r"(thread_id));
 #elif defined(GB_ARCH_64_BIT) && defined(GB_CPU_X86)
-	__asm__("mov %%gs:0x10,%0" : "=r"(thread_id));
+	// NOTE(bill): x86-64 uses %fs for the thread control block, which points to itself at 0x10
+	__asm__("mov %%fs:0x10,%0" : "=r"(thread_id));
 #else
 	#error Unsupported architecture for gb_thread_current_id()
 #endif
@@ -4801,6 +6884,7 @@ gb_inline gbAllocator gb_heap_allocator(void) {
 
 GB_ALLOCATOR_PROC(gb_heap_allocator_proc) {
 	void *ptr = NULL;
+	GB_PROFILE_BEGIN("gb_heap_allocator_proc");
 	gb_unused(allocator_data);
 	gb_unused(old_size);
 // TODO(bill): Throughly test!
@@ -4844,6 +6928,7 @@ GB_ALLOCATOR_PROC(gb_heap_allocator_proc) {
 		break;
 	}
 
+	GB_PROFILE_END();
 	return ptr;
 }
 
@@ -4978,13 +7063,512 @@ isize gb_affinity_thread_count_for_core(gbAffinity *a, isize core) {
 }
 
 #elif defined(GB_SYSTEM_LINUX)
-#error TODO(bill): Implement gbAffinity for linux
+gb_internal isize gb__read_small_file(char const *path, char *buf, isize cap) {
+	isize len = 0;
+	int fd = open(path, O_RDONLY);
+	if (fd >= 0) {
+		ssize_t n;
+		while (len < cap-1 && (n = read(fd, buf+len, cap-1-len)) > 0)
+			len += n;
+		close(fd);
+	}
+	buf[len] = '\0';
+	return len;
+}
+
+void gb_affinity_init(gbAffinity *a) {
+	u8 assigned[GB_LINUX_MAX_THREADS] = {0};
+	long count = sysconf(_SC_NPROCESSORS_CONF);
+	isize cpu;
+
+	a->is_accurate      = false;
+	a->thread_count     = 0;
+	a->core_count       = 0;
+	a->threads_per_core = 1;
+
+	if (count > GB_LINUX_MAX_THREADS)
+		count = GB_LINUX_MAX_THREADS;
+
+	// NOTE(bill): Siblings are not numbered consistently between machines so the topology is read
+	// from sysfs. Each core's logical cpus are stored contiguously from core_first[core]
+	for (cpu = 0; cpu < count; cpu++) {
+		char path[128], list[256];
+		char *c;
+		isize first;
+
+		if (assigned[cpu])
+			continue;
+		gb_snprintf(path, gb_size_of(path), "/sys/devices/system/cpu/cpu%td/topology/thread_siblings_list", cpu);
+		if (gb__read_small_file(path, list, gb_size_of(list)) == 0)
+			continue; // NOTE(bill): Offline
+
+		first = a->thread_count;
+		a->core_first[a->core_count] = cast(u16)first;
+		c = list;
+		while (gb_char_is_digit(*c)) {
+			isize lo, hi, i;
+			lo = hi = cast(isize)gb_str_to_i64(c, &c, 10);
+			if (*c == '-')
+				hi = cast(isize)gb_str_to_i64(c+1, &c, 10);
+			for (i = lo; i <= hi && i < GB_LINUX_MAX_THREADS; i++) {
+				if (!assigned[i]) {
+					assigned[i] = true;
+					a->core_cpus[a->thread_count++] = cast(u16)i;
+				}
+			}
+			if (*c == ',') c++;
+		}
+		if (!assigned[cpu]) {
+			// NOTE(bill): Malformed list, at least keep this cpu
+			assigned[cpu] = true;
+			a->core_cpus[a->thread_count++] = cast(u16)cpu;
+		}
+
+		if (a->threads_per_core < a->thread_count - first)
+			a->threads_per_core = a->thread_count - first;
+		a->core_count++;
+		a->is_accurate = true;
+	}
+
+	if (a->core_count == 0) {
+		// NOTE(bill): No sysfs, treat every online cpu as its own core
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		if (online < 1) online = 1;
+		if (online > GB_LINUX_MAX_THREADS) online = GB_LINUX_MAX_THREADS;
+		for (cpu = 0; cpu < online; cpu++) {
+			a->core_first[cpu] = cast(u16)cpu;
+			a->core_cpus[cpu]  = cast(u16)cpu;
+		}
+		a->core_count   = online;
+		a->thread_count = online;
+	}
+	a->core_first[a->core_count] = cast(u16)a->thread_count;
+}
+
+void gb_affinity_destroy(gbAffinity *a) {
+	gb_unused(a);
+}
+
+b32 gb_affinity_set(gbAffinity *a, isize core, isize thread_index) {
+	// NOTE(bill): The mask is built by hand and passed straight to the syscall as cpu_set_t,
+	// CPU_SET and pthread_setaffinity_np all need _GNU_SOURCE before the first system header
+	unsigned long mask[GB_LINUX_MAX_THREADS / (8*gb_size_of(unsigned long))] = {0};
+	isize bits = 8*gb_size_of(unsigned long);
+	isize cpu;
+
+	GB_ASSERT(core >= 0 && core < a->core_count);
+	GB_ASSERT(thread_index >= 0 && thread_index < gb_affinity_thread_count_for_core(a, core));
+
+	cpu = a->core_cpus[a->core_first[core] + thread_index];
+	mask[cpu / bits] |= 1ul << (cpu % bits);
+	// NOTE(bill): A pid of 0 is the calling thread
+	return syscall(SYS_sched_setaffinity, 0, gb_size_of(mask), mask) == 0;
+}
+
+isize gb_affinity_thread_count_for_core(gbAffinity *a, isize core) {
+	GB_ASSERT(core >= 0 && core < a->core_count);
+	return a->core_first[core+1] - a->core_first[core];
+}
+
 #else
 #error TODO(bill): Unknown system
 #endif
 
 
 
+gb_internal i64 gb__queue_capacity(isize capacity) {
+	i64 result = 2;
+	GB_ASSERT(capacity > 0);
+	while (result < capacity)
+		result <<= 1;
+	return result;
+}
+
+void gb_spsc_queue_init(gbSpscQueue *q, gbAllocator a, isize capacity, isize element_size) {
+	i64 size = gb__queue_capacity(capacity);
+	gb_zero_item(q);
+	q->allocator    = a;
+	q->element_size = element_size;
+	q->mask         = size-1;
+	q->buffer       = cast(u8 *)gb_alloc_align(a, cast(isize)size * element_size, GB_CACHE_LINE_SIZE);
+	GB_ASSERT_NOT_NULL(q->buffer);
+}
+
+gb_inline void gb_spsc_queue_destroy(gbSpscQueue *q) {
+	gb_free(q->allocator, q->buffer);
+	q->buffer = NULL;
+}
+
+b32 gb_spsc_queue_push(gbSpscQueue *q, void const *element) {
+	i64 tail = q->tail.value; // NOTE(bill): Only the producer writes to tail
+	if (tail - q->cached_head > q->mask) {
+		// NOTE(bill): Only touch the consumer's cache line when the queue looks full
+		q->cached_head = gb_atomic64_load(&q->head);
+		if (tail - q->cached_head > q->mask)
+			return false;
+	}
+	gb_memcopy(q->buffer + (tail & q->mask)*q->element_size, element, q->element_size);
+	gb_sfence();
+	gb_atomic64_store(&q->tail, tail+1);
+	return true;
+}
+
+b32 gb_spsc_queue_pop(gbSpscQueue *q, void *element) {
+	i64 head = q->head.value; // NOTE(bill): Only the consumer writes to head
+	if (head >= q->cached_tail) {
+		q->cached_tail = gb_atomic64_load(&q->tail);
+		if (head >= q->cached_tail)
+			return false;
+	}
+	gb_lfence();
+	gb_memcopy(element, q->buffer + (head & q->mask)*q->element_size, q->element_size);
+	gb_mfence(); // NOTE(bill): The element must be read before the producer can reuse the slot
+	gb_atomic64_store(&q->head, head+1);
+	return true;
+}
+
+gb_inline isize gb_spsc_queue_count(gbSpscQueue *q) {
+	i64 head = gb_atomic64_load(&q->head);
+	i64 tail = gb_atomic64_load(&q->tail);
+	return tail > head ? cast(isize)(tail - head) : 0;
+}
+
+
+// NOTE(bill): Every cell is a gbAtomic64 sequence number followed by the element
+gb_internal gb_inline gbAtomic64 *gb__mpmc_cell(gbMpmcQueue *q, i64 pos) {
+	return cast(gbAtomic64 *)(q->cells + (pos & q->mask)*q->cell_size);
+}
+
+void gb_mpmc_queue_init(gbMpmcQueue *q, gbAllocator a, isize capacity, isize element_size) {
+	i64 i, size = gb__queue_capacity(capacity);
+	gb_zero_item(q);
+	q->allocator    = a;
+	q->element_size = element_size;
+	q->cell_size    = gb_size_of(gbAtomic64) + ((element_size + 7) & ~cast(isize)7);
+	q->mask         = size-1;
+	q->cells        = cast(u8 *)gb_alloc_align(a, cast(isize)size * q->cell_size, GB_CACHE_LINE_SIZE);
+	GB_ASSERT_NOT_NULL(q->cells);
+	for (i = 0; i < size; i++)
+		gb_atomic64_store(gb__mpmc_cell(q, i), i);
+}
+
+gb_inline void gb_mpmc_queue_destroy(gbMpmcQueue *q) {
+	gb_free(q->allocator, q->cells);
+	q->cells = NULL;
+}
+
+b32 gb_mpmc_queue_push(gbMpmcQueue *q, void const *element) {
+	gbAtomic64 *cell;
+	i64 pos = gb_atomic64_load(&q->tail);
+	for (;;) {
+		i64 seq, diff;
+		cell = gb__mpmc_cell(q, pos);
+		seq  = gb_atomic64_load(cell);
+		diff = seq - pos;
+		if (diff == 0) {
+			i64 previous = gb_atomic64_compare_exchange(&q->tail, pos, pos+1);
+			if (previous == pos)
+				break;
+			pos = previous;
+		} else if (diff < 0) {
+			return false; // NOTE(bill): Full
+		} else {
+			pos = gb_atomic64_load(&q->tail);
+		}
+	}
+	gb_memcopy(cell+1, element, q->element_size);
+	gb_sfence();
+	gb_atomic64_store(cell, pos+1);
+	return true;
+}
+
+b32 gb_mpmc_queue_pop(gbMpmcQueue *q, void *element) {
+	gbAtomic64 *cell;
+	i64 pos = gb_atomic64_load(&q->head);
+	for (;;) {
+		i64 seq, diff;
+		cell = gb__mpmc_cell(q, pos);
+		seq  = gb_atomic64_load(cell);
+		diff = seq - (pos+1);
+		if (diff == 0) {
+			i64 previous = gb_atomic64_compare_exchange(&q->head, pos, pos+1);
+			if (previous == pos)
+				break;
+			pos = previous;
+		} else if (diff < 0) {
+			return false; // NOTE(bill): Empty
+		} else {
+			pos = gb_atomic64_load(&q->head);
+		}
+	}
+	gb_lfence();
+	gb_memcopy(element, cell+1, q->element_size);
+	gb_mfence();
+	gb_atomic64_store(cell, pos + q->mask + 1);
+	return true;
+}
+
+gb_inline isize gb_mpmc_queue_count(gbMpmcQueue *q) {
+	i64 head = gb_atomic64_load(&q->head);
+	i64 tail = gb_atomic64_load(&q->tail);
+	return tail > head ? cast(isize)(tail - head) : 0;
+}
+
+
+
+gb_global gb_thread_local gbJobWorker *gb__job_worker = NULL;
+
+gb_internal b32 gb__job_deque_push(gbJobDeque *d, gbJob job) {
+	i64 b = gb_atomic64_load(&d->bottom);
+	i64 t = gb_atomic64_load(&d->top);
+	if (b - t >= GB_JOB_DEQUE_SIZE)
+		return false;
+	d->jobs[b & (GB_JOB_DEQUE_SIZE-1)] = job;
+	gb_sfence(); // NOTE(bill): The job must be visible before the new bottom
+	gb_atomic64_store(&d->bottom, b+1);
+	return true;
+}
+
+gb_internal b32 gb__job_deque_pop(gbJobDeque *d, gbJob *job) {
+	i64 b = gb_atomic64_load(&d->bottom) - 1;
+	i64 t;
+	b32 result = true;
+	gb_atomic64_store(&d->bottom, b);
+	gb_mfence(); // NOTE(bill): The new bottom must be visible to thieves before top is read
+	t = gb_atomic64_load(&d->top);
+	if (t <= b) {
+		*job = d->jobs[b & (GB_JOB_DEQUE_SIZE-1)];
+		if (t == b) {
+			// NOTE(bill): Last job, race the thieves for it
+			if (gb_atomic64_compare_exchange(&d->top, t, t+1) != t)
+				result = false;
+			gb_atomic64_store(&d->bottom, b+1);
+		}
+	} else {
+		result = false;
+		gb_atomic64_store(&d->bottom, b+1);
+	}
+	return result;
+}
+
+gb_internal b32 gb__job_deque_steal(gbJobDeque *d, gbJob *job) {
+	i64 t = gb_atomic64_load(&d->top);
+	i64 b;
+	gb_mfence();
+	b = gb_atomic64_load(&d->bottom);
+	if (t < b) {
+		*job = d->jobs[t & (GB_JOB_DEQUE_SIZE-1)];
+		gb_lfence();
+		if (gb_atomic64_compare_exchange(&d->top, t, t+1) == t)
+			return true;
+	}
+	return false;
+}
+
+
+gb_internal void gb__job_execute(gbJob *job) {
+	job->proc(job->data);
+	if (job->counter) {
+		gb_mfence();
+		gb_atomic32_fetch_add(&job->counter->count, -1);
+	}
+}
+
+gb_internal b32 gb__job_find(gbJobSystem *js, gbJobWorker *w, gbJob *job) {
+	isize i, start;
+	if (gb__job_deque_pop(w->deque, job))
+		return true;
+	if (js->worker_count <= 1)
+		return false;
+
+	// NOTE(bill): xorshift to pick a random worker to start stealing from
+	w->steal_seed ^= w->steal_seed << 13;
+	w->steal_seed ^= w->steal_seed >> 17;
+	w->steal_seed ^= w->steal_seed << 5;
+	start = cast(isize)(w->steal_seed % cast(u32)js->worker_count);
+	for (i = 0; i < js->worker_count; i++) {
+		isize index = (start + i) % js->worker_count;
+		if (index != w->index && gb__job_deque_steal(js->workers[index].deque, job))
+			return true;
+	}
+	return false;
+}
+
+gb_internal b32 gb__job_system_has_work(gbJobSystem *js) {
+	isize i;
+	for (i = 0; i < js->worker_count; i++) {
+		gbJobDeque *d = js->workers[i].deque;
+		if (gb_atomic64_load(&d->top) < gb_atomic64_load(&d->bottom))
+			return true;
+	}
+	return false;
+}
+
+gb_internal void gb__job_system_wake(gbJobSystem *js) {
+	gb_mfence();
+	if (gb_atomic32_load(&js->sleeping_count) > 0) {
+		gb_mutex_lock(&js->sleep_mutex);
+		// NOTE(bill): Only sleepers are counted and only one post is made per sleeper so no wake up
+		// is lost nor is the semaphore overposted
+		if (js->sleeping_count.value > 0) {
+			js->sleeping_count.value--;
+			gb_fast_semaphore_release(&js->sleep_semaphore);
+		}
+		gb_mutex_unlock(&js->sleep_mutex);
+	}
+}
+
+gb_internal GB_THREAD_PROC(gb__job_worker_proc) {
+	gbJobWorker *w  = cast(gbJobWorker *)data;
+	gbJobSystem *js = w->system;
+	isize spin_count = 0;
+
+	gb__job_worker = w;
+	if (js->affinity.core_count > 1) {
+		isize core = w->index % js->affinity.core_count;
+		gb_affinity_set(&js->affinity, core, 0);
+	}
+
+	while (gb_atomic32_load(&js->is_running)) {
+		gbJob job;
+		if (gb__job_find(js, w, &job)) {
+			gb__job_execute(&job);
+			spin_count = 0;
+		} else if (spin_count < 64) {
+			spin_count++;
+			gb_yield_thread();
+		} else {
+			b32 do_sleep;
+			gb_mutex_lock(&js->sleep_mutex);
+			js->sleeping_count.value++;
+			gb_mfence(); // NOTE(bill): Pairs with the fence in gb__job_system_wake
+			do_sleep = gb_atomic32_load(&js->is_running) && !gb__job_system_has_work(js);
+			if (!do_sleep)
+				js->sleeping_count.value--;
+			gb_mutex_unlock(&js->sleep_mutex);
+
+			if (do_sleep)
+				gb_fast_semaphore_wait(&js->sleep_semaphore);
+			spin_count = 0;
+		}
+	}
+}
+
+
+void gb_job_system_init(gbJobSystem *js, isize worker_count, gbAllocator a) {
+	isize i;
+	gb_zero_item(js);
+	js->allocator = a;
+	gb_affinity_init(&js->affinity);
+	if (worker_count <= 0)
+		worker_count = js->affinity.core_count;
+	if (worker_count > GB_JOB_MAX_WORKERS)
+		worker_count = GB_JOB_MAX_WORKERS;
+	js->worker_count = worker_count;
+
+	gb_mutex_init(&js->sleep_mutex);
+	gb_fast_semaphore_init(&js->sleep_semaphore);
+	gb_atomic32_store(&js->is_running, true);
+
+	for (i = 0; i < worker_count; i++) {
+		gbJobWorker *w = &js->workers[i];
+		w->system     = js;
+		w->index      = i;
+		w->steal_seed = cast(u32)(i+1) * 0x9e3779b9u;
+		w->deque      = cast(gbJobDeque *)gb_alloc_align(a, gb_size_of(gbJobDeque), GB_CACHE_LINE_SIZE);
+		GB_ASSERT_NOT_NULL(w->deque);
+		gb_atomic64_store(&w->deque->top, 0);
+		gb_atomic64_store(&w->deque->bottom, 0);
+	}
+
+	// NOTE(bill): The calling thread is worker 0
+	gb__job_worker = &js->workers[0];
+	for (i = 1; i < worker_count; i++) {
+		gb_thread_init(&js->workers[i].thread);
+		gb_thread_start(&js->workers[i].thread, gb__job_worker_proc, &js->workers[i]);
+	}
+}
+
+void gb_job_system_destroy(gbJobSystem *js) {
+	isize i;
+	GB_ASSERT_MSG(gb__job_worker == &js->workers[0], "gb_job_system_destroy must be called from the thread which initialized it");
+
+	// NOTE(bill): Finish what is left in the main thread's deque before stopping
+	while (gb_job_system_try_run_one(js))
+		;
+
+	gb_atomic32_store(&js->is_running, false);
+	gb_mutex_lock(&js->sleep_mutex);
+	gb_fast_semaphore_post(&js->sleep_semaphore, js->sleeping_count.value);
+	js->sleeping_count.value = 0;
+	gb_mutex_unlock(&js->sleep_mutex);
+
+	for (i = 1; i < js->worker_count; i++)
+		gb_thread_destory(&js->workers[i].thread);
+	for (i = 0; i < js->worker_count; i++)
+		gb_free(js->allocator, js->workers[i].deque);
+
+	gb_fast_semaphore_destroy(&js->sleep_semaphore);
+	gb_mutex_destroy(&js->sleep_mutex);
+	gb_affinity_destroy(&js->affinity);
+	gb__job_worker = NULL;
+}
+
+gb_inline isize gb_job_system_worker_index(gbJobSystem *js) {
+	gbJobWorker *w = gb__job_worker;
+	if (w && w->system == js)
+		return w->index;
+	return -1;
+}
+
+gb_inline void gb_job_system_run(gbJobSystem *js, gbJobProc *proc, void *data, gbJobCounter *counter) {
+	gbJob job;
+	job.proc    = proc;
+	job.data    = data;
+	job.counter = counter;
+	gb_job_system_run_jobs(js, &job, 1, counter);
+}
+
+void gb_job_system_run_jobs(gbJobSystem *js, gbJob *jobs, isize job_count, gbJobCounter *counter) {
+	gbJobWorker *w = gb__job_worker;
+	isize i;
+	GB_ASSERT_MSG(w != NULL && w->system == js, "Jobs can only be submitted from a thread of the job system");
+
+	if (counter)
+		gb_atomic32_fetch_add(&counter->count, cast(i32)job_count);
+	for (i = 0; i < job_count; i++) {
+		gbJob job = jobs[i];
+		job.counter = counter;
+		if (!gb__job_deque_push(w->deque, job)) {
+			gb__job_execute(&job);
+		} else {
+			gb__job_system_wake(js);
+		}
+	}
+}
+
+gb_inline b32 gb_job_system_try_run_one(gbJobSystem *js) {
+	gbJobWorker *w = gb__job_worker;
+	gbJob job;
+	GB_ASSERT(w != NULL && w->system == js);
+	if (gb__job_find(js, w, &job)) {
+		gb__job_execute(&job);
+		return true;
+	}
+	return false;
+}
+
+void gb_job_system_wait(gbJobSystem *js, gbJobCounter *counter) {
+	// NOTE(bill): Help while waiting rather than blocking
+	while (gb_atomic32_load(&counter->count) > 0) {
+		if (!gb_job_system_try_run_one(js))
+			gb_yield_thread();
+	}
+	gb_mfence();
+}
+
+
+
 
 
 
@@ -5061,6 +7645,18 @@ isize gb_virtual_memory_page_size(isize *alignment_out) {
 	return info.dwPageSize;
 }
 
+gb_inline gbVirtualMemory gb_vm_reserve(void *addr, isize size) {
+	gbVirtualMemory vm;
+	GB_ASSERT(size > 0);
+	vm.data = VirtualAlloc(addr, size, MEM_RESERVE, PAGE_NOACCESS);
+	vm.size = size;
+	return vm;
+}
+
+gb_inline b32 gb_vm_commit  (gbVirtualMemory vm) { return VirtualAlloc(vm.data, vm.size, MEM_COMMIT, PAGE_READWRITE) != NULL; }
+gb_inline b32 gb_vm_decommit(gbVirtualMemory vm) { return VirtualFree(vm.data, vm.size, MEM_DECOMMIT) != 0; }
+gb_inline b32 gb_vm_release (gbVirtualMemory vm) { return VirtualFree(vm.data, 0, MEM_RELEASE) != 0; }
+
 #else
 
 #ifndef MAP_ANONYMOUS
@@ -5108,6 +7704,34 @@ isize gb_virtual_memory_page_size(isize *alignment_out) {
 	return result;
 }
 
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+gb_inline gbVirtualMemory gb_vm_reserve(void *addr, isize size) {
+	gbVirtualMemory vm;
+	GB_ASSERT(size > 0);
+	vm.data = mmap(addr, size, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+	if (vm.data == MAP_FAILED)
+		vm.data = NULL;
+	vm.size = size;
+	return vm;
+}
+
+gb_inline b32 gb_vm_commit(gbVirtualMemory vm) {
+	return mprotect(vm.data, vm.size, PROT_READ | PROT_WRITE) == 0;
+}
+
+gb_inline b32 gb_vm_decommit(gbVirtualMemory vm) {
+	// NOTE(bill): Mapping over the pages drops them and makes them inaccessible again
+	void *ptr = mmap(vm.data, vm.size, PROT_NONE, MAP_FIXED | MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+	return ptr != MAP_FAILED;
+}
+
+gb_inline b32 gb_vm_release(gbVirtualMemory vm) {
+	return munmap(vm.data, vm.size) == 0;
+}
+
 #endif
 
 
@@ -5125,6 +7749,7 @@ isize gb_virtual_memory_page_size(isize *alignment_out) {
 //
 
 gb_inline void gb_arena_init_from_memory(gbArena *arena, void *start, isize size) {
+	gb_zero_item(arena);
 	arena->backing.proc    = NULL;
 	arena->backing.data    = NULL;
 	arena->physical_start  = start;
@@ -5134,6 +7759,7 @@ gb_inline void gb_arena_init_from_memory(gbArena *arena, void *start, isize size
 }
 
 gb_inline void gb_arena_init_from_allocator(gbArena *arena, gbAllocator backing, isize size) {
+	gb_zero_item(arena);
 	arena->backing         = backing;
 	arena->physical_start  = gb_alloc(backing, size); // NOTE(bill): Uses default alignment
 	arena->total_size      = size;
@@ -5144,13 +7770,64 @@ gb_inline void gb_arena_init_from_allocator(gbArena *arena, gbAllocator backing,
 gb_inline void gb_arena_init_sub(gbArena *arena, gbArena *parent_arena, isize size) { gb_arena_init_from_allocator(arena, gb_arena_allocator(parent_arena), size); }
 
 
+b32 gb_arena_init_virtual(gbArena *arena, isize reserve_size, b32 guard_pages) {
+	isize page_size = gb_virtual_memory_page_size(NULL);
+	isize guard_size = guard_pages ? page_size : 0;
+	GB_ASSERT(GB_ARENA_COMMIT_SIZE % page_size == 0);
+
+	gb_zero_item(arena);
+	reserve_size = (reserve_size + GB_ARENA_COMMIT_SIZE-1) / GB_ARENA_COMMIT_SIZE * GB_ARENA_COMMIT_SIZE;
+	arena->reservation = gb_vm_reserve(NULL, reserve_size + 2*guard_size);
+	if (arena->reservation.data == NULL) {
+		gb_zero_item(arena);
+		return false;
+	}
+
+	// NOTE(bill): The guard pages are just never committed
+	arena->physical_start = gb_pointer_add(arena->reservation.data, guard_size);
+	arena->total_size     = reserve_size;
+	arena->commit_retain  = 4*GB_ARENA_COMMIT_SIZE;
+	return true;
+}
+
 gb_inline void gb_arena_free(gbArena *arena) {
-	if (arena->backing.proc) {
+	if (arena->reservation.data) {
+		gb_vm_release(arena->reservation);
+		gb_zero_item(arena);
+	} else if (arena->backing.proc) {
 		gb_free(arena->backing, arena->physical_start);
 		arena->physical_start = NULL;
 	}
 }
 
+gb_internal b32 gb__arena_commit(gbArena *arena, isize size) {
+	isize new_committed;
+	if (size <= arena->total_committed)
+		return true;
+	if (size > arena->total_size)
+		return false;
+	new_committed = (size + GB_ARENA_COMMIT_SIZE-1) / GB_ARENA_COMMIT_SIZE * GB_ARENA_COMMIT_SIZE;
+	if (new_committed > arena->total_size)
+		new_committed = arena->total_size;
+	if (!gb_vm_commit(gb_virtual_memory(gb_pointer_add(arena->physical_start, arena->total_committed),
+	                                    new_committed - arena->total_committed)))
+		return false;
+	arena->total_committed = new_committed;
+	return true;
+}
+
+gb_internal void gb__arena_decommit(gbArena *arena) {
+	isize page_size = gb_virtual_memory_page_size(NULL);
+	isize keep;
+	arena->commit_mark -= (arena->commit_mark - arena->total_allocated) / GB_ARENA_COMMIT_DECAY;
+	keep = arena->commit_mark + arena->commit_retain;
+	keep = (keep + page_size-1) / page_size * page_size;
+	if (keep < arena->total_committed) {
+		gb_vm_decommit(gb_virtual_memory(gb_pointer_add(arena->physical_start, keep), arena->total_committed - keep));
+		arena->total_committed = keep;
+	}
+}
+
 
 gb_inline isize gb_arena_alignment_of(gbArena *arena, isize alignment) {
 	isize alignment_offset, result_pointer, mask;
@@ -5187,6 +7864,7 @@ gb_inline gbAllocator gb_arena_allocator(gbArena *arena) {
 GB_ALLOCATOR_PROC(gb_arena_allocator_proc) {
 	gbArena *arena = cast(gbArena *)allocator_data;
 	void *ptr = NULL;
+	GB_PROFILE_BEGIN("gb_arena_allocator_proc");
 
 	gb_unused(old_size);
 
@@ -5198,11 +7876,21 @@ GB_ALLOCATOR_PROC(gb_arena_allocator_proc) {
 		// NOTE(bill): Out of memory
 		if (arena->total_allocated + total_size > cast(isize)arena->total_size) {
 			gb_printf_err("Arena out of memory\n");
+			GB_PROFILE_END();
+			return NULL;
+		}
+		if (arena->reservation.data && !gb__arena_commit(arena, arena->total_allocated + total_size)) {
+			gb_printf_err("Arena failed to commit memory\n");
+			GB_PROFILE_END();
 			return NULL;
 		}
 
 		ptr = gb_align_forward(end, alignment);
 		arena->total_allocated += total_size;
+		if (arena->commit_mark < arena->total_allocated)
+			arena->commit_mark = arena->total_allocated;
+		if (arena->high_water_mark < arena->total_allocated)
+			arena->high_water_mark = arena->total_allocated;
 		if (flags & gbAllocatorFlag_ClearToZero)
 			gb_zero_size(ptr, size);
 	} break;
@@ -5214,6 +7902,8 @@ GB_ALLOCATOR_PROC(gb_arena_allocator_proc) {
 
 	case gbAllocation_FreeAll:
 		arena->total_allocated = 0;
+		if (arena->reservation.data)
+			gb__arena_decommit(arena);
 		break;
 
 	case gbAllocation_Resize: {
@@ -5222,6 +7912,7 @@ GB_ALLOCATOR_PROC(gb_arena_allocator_proc) {
 		ptr = gb_default_resize_align(a, old_memory, old_size, size, alignment);
 	} break;
 	}
+	GB_PROFILE_END();
 	return ptr;
 }
 
@@ -5239,6 +7930,8 @@ gb_inline void gb_temp_arena_memory_end(gbTempArenaMemory tmp) {
 	GB_ASSERT(tmp.arena->temp_count > 0);
 	tmp.arena->total_allocated = tmp.original_count;
 	tmp.arena->temp_count--;
+	if (tmp.arena->reservation.data)
+		gb__arena_decommit(tmp.arena);
 }
 
 
@@ -5300,6 +7993,7 @@ gb_inline gbAllocator gb_pool_allocator(gbPool *pool) {
 GB_ALLOCATOR_PROC(gb_pool_allocator_proc) {
 	gbPool *pool = cast(gbPool *)allocator_data;
 	void *ptr = NULL;
+	GB_PROFILE_BEGIN("gb_pool_allocator_proc");
 
 	gb_unused(old_size);
 
@@ -5320,7 +8014,7 @@ GB_ALLOCATOR_PROC(gb_pool_allocator_proc) {
 
 	case gbAllocation_Free: {
 		uintptr *next;
-		if (old_memory == NULL) return NULL;
+		if (old_memory == NULL) break;
 
 		next = cast(uintptr *)old_memory;
 		*next = cast(uintptr)pool->free_list;
@@ -5338,6 +8032,7 @@ GB_ALLOCATOR_PROC(gb_pool_allocator_proc) {
 		break;
 	}
 
+	GB_PROFILE_END();
 	return ptr;
 }
 
@@ -5366,16 +8061,294 @@ gb_inline void gb_allocation_header_fill(gbAllocationHeader *header, void *data,
 // Free List Allocator
 //
 
-gb_inline void gb_free_list_init(gbFreeList *fl, void *start, isize size) {
-	GB_ASSERT(size > gb_size_of(gbFreeListBlock));
+// NOTE(bill): TLSF - Two-Level Segregated Fit
+// The first level is the power of two of the size and the second level splits that linearly into
+// GB__TLSF_SL_COUNT lists. Sizes below GB__TLSF_SMALL_SIZE all go into the first list of the first level.
+// Every block has a header with its size and the previous physical block, the size's low bits
+// say whether the block and the previous block are free. The free list links of a free block are
+// stored in its payload. The region always ends with a used 0 sized sentinel block.
 
-	fl->physical_start   = start;
+#if defined(GB_ARCH_64_BIT)
+#define GB__TLSF_ALIGN_LOG2 4
+#define GB__TLSF_FL_MAX     40
+#else
+#define GB__TLSF_ALIGN_LOG2 3
+#define GB__TLSF_FL_MAX     30
+#endif
+
+#define GB__TLSF_ALIGN       (1 << GB__TLSF_ALIGN_LOG2)
+#define GB__TLSF_SL_LOG2     5
+#define GB__TLSF_SL_COUNT    (1 << GB__TLSF_SL_LOG2)
+#define GB__TLSF_FL_SHIFT    (GB__TLSF_SL_LOG2 + GB__TLSF_ALIGN_LOG2)
+#define GB__TLSF_FL_COUNT    (GB__TLSF_FL_MAX - GB__TLSF_FL_SHIFT + 1)
+#define GB__TLSF_SMALL_SIZE  (1 << GB__TLSF_FL_SHIFT)
+#define GB__TLSF_FREE        cast(usize)1
+#define GB__TLSF_PREV_FREE   cast(usize)2
+
+typedef struct gbprivTlsfBlock gbprivTlsfBlock;
+struct gbprivTlsfBlock {
+	usize            size; // NOTE(bill): Payload size, the low bits are the GB__TLSF_FREE & GB__TLSF_PREV_FREE flags
+	gbprivTlsfBlock *prev_phys;
+
+	// NOTE(bill): Only valid while the block is free
+	gbprivTlsfBlock *next_free;
+	gbprivTlsfBlock *prev_free;
+};
+
+typedef struct gbprivTlsfControl {
+	u32              fl_bitmap;
+	u32              sl_bitmap[GB__TLSF_FL_COUNT];
+	gbprivTlsfBlock *blocks[GB__TLSF_FL_COUNT][GB__TLSF_SL_COUNT];
+} gbprivTlsfControl;
+
+#define GB__TLSF_HEADER_SIZE  (2*gb_size_of(void *))
+#define GB__TLSF_MIN_PAYLOAD  (2*gb_size_of(void *))
+GB_STATIC_ASSERT(GB__TLSF_HEADER_SIZE == GB__TLSF_ALIGN);
+GB_STATIC_ASSERT(GB__TLSF_FL_COUNT <= 32);
+
+gb_internal gb_inline usize gb__tlsf_size(gbprivTlsfBlock *b) { return b->size & ~(GB__TLSF_FREE|GB__TLSF_PREV_FREE); }
+gb_internal gb_inline void *gb__tlsf_payload(gbprivTlsfBlock *b) { return cast(u8 *)b + GB__TLSF_HEADER_SIZE; }
+gb_internal gb_inline gbprivTlsfBlock *gb__tlsf_next(gbprivTlsfBlock *b) {
+	return cast(gbprivTlsfBlock *)(cast(u8 *)b + GB__TLSF_HEADER_SIZE + gb__tlsf_size(b));
+}
+
+gb_internal void gb__tlsf_mapping(usize size, i32 *fl, i32 *sl) {
+	if (size < GB__TLSF_SMALL_SIZE) {
+		*fl = 0;
+		*sl = cast(i32)(size >> GB__TLSF_ALIGN_LOG2);
+	} else {
+		i32 f = gb__fls_usize(size);
+		*sl = cast(i32)(size >> (f - GB__TLSF_SL_LOG2)) ^ GB__TLSF_SL_COUNT;
+		*fl = f - GB__TLSF_FL_SHIFT + 1;
+	}
+}
+
+gb_internal void gb__tlsf_insert(gbprivTlsfControl *c, gbprivTlsfBlock *b) {
+	i32 fl, sl;
+	gbprivTlsfBlock *head;
+	gb__tlsf_mapping(gb__tlsf_size(b), &fl, &sl);
+	head = c->blocks[fl][sl];
+	b->next_free = head;
+	b->prev_free = NULL;
+	if (head) head->prev_free = b;
+	c->blocks[fl][sl] = b;
+	c->fl_bitmap     |= cast(u32)1 << fl;
+	c->sl_bitmap[fl] |= cast(u32)1 << sl;
+}
+
+gb_internal void gb__tlsf_remove(gbprivTlsfControl *c, gbprivTlsfBlock *b) {
+	i32 fl, sl;
+	gb__tlsf_mapping(gb__tlsf_size(b), &fl, &sl);
+	if (b->next_free) b->next_free->prev_free = b->prev_free;
+	if (b->prev_free) {
+		b->prev_free->next_free = b->next_free;
+	} else {
+		c->blocks[fl][sl] = b->next_free;
+		if (b->next_free == NULL) {
+			c->sl_bitmap[fl] &= ~(cast(u32)1 << sl);
+			if (c->sl_bitmap[fl] == 0)
+				c->fl_bitmap &= ~(cast(u32)1 << fl);
+		}
+	}
+}
+
+gb_internal gbprivTlsfBlock *gb__tlsf_find(gbprivTlsfControl *c, usize size) {
+	i32 fl, sl;
+	u32 sl_map;
+	if (size >= GB__TLSF_SMALL_SIZE) {
+		// NOTE(bill): Round up to the next list so that any block in it is large enough
+		size += (cast(usize)1 << (gb__fls_usize(size) - GB__TLSF_SL_LOG2)) - 1;
+	}
+	gb__tlsf_mapping(size, &fl, &sl);
+	if (fl >= GB__TLSF_FL_COUNT)
+		return NULL;
+
+	sl_map = c->sl_bitmap[fl] & (~cast(u32)0 << sl);
+	if (sl_map == 0) {
+		u32 fl_map = fl+1 < 32 ? c->fl_bitmap & (~cast(u32)0 << (fl+1)) : 0;
+		if (fl_map == 0)
+			return NULL;
+		fl = gb__ctz32(fl_map);
+		sl_map = c->sl_bitmap[fl];
+	}
+	sl = gb__ctz32(sl_map);
+	return c->blocks[fl][sl];
+}
+
+// NOTE(bill): Splits off the end of the block as a new free block if there is enough left
+gb_internal void gb__tlsf_trim(gbprivTlsfControl *c, gbprivTlsfBlock *b, usize size) {
+	usize block_size = gb__tlsf_size(b);
+	if (block_size >= size + GB__TLSF_HEADER_SIZE + GB__TLSF_MIN_PAYLOAD) {
+		gbprivTlsfBlock *rest = cast(gbprivTlsfBlock *)(cast(u8 *)b + GB__TLSF_HEADER_SIZE + size);
+		rest->size = (block_size - size - GB__TLSF_HEADER_SIZE) | GB__TLSF_FREE;
+		rest->prev_phys = b;
+		b->size = size | (b->size & (GB__TLSF_FREE|GB__TLSF_PREV_FREE));
+		gb__tlsf_next(rest)->prev_phys = rest;
+		gb__tlsf_next(rest)->size |= GB__TLSF_PREV_FREE;
+		gb__tlsf_insert(c, rest);
+	}
+}
+
+gb_internal void *gb__tlsf_alloc(gbFreeList *fl, isize size, isize alignment) {
+	gbprivTlsfControl *c = cast(gbprivTlsfControl *)fl->tlsf_control;
+	gbprivTlsfBlock *b;
+	usize request, search;
+
+	if (size < GB__TLSF_MIN_PAYLOAD) size = GB__TLSF_MIN_PAYLOAD;
+	request = (cast(usize)size + GB__TLSF_ALIGN-1) & ~cast(usize)(GB__TLSF_ALIGN-1);
+	search  = request;
+	if (alignment > GB__TLSF_ALIGN)
+		search += alignment + GB__TLSF_HEADER_SIZE + GB__TLSF_MIN_PAYLOAD;
+
+	b = gb__tlsf_find(c, search);
+	if (b == NULL)
+		return NULL;
+	gb__tlsf_remove(c, b);
+
+	if (alignment > GB__TLSF_ALIGN) {
+		u8 *payload = cast(u8 *)gb__tlsf_payload(b);
+		u8 *aligned = cast(u8 *)gb_align_forward(payload, alignment);
+		if (aligned != payload && aligned - payload < GB__TLSF_HEADER_SIZE + GB__TLSF_MIN_PAYLOAD)
+			aligned = cast(u8 *)gb_align_forward(payload + GB__TLSF_HEADER_SIZE + GB__TLSF_MIN_PAYLOAD, alignment);
+		if (aligned != payload) {
+			// NOTE(bill): Give the gap in front back as its own free block
+			usize gap = cast(usize)(aligned - payload);
+			gbprivTlsfBlock *ab = cast(gbprivTlsfBlock *)(aligned - GB__TLSF_HEADER_SIZE);
+			ab->size      = (gb__tlsf_size(b) - gap) | GB__TLSF_PREV_FREE;
+			ab->prev_phys = b;
+			gb__tlsf_next(ab)->prev_phys = ab;
+			b->size = (gap - GB__TLSF_HEADER_SIZE) | (b->size & GB__TLSF_PREV_FREE) | GB__TLSF_FREE;
+			gb__tlsf_insert(c, b);
+			b = ab;
+		}
+	}
+
+	gb__tlsf_trim(c, b, request);
+	b->size &= ~GB__TLSF_FREE;
+	gb__tlsf_next(b)->size &= ~GB__TLSF_PREV_FREE;
+
+	fl->total_allocated += gb__tlsf_size(b);
+	fl->allocation_count++;
+	return gb__tlsf_payload(b);
+}
+
+gb_internal void gb__tlsf_free(gbFreeList *fl, void *ptr) {
+	gbprivTlsfControl *c = cast(gbprivTlsfControl *)fl->tlsf_control;
+	gbprivTlsfBlock *b = cast(gbprivTlsfBlock *)(cast(u8 *)ptr - GB__TLSF_HEADER_SIZE);
+	gbprivTlsfBlock *next;
+
+	GB_ASSERT_MSG((b->size & GB__TLSF_FREE) == 0, "Double free");
+	fl->total_allocated -= gb__tlsf_size(b);
+	fl->allocation_count--;
+
+	b->size |= GB__TLSF_FREE;
+	next = gb__tlsf_next(b);
+	next->size |= GB__TLSF_PREV_FREE;
+
+	if (b->size & GB__TLSF_PREV_FREE) {
+		gbprivTlsfBlock *prev = b->prev_phys;
+		gb__tlsf_remove(c, prev);
+		prev->size += GB__TLSF_HEADER_SIZE + gb__tlsf_size(b);
+		next->prev_phys = prev;
+		b = prev;
+	}
+	if (next->size & GB__TLSF_FREE) {
+		gb__tlsf_remove(c, next);
+		b->size += GB__TLSF_HEADER_SIZE + gb__tlsf_size(next);
+		gb__tlsf_next(b)->prev_phys = b;
+	}
+	gb__tlsf_insert(c, b);
+}
+
+gb_internal b32 gb__tlsf_init(gbFreeList *fl, void *start, isize size) {
+	u8 *end = cast(u8 *)start + size;
+	gbprivTlsfControl *c = cast(gbprivTlsfControl *)gb_align_forward(start, GB__TLSF_ALIGN);
+	gbprivTlsfBlock *first, *sentinel;
+	u8 *blocks = cast(u8 *)gb_align_forward(c+1, GB__TLSF_ALIGN);
+	usize max_size = (cast(usize)1 << GB__TLSF_FL_MAX) - GB__TLSF_ALIGN;
+	usize payload;
+
+	if (end < blocks || end - blocks < 2*GB__TLSF_HEADER_SIZE + GB__TLSF_MIN_PAYLOAD)
+		return false;
+	payload = cast(usize)(end - blocks) - 2*GB__TLSF_HEADER_SIZE;
+	payload &= ~cast(usize)(GB__TLSF_ALIGN-1);
+	if (payload > max_size) payload = max_size;
+
+	gb_zero_item(c);
+	fl->tlsf_control = c;
+
+	first = cast(gbprivTlsfBlock *)blocks;
+	first->size      = payload | GB__TLSF_FREE;
+	first->prev_phys = NULL;
+	sentinel = gb__tlsf_next(first);
+	sentinel->size      = 0 | GB__TLSF_PREV_FREE;
+	sentinel->prev_phys = first;
+	gb__tlsf_insert(c, first);
+	return true;
+}
+
+
+gb_inline void gb_free_list_init(gbFreeList *fl, void *start, isize size) {
+	gb_free_list_init_mode(fl, start, size, gbFreeListMode_Tlsf);
+}
+
+void gb_free_list_init_mode(gbFreeList *fl, void *start, isize size, gbFreeListMode mode) {
+	GB_ASSERT(size > gb_size_of(gbFreeListBlock));
+
+	fl->physical_start   = start;
 	fl->total_size       = size;
+	fl->mode             = mode;
+	fl->curr_block       = NULL;
+	fl->tlsf_control     = NULL;
+	fl->total_allocated  = 0;
+	fl->allocation_count = 0;
+
+	if (mode == gbFreeListMode_Tlsf && gb__tlsf_init(fl, start, size))
+		return;
+
+	fl->mode             = gbFreeListMode_FirstFit;
 	fl->curr_block       = cast(gbFreeListBlock *)start;
 	fl->curr_block->size = size;
 	fl->curr_block->next = NULL;
 }
 
+gbFreeListStats gb_free_list_stats(gbFreeList const *fl) {
+	gbFreeListStats stats = {0};
+	stats.total_allocated  = fl->total_allocated;
+	stats.allocation_count = fl->allocation_count;
+
+	if (fl->mode == gbFreeListMode_Tlsf) {
+		gbprivTlsfControl *c = cast(gbprivTlsfControl *)fl->tlsf_control;
+		i32 i, j;
+		for (i = 0; i < GB__TLSF_FL_COUNT; i++) {
+			if ((c->fl_bitmap & (cast(u32)1 << i)) == 0)
+				continue;
+			for (j = 0; j < GB__TLSF_SL_COUNT; j++) {
+				gbprivTlsfBlock *b;
+				for (b = c->blocks[i][j]; b != NULL; b = b->next_free) {
+					isize block_size = cast(isize)gb__tlsf_size(b);
+					stats.total_free += block_size;
+					stats.free_block_count++;
+					if (stats.largest_free_block < block_size)
+						stats.largest_free_block = block_size;
+				}
+			}
+		}
+	} else {
+		gbFreeListBlock *b;
+		for (b = fl->curr_block; b != NULL; b = b->next) {
+			stats.total_free += b->size;
+			stats.free_block_count++;
+			if (stats.largest_free_block < b->size)
+				stats.largest_free_block = b->size;
+		}
+	}
+
+	if (stats.total_free > 0)
+		stats.fragmentation = 1.0f - cast(f32)stats.largest_free_block / cast(f32)stats.total_free;
+	return stats;
+}
+
 
 gb_inline void gb_free_list_init_from_allocator(gbFreeList *fl, gbAllocator backing, isize size) {
 	void *start = gb_alloc(backing, size);
@@ -5394,9 +8367,44 @@ gb_inline gbAllocator gb_free_list_allocator(gbFreeList *fl) {
 GB_ALLOCATOR_PROC(gb_free_list_allocator_proc) {
 	gbFreeList *fl = cast(gbFreeList *)allocator_data;
 	void *ptr = NULL;
+	GB_PROFILE_BEGIN("gb_free_list_allocator_proc");
 
 	GB_ASSERT_NOT_NULL(fl);
 
+	if (fl->mode == gbFreeListMode_Tlsf) {
+		switch (type) {
+		case gbAllocation_Alloc:
+			ptr = gb__tlsf_alloc(fl, size, alignment);
+			if (ptr && (flags & gbAllocatorFlag_ClearToZero))
+				gb_zero_size(ptr, size);
+			break;
+
+		case gbAllocation_Free:
+			if (old_memory != NULL)
+				gb__tlsf_free(fl, old_memory);
+			break;
+
+		case gbAllocation_FreeAll:
+			gb_free_list_init_mode(fl, fl->physical_start, fl->total_size, gbFreeListMode_Tlsf);
+			break;
+
+		case gbAllocation_Resize:
+			if (old_memory != NULL && size > 0) {
+				// NOTE(bill): Stay in place if the block is already big enough
+				gbprivTlsfBlock *b = cast(gbprivTlsfBlock *)(cast(u8 *)old_memory - GB__TLSF_HEADER_SIZE);
+				if (cast(usize)size <= gb__tlsf_size(b) && gb_is_power_of_two(alignment) &&
+				    (cast(uintptr)old_memory & cast(uintptr)(alignment-1)) == 0) {
+					GB_PROFILE_END();
+					return old_memory;
+				}
+			}
+			ptr = gb_default_resize_align(gb_free_list_allocator(fl), old_memory, old_size, size, alignment);
+			break;
+		}
+		GB_PROFILE_END();
+		return ptr;
+	}
+
 	switch (type) {
 	case gbAllocation_Alloc: {
 		gbFreeListBlock *prev_block = NULL;
@@ -5407,6 +8415,8 @@ GB_ALLOCATOR_PROC(gb_free_list_allocator_proc) {
 			gbAllocationHeader *header;
 
 			total_size = size + alignment + gb_size_of(gbAllocationHeader);
+			// NOTE(bill): Keep the blocks word aligned for the headers
+			total_size = (total_size + gb_size_of(isize)-1) & ~(gb_size_of(isize)-1);
 
 			if (curr_block->size < total_size) {
 				prev_block = curr_block;
@@ -5414,7 +8424,7 @@ GB_ALLOCATOR_PROC(gb_free_list_allocator_proc) {
 				continue;
 			}
 
-			if (curr_block->size - total_size <= gb_size_of(gbAllocationHeader)) {
+			if (curr_block->size - total_size < gb_size_of(gbFreeListBlock)) {
 				total_size = curr_block->size;
 
 				if (prev_block)
@@ -5438,10 +8448,10 @@ GB_ALLOCATOR_PROC(gb_free_list_allocator_proc) {
 			}
 
 
-			// TODO(bill): Set Header Info
+			// NOTE(bill): The header holds the size of the whole block so that it can be freed
 			header = cast(gbAllocationHeader *)curr_block;
 			ptr = gb_align_forward(header+1, alignment);
-			gb_allocation_header_fill(header, ptr, size);
+			gb_allocation_header_fill(header, ptr, total_size);
 
 			fl->total_allocated += total_size;
 			fl->allocation_count++;
@@ -5449,9 +8459,11 @@ GB_ALLOCATOR_PROC(gb_free_list_allocator_proc) {
 
 			if (flags & gbAllocatorFlag_ClearToZero)
 				gb_zero_size(ptr, size);
+			GB_PROFILE_END();
 			return ptr;
 		}
 		// NOTE(bill): if ptr == NULL, ran out of free list memory! FUCK!
+		GB_PROFILE_END();
 		return NULL;
 	} break;
 
@@ -5499,7 +8511,7 @@ GB_ALLOCATOR_PROC(gb_free_list_allocator_proc) {
 	} break;
 
 	case gbAllocation_FreeAll:
-		gb_free_list_init(fl, fl->physical_start, fl->total_size);
+		gb_free_list_init_mode(fl, fl->physical_start, fl->total_size, gbFreeListMode_FirstFit);
 		break;
 
 	case gbAllocation_Resize:
@@ -5507,16 +8519,24 @@ GB_ALLOCATOR_PROC(gb_free_list_allocator_proc) {
 		break;
 	}
 
+	GB_PROFILE_END();
 	return ptr;
 }
 
 
 
 void gb_scratch_memory_init(gbScratchMemory *s, void *start, isize size) {
-	s->physical_start = start;
+	// NOTE(bill): Every block starts with a gbAllocationHeader at an aligned address, so trim the
+	// buffer to aligned ends. Then the space left before the end always fits a header.
+	isize header_align = gb_align_of(gbAllocationHeader);
+	void *aligned_start = gb_align_forward(start, header_align);
+	size -= gb_pointer_diff(start, aligned_start);
+	size = size > 0 ? size & ~(header_align-1) : 0;
+
+	s->physical_start = aligned_start;
 	s->total_size     = size;
-	s->alloc_point    = start;
-	s->free_point     = start;
+	s->alloc_point    = aligned_start;
+	s->free_point     = aligned_start;
 }
 
 
@@ -5538,36 +8558,46 @@ gbAllocator gb_scratch_allocator(gbScratchMemory *s) {
 GB_ALLOCATOR_PROC(gb_scratch_allocator_proc) {
 	gbScratchMemory *s = cast(gbScratchMemory *)allocator_data;
 	void *ptr = NULL;
+	GB_PROFILE_BEGIN("gb_scratch_allocator_proc");
 	GB_ASSERT_NOT_NULL(s);
 
 	switch (type) {
 	case gbAllocation_Alloc: {
-		void *pt = s->alloc_point;
-		gbAllocationHeader *header = cast(gbAllocationHeader *)pt;
+		gbAllocationHeader *header = cast(gbAllocationHeader *)s->alloc_point;
 		void *data = gb_align_forward(header+1, alignment);
 		void *end = gb_pointer_add(s->physical_start, s->total_size);
+		void *limit = end; // NOTE(bill): Where the free space after alloc_point ends
+		gbAllocationHeader *wrapped = NULL;
+		void *pt;
 
 		GB_ASSERT(alignment % 4 == 0);
-		size = ((size + 3)/4)*4;
-		pt = gb_pointer_add(pt, size);
-
-		// NOTE(bill): Wrap around
-		if (pt > end) {
-			header->size = gb_pointer_diff(header, end) | GB_ISIZE_HIGH_BIT;
-			pt = s->physical_start;
-			header = cast(gbAllocationHeader *)pt;
+		if (s->alloc_point < s->free_point)
+			limit = s->free_point;
+		// NOTE(bill): The allocation ends where the next header starts so keep it aligned for one
+		pt = gb_align_forward(gb_pointer_add(data, size), gb_align_of(gbAllocationHeader));
+
+		// NOTE(bill): Wrap around, the rest of the buffer is then skipped as a free block
+		if (pt > end && limit == end) {
+			wrapped = header;
+			header = cast(gbAllocationHeader *)s->physical_start;
 			data = gb_align_forward(header+1, alignment);
-			pt = gb_pointer_add(pt, size);
+			pt = gb_align_forward(gb_pointer_add(data, size), gb_align_of(gbAllocationHeader));
+			limit = s->free_point == s->alloc_point ? wrapped : s->free_point;
 		}
 
-		if (!gb_scratch_memory_is_in_use(s, pt)) {
-			gb_allocation_header_fill(header, pt, gb_pointer_diff(header, pt));
-			s->alloc_point = cast(u8 *)pt;
+		// NOTE(bill): Ending on free_point would make it look empty
+		if (pt < limit || (pt == limit && limit == end && s->free_point != s->physical_start)) {
+			if (wrapped) {
+				wrapped->size = gb_pointer_diff(wrapped, end) | GB_ISIZE_HIGH_BIT;
+				if (s->free_point == s->alloc_point)
+					s->free_point = s->physical_start;
+			}
+			gb_allocation_header_fill(header, data, gb_pointer_diff(header, pt));
+			s->alloc_point = pt == end ? s->physical_start : pt;
 			ptr = data;
+			if (flags & gbAllocatorFlag_ClearToZero)
+				gb_zero_size(ptr, size);
 		}
-
-		if (flags & gbAllocatorFlag_ClearToZero)
-			gb_zero_size(ptr, size);
 	} break;
 
 	case gbAllocation_Free: {
@@ -5586,10 +8616,15 @@ GB_ALLOCATOR_PROC(gb_scratch_allocator_proc) {
 					if ((header->size & GB_ISIZE_HIGH_BIT) == 0)
 						break;
 
-					s->free_point = gb_pointer_add(s->free_point, h->size & (~GB_ISIZE_HIGH_BIT));
+					s->free_point = gb_pointer_add(s->free_point, header->size & (~GB_ISIZE_HIGH_BIT));
 					if (s->free_point == end)
 						s->free_point = s->physical_start;
 				}
+				// NOTE(bill): Empty, start again from the beginning so the whole buffer can be used
+				if (s->free_point == s->alloc_point) {
+					s->alloc_point = s->physical_start;
+					s->free_point  = s->physical_start;
+				}
 			}
 		}
 	} break;
@@ -5604,12 +8639,733 @@ GB_ALLOCATOR_PROC(gb_scratch_allocator_proc) {
 		break;
 	}
 
+	GB_PROFILE_END();
+	return ptr;
+}
+
+
+
+
+//
+// Cached Allocator
+//
+
+// NOTE(bill): Every span starts with this header. Small allocations never use the first
+// GB__CACHED_SPAN_HEADER_SIZE bytes so blocks of classes which are multiples of 64 are 64 byte aligned
+typedef struct gbCachedAllocatorSpan {
+	gbCachedAllocator *owner;
+	isize              size_class;
+	void *             next_chunk; // NOTE(bill): Only used by the first span of a chunk
+} gbCachedAllocatorSpan;
+
+#define GB__CACHED_SPAN_HEADER_SIZE 64
+GB_STATIC_ASSERT(gb_size_of(gbCachedAllocatorSpan) <= GB__CACHED_SPAN_HEADER_SIZE);
+GB_STATIC_ASSERT((GB_CACHED_ALLOCATOR_SPAN_SIZE & (GB_CACHED_ALLOCATOR_SPAN_SIZE-1)) == 0);
+
+// NOTE(bill): Large allocations start with this header right before the returned pointer
+typedef struct gbCachedAllocatorLarge {
+	gbCachedAllocator *owner;
+	void *             base;
+	isize              size;
+} gbCachedAllocatorLarge;
+
+// NOTE(bill): An open addressed set of span addresses, filled with ca->lock held and read without it.
+// Spans are only removed by gb_cached_allocator_destroy so a table is only read while it is still
+// valid. When it grows, the old table is kept (until destroy) for the threads still reading it.
+struct gbCachedAllocatorSpanTable {
+	gbCachedAllocatorSpanTable *prev;
+	isize                       capacity; // NOTE(bill): Power of two
+	isize                       count;
+	uintptr                     spans[1];
+};
+
+typedef struct gbCachedAllocatorThreadSlot {
+	u64                     allocator_id;
+	gbCachedAllocatorCache *cache;
+} gbCachedAllocatorThreadSlot;
+
+gb_global gbAtomic64 gb__cached_allocator_next_id     = {0};
+gb_global gbAtomic64 gb__cached_allocator_next_thread = {0};
+gb_global gb_thread_local u64                         gb__cached_allocator_thread = 0;
+gb_global gb_thread_local gbCachedAllocatorThreadSlot gb__cached_allocator_slots[GB_CACHED_ALLOCATOR_THREAD_SLOTS];
+
+gb_internal gb_inline gbCachedAllocatorSpan *gb__cached_allocator_span(void const *ptr) {
+	return cast(gbCachedAllocatorSpan *)(cast(uintptr)ptr & ~cast(uintptr)(GB_CACHED_ALLOCATOR_SPAN_SIZE-1));
+}
+
+gb_internal gb_inline usize gb__cached_allocator_span_hash(uintptr span) {
+	return cast(usize)(span / GB_CACHED_ALLOCATOR_SPAN_SIZE) * cast(usize)0x9e3779b1ul;
+}
+
+gb_internal b32 gb__cached_allocator_is_span(gbCachedAllocator *ca, void const *ptr) {
+	gbCachedAllocatorSpanTable *table = cast(gbCachedAllocatorSpanTable *)gb_atomic_ptr_load(&ca->span_table);
+	uintptr span = cast(uintptr)gb__cached_allocator_span(ptr);
+	usize mask, i;
+	if (table == NULL)
+		return false;
+	mask = cast(usize)table->capacity-1;
+	for (i = gb__cached_allocator_span_hash(span) & mask; table->spans[i] != 0; i = (i+1) & mask) {
+		if (table->spans[i] == span)
+			return true;
+	}
+	return false;
+}
+
+gb_internal void gb__cached_allocator_span_table_insert(gbCachedAllocatorSpanTable *table, uintptr span) {
+	usize mask = cast(usize)table->capacity-1;
+	usize i = gb__cached_allocator_span_hash(span) & mask;
+	while (table->spans[i] != 0)
+		i = (i+1) & mask;
+	table->spans[i] = span;
+	table->count++;
+}
+
+// NOTE(bill): ca->lock must be held
+gb_internal b32 gb__cached_allocator_add_spans(gbCachedAllocator *ca, u8 *chunk, isize span_count) {
+	gbCachedAllocatorSpanTable *table = cast(gbCachedAllocatorSpanTable *)ca->span_table.value;
+	isize i;
+	if (table == NULL || 2*(table->count + span_count) > table->capacity) {
+		gbCachedAllocatorSpanTable *new_table;
+		isize capacity = table ? 2*table->capacity : 256;
+		while (2*((table ? table->count : 0) + span_count) > capacity)
+			capacity *= 2;
+		new_table = cast(gbCachedAllocatorSpanTable *)gb_alloc(ca->backing, gb_size_of(gbCachedAllocatorSpanTable) + (capacity-1)*gb_size_of(uintptr));
+		if (new_table == NULL)
+			return false;
+		new_table->prev     = table;
+		new_table->capacity = capacity;
+		new_table->count    = 0;
+		gb_zero_size(new_table->spans, capacity*gb_size_of(uintptr));
+		if (table) {
+			for (i = 0; i < table->capacity; i++) {
+				if (table->spans[i] != 0)
+					gb__cached_allocator_span_table_insert(new_table, table->spans[i]);
+			}
+		}
+		for (i = 0; i < span_count; i++)
+			gb__cached_allocator_span_table_insert(new_table, cast(uintptr)(chunk + i*GB_CACHED_ALLOCATOR_SPAN_SIZE));
+		gb_mfence();
+		gb_atomic_ptr_store(&ca->span_table, new_table);
+		return true;
+	}
+	// NOTE(bill): No block of these spans can be freed before they are handed out, so a reader seeing
+	// the table half filled is fine
+	for (i = 0; i < span_count; i++)
+		gb__cached_allocator_span_table_insert(table, cast(uintptr)(chunk + i*GB_CACHED_ALLOCATOR_SPAN_SIZE));
+	return true;
+}
+
+void gb_cached_allocator_init(gbCachedAllocator *ca, gbAllocator backing) {
+	isize c = 0, size, step, i;
+	gb_zero_item(ca);
+	ca->backing = backing;
+	ca->id      = cast(u64)gb_atomic64_fetch_add(&gb__cached_allocator_next_id, 1) + 1;
+
+	// NOTE(bill): 16 byte steps up to 128 and then 4 classes per power of two
+	for (size = 16; size <= 128; size += 16)
+		ca->class_sizes[c++] = cast(u16)size;
+	for (size = 128, step = 32; c < GB_CACHED_ALLOCATOR_CLASS_COUNT; step *= 2) {
+		for (i = 0; i < 4; i++) {
+			size += step;
+			ca->class_sizes[c++] = cast(u16)size;
+		}
+	}
+	GB_ASSERT(ca->class_sizes[GB_CACHED_ALLOCATOR_CLASS_COUNT-1] == GB_CACHED_ALLOCATOR_MAX_SMALL_SIZE);
+
+	for (c = 0; c < GB_CACHED_ALLOCATOR_CLASS_COUNT; c++) {
+		isize batch = 8192 / ca->class_sizes[c];
+		ca->class_batches[c] = cast(u16)gb_clamp(batch, 2, 64);
+	}
+	for (i = 0, c = 0; i < gb_count_of(ca->class_lookup); i++) {
+		while (ca->class_sizes[c] < i*16)
+			c++;
+		ca->class_lookup[i] = cast(u8)c;
+	}
+}
+
+void gb_cached_allocator_destroy(gbCachedAllocator *ca) {
+	gbCachedAllocatorThreadSlot *slot = &gb__cached_allocator_slots[ca->id % GB_CACHED_ALLOCATOR_THREAD_SLOTS];
+	gbCachedAllocatorSpanTable *table = cast(gbCachedAllocatorSpanTable *)ca->span_table.value;
+	isize i;
+	void *chunk = ca->chunks;
+	while (chunk) {
+		void *next = (cast(gbCachedAllocatorSpan *)chunk)->next_chunk;
+		gb_free(ca->backing, chunk);
+		chunk = next;
+	}
+	while (table) {
+		gbCachedAllocatorSpanTable *prev = table->prev;
+		gb_free(ca->backing, table);
+		table = prev;
+	}
+	for (i = 0; i < ca->cache_count.value; i++)
+		gb_free(ca->backing, ca->caches[i]);
+
+	// NOTE(bill): The slots of other threads still hold this id but as ids are never reused they can
+	// never match again and the stale cache pointer is never followed
+	if (slot->allocator_id == ca->id)
+		gb_zero_item(slot);
+	ca->id = 0;
+	ca->chunks = NULL;
+	ca->span_table.value = NULL;
+	ca->cache_count.value = 0;
+}
+
+
+gb_internal u8 *gb__cached_allocator_new_span(gbCachedAllocator *ca, isize size_class) {
+	gbCachedAllocatorSpan *span = NULL;
+	gb_atomic32_spin_lock(&ca->lock, -1);
+	if (ca->chunk_cursor == ca->chunk_end) {
+		isize chunk_size = GB_CACHED_ALLOCATOR_SPANS_PER_CHUNK * GB_CACHED_ALLOCATOR_SPAN_SIZE;
+		u8 *chunk = cast(u8 *)gb_alloc_align(ca->backing, chunk_size, GB_CACHED_ALLOCATOR_SPAN_SIZE);
+		if (chunk && !gb__cached_allocator_add_spans(ca, chunk, GB_CACHED_ALLOCATOR_SPANS_PER_CHUNK)) {
+			gb_free(ca->backing, chunk);
+			chunk = NULL;
+		}
+		if (chunk) {
+			(cast(gbCachedAllocatorSpan *)chunk)->next_chunk = ca->chunks;
+			ca->chunks       = chunk;
+			ca->chunk_cursor = chunk;
+			ca->chunk_end    = chunk + chunk_size;
+			gb_atomic64_fetch_add(&ca->chunk_allocated, chunk_size);
+		}
+	}
+	if (ca->chunk_cursor != ca->chunk_end) {
+		span = cast(gbCachedAllocatorSpan *)ca->chunk_cursor;
+		ca->chunk_cursor += GB_CACHED_ALLOCATOR_SPAN_SIZE;
+		span->owner      = ca;
+		span->size_class = size_class;
+	}
+	gb_atomic32_spin_unlock(&ca->lock);
+	return cast(u8 *)span;
+}
+
+gb_internal gbCachedAllocatorBlock *gb__cached_allocator_take_batch(gbCachedAllocator *ca, isize size_class, isize *count_) {
+	gbCachedAllocatorCentral *central = &ca->centrals[size_class];
+	gbCachedAllocatorBlock *head = NULL, *b;
+	isize count = 0;
+
+	gb_atomic32_spin_lock(&central->lock, -1);
+	if (central->batches) {
+		head = central->batches;
+		central->batches = head->next_batch;
+	} else {
+		isize size  = ca->class_sizes[size_class];
+		isize batch = ca->class_batches[size_class];
+		for (count = 0; count < batch; count++) {
+			if (central->span_cursor + size > central->span_end) {
+				u8 *span = gb__cached_allocator_new_span(ca, size_class);
+				if (span == NULL)
+					break;
+				central->span_cursor = span + GB__CACHED_SPAN_HEADER_SIZE;
+				central->span_end    = span + GB_CACHED_ALLOCATOR_SPAN_SIZE;
+			}
+			b = cast(gbCachedAllocatorBlock *)central->span_cursor;
+			central->span_cursor += size;
+			b->next = head;
+			head = b;
+		}
+	}
+	gb_atomic32_spin_unlock(&central->lock);
+
+	if (count == 0) {
+		for (b = head; b != NULL; b = b->next)
+			count++;
+	}
+	*count_ = count;
+	return head;
+}
+
+gb_internal void gb__cached_allocator_return_batch(gbCachedAllocator *ca, isize size_class, gbCachedAllocatorBlock *head) {
+	gbCachedAllocatorCentral *central = &ca->centrals[size_class];
+	gb_atomic32_spin_lock(&central->lock, -1);
+	head->next_batch = central->batches;
+	central->batches = head;
+	gb_atomic32_spin_unlock(&central->lock);
+}
+
+gb_internal gbCachedAllocatorCache *gb__cached_allocator_cache_for_thread(gbCachedAllocator *ca) {
+	gbCachedAllocatorThreadSlot *slot = &gb__cached_allocator_slots[ca->id % GB_CACHED_ALLOCATOR_THREAD_SLOTS];
+	gbCachedAllocatorCache *cache;
+	u64 thread;
+	i32 i, count;
+	if (slot->allocator_id == ca->id)
+		return slot->cache;
+
+	thread = gb__cached_allocator_thread;
+	if (thread == 0) {
+		thread = cast(u64)gb_atomic64_fetch_add(&gb__cached_allocator_next_thread, 1) + 1;
+		gb__cached_allocator_thread = thread;
+	}
+	count = gb_atomic32_load(&ca->cache_count);
+	for (i = 0; i < count; i++) {
+		if (ca->caches[i]->thread == thread) {
+			slot->allocator_id = ca->id;
+			slot->cache        = ca->caches[i];
+			return ca->caches[i];
+		}
+	}
+
+	cache = NULL;
+	gb_atomic32_spin_lock(&ca->lock, -1);
+	count = ca->cache_count.value;
+	if (count < GB_CACHED_ALLOCATOR_MAX_THREADS) {
+		cache = cast(gbCachedAllocatorCache *)gb_alloc(ca->backing, gb_size_of(gbCachedAllocatorCache));
+		if (cache) {
+			gb_zero_item(cache);
+			cache->owner  = ca;
+			cache->thread = thread;
+			ca->caches[count] = cache;
+			gb_mfence();
+			gb_atomic32_store(&ca->cache_count, count+1);
+		}
+	}
+	gb_atomic32_spin_unlock(&ca->lock);
+
+	// NOTE(bill): NULL if there are too many threads; they go through the central pools directly
+	if (cache) {
+		slot->allocator_id = ca->id;
+		slot->cache        = cache;
+	}
+	return cache;
+}
+
+gb_internal isize gb__cached_allocator_size_class(gbCachedAllocator *ca, isize size, isize alignment) {
+	isize c;
+	if (alignment > 64)
+		return -1;
+	if (size < alignment)
+		size = alignment;
+	if (size > GB_CACHED_ALLOCATOR_MAX_SMALL_SIZE)
+		return -1;
+	c = ca->class_lookup[(size+15) >> 4];
+	if (alignment > 16) {
+		// NOTE(bill): The blocks of a class are aligned to the largest power of two (up to 64)
+		// which divides its size
+		while (c < GB_CACHED_ALLOCATOR_CLASS_COUNT && (ca->class_sizes[c] & (alignment-1)) != 0)
+			c++;
+		if (c == GB_CACHED_ALLOCATOR_CLASS_COUNT)
+			return -1;
+	}
+	return c;
+}
+
+gb_internal void *gb__cached_allocator_alloc(gbCachedAllocator *ca, isize size, isize alignment) {
+	isize size_class = gb__cached_allocator_size_class(ca, size, alignment);
+	gbCachedAllocatorCache *cache;
+	gbCachedAllocatorBlock *b;
+
+	if (size_class < 0) {
+		gbCachedAllocatorLarge *large;
+		u8 *base;
+		// NOTE(bill): Only aligned as requested, the header is padded so the pointer after it stays aligned
+		isize header_size = gb_size_of(gbCachedAllocatorLarge);
+		if (alignment < gb_align_of(gbCachedAllocatorLarge))
+			alignment = gb_align_of(gbCachedAllocatorLarge);
+		header_size = (header_size + alignment-1) & ~(alignment-1);
+		gb_atomic32_spin_lock(&ca->lock, -1);
+		base = cast(u8 *)gb_alloc_align(ca->backing, header_size + size, alignment);
+		gb_atomic32_spin_unlock(&ca->lock);
+		if (base == NULL)
+			return NULL;
+		large = cast(gbCachedAllocatorLarge *)(base + header_size) - 1;
+		large->owner = ca;
+		large->base  = base;
+		large->size  = size;
+		gb_atomic64_fetch_add(&ca->large_allocated, size);
+		return base + header_size;
+	}
+
+	cache = gb__cached_allocator_cache_for_thread(ca);
+	if (cache) {
+		gbCachedAllocatorBin *bin = &cache->bins[size_class];
+		if (bin->head == NULL) {
+			bin->head = gb__cached_allocator_take_batch(ca, size_class, &bin->count);
+			if (bin->head == NULL)
+				return NULL;
+		}
+		b = bin->head;
+		bin->head = b->next;
+		bin->count--;
+	} else {
+		isize count;
+		b = gb__cached_allocator_take_batch(ca, size_class, &count);
+		if (b && b->next)
+			gb__cached_allocator_return_batch(ca, size_class, b->next);
+	}
+	return b;
+}
+
+gb_internal void gb__cached_allocator_free(gbCachedAllocator *ca, void *ptr) {
+	gbCachedAllocatorBlock *b = cast(gbCachedAllocatorBlock *)ptr;
+	gbCachedAllocatorCache *cache;
+	isize size_class;
+
+	if (!gb__cached_allocator_is_span(ca, ptr)) {
+		gbCachedAllocatorLarge *large = cast(gbCachedAllocatorLarge *)ptr - 1;
+		GB_ASSERT_MSG(large->owner == ca, "This memory was not allocated by this gbCachedAllocator");
+		gb_atomic64_fetch_add(&ca->large_allocated, -large->size);
+		gb_atomic32_spin_lock(&ca->lock, -1);
+		gb_free(ca->backing, large->base);
+		gb_atomic32_spin_unlock(&ca->lock);
+		return;
+	}
+	size_class = gb__cached_allocator_span(ptr)->size_class;
+
+	cache = gb__cached_allocator_cache_for_thread(ca);
+	if (cache) {
+		gbCachedAllocatorBin *bin = &cache->bins[size_class];
+		isize batch = ca->class_batches[size_class];
+		b->next = bin->head;
+		bin->head = b;
+		bin->count++;
+		if (bin->count >= 2*batch) {
+			// NOTE(bill): Give the most recently freed blocks back and keep the rest
+			gbCachedAllocatorBlock *last = bin->head;
+			isize i;
+			for (i = 1; i < batch; i++)
+				last = last->next;
+			b = bin->head;
+			bin->head = last->next;
+			bin->count -= batch;
+			last->next = NULL;
+			gb__cached_allocator_return_batch(ca, size_class, b);
+		}
+	} else {
+		b->next = NULL;
+		gb__cached_allocator_return_batch(ca, size_class, b);
+	}
+}
+
+void gb_cached_allocator_flush_thread(gbCachedAllocator *ca) {
+	gbCachedAllocatorCache *cache = gb__cached_allocator_cache_for_thread(ca);
+	isize i;
+	if (cache == NULL)
+		return;
+	for (i = 0; i < GB_CACHED_ALLOCATOR_CLASS_COUNT; i++) {
+		gbCachedAllocatorBin *bin = &cache->bins[i];
+		if (bin->head)
+			gb__cached_allocator_return_batch(ca, i, bin->head);
+		bin->head  = NULL;
+		bin->count = 0;
+	}
+}
+
+gb_inline gbAllocator gb_cached_allocator(gbCachedAllocator *ca) {
+	gbAllocator a;
+	a.proc = gb_cached_allocator_proc;
+	a.data = ca;
+	return a;
+}
+
+GB_ALLOCATOR_PROC(gb_cached_allocator_proc) {
+	gbCachedAllocator *ca = cast(gbCachedAllocator *)allocator_data;
+	void *ptr = NULL;
+	GB_PROFILE_BEGIN("gb_cached_allocator_proc");
+
+	switch (type) {
+	case gbAllocation_Alloc:
+		ptr = gb__cached_allocator_alloc(ca, size, alignment);
+		if (ptr && (flags & gbAllocatorFlag_ClearToZero))
+			gb_zero_size(ptr, size);
+		break;
+
+	case gbAllocation_Free:
+		if (old_memory != NULL)
+			gb__cached_allocator_free(ca, old_memory);
+		break;
+
+	case gbAllocation_FreeAll:
+		// NOTE(bill): Use gb_cached_allocator_destroy
+		break;
+
+	case gbAllocation_Resize: {
+		if (old_memory == NULL) {
+			ptr = gb__cached_allocator_alloc(ca, size, alignment);
+			break;
+		}
+		// NOTE(bill): Stay in the same block if it is still the right size class
+		if (size > 0 && gb__cached_allocator_is_span(ca, old_memory) &&
+		    gb__cached_allocator_span(old_memory)->size_class == gb__cached_allocator_size_class(ca, size, alignment)) {
+			ptr = old_memory;
+			break;
+		}
+		ptr = gb_default_resize_align(gb_cached_allocator(ca), old_memory, old_size, size, alignment);
+	} break;
+	}
+
+	GB_PROFILE_END();
 	return ptr;
 }
 
 
 
 
+//
+// Tracking Allocator
+//
+
+typedef struct gbprivTrackingHeader {
+	isize size;
+	u32   offset; // NOTE(bill): From the start of the backing allocation
+	u32   tag_index; // NOTE(bill): U32_MAX if not sampled
+} gbprivTrackingHeader;
+
+gb_global gb_thread_local char const *gb__tracking_tag = NULL;
+
+gb_inline char const *gb_tracking_set_tag(char const *tag) {
+	char const *prev = gb__tracking_tag;
+	gb__tracking_tag = tag;
+	return prev;
+}
+
+void gb_tracking_allocator_init(gbTrackingAllocator *ta, gbAllocator backing, i32 sample_rate) {
+	gb_zero_item(ta);
+	ta->backing     = backing;
+	ta->sample_rate = sample_rate < 1 ? 1 : sample_rate;
+	ta->tags[0].name = "(untagged)";
+	ta->tag_count.value = 1;
+}
+
+gb_inline gbAllocator gb_tracking_allocator(gbTrackingAllocator *ta) {
+	gbAllocator a;
+	a.proc = gb_tracking_allocator_proc;
+	a.data = ta;
+	return a;
+}
+
+gb_internal u32 gb__tracking_tag_index(gbTrackingAllocator *ta, char const *name) {
+	i32 i, count;
+	if (name == NULL)
+		return 0;
+	count = gb_atomic32_load(&ta->tag_count);
+	for (i = 1; i < count; i++) {
+		if (ta->tags[i].name == name)
+			return cast(u32)i;
+	}
+
+	gb_atomic32_spin_lock(&ta->tag_lock, -1);
+	count = ta->tag_count.value;
+	for (i = 1; i < count; i++) {
+		if (ta->tags[i].name == name || gb_strcmp(ta->tags[i].name, name) == 0)
+			break;
+	}
+	if (i == count) {
+		if (count < GB_TRACKING_MAX_TAGS) {
+			ta->tags[count].name = name;
+			gb_mfence();
+			gb_atomic32_store(&ta->tag_count, count+1);
+		} else {
+			i = 0; // NOTE(bill): Out of tags
+		}
+	}
+	gb_atomic32_spin_unlock(&ta->tag_lock);
+	return cast(u32)i;
+}
+
+gb_internal void gb__tracking_record_alloc(gbTrackingAllocator *ta, gbprivTrackingHeader *header) {
+	i64 total = gb_atomic64_fetch_add(&ta->total_allocated, header->size) + header->size;
+	i64 peak  = gb_atomic64_load(&ta->peak_allocated);
+	while (total > peak) {
+		i64 prev = gb_atomic64_compare_exchange(&ta->peak_allocated, peak, total);
+		if (prev == peak) break;
+		peak = prev;
+	}
+	gb_atomic64_fetch_add(&ta->allocation_count, 1);
+
+	header->tag_index = U32_MAX;
+	if (ta->sample_rate <= 1 || gb_atomic64_fetch_add(&ta->sample_counter, 1) % ta->sample_rate == 0) {
+		gbTrackingTag *tag;
+		i32 bucket = header->size > 0 ? gb__fls_usize(cast(usize)header->size) : 0;
+		if (bucket >= GB_TRACKING_HISTOGRAM_COUNT)
+			bucket = GB_TRACKING_HISTOGRAM_COUNT-1;
+		gb_atomic64_fetch_add(&ta->histogram[bucket], 1);
+
+		header->tag_index = gb__tracking_tag_index(ta, gb__tracking_tag);
+		tag = &ta->tags[header->tag_index];
+		gb_atomic64_fetch_add(&tag->count, 1);
+		gb_atomic64_fetch_add(&tag->bytes, header->size);
+		gb_atomic64_fetch_add(&tag->live_bytes, header->size);
+	}
+}
+
+gb_internal void gb__tracking_record_free(gbTrackingAllocator *ta, gbprivTrackingHeader *header) {
+	gb_atomic64_fetch_add(&ta->total_allocated, -header->size);
+	gb_atomic64_fetch_add(&ta->allocation_count, -1);
+	if (header->tag_index != U32_MAX)
+		gb_atomic64_fetch_add(&ta->tags[header->tag_index].live_bytes, -header->size);
+}
+
+gb_internal gb_inline isize gb__tracking_offset(isize alignment) {
+	isize header_size = gb_size_of(gbprivTrackingHeader);
+	return (header_size + alignment-1) & ~(alignment-1);
+}
+
+GB_ALLOCATOR_PROC(gb_tracking_allocator_proc) {
+	gbTrackingAllocator *ta = cast(gbTrackingAllocator *)allocator_data;
+	void *ptr = NULL;
+	GB_PROFILE_BEGIN("gb_tracking_allocator_proc");
+
+	gb_atomic64_fetch_add(&ta->type_counts[type], 1);
+	if (alignment < gb_align_of(gbprivTrackingHeader))
+		alignment = gb_align_of(gbprivTrackingHeader);
+
+	switch (type) {
+	case gbAllocation_Alloc: {
+		isize offset = gb__tracking_offset(alignment);
+		u8 *raw = cast(u8 *)ta->backing.proc(ta->backing.data, type, size + offset, alignment, NULL, 0, flags);
+		if (raw) {
+			gbprivTrackingHeader *header;
+			ptr = raw + offset;
+			header = cast(gbprivTrackingHeader *)ptr - 1;
+			header->size   = size;
+			header->offset = cast(u32)offset;
+			gb__tracking_record_alloc(ta, header);
+			gb_atomic64_fetch_add(&ta->type_bytes[type], size);
+		}
+	} break;
+
+	case gbAllocation_Free:
+		if (old_memory) {
+			gbprivTrackingHeader *header = cast(gbprivTrackingHeader *)old_memory - 1;
+			GB_ASSERT_MSG(old_size <= header->size, "old_size %td is larger than the allocation of %td bytes", old_size, header->size);
+			gb_atomic64_fetch_add(&ta->type_bytes[type], header->size);
+			gb__tracking_record_free(ta, header);
+			ta->backing.proc(ta->backing.data, type, 0, 0, cast(u8 *)old_memory - header->offset, 0, flags);
+		}
+		break;
+
+	case gbAllocation_FreeAll: {
+		i32 i;
+		ta->backing.proc(ta->backing.data, type, 0, 0, NULL, 0, flags);
+		// NOTE(bill): Everything is gone
+		gb_atomic64_store(&ta->total_allocated, 0);
+		gb_atomic64_store(&ta->allocation_count, 0);
+		for (i = 0; i < ta->tag_count.value; i++)
+			gb_atomic64_store(&ta->tags[i].live_bytes, 0);
+	} break;
+
+	case gbAllocation_Resize: {
+		gbprivTrackingHeader *header, old_header;
+		u8 *raw;
+		isize offset = gb__tracking_offset(alignment);
+		if (old_memory == NULL) {
+			ptr = gb_tracking_allocator_proc(allocator_data, gbAllocation_Alloc, size, alignment, NULL, 0, flags);
+			break;
+		}
+		header = cast(gbprivTrackingHeader *)old_memory - 1;
+		// NOTE(bill): old_size may be less than the allocation (only what is in use), never more
+		GB_ASSERT_MSG(old_size <= header->size, "old_size %td is larger than the allocation of %td bytes", old_size, header->size);
+		if (size == 0) {
+			gb_tracking_allocator_proc(allocator_data, gbAllocation_Free, 0, 0, old_memory, 0, flags);
+			break;
+		}
+		if (header->offset != offset) {
+			// NOTE(bill): Different alignment, the backing allocator cannot do this in place
+			ptr = gb_tracking_allocator_proc(allocator_data, gbAllocation_Alloc, size, alignment, NULL, 0, flags);
+			if (ptr) {
+				gb_memcopy(ptr, old_memory, gb_min(size, header->size));
+				gb_tracking_allocator_proc(allocator_data, gbAllocation_Free, 0, 0, old_memory, 0, flags);
+			}
+			break;
+		}
+		old_header = *header;
+		raw = cast(u8 *)ta->backing.proc(ta->backing.data, type, size + offset, alignment,
+		                                 cast(u8 *)old_memory - offset, old_header.size + offset, flags);
+		if (raw) {
+			ptr = raw + offset;
+			header = cast(gbprivTrackingHeader *)ptr - 1;
+			gb__tracking_record_free(ta, &old_header);
+			header->size = size;
+			gb__tracking_record_alloc(ta, header);
+			gb_atomic64_fetch_add(&ta->type_bytes[type], size);
+		}
+	} break;
+	}
+
+	GB_PROFILE_END();
+	return ptr;
+}
+
+void gb_tracking_allocator_print(gbTrackingAllocator *ta, gbFile *f) {
+	gb_local_persist char const *type_names[4] = {"alloc", "free", "free_all", "resize"};
+	i32 i, first = -1, last = -1;
+	if (f == NULL)
+		f = gb_file_get_standard(gbFileStandard_Output);
+
+	gb_fprintf(f, "Tracking Allocator\n");
+	gb_fprintf(f, "  in use %lld bytes in %lld allocations, peak %lld bytes\n",
+	           cast(long long)gb_atomic64_load(&ta->total_allocated),
+	           cast(long long)gb_atomic64_load(&ta->allocation_count),
+	           cast(long long)gb_atomic64_load(&ta->peak_allocated));
+	for (i = 0; i < 4; i++) {
+		gb_fprintf(f, "  %-8s %12lld calls %16lld bytes\n", type_names[i],
+		           cast(long long)gb_atomic64_load(&ta->type_counts[i]),
+		           cast(long long)gb_atomic64_load(&ta->type_bytes[i]));
+	}
+
+	for (i = 0; i < GB_TRACKING_HISTOGRAM_COUNT; i++) {
+		if (gb_atomic64_load(&ta->histogram[i]) != 0) {
+			if (first < 0) first = i;
+			last = i;
+		}
+	}
+	if (first >= 0) {
+		gb_fprintf(f, "  sizes%s\n", ta->sample_rate > 1 ? " (sampled)" : "");
+		for (i = first; i <= last; i++) {
+			gb_fprintf(f, "    %10lld - %10lld %12lld\n",
+			           cast(long long)1 << i, (cast(long long)1 << (i+1)) - 1,
+			           cast(long long)gb_atomic64_load(&ta->histogram[i]));
+		}
+	}
+
+	gb_fprintf(f, "  tags%s\n", ta->sample_rate > 1 ? " (sampled)" : "");
+	for (i = 0; i < gb_atomic32_load(&ta->tag_count); i++) {
+		gbTrackingTag *tag = &ta->tags[i];
+		if (gb_atomic64_load(&tag->count) == 0)
+			continue;
+		gb_fprintf(f, "    %-24s %12lld allocations %16lld bytes %16lld in use\n", tag->name,
+		           cast(long long)gb_atomic64_load(&tag->count),
+		           cast(long long)gb_atomic64_load(&tag->bytes),
+		           cast(long long)gb_atomic64_load(&tag->live_bytes));
+	}
+}
+
+
+b32 gb_allocator_stats(gbAllocator a, gbAllocatorStats *stats) {
+	gb_zero_item(stats);
+	if (a.proc == gb_arena_allocator_proc) {
+		gbArena *arena = cast(gbArena *)a.data;
+		stats->total_allocated = arena->total_allocated;
+		stats->peak_allocated  = arena->high_water_mark;
+		stats->capacity        = arena->total_size;
+	} else if (a.proc == gb_pool_allocator_proc) {
+		gbPool *pool = cast(gbPool *)a.data;
+		stats->total_allocated  = pool->total_size; // NOTE(bill): The pool counts the bytes in use
+		stats->allocation_count = pool->block_size > 0 ? pool->total_size / pool->block_size : 0;
+	} else if (a.proc == gb_free_list_allocator_proc) {
+		gbFreeList *fl = cast(gbFreeList *)a.data;
+		stats->total_allocated  = fl->total_allocated;
+		stats->allocation_count = fl->allocation_count;
+		stats->capacity         = fl->total_size;
+	} else if (a.proc == gb_cached_allocator_proc) {
+		gbCachedAllocator *ca = cast(gbCachedAllocator *)a.data;
+		stats->total_allocated = gb_atomic64_load(&ca->large_allocated); // NOTE(bill): Small allocations are not counted
+		stats->capacity        = gb_atomic64_load(&ca->chunk_allocated) + stats->total_allocated;
+	} else if (a.proc == gb_tracking_allocator_proc) {
+		gbTrackingAllocator *ta = cast(gbTrackingAllocator *)a.data;
+		stats->total_allocated  = gb_atomic64_load(&ta->total_allocated);
+		stats->allocation_count = gb_atomic64_load(&ta->allocation_count);
+		stats->peak_allocated   = gb_atomic64_load(&ta->peak_allocated);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+
+
+
 
 
 ////////////////////////////////////////////////////////////////
@@ -5656,116 +9412,391 @@ GB_COMPARE_PROC_PTR(gb_str_cmp(isize offset)) {
 
 
 
-// TODO(bill): Make user definable?
-#define GB__SORT_STACK_SIZE            64
-#define GB__SORT_INSERT_SORT_THRESHOLD  8
+// NOTE(bill): The generic sort only ever swaps items so it needs no temporary storage
+gb_internal gb_inline void gb__sort_swap(u8 *a, u8 *b, isize size) {
+	// NOTE(bill): Items may be of any type and alignment, so no u64/u32 lvalues
+	while (size >= 8) {
+		u64 t = gb__load_u64(a);
+		gb__store_u64(a, gb__load_u64(b));
+		gb__store_u64(b, t);
+		a += 8, b += 8, size -= 8;
+	}
+	if (size >= 4) {
+		u32 t = gb__load_u32(a);
+		gb__store_u32(a, gb__load_u32(b));
+		gb__store_u32(b, t);
+		a += 4, b += 4, size -= 4;
+	}
+	while (size-- > 0) {
+		gb_swap(u8, *a, *b);
+		a++, b++;
+	}
+}
+
+#define GB__SORT_AT(i)      (base + (i)*size)
+#define GB__SORT_LESS(i, j) (cmp(GB__SORT_AT(i), GB__SORT_AT(j)) < 0)
+#define GB__SORT_SWAP(i, j) gb__sort_swap(GB__SORT_AT(i), GB__SORT_AT(j), size)
 
-#define GB__SORT_PUSH(_base, _limit) do { \
-	stack_ptr[0] = (_base); \
-	stack_ptr[1] = (_limit); \
-	stack_ptr += 2; \
-} while (0)
+gb_internal void gb__sort_insertion(u8 *base, isize count, isize size, gbCompareProc cmp) {
+	u8 *i, *j, *limit = base + count*size;
+	for (i = base+size; i < limit; i += size) {
+		for (j = i; j > base && cmp(j, j-size) < 0; j -= size)
+			gb__sort_swap(j, j-size, size);
+	}
+}
+
+gb_internal b32 gb__sort_partial_insertion(u8 *base, isize count, isize size, gbCompareProc cmp) {
+	isize i, j, moved = 0;
+	for (i = 1; i < count; i++) {
+		for (j = i; j > 0 && GB__SORT_LESS(j, j-1); j--)
+			GB__SORT_SWAP(j, j-1);
+		moved += i-j;
+		if (moved > GB_SORT_PARTIAL_INSERTION_LIMIT)
+			return false;
+	}
+	return true;
+}
+
+gb_internal void gb__sort_sift_down(u8 *base, isize i, isize count, isize size, gbCompareProc cmp) {
+	for (;;) {
+		isize child = 2*i + 1;
+		if (child >= count) break;
+		if (child+1 < count && GB__SORT_LESS(child, child+1)) child++;
+		if (!GB__SORT_LESS(i, child)) break;
+		GB__SORT_SWAP(i, child);
+		i = child;
+	}
+}
+
+gb_internal void gb__sort_heap(u8 *base, isize count, isize size, gbCompareProc cmp) {
+	isize i;
+	for (i = count/2; i-- > 0; )
+		gb__sort_sift_down(base, i, count, size, cmp);
+	for (i = count-1; i > 0; i--) {
+		GB__SORT_SWAP(0, i);
+		gb__sort_sift_down(base, 0, i, size, cmp);
+	}
+}
 
+gb_internal void gb__sort3(u8 *base, isize i, isize j, isize k, isize size, gbCompareProc cmp) {
+	if (GB__SORT_LESS(j, i)) GB__SORT_SWAP(i, j);
+	if (GB__SORT_LESS(k, j)) {
+		GB__SORT_SWAP(j, k);
+		if (GB__SORT_LESS(j, i)) GB__SORT_SWAP(i, j);
+	}
+}
+
+// NOTE(bill): The pivot is items[0] and it stays put until the end. The median of three leaves an
+// item >= pivot at the end which stops the first scan.
+gb_internal isize gb__sort_partition_right(u8 *base, isize count, isize size, gbCompareProc cmp, b32 *already_partitioned) {
+	u8 *first = base, *last = base + count*size;
+	while (cmp(first += size, base) < 0) {}
+	if (first == base+size) {
+		while (first < last && !(cmp(last -= size, base) < 0)) {}
+	} else {
+		while (!(cmp(last -= size, base) < 0)) {}
+	}
+	*already_partitioned = first >= last;
+	while (first < last) {
+		gb__sort_swap(first, last, size);
+		while (cmp(first += size, base) < 0) {}
+		while (!(cmp(last -= size, base) < 0)) {}
+	}
+	first -= size;
+	gb__sort_swap(base, first, size);
+	return (first-base)/size;
+}
+
+// NOTE(bill): Puts the items equal to the pivot on the left, used when there are many equal items
+gb_internal isize gb__sort_partition_left(u8 *base, isize count, isize size, gbCompareProc cmp) {
+	u8 *first = base, *last = base + count*size;
+	while (cmp(base, last -= size) < 0) {}
+	if (last+size == base + count*size) {
+		while (first < last && !(cmp(base, first += size) < 0)) {}
+	} else {
+		while (!(cmp(base, first += size) < 0)) {}
+	}
+	while (first < last) {
+		gb__sort_swap(first, last, size);
+		while (cmp(base, last -= size) < 0) {}
+		while (!(cmp(base, first += size) < 0)) {}
+	}
+	gb__sort_swap(base, last, size);
+	return (last-base)/size;
+}
 
-#define GB__SORT_POP(_base, _limit) do { \
-	stack_ptr -= 2; \
-	(_base)  = stack_ptr[0]; \
-	(_limit) = stack_ptr[1]; \
-} while (0)
+gb_internal void gb__sort_loop(u8 *base, isize count, isize size, gbCompareProc cmp, isize bad_allowed, b32 leftmost) {
+	for (;;) {
+		isize half, pivot, left_count, right_count;
+		b32 already_partitioned = false;
 
+		if (count < GB_SORT_INSERTION_THRESHOLD) {
+			gb__sort_insertion(base, count, size, cmp);
+			return;
+		}
 
+		half = count/2;
+		if (count > GB_SORT_NINTHER_THRESHOLD) {
+			gb__sort3(base, 0,      half,   count-1, size, cmp);
+			gb__sort3(base, 1,      half-1, count-2, size, cmp);
+			gb__sort3(base, 2,      half+1, count-3, size, cmp);
+			gb__sort3(base, half-1, half,   half+1,  size, cmp);
+			GB__SORT_SWAP(0, half);
+		} else {
+			gb__sort3(base, half, 0, count-1, size, cmp);
+		}
 
-void gb_sort(void *base_, isize count, isize size, gbCompareProc cmp) {
-	u8 *i, *j;
-	u8 *base = cast(u8 *)base_;
-	u8 *limit = base + count*size;
-	isize threshold = GB__SORT_INSERT_SORT_THRESHOLD * size;
+		// NOTE(bill): The item before this range is the previous pivot, if it is equal to this
+		// pivot then everything equal to it can be skipped
+		if (!leftmost && !(cmp(base - size, base) < 0)) {
+			pivot = gb__sort_partition_left(base, count, size, cmp);
+			base  += (pivot+1)*size;
+			count -= pivot+1;
+			continue;
+		}
 
-	// NOTE(bill): Prepare the stack
-	u8 *stack[GB__SORT_STACK_SIZE] = {0};
-	u8 **stack_ptr = stack;
+		pivot = gb__sort_partition_right(base, count, size, cmp, &already_partitioned);
+		left_count  = pivot;
+		right_count = count - pivot - 1;
 
-	for (;;) {
-		if ((limit-base) > threshold) {
-			// NOTE(bill): Quick sort
-			i = base + size;
-			j = limit - size;
-
-			gb_memswap(((limit-base)/size/2) * size + base, base, size);
-			if (cmp(i, j) > 0)    gb_memswap(i, j, size);
-			if (cmp(base, j) > 0) gb_memswap(base, j, size);
-			if (cmp(i, base) > 0) gb_memswap(i, base, size);
-
-			for (;;) {
-				do i += size; while (cmp(i, base) < 0);
-				do j -= size; while (cmp(j, base) > 0);
-				if (i > j) break;
-				gb_memswap(i, j, size);
+		if (left_count < count/8 || right_count < count/8) {
+			if (--bad_allowed == 0) {
+				gb__sort_heap(base, count, size, cmp);
+				return;
 			}
-
-			gb_memswap(base, j, size);
-
-			if (j - base > limit - i) {
-				GB__SORT_PUSH(base, j);
-				base = i;
-			} else {
-				GB__SORT_PUSH(i, limit);
-				limit = j;
+			// NOTE(bill): Break up the pattern which caused the bad partition
+			if (left_count >= GB_SORT_INSERTION_THRESHOLD) {
+				GB__SORT_SWAP(0,       left_count/4);
+				GB__SORT_SWAP(pivot-1, pivot-left_count/4);
 			}
-		} else {
-			// NOTE(bill): Insertion sort
-			for (j = base, i = j+size;
-			     i < limit;
-			     j = i, i += size) {
-				for (; cmp(j, j+size) > 0; j -= size) {
-					gb_memswap(j, j+size, size);
-					if (j == base) break;
-				}
+			if (right_count >= GB_SORT_INSERTION_THRESHOLD) {
+				GB__SORT_SWAP(pivot+1, pivot+1+right_count/4);
+				GB__SORT_SWAP(count-1, count-right_count/4);
 			}
-
-			if (stack_ptr == stack) break; // NOTE(bill): Sorting is done!
-			GB__SORT_POP(base, limit);
+		} else if (already_partitioned &&
+		           gb__sort_partial_insertion(base, left_count, size, cmp) &&
+		           gb__sort_partial_insertion(base + (pivot+1)*size, right_count, size, cmp)) {
+			return; // NOTE(bill): It was (nearly) sorted already
 		}
+
+		gb__sort_loop(base, left_count, size, cmp, bad_allowed, leftmost);
+		base += (pivot+1)*size;
+		count = right_count;
+		leftmost = false;
 	}
 }
 
-#undef GB__SORT_PUSH
-#undef GB__SORT_POP
-
-
-#define GB_RADIX_SORT_PROC_GEN(Type) GB_RADIX_SORT_PROC(Type) { \
-	Type *source = items; \
-	Type *dest   = temp; \
-	isize byte_index, i, byte_max = 8*gb_size_of(Type); \
-	for (byte_index = 0; byte_index < byte_max; byte_index += 8) { \
-		isize offsets[256] = {0}; \
-		isize total = 0; \
-		/* NOTE(bill): First pass - count how many of each key */ \
-		for (i = 0; i < count; i++) { \
-			Type radix_value = source[i]; \
-			Type radix_piece = (radix_value >> byte_index) & 0xff; \
-			offsets[radix_piece]++; \
-		} \
-		/* NOTE(bill): Change counts to offsets */ \
-		for (i = 0; i < gb_count_of(offsets); i++) { \
-			isize skcount = offsets[i]; \
+#undef GB__SORT_AT
+#undef GB__SORT_LESS
+#undef GB__SORT_SWAP
+
+void gb_sort(void *base, isize count, isize size, gbCompareProc cmp) {
+	isize bad_allowed = 1;
+	GB_PROFILE_BEGIN("gb_sort");
+	while ((cast(isize)1 << bad_allowed) < count) bad_allowed++;
+	gb__sort_loop(cast(u8 *)base, count, size, cmp, bad_allowed, true);
+	GB_PROFILE_END();
+}
+
+GB_SORT_PROC_GEN(gb_sort_i32,   i32,   GB_SORT_LESS);
+GB_SORT_PROC_GEN(gb_sort_i64,   i64,   GB_SORT_LESS);
+GB_SORT_PROC_GEN(gb_sort_u32,   u32,   GB_SORT_LESS);
+GB_SORT_PROC_GEN(gb_sort_u64,   u64,   GB_SORT_LESS);
+GB_SORT_PROC_GEN(gb_sort_isize, isize, GB_SORT_LESS);
+GB_SORT_PROC_GEN(gb_sort_f32,   f32,   GB_SORT_LESS);
+GB_SORT_PROC_GEN(gb_sort_f64,   f64,   GB_SORT_LESS);
+
+
+// NOTE(bill): key = item ^ (flip | (neg_mask & -sign))
+// unsigned: flip = 0, neg_mask = 0; signed: flip = sign bit; float: flip = sign bit, neg_mask = ~0
+// i.e. negative floats have every bit flipped and positive ones just the sign bit
+#define GB__RADIX_KEY(UType, x) \
+	cast(UType)((x) ^ (flip | (neg_mask & cast(UType)(0 - cast(UType)((x) >> (8*gb_size_of(UType)-1))))))
+
+typedef struct gbprivRadixSortJob {
+	void *source, *dest;
+	u32 * source_values, *dest_values;
+	isize start, end;
+	isize digit; // NOTE(bill): -1 counts every digit
+	u64   flip, neg_mask;
+	isize counts[8][256]; // NOTE(bill): Turned into this job's offsets for the scatter
+} gbprivRadixSortJob;
+
+gb_internal void gb__radix_sort_run_jobs(gbJobSystem *js, gbJob *jobs, isize job_count) {
+	gbJobCounter counter = {0};
+	gb_job_system_run_jobs(js, jobs, job_count, &counter);
+	gb_job_system_wait(js, &counter);
+}
+
+#define GB__RADIX_SORT_CORE_GEN(UType) \
+gb_internal void gb__radix_sort_##UType(UType *items, UType *temp, u32 *values, u32 *temp_values, isize count, UType flip, UType neg_mask) { \
+	isize counts[gb_size_of(UType)][256]; \
+	UType *source = items, *dest = temp; \
+	u32 *source_values = values, *dest_values = temp_values; \
+	isize i, b; \
+	if (count <= 1) return; \
+	gb_zero_size(counts, gb_size_of(counts)); \
+	/* NOTE(bill): Count every digit in one pass */ \
+	for (i = 0; i < count; i++) { \
+		UType key = GB__RADIX_KEY(UType, source[i]); \
+		for (b = 0; b < gb_size_of(UType); b++) \
+			counts[b][(key >> (8*b)) & 0xff]++; \
+	} \
+	for (b = 0; b < gb_size_of(UType); b++) { \
+		isize *offsets = counts[b]; \
+		isize total = 0, shift = 8*b; \
+		if (offsets[(GB__RADIX_KEY(UType, source[0]) >> shift) & 0xff] == count) \
+			continue; /* NOTE(bill): Every item has the same digit */ \
+		for (i = 0; i < 256; i++) { \
+			isize c = offsets[i]; \
 			offsets[i] = total; \
-			total += skcount; \
+			total += c; \
+		} \
+		if (source_values) { \
+			for (i = 0; i < count; i++) { \
+				UType value = source[i]; \
+				isize j = offsets[(GB__RADIX_KEY(UType, value) >> shift) & 0xff]++; \
+				dest[j] = value; \
+				dest_values[j] = source_values[i]; \
+			} \
+			gb_swap(u32 *, source_values, dest_values); \
+		} else { \
+			for (i = 0; i < count; i++) { \
+				UType value = source[i]; \
+				dest[offsets[(GB__RADIX_KEY(UType, value) >> shift) & 0xff]++] = value; \
+			} \
+		} \
+		gb_swap(UType *, source, dest); \
+	} \
+	if (source != items) { \
+		gb_memcopy(items, source, count*gb_size_of(UType)); \
+		if (values) gb_memcopy(values, source_values, count*gb_size_of(u32)); \
+	} \
+} \
+GB_JOB_PROC(gb__radix_sort_count_job_##UType) { \
+	gbprivRadixSortJob *job = cast(gbprivRadixSortJob *)data; \
+	UType *source = cast(UType *)job->source; \
+	UType flip = cast(UType)job->flip, neg_mask = cast(UType)job->neg_mask; \
+	isize i, b; \
+	if (job->digit < 0) { \
+		gb_zero_size(job->counts, gb_size_of(UType)*gb_size_of(job->counts[0])); \
+		for (i = job->start; i < job->end; i++) { \
+			UType key = GB__RADIX_KEY(UType, source[i]); \
+			for (b = 0; b < gb_size_of(UType); b++) \
+				job->counts[b][(key >> (8*b)) & 0xff]++; \
+		} \
+	} else { \
+		isize *counts = job->counts[job->digit], shift = 8*job->digit; \
+		gb_zero_size(counts, gb_size_of(job->counts[0])); \
+		for (i = job->start; i < job->end; i++) \
+			counts[(GB__RADIX_KEY(UType, source[i]) >> shift) & 0xff]++; \
+	} \
+} \
+GB_JOB_PROC(gb__radix_sort_scatter_job_##UType) { \
+	gbprivRadixSortJob *job = cast(gbprivRadixSortJob *)data; \
+	UType *source = cast(UType *)job->source, *dest = cast(UType *)job->dest; \
+	UType flip = cast(UType)job->flip, neg_mask = cast(UType)job->neg_mask; \
+	isize *offsets = job->counts[job->digit], shift = 8*job->digit, i; \
+	for (i = job->start; i < job->end; i++) { \
+		UType value = source[i]; \
+		isize j = offsets[(GB__RADIX_KEY(UType, value) >> shift) & 0xff]++; \
+		dest[j] = value; \
+		if (job->source_values) job->dest_values[j] = job->source_values[i]; \
+	} \
+} \
+gb_internal void gb__radix_sort_parallel_##UType(gbJobSystem *js, UType *items, UType *temp, u32 *values, u32 *temp_values, isize count, UType flip, UType neg_mask) { \
+	gbprivRadixSortJob *jobs; \
+	gbJob job_list[GB_RADIX_SORT_MAX_JOBS]; \
+	UType *source = items, *dest = temp; \
+	u32 *source_values = values, *dest_values = temp_values; \
+	isize job_count = gb_min(js->worker_count, GB_RADIX_SORT_MAX_JOBS); \
+	isize per_job, i, j, b; \
+	b32 counted = true; \
+	if (job_count <= 1 || count < GB_RADIX_SORT_PARALLEL_THRESHOLD) { \
+		gb__radix_sort_##UType(items, temp, values, temp_values, count, flip, neg_mask); \
+		return; \
+	} \
+	jobs = gb_alloc_array(js->allocator, gbprivRadixSortJob, job_count); \
+	per_job = (count + job_count-1) / job_count; \
+	for (j = 0; j < job_count; j++) { \
+		jobs[j].source   = source; \
+		jobs[j].start    = j*per_job; \
+		jobs[j].end      = gb_min(count, (j+1)*per_job); \
+		jobs[j].digit    = -1; \
+		jobs[j].flip     = flip; \
+		jobs[j].neg_mask = neg_mask; \
+		job_list[j].proc = gb__radix_sort_count_job_##UType; \
+		job_list[j].data = &jobs[j]; \
+	} \
+	gb__radix_sort_run_jobs(js, job_list, job_count); \
+	for (b = 0; b < gb_size_of(UType); b++) { \
+		isize total = 0, same = 0, digit = (GB__RADIX_KEY(UType, source[0]) >> (8*b)) & 0xff; \
+		/* NOTE(bill): The totals per digit do not depend on the order so the first counts do */ \
+		for (j = 0; j < job_count; j++) \
+			same += jobs[j].counts[b][digit]; \
+		if (same == count) \
+			continue; \
+		for (j = 0; j < job_count; j++) { \
+			jobs[j].source = source; \
+			jobs[j].dest   = dest; \
+			jobs[j].source_values = source_values; \
+			jobs[j].dest_values   = dest_values; \
+			jobs[j].digit  = b; \
+			job_list[j].proc = gb__radix_sort_count_job_##UType; \
 		} \
-		/* NOTE(bill): Second pass - place elements into the right location */ \
-		for (i = 0; i < count; i++) { \
-			Type radix_value = source[i]; \
-			Type radix_piece = (radix_value >> byte_index) & 0xff; \
-			dest[offsets[radix_piece]++] = source[i]; \
+		if (!counted) \
+			gb__radix_sort_run_jobs(js, job_list, job_count); \
+		for (i = 0; i < 256; i++) { \
+			for (j = 0; j < job_count; j++) { \
+				isize c = jobs[j].counts[b][i]; \
+				jobs[j].counts[b][i] = total; \
+				total += c; \
+			} \
 		} \
-		gb_swap(Type *, source, dest); \
+		for (j = 0; j < job_count; j++) \
+			job_list[j].proc = gb__radix_sort_scatter_job_##UType; \
+		gb__radix_sort_run_jobs(js, job_list, job_count); \
+		gb_swap(UType *, source, dest); \
+		gb_swap(u32 *, source_values, dest_values); \
+		counted = false; \
 	} \
+	if (source != items) { \
+		gb_memcopy(items, source, count*gb_size_of(UType)); \
+		if (values) gb_memcopy(values, source_values, count*gb_size_of(u32)); \
+	} \
+	gb_free(js->allocator, jobs); \
 }
 
-GB_RADIX_SORT_PROC_GEN(u8);
-GB_RADIX_SORT_PROC_GEN(u16);
-GB_RADIX_SORT_PROC_GEN(u32);
-GB_RADIX_SORT_PROC_GEN(u64);
+#define GB__RADIX_SORT_PROC_GEN(Type, UType, flip, neg_mask) \
+GB_RADIX_SORT_PROC(Type) { \
+	gb__radix_sort_##UType(cast(UType *)items, cast(UType *)temp, NULL, NULL, count, flip, neg_mask); \
+} \
+GB_RADIX_SORT_PAIRS_PROC(Type) { \
+	gb__radix_sort_##UType(cast(UType *)keys, cast(UType *)temp_keys, values, temp_values, count, flip, neg_mask); \
+} \
+GB_RADIX_SORT_PARALLEL_PROC(Type) { \
+	gb__radix_sort_parallel_##UType(js, cast(UType *)items, cast(UType *)temp, values, temp_values, count, flip, neg_mask); \
+}
+
+GB__RADIX_SORT_CORE_GEN(u8);
+GB__RADIX_SORT_CORE_GEN(u16);
+GB__RADIX_SORT_CORE_GEN(u32);
+GB__RADIX_SORT_CORE_GEN(u64);
+
+GB__RADIX_SORT_PROC_GEN(u8,  u8,  0, 0);
+GB__RADIX_SORT_PROC_GEN(u16, u16, 0, 0);
+GB__RADIX_SORT_PROC_GEN(u32, u32, 0, 0);
+GB__RADIX_SORT_PROC_GEN(u64, u64, 0, 0);
+GB__RADIX_SORT_PROC_GEN(i8,  u8,  0x80u, 0);
+GB__RADIX_SORT_PROC_GEN(i16, u16, 0x8000u, 0);
+GB__RADIX_SORT_PROC_GEN(i32, u32, 0x80000000u, 0);
+GB__RADIX_SORT_PROC_GEN(i64, u64, 0x8000000000000000ull, 0);
+GB__RADIX_SORT_PROC_GEN(f32, u32, 0x80000000u, 0xffffffffu);
+GB__RADIX_SORT_PROC_GEN(f64, u64, 0x8000000000000000ull, 0xffffffffffffffffull);
+
+#undef GB__RADIX_KEY
+#undef GB__RADIX_SORT_CORE_GEN
+#undef GB__RADIX_SORT_PROC_GEN
 
 gb_inline isize gb_binary_search(void const *base, isize count, isize size, void const *key, gbCompareProc compare_proc) {
 	isize start = 0;
@@ -5800,12 +9831,330 @@ void gb_shuffle(void *base, isize count, isize size) {
 
 void gb_reverse(void *base, isize count, isize size) {
 	isize i, j = count-1;
-	for (i = 0; i < j; i++, j++)
+	for (i = 0; i < j; i++, j--)
 		gb_memswap(cast(u8 *)base + i*size, cast(u8 *)base + j*size, size);
 }
 
 
 
+//
+// Parallel Algorithms
+//
+
+typedef struct gbprivParallelFor {
+	gbParallelForProc *proc;
+	void *             data;
+	isize              end;
+	isize              grain_size;
+	gbAtomic64         next;
+} gbprivParallelFor;
+
+gb_internal GB_JOB_PROC(gb__parallel_for_job) {
+	gbprivParallelFor *pf = cast(gbprivParallelFor *)data;
+	for (;;) {
+		isize start = cast(isize)gb_atomic64_fetch_add(&pf->next, pf->grain_size);
+		if (start >= pf->end)
+			break;
+		pf->proc(pf->data, start, gb_min(start + pf->grain_size, pf->end));
+	}
+}
+
+void gb_parallel_for(gbJobSystem *js, isize start, isize end, isize grain_size, gbParallelForProc *proc, void *data) {
+	gbprivParallelFor pf;
+	gbJob jobs[GB_JOB_MAX_WORKERS];
+	gbJobCounter counter = {0};
+	isize count = end - start, job_count, i;
+
+	if (count <= 0)
+		return;
+	if (grain_size <= 0)
+		grain_size = gb_max(count / (js->worker_count*4), 1);
+	job_count = gb_min((count + grain_size-1) / grain_size, js->worker_count);
+	if (job_count <= 1) {
+		// NOTE(bill): Still in grain_size pieces, callers may index per piece data with start/grain_size
+		for (i = start; i < end; i += grain_size)
+			proc(data, i, gb_min(i + grain_size, end));
+		return;
+	}
+
+	pf.proc       = proc;
+	pf.data       = data;
+	pf.end        = end;
+	pf.grain_size = grain_size;
+	gb_atomic64_store(&pf.next, start);
+	for (i = 0; i < job_count; i++) {
+		jobs[i].proc    = gb__parallel_for_job;
+		jobs[i].data    = &pf;
+		jobs[i].counter = NULL;
+	}
+	gb_job_system_run_jobs(js, jobs, job_count, &counter);
+	gb_job_system_wait(js, &counter);
+}
+
+
+typedef struct gbprivParallelReduce {
+	gbParallelReduceProc *proc;
+	void *                data;
+	u8 *                  partials;
+	isize                 result_size;
+	isize                 start;
+	isize                 chunk_size;
+} gbprivParallelReduce;
+
+gb_internal GB_PARALLEL_FOR_PROC(gb__parallel_reduce_chunk) {
+	gbprivParallelReduce *r = cast(gbprivParallelReduce *)data;
+	isize chunk = (start - r->start) / r->chunk_size;
+	r->proc(r->data, start, end, r->partials + chunk*r->result_size);
+}
+
+void gb_parallel_reduce(gbJobSystem *js, isize start, isize end, isize grain_size,
+                        void *result, isize result_size,
+                        gbParallelReduceProc *reduce_proc, gbParallelCombineProc *combine_proc, void *data) {
+	gbprivParallelReduce r;
+	isize count = end - start, chunk_count, i;
+	if (count <= 0)
+		return;
+	if (grain_size <= 0)
+		grain_size = gb_max(count / (js->worker_count*4), 1);
+	chunk_count = (count + grain_size-1) / grain_size;
+	if (chunk_count > GB_PARALLEL_MAX_CHUNKS) {
+		grain_size  = (count + GB_PARALLEL_MAX_CHUNKS-1) / GB_PARALLEL_MAX_CHUNKS;
+		chunk_count = (count + grain_size-1) / grain_size;
+	}
+	if (chunk_count <= 1 || js->worker_count <= 1) {
+		reduce_proc(data, start, end, result);
+		return;
+	}
+
+	r.proc        = reduce_proc;
+	r.data        = data;
+	r.result_size = result_size;
+	r.start       = start;
+	r.chunk_size  = grain_size;
+	r.partials    = cast(u8 *)gb_alloc(js->allocator, chunk_count*result_size);
+	for (i = 0; i < chunk_count; i++)
+		gb_memcopy(r.partials + i*result_size, result, result_size);
+
+	gb_parallel_for(js, start, end, grain_size, gb__parallel_reduce_chunk, &r);
+
+	for (i = 0; i < chunk_count; i++)
+		combine_proc(data, result, r.partials + i*result_size);
+	gb_free(js->allocator, r.partials);
+}
+
+
+typedef struct gbprivParallelScan {
+	void *items;
+	void *partials;
+	isize chunk_size;
+	b32   exclusive;
+} gbprivParallelScan;
+
+gb_internal isize gb__parallel_chunk_size(isize count) {
+	isize chunk_size = (count + GB_PARALLEL_MAX_CHUNKS-1) / GB_PARALLEL_MAX_CHUNKS;
+	return gb_max(chunk_size, GB_PARALLEL_MIN_CHUNK_SIZE);
+}
+
+#define GB__PARALLEL_SUM_GEN(Type) \
+GB_PARALLEL_FOR_PROC(gb__parallel_sum_chunk_##Type) { \
+	gbprivParallelScan *scan = cast(gbprivParallelScan *)data; \
+	Type const *items = cast(Type const *)scan->items; \
+	Type total = 0; \
+	isize i; \
+	for (i = start; i < end; i++) \
+		total += items[i]; \
+	(cast(Type *)scan->partials)[start / scan->chunk_size] = total; \
+} \
+GB_PARALLEL_FOR_PROC(gb__parallel_scan_chunk_##Type) { \
+	gbprivParallelScan *scan = cast(gbprivParallelScan *)data; \
+	Type *items = cast(Type *)scan->items; \
+	Type total = (cast(Type *)scan->partials)[start / scan->chunk_size]; \
+	isize i; \
+	if (scan->exclusive) { \
+		for (i = start; i < end; i++) { \
+			Type value = items[i]; \
+			items[i] = total; \
+			total += value; \
+		} \
+	} else { \
+		for (i = start; i < end; i++) { \
+			total += items[i]; \
+			items[i] = total; \
+		} \
+	} \
+} \
+GB_PARALLEL_SUM_PROC(Type) { \
+	Type partials[GB_PARALLEL_MAX_CHUNKS]; \
+	Type total = 0; \
+	isize chunk_count, i; \
+	gbprivParallelScan scan = {0}; \
+	scan.items      = cast(void *)items; \
+	scan.partials   = partials; \
+	scan.chunk_size = gb__parallel_chunk_size(count); \
+	chunk_count = (count + scan.chunk_size-1) / scan.chunk_size; \
+	gb_parallel_for(js, 0, count, scan.chunk_size, gb__parallel_sum_chunk_##Type, &scan); \
+	for (i = 0; i < chunk_count; i++) \
+		total += partials[i]; \
+	return total; \
+} \
+GB_PARALLEL_PREFIX_SUM_PROC(Type) { \
+	Type partials[GB_PARALLEL_MAX_CHUNKS]; \
+	Type total = 0; \
+	isize chunk_count, i; \
+	gbprivParallelScan scan = {0}; \
+	scan.items      = items; \
+	scan.partials   = partials; \
+	scan.chunk_size = gb__parallel_chunk_size(count); \
+	scan.exclusive  = exclusive; \
+	chunk_count = (count + scan.chunk_size-1) / scan.chunk_size; \
+	gb_parallel_for(js, 0, count, scan.chunk_size, gb__parallel_sum_chunk_##Type, &scan); \
+	for (i = 0; i < chunk_count; i++) { \
+		Type value = partials[i]; \
+		partials[i] = total; \
+		total += value; \
+	} \
+	gb_parallel_for(js, 0, count, scan.chunk_size, gb__parallel_scan_chunk_##Type, &scan); \
+	return total; \
+}
+
+GB__PARALLEL_SUM_GEN(i32);
+GB__PARALLEL_SUM_GEN(i64);
+GB__PARALLEL_SUM_GEN(u32);
+GB__PARALLEL_SUM_GEN(u64);
+GB__PARALLEL_SUM_GEN(isize);
+GB__PARALLEL_SUM_GEN(f32);
+GB__PARALLEL_SUM_GEN(f64);
+
+#undef GB__PARALLEL_SUM_GEN
+
+
+#define GB__PARALLEL_SORT_OVERSAMPLE   16
+#define GB__PARALLEL_SORT_MAX_BUCKETS 256 // NOTE(bill): Bucket indices are stored as u8
+
+typedef struct gbprivParallelSort {
+	u8 *          base;
+	u8 *          temp;
+	u8 *          buckets; // NOTE(bill): The bucket of each item
+	u8 *          splitters;
+	isize *       offsets; // NOTE(bill): [chunk_count][bucket_count], counts then scatter offsets
+	isize         bucket_starts[GB__PARALLEL_SORT_MAX_BUCKETS+1];
+	isize         count, size;
+	isize         chunk_size, chunk_count, bucket_count;
+	gbCompareProc *cmp;
+} gbprivParallelSort;
+
+gb_internal GB_PARALLEL_FOR_PROC(gb__parallel_sort_classify) {
+	gbprivParallelSort *ps = cast(gbprivParallelSort *)data;
+	isize chunk;
+	for (chunk = start; chunk < end; chunk++) {
+		isize *counts = ps->offsets + chunk*ps->bucket_count;
+		isize i, first = chunk*ps->chunk_size, last = gb_min(first + ps->chunk_size, ps->count);
+		for (i = first; i < last; i++) {
+			u8 *item = ps->base + i*ps->size;
+			isize lo = 0, hi = ps->bucket_count-1;
+			while (lo < hi) {
+				isize mid = lo + (hi-lo)/2;
+				if (ps->cmp(item, ps->splitters + mid*ps->size) < 0)
+					hi = mid;
+				else
+					lo = mid+1;
+			}
+			ps->buckets[i] = cast(u8)lo;
+			counts[lo]++;
+		}
+	}
+}
+
+gb_internal GB_PARALLEL_FOR_PROC(gb__parallel_sort_scatter) {
+	gbprivParallelSort *ps = cast(gbprivParallelSort *)data;
+	isize chunk;
+	for (chunk = start; chunk < end; chunk++) {
+		isize *offsets = ps->offsets + chunk*ps->bucket_count;
+		isize i, first = chunk*ps->chunk_size, last = gb_min(first + ps->chunk_size, ps->count);
+		for (i = first; i < last; i++)
+			gb_memcopy(ps->temp + (offsets[ps->buckets[i]]++)*ps->size, ps->base + i*ps->size, ps->size);
+	}
+}
+
+gb_internal GB_PARALLEL_FOR_PROC(gb__parallel_sort_buckets) {
+	gbprivParallelSort *ps = cast(gbprivParallelSort *)data;
+	isize bucket;
+	for (bucket = start; bucket < end; bucket++) {
+		isize offset = ps->bucket_starts[bucket]*ps->size;
+		isize count  = ps->bucket_starts[bucket+1] - ps->bucket_starts[bucket];
+		gb_sort(ps->temp + offset, count, ps->size, ps->cmp);
+		gb_memcopy(ps->base + offset, ps->temp + offset, count*ps->size);
+	}
+}
+
+void gb_sort_parallel(gbJobSystem *js, void *base, isize count, isize size, gbCompareProc cmp) {
+	gbprivParallelSort ps = {0};
+	isize sample_count, i, b, c, total;
+	isize temp_size, buckets_size, samples_size, offsets_size;
+	u8 *memory, *samples;
+	u64 seed = 0x9e3779b97f4a7c15ull;
+
+	if (count < GB_PARALLEL_SORT_THRESHOLD || js->worker_count <= 1) {
+		gb_sort(base, count, size, cmp);
+		return;
+	}
+
+	ps.base         = cast(u8 *)base;
+	ps.count        = count;
+	ps.size         = size;
+	ps.cmp          = cmp;
+	ps.bucket_count = gb_min(js->worker_count*4, GB__PARALLEL_SORT_MAX_BUCKETS);
+	ps.chunk_count  = js->worker_count*2;
+	ps.chunk_size   = (count + ps.chunk_count-1) / ps.chunk_count;
+	sample_count    = ps.bucket_count*GB__PARALLEL_SORT_OVERSAMPLE;
+
+	temp_size    = (count*size + 15) & ~15;
+	buckets_size = (count + 15) & ~15;
+	samples_size = (sample_count*size + 15) & ~15;
+	offsets_size = ps.chunk_count*ps.bucket_count*gb_size_of(isize);
+	memory = cast(u8 *)gb_alloc(js->allocator, temp_size + buckets_size + samples_size + offsets_size);
+	ps.temp    = memory;
+	ps.buckets = memory + temp_size;
+	samples    = ps.buckets + buckets_size;
+	ps.offsets = cast(isize *)(samples + samples_size);
+	gb_zero_size(ps.offsets, offsets_size);
+
+	// NOTE(bill): Pick the splitters from a sorted random sample
+	for (i = 0; i < sample_count; i++) {
+		seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+		gb_memcopy(samples + i*size, ps.base + (seed % cast(u64)count)*size, size);
+	}
+	gb_sort(samples, sample_count, size, cmp);
+	for (b = 1; b < ps.bucket_count; b++)
+		gb_memmove(samples + (b-1)*size, samples + (b*GB__PARALLEL_SORT_OVERSAMPLE)*size, size);
+	ps.splitters = samples;
+
+	gb_parallel_for(js, 0, ps.chunk_count, 1, gb__parallel_sort_classify, &ps);
+
+	// NOTE(bill): Bucket major offsets so each chunk scatters into its own slice of every bucket
+	total = 0;
+	for (b = 0; b < ps.bucket_count; b++) {
+		ps.bucket_starts[b] = total;
+		for (c = 0; c < ps.chunk_count; c++) {
+			isize *offset = ps.offsets + c*ps.bucket_count + b;
+			isize n = *offset;
+			*offset = total;
+			total += n;
+		}
+	}
+	ps.bucket_starts[ps.bucket_count] = total;
+
+	gb_parallel_for(js, 0, ps.chunk_count,  1, gb__parallel_sort_scatter, &ps);
+	gb_parallel_for(js, 0, ps.bucket_count, 1, gb__parallel_sort_buckets, &ps);
+
+	gb_free(js->allocator, memory);
+}
+
+#undef GB__PARALLEL_SORT_OVERSAMPLE
+#undef GB__PARALLEL_SORT_MAX_BUCKETS
+
+
+
 ////////////////////////////////////////////////////////////////
 //
 // Char things
@@ -5922,36 +10271,17 @@ gb_inline isize gb_strnlen(char const *str, isize max_len) {
 }
 
 gb_inline isize gb_utf8_strlen(u8 const *str) {
-	isize count = 0;
-	for (; *str; count++) {
-		u8 c = *str;
-		isize inc = 0;
-		     if (c < 0x80)           inc = 1;
-		else if ((c & 0xe0) == 0xc0) inc = 2;
-		else if ((c & 0xf0) == 0xe0) inc = 3;
-		else if ((c & 0xf8) == 0xf0) inc = 4;
-		else return -1;
-
-		str += inc;
-	}
-	return count;
+	isize len = gb_strlen(cast(char const *)str);
+	if (gb_utf8_validate(str, len) != len)
+		return -1;
+	return gb_utf8_count(str, len);
 }
 
 gb_inline isize gb_utf8_strnlen(u8 const *str, isize max_len) {
-	isize count = 0;
-	for (; *str && max_len > 0; count++) {
-		u8 c = *str;
-		isize inc = 0;
-		     if (c < 0x80)           inc = 1;
-		else if ((c & 0xe0) == 0xc0) inc = 2;
-		else if ((c & 0xf0) == 0xe0) inc = 3;
-		else if ((c & 0xf8) == 0xf0) inc = 4;
-		else return -1;
-
-		str += inc;
-		max_len -= inc;
-	}
-	return count;
+	isize len = gb_strnlen(cast(char const *)str, max_len);
+	if (gb_utf8_validate(str, len) != len)
+		return -1;
+	return gb_utf8_count(str, len);
 }
 
 
@@ -6209,102 +10539,903 @@ gb_inline void gb_i64_to_str(i64 value, char *string, i32 base) {
 		negative = true;
 		value = -value;
 	}
-	if (value) {
-		while (value > 0) {
-			*buf++ = gb__num_to_char_table[value % base];
-			value /= base;
-		}
+	if (value) {
+		while (value > 0) {
+			*buf++ = gb__num_to_char_table[value % base];
+			value /= base;
+		}
+	} else {
+		*buf++ = '0';
+	}
+	if (negative)
+		*buf++ = '-';
+	*buf = '\0';
+	gb_strrev(string);
+}
+
+
+
+gb_inline void gb_u64_to_str(u64 value, char *string, i32 base) {
+	char *buf = string;
+
+	if (value) {
+		while (value > 0) {
+			*buf++ = gb__num_to_char_table[value % base];
+			value /= base;
+		}
+	} else {
+		*buf++ = '0';
+	}
+	*buf = '\0';
+
+	gb_strrev(string);
+}
+
+////////////////////////////////////////////////////////////////
+//
+// Floating Point Conversion
+//
+// NOTE(bill): Formatting is Grisu3 (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+// with Integers"), which gives the shortest digits that round trip and can tell when it is not sure.
+// For those (about 0.5% of values) the shortest digits are found with exact big integer arithmetic.
+// Parsing takes the exact f64 path when the digits and the power of ten are both exact, otherwise
+// it makes a 64 bit estimate with a known error bound. Only when the estimate is too close to a
+// halfway point does it fall back to an exact big integer comparison.
+//
+
+typedef struct gbprivDiyFp {
+	u64 f;
+	i32 e; // NOTE(bill): value = f * 2^e
+} gbprivDiyFp;
+
+// NOTE(bill): Normalized 10^k for k = -348, -340, ..., 340
+gb_global u64 const gb__cached_powers_f[87] = {
+	0xfa8fd5a0081c0288ull, 0xbaaee17fa23ebf76ull, 0x8b16fb203055ac76ull, 0xcf42894a5dce35eaull,
+	0x9a6bb0aa55653b2dull, 0xe61acf033d1a45dfull, 0xab70fe17c79ac6caull, 0xff77b1fcbebcdc4full,
+	0xbe5691ef416bd60cull, 0x8dd01fad907ffc3cull, 0xd3515c2831559a83ull, 0x9d71ac8fada6c9b5ull,
+	0xea9c227723ee8bcbull, 0xaecc49914078536dull, 0x823c12795db6ce57ull, 0xc21094364dfb5637ull,
+	0x9096ea6f3848984full, 0xd77485cb25823ac7ull, 0xa086cfcd97bf97f4ull, 0xef340a98172aace5ull,
+	0xb23867fb2a35b28eull, 0x84c8d4dfd2c63f3bull, 0xc5dd44271ad3cdbaull, 0x936b9fcebb25c996ull,
+	0xdbac6c247d62a584ull, 0xa3ab66580d5fdaf6ull, 0xf3e2f893dec3f126ull, 0xb5b5ada8aaff80b8ull,
+	0x87625f056c7c4a8bull, 0xc9bcff6034c13053ull, 0x964e858c91ba2655ull, 0xdff9772470297ebdull,
+	0xa6dfbd9fb8e5b88full, 0xf8a95fcf88747d94ull, 0xb94470938fa89bcfull, 0x8a08f0f8bf0f156bull,
+	0xcdb02555653131b6ull, 0x993fe2c6d07b7facull, 0xe45c10c42a2b3b06ull, 0xaa242499697392d3ull,
+	0xfd87b5f28300ca0eull, 0xbce5086492111aebull, 0x8cbccc096f5088ccull, 0xd1b71758e219652cull,
+	0x9c40000000000000ull, 0xe8d4a51000000000ull, 0xad78ebc5ac620000ull, 0x813f3978f8940984ull,
+	0xc097ce7bc90715b3ull, 0x8f7e32ce7bea5c70ull, 0xd5d238a4abe98068ull, 0x9f4f2726179a2245ull,
+	0xed63a231d4c4fb27ull, 0xb0de65388cc8ada8ull, 0x83c7088e1aab65dbull, 0xc45d1df942711d9aull,
+	0x924d692ca61be758ull, 0xda01ee641a708deaull, 0xa26da3999aef774aull, 0xf209787bb47d6b85ull,
+	0xb454e4a179dd1877ull, 0x865b86925b9bc5c2ull, 0xc83553c5c8965d3dull, 0x952ab45cfa97a0b3ull,
+	0xde469fbd99a05fe3ull, 0xa59bc234db398c25ull, 0xf6c69a72a3989f5cull, 0xb7dcbf5354e9beceull,
+	0x88fcf317f22241e2ull, 0xcc20ce9bd35c78a5ull, 0x98165af37b2153dfull, 0xe2a0b5dc971f303aull,
+	0xa8d9d1535ce3b396ull, 0xfb9b7cd9a4a7443cull, 0xbb764c4ca7a44410ull, 0x8bab8eefb6409c1aull,
+	0xd01fef10a657842cull, 0x9b10a4e5e9913129ull, 0xe7109bfba19c0c9dull, 0xac2820d9623bf429ull,
+	0x80444b5e7aa7cf85ull, 0xbf21e44003acdd2dull, 0x8e679c2f5e44ff8full, 0xd433179d9c8cb841ull,
+	0x9e19db92b4e31ba9ull, 0xeb96bf6ebadf77d9ull, 0xaf87023b9bf0ee6bull,
+};
+gb_global i16 const gb__cached_powers_e[87] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066,
+};
+
+gb_global u64 const gb__pow10_u64[20] = {
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+	1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+	100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+	1000000000000000000ull, 10000000000000000000ull,
+};
+
+// NOTE(bill): Every one of these is exact in an f64
+gb_global f64 const gb__pow10_f64[23] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+gb_internal gb_inline u64 gb__f64_bits(f64 value) { union { f64 f; u64 u; } v; v.f = value; return v.u; }
+gb_internal gb_inline f64 gb__f64_from_bits(u64 bits) { union { f64 f; u64 u; } v; v.u = bits; return v.f; }
+gb_internal gb_inline u32 gb__f32_bits(f32 value) { union { f32 f; u32 u; } v; v.f = value; return v.u; }
+
+gb_internal gb_inline i32 gb__fls64(u64 x) {
+#if defined(GB_ARCH_64_BIT)
+	return gb__fls_usize(cast(usize)x);
+#else
+	u32 hi = cast(u32)(x >> 32);
+	return hi ? 32 + gb__fls32(hi) : gb__fls32(cast(u32)x);
+#endif
+}
+
+gb_internal gb_inline gbprivDiyFp gb__diy_fp(u64 f, i32 e) {
+	gbprivDiyFp r;
+	r.f = f;
+	r.e = e;
+	return r;
+}
+
+gb_internal gb_inline gbprivDiyFp gb__diy_fp_normalize(gbprivDiyFp x) {
+	i32 shift = 63 - gb__fls64(x.f);
+	x.f <<= shift;
+	x.e -= shift;
+	return x;
+}
+
+// NOTE(bill): The upper 64 bits of the 128 bit product, rounded
+gb_internal gbprivDiyFp gb__diy_fp_mul(gbprivDiyFp x, gbprivDiyFp y) {
+	u64 a = x.f >> 32, b = x.f & 0xffffffffull;
+	u64 c = y.f >> 32, d = y.f & 0xffffffffull;
+	u64 ac = a*c, bc = b*c, ad = a*d, bd = b*d;
+	u64 tmp = (bd >> 32) + (ad & 0xffffffffull) + (bc & 0xffffffffull);
+	tmp += 1ull << 31;
+	return gb__diy_fp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+// NOTE(bill): Returns the index of the cached power which brings a number with a binary exponent
+// of `e` into [2^-60, 2^-32), and the negated decimal exponent of that power
+gb_internal gb_inline i32 gb__cached_power_for_binary_exponent(i32 e, i32 *decimal_exponent) {
+	f64 dk = (-61 - e) * 0.30102999566398114 + 347;
+	i32 k = cast(i32)dk, index;
+	if (dk - k > 0.0) k++;
+	index = (k >> 3) + 1;
+	*decimal_exponent = -(-348 + (index << 3));
+	return index;
+}
+
+// NOTE(bill): Grisu3's check and round (double-conversion's RoundWeed). Moves the last digit down
+// towards w like Grisu2 does, but as the boundaries and w are only known to within `unit` it
+// returns false when that is not enough to be sure the digits are the shortest and the closest.
+gb_internal b32 gb__grisu_round_weed(char *digits, i32 len, u64 distance_too_high_w, u64 unsafe_interval,
+                                     u64 rest, u64 ten_kappa, u64 unit) {
+	u64 small_distance = distance_too_high_w - unit;
+	u64 big_distance   = distance_too_high_w + unit;
+	while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+	       (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+		digits[len-1]--;
+		rest += ten_kappa;
+	}
+	if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+	    (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance))
+		return false;
+	return 2*unit <= rest && rest <= unsafe_interval - 4*unit;
+}
+
+// NOTE(bill): Writes the digits of f * 2^e (f != 0), their count goes in `*len` and the value is then
+// digits * 10^(*decimal_exponent). `lower_closer` is set when the float below is half as far away
+// as the float above, i.e. f is the smallest significand of a binade.
+// At most 17 digits for an f64 and 9 for an f32. Returns false for the ~0.5% of values where the
+// digits might not be the shortest, they are then only a close guess.
+gb_internal b32 gb__grisu3(u64 f, i32 e, b32 lower_closer, char *digits, i32 *len, i32 *decimal_exponent) {
+	gbprivDiyFp w, plus, minus, c_mk, high, low;
+	u64 unit = 1, too_high, unsafe_interval, one_f, p2, rest;
+	u32 p1;
+	i32 one_e, kappa;
+
+	plus = gb__diy_fp_normalize(gb__diy_fp((f << 1) + 1, e - 1));
+	minus = lower_closer ? gb__diy_fp((f << 2) - 1, e - 2) : gb__diy_fp((f << 1) - 1, e - 1);
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+
+	{
+		i32 index = gb__cached_power_for_binary_exponent(plus.e, decimal_exponent);
+		c_mk = gb__diy_fp(gb__cached_powers_f[index], gb__cached_powers_e[index]);
+	}
+
+	// NOTE(bill): The products are each out by up to one unit, so the digits are made from the
+	// widest interval they could be and checked against the narrowest at the end
+	w    = gb__diy_fp_mul(gb__diy_fp_normalize(gb__diy_fp(f, e)), c_mk);
+	high = gb__diy_fp_mul(plus,  c_mk);
+	low  = gb__diy_fp_mul(minus, c_mk);
+	too_high = high.f + unit;
+	unsafe_interval = too_high - (low.f - unit);
+
+	one_e = -w.e;
+	one_f = 1ull << one_e;
+	p1 = cast(u32)(too_high >> one_e);
+	p2 = too_high & (one_f - 1);
+	*len = 0;
+
+	for (kappa = 1; kappa < 10 && p1 >= gb__pow10_u64[kappa]; kappa++) {
+		// NOTE(bill): Count the digits of the integral part
+	}
+
+	while (kappa > 0) {
+		u32 div = cast(u32)gb__pow10_u64[kappa-1];
+		u32 d = p1 / div;
+		p1 %= div;
+		if (d || *len)
+			digits[(*len)++] = cast(char)('0' + d);
+		kappa--;
+		rest = (cast(u64)p1 << one_e) + p2;
+		if (rest < unsafe_interval) {
+			*decimal_exponent += kappa;
+			return gb__grisu_round_weed(digits, *len, too_high - w.f, unsafe_interval, rest,
+			                            gb__pow10_u64[kappa] << one_e, unit);
+		}
+	}
+
+	for (;;) {
+		char d;
+		p2 *= 10;
+		unit *= 10;
+		unsafe_interval *= 10;
+		d = cast(char)(p2 >> one_e);
+		if (d || *len)
+			digits[(*len)++] = cast(char)('0' + d);
+		p2 &= one_f - 1;
+		kappa--;
+		if (p2 < unsafe_interval) {
+			*decimal_exponent += kappa;
+			return gb__grisu_round_weed(digits, *len, (too_high - w.f) * unit, unsafe_interval, p2, one_f, unit);
+		}
+	}
+}
+
+// NOTE(bill): Exact arithmetic for the rare inputs the estimate cannot settle, 4096 bits is enough
+// for 800 significant digits at any exponent an f64 can reach
+#define GB__BIGINT_LIMBS 128
+#define GB__STRTOD_MAX_DIGITS 800
+#define GB__FLOAT_EXACT_DIGITS 770 // NOTE(bill): No f64 has more significant digits than this
+
+typedef struct gbprivBigInt {
+	u32 limbs[GB__BIGINT_LIMBS];
+	i32 count;
+} gbprivBigInt;
+
+gb_internal void gb__bigint_set_u64(gbprivBigInt *b, u64 value) {
+	b->count = 0;
+	while (value) {
+		b->limbs[b->count++] = cast(u32)value;
+		value >>= 32;
+	}
+}
+
+gb_internal void gb__bigint_mul_add_u32(gbprivBigInt *b, u32 mul, u32 add) {
+	u64 carry = add;
+	i32 i;
+	for (i = 0; i < b->count; i++) {
+		carry += cast(u64)b->limbs[i] * mul;
+		b->limbs[i] = cast(u32)carry;
+		carry >>= 32;
+	}
+	if (carry && b->count < GB__BIGINT_LIMBS)
+		b->limbs[b->count++] = cast(u32)carry;
+}
+
+gb_internal void gb__bigint_mul_pow5(gbprivBigInt *b, i32 n) {
+	gb_local_persist u32 const pow5[14] = {1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125,
+	                                       9765625, 48828125, 244140625, 1220703125};
+	while (n >= 13) {
+		gb__bigint_mul_add_u32(b, pow5[13], 0);
+		n -= 13;
+	}
+	if (n > 0)
+		gb__bigint_mul_add_u32(b, pow5[n], 0);
+}
+
+gb_internal void gb__bigint_shift_left(gbprivBigInt *b, i32 bits) {
+	i32 limbs = bits / 32, shift = bits % 32, i;
+	if (b->count == 0 || bits <= 0) return;
+	GB_ASSERT(b->count + limbs + 1 <= GB__BIGINT_LIMBS);
+	if (shift) {
+		u32 carry = 0;
+		for (i = 0; i < b->count; i++) {
+			u32 limb = b->limbs[i];
+			b->limbs[i] = (limb << shift) | carry;
+			carry = limb >> (32 - shift);
+		}
+		if (carry)
+			b->limbs[b->count++] = carry;
+	}
+	if (limbs) {
+		for (i = b->count-1; i >= 0; i--)
+			b->limbs[i + limbs] = b->limbs[i];
+		for (i = 0; i < limbs; i++)
+			b->limbs[i] = 0;
+		b->count += limbs;
+	}
+}
+
+// NOTE(bill): a -= b, a must not be less than b
+gb_internal void gb__bigint_sub(gbprivBigInt *a, gbprivBigInt const *b) {
+	u64 borrow = 0;
+	i32 i;
+	for (i = 0; i < a->count; i++) {
+		u64 diff = cast(u64)a->limbs[i] - (i < b->count ? b->limbs[i] : 0) - borrow;
+		a->limbs[i] = cast(u32)diff;
+		borrow = (diff >> 32) & 1;
+	}
+	while (a->count > 0 && a->limbs[a->count-1] == 0)
+		a->count--;
+}
+
+gb_internal i32 gb__bigint_compare(gbprivBigInt const *a, gbprivBigInt const *b) {
+	i32 i;
+	if (a->count != b->count)
+		return a->count < b->count ? -1 : +1;
+	for (i = a->count-1; i >= 0; i--) {
+		if (a->limbs[i] != b->limbs[i])
+			return a->limbs[i] < b->limbs[i] ? -1 : +1;
+	}
+	return 0;
+}
+
+// NOTE(bill): Compares m * 2^e against the decimal 0.digits * 10^point
+gb_internal i32 gb__float_compare_scaled(u64 m, i32 e, char const *digits, i32 len, i32 point) {
+	gbprivBigInt lhs, rhs;
+	i32 q = point - len, pow2, i;
+
+	gb__bigint_set_u64(&lhs, m);
+	gb__bigint_set_u64(&rhs, 0);
+	for (i = 0; i < len; i++)
+		gb__bigint_mul_add_u32(&rhs, 10, cast(u32)(digits[i] - '0'));
+
+	// NOTE(bill): m * 2^e against digits * 5^q * 2^q
+	if (q >= 0) gb__bigint_mul_pow5(&rhs, q);
+	else        gb__bigint_mul_pow5(&lhs, -q);
+	pow2 = e - q;
+	if (pow2 > 0) gb__bigint_shift_left(&lhs, pow2);
+	else          gb__bigint_shift_left(&rhs, -pow2);
+	return gb__bigint_compare(&lhs, &rhs);
+}
+
+// NOTE(bill): Compares the exact value of `value` (finite, the sign is ignored) against the decimal
+// 0.digits * 10^point
+gb_internal i32 gb__float_compare_digits(f64 value, char const *digits, i32 len, i32 point) {
+	u64 bits = gb__f64_bits(value), m = bits & 0xfffffffffffffull;
+	i32 biased = cast(i32)((bits >> 52) & 0x7ff), e = -1074;
+	if (biased) {
+		m |= 1ull << 52;
+		e = biased - 1075;
+	}
+	return gb__float_compare_scaled(m, e, digits, len, point);
+}
+
+// NOTE(bill): Drops trailing zeros, or adds one to the last digit with the carry
+gb_internal i32 gb__float_finish_digits(char *digits, i32 len, b32 round_up, i32 *point) {
+	i32 i;
+	if (!round_up) {
+		while (len > 0 && digits[len-1] == '0')
+			len--;
+		return len;
+	}
+
+	for (i = len-1; i >= 0; i--) {
+		if (digits[i] < '9') {
+			digits[i]++;
+			return i+1;
+		}
+	}
+	// NOTE(bill): All nines (or nothing kept) carried into a new leading digit
+	digits[0] = '1';
+	*point += 1;
+	return 1;
+}
+
+// NOTE(bill): Rounds the shortest digits of `value` to `keep` digits. The decimal point is `*point`
+// digits from the front, a carry out of the first digit moves it along one. A trailing 5 is rarely
+// an exact tie so the direction comes from the exact value, and only a true tie goes to even.
+// Returns the new digit count, 0 if everything rounded away.
+gb_internal i32 gb__float_round_digits(f64 value, char *digits, i32 len, i32 keep, i32 *point) {
+	b32 round_up;
+	if (keep >= len) return len;
+	if (keep < 0)    return 0;
+
+	round_up = digits[keep] > '5' || (digits[keep] == '5' && keep+1 < len);
+	if (digits[keep] == '5' && keep+1 == len) {
+		i32 cmp = gb__float_compare_digits(value, digits, len, *point);
+		round_up = cmp > 0 || (cmp == 0 && keep > 0 && ((digits[keep-1]-'0') & 1));
+	}
+	return gb__float_finish_digits(digits, keep, round_up, point);
+}
+
+// NOTE(bill): Exactly `keep` significant digits of `value` (finite, non-zero, the sign is ignored), or
+// with `fixed` set, `keep` digits after the decimal point. Only used when more digits are asked for
+// than the shortest form has, as every f64 is a finite decimal the result is the same as printf's.
+// `*point` must be within one of the answer on entry.
+gb_internal i32 gb__float_exact_digits(f64 value, char *digits, i32 keep, b32 fixed, i32 *point) {
+	gbprivBigInt num, den, tmp;
+	u64 bits = gb__f64_bits(value), m = bits & 0xfffffffffffffull;
+	i32 biased = cast(i32)((bits >> 52) & 0x7ff), e = -1074, k = *point, i, cmp;
+	if (biased) {
+		m |= 1ull << 52;
+		e = biased - 1075;
+	}
+
+	// NOTE(bill): value / 10^k = num / den, then k is moved until that is in [0.1, 1)
+	gb__bigint_set_u64(&num, m);
+	gb__bigint_set_u64(&den, 1);
+	if (e > 0) gb__bigint_shift_left(&num, e);
+	else       gb__bigint_shift_left(&den, -e);
+	if (k >= 0) {
+		gb__bigint_mul_pow5(&den, k);
+		gb__bigint_shift_left(&den, k);
+	} else {
+		gb__bigint_mul_pow5(&num, -k);
+		gb__bigint_shift_left(&num, -k);
+	}
+	while (gb__bigint_compare(&num, &den) >= 0) {
+		gb__bigint_mul_add_u32(&den, 10, 0);
+		k++;
+	}
+	for (;;) {
+		tmp = num;
+		gb__bigint_mul_add_u32(&tmp, 10, 0);
+		if (gb__bigint_compare(&tmp, &den) >= 0)
+			break;
+		num = tmp;
+		k--;
+	}
+
+	*point = k;
+	if (fixed)
+		keep += k;
+	keep = gb_min(keep, GB__FLOAT_EXACT_DIGITS);
+	if (keep < 0)
+		return 0;
+
+	for (i = 0; i < keep; i++) {
+		char d = '0';
+		gb__bigint_mul_add_u32(&num, 10, 0);
+		while (gb__bigint_compare(&num, &den) >= 0) {
+			gb__bigint_sub(&num, &den);
+			d++;
+		}
+		digits[i] = d;
+	}
+
+	gb__bigint_shift_left(&num, 1);
+	cmp = gb__bigint_compare(&num, &den);
+	return gb__float_finish_digits(digits, keep, cmp > 0 || (cmp == 0 && keep > 0 && ((digits[keep-1]-'0') & 1)), point);
+}
+
+// NOTE(bill): Whether 0.digits * 10^point reads back as the float m * 2^e, i.e. it is between the
+// halfway points to the floats either side of it, or on one when m is even as ties go to even
+gb_internal b32 gb__float_digits_round_trip(u64 m, i32 e, b32 lower_closer, char const *digits, i32 len, i32 point) {
+	b32 even = (m & 1) == 0;
+	i32 above = gb__float_compare_scaled((m << 1) + 1, e - 1, digits, len, point);
+	i32 below = lower_closer ? gb__float_compare_scaled((m << 2) - 1, e - 2, digits, len, point)
+	                         : gb__float_compare_scaled((m << 1) - 1, e - 1, digits, len, point);
+	return (above > 0 || (even && above == 0)) && (below < 0 || (even && below == 0));
+}
+
+// NOTE(bill): The decimal with `count` significant digits nearest to `value` (= m * 2^e), if it reads
+// back. Above a power of two the gap to the next float is twice the one below, so the decimal just
+// above can read back when the nearest (below) does not.
+gb_internal b32 gb__float_try_digits(f64 value, u64 m, i32 e, b32 lower_closer, i32 count, char *digits, i32 *len, i32 *point) {
+	i32 i;
+	*len = gb__float_exact_digits(value, digits, count, false, point);
+	if (gb__float_digits_round_trip(m, e, lower_closer, digits, *len, *point))
+		return true;
+	if (!lower_closer || gb__float_compare_scaled(m, e, digits, *len, *point) < 0)
+		return false;
+	for (i = *len; i < count; i++)
+		digits[i] = '0';
+	*len = gb__float_finish_digits(digits, count, true, point);
+	return gb__float_digits_round_trip(m, e, lower_closer, digits, *len, *point);
+}
+
+// NOTE(bill): The exact fallback for when Grisu3 cannot vouch for its digits, whose count is a close
+// guess to start from. The fewest digits which read back, and of those the nearest to `value`.
+gb_internal i32 gb__float_shortest_exact(f64 value, u64 m, i32 e, b32 lower_closer, char *digits, i32 len, i32 *decimal_exponent) {
+	char best[20], attempt[20];
+	i32 guess_point = *decimal_exponent + len, best_len = 0, best_point = 0, count, attempt_len, attempt_point;
+	b32 found = false;
+
+	// NOTE(bill): If a count reads back so does every longer one, 17 digits always do
+	for (count = len; count <= 17 && !found; count++) {
+		best_point = guess_point;
+		found = gb__float_try_digits(value, m, e, lower_closer, count, best, &best_len, &best_point);
+	}
+	GB_ASSERT(found);
+	if (count-1 == len) {
+		for (count = len-1; count > 0; count--) {
+			attempt_point = guess_point;
+			if (!gb__float_try_digits(value, m, e, lower_closer, count, attempt, &attempt_len, &attempt_point))
+				break;
+			gb_memcopy(best, attempt, attempt_len);
+			best_len   = attempt_len;
+			best_point = attempt_point;
+		}
+	}
+
+	gb_memcopy(digits, best, best_len);
+	*decimal_exponent = best_point - best_len;
+	return best_len;
+}
+
+// NOTE(bill): `value` must be finite and non-zero, the sign is ignored
+gb_internal i32 gb__f64_shortest_digits(f64 value, char *digits, i32 *decimal_exponent) {
+	u64 bits = gb__f64_bits(value);
+	u64 m = bits & 0xfffffffffffffull;
+	i32 biased = cast(i32)((bits >> 52) & 0x7ff), e = -1074, len;
+	b32 lower_closer = m == 0 && biased > 1;
+	if (biased) {
+		m |= 1ull << 52;
+		e = biased - 1075;
+	}
+	if (gb__grisu3(m, e, lower_closer, digits, &len, decimal_exponent))
+		return len;
+	return gb__float_shortest_exact(value, m, e, lower_closer, digits, len, decimal_exponent);
+}
+
+gb_internal i32 gb__f32_shortest_digits(f32 value, char *digits, i32 *decimal_exponent) {
+	u32 bits = gb__f32_bits(value);
+	u32 m = bits & 0x7fffff;
+	i32 biased = cast(i32)((bits >> 23) & 0xff), e = -149, len;
+	b32 lower_closer = m == 0 && biased > 1;
+	if (biased) {
+		m |= 1u << 23;
+		e = biased - 150;
+	}
+	if (gb__grisu3(m, e, lower_closer, digits, &len, decimal_exponent))
+		return len;
+	return gb__float_shortest_exact(value, m, e, lower_closer, digits, len, decimal_exponent);
+}
+
+gb_internal gb_inline char gb__float_digit(char const *digits, i32 len, i32 index) {
+	return (index >= 0 && index < len) ? digits[index] : '0';
+}
+
+gb_internal isize gb__float_write_fixed(char *out, char const *digits, i32 len, i32 point, i32 fraction, b32 alt) {
+	char *text = out;
+	i32 i;
+	if (point <= 0) {
+		*text++ = '0';
+	} else {
+		for (i = 0; i < point; i++)
+			*text++ = gb__float_digit(digits, len, i);
+	}
+	if (fraction > 0 || alt)
+		*text++ = '.';
+	for (i = 0; i < fraction; i++)
+		*text++ = gb__float_digit(digits, len, point + i);
+	return text - out;
+}
+
+gb_internal isize gb__float_write_exponent(char *out, char const *digits, i32 len, i32 point, i32 fraction, b32 alt, b32 upper) {
+	char *text = out;
+	i32 i, exponent = len ? point-1 : 0;
+	*text++ = gb__float_digit(digits, len, 0);
+	if (fraction > 0 || alt)
+		*text++ = '.';
+	for (i = 0; i < fraction; i++)
+		*text++ = gb__float_digit(digits, len, i+1);
+	*text++ = upper ? 'E' : 'e';
+	if (exponent < 0) {
+		*text++ = '-';
+		exponent = -exponent;
 	} else {
-		*buf++ = '0';
+		*text++ = '+';
 	}
-	if (negative)
-		*buf++ = '-';
-	*buf = '\0';
-	gb_strrev(string);
+	if (exponent >= 100)
+		*text++ = cast(char)('0' + exponent/100);
+	*text++ = cast(char)('0' + (exponent/10)%10);
+	*text++ = cast(char)('0' + exponent%10);
+	return text - out;
+}
+
+// NOTE(bill): The shortest form, fixed notation for magnitudes in [1e-4, 1e17) and exponent notation
+// otherwise, `out` needs GB_FLOAT_STR_MAX bytes
+gb_internal isize gb__float_write_shortest(char *out, char const *digits, i32 len, i32 point, b32 upper) {
+	i32 exponent = len ? point-1 : 0;
+	if (exponent >= -4 && exponent < 17)
+		return gb__float_write_fixed(out, digits, len, point, gb_max(len - point, 0), false);
+	return gb__float_write_exponent(out, digits, len, point, len-1, false, upper);
+}
+
+isize gb_f64_to_str(f64 value, char *string) {
+	char digits[20];
+	char *text = string;
+	i32 len, point;
+	u64 bits = gb__f64_bits(value);
+
+	if (bits >> 63)
+		*text++ = '-';
+	if ((bits & 0x7ff0000000000000ull) == 0x7ff0000000000000ull) {
+		gb_memcopy(text, (bits & 0xfffffffffffffull) ? "nan" : "inf", 3);
+		text[3] = '\0';
+		return (text - string) + 3;
+	}
+	if (value == 0) {
+		*text++ = '0';
+		*text = '\0';
+		return text - string;
+	}
+
+	len = gb__f64_shortest_digits(value, digits, &point);
+	point += len;
+	text += gb__float_write_shortest(text, digits, len, point, false);
+	*text = '\0';
+	return text - string;
+}
+
+isize gb_f32_to_str(f32 value, char *string) {
+	char digits[12];
+	char *text = string;
+	i32 len, point;
+	u32 bits = gb__f32_bits(value);
+
+	if ((bits & 0x7f800000) == 0x7f800000)
+		return gb_f64_to_str(value, string); // NOTE(bill): nan and inf
+	if (bits >> 31)
+		*text++ = '-';
+	if (value == 0) {
+		*text++ = '0';
+		*text = '\0';
+		return text - string;
+	}
+
+	len = gb__f32_shortest_digits(value, digits, &point);
+	point += len;
+	text += gb__float_write_shortest(text, digits, len, point, false);
+	*text = '\0';
+	return text - string;
 }
 
 
+// NOTE(bill): `guess` is the correctly rounded result or the float just below it. Decides by comparing
+// the exact decimal input with the halfway point between `guess` and the next float up.
+gb_internal f64 gb__strtod_bignum(char const *text, char const *text_end, i32 exponent, f64 guess) {
+	gbprivBigInt input, halfway;
+	u64 bits = gb__f64_bits(guess), m;
+	i32 e, biased, taken = 0, sticky = 0, cmp, pow2;
+	u32 chunk = 0, chunk_len = 0;
+	b32 seen_point = false;
 
-gb_inline void gb_u64_to_str(u64 value, char *string, i32 base) {
-	char *buf = string;
+	biased = cast(i32)((bits >> 52) & 0x7ff);
+	if (biased == 0x7ff)
+		return guess;
 
-	if (value) {
-		while (value > 0) {
-			*buf++ = gb__num_to_char_table[value % base];
-			value /= base;
+	gb__bigint_set_u64(&input, 0);
+	for (; text < text_end; text++) {
+		if (*text == '.') {
+			seen_point = true;
+			continue;
+		}
+		if (taken == 0 && *text == '0') {
+			if (seen_point) exponent--;
+			continue;
+		}
+		if (taken < GB__STRTOD_MAX_DIGITS) {
+			chunk = chunk*10 + cast(u32)(*text - '0');
+			if (++chunk_len == 9) {
+				gb__bigint_mul_add_u32(&input, 1000000000u, chunk);
+				chunk = chunk_len = 0;
+			}
+			taken++;
+			if (seen_point) exponent--;
+		} else {
+			if (*text != '0') sticky = 1;
+			if (!seen_point) exponent++;
 		}
+	}
+	if (chunk_len)
+		gb__bigint_mul_add_u32(&input, cast(u32)gb__pow10_u64[chunk_len], chunk);
+
+	m = bits & 0xfffffffffffffull;
+	if (biased) {
+		m |= 1ull << 52;
+		e = biased - 1075;
 	} else {
-		*buf++ = '0';
+		e = -1074;
 	}
-	*buf = '\0';
 
-	gb_strrev(string);
+	// NOTE(bill): input * 10^exponent against (2m + 1) * 2^(e-1), with the powers of five and two
+	// moved to whichever side keeps them integral
+	gb__bigint_set_u64(&halfway, 2*m + 1);
+	if (exponent >= 0) {
+		gb__bigint_mul_pow5(&input, exponent);
+	} else {
+		gb__bigint_mul_pow5(&halfway, -exponent);
+	}
+	pow2 = exponent - (e - 1);
+	if (pow2 > 0) gb__bigint_shift_left(&input, pow2);
+	else          gb__bigint_shift_left(&halfway, -pow2);
+
+	cmp = gb__bigint_compare(&input, &halfway);
+	if (cmp > 0 || (cmp == 0 && (sticky || (m & 1))))
+		return gb__f64_from_bits(bits + 1);
+	return guess;
+}
+
+gb_internal f64 gb__diy_fp_to_f64(gbprivDiyFp v) {
+	u64 f = v.f;
+	i32 e = v.e;
+	while (f > (1ull << 53) - 1) {
+		f >>= 1;
+		e++;
+	}
+	if (e >= 972)
+		return gb__f64_from_bits(0x7ff0000000000000ull);
+	if (e < -1074)
+		return 0.0;
+	while (e > -1074 && (f & (1ull << 52)) == 0) {
+		f <<= 1;
+		e--;
+	}
+	if (e == -1074 && (f & (1ull << 52)) == 0)
+		return gb__f64_from_bits(f);
+	return gb__f64_from_bits((f & 0xfffffffffffffull) | (cast(u64)(e + 1075) << 52));
 }
 
-gb_inline f32 gb_str_to_f32(char const *str, char **end_ptr) {
-	f64 f = gb_str_to_f64(str, end_ptr);
-	f32 r = cast(f32)f;
-	return r;
+// NOTE(bill): Estimates mantissa * 10^exponent, the error is tracked in eighths of an ulp of the
+// 64 bit intermediate. Returns false if the result might be one float too low.
+gb_internal b32 gb__strtod_diy_fp(u64 mantissa, i32 digit_count, i32 exponent, b32 truncated, f64 *result) {
+	gbprivDiyFp input, cached;
+	u64 error = truncated ? 8 : 0, precision_bits, half_way, mask;
+	i32 old_e, index, adjustment, order, significand_size, precision_count;
+
+	input = gb__diy_fp(mantissa, 0);
+	if (exponent < -348) {
+		*result = 0.0;
+		return true;
+	}
+	index = (exponent + 348) >> 3;
+	adjustment = exponent - (-348 + (index << 3));
+
+	old_e = input.e;
+	input = gb__diy_fp_normalize(input);
+	error <<= old_e - input.e;
+
+	if (adjustment) {
+		gbprivDiyFp power = gb__diy_fp_normalize(gb__diy_fp(gb__pow10_u64[adjustment], 0));
+		input = gb__diy_fp_mul(input, power);
+		if (19 - digit_count < adjustment) // NOTE(bill): The product does not fit in 64 bits
+			error += 4;
+	}
+
+	cached = gb__diy_fp(gb__cached_powers_f[index], gb__cached_powers_e[index]);
+	input = gb__diy_fp_mul(input, cached);
+	error += 8 + (error ? 1 : 0);
+
+	old_e = input.e;
+	input = gb__diy_fp_normalize(input);
+	error <<= old_e - input.e;
+
+	order = 64 + input.e;
+	if (order >= -1074 + 53)  significand_size = 53;
+	else if (order <= -1074)  significand_size = 0;
+	else                      significand_size = order + 1074;
+	precision_count = 64 - significand_size;
+	if (precision_count + 3 >= 64) {
+		i32 shift = precision_count + 3 - 64 + 1;
+		input.f >>= shift;
+		input.e += shift;
+		error = (error >> shift) + 1 + 8;
+		precision_count -= shift;
+	}
+
+	mask = (1ull << precision_count) - 1;
+	precision_bits = (input.f & mask) * 8;
+	half_way = (1ull << (precision_count - 1)) * 8;
+
+	input.f >>= precision_count;
+	input.e += precision_count;
+	if (precision_bits >= half_way + error)
+		input.f++;
+
+	*result = gb__diy_fp_to_f64(input);
+	return half_way - error >= precision_bits || precision_bits >= half_way + error;
 }
 
-gb_inline f64 gb_str_to_f64(char const *str, char **end_ptr) {
-	f64 result, value, sign, scale;
-	i32 frac;
+f64 gb_str_to_f64(char const *str, char **end_ptr) {
+	char const *begin = str, *digits_begin, *digits_end;
+	u64 mantissa = 0;
+	i32 digit_count = 0, exponent = 0, explicit_exponent = 0;
+	b32 negative = false, truncated = false, any_digits = false;
+	f64 result;
 
-	while (gb_char_is_space(*str)) {
+	while (gb_char_is_space(*str))
 		str++;
-	}
 
-	sign = 1.0;
 	if (*str == '-') {
-		sign = -1.0;
+		negative = true;
 		str++;
 	} else if (*str == '+') {
 		str++;
 	}
 
-	for (value = 0.0; gb_char_is_digit(*str); str++) {
-		value = value * 10.0 + (*str-'0');
+	if (gb_char_to_lower(str[0]) == 'i' && gb_char_to_lower(str[1]) == 'n' && gb_char_to_lower(str[2]) == 'f') {
+		str += 3;
+		if (gb_strncmp(str, "inity", 5) == 0 || gb_strncmp(str, "INITY", 5) == 0)
+			str += 5;
+		if (end_ptr) *end_ptr = cast(char *)str;
+		return gb__f64_from_bits((cast(u64)negative << 63) | 0x7ff0000000000000ull);
+	}
+	if (gb_char_to_lower(str[0]) == 'n' && gb_char_to_lower(str[1]) == 'a' && gb_char_to_lower(str[2]) == 'n') {
+		if (end_ptr) *end_ptr = cast(char *)(str + 3);
+		return gb__f64_from_bits((cast(u64)negative << 63) | 0x7ff8000000000000ull);
 	}
 
-	if (*str == '.') {
-		f64 pow10 = 10.0;
+	digits_begin = str;
+	for (; *str == '0'; str++)
+		any_digits = true;
+	for (; gb_char_is_digit(*str); str++) {
+		any_digits = true;
+		if (digit_count < 19) {
+			mantissa = mantissa*10 + cast(u64)(*str - '0');
+			digit_count++;
+		} else {
+			if (*str != '0') truncated = true;
+			exponent++;
+		}
+	}
+	if (*str == '.' && (any_digits || gb_char_is_digit(str[1]))) {
 		str++;
-		while (gb_char_is_digit(*str)) {
-			value += (*str-'0') / pow10;
-			pow10 *= 10.0;
-			str++;
+		if (digit_count == 0) {
+			for (; *str == '0'; str++) {
+				any_digits = true;
+				exponent--;
+			}
+		}
+		for (; gb_char_is_digit(*str); str++) {
+			any_digits = true;
+			if (digit_count < 19) {
+				mantissa = mantissa*10 + cast(u64)(*str - '0');
+				digit_count++;
+				exponent--;
+			} else if (*str != '0') {
+				truncated = true;
+			}
 		}
 	}
+	digits_end = str;
 
-	frac = 0;
-	scale = 1.0;
-	if ((*str == 'e') || (*str == 'E')) {
-		u32 exp;
+	if (!any_digits) {
+		if (end_ptr) *end_ptr = cast(char *)begin;
+		return 0.0;
+	}
 
+	if ((*str == 'e' || *str == 'E') &&
+	    (gb_char_is_digit(str[1]) || ((str[1] == '-' || str[1] == '+') && gb_char_is_digit(str[2])))) {
+		b32 negative_exponent = false;
 		str++;
-		if (*str == '-') {
-			frac = 1;
-			str++;
-		} else if (*str == '+') {
-			str++;
+		if (*str == '-' || *str == '+')
+			negative_exponent = *str++ == '-';
+		for (; gb_char_is_digit(*str); str++) {
+			if (explicit_exponent < 100000)
+				explicit_exponent = explicit_exponent*10 + (*str - '0');
 		}
+		if (negative_exponent)
+			explicit_exponent = -explicit_exponent;
+	}
+	if (end_ptr) *end_ptr = cast(char *)str;
 
-		for (exp = 0; gb_char_is_digit(*str); str++) {
-			exp = exp * 10 + (*str-'0');
+	exponent += explicit_exponent;
+	if (mantissa == 0) {
+		result = 0.0;
+	} else if (exponent + digit_count > 310) {
+		result = gb__f64_from_bits(0x7ff0000000000000ull);
+	} else if (exponent + digit_count < -324) {
+		result = 0.0;
+	} else if (!truncated && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22+15) {
+		// NOTE(bill): Both operands are exact so the single rounding is correct
+		if (exponent < 0) {
+			result = cast(f64)mantissa / gb__pow10_f64[-exponent];
+		} else if (exponent <= 22) {
+			result = cast(f64)mantissa * gb__pow10_f64[exponent];
+		} else if (mantissa <= (1ull << 53) / gb__pow10_u64[exponent-22]) {
+			result = cast(f64)(mantissa * gb__pow10_u64[exponent-22]) * 1e22;
+		} else if (!gb__strtod_diy_fp(mantissa, digit_count, exponent, truncated, &result)) {
+			result = gb__strtod_bignum(digits_begin, digits_end, explicit_exponent, result);
 		}
-		if (exp > 308) exp = 308;
-
-		while (exp >= 50) { scale *= 1e50; exp -= 50; }
-		while (exp >=  8) { scale *= 1e8;  exp -=  8; }
-		while (exp >   0) { scale *= 10.0; exp -=  1; }
+	} else if (!gb__strtod_diy_fp(mantissa, digit_count, exponent, truncated, &result)) {
+		result = gb__strtod_bignum(digits_begin, digits_end, explicit_exponent, result);
 	}
 
-	result = sign * (frac ? (value / scale) : (value * scale));
-
-	if (end_ptr) *end_ptr = cast(char *)str;
+	return negative ? -result : result;
+}
 
-	return result;
+// NOTE(bill): This rounds twice (decimal to f64 to f32) which can be off by one f32 ulp for inputs
+// within about 2^-29 of an f32 halfway point, shortest f32 strings always come back exactly
+gb_inline f32 gb_str_to_f32(char const *str, char **end_ptr) {
+	f64 f = gb_str_to_f64(str, end_ptr);
+	f32 r = cast(f32)f;
+	return r;
 }
 
 
@@ -6337,6 +11468,7 @@ gbString gb_string_make_length(gbAllocator a, void const *init_str, isize num_by
 	header->allocator = a;
 	header->length    = num_bytes;
 	header->capacity  = num_bytes;
+	header->in_buffer = false;
 	if (num_bytes && init_str)
 		gb_memcopy(str, init_str, num_bytes);
 	str[num_bytes] = '\0';
@@ -6344,10 +11476,31 @@ gbString gb_string_make_length(gbAllocator a, void const *init_str, isize num_by
 	return str;
 }
 
+gbString gb_string_make_in_buffer(gbAllocator a, void *buffer, isize buffer_size, char const *str) {
+	isize len = str ? gb_strlen(str) : 0;
+	gbStringHeader *header = cast(gbStringHeader *)gb_align_forward(buffer, gb_align_of(gbStringHeader));
+	isize capacity = buffer_size - (cast(u8 *)(header+1) - cast(u8 *)buffer) - 1;
+	gbString s;
+
+	if (capacity < len)
+		return gb_string_make_length(a, str, len);
+
+	header->allocator = a;
+	header->length    = len;
+	header->capacity  = capacity;
+	header->in_buffer = true;
+	s = cast(gbString)(header+1);
+	if (len)
+		gb_memcopy(s, str, len);
+	s[len] = '\0';
+	return s;
+}
+
 gb_inline void gb_string_free(gbString str) {
 	if (str) {
 		gbStringHeader *header = GB_STRING_HEADER(str);
-		gb_free(header->allocator, header);
+		if (!header->in_buffer)
+			gb_free(header->allocator, header);
 	}
 
 }
@@ -6388,6 +11541,53 @@ gb_inline gbString gb_string_appendc(gbString str, char const *other) {
 	return gb_string_append_length(str, other, gb_strlen(other));
 }
 
+gbString gb_string_append_f64s(gbString str, f64 const *values, isize count, char const *separator) {
+	isize separator_len = separator ? gb_strlen(separator) : 0, i;
+	char *end;
+	if (count <= 0)
+		return str;
+
+	// NOTE(bill): One reservation for the worst case, then the digits are written in place
+	str = gb_string_make_space_for(str, count * (GB_FLOAT_STR_MAX + separator_len));
+	if (str == NULL)
+		return NULL;
+
+	end = str + gb_string_length(str);
+	for (i = 0; i < count; i++) {
+		if (i > 0 && separator_len) {
+			gb_memcopy(end, separator, separator_len);
+			end += separator_len;
+		}
+		end += gb_f64_to_str(values[i], end);
+	}
+	*end = '\0';
+	gb__set_string_length(str, end - str);
+	return str;
+}
+
+gbString gb_string_append_f32s(gbString str, f32 const *values, isize count, char const *separator) {
+	isize separator_len = separator ? gb_strlen(separator) : 0, i;
+	char *end;
+	if (count <= 0)
+		return str;
+
+	str = gb_string_make_space_for(str, count * (GB_FLOAT_STR_MAX + separator_len));
+	if (str == NULL)
+		return NULL;
+
+	end = str + gb_string_length(str);
+	for (i = 0; i < count; i++) {
+		if (i > 0 && separator_len) {
+			gb_memcopy(end, separator, separator_len);
+			end += separator_len;
+		}
+		end += gb_f32_to_str(values[i], end);
+	}
+	*end = '\0';
+	gb__set_string_length(str, end - str);
+	return str;
+}
+
 
 gbString gb_string_set(gbString str, char const *cstr) {
 	isize len = gb_strlen(cstr);
@@ -6406,33 +11606,49 @@ gbString gb_string_set(gbString str, char const *cstr) {
 
 
 
-gbString gb_string_make_space_for(gbString str, isize add_len) {
-	isize available = gb_string_available_space(str);
+gbString gb_string_reserve(gbString str, isize capacity) {
+	gbStringHeader *header = GB_STRING_HEADER(str);
 
-	// NOTE(bill): Return if there is enough space left
-	if (available >= add_len) {
+	if (header->capacity >= capacity) {
 		return str;
 	} else {
-		isize new_len, old_size, new_size;
-		void *ptr, *new_ptr;
-		gbAllocator a = GB_STRING_HEADER(str)->allocator;
-		gbStringHeader *header;
-
-		new_len = gb_string_length(str) + add_len;
-		ptr = GB_STRING_HEADER(str);
-		old_size = gb_size_of(gbStringHeader) + gb_string_length(str) + 1;
-		new_size = gb_size_of(gbStringHeader) + new_len + 1;
-
-		new_ptr = gb_resize(a, ptr, old_size, new_size);
-		if (new_ptr == NULL) return NULL;
+		isize old_size, new_size;
+		void *new_ptr;
+		gbAllocator a = header->allocator;
+
+		old_size = gb_size_of(gbStringHeader) + header->length + 1;
+		new_size = gb_size_of(gbStringHeader) + capacity + 1;
+
+		if (header->in_buffer) {
+			// NOTE(bill): Move out of the buffer into the allocator
+			new_ptr = gb_alloc(a, new_size);
+			if (new_ptr == NULL) return NULL;
+			gb_memcopy(new_ptr, header, old_size);
+		} else {
+			new_ptr = gb_resize(a, header, old_size, new_size);
+			if (new_ptr == NULL) return NULL;
+		}
 
 		header = cast(gbStringHeader *)new_ptr;
 		header->allocator = a;
+		header->capacity  = capacity;
+		header->in_buffer = false;
+
+		return cast(gbString)(header+1);
+	}
+}
 
-		str = cast(gbString)(header+1);
-		gb__set_string_capacity(str, new_len);
+gbString gb_string_make_space_for(gbString str, isize add_len) {
+	isize available = gb_string_available_space(str);
 
+	// NOTE(bill): Return if there is enough space left
+	if (available >= add_len) {
 		return str;
+	} else {
+		// NOTE(bill): Grow geometrically so a run of appends is amortized O(1) each
+		isize new_cap = GB_STRING_GROW_FORMULA(gb_string_capacity(str));
+		isize needed  = gb_string_length(str) + add_len;
+		return gb_string_reserve(str, gb_max(new_cap, needed));
 	}
 }
 
@@ -6485,114 +11701,81 @@ gb_inline gbString gb_string_trim_space(gbString str) { return gb_string_trim(st
 
 
 
+GB_TABLE_OA_DEFINE(gbStringInternTable, gb__string_intern_table_, isize);
+
+void gb_string_interner_init(gbStringInterner *si, gbAllocator a) {
+	si->allocator = a;
+	gb__string_intern_table_init(&si->table, a);
+	gb_array_init(si->strings, a);
+	gb_array_init(si->next,    a);
+}
+
+void gb_string_interner_destroy(gbStringInterner *si) {
+	isize i;
+	for (i = 0; i < gb_array_count(si->strings); i++)
+		gb_string_free(si->strings[i]);
+	gb_array_free(si->strings);
+	gb_array_free(si->next);
+	gb__string_intern_table_destroy(&si->table);
+}
+
+gb_inline gbString gb_string_intern(gbStringInterner *si, char const *str) {
+	return gb_string_intern_length(si, str, gb_strlen(str));
+}
+
+gbString gb_string_intern_length(gbStringInterner *si, void const *str, isize num_bytes) {
+	u64 key = gb_fnv64a(str, num_bytes);
+	isize *latest = gb__string_intern_table_get(&si->table, key);
+	isize prev = latest ? *latest : -1;
+	isize i;
+	gbString s;
+
+	for (i = prev; i >= 0; i = si->next[i]) {
+		s = si->strings[i];
+		if (gb_string_length(s) == num_bytes && gb_memcompare(s, str, num_bytes) == 0)
+			return s;
+	}
+
+	s = gb_string_make_length(si->allocator, str, num_bytes);
+	if (s == NULL)
+		return NULL;
+	gb_array_append(si->strings, s);
+	gb_array_append(si->next, prev);
+	gb__string_intern_table_set(&si->table, key, gb_array_count(si->strings)-1);
+	return s;
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////
 //
-// Windows UTF-8 Handling
+// UTF-8 Handling
 //
 //
 
 
 u16 *gb_utf8_to_ucs2(u16 *buffer, isize len, u8 const *str) {
-	Rune c;
-	isize i = 0;
-	len--;
-	while (*str) {
-		if (i >= len)
-			return NULL;
-		if (!(*str & 0x80)) {
-			buffer[i++] = *str++;
-		} else if ((*str & 0xe0) == 0xc0) {
-			if (*str < 0xc2)
-				return NULL;
-			c = (*str++ & 0x1f) << 6;
-			if ((*str & 0xc0) != 0x80)
-				return NULL;
-			buffer[i++] = cast(u16)(c + (*str++ & 0x3f));
-		} else if ((*str & 0xf0) == 0xe0) {
-			if (*str == 0xe0 &&
-			    (str[1] < 0xa0 || str[1] > 0xbf))
-				return NULL;
-			if (*str == 0xed && str[1] > 0x9f) // str[1] < 0x80 is checked below
-				return NULL;
-			c = (*str++ & 0x0f) << 12;
-			if ((*str & 0xc0) != 0x80)
-				return NULL;
-			c += (*str++ & 0x3f) << 6;
-			if ((*str & 0xc0) != 0x80)
-				return NULL;
-			buffer[i++] = cast(u16)(c + (*str++ & 0x3f));
-		} else if ((*str & 0xf8) == 0xf0) {
-			if (*str > 0xf4)
-				return NULL;
-			if (*str == 0xf0 && (str[1] < 0x90 || str[1] > 0xbf))
-				return NULL;
-			if (*str == 0xf4 && str[1] > 0x8f) // str[1] < 0x80 is checked below
-				return NULL;
-			c = (*str++ & 0x07) << 18;
-			if ((*str & 0xc0) != 0x80)
-				return NULL;
-			c += (*str++ & 0x3f) << 12;
-			if ((*str & 0xc0) != 0x80)
-				return NULL;
-			c += (*str++ & 0x3f) << 6;
-			if ((*str & 0xc0) != 0x80)
-				return NULL;
-			c += (*str++ & 0x3f);
-			// UTF-8 encodings of values used in surrogate pairs are invalid
-			if ((c & 0xfffff800) == 0xd800)
-				return NULL;
-			if (c >= 0x10000) {
-				c -= 0x10000;
-				if (i+2 > len)
-					return NULL;
-				buffer[i++] = 0xd800 | (0x3ff & (c>>10));
-				buffer[i++] = 0xdc00 | (0x3ff & (c    ));
-			}
-		} else {
-			return NULL;
-		}
-	}
-	buffer[i] = 0;
+	isize n;
+	if (len <= 0)
+		return NULL;
+	n = gb_utf8_to_utf16(buffer, len-1, str, gb_strlen(cast(char const *)str), NULL);
+	if (n < 0)
+		return NULL;
+	buffer[n] = 0;
 	return buffer;
 }
 
 u8 *gb_ucs2_to_utf8(u8 *buffer, isize len, u16 const *str) {
-	isize i = 0;
-	len--;
-	while (*str) {
-		if (*str < 0x80) {
-			if (i+1 > len)
-				return NULL;
-			buffer[i++] = (char) *str++;
-		} else if (*str < 0x800) {
-			if (i+2 > len)
-				return NULL;
-			buffer[i++] = cast(char)(0xc0 + (*str >> 6));
-			buffer[i++] = cast(char)(0x80 + (*str & 0x3f));
-			str += 1;
-		} else if (*str >= 0xd800 && *str < 0xdc00) {
-			Rune c;
-			if (i+4 > len)
-				return NULL;
-			c = ((str[0] - 0xd800) << 10) + ((str[1]) - 0xdc00) + 0x10000;
-			buffer[i++] = cast(char)(0xf0 +  (c >> 18));
-			buffer[i++] = cast(char)(0x80 + ((c >> 12) & 0x3f));
-			buffer[i++] = cast(char)(0x80 + ((c >>  6) & 0x3f));
-			buffer[i++] = cast(char)(0x80 + ((c      ) & 0x3f));
-			str += 2;
-		} else if (*str >= 0xdc00 && *str < 0xe000) {
-			return NULL;
-		} else {
-			if (i+3 > len)
-				return NULL;
-			buffer[i++] = 0xe0 +  (*str >> 12);
-			buffer[i++] = 0x80 + ((*str >>  6) & 0x3f);
-			buffer[i++] = 0x80 + ((*str      ) & 0x3f);
-			str += 1;
-		}
-	}
-	buffer[i] = 0;
+	isize n, str_len = 0;
+	if (len <= 0)
+		return NULL;
+	while (str[str_len])
+		str_len++;
+	n = gb_utf16_to_utf8(buffer, len-1, str, str_len, NULL);
+	if (n < 0)
+		return NULL;
+	buffer[n] = 0;
 	return buffer;
 }
 
@@ -6653,8 +11836,7 @@ isize gb_utf8_decode(u8 const *str, isize str_len, Rune *codepoint_out) {
 		u8 b1, b2, b3;
 		gbUtf8AcceptRange accept;
 		if (x > 0xf0) {
-			Rune mask = (cast(Rune)x >> 31) << 31;
-			codepoint = (cast(Rune)s0 & (~mask)) | (GB_RUNE_INVALID & mask);
+			codepoint = GB_RUNE_INVALID;
 			width = 1;
 			goto end;
 		}
@@ -6666,7 +11848,7 @@ isize gb_utf8_decode(u8 const *str, isize str_len, Rune *codepoint_out) {
 
 		sz = x&7;
 		accept = gb__utf8_accept_ranges[x>>4];
-		if (str_len < gb_size_of(sz))
+		if (str_len < sz)
 			goto invalid_codepoint;
 
 		b1 = str[1];
@@ -6684,7 +11866,7 @@ isize gb_utf8_decode(u8 const *str, isize str_len, Rune *codepoint_out) {
 			goto invalid_codepoint;
 
 		if (sz == 3) {
-			codepoint = (cast(Rune)s0&0x1f)<<12 | (cast(Rune)b1&0x3f)<<6 | (cast(Rune)b2&0x3f);
+			codepoint = (cast(Rune)s0&0x0f)<<12 | (cast(Rune)b1&0x3f)<<6 | (cast(Rune)b2&0x3f);
 			width = 3;
 			goto end;
 		}
@@ -6713,45 +11895,484 @@ isize gb_utf8_codepoint_size(u8 const *str, isize str_len) {
 		if ((str[i] & 0xc0) != 0x80)
 			break;
 	}
-	return i+1;
+	return i+1;
+}
+
+isize gb_utf8_encode_rune(u8 buf[4], Rune r) {
+	u32 i = cast(u32)r;
+	u8 mask = 0x3f;
+	if (i <= (1<<7)-1) {
+		buf[0] = cast(u8)r;
+		return 1;
+	}
+	if (i <= (1<<11)-1) {
+		buf[0] = 0xc0 | cast(u8)(r>>6);
+		buf[1] = 0x80 | (cast(u8)(r)&mask);
+		return 2;
+	}
+
+	// Invalid or Surrogate range
+	if (i > GB_RUNE_MAX ||
+	    gb_is_between(i, 0xd800, 0xdfff)) {
+		r = GB_RUNE_INVALID;
+
+		buf[0] = 0xe0 | cast(u8)(r>>12);
+		buf[1] = 0x80 | (cast(u8)(r>>6)&mask);
+		buf[2] = 0x80 | (cast(u8)(r)&mask);
+		return 3;
+	}
+
+	if (i <= (1<<16)-1) {
+		buf[0] = 0xe0 | cast(u8)(r>>12);
+		buf[1] = 0x80 | (cast(u8)(r>>6)&mask);
+		buf[2] = 0x80 | (cast(u8)(r)&mask);
+		return 3;
+	}
+
+	buf[0] = 0xf0 | cast(u8)(r>>18);
+	buf[1] = 0x80 | (cast(u8)(r>>12)&mask);
+	buf[2] = 0x80 | (cast(u8)(r>>6)&mask);
+	buf[3] = 0x80 | (cast(u8)(r)&mask);
+	return 4;
+}
+
+
+// NOTE(bill): Size of the valid sequence at the start of `str`, 0 if it is invalid or cut short
+gb_internal gb_inline isize gb__utf8_sequence_size(u8 const *str, isize len) {
+	u8 x = gb__utf8_first[str[0]];
+	isize sz;
+	gbUtf8AcceptRange accept;
+	if (x == 0xf0) return 1;
+	if (x == 0xf1) return 0;
+	sz = x&7;
+	if (len < sz) return 0;
+	accept = gb__utf8_accept_ranges[x>>4];
+	if (str[1] < accept.lo || accept.hi < str[1]) return 0;
+	if (sz > 2 && (str[2] & 0xc0) != 0x80) return 0;
+	if (sz > 3 && (str[3] & 0xc0) != 0x80) return 0;
+	return sz;
+}
+
+// NOTE(bill): `start` must be the start of a sequence
+gb_internal isize gb__utf8_validate_scalar(u8 const *str, isize start, isize len) {
+	isize i = start;
+	while (i < len) {
+		isize sz;
+		if (str[i] < 0x80) {
+		#if defined(GB_SIMD_SSE2)
+			while (i+16 <= len && _mm_movemask_epi8(_mm_loadu_si128(cast(__m128i const *)(str+i))) == 0)
+				i += 16;
+		#else
+			while (i+8 <= len) {
+				u64 w;
+				gb_memcopy(&w, str+i, 8);
+				if (w & 0x8080808080808080ull)
+					break;
+				i += 8;
+			}
+		#endif
+			if (i >= len)
+				break;
+		}
+		sz = gb__utf8_sequence_size(str+i, len-i);
+		if (sz == 0)
+			return i;
+		i += sz;
+	}
+	return len;
+}
+
+#if defined(GB_SIMD_AVX2) || defined(GB_SIMD_NEON)
+// NOTE(bill): Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"
+// Every byte pair is classified by the high and low nibble of the first byte and the high nibble of
+// the second, it is an error when a bit is set in all three. Only the 3rd and 4th bytes of a sequence
+// need the bytes further back, which is done by `must23`
+#define GB__UTF8_TOO_SHORT  0x01 // 11______ 0_______ and 11______ 11______
+#define GB__UTF8_TOO_LONG   0x02 // 0_______ 10______
+#define GB__UTF8_OVERLONG_3 0x04 // 11100000 100_____
+#define GB__UTF8_TOO_LARGE  0x08 // 11110100 1001____, 11110100 101_____, 11110101+ 1001____ etc.
+#define GB__UTF8_SURROGATE  0x10 // 11101101 101_____
+#define GB__UTF8_OVERLONG_2 0x20 // 1100000_ 10______
+#define GB__UTF8_TOO_LARGE2 0x40 // 11110101+ 1000____ and OVERLONG_4, 11110000 1000____
+#define GB__UTF8_TWO_CONTS  0x80 // 10______ 10______
+#define GB__UTF8_CARRY (GB__UTF8_TOO_SHORT | GB__UTF8_TOO_LONG | GB__UTF8_TWO_CONTS)
+
+gb_global u8 const gb__utf8_lookup_byte1_high[16] = {
+	GB__UTF8_TOO_LONG, GB__UTF8_TOO_LONG, GB__UTF8_TOO_LONG, GB__UTF8_TOO_LONG,
+	GB__UTF8_TOO_LONG, GB__UTF8_TOO_LONG, GB__UTF8_TOO_LONG, GB__UTF8_TOO_LONG,
+	GB__UTF8_TWO_CONTS, GB__UTF8_TWO_CONTS, GB__UTF8_TWO_CONTS, GB__UTF8_TWO_CONTS,
+	GB__UTF8_TOO_SHORT | GB__UTF8_OVERLONG_2,
+	GB__UTF8_TOO_SHORT,
+	GB__UTF8_TOO_SHORT | GB__UTF8_OVERLONG_3 | GB__UTF8_SURROGATE,
+	GB__UTF8_TOO_SHORT | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+};
+gb_global u8 const gb__utf8_lookup_byte1_low[16] = {
+	GB__UTF8_CARRY | GB__UTF8_OVERLONG_3 | GB__UTF8_OVERLONG_2 | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_OVERLONG_2,
+	GB__UTF8_CARRY,
+	GB__UTF8_CARRY,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2 | GB__UTF8_SURROGATE,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_CARRY | GB__UTF8_TOO_LARGE | GB__UTF8_TOO_LARGE2,
+};
+gb_global u8 const gb__utf8_lookup_byte2_high[16] = {
+	GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT,
+	GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT,
+	GB__UTF8_TOO_LONG | GB__UTF8_OVERLONG_2 | GB__UTF8_TWO_CONTS | GB__UTF8_OVERLONG_3 | GB__UTF8_TOO_LARGE2,
+	GB__UTF8_TOO_LONG | GB__UTF8_OVERLONG_2 | GB__UTF8_TWO_CONTS | GB__UTF8_OVERLONG_3 | GB__UTF8_TOO_LARGE,
+	GB__UTF8_TOO_LONG | GB__UTF8_OVERLONG_2 | GB__UTF8_TWO_CONTS | GB__UTF8_SURROGATE  | GB__UTF8_TOO_LARGE,
+	GB__UTF8_TOO_LONG | GB__UTF8_OVERLONG_2 | GB__UTF8_TWO_CONTS | GB__UTF8_SURROGATE  | GB__UTF8_TOO_LARGE,
+	GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT, GB__UTF8_TOO_SHORT,
+};
+// NOTE(bill): Saturating subtract from the end of a block, non zero if a sequence is still open
+gb_global u8 const gb__utf8_incomplete_max[32] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0-1, 0xe0-1, 0xc0-1,
+};
+
+// NOTE(bill): The blocks are only checked as a whole, everything before `i` is valid but a sequence
+// may still be open at `i`. Back up to its lead byte and find the exact position of the error
+gb_internal isize gb__utf8_validate_finish(u8 const *str, isize i, isize len) {
+	isize start = i, k;
+	for (k = 1; k <= 3 && i-k >= 0; k++) {
+		u8 c = str[i-k];
+		if (c < 0x80)
+			break;
+		if (c >= 0xc0) {
+			start = i-k;
+			break;
+		}
+	}
+	return gb__utf8_validate_scalar(str, start, len);
+}
+#endif
+
+#if defined(GB_SIMD_AVX2) // NOTE(bill): i.e. the compiler supports target specific procedures
+#if defined(GB_COMPILER_MSVC)
+	#define GB__TARGET_SSE41
+#else
+	#define GB__TARGET_SSE41 __attribute__((target("ssse3,sse4.1")))
+#endif
+
+GB__TARGET_SSE41 gb_internal isize gb__utf8_validate_sse41(u8 const *str, isize len) {
+	__m128i const byte1_high     = _mm_loadu_si128(cast(__m128i const *)gb__utf8_lookup_byte1_high);
+	__m128i const byte1_low      = _mm_loadu_si128(cast(__m128i const *)gb__utf8_lookup_byte1_low);
+	__m128i const byte2_high     = _mm_loadu_si128(cast(__m128i const *)gb__utf8_lookup_byte2_high);
+	__m128i const incomplete_max = _mm_loadu_si128(cast(__m128i const *)(gb__utf8_incomplete_max+16));
+	__m128i const nibble         = _mm_set1_epi8(0x0f);
+	__m128i prev       = _mm_setzero_si128();
+	__m128i incomplete = _mm_setzero_si128();
+	isize i = 0;
+	for (; i+16 <= len; i += 16) {
+		__m128i in = _mm_loadu_si128(cast(__m128i const *)(str+i));
+		__m128i prev1, prev2, prev3, special, must23, error;
+		if (_mm_movemask_epi8(in) == 0) {
+			// NOTE(bill): ASCII, only a sequence left open by the previous block can be wrong
+			if (!_mm_testz_si128(incomplete, incomplete))
+				break;
+			prev = in;
+			continue;
+		}
+		prev1 = _mm_alignr_epi8(in, prev, 15);
+		prev2 = _mm_alignr_epi8(in, prev, 14);
+		prev3 = _mm_alignr_epi8(in, prev, 13);
+		special = _mm_and_si128(_mm_and_si128(_mm_shuffle_epi8(byte1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+		                                      _mm_shuffle_epi8(byte1_low,  _mm_and_si128(prev1, nibble))),
+		                        _mm_shuffle_epi8(byte2_high, _mm_and_si128(_mm_srli_epi16(in, 4), nibble)));
+		must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xe0-0x80)),
+		                      _mm_subs_epu8(prev3, _mm_set1_epi8(0xf0-0x80)));
+		error = _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8(cast(char)0x80)), special);
+		if (!_mm_testz_si128(error, error))
+			break;
+		incomplete = _mm_subs_epu8(in, incomplete_max);
+		prev = in;
+	}
+	return gb__utf8_validate_finish(str, i, len);
+}
+
+GB__TARGET_AVX2 gb_internal isize gb__utf8_validate_avx2(u8 const *str, isize len) {
+	__m256i const byte1_high     = _mm256_broadcastsi128_si256(_mm_loadu_si128(cast(__m128i const *)gb__utf8_lookup_byte1_high));
+	__m256i const byte1_low      = _mm256_broadcastsi128_si256(_mm_loadu_si128(cast(__m128i const *)gb__utf8_lookup_byte1_low));
+	__m256i const byte2_high     = _mm256_broadcastsi128_si256(_mm_loadu_si128(cast(__m128i const *)gb__utf8_lookup_byte2_high));
+	__m256i const incomplete_max = _mm256_loadu_si256(cast(__m256i const *)gb__utf8_incomplete_max);
+	__m256i const nibble         = _mm256_set1_epi8(0x0f);
+	__m256i prev       = _mm256_setzero_si256();
+	__m256i incomplete = _mm256_setzero_si256();
+	isize i = 0;
+	for (; i+32 <= len; i += 32) {
+		__m256i in = _mm256_loadu_si256(cast(__m256i const *)(str+i));
+		__m256i shifted, prev1, prev2, prev3, special, must23, error;
+		if (_mm256_movemask_epi8(in) == 0) {
+			if (!_mm256_testz_si256(incomplete, incomplete))
+				break;
+			prev = in;
+			continue;
+		}
+		// NOTE(bill): alignr works per 128 bit lane so the lower lane needs the top of `prev`
+		shifted = _mm256_permute2x128_si256(prev, in, 0x21);
+		prev1 = _mm256_alignr_epi8(in, shifted, 15);
+		prev2 = _mm256_alignr_epi8(in, shifted, 14);
+		prev3 = _mm256_alignr_epi8(in, shifted, 13);
+		special = _mm256_and_si256(_mm256_and_si256(_mm256_shuffle_epi8(byte1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+		                                            _mm256_shuffle_epi8(byte1_low,  _mm256_and_si256(prev1, nibble))),
+		                           _mm256_shuffle_epi8(byte2_high, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble)));
+		must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0-0x80)),
+		                         _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0-0x80)));
+		error = _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8(cast(char)0x80)), special);
+		if (!_mm256_testz_si256(error, error))
+			break;
+		incomplete = _mm256_subs_epu8(in, incomplete_max);
+		prev = in;
+	}
+	return gb__utf8_validate_finish(str, i, len);
+}
+
+gb_internal isize gb__utf8_validate_sse2(u8 const *str, isize len) {
+	return gb__utf8_validate_scalar(str, 0, len);
+}
+
+// NOTE(bill): Picked on the first call like the memory kernels
+typedef isize gbprivUtf8ValidateProc(u8 const *str, isize len);
+gb_internal isize gb__utf8_validate_resolve(u8 const *str, isize len);
+gb_global gbprivUtf8ValidateProc *gb__utf8_validate_proc = gb__utf8_validate_resolve;
+
+gb_internal isize gb__utf8_validate_resolve(u8 const *str, isize len) {
+	u32 const sse41 = gbCpuFeature_SSSE3 | gbCpuFeature_SSE41;
+	u32 features = gb_cpu_features();
+	if (features & gbCpuFeature_AVX2)
+		gb__utf8_validate_proc = gb__utf8_validate_avx2;
+	else if ((features & sse41) == sse41)
+		gb__utf8_validate_proc = gb__utf8_validate_sse41;
+	else
+		gb__utf8_validate_proc = gb__utf8_validate_sse2;
+	return gb__utf8_validate_proc(str, len);
+}
+
+#elif defined(GB_SIMD_NEON)
+gb_internal isize gb__utf8_validate_neon(u8 const *str, isize len) {
+	uint8x16_t const byte1_high     = vld1q_u8(gb__utf8_lookup_byte1_high);
+	uint8x16_t const byte1_low      = vld1q_u8(gb__utf8_lookup_byte1_low);
+	uint8x16_t const byte2_high     = vld1q_u8(gb__utf8_lookup_byte2_high);
+	uint8x16_t const incomplete_max = vld1q_u8(gb__utf8_incomplete_max+16);
+	uint8x16_t const nibble         = vdupq_n_u8(0x0f);
+	uint8x16_t prev       = vdupq_n_u8(0);
+	uint8x16_t incomplete = vdupq_n_u8(0);
+	isize i = 0;
+	for (; i+16 <= len; i += 16) {
+		uint8x16_t in = vld1q_u8(str+i);
+		uint8x16_t prev1, prev2, prev3, special, must23, error;
+		if (vmaxvq_u8(in) < 0x80) {
+			if (vmaxvq_u8(incomplete) != 0)
+				break;
+			prev = in;
+			continue;
+		}
+		prev1 = vextq_u8(prev, in, 15);
+		prev2 = vextq_u8(prev, in, 14);
+		prev3 = vextq_u8(prev, in, 13);
+		special = vandq_u8(vandq_u8(vqtbl1q_u8(byte1_high, vshrq_n_u8(prev1, 4)),
+		                            vqtbl1q_u8(byte1_low,  vandq_u8(prev1, nibble))),
+		                   vqtbl1q_u8(byte2_high, vshrq_n_u8(in, 4)));
+		must23 = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xe0-0x80)),
+		                  vqsubq_u8(prev3, vdupq_n_u8(0xf0-0x80)));
+		error = veorq_u8(vandq_u8(must23, vdupq_n_u8(0x80)), special);
+		if (vmaxvq_u8(error) != 0)
+			break;
+		incomplete = vqsubq_u8(in, incomplete_max);
+		prev = in;
+	}
+	return gb__utf8_validate_finish(str, i, len);
 }
+#endif
 
-isize gb_utf8_encode_rune(u8 buf[4], Rune r) {
-	u32 i = cast(u32)r;
-	u8 mask = 0x3f;
-	if (i <= (1<<7)-1) {
-		buf[0] = cast(u8)r;
-		return 1;
+isize gb_utf8_validate(u8 const *str, isize len) {
+#if defined(GB_SIMD_AVX2)
+	return gb__utf8_validate_proc(str, len);
+#elif defined(GB_SIMD_NEON)
+	return gb__utf8_validate_neon(str, len);
+#else
+	return gb__utf8_validate_scalar(str, 0, len);
+#endif
+}
+
+isize gb_utf8_count(u8 const *str, isize len) {
+	isize count = 0, i = 0;
+	// NOTE(bill): Counts the bytes which are not continuation bytes, 0x80-0xbf is -128..-65 as signed.
+	// The byte counters are summed every 255 blocks before they can wrap
+#if defined(GB_SIMD_SSE2)
+	__m128i const cont = _mm_set1_epi8(-65);
+	__m128i const zero = _mm_setzero_si128();
+	while (i+16 <= len) {
+		__m128i acc = zero, sum;
+		isize end = i + gb_min(len-i, 255*16);
+		for (; i+16 <= end; i += 16)
+			acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(_mm_loadu_si128(cast(__m128i const *)(str+i)), cont));
+		sum = _mm_sad_epu8(acc, zero);
+		count += _mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4);
 	}
-	if (i <= (1<<11)-1) {
-		buf[0] = 0xc0 | cast(u8)(r>>6);
-		buf[1] = 0x80 | (cast(u8)(r)&mask);
-		return 2;
+#elif defined(GB_SIMD_NEON)
+	int8x16_t const cont = vdupq_n_s8(-65);
+	while (i+16 <= len) {
+		uint8x16_t acc = vdupq_n_u8(0);
+		isize end = i + gb_min(len-i, 255*16);
+		for (; i+16 <= end; i += 16)
+			acc = vsubq_u8(acc, vcgtq_s8(vreinterpretq_s8_u8(vld1q_u8(str+i)), cont));
+		count += vaddlvq_u8(acc);
 	}
+#endif
+	for (; i < len; i++)
+		count += (str[i] & 0xc0) != 0x80;
+	return count;
+}
 
-	// Invalid or Surrogate range
-	if (i > GB_RUNE_MAX ||
-	    gb_is_between(i, 0xd800, 0xdfff)) {
-		r = GB_RUNE_INVALID;
+isize gb_utf8_to_utf16(u16 *out, isize out_len, u8 const *str, isize len, isize *error_offset) {
+	isize i = 0, n = 0;
+	while (i < len) {
+		u8 const *s = str+i;
+		Rune r;
+		isize sz;
+		if (s[0] < 0x80) {
+			// NOTE(bill): ASCII is zero extended 16 bytes at a time
+		#if defined(GB_SIMD_SSE2)
+			__m128i const zero = _mm_setzero_si128();
+			while (i+16 <= len && n+16 <= out_len) {
+				__m128i v = _mm_loadu_si128(cast(__m128i const *)(str+i));
+				if (_mm_movemask_epi8(v) != 0)
+					break;
+				_mm_storeu_si128(cast(__m128i *)(out+n),   _mm_unpacklo_epi8(v, zero));
+				_mm_storeu_si128(cast(__m128i *)(out+n+8), _mm_unpackhi_epi8(v, zero));
+				i += 16, n += 16;
+			}
+		#elif defined(GB_SIMD_NEON)
+			while (i+16 <= len && n+16 <= out_len) {
+				uint8x16_t v = vld1q_u8(str+i);
+				if (vmaxvq_u8(v) >= 0x80)
+					break;
+				vst1q_u16(out+n,   vmovl_u8(vget_low_u8(v)));
+				vst1q_u16(out+n+8, vmovl_high_u8(v));
+				i += 16, n += 16;
+			}
+		#endif
+			if (i >= len)
+				break;
+			s = str+i;
+			if (s[0] < 0x80) {
+				if (n >= out_len)
+					goto error;
+				out[n++] = s[0];
+				i++;
+				continue;
+			}
+		}
 
-		buf[0] = 0xe0 | cast(u8)(r>>12);
-		buf[1] = 0x80 | (cast(u8)(r>>6)&mask);
-		buf[2] = 0x80 | (cast(u8)(r)&mask);
-		return 3;
+		sz = gb__utf8_sequence_size(s, len-i);
+		switch (sz) {
+		case 2:  r = (cast(Rune)s[0]&0x1f)<<6  | (cast(Rune)s[1]&0x3f); break;
+		case 3:  r = (cast(Rune)s[0]&0x0f)<<12 | (cast(Rune)s[1]&0x3f)<<6  | (cast(Rune)s[2]&0x3f); break;
+		case 4:  r = (cast(Rune)s[0]&0x07)<<18 | (cast(Rune)s[1]&0x3f)<<12 | (cast(Rune)s[2]&0x3f)<<6 | (cast(Rune)s[3]&0x3f); break;
+		default: goto error;
+		}
+
+		if (r >= 0x10000) {
+			if (n+2 > out_len)
+				goto error;
+			r -= 0x10000;
+			out[n++] = cast(u16)(0xd800 | (r >> 10));
+			out[n++] = cast(u16)(0xdc00 | (r & 0x3ff));
+		} else {
+			if (n >= out_len)
+				goto error;
+			out[n++] = cast(u16)r;
+		}
+		i += sz;
 	}
+	return n;
 
-	if (i <= (1<<16)-1) {
-		buf[0] = 0xe0 | cast(u8)(r>>12);
-		buf[1] = 0x80 | (cast(u8)(r>>6)&mask);
-		buf[2] = 0x80 | (cast(u8)(r)&mask);
-		return 3;
+error:
+	if (error_offset) *error_offset = i;
+	return -1;
+}
+
+isize gb_utf16_to_utf8(u8 *out, isize out_len, u16 const *str, isize len, isize *error_offset) {
+	isize i = 0, n = 0;
+	while (i < len) {
+		u16 c = str[i];
+		if (c < 0x80) {
+			// NOTE(bill): ASCII is narrowed 16 code units at a time
+		#if defined(GB_SIMD_SSE2)
+			__m128i const high = _mm_set1_epi16(cast(i16)0xff80);
+			__m128i const zero = _mm_setzero_si128();
+			while (i+16 <= len && n+16 <= out_len) {
+				__m128i a = _mm_loadu_si128(cast(__m128i const *)(str+i));
+				__m128i b = _mm_loadu_si128(cast(__m128i const *)(str+i+8));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), high), zero)) != 0xffff)
+					break;
+				_mm_storeu_si128(cast(__m128i *)(out+n), _mm_packus_epi16(a, b));
+				i += 16, n += 16;
+			}
+		#elif defined(GB_SIMD_NEON)
+			while (i+16 <= len && n+16 <= out_len) {
+				uint16x8_t a = vld1q_u16(str+i);
+				uint16x8_t b = vld1q_u16(str+i+8);
+				if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80)
+					break;
+				vst1q_u8(out+n, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+				i += 16, n += 16;
+			}
+		#endif
+			if (i >= len)
+				break;
+			c = str[i];
+		}
+
+		if (c < 0x80) {
+			if (n+1 > out_len)
+				goto error;
+			out[n++] = cast(u8)c;
+			i += 1;
+		} else if (c < 0x800) {
+			if (n+2 > out_len)
+				goto error;
+			out[n++] = cast(u8)(0xc0 | (c >> 6));
+			out[n++] = cast(u8)(0x80 | (c & 0x3f));
+			i += 1;
+		} else if (gb_is_between(c, 0xd800, 0xdbff)) {
+			Rune r;
+			if (i+1 >= len || !gb_is_between(str[i+1], 0xdc00, 0xdfff))
+				goto error;
+			if (n+4 > out_len)
+				goto error;
+			r = ((cast(Rune)c - 0xd800) << 10) + (cast(Rune)str[i+1] - 0xdc00) + 0x10000;
+			out[n++] = cast(u8)(0xf0 |  (r >> 18));
+			out[n++] = cast(u8)(0x80 | ((r >> 12) & 0x3f));
+			out[n++] = cast(u8)(0x80 | ((r >>  6) & 0x3f));
+			out[n++] = cast(u8)(0x80 | ( r        & 0x3f));
+			i += 2;
+		} else if (gb_is_between(c, 0xdc00, 0xdfff)) {
+			goto error;
+		} else {
+			if (n+3 > out_len)
+				goto error;
+			out[n++] = cast(u8)(0xe0 |  (c >> 12));
+			out[n++] = cast(u8)(0x80 | ((c >>  6) & 0x3f));
+			out[n++] = cast(u8)(0x80 | ( c        & 0x3f));
+			i += 1;
+		}
 	}
+	return n;
 
-	buf[0] = 0xf0 | cast(u8)(r>>18);
-	buf[1] = 0x80 | (cast(u8)(r>>12)&mask);
-	buf[2] = 0x80 | (cast(u8)(r>>6)&mask);
-	buf[3] = 0x80 | (cast(u8)(r)&mask);
-	return 4;
+error:
+	if (error_offset) *error_offset = i;
+	return -1;
 }
 
 
@@ -6801,9 +12422,11 @@ gb_no_inline void *gb__array_set_capacity(void *array, isize capacity, isize ele
 //
 //
 
-u32 gb_adler32(void const *data, isize len) {
+gb_inline void gb_adler32_init(gbAdler32 *s) { s->a = 1; s->b = 0; }
+
+void gb_adler32_update(gbAdler32 *s, void const *data, isize len) {
 	u32 const MOD_ALDER = 65521;
-	u32 a = 1, b = 0;
+	u32 a = s->a, b = s->b;
 	isize i, block_len;
 	u8 const *bytes = cast(u8 const *)data;
 
@@ -6830,7 +12453,16 @@ u32 gb_adler32(void const *data, isize len) {
 		block_len = 5552;
 	}
 
-	return (b << 16) | a;
+	s->a = a, s->b = b;
+}
+
+gb_inline u32 gb_adler32_final(gbAdler32 *s) { return (s->b << 16) | s->a; }
+
+u32 gb_adler32(void const *data, isize len) {
+	gbAdler32 s;
+	gb_adler32_init(&s);
+	gb_adler32_update(&s, data, len);
+	return gb_adler32_final(&s);
 }
 
 
@@ -6968,66 +12600,1084 @@ gb_global u64 const GB__CRC64_TABLE[256] = {
 	0x5dedc41a34bbeeb2ull, 0x1f1d25f19d51d821ull, 0xd80c07cd676f8394ull, 0x9afce626ce85b507ull,
 };
 
-u32 gb_crc32(void const *data, isize len) {
-	isize remaining;
-	u32 result = ~(cast(u32)0);
+// NOTE(bill): Slicing-by-8 tables, [0] is the byte-wise table and [k] is [k-1] advanced by another zero byte
+gb_global u32 const gb__crc32_slices[8][256] = {
+	{
+		0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
+		0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
+		0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+		0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
+		0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172, 0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
+		0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+		0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
+		0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924, 0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
+		0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+		0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
+		0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
+		0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+		0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
+		0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0, 0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
+		0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+		0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
+		0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
+		0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+		0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
+		0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
+		0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+		0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
+		0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236, 0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
+		0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+		0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
+		0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
+		0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+		0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
+		0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
+		0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+		0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
+		0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d,
+	},
+	{
+		0x00000000, 0x191b3141, 0x32366282, 0x2b2d53c3, 0x646cc504, 0x7d77f445, 0x565aa786, 0x4f4196c7,
+		0xc8d98a08, 0xd1c2bb49, 0xfaefe88a, 0xe3f4d9cb, 0xacb54f0c, 0xb5ae7e4d, 0x9e832d8e, 0x87981ccf,
+		0x4ac21251, 0x53d92310, 0x78f470d3, 0x61ef4192, 0x2eaed755, 0x37b5e614, 0x1c98b5d7, 0x05838496,
+		0x821b9859, 0x9b00a918, 0xb02dfadb, 0xa936cb9a, 0xe6775d5d, 0xff6c6c1c, 0xd4413fdf, 0xcd5a0e9e,
+		0x958424a2, 0x8c9f15e3, 0xa7b24620, 0xbea97761, 0xf1e8e1a6, 0xe8f3d0e7, 0xc3de8324, 0xdac5b265,
+		0x5d5daeaa, 0x44469feb, 0x6f6bcc28, 0x7670fd69, 0x39316bae, 0x202a5aef, 0x0b07092c, 0x121c386d,
+		0xdf4636f3, 0xc65d07b2, 0xed705471, 0xf46b6530, 0xbb2af3f7, 0xa231c2b6, 0x891c9175, 0x9007a034,
+		0x179fbcfb, 0x0e848dba, 0x25a9de79, 0x3cb2ef38, 0x73f379ff, 0x6ae848be, 0x41c51b7d, 0x58de2a3c,
+		0xf0794f05, 0xe9627e44, 0xc24f2d87, 0xdb541cc6, 0x94158a01, 0x8d0ebb40, 0xa623e883, 0xbf38d9c2,
+		0x38a0c50d, 0x21bbf44c, 0x0a96a78f, 0x138d96ce, 0x5ccc0009, 0x45d73148, 0x6efa628b, 0x77e153ca,
+		0xbabb5d54, 0xa3a06c15, 0x888d3fd6, 0x91960e97, 0xded79850, 0xc7cca911, 0xece1fad2, 0xf5facb93,
+		0x7262d75c, 0x6b79e61d, 0x4054b5de, 0x594f849f, 0x160e1258, 0x0f152319, 0x243870da, 0x3d23419b,
+		0x65fd6ba7, 0x7ce65ae6, 0x57cb0925, 0x4ed03864, 0x0191aea3, 0x188a9fe2, 0x33a7cc21, 0x2abcfd60,
+		0xad24e1af, 0xb43fd0ee, 0x9f12832d, 0x8609b26c, 0xc94824ab, 0xd05315ea, 0xfb7e4629, 0xe2657768,
+		0x2f3f79f6, 0x362448b7, 0x1d091b74, 0x04122a35, 0x4b53bcf2, 0x52488db3, 0x7965de70, 0x607eef31,
+		0xe7e6f3fe, 0xfefdc2bf, 0xd5d0917c, 0xcccba03d, 0x838a36fa, 0x9a9107bb, 0xb1bc5478, 0xa8a76539,
+		0x3b83984b, 0x2298a90a, 0x09b5fac9, 0x10aecb88, 0x5fef5d4f, 0x46f46c0e, 0x6dd93fcd, 0x74c20e8c,
+		0xf35a1243, 0xea412302, 0xc16c70c1, 0xd8774180, 0x9736d747, 0x8e2de606, 0xa500b5c5, 0xbc1b8484,
+		0x71418a1a, 0x685abb5b, 0x4377e898, 0x5a6cd9d9, 0x152d4f1e, 0x0c367e5f, 0x271b2d9c, 0x3e001cdd,
+		0xb9980012, 0xa0833153, 0x8bae6290, 0x92b553d1, 0xddf4c516, 0xc4eff457, 0xefc2a794, 0xf6d996d5,
+		0xae07bce9, 0xb71c8da8, 0x9c31de6b, 0x852aef2a, 0xca6b79ed, 0xd37048ac, 0xf85d1b6f, 0xe1462a2e,
+		0x66de36e1, 0x7fc507a0, 0x54e85463, 0x4df36522, 0x02b2f3e5, 0x1ba9c2a4, 0x30849167, 0x299fa026,
+		0xe4c5aeb8, 0xfdde9ff9, 0xd6f3cc3a, 0xcfe8fd7b, 0x80a96bbc, 0x99b25afd, 0xb29f093e, 0xab84387f,
+		0x2c1c24b0, 0x350715f1, 0x1e2a4632, 0x07317773, 0x4870e1b4, 0x516bd0f5, 0x7a468336, 0x635db277,
+		0xcbfad74e, 0xd2e1e60f, 0xf9ccb5cc, 0xe0d7848d, 0xaf96124a, 0xb68d230b, 0x9da070c8, 0x84bb4189,
+		0x03235d46, 0x1a386c07, 0x31153fc4, 0x280e0e85, 0x674f9842, 0x7e54a903, 0x5579fac0, 0x4c62cb81,
+		0x8138c51f, 0x9823f45e, 0xb30ea79d, 0xaa1596dc, 0xe554001b, 0xfc4f315a, 0xd7626299, 0xce7953d8,
+		0x49e14f17, 0x50fa7e56, 0x7bd72d95, 0x62cc1cd4, 0x2d8d8a13, 0x3496bb52, 0x1fbbe891, 0x06a0d9d0,
+		0x5e7ef3ec, 0x4765c2ad, 0x6c48916e, 0x7553a02f, 0x3a1236e8, 0x230907a9, 0x0824546a, 0x113f652b,
+		0x96a779e4, 0x8fbc48a5, 0xa4911b66, 0xbd8a2a27, 0xf2cbbce0, 0xebd08da1, 0xc0fdde62, 0xd9e6ef23,
+		0x14bce1bd, 0x0da7d0fc, 0x268a833f, 0x3f91b27e, 0x70d024b9, 0x69cb15f8, 0x42e6463b, 0x5bfd777a,
+		0xdc656bb5, 0xc57e5af4, 0xee530937, 0xf7483876, 0xb809aeb1, 0xa1129ff0, 0x8a3fcc33, 0x9324fd72,
+	},
+	{
+		0x00000000, 0x01c26a37, 0x0384d46e, 0x0246be59, 0x0709a8dc, 0x06cbc2eb, 0x048d7cb2, 0x054f1685,
+		0x0e1351b8, 0x0fd13b8f, 0x0d9785d6, 0x0c55efe1, 0x091af964, 0x08d89353, 0x0a9e2d0a, 0x0b5c473d,
+		0x1c26a370, 0x1de4c947, 0x1fa2771e, 0x1e601d29, 0x1b2f0bac, 0x1aed619b, 0x18abdfc2, 0x1969b5f5,
+		0x1235f2c8, 0x13f798ff, 0x11b126a6, 0x10734c91, 0x153c5a14, 0x14fe3023, 0x16b88e7a, 0x177ae44d,
+		0x384d46e0, 0x398f2cd7, 0x3bc9928e, 0x3a0bf8b9, 0x3f44ee3c, 0x3e86840b, 0x3cc03a52, 0x3d025065,
+		0x365e1758, 0x379c7d6f, 0x35dac336, 0x3418a901, 0x3157bf84, 0x3095d5b3, 0x32d36bea, 0x331101dd,
+		0x246be590, 0x25a98fa7, 0x27ef31fe, 0x262d5bc9, 0x23624d4c, 0x22a0277b, 0x20e69922, 0x2124f315,
+		0x2a78b428, 0x2bbade1f, 0x29fc6046, 0x283e0a71, 0x2d711cf4, 0x2cb376c3, 0x2ef5c89a, 0x2f37a2ad,
+		0x709a8dc0, 0x7158e7f7, 0x731e59ae, 0x72dc3399, 0x7793251c, 0x76514f2b, 0x7417f172, 0x75d59b45,
+		0x7e89dc78, 0x7f4bb64f, 0x7d0d0816, 0x7ccf6221, 0x798074a4, 0x78421e93, 0x7a04a0ca, 0x7bc6cafd,
+		0x6cbc2eb0, 0x6d7e4487, 0x6f38fade, 0x6efa90e9, 0x6bb5866c, 0x6a77ec5b, 0x68315202, 0x69f33835,
+		0x62af7f08, 0x636d153f, 0x612bab66, 0x60e9c151, 0x65a6d7d4, 0x6464bde3, 0x662203ba, 0x67e0698d,
+		0x48d7cb20, 0x4915a117, 0x4b531f4e, 0x4a917579, 0x4fde63fc, 0x4e1c09cb, 0x4c5ab792, 0x4d98dda5,
+		0x46c49a98, 0x4706f0af, 0x45404ef6, 0x448224c1, 0x41cd3244, 0x400f5873, 0x4249e62a, 0x438b8c1d,
+		0x54f16850, 0x55330267, 0x5775bc3e, 0x56b7d609, 0x53f8c08c, 0x523aaabb, 0x507c14e2, 0x51be7ed5,
+		0x5ae239e8, 0x5b2053df, 0x5966ed86, 0x58a487b1, 0x5deb9134, 0x5c29fb03, 0x5e6f455a, 0x5fad2f6d,
+		0xe1351b80, 0xe0f771b7, 0xe2b1cfee, 0xe373a5d9, 0xe63cb35c, 0xe7fed96b, 0xe5b86732, 0xe47a0d05,
+		0xef264a38, 0xeee4200f, 0xeca29e56, 0xed60f461, 0xe82fe2e4, 0xe9ed88d3, 0xebab368a, 0xea695cbd,
+		0xfd13b8f0, 0xfcd1d2c7, 0xfe976c9e, 0xff5506a9, 0xfa1a102c, 0xfbd87a1b, 0xf99ec442, 0xf85cae75,
+		0xf300e948, 0xf2c2837f, 0xf0843d26, 0xf1465711, 0xf4094194, 0xf5cb2ba3, 0xf78d95fa, 0xf64fffcd,
+		0xd9785d60, 0xd8ba3757, 0xdafc890e, 0xdb3ee339, 0xde71f5bc, 0xdfb39f8b, 0xddf521d2, 0xdc374be5,
+		0xd76b0cd8, 0xd6a966ef, 0xd4efd8b6, 0xd52db281, 0xd062a404, 0xd1a0ce33, 0xd3e6706a, 0xd2241a5d,
+		0xc55efe10, 0xc49c9427, 0xc6da2a7e, 0xc7184049, 0xc25756cc, 0xc3953cfb, 0xc1d382a2, 0xc011e895,
+		0xcb4dafa8, 0xca8fc59f, 0xc8c97bc6, 0xc90b11f1, 0xcc440774, 0xcd866d43, 0xcfc0d31a, 0xce02b92d,
+		0x91af9640, 0x906dfc77, 0x922b422e, 0x93e92819, 0x96a63e9c, 0x976454ab, 0x9522eaf2, 0x94e080c5,
+		0x9fbcc7f8, 0x9e7eadcf, 0x9c381396, 0x9dfa79a1, 0x98b56f24, 0x99770513, 0x9b31bb4a, 0x9af3d17d,
+		0x8d893530, 0x8c4b5f07, 0x8e0de15e, 0x8fcf8b69, 0x8a809dec, 0x8b42f7db, 0x89044982, 0x88c623b5,
+		0x839a6488, 0x82580ebf, 0x801eb0e6, 0x81dcdad1, 0x8493cc54, 0x8551a663, 0x8717183a, 0x86d5720d,
+		0xa9e2d0a0, 0xa820ba97, 0xaa6604ce, 0xaba46ef9, 0xaeeb787c, 0xaf29124b, 0xad6fac12, 0xacadc625,
+		0xa7f18118, 0xa633eb2f, 0xa4755576, 0xa5b73f41, 0xa0f829c4, 0xa13a43f3, 0xa37cfdaa, 0xa2be979d,
+		0xb5c473d0, 0xb40619e7, 0xb640a7be, 0xb782cd89, 0xb2cddb0c, 0xb30fb13b, 0xb1490f62, 0xb08b6555,
+		0xbbd72268, 0xba15485f, 0xb853f606, 0xb9919c31, 0xbcde8ab4, 0xbd1ce083, 0xbf5a5eda, 0xbe9834ed,
+	},
+	{
+		0x00000000, 0xb8bc6765, 0xaa09c88b, 0x12b5afee, 0x8f629757, 0x37def032, 0x256b5fdc, 0x9dd738b9,
+		0xc5b428ef, 0x7d084f8a, 0x6fbde064, 0xd7018701, 0x4ad6bfb8, 0xf26ad8dd, 0xe0df7733, 0x58631056,
+		0x5019579f, 0xe8a530fa, 0xfa109f14, 0x42acf871, 0xdf7bc0c8, 0x67c7a7ad, 0x75720843, 0xcdce6f26,
+		0x95ad7f70, 0x2d111815, 0x3fa4b7fb, 0x8718d09e, 0x1acfe827, 0xa2738f42, 0xb0c620ac, 0x087a47c9,
+		0xa032af3e, 0x188ec85b, 0x0a3b67b5, 0xb28700d0, 0x2f503869, 0x97ec5f0c, 0x8559f0e2, 0x3de59787,
+		0x658687d1, 0xdd3ae0b4, 0xcf8f4f5a, 0x7733283f, 0xeae41086, 0x525877e3, 0x40edd80d, 0xf851bf68,
+		0xf02bf8a1, 0x48979fc4, 0x5a22302a, 0xe29e574f, 0x7f496ff6, 0xc7f50893, 0xd540a77d, 0x6dfcc018,
+		0x359fd04e, 0x8d23b72b, 0x9f9618c5, 0x272a7fa0, 0xbafd4719, 0x0241207c, 0x10f48f92, 0xa848e8f7,
+		0x9b14583d, 0x23a83f58, 0x311d90b6, 0x89a1f7d3, 0x1476cf6a, 0xaccaa80f, 0xbe7f07e1, 0x06c36084,
+		0x5ea070d2, 0xe61c17b7, 0xf4a9b859, 0x4c15df3c, 0xd1c2e785, 0x697e80e0, 0x7bcb2f0e, 0xc377486b,
+		0xcb0d0fa2, 0x73b168c7, 0x6104c729, 0xd9b8a04c, 0x446f98f5, 0xfcd3ff90, 0xee66507e, 0x56da371b,
+		0x0eb9274d, 0xb6054028, 0xa4b0efc6, 0x1c0c88a3, 0x81dbb01a, 0x3967d77f, 0x2bd27891, 0x936e1ff4,
+		0x3b26f703, 0x839a9066, 0x912f3f88, 0x299358ed, 0xb4446054, 0x0cf80731, 0x1e4da8df, 0xa6f1cfba,
+		0xfe92dfec, 0x462eb889, 0x549b1767, 0xec277002, 0x71f048bb, 0xc94c2fde, 0xdbf98030, 0x6345e755,
+		0x6b3fa09c, 0xd383c7f9, 0xc1366817, 0x798a0f72, 0xe45d37cb, 0x5ce150ae, 0x4e54ff40, 0xf6e89825,
+		0xae8b8873, 0x1637ef16, 0x048240f8, 0xbc3e279d, 0x21e91f24, 0x99557841, 0x8be0d7af, 0x335cb0ca,
+		0xed59b63b, 0x55e5d15e, 0x47507eb0, 0xffec19d5, 0x623b216c, 0xda874609, 0xc832e9e7, 0x708e8e82,
+		0x28ed9ed4, 0x9051f9b1, 0x82e4565f, 0x3a58313a, 0xa78f0983, 0x1f336ee6, 0x0d86c108, 0xb53aa66d,
+		0xbd40e1a4, 0x05fc86c1, 0x1749292f, 0xaff54e4a, 0x322276f3, 0x8a9e1196, 0x982bbe78, 0x2097d91d,
+		0x78f4c94b, 0xc048ae2e, 0xd2fd01c0, 0x6a4166a5, 0xf7965e1c, 0x4f2a3979, 0x5d9f9697, 0xe523f1f2,
+		0x4d6b1905, 0xf5d77e60, 0xe762d18e, 0x5fdeb6eb, 0xc2098e52, 0x7ab5e937, 0x680046d9, 0xd0bc21bc,
+		0x88df31ea, 0x3063568f, 0x22d6f961, 0x9a6a9e04, 0x07bda6bd, 0xbf01c1d8, 0xadb46e36, 0x15080953,
+		0x1d724e9a, 0xa5ce29ff, 0xb77b8611, 0x0fc7e174, 0x9210d9cd, 0x2aacbea8, 0x38191146, 0x80a57623,
+		0xd8c66675, 0x607a0110, 0x72cfaefe, 0xca73c99b, 0x57a4f122, 0xef189647, 0xfdad39a9, 0x45115ecc,
+		0x764dee06, 0xcef18963, 0xdc44268d, 0x64f841e8, 0xf92f7951, 0x41931e34, 0x5326b1da, 0xeb9ad6bf,
+		0xb3f9c6e9, 0x0b45a18c, 0x19f00e62, 0xa14c6907, 0x3c9b51be, 0x842736db, 0x96929935, 0x2e2efe50,
+		0x2654b999, 0x9ee8defc, 0x8c5d7112, 0x34e11677, 0xa9362ece, 0x118a49ab, 0x033fe645, 0xbb838120,
+		0xe3e09176, 0x5b5cf613, 0x49e959fd, 0xf1553e98, 0x6c820621, 0xd43e6144, 0xc68bceaa, 0x7e37a9cf,
+		0xd67f4138, 0x6ec3265d, 0x7c7689b3, 0xc4caeed6, 0x591dd66f, 0xe1a1b10a, 0xf3141ee4, 0x4ba87981,
+		0x13cb69d7, 0xab770eb2, 0xb9c2a15c, 0x017ec639, 0x9ca9fe80, 0x241599e5, 0x36a0360b, 0x8e1c516e,
+		0x866616a7, 0x3eda71c2, 0x2c6fde2c, 0x94d3b949, 0x090481f0, 0xb1b8e695, 0xa30d497b, 0x1bb12e1e,
+		0x43d23e48, 0xfb6e592d, 0xe9dbf6c3, 0x516791a6, 0xccb0a91f, 0x740cce7a, 0x66b96194, 0xde0506f1,
+	},
+	{
+		0x00000000, 0x3d6029b0, 0x7ac05360, 0x47a07ad0, 0xf580a6c0, 0xc8e08f70, 0x8f40f5a0, 0xb220dc10,
+		0x30704bc1, 0x0d106271, 0x4ab018a1, 0x77d03111, 0xc5f0ed01, 0xf890c4b1, 0xbf30be61, 0x825097d1,
+		0x60e09782, 0x5d80be32, 0x1a20c4e2, 0x2740ed52, 0x95603142, 0xa80018f2, 0xefa06222, 0xd2c04b92,
+		0x5090dc43, 0x6df0f5f3, 0x2a508f23, 0x1730a693, 0xa5107a83, 0x98705333, 0xdfd029e3, 0xe2b00053,
+		0xc1c12f04, 0xfca106b4, 0xbb017c64, 0x866155d4, 0x344189c4, 0x0921a074, 0x4e81daa4, 0x73e1f314,
+		0xf1b164c5, 0xccd14d75, 0x8b7137a5, 0xb6111e15, 0x0431c205, 0x3951ebb5, 0x7ef19165, 0x4391b8d5,
+		0xa121b886, 0x9c419136, 0xdbe1ebe6, 0xe681c256, 0x54a11e46, 0x69c137f6, 0x2e614d26, 0x13016496,
+		0x9151f347, 0xac31daf7, 0xeb91a027, 0xd6f18997, 0x64d15587, 0x59b17c37, 0x1e1106e7, 0x23712f57,
+		0x58f35849, 0x659371f9, 0x22330b29, 0x1f532299, 0xad73fe89, 0x9013d739, 0xd7b3ade9, 0xead38459,
+		0x68831388, 0x55e33a38, 0x124340e8, 0x2f236958, 0x9d03b548, 0xa0639cf8, 0xe7c3e628, 0xdaa3cf98,
+		0x3813cfcb, 0x0573e67b, 0x42d39cab, 0x7fb3b51b, 0xcd93690b, 0xf0f340bb, 0xb7533a6b, 0x8a3313db,
+		0x0863840a, 0x3503adba, 0x72a3d76a, 0x4fc3feda, 0xfde322ca, 0xc0830b7a, 0x872371aa, 0xba43581a,
+		0x9932774d, 0xa4525efd, 0xe3f2242d, 0xde920d9d, 0x6cb2d18d, 0x51d2f83d, 0x167282ed, 0x2b12ab5d,
+		0xa9423c8c, 0x9422153c, 0xd3826fec, 0xeee2465c, 0x5cc29a4c, 0x61a2b3fc, 0x2602c92c, 0x1b62e09c,
+		0xf9d2e0cf, 0xc4b2c97f, 0x8312b3af, 0xbe729a1f, 0x0c52460f, 0x31326fbf, 0x7692156f, 0x4bf23cdf,
+		0xc9a2ab0e, 0xf4c282be, 0xb362f86e, 0x8e02d1de, 0x3c220dce, 0x0142247e, 0x46e25eae, 0x7b82771e,
+		0xb1e6b092, 0x8c869922, 0xcb26e3f2, 0xf646ca42, 0x44661652, 0x79063fe2, 0x3ea64532, 0x03c66c82,
+		0x8196fb53, 0xbcf6d2e3, 0xfb56a833, 0xc6368183, 0x74165d93, 0x49767423, 0x0ed60ef3, 0x33b62743,
+		0xd1062710, 0xec660ea0, 0xabc67470, 0x96a65dc0, 0x248681d0, 0x19e6a860, 0x5e46d2b0, 0x6326fb00,
+		0xe1766cd1, 0xdc164561, 0x9bb63fb1, 0xa6d61601, 0x14f6ca11, 0x2996e3a1, 0x6e369971, 0x5356b0c1,
+		0x70279f96, 0x4d47b626, 0x0ae7ccf6, 0x3787e546, 0x85a73956, 0xb8c710e6, 0xff676a36, 0xc2074386,
+		0x4057d457, 0x7d37fde7, 0x3a978737, 0x07f7ae87, 0xb5d77297, 0x88b75b27, 0xcf1721f7, 0xf2770847,
+		0x10c70814, 0x2da721a4, 0x6a075b74, 0x576772c4, 0xe547aed4, 0xd8278764, 0x9f87fdb4, 0xa2e7d404,
+		0x20b743d5, 0x1dd76a65, 0x5a7710b5, 0x67173905, 0xd537e515, 0xe857cca5, 0xaff7b675, 0x92979fc5,
+		0xe915e8db, 0xd475c16b, 0x93d5bbbb, 0xaeb5920b, 0x1c954e1b, 0x21f567ab, 0x66551d7b, 0x5b3534cb,
+		0xd965a31a, 0xe4058aaa, 0xa3a5f07a, 0x9ec5d9ca, 0x2ce505da, 0x11852c6a, 0x562556ba, 0x6b457f0a,
+		0x89f57f59, 0xb49556e9, 0xf3352c39, 0xce550589, 0x7c75d999, 0x4115f029, 0x06b58af9, 0x3bd5a349,
+		0xb9853498, 0x84e51d28, 0xc34567f8, 0xfe254e48, 0x4c059258, 0x7165bbe8, 0x36c5c138, 0x0ba5e888,
+		0x28d4c7df, 0x15b4ee6f, 0x521494bf, 0x6f74bd0f, 0xdd54611f, 0xe03448af, 0xa794327f, 0x9af41bcf,
+		0x18a48c1e, 0x25c4a5ae, 0x6264df7e, 0x5f04f6ce, 0xed242ade, 0xd044036e, 0x97e479be, 0xaa84500e,
+		0x4834505d, 0x755479ed, 0x32f4033d, 0x0f942a8d, 0xbdb4f69d, 0x80d4df2d, 0xc774a5fd, 0xfa148c4d,
+		0x78441b9c, 0x4524322c, 0x028448fc, 0x3fe4614c, 0x8dc4bd5c, 0xb0a494ec, 0xf704ee3c, 0xca64c78c,
+	},
+	{
+		0x00000000, 0xcb5cd3a5, 0x4dc8a10b, 0x869472ae, 0x9b914216, 0x50cd91b3, 0xd659e31d, 0x1d0530b8,
+		0xec53826d, 0x270f51c8, 0xa19b2366, 0x6ac7f0c3, 0x77c2c07b, 0xbc9e13de, 0x3a0a6170, 0xf156b2d5,
+		0x03d6029b, 0xc88ad13e, 0x4e1ea390, 0x85427035, 0x9847408d, 0x531b9328, 0xd58fe186, 0x1ed33223,
+		0xef8580f6, 0x24d95353, 0xa24d21fd, 0x6911f258, 0x7414c2e0, 0xbf481145, 0x39dc63eb, 0xf280b04e,
+		0x07ac0536, 0xccf0d693, 0x4a64a43d, 0x81387798, 0x9c3d4720, 0x57619485, 0xd1f5e62b, 0x1aa9358e,
+		0xebff875b, 0x20a354fe, 0xa6372650, 0x6d6bf5f5, 0x706ec54d, 0xbb3216e8, 0x3da66446, 0xf6fab7e3,
+		0x047a07ad, 0xcf26d408, 0x49b2a6a6, 0x82ee7503, 0x9feb45bb, 0x54b7961e, 0xd223e4b0, 0x197f3715,
+		0xe82985c0, 0x23755665, 0xa5e124cb, 0x6ebdf76e, 0x73b8c7d6, 0xb8e41473, 0x3e7066dd, 0xf52cb578,
+		0x0f580a6c, 0xc404d9c9, 0x4290ab67, 0x89cc78c2, 0x94c9487a, 0x5f959bdf, 0xd901e971, 0x125d3ad4,
+		0xe30b8801, 0x28575ba4, 0xaec3290a, 0x659ffaaf, 0x789aca17, 0xb3c619b2, 0x35526b1c, 0xfe0eb8b9,
+		0x0c8e08f7, 0xc7d2db52, 0x4146a9fc, 0x8a1a7a59, 0x971f4ae1, 0x5c439944, 0xdad7ebea, 0x118b384f,
+		0xe0dd8a9a, 0x2b81593f, 0xad152b91, 0x6649f834, 0x7b4cc88c, 0xb0101b29, 0x36846987, 0xfdd8ba22,
+		0x08f40f5a, 0xc3a8dcff, 0x453cae51, 0x8e607df4, 0x93654d4c, 0x58399ee9, 0xdeadec47, 0x15f13fe2,
+		0xe4a78d37, 0x2ffb5e92, 0xa96f2c3c, 0x6233ff99, 0x7f36cf21, 0xb46a1c84, 0x32fe6e2a, 0xf9a2bd8f,
+		0x0b220dc1, 0xc07ede64, 0x46eaacca, 0x8db67f6f, 0x90b34fd7, 0x5bef9c72, 0xdd7beedc, 0x16273d79,
+		0xe7718fac, 0x2c2d5c09, 0xaab92ea7, 0x61e5fd02, 0x7ce0cdba, 0xb7bc1e1f, 0x31286cb1, 0xfa74bf14,
+		0x1eb014d8, 0xd5ecc77d, 0x5378b5d3, 0x98246676, 0x852156ce, 0x4e7d856b, 0xc8e9f7c5, 0x03b52460,
+		0xf2e396b5, 0x39bf4510, 0xbf2b37be, 0x7477e41b, 0x6972d4a3, 0xa22e0706, 0x24ba75a8, 0xefe6a60d,
+		0x1d661643, 0xd63ac5e6, 0x50aeb748, 0x9bf264ed, 0x86f75455, 0x4dab87f0, 0xcb3ff55e, 0x006326fb,
+		0xf135942e, 0x3a69478b, 0xbcfd3525, 0x77a1e680, 0x6aa4d638, 0xa1f8059d, 0x276c7733, 0xec30a496,
+		0x191c11ee, 0xd240c24b, 0x54d4b0e5, 0x9f886340, 0x828d53f8, 0x49d1805d, 0xcf45f2f3, 0x04192156,
+		0xf54f9383, 0x3e134026, 0xb8873288, 0x73dbe12d, 0x6eded195, 0xa5820230, 0x2316709e, 0xe84aa33b,
+		0x1aca1375, 0xd196c0d0, 0x5702b27e, 0x9c5e61db, 0x815b5163, 0x4a0782c6, 0xcc93f068, 0x07cf23cd,
+		0xf6999118, 0x3dc542bd, 0xbb513013, 0x700de3b6, 0x6d08d30e, 0xa65400ab, 0x20c07205, 0xeb9ca1a0,
+		0x11e81eb4, 0xdab4cd11, 0x5c20bfbf, 0x977c6c1a, 0x8a795ca2, 0x41258f07, 0xc7b1fda9, 0x0ced2e0c,
+		0xfdbb9cd9, 0x36e74f7c, 0xb0733dd2, 0x7b2fee77, 0x662adecf, 0xad760d6a, 0x2be27fc4, 0xe0beac61,
+		0x123e1c2f, 0xd962cf8a, 0x5ff6bd24, 0x94aa6e81, 0x89af5e39, 0x42f38d9c, 0xc467ff32, 0x0f3b2c97,
+		0xfe6d9e42, 0x35314de7, 0xb3a53f49, 0x78f9ecec, 0x65fcdc54, 0xaea00ff1, 0x28347d5f, 0xe368aefa,
+		0x16441b82, 0xdd18c827, 0x5b8cba89, 0x90d0692c, 0x8dd55994, 0x46898a31, 0xc01df89f, 0x0b412b3a,
+		0xfa1799ef, 0x314b4a4a, 0xb7df38e4, 0x7c83eb41, 0x6186dbf9, 0xaada085c, 0x2c4e7af2, 0xe712a957,
+		0x15921919, 0xdececabc, 0x585ab812, 0x93066bb7, 0x8e035b0f, 0x455f88aa, 0xc3cbfa04, 0x089729a1,
+		0xf9c19b74, 0x329d48d1, 0xb4093a7f, 0x7f55e9da, 0x6250d962, 0xa90c0ac7, 0x2f987869, 0xe4c4abcc,
+	},
+	{
+		0x00000000, 0xa6770bb4, 0x979f1129, 0x31e81a9d, 0xf44f2413, 0x52382fa7, 0x63d0353a, 0xc5a73e8e,
+		0x33ef4e67, 0x959845d3, 0xa4705f4e, 0x020754fa, 0xc7a06a74, 0x61d761c0, 0x503f7b5d, 0xf64870e9,
+		0x67de9cce, 0xc1a9977a, 0xf0418de7, 0x56368653, 0x9391b8dd, 0x35e6b369, 0x040ea9f4, 0xa279a240,
+		0x5431d2a9, 0xf246d91d, 0xc3aec380, 0x65d9c834, 0xa07ef6ba, 0x0609fd0e, 0x37e1e793, 0x9196ec27,
+		0xcfbd399c, 0x69ca3228, 0x582228b5, 0xfe552301, 0x3bf21d8f, 0x9d85163b, 0xac6d0ca6, 0x0a1a0712,
+		0xfc5277fb, 0x5a257c4f, 0x6bcd66d2, 0xcdba6d66, 0x081d53e8, 0xae6a585c, 0x9f8242c1, 0x39f54975,
+		0xa863a552, 0x0e14aee6, 0x3ffcb47b, 0x998bbfcf, 0x5c2c8141, 0xfa5b8af5, 0xcbb39068, 0x6dc49bdc,
+		0x9b8ceb35, 0x3dfbe081, 0x0c13fa1c, 0xaa64f1a8, 0x6fc3cf26, 0xc9b4c492, 0xf85cde0f, 0x5e2bd5bb,
+		0x440b7579, 0xe27c7ecd, 0xd3946450, 0x75e36fe4, 0xb044516a, 0x16335ade, 0x27db4043, 0x81ac4bf7,
+		0x77e43b1e, 0xd19330aa, 0xe07b2a37, 0x460c2183, 0x83ab1f0d, 0x25dc14b9, 0x14340e24, 0xb2430590,
+		0x23d5e9b7, 0x85a2e203, 0xb44af89e, 0x123df32a, 0xd79acda4, 0x71edc610, 0x4005dc8d, 0xe672d739,
+		0x103aa7d0, 0xb64dac64, 0x87a5b6f9, 0x21d2bd4d, 0xe47583c3, 0x42028877, 0x73ea92ea, 0xd59d995e,
+		0x8bb64ce5, 0x2dc14751, 0x1c295dcc, 0xba5e5678, 0x7ff968f6, 0xd98e6342, 0xe86679df, 0x4e11726b,
+		0xb8590282, 0x1e2e0936, 0x2fc613ab, 0x89b1181f, 0x4c162691, 0xea612d25, 0xdb8937b8, 0x7dfe3c0c,
+		0xec68d02b, 0x4a1fdb9f, 0x7bf7c102, 0xdd80cab6, 0x1827f438, 0xbe50ff8c, 0x8fb8e511, 0x29cfeea5,
+		0xdf879e4c, 0x79f095f8, 0x48188f65, 0xee6f84d1, 0x2bc8ba5f, 0x8dbfb1eb, 0xbc57ab76, 0x1a20a0c2,
+		0x8816eaf2, 0x2e61e146, 0x1f89fbdb, 0xb9fef06f, 0x7c59cee1, 0xda2ec555, 0xebc6dfc8, 0x4db1d47c,
+		0xbbf9a495, 0x1d8eaf21, 0x2c66b5bc, 0x8a11be08, 0x4fb68086, 0xe9c18b32, 0xd82991af, 0x7e5e9a1b,
+		0xefc8763c, 0x49bf7d88, 0x78576715, 0xde206ca1, 0x1b87522f, 0xbdf0599b, 0x8c184306, 0x2a6f48b2,
+		0xdc27385b, 0x7a5033ef, 0x4bb82972, 0xedcf22c6, 0x28681c48, 0x8e1f17fc, 0xbff70d61, 0x198006d5,
+		0x47abd36e, 0xe1dcd8da, 0xd034c247, 0x7643c9f3, 0xb3e4f77d, 0x1593fcc9, 0x247be654, 0x820cede0,
+		0x74449d09, 0xd23396bd, 0xe3db8c20, 0x45ac8794, 0x800bb91a, 0x267cb2ae, 0x1794a833, 0xb1e3a387,
+		0x20754fa0, 0x86024414, 0xb7ea5e89, 0x119d553d, 0xd43a6bb3, 0x724d6007, 0x43a57a9a, 0xe5d2712e,
+		0x139a01c7, 0xb5ed0a73, 0x840510ee, 0x22721b5a, 0xe7d525d4, 0x41a22e60, 0x704a34fd, 0xd63d3f49,
+		0xcc1d9f8b, 0x6a6a943f, 0x5b828ea2, 0xfdf58516, 0x3852bb98, 0x9e25b02c, 0xafcdaab1, 0x09baa105,
+		0xfff2d1ec, 0x5985da58, 0x686dc0c5, 0xce1acb71, 0x0bbdf5ff, 0xadcafe4b, 0x9c22e4d6, 0x3a55ef62,
+		0xabc30345, 0x0db408f1, 0x3c5c126c, 0x9a2b19d8, 0x5f8c2756, 0xf9fb2ce2, 0xc813367f, 0x6e643dcb,
+		0x982c4d22, 0x3e5b4696, 0x0fb35c0b, 0xa9c457bf, 0x6c636931, 0xca146285, 0xfbfc7818, 0x5d8b73ac,
+		0x03a0a617, 0xa5d7ada3, 0x943fb73e, 0x3248bc8a, 0xf7ef8204, 0x519889b0, 0x6070932d, 0xc6079899,
+		0x304fe870, 0x9638e3c4, 0xa7d0f959, 0x01a7f2ed, 0xc400cc63, 0x6277c7d7, 0x539fdd4a, 0xf5e8d6fe,
+		0x647e3ad9, 0xc209316d, 0xf3e12bf0, 0x55962044, 0x90311eca, 0x3646157e, 0x07ae0fe3, 0xa1d90457,
+		0x579174be, 0xf1e67f0a, 0xc00e6597, 0x66796e23, 0xa3de50ad, 0x05a95b19, 0x34414184, 0x92364a30,
+	},
+	{
+		0x00000000, 0xccaa009e, 0x4225077d, 0x8e8f07e3, 0x844a0efa, 0x48e00e64, 0xc66f0987, 0x0ac50919,
+		0xd3e51bb5, 0x1f4f1b2b, 0x91c01cc8, 0x5d6a1c56, 0x57af154f, 0x9b0515d1, 0x158a1232, 0xd92012ac,
+		0x7cbb312b, 0xb01131b5, 0x3e9e3656, 0xf23436c8, 0xf8f13fd1, 0x345b3f4f, 0xbad438ac, 0x767e3832,
+		0xaf5e2a9e, 0x63f42a00, 0xed7b2de3, 0x21d12d7d, 0x2b142464, 0xe7be24fa, 0x69312319, 0xa59b2387,
+		0xf9766256, 0x35dc62c8, 0xbb53652b, 0x77f965b5, 0x7d3c6cac, 0xb1966c32, 0x3f196bd1, 0xf3b36b4f,
+		0x2a9379e3, 0xe639797d, 0x68b67e9e, 0xa41c7e00, 0xaed97719, 0x62737787, 0xecfc7064, 0x205670fa,
+		0x85cd537d, 0x496753e3, 0xc7e85400, 0x0b42549e, 0x01875d87, 0xcd2d5d19, 0x43a25afa, 0x8f085a64,
+		0x562848c8, 0x9a824856, 0x140d4fb5, 0xd8a74f2b, 0xd2624632, 0x1ec846ac, 0x9047414f, 0x5ced41d1,
+		0x299dc2ed, 0xe537c273, 0x6bb8c590, 0xa712c50e, 0xadd7cc17, 0x617dcc89, 0xeff2cb6a, 0x2358cbf4,
+		0xfa78d958, 0x36d2d9c6, 0xb85dde25, 0x74f7debb, 0x7e32d7a2, 0xb298d73c, 0x3c17d0df, 0xf0bdd041,
+		0x5526f3c6, 0x998cf358, 0x1703f4bb, 0xdba9f425, 0xd16cfd3c, 0x1dc6fda2, 0x9349fa41, 0x5fe3fadf,
+		0x86c3e873, 0x4a69e8ed, 0xc4e6ef0e, 0x084cef90, 0x0289e689, 0xce23e617, 0x40ace1f4, 0x8c06e16a,
+		0xd0eba0bb, 0x1c41a025, 0x92cea7c6, 0x5e64a758, 0x54a1ae41, 0x980baedf, 0x1684a93c, 0xda2ea9a2,
+		0x030ebb0e, 0xcfa4bb90, 0x412bbc73, 0x8d81bced, 0x8744b5f4, 0x4beeb56a, 0xc561b289, 0x09cbb217,
+		0xac509190, 0x60fa910e, 0xee7596ed, 0x22df9673, 0x281a9f6a, 0xe4b09ff4, 0x6a3f9817, 0xa6959889,
+		0x7fb58a25, 0xb31f8abb, 0x3d908d58, 0xf13a8dc6, 0xfbff84df, 0x37558441, 0xb9da83a2, 0x7570833c,
+		0x533b85da, 0x9f918544, 0x111e82a7, 0xddb48239, 0xd7718b20, 0x1bdb8bbe, 0x95548c5d, 0x59fe8cc3,
+		0x80de9e6f, 0x4c749ef1, 0xc2fb9912, 0x0e51998c, 0x04949095, 0xc83e900b, 0x46b197e8, 0x8a1b9776,
+		0x2f80b4f1, 0xe32ab46f, 0x6da5b38c, 0xa10fb312, 0xabcaba0b, 0x6760ba95, 0xe9efbd76, 0x2545bde8,
+		0xfc65af44, 0x30cfafda, 0xbe40a839, 0x72eaa8a7, 0x782fa1be, 0xb485a120, 0x3a0aa6c3, 0xf6a0a65d,
+		0xaa4de78c, 0x66e7e712, 0xe868e0f1, 0x24c2e06f, 0x2e07e976, 0xe2ade9e8, 0x6c22ee0b, 0xa088ee95,
+		0x79a8fc39, 0xb502fca7, 0x3b8dfb44, 0xf727fbda, 0xfde2f2c3, 0x3148f25d, 0xbfc7f5be, 0x736df520,
+		0xd6f6d6a7, 0x1a5cd639, 0x94d3d1da, 0x5879d144, 0x52bcd85d, 0x9e16d8c3, 0x1099df20, 0xdc33dfbe,
+		0x0513cd12, 0xc9b9cd8c, 0x4736ca6f, 0x8b9ccaf1, 0x8159c3e8, 0x4df3c376, 0xc37cc495, 0x0fd6c40b,
+		0x7aa64737, 0xb60c47a9, 0x3883404a, 0xf42940d4, 0xfeec49cd, 0x32464953, 0xbcc94eb0, 0x70634e2e,
+		0xa9435c82, 0x65e95c1c, 0xeb665bff, 0x27cc5b61, 0x2d095278, 0xe1a352e6, 0x6f2c5505, 0xa386559b,
+		0x061d761c, 0xcab77682, 0x44387161, 0x889271ff, 0x825778e6, 0x4efd7878, 0xc0727f9b, 0x0cd87f05,
+		0xd5f86da9, 0x19526d37, 0x97dd6ad4, 0x5b776a4a, 0x51b26353, 0x9d1863cd, 0x1397642e, 0xdf3d64b0,
+		0x83d02561, 0x4f7a25ff, 0xc1f5221c, 0x0d5f2282, 0x079a2b9b, 0xcb302b05, 0x45bf2ce6, 0x89152c78,
+		0x50353ed4, 0x9c9f3e4a, 0x121039a9, 0xdeba3937, 0xd47f302e, 0x18d530b0, 0x965a3753, 0x5af037cd,
+		0xff6b144a, 0x33c114d4, 0xbd4e1337, 0x71e413a9, 0x7b211ab0, 0xb78b1a2e, 0x39041dcd, 0xf5ae1d53,
+		0x2c8e0fff, 0xe0240f61, 0x6eab0882, 0xa201081c, 0xa8c40105, 0x646e019b, 0xeae10678, 0x264b06e6,
+	},
+};
+gb_global u64 const gb__crc64_slices[8][256] = {
+	{
+		0x0000000000000000ull, 0x42f0e1eba9ea3693ull, 0x85e1c3d753d46d26ull, 0xc711223cfa3e5bb5ull,
+		0x493366450e42ecdfull, 0x0bc387aea7a8da4cull, 0xccd2a5925d9681f9ull, 0x8e224479f47cb76aull,
+		0x9266cc8a1c85d9beull, 0xd0962d61b56fef2dull, 0x17870f5d4f51b498ull, 0x5577eeb6e6bb820bull,
+		0xdb55aacf12c73561ull, 0x99a54b24bb2d03f2ull, 0x5eb4691841135847ull, 0x1c4488f3e8f96ed4ull,
+		0x663d78ff90e185efull, 0x24cd9914390bb37cull, 0xe3dcbb28c335e8c9ull, 0xa12c5ac36adfde5aull,
+		0x2f0e1eba9ea36930ull, 0x6dfeff5137495fa3ull, 0xaaefdd6dcd770416ull, 0xe81f3c86649d3285ull,
+		0xf45bb4758c645c51ull, 0xb6ab559e258e6ac2ull, 0x71ba77a2dfb03177ull, 0x334a9649765a07e4ull,
+		0xbd68d2308226b08eull, 0xff9833db2bcc861dull, 0x388911e7d1f2dda8ull, 0x7a79f00c7818eb3bull,
+		0xcc7af1ff21c30bdeull, 0x8e8a101488293d4dull, 0x499b3228721766f8ull, 0x0b6bd3c3dbfd506bull,
+		0x854997ba2f81e701ull, 0xc7b97651866bd192ull, 0x00a8546d7c558a27ull, 0x4258b586d5bfbcb4ull,
+		0x5e1c3d753d46d260ull, 0x1cecdc9e94ace4f3ull, 0xdbfdfea26e92bf46ull, 0x990d1f49c77889d5ull,
+		0x172f5b3033043ebfull, 0x55dfbadb9aee082cull, 0x92ce98e760d05399ull, 0xd03e790cc93a650aull,
+		0xaa478900b1228e31ull, 0xe8b768eb18c8b8a2ull, 0x2fa64ad7e2f6e317ull, 0x6d56ab3c4b1cd584ull,
+		0xe374ef45bf6062eeull, 0xa1840eae168a547dull, 0x66952c92ecb40fc8ull, 0x2465cd79455e395bull,
+		0x3821458aada7578full, 0x7ad1a461044d611cull, 0xbdc0865dfe733aa9ull, 0xff3067b657990c3aull,
+		0x711223cfa3e5bb50ull, 0x33e2c2240a0f8dc3ull, 0xf4f3e018f031d676ull, 0xb60301f359dbe0e5ull,
+		0xda050215ea6c212full, 0x98f5e3fe438617bcull, 0x5fe4c1c2b9b84c09ull, 0x1d14202910527a9aull,
+		0x93366450e42ecdf0ull, 0xd1c685bb4dc4fb63ull, 0x16d7a787b7faa0d6ull, 0x5427466c1e109645ull,
+		0x4863ce9ff6e9f891ull, 0x0a932f745f03ce02ull, 0xcd820d48a53d95b7ull, 0x8f72eca30cd7a324ull,
+		0x0150a8daf8ab144eull, 0x43a04931514122ddull, 0x84b16b0dab7f7968ull, 0xc6418ae602954ffbull,
+		0xbc387aea7a8da4c0ull, 0xfec89b01d3679253ull, 0x39d9b93d2959c9e6ull, 0x7b2958d680b3ff75ull,
+		0xf50b1caf74cf481full, 0xb7fbfd44dd257e8cull, 0x70eadf78271b2539ull, 0x321a3e938ef113aaull,
+		0x2e5eb66066087d7eull, 0x6cae578bcfe24bedull, 0xabbf75b735dc1058ull, 0xe94f945c9c3626cbull,
+		0x676dd025684a91a1ull, 0x259d31cec1a0a732ull, 0xe28c13f23b9efc87ull, 0xa07cf2199274ca14ull,
+		0x167ff3eacbaf2af1ull, 0x548f120162451c62ull, 0x939e303d987b47d7ull, 0xd16ed1d631917144ull,
+		0x5f4c95afc5edc62eull, 0x1dbc74446c07f0bdull, 0xdaad56789639ab08ull, 0x985db7933fd39d9bull,
+		0x84193f60d72af34full, 0xc6e9de8b7ec0c5dcull, 0x01f8fcb784fe9e69ull, 0x43081d5c2d14a8faull,
+		0xcd2a5925d9681f90ull, 0x8fdab8ce70822903ull, 0x48cb9af28abc72b6ull, 0x0a3b7b1923564425ull,
+		0x70428b155b4eaf1eull, 0x32b26afef2a4998dull, 0xf5a348c2089ac238ull, 0xb753a929a170f4abull,
+		0x3971ed50550c43c1ull, 0x7b810cbbfce67552ull, 0xbc902e8706d82ee7ull, 0xfe60cf6caf321874ull,
+		0xe224479f47cb76a0ull, 0xa0d4a674ee214033ull, 0x67c58448141f1b86ull, 0x253565a3bdf52d15ull,
+		0xab1721da49899a7full, 0xe9e7c031e063acecull, 0x2ef6e20d1a5df759ull, 0x6c0603e6b3b7c1caull,
+		0xf6fae5c07d3274cdull, 0xb40a042bd4d8425eull, 0x731b26172ee619ebull, 0x31ebc7fc870c2f78ull,
+		0xbfc9838573709812ull, 0xfd39626eda9aae81ull, 0x3a28405220a4f534ull, 0x78d8a1b9894ec3a7ull,
+		0x649c294a61b7ad73ull, 0x266cc8a1c85d9be0ull, 0xe17dea9d3263c055ull, 0xa38d0b769b89f6c6ull,
+		0x2daf4f0f6ff541acull, 0x6f5faee4c61f773full, 0xa84e8cd83c212c8aull, 0xeabe6d3395cb1a19ull,
+		0x90c79d3fedd3f122ull, 0xd2377cd44439c7b1ull, 0x15265ee8be079c04ull, 0x57d6bf0317edaa97ull,
+		0xd9f4fb7ae3911dfdull, 0x9b041a914a7b2b6eull, 0x5c1538adb04570dbull, 0x1ee5d94619af4648ull,
+		0x02a151b5f156289cull, 0x4051b05e58bc1e0full, 0x87409262a28245baull, 0xc5b073890b687329ull,
+		0x4b9237f0ff14c443ull, 0x0962d61b56fef2d0ull, 0xce73f427acc0a965ull, 0x8c8315cc052a9ff6ull,
+		0x3a80143f5cf17f13ull, 0x7870f5d4f51b4980ull, 0xbf61d7e80f251235ull, 0xfd913603a6cf24a6ull,
+		0x73b3727a52b393ccull, 0x31439391fb59a55full, 0xf652b1ad0167feeaull, 0xb4a25046a88dc879ull,
+		0xa8e6d8b54074a6adull, 0xea16395ee99e903eull, 0x2d071b6213a0cb8bull, 0x6ff7fa89ba4afd18ull,
+		0xe1d5bef04e364a72ull, 0xa3255f1be7dc7ce1ull, 0x64347d271de22754ull, 0x26c49cccb40811c7ull,
+		0x5cbd6cc0cc10fafcull, 0x1e4d8d2b65facc6full, 0xd95caf179fc497daull, 0x9bac4efc362ea149ull,
+		0x158e0a85c2521623ull, 0x577eeb6e6bb820b0ull, 0x906fc95291867b05ull, 0xd29f28b9386c4d96ull,
+		0xcedba04ad0952342ull, 0x8c2b41a1797f15d1ull, 0x4b3a639d83414e64ull, 0x09ca82762aab78f7ull,
+		0x87e8c60fded7cf9dull, 0xc51827e4773df90eull, 0x020905d88d03a2bbull, 0x40f9e43324e99428ull,
+		0x2cffe7d5975e55e2ull, 0x6e0f063e3eb46371ull, 0xa91e2402c48a38c4ull, 0xebeec5e96d600e57ull,
+		0x65cc8190991cb93dull, 0x273c607b30f68faeull, 0xe02d4247cac8d41bull, 0xa2dda3ac6322e288ull,
+		0xbe992b5f8bdb8c5cull, 0xfc69cab42231bacfull, 0x3b78e888d80fe17aull, 0x7988096371e5d7e9ull,
+		0xf7aa4d1a85996083ull, 0xb55aacf12c735610ull, 0x724b8ecdd64d0da5ull, 0x30bb6f267fa73b36ull,
+		0x4ac29f2a07bfd00dull, 0x08327ec1ae55e69eull, 0xcf235cfd546bbd2bull, 0x8dd3bd16fd818bb8ull,
+		0x03f1f96f09fd3cd2ull, 0x41011884a0170a41ull, 0x86103ab85a2951f4ull, 0xc4e0db53f3c36767ull,
+		0xd8a453a01b3a09b3ull, 0x9a54b24bb2d03f20ull, 0x5d45907748ee6495ull, 0x1fb5719ce1045206ull,
+		0x919735e51578e56cull, 0xd367d40ebc92d3ffull, 0x1476f63246ac884aull, 0x568617d9ef46bed9ull,
+		0xe085162ab69d5e3cull, 0xa275f7c11f7768afull, 0x6564d5fde549331aull, 0x279434164ca30589ull,
+		0xa9b6706fb8dfb2e3ull, 0xeb46918411358470ull, 0x2c57b3b8eb0bdfc5ull, 0x6ea7525342e1e956ull,
+		0x72e3daa0aa188782ull, 0x30133b4b03f2b111ull, 0xf7021977f9cceaa4ull, 0xb5f2f89c5026dc37ull,
+		0x3bd0bce5a45a6b5dull, 0x79205d0e0db05dceull, 0xbe317f32f78e067bull, 0xfcc19ed95e6430e8ull,
+		0x86b86ed5267cdbd3ull, 0xc4488f3e8f96ed40ull, 0x0359ad0275a8b6f5ull, 0x41a94ce9dc428066ull,
+		0xcf8b0890283e370cull, 0x8d7be97b81d4019full, 0x4a6acb477bea5a2aull, 0x089a2aacd2006cb9ull,
+		0x14dea25f3af9026dull, 0x562e43b4931334feull, 0x913f6188692d6f4bull, 0xd3cf8063c0c759d8ull,
+		0x5dedc41a34bbeeb2ull, 0x1f1d25f19d51d821ull, 0xd80c07cd676f8394ull, 0x9afce626ce85b507ull,
+	},
+	{
+		0x0000000000000000ull, 0x57944fe2fc4440a1ull, 0x002db5aeab065e4aull, 0x57b9fa4c57421eebull,
+		0x56cf24bfaa48fc35ull, 0x015b6b5d560cbc94ull, 0x56e29111014ea27full, 0x0176def3fd0ae2deull,
+		0x029b6314071f2762ull, 0x550f2cf6fb5b67c3ull, 0x02b6d6baac197928ull, 0x55229958505d3989ull,
+		0x545447abad57db57ull, 0x03c0084951139bf6ull, 0x5479f2050651851dull, 0x03edbde7fa15c5bcull,
+		0xfca7a3a1a1f4d16dull, 0xab33ec435db091ccull, 0xfc8a160f0af28f27ull, 0xab1e59edf6b6cf86ull,
+		0xaa68871e0bbc2d58ull, 0xfdfcc8fcf7f86df9ull, 0xaa4532b0a0ba7312ull, 0xfdd17d525cfe33b3ull,
+		0xfe3cc0b5a6ebf60full, 0xa9a88f575aafb6aeull, 0xfe11751b0deda845ull, 0xa9853af9f1a9e8e4ull,
+		0xa8f3e40a0ca30a3aull, 0xff67abe8f0e74a9bull, 0xa8de51a4a7a55470ull, 0xff4a1e465be114d1ull,
+		0x14ba8cc3b98d4b41ull, 0x432ec32145c90be0ull, 0x1497396d128b150bull, 0x4303768feecf55aaull,
+		0x4275a87c13c5b774ull, 0x15e1e79eef81f7d5ull, 0x42581dd2b8c3e93eull, 0x15cc52304487a99full,
+		0x1621efd7be926c23ull, 0x41b5a03542d62c82ull, 0x160c5a7915943269ull, 0x4198159be9d072c8ull,
+		0x40eecb6814da9016ull, 0x177a848ae89ed0b7ull, 0x40c37ec6bfdcce5cull, 0x1757312443988efdull,
+		0xe81d2f6218799a2cull, 0xbf896080e43dda8dull, 0xe8309accb37fc466ull, 0xbfa4d52e4f3b84c7ull,
+		0xbed20bddb2316619ull, 0xe946443f4e7526b8ull, 0xbeffbe7319373853ull, 0xe96bf191e57378f2ull,
+		0xea864c761f66bd4eull, 0xbd120394e322fdefull, 0xeaabf9d8b460e304ull, 0xbd3fb63a4824a3a5ull,
+		0xbc4968c9b52e417bull, 0xebdd272b496a01daull, 0xbc64dd671e281f31ull, 0xebf09285e26c5f90ull,
+		0xd0e47c0edcd0092bull, 0x877033ec2094498aull, 0xd0c9c9a077d65761ull, 0x875d86428b9217c0ull,
+		0x862b58b17698f51eull, 0xd1bf17538adcb5bfull, 0x8606ed1fdd9eab54ull, 0xd192a2fd21daebf5ull,
+		0xd27f1f1adbcf2e49ull, 0x85eb50f8278b6ee8ull, 0xd252aab470c97003ull, 0x85c6e5568c8d30a2ull,
+		0x84b03ba57187d27cull, 0xd32474478dc392ddull, 0x849d8e0bda818c36ull, 0xd309c1e926c5cc97ull,
+		0x2c43dfaf7d24d846ull, 0x7bd7904d816098e7ull, 0x2c6e6a01d622860cull, 0x7bfa25e32a66c6adull,
+		0x7a8cfb10d76c2473ull, 0x2d18b4f22b2864d2ull, 0x7aa14ebe7c6a7a39ull, 0x2d35015c802e3a98ull,
+		0x2ed8bcbb7a3bff24ull, 0x794cf359867fbf85ull, 0x2ef50915d13da16eull, 0x796146f72d79e1cfull,
+		0x78179804d0730311ull, 0x2f83d7e62c3743b0ull, 0x783a2daa7b755d5bull, 0x2fae624887311dfaull,
+		0xc45ef0cd655d426aull, 0x93cabf2f991902cbull, 0xc4734563ce5b1c20ull, 0x93e70a81321f5c81ull,
+		0x9291d472cf15be5full, 0xc5059b903351fefeull, 0x92bc61dc6413e015ull, 0xc5282e3e9857a0b4ull,
+		0xc6c593d962426508ull, 0x9151dc3b9e0625a9ull, 0xc6e82677c9443b42ull, 0x917c699535007be3ull,
+		0x900ab766c80a993dull, 0xc79ef884344ed99cull, 0x902702c8630cc777ull, 0xc7b34d2a9f4887d6ull,
+		0x38f9536cc4a99307ull, 0x6f6d1c8e38edd3a6ull, 0x38d4e6c26fafcd4dull, 0x6f40a92093eb8decull,
+		0x6e3677d36ee16f32ull, 0x39a2383192a52f93ull, 0x6e1bc27dc5e73178ull, 0x398f8d9f39a371d9ull,
+		0x3a623078c3b6b465ull, 0x6df67f9a3ff2f4c4ull, 0x3a4f85d668b0ea2full, 0x6ddbca3494f4aa8eull,
+		0x6cad14c769fe4850ull, 0x3b395b2595ba08f1ull, 0x6c80a169c2f8161aull, 0x3b14ee8b3ebc56bbull,
+		0xb5ac5614ec0e6464ull, 0xe23819f6104a24c5ull, 0xb581e3ba47083a2eull, 0xe215ac58bb4c7a8full,
+		0xe36372ab46469851ull, 0xb4f73d49ba02d8f0ull, 0xe34ec705ed40c61bull, 0xb4da88e7110486baull,
+		0xb7373500eb114306ull, 0xe0a37ae2175503a7ull, 0xb71a80ae40171d4cull, 0xe08ecf4cbc535dedull,
+		0xe1f811bf4159bf33ull, 0xb66c5e5dbd1dff92ull, 0xe1d5a411ea5fe179ull, 0xb641ebf3161ba1d8ull,
+		0x490bf5b54dfab509ull, 0x1e9fba57b1bef5a8ull, 0x4926401be6fceb43ull, 0x1eb20ff91ab8abe2ull,
+		0x1fc4d10ae7b2493cull, 0x48509ee81bf6099dull, 0x1fe964a44cb41776ull, 0x487d2b46b0f057d7ull,
+		0x4b9096a14ae5926bull, 0x1c04d943b6a1d2caull, 0x4bbd230fe1e3cc21ull, 0x1c296ced1da78c80ull,
+		0x1d5fb21ee0ad6e5eull, 0x4acbfdfc1ce92effull, 0x1d7207b04bab3014ull, 0x4ae64852b7ef70b5ull,
+		0xa116dad755832f25ull, 0xf6829535a9c76f84ull, 0xa13b6f79fe85716full, 0xf6af209b02c131ceull,
+		0xf7d9fe68ffcbd310ull, 0xa04db18a038f93b1ull, 0xf7f44bc654cd8d5aull, 0xa0600424a889cdfbull,
+		0xa38db9c3529c0847ull, 0xf419f621aed848e6ull, 0xa3a00c6df99a560dull, 0xf434438f05de16acull,
+		0xf5429d7cf8d4f472ull, 0xa2d6d29e0490b4d3ull, 0xf56f28d253d2aa38ull, 0xa2fb6730af96ea99ull,
+		0x5db17976f477fe48ull, 0x0a2536940833bee9ull, 0x5d9cccd85f71a002ull, 0x0a08833aa335e0a3ull,
+		0x0b7e5dc95e3f027dull, 0x5cea122ba27b42dcull, 0x0b53e867f5395c37ull, 0x5cc7a785097d1c96ull,
+		0x5f2a1a62f368d92aull, 0x08be55800f2c998bull, 0x5f07afcc586e8760ull, 0x0893e02ea42ac7c1ull,
+		0x09e53edd5920251full, 0x5e71713fa56465beull, 0x09c88b73f2267b55ull, 0x5e5cc4910e623bf4ull,
+		0x65482a1a30de6d4full, 0x32dc65f8cc9a2deeull, 0x65659fb49bd83305ull, 0x32f1d056679c73a4ull,
+		0x33870ea59a96917aull, 0x6413414766d2d1dbull, 0x33aabb0b3190cf30ull, 0x643ef4e9cdd48f91ull,
+		0x67d3490e37c14a2dull, 0x304706eccb850a8cull, 0x67fefca09cc71467ull, 0x306ab342608354c6ull,
+		0x311c6db19d89b618ull, 0x6688225361cdf6b9ull, 0x3131d81f368fe852ull, 0x66a597fdcacba8f3ull,
+		0x99ef89bb912abc22ull, 0xce7bc6596d6efc83ull, 0x99c23c153a2ce268ull, 0xce5673f7c668a2c9ull,
+		0xcf20ad043b624017ull, 0x98b4e2e6c72600b6ull, 0xcf0d18aa90641e5dull, 0x989957486c205efcull,
+		0x9b74eaaf96359b40ull, 0xcce0a54d6a71dbe1ull, 0x9b595f013d33c50aull, 0xcccd10e3c17785abull,
+		0xcdbbce103c7d6775ull, 0x9a2f81f2c03927d4ull, 0xcd967bbe977b393full, 0x9a02345c6b3f799eull,
+		0x71f2a6d98953260eull, 0x2666e93b751766afull, 0x71df137722557844ull, 0x264b5c95de1138e5ull,
+		0x273d8266231bda3bull, 0x70a9cd84df5f9a9aull, 0x271037c8881d8471ull, 0x7084782a7459c4d0ull,
+		0x7369c5cd8e4c016cull, 0x24fd8a2f720841cdull, 0x73447063254a5f26ull, 0x24d03f81d90e1f87ull,
+		0x25a6e1722404fd59ull, 0x7232ae90d840bdf8ull, 0x258b54dc8f02a313ull, 0x721f1b3e7346e3b2ull,
+		0x8d55057828a7f763ull, 0xdac14a9ad4e3b7c2ull, 0x8d78b0d683a1a929ull, 0xdaecff347fe5e988ull,
+		0xdb9a21c782ef0b56ull, 0x8c0e6e257eab4bf7ull, 0xdbb7946929e9551cull, 0x8c23db8bd5ad15bdull,
+		0x8fce666c2fb8d001ull, 0xd85a298ed3fc90a0ull, 0x8fe3d3c284be8e4bull, 0xd8779c2078faceeaull,
+		0xd90142d385f02c34ull, 0x8e950d3179b46c95ull, 0xd92cf77d2ef6727eull, 0x8eb8b89fd2b232dfull,
+	},
+	{
+		0x0000000000000000ull, 0x7827619b17e70dc0ull, 0xcd8220fd0b9693e9ull, 0xb5a541661c719e29ull,
+		0xa1d2c18aa9201c81ull, 0xd9f5a011bec71141ull, 0x6c50e177a2b68f68ull, 0x147780ecb55182a8ull,
+		0x939cab5e8c7c58f0ull, 0xebbbcac59b9b5530ull, 0x5e1e8ba387eacb19ull, 0x2639ea38900dc6d9ull,
+		0x324e6ad4255c4471ull, 0x4a690b4f32bb49b1ull, 0xffcc4a292ecad798ull, 0x87eb2bb2392dda58ull,
+		0x8f261f6dd123ddd2ull, 0xf7017ef6c6c4d012ull, 0x42a43f90dab54e3bull, 0x3a835e0bcd5243fbull,
+		0x2ef4dee77803c153ull, 0x56d3bf7c6fe4cc93ull, 0xe376fe1a739552baull, 0x9b519f8164725f7aull,
+		0x1cbab4335d5f8522ull, 0x649dd5a84ab888e2ull, 0xd13894ce56c916cbull, 0xa91ff555412e1b0bull,
+		0xbd6875b9f47f99a3ull, 0xc54f1422e3989463ull, 0x70ea5544ffe90a4aull, 0x08cd34dfe80e078aull,
+		0x98e15972803f9af7ull, 0xe0c638e997d89737ull, 0x5563798f8ba9091eull, 0x2d4418149c4e04deull,
+		0x393398f8291f8676ull, 0x4114f9633ef88bb6ull, 0xf4b1b8052289159full, 0x8c96d99e356e185full,
+		0x0b7df22c0c43c207ull, 0x735a93b71ba4cfc7ull, 0xc6ffd2d107d551eeull, 0xbed8b34a10325c2eull,
+		0xaaaf33a6a563de86ull, 0xd288523db284d346ull, 0x672d135baef54d6full, 0x1f0a72c0b91240afull,
+		0x17c7461f511c4725ull, 0x6fe0278446fb4ae5ull, 0xda4566e25a8ad4ccull, 0xa26207794d6dd90cull,
+		0xb6158795f83c5ba4ull, 0xce32e60eefdb5664ull, 0x7b97a768f3aac84dull, 0x03b0c6f3e44dc58dull,
+		0x845bed41dd601fd5ull, 0xfc7c8cdaca871215ull, 0x49d9cdbcd6f68c3cull, 0x31feac27c11181fcull,
+		0x25892ccb74400354ull, 0x5dae4d5063a70e94ull, 0xe80b0c367fd690bdull, 0x902c6dad68319d7dull,
+		0x99ddfb35c9a459dcull, 0xe1fa9aaede43541cull, 0x545fdbc8c232ca35ull, 0x2c78ba53d5d5c7f5ull,
+		0x380f3abf6084455dull, 0x40285b247763489dull, 0xf58d1a426b12d6b4ull, 0x8daa7bd97cf5db74ull,
+		0x0a41506b45d8012cull, 0x726631f0523f0cecull, 0xc7c370964e4e92c5ull, 0xbfe4110d59a99f05ull,
+		0xab9391e1ecf81dadull, 0xd3b4f07afb1f106dull, 0x6611b11ce76e8e44ull, 0x1e36d087f0898384ull,
+		0x16fbe4581887840eull, 0x6edc85c30f6089ceull, 0xdb79c4a5131117e7ull, 0xa35ea53e04f61a27ull,
+		0xb72925d2b1a7988full, 0xcf0e4449a640954full, 0x7aab052fba310b66ull, 0x028c64b4add606a6ull,
+		0x85674f0694fbdcfeull, 0xfd402e9d831cd13eull, 0x48e56ffb9f6d4f17ull, 0x30c20e60888a42d7ull,
+		0x24b58e8c3ddbc07full, 0x5c92ef172a3ccdbfull, 0xe937ae71364d5396ull, 0x9110cfea21aa5e56ull,
+		0x013ca247499bc32bull, 0x791bc3dc5e7cceebull, 0xccbe82ba420d50c2ull, 0xb499e32155ea5d02ull,
+		0xa0ee63cde0bbdfaaull, 0xd8c90256f75cd26aull, 0x6d6c4330eb2d4c43ull, 0x154b22abfcca4183ull,
+		0x92a00919c5e79bdbull, 0xea876882d200961bull, 0x5f2229e4ce710832ull, 0x2705487fd99605f2ull,
+		0x3372c8936cc7875aull, 0x4b55a9087b208a9aull, 0xfef0e86e675114b3ull, 0x86d789f570b61973ull,
+		0x8e1abd2a98b81ef9ull, 0xf63ddcb18f5f1339ull, 0x43989dd7932e8d10ull, 0x3bbffc4c84c980d0ull,
+		0x2fc87ca031980278ull, 0x57ef1d3b267f0fb8ull, 0xe24a5c5d3a0e9191ull, 0x9a6d3dc62de99c51ull,
+		0x1d86167414c44609ull, 0x65a177ef03234bc9ull, 0xd00436891f52d5e0ull, 0xa823571208b5d820ull,
+		0xbc54d7febde45a88ull, 0xc473b665aa035748ull, 0x71d6f703b672c961ull, 0x09f19698a195c4a1ull,
+		0x5ff939f9d101c84aull, 0x27de5862c6e6c58aull, 0x927b1904da975ba3ull, 0xea5c789fcd705663ull,
+		0xfe2bf8737821d4cbull, 0x860c99e86fc6d90bull, 0x33a9d88e73b74722ull, 0x4b8eb91564504ae2ull,
+		0xcc6592a75d7d90baull, 0xb442f33c4a9a9d7aull, 0x01e7b25a56eb0353ull, 0x79c0d3c1410c0e93ull,
+		0x6db7532df45d8c3bull, 0x159032b6e3ba81fbull, 0xa03573d0ffcb1fd2ull, 0xd812124be82c1212ull,
+		0xd0df269400221598ull, 0xa8f8470f17c51858ull, 0x1d5d06690bb48671ull, 0x657a67f21c538bb1ull,
+		0x710de71ea9020919ull, 0x092a8685bee504d9ull, 0xbc8fc7e3a2949af0ull, 0xc4a8a678b5739730ull,
+		0x43438dca8c5e4d68ull, 0x3b64ec519bb940a8ull, 0x8ec1ad3787c8de81ull, 0xf6e6ccac902fd341ull,
+		0xe2914c40257e51e9ull, 0x9ab62ddb32995c29ull, 0x2f136cbd2ee8c200ull, 0x57340d26390fcfc0ull,
+		0xc718608b513e52bdull, 0xbf3f011046d95f7dull, 0x0a9a40765aa8c154ull, 0x72bd21ed4d4fcc94ull,
+		0x66caa101f81e4e3cull, 0x1eedc09aeff943fcull, 0xab4881fcf388ddd5ull, 0xd36fe067e46fd015ull,
+		0x5484cbd5dd420a4dull, 0x2ca3aa4ecaa5078dull, 0x9906eb28d6d499a4ull, 0xe1218ab3c1339464ull,
+		0xf5560a5f746216ccull, 0x8d716bc463851b0cull, 0x38d42aa27ff48525ull, 0x40f34b39681388e5ull,
+		0x483e7fe6801d8f6full, 0x30191e7d97fa82afull, 0x85bc5f1b8b8b1c86ull, 0xfd9b3e809c6c1146ull,
+		0xe9ecbe6c293d93eeull, 0x91cbdff73eda9e2eull, 0x246e9e9122ab0007ull, 0x5c49ff0a354c0dc7ull,
+		0xdba2d4b80c61d79full, 0xa385b5231b86da5full, 0x1620f44507f74476ull, 0x6e0795de101049b6ull,
+		0x7a701532a541cb1eull, 0x025774a9b2a6c6deull, 0xb7f235cfaed758f7ull, 0xcfd55454b9305537ull,
+		0xc624c2cc18a59196ull, 0xbe03a3570f429c56ull, 0x0ba6e2311333027full, 0x738183aa04d40fbfull,
+		0x67f60346b1858d17ull, 0x1fd162dda66280d7ull, 0xaa7423bbba131efeull, 0xd2534220adf4133eull,
+		0x55b8699294d9c966ull, 0x2d9f0809833ec4a6ull, 0x983a496f9f4f5a8full, 0xe01d28f488a8574full,
+		0xf46aa8183df9d5e7ull, 0x8c4dc9832a1ed827ull, 0x39e888e5366f460eull, 0x41cfe97e21884bceull,
+		0x4902dda1c9864c44ull, 0x3125bc3ade614184ull, 0x8480fd5cc210dfadull, 0xfca79cc7d5f7d26dull,
+		0xe8d01c2b60a650c5ull, 0x90f77db077415d05ull, 0x25523cd66b30c32cull, 0x5d755d4d7cd7ceecull,
+		0xda9e76ff45fa14b4ull, 0xa2b91764521d1974ull, 0x171c56024e6c875dull, 0x6f3b3799598b8a9dull,
+		0x7b4cb775ecda0835ull, 0x036bd6eefb3d05f5ull, 0xb6ce9788e74c9bdcull, 0xcee9f613f0ab961cull,
+		0x5ec59bbe989a0b61ull, 0x26e2fa258f7d06a1ull, 0x9347bb43930c9888ull, 0xeb60dad884eb9548ull,
+		0xff175a3431ba17e0ull, 0x87303baf265d1a20ull, 0x32957ac93a2c8409ull, 0x4ab21b522dcb89c9ull,
+		0xcd5930e014e65391ull, 0xb57e517b03015e51ull, 0x00db101d1f70c078ull, 0x78fc71860897cdb8ull,
+		0x6c8bf16abdc64f10ull, 0x14ac90f1aa2142d0ull, 0xa109d197b650dcf9ull, 0xd92eb00ca1b7d139ull,
+		0xd1e384d349b9d6b3ull, 0xa9c4e5485e5edb73ull, 0x1c61a42e422f455aull, 0x6446c5b555c8489aull,
+		0x70314559e099ca32ull, 0x081624c2f77ec7f2ull, 0xbdb365a4eb0f59dbull, 0xc594043ffce8541bull,
+		0x427f2f8dc5c58e43ull, 0x3a584e16d2228383ull, 0x8ffd0f70ce531daaull, 0xf7da6eebd9b4106aull,
+		0xe3adee076ce592c2ull, 0x9b8a8f9c7b029f02ull, 0x2e2fcefa6773012bull, 0x5608af6170940cebull,
+	},
+	{
+		0x0000000000000000ull, 0x2c87c0b40c49b2efull, 0x30deb96bfef92782ull, 0x1c5979dff2b0956dull,
+		0xb4abd6ea5e716242ull, 0x982c165e5238d0adull, 0x84756f81a08845c0ull, 0xa8f2af35acc1f72full,
+		0x862bf27e78f0a78bull, 0xaaac32ca74b91564ull, 0xb6f54b1586098009ull, 0x9a728ba18a4032e6ull,
+		0x328024942681c5c9ull, 0x1e07e4202ac87726ull, 0x025e9dffd878e24bull, 0x2ed95d4bd43150a4ull,
+		0xcfac7ae239ba9ef6ull, 0xe32bba5635f32c19ull, 0xff72c389c743b974ull, 0xd3f5033dcb0a0b9bull,
+		0x7b07ac0867cbfcb4ull, 0x57806cbc6b824e5bull, 0x4bd915639932db36ull, 0x675ed5d7957b69d9ull,
+		0x4987889c414a397dull, 0x650048284d038b92ull, 0x795931f7bfb31effull, 0x55def143b3faac10ull,
+		0xfd2c5e761f3b5b3full, 0xd1ab9ec21372e9d0ull, 0xcdf2e71de1c27cbdull, 0xe17527a9ed8bce52ull,
+		0x0802cbf5a0805323ull, 0x24850b41acc9e1ccull, 0x38dc729e5e7974a1ull, 0x145bb22a5230c64eull,
+		0xbca91d1ffef13161ull, 0x902eddabf2b8838eull, 0x8c77a474000816e3ull, 0xa0f064c00c41a40cull,
+		0x8e29398bd870f4a8ull, 0xa2aef93fd4394647ull, 0xbef780e02689d32aull, 0x927040542ac061c5ull,
+		0x3a82ef61860196eaull, 0x16052fd58a482405ull, 0x0a5c560a78f8b168ull, 0x26db96be74b10387ull,
+		0xc7aeb117993acdd5ull, 0xeb2971a395737f3aull, 0xf770087c67c3ea57ull, 0xdbf7c8c86b8a58b8ull,
+		0x730567fdc74baf97ull, 0x5f82a749cb021d78ull, 0x43dbde9639b28815ull, 0x6f5c1e2235fb3afaull,
+		0x41854369e1ca6a5eull, 0x6d0283dded83d8b1ull, 0x715bfa021f334ddcull, 0x5ddc3ab6137aff33ull,
+		0xf52e9583bfbb081cull, 0xd9a95537b3f2baf3ull, 0xc5f02ce841422f9eull, 0xe977ec5c4d0b9d71ull,
+		0x910ee81e20b14135ull, 0xbd8928aa2cf8f3daull, 0xa1d05175de4866b7ull, 0x8d5791c1d201d458ull,
+		0x25a53ef47ec02377ull, 0x0922fe4072899198ull, 0x157b879f803904f5ull, 0x39fc472b8c70b61aull,
+		0x17251a605841e6beull, 0x3ba2dad454085451ull, 0x27fba30ba6b8c13cull, 0x0b7c63bfaaf173d3ull,
+		0xa38ecc8a063084fcull, 0x8f090c3e0a793613ull, 0x935075e1f8c9a37eull, 0xbfd7b555f4801191ull,
+		0x5ea292fc190bdfc3ull, 0x7225524815426d2cull, 0x6e7c2b97e7f2f841ull, 0x42fbeb23ebbb4aaeull,
+		0xea094416477abd81ull, 0xc68e84a24b330f6eull, 0xdad7fd7db9839a03ull, 0xf6503dc9b5ca28ecull,
+		0xd889608261fb7848ull, 0xf40ea0366db2caa7ull, 0xe857d9e99f025fcaull, 0xc4d0195d934bed25ull,
+		0x6c22b6683f8a1a0aull, 0x40a576dc33c3a8e5ull, 0x5cfc0f03c1733d88ull, 0x707bcfb7cd3a8f67ull,
+		0x990c23eb80311216ull, 0xb58be35f8c78a0f9ull, 0xa9d29a807ec83594ull, 0x85555a347281877bull,
+		0x2da7f501de407054ull, 0x012035b5d209c2bbull, 0x1d794c6a20b957d6ull, 0x31fe8cde2cf0e539ull,
+		0x1f27d195f8c1b59dull, 0x33a01121f4880772ull, 0x2ff968fe0638921full, 0x037ea84a0a7120f0ull,
+		0xab8c077fa6b0d7dfull, 0x870bc7cbaaf96530ull, 0x9b52be145849f05dull, 0xb7d57ea0540042b2ull,
+		0x56a05909b98b8ce0ull, 0x7a2799bdb5c23e0full, 0x667ee0624772ab62ull, 0x4af920d64b3b198dull,
+		0xe20b8fe3e7faeea2ull, 0xce8c4f57ebb35c4dull, 0xd2d536881903c920ull, 0xfe52f63c154a7bcfull,
+		0xd08bab77c17b2b6bull, 0xfc0c6bc3cd329984ull, 0xe055121c3f820ce9ull, 0xccd2d2a833cbbe06ull,
+		0x64207d9d9f0a4929ull, 0x48a7bd299343fbc6ull, 0x54fec4f661f36eabull, 0x787904426dbadc44ull,
+		0xcdddf4715cec947full, 0xe15a34c550a52690ull, 0xfd034d1aa215b3fdull, 0xd1848daeae5c0112ull,
+		0x7976229b029df63dull, 0x55f1e22f0ed444d2ull, 0x49a89bf0fc64d1bfull, 0x652f5b44f02d6350ull,
+		0x4bf6060f241c33f4ull, 0x6771c6bb2855811bull, 0x7b28bf64dae51476ull, 0x57af7fd0d6aca699ull,
+		0xff5dd0e57a6d51b6ull, 0xd3da10517624e359ull, 0xcf83698e84947634ull, 0xe304a93a88ddc4dbull,
+		0x02718e9365560a89ull, 0x2ef64e27691fb866ull, 0x32af37f89baf2d0bull, 0x1e28f74c97e69fe4ull,
+		0xb6da58793b2768cbull, 0x9a5d98cd376eda24ull, 0x8604e112c5de4f49ull, 0xaa8321a6c997fda6ull,
+		0x845a7ced1da6ad02ull, 0xa8ddbc5911ef1fedull, 0xb484c586e35f8a80ull, 0x98030532ef16386full,
+		0x30f1aa0743d7cf40ull, 0x1c766ab34f9e7dafull, 0x002f136cbd2ee8c2ull, 0x2ca8d3d8b1675a2dull,
+		0xc5df3f84fc6cc75cull, 0xe958ff30f02575b3ull, 0xf50186ef0295e0deull, 0xd986465b0edc5231ull,
+		0x7174e96ea21da51eull, 0x5df329daae5417f1ull, 0x41aa50055ce4829cull, 0x6d2d90b150ad3073ull,
+		0x43f4cdfa849c60d7ull, 0x6f730d4e88d5d238ull, 0x732a74917a654755ull, 0x5fadb425762cf5baull,
+		0xf75f1b10daed0295ull, 0xdbd8dba4d6a4b07aull, 0xc781a27b24142517ull, 0xeb0662cf285d97f8ull,
+		0x0a734566c5d659aaull, 0x26f485d2c99feb45ull, 0x3aadfc0d3b2f7e28ull, 0x162a3cb93766ccc7ull,
+		0xbed8938c9ba73be8ull, 0x925f533897ee8907ull, 0x8e062ae7655e1c6aull, 0xa281ea536917ae85ull,
+		0x8c58b718bd26fe21ull, 0xa0df77acb16f4cceull, 0xbc860e7343dfd9a3ull, 0x9001cec74f966b4cull,
+		0x38f361f2e3579c63ull, 0x1474a146ef1e2e8cull, 0x082dd8991daebbe1ull, 0x24aa182d11e7090eull,
+		0x5cd31c6f7c5dd54aull, 0x7054dcdb701467a5ull, 0x6c0da50482a4f2c8ull, 0x408a65b08eed4027ull,
+		0xe878ca85222cb708ull, 0xc4ff0a312e6505e7ull, 0xd8a673eedcd5908aull, 0xf421b35ad09c2265ull,
+		0xdaf8ee1104ad72c1ull, 0xf67f2ea508e4c02eull, 0xea26577afa545543ull, 0xc6a197cef61de7acull,
+		0x6e5338fb5adc1083ull, 0x42d4f84f5695a26cull, 0x5e8d8190a4253701ull, 0x720a4124a86c85eeull,
+		0x937f668d45e74bbcull, 0xbff8a63949aef953ull, 0xa3a1dfe6bb1e6c3eull, 0x8f261f52b757ded1ull,
+		0x27d4b0671b9629feull, 0x0b5370d317df9b11ull, 0x170a090ce56f0e7cull, 0x3b8dc9b8e926bc93ull,
+		0x155494f33d17ec37ull, 0x39d35447315e5ed8ull, 0x258a2d98c3eecbb5ull, 0x090ded2ccfa7795aull,
+		0xa1ff421963668e75ull, 0x8d7882ad6f2f3c9aull, 0x9121fb729d9fa9f7ull, 0xbda63bc691d61b18ull,
+		0x54d1d79adcdd8669ull, 0x7856172ed0943486ull, 0x640f6ef12224a1ebull, 0x4888ae452e6d1304ull,
+		0xe07a017082ace42bull, 0xccfdc1c48ee556c4ull, 0xd0a4b81b7c55c3a9ull, 0xfc2378af701c7146ull,
+		0xd2fa25e4a42d21e2ull, 0xfe7de550a864930dull, 0xe2249c8f5ad40660ull, 0xcea35c3b569db48full,
+		0x6651f30efa5c43a0ull, 0x4ad633baf615f14full, 0x568f4a6504a56422ull, 0x7a088ad108ecd6cdull,
+		0x9b7dad78e567189full, 0xb7fa6dcce92eaa70ull, 0xaba314131b9e3f1dull, 0x8724d4a717d78df2ull,
+		0x2fd67b92bb167addull, 0x0351bb26b75fc832ull, 0x1f08c2f945ef5d5full, 0x338f024d49a6efb0ull,
+		0x1d565f069d97bf14ull, 0x31d19fb291de0dfbull, 0x2d88e66d636e9896ull, 0x010f26d96f272a79ull,
+		0xa9fd89ecc3e6dd56ull, 0x857a4958cfaf6fb9ull, 0x992330873d1ffad4ull, 0xb5a4f0333156483bull,
+	},
+	{
+		0x0000000000000000ull, 0xfced1919ea68795aull, 0x732bf8ae4518e0ccull, 0x8fc6e1b7af709996ull,
+		0x5f506a1453e63d6bull, 0xa3bd730db98e4431ull, 0x2c7b92ba16fedda7ull, 0xd0968ba3fc96a4fdull,
+		0xa30b2084e5f10661ull, 0x5fe6399d0f997f3bull, 0xd020d82aa0e9e6adull, 0x2ccdc1334a819ff7ull,
+		0xfc5b4a90b6173b0aull, 0x00b653895c7f4250ull, 0x8f70b23ef30fdbc6ull, 0x739dab271967a29cull,
+		0x4aa5673d99d3e0b4ull, 0xb6487e2473bb99eeull, 0x398e9f93dccb0078ull, 0xc563868a36a37922ull,
+		0x15f50d29ca35dddfull, 0xe9181430205da485ull, 0x66def5878f2d3d13ull, 0x9a33ec9e65454449ull,
+		0xe9ae47b97c22e6d5ull, 0x15435ea0964a9f8full, 0x9a85bf17393a0619ull, 0x6668a60ed3527f43ull,
+		0xb6fe2dad2fc4dbbeull, 0x4a1334b4c5aca2e4ull, 0xc5d5d5036adc3b72ull, 0x3938cc1a80b44228ull,
+		0x0b63d1082e5dd038ull, 0xf78ec811c435a962ull, 0x784829a66b4530f4ull, 0x84a530bf812d49aeull,
+		0x5433bb1c7dbbed53ull, 0xa8dea20597d39409ull, 0x271843b238a30d9full, 0xdbf55aabd2cb74c5ull,
+		0xa868f18ccbacd659ull, 0x5485e89521c4af03ull, 0xdb4309228eb43695ull, 0x27ae103b64dc4fcfull,
+		0xf7389b98984aeb32ull, 0x0bd5828172229268ull, 0x84136336dd520bfeull, 0x78fe7a2f373a72a4ull,
+		0x41c6b635b78e308cull, 0xbd2baf2c5de649d6ull, 0x32ed4e9bf296d040ull, 0xce00578218fea91aull,
+		0x1e96dc21e4680de7ull, 0xe27bc5380e0074bdull, 0x6dbd248fa170ed2bull, 0x91503d964b189471ull,
+		0xe2cd96b1527f36edull, 0x1e208fa8b8174fb7ull, 0x91e66e1f1767d621ull, 0x6d0b7706fd0faf7bull,
+		0xbd9dfca501990b86ull, 0x4170e5bcebf172dcull, 0xceb6040b4481eb4aull, 0x325b1d12aee99210ull,
+		0xa115004608aae53cull, 0x5df8195fe2c29c66ull, 0xd23ef8e84db205f0ull, 0x2ed3e1f1a7da7caaull,
+		0xfe456a525b4cd857ull, 0x02a8734bb124a10dull, 0x8d6e92fc1e54389bull, 0x71838be5f43c41c1ull,
+		0x021e20c2ed5be35dull, 0xfef339db07339a07ull, 0x7135d86ca8430391ull, 0x8dd8c175422b7acbull,
+		0x5d4e4ad6bebdde36ull, 0xa1a353cf54d5a76cull, 0x2e65b278fba53efaull, 0xd288ab6111cd47a0ull,
+		0xebb0677b91790588ull, 0x175d7e627b117cd2ull, 0x989b9fd5d461e544ull, 0x647686cc3e099c1eull,
+		0xb4e00d6fc29f38e3ull, 0x480d147628f741b9ull, 0xc7cbf5c18787d82full, 0x3b26ecd86defa175ull,
+		0x48bb47ff748803e9ull, 0xb4565ee69ee07ab3ull, 0x3b90bf513190e325ull, 0xc77da648dbf89a7full,
+		0x17eb2deb276e3e82ull, 0xeb0634f2cd0647d8ull, 0x64c0d5456276de4eull, 0x982dcc5c881ea714ull,
+		0xaa76d14e26f73504ull, 0x569bc857cc9f4c5eull, 0xd95d29e063efd5c8ull, 0x25b030f98987ac92ull,
+		0xf526bb5a7511086full, 0x09cba2439f797135ull, 0x860d43f43009e8a3ull, 0x7ae05aedda6191f9ull,
+		0x097df1cac3063365ull, 0xf590e8d3296e4a3full, 0x7a560964861ed3a9ull, 0x86bb107d6c76aaf3ull,
+		0x562d9bde90e00e0eull, 0xaac082c77a887754ull, 0x25066370d5f8eec2ull, 0xd9eb7a693f909798ull,
+		0xe0d3b673bf24d5b0ull, 0x1c3eaf6a554caceaull, 0x93f84eddfa3c357cull, 0x6f1557c410544c26ull,
+		0xbf83dc67ecc2e8dbull, 0x436ec57e06aa9181ull, 0xcca824c9a9da0817ull, 0x30453dd043b2714dull,
+		0x43d896f75ad5d3d1ull, 0xbf358feeb0bdaa8bull, 0x30f36e591fcd331dull, 0xcc1e7740f5a54a47ull,
+		0x1c88fce30933eebaull, 0xe065e5fae35b97e0ull, 0x6fa3044d4c2b0e76ull, 0x934e1d54a643772cull,
+		0x6ccbde12c2eb2d5eull, 0x9026c70b28835404ull, 0x1fe026bc87f3cd92ull, 0xe30d3fa56d9bb4c8ull,
+		0x339bb406910d1035ull, 0xcf76ad1f7b65696full, 0x40b04ca8d415f0f9ull, 0xbc5d55b13e7d89a3ull,
+		0xcfc0fe96271a2b3full, 0x332de78fcd725265ull, 0xbceb06386202cbf3ull, 0x40061f21886ab2a9ull,
+		0x9090948274fc1654ull, 0x6c7d8d9b9e946f0eull, 0xe3bb6c2c31e4f698ull, 0x1f567535db8c8fc2ull,
+		0x266eb92f5b38cdeaull, 0xda83a036b150b4b0ull, 0x554541811e202d26ull, 0xa9a85898f448547cull,
+		0x793ed33b08def081ull, 0x85d3ca22e2b689dbull, 0x0a152b954dc6104dull, 0xf6f8328ca7ae6917ull,
+		0x856599abbec9cb8bull, 0x798880b254a1b2d1ull, 0xf64e6105fbd12b47ull, 0x0aa3781c11b9521dull,
+		0xda35f3bfed2ff6e0ull, 0x26d8eaa607478fbaull, 0xa91e0b11a837162cull, 0x55f31208425f6f76ull,
+		0x67a80f1aecb6fd66ull, 0x9b45160306de843cull, 0x1483f7b4a9ae1daaull, 0xe86eeead43c664f0ull,
+		0x38f8650ebf50c00dull, 0xc4157c175538b957ull, 0x4bd39da0fa4820c1ull, 0xb73e84b91020599bull,
+		0xc4a32f9e0947fb07ull, 0x384e3687e32f825dull, 0xb788d7304c5f1bcbull, 0x4b65ce29a6376291ull,
+		0x9bf3458a5aa1c66cull, 0x671e5c93b0c9bf36ull, 0xe8d8bd241fb926a0ull, 0x1435a43df5d15ffaull,
+		0x2d0d682775651dd2ull, 0xd1e0713e9f0d6488ull, 0x5e269089307dfd1eull, 0xa2cb8990da158444ull,
+		0x725d0233268320b9ull, 0x8eb01b2acceb59e3ull, 0x0176fa9d639bc075ull, 0xfd9be38489f3b92full,
+		0x8e0648a390941bb3ull, 0x72eb51ba7afc62e9ull, 0xfd2db00dd58cfb7full, 0x01c0a9143fe48225ull,
+		0xd15622b7c37226d8ull, 0x2dbb3bae291a5f82ull, 0xa27dda19866ac614ull, 0x5e90c3006c02bf4eull,
+		0xcddede54ca41c862ull, 0x3133c74d2029b138ull, 0xbef526fa8f5928aeull, 0x42183fe3653151f4ull,
+		0x928eb44099a7f509ull, 0x6e63ad5973cf8c53ull, 0xe1a54ceedcbf15c5ull, 0x1d4855f736d76c9full,
+		0x6ed5fed02fb0ce03ull, 0x9238e7c9c5d8b759ull, 0x1dfe067e6aa82ecfull, 0xe1131f6780c05795ull,
+		0x318594c47c56f368ull, 0xcd688ddd963e8a32ull, 0x42ae6c6a394e13a4ull, 0xbe437573d3266afeull,
+		0x877bb969539228d6ull, 0x7b96a070b9fa518cull, 0xf45041c7168ac81aull, 0x08bd58defce2b140ull,
+		0xd82bd37d007415bdull, 0x24c6ca64ea1c6ce7ull, 0xab002bd3456cf571ull, 0x57ed32caaf048c2bull,
+		0x247099edb6632eb7ull, 0xd89d80f45c0b57edull, 0x575b6143f37bce7bull, 0xabb6785a1913b721ull,
+		0x7b20f3f9e58513dcull, 0x87cdeae00fed6a86ull, 0x080b0b57a09df310ull, 0xf4e6124e4af58a4aull,
+		0xc6bd0f5ce41c185aull, 0x3a5016450e746100ull, 0xb596f7f2a104f896ull, 0x497beeeb4b6c81ccull,
+		0x99ed6548b7fa2531ull, 0x65007c515d925c6bull, 0xeac69de6f2e2c5fdull, 0x162b84ff188abca7ull,
+		0x65b62fd801ed1e3bull, 0x995b36c1eb856761ull, 0x169dd77644f5fef7ull, 0xea70ce6fae9d87adull,
+		0x3ae645cc520b2350ull, 0xc60b5cd5b8635a0aull, 0x49cdbd621713c39cull, 0xb520a47bfd7bbac6ull,
+		0x8c1868617dcff8eeull, 0x70f5717897a781b4ull, 0xff3390cf38d71822ull, 0x03de89d6d2bf6178ull,
+		0xd34802752e29c585ull, 0x2fa51b6cc441bcdfull, 0xa063fadb6b312549ull, 0x5c8ee3c281595c13ull,
+		0x2f1348e5983efe8full, 0xd3fe51fc725687d5ull, 0x5c38b04bdd261e43ull, 0xa0d5a952374e6719ull,
+		0x704322f1cbd8c3e4ull, 0x8cae3be821b0babeull, 0x0368da5f8ec02328ull, 0xff85c34664a85a72ull,
+	},
+	{
+		0x0000000000000000ull, 0xab4398ae2c367821ull, 0xf7d966e22bdc7863ull, 0x5c9afe4c07ea0042ull,
+		0x43574d3639474ec7ull, 0xe814d598157136e6ull, 0xb48e2bd4129b36a4ull, 0x1fcdb37a3ead4e85ull,
+		0x542c1921e6a0ed64ull, 0xff6f818fca969545ull, 0xa3f57fc3cd7c9507ull, 0x08b6e76de14aed26ull,
+		0x177b5417dfe7a3a3ull, 0xbc38ccb9f3d1db82ull, 0xe0a232f5f43bdbc0ull, 0x4be1aa5bd80da3e1ull,
+		0x15c4afe2ffcbc5c3ull, 0xbe87374cd3fdbde2ull, 0xe21dc900d417bda0ull, 0x495e51aef821c581ull,
+		0x5693e2d4c68c8b04ull, 0xfdd07a7aeabaf325ull, 0xa14a8436ed50f367ull, 0x0a091c98c1668b46ull,
+		0x41e8b6c3196b28a7ull, 0xeaab2e6d355d5086ull, 0xb631d02132b750c4ull, 0x1d72488f1e8128e5ull,
+		0x02bffbf5202c6660ull, 0xa9fc635b0c1a1e41ull, 0xf5669d170bf01e03ull, 0x5e2505b927c66622ull,
+		0x382a265ba5890a5full, 0x9369bef589bf727eull, 0xcff340b98e55723cull, 0x64b0d817a2630a1dull,
+		0x7b7d6b6d9cce4498ull, 0xd03ef3c3b0f83cb9ull, 0x8ca40d8fb7123cfbull, 0x27e795219b2444daull,
+		0x6c063f7a4329e73bull, 0xc745a7d46f1f9f1aull, 0x9bdf599868f59f58ull, 0x309cc13644c3e779ull,
+		0x2f51724c7a6ea9fcull, 0x8412eae25658d1ddull, 0xd88814ae51b2d19full, 0x73cb8c007d84a9beull,
+		0x2dee89b95a42cf9cull, 0x86ad11177674b7bdull, 0xda37ef5b719eb7ffull, 0x717477f55da8cfdeull,
+		0x6eb9c48f6305815bull, 0xc5fa5c214f33f97aull, 0x9960a26d48d9f938ull, 0x32233ac364ef8119ull,
+		0x79c29098bce222f8ull, 0xd281083690d45ad9ull, 0x8e1bf67a973e5a9bull, 0x25586ed4bb0822baull,
+		0x3a95ddae85a56c3full, 0x91d64500a993141eull, 0xcd4cbb4cae79145cull, 0x660f23e2824f6c7dull,
+		0x71b336cfe5ed11b5ull, 0xdaf0ae61c9db6994ull, 0x866a502dce3169d6ull, 0x2d29c883e20711f7ull,
+		0x32e47bf9dcaa5f72ull, 0x99a7e357f09c2753ull, 0xc53d1d1bf7762711ull, 0x6e7e85b5db405f30ull,
+		0x259f2fee034dfcd1ull, 0x8edcb7402f7b84f0ull, 0xd246490c289184b2ull, 0x7905d1a204a7fc93ull,
+		0x66c862d83a0ab216ull, 0xcd8bfa76163cca37ull, 0x9111043a11d6ca75ull, 0x3a529c943de0b254ull,
+		0x6477992d1a26d476ull, 0xcf3401833610ac57ull, 0x93aeffcf31faac15ull, 0x38ed67611dccd434ull,
+		0x2720d41b23619ab1ull, 0x8c634cb50f57e290ull, 0xd0f9b2f908bde2d2ull, 0x7bba2a57248b9af3ull,
+		0x305b800cfc863912ull, 0x9b1818a2d0b04133ull, 0xc782e6eed75a4171ull, 0x6cc17e40fb6c3950ull,
+		0x730ccd3ac5c177d5ull, 0xd84f5594e9f70ff4ull, 0x84d5abd8ee1d0fb6ull, 0x2f963376c22b7797ull,
+		0x4999109440641beaull, 0xe2da883a6c5263cbull, 0xbe4076766bb86389ull, 0x1503eed8478e1ba8ull,
+		0x0ace5da27923552dull, 0xa18dc50c55152d0cull, 0xfd173b4052ff2d4eull, 0x5654a3ee7ec9556full,
+		0x1db509b5a6c4f68eull, 0xb6f6911b8af28eafull, 0xea6c6f578d188eedull, 0x412ff7f9a12ef6ccull,
+		0x5ee244839f83b849ull, 0xf5a1dc2db3b5c068ull, 0xa93b2261b45fc02aull, 0x0278bacf9869b80bull,
+		0x5c5dbf76bfafde29ull, 0xf71e27d89399a608ull, 0xab84d9949473a64aull, 0x00c7413ab845de6bull,
+		0x1f0af24086e890eeull, 0xb4496aeeaadee8cfull, 0xe8d394a2ad34e88dull, 0x43900c0c810290acull,
+		0x0871a657590f334dull, 0xa3323ef975394b6cull, 0xffa8c0b572d34b2eull, 0x54eb581b5ee5330full,
+		0x4b26eb6160487d8aull, 0xe06573cf4c7e05abull, 0xbcff8d834b9405e9ull, 0x17bc152d67a27dc8ull,
+		0xe2e0d82c295c17aaull, 0x49a34082056a6f8bull, 0x1539bece02806fc9ull, 0xbe7a26602eb617e8ull,
+		0xa1b7951a101b596dull, 0x0af40db43c2d214cull, 0x566ef3f83bc7210eull, 0xfd2d6b5617f1592full,
+		0xb6ccc10dcffcfaceull, 0x1d8f59a3e3ca82efull, 0x4115a7efe42082adull, 0xea563f41c816fa8cull,
+		0xf59b8c3bf6bbb409ull, 0x5ed81495da8dcc28ull, 0x0242ead9dd67cc6aull, 0xa9017277f151b44bull,
+		0xf72477ced697d269ull, 0x5c67ef60faa1aa48ull, 0x00fd112cfd4baa0aull, 0xabbe8982d17dd22bull,
+		0xb4733af8efd09caeull, 0x1f30a256c3e6e48full, 0x43aa5c1ac40ce4cdull, 0xe8e9c4b4e83a9cecull,
+		0xa3086eef30373f0dull, 0x084bf6411c01472cull, 0x54d1080d1beb476eull, 0xff9290a337dd3f4full,
+		0xe05f23d9097071caull, 0x4b1cbb77254609ebull, 0x1786453b22ac09a9ull, 0xbcc5dd950e9a7188ull,
+		0xdacafe778cd51df5ull, 0x718966d9a0e365d4ull, 0x2d139895a7096596ull, 0x8650003b8b3f1db7ull,
+		0x999db341b5925332ull, 0x32de2bef99a42b13ull, 0x6e44d5a39e4e2b51ull, 0xc5074d0db2785370ull,
+		0x8ee6e7566a75f091ull, 0x25a57ff8464388b0ull, 0x793f81b441a988f2ull, 0xd27c191a6d9ff0d3ull,
+		0xcdb1aa605332be56ull, 0x66f232ce7f04c677ull, 0x3a68cc8278eec635ull, 0x912b542c54d8be14ull,
+		0xcf0e5195731ed836ull, 0x644dc93b5f28a017ull, 0x38d7377758c2a055ull, 0x9394afd974f4d874ull,
+		0x8c591ca34a5996f1ull, 0x271a840d666feed0ull, 0x7b807a416185ee92ull, 0xd0c3e2ef4db396b3ull,
+		0x9b2248b495be3552ull, 0x3061d01ab9884d73ull, 0x6cfb2e56be624d31ull, 0xc7b8b6f892543510ull,
+		0xd8750582acf97b95ull, 0x73369d2c80cf03b4ull, 0x2fac6360872503f6ull, 0x84effbceab137bd7ull,
+		0x9353eee3ccb1061full, 0x3810764de0877e3eull, 0x648a8801e76d7e7cull, 0xcfc910afcb5b065dull,
+		0xd004a3d5f5f648d8ull, 0x7b473b7bd9c030f9ull, 0x27ddc537de2a30bbull, 0x8c9e5d99f21c489aull,
+		0xc77ff7c22a11eb7bull, 0x6c3c6f6c0627935aull, 0x30a6912001cd9318ull, 0x9be5098e2dfbeb39ull,
+		0x8428baf41356a5bcull, 0x2f6b225a3f60dd9dull, 0x73f1dc16388adddfull, 0xd8b244b814bca5feull,
+		0x86974101337ac3dcull, 0x2dd4d9af1f4cbbfdull, 0x714e27e318a6bbbfull, 0xda0dbf4d3490c39eull,
+		0xc5c00c370a3d8d1bull, 0x6e839499260bf53aull, 0x32196ad521e1f578ull, 0x995af27b0dd78d59ull,
+		0xd2bb5820d5da2eb8ull, 0x79f8c08ef9ec5699ull, 0x25623ec2fe0656dbull, 0x8e21a66cd2302efaull,
+		0x91ec1516ec9d607full, 0x3aaf8db8c0ab185eull, 0x663573f4c741181cull, 0xcd76eb5aeb77603dull,
+		0xab79c8b869380c40ull, 0x003a5016450e7461ull, 0x5ca0ae5a42e47423ull, 0xf7e336f46ed20c02ull,
+		0xe82e858e507f4287ull, 0x436d1d207c493aa6ull, 0x1ff7e36c7ba33ae4ull, 0xb4b47bc2579542c5ull,
+		0xff55d1998f98e124ull, 0x54164937a3ae9905ull, 0x088cb77ba4449947ull, 0xa3cf2fd58872e166ull,
+		0xbc029cafb6dfafe3ull, 0x174104019ae9d7c2ull, 0x4bdbfa4d9d03d780ull, 0xe09862e3b135afa1ull,
+		0xbebd675a96f3c983ull, 0x15fefff4bac5b1a2ull, 0x496401b8bd2fb1e0ull, 0xe22799169119c9c1ull,
+		0xfdea2a6cafb48744ull, 0x56a9b2c28382ff65ull, 0x0a334c8e8468ff27ull, 0xa170d420a85e8706ull,
+		0xea917e7b705324e7ull, 0x41d2e6d55c655cc6ull, 0x1d4818995b8f5c84ull, 0xb60b803777b924a5ull,
+		0xa9c6334d49146a20ull, 0x0285abe365221201ull, 0x5e1f55af62c81243ull, 0xf55ccd014efe6a62ull,
+	},
+	{
+		0x0000000000000000ull, 0x8e21538c26050b35ull, 0xd19908b0d3baad3cull, 0x5fb85b3cf5bfa609ull,
+		0xa29ef4e1551ba5c6ull, 0x2cbfa76d731eaef3ull, 0x7307fc5186a108faull, 0xfd26afdda0a403cfull,
+		0x5f18b9b6e40b66c3ull, 0xd139ea3ac20e6df6ull, 0x8e81b10637b1cbffull, 0x00a0e28a11b4c0caull,
+		0xfd864d57b110c305ull, 0x73a71edb9715c830ull, 0x2c1f45e762aa6e39ull, 0xa23e166b44af650cull,
+		0xebfb01468f9fc592ull, 0x65da52caa99acea7ull, 0x3a6209f65c2568aeull, 0xb4435a7a7a20639bull,
+		0x4965f5a7da846054ull, 0xc744a62bfc816b61ull, 0x98fcfd17093ecd68ull, 0x16ddae9b2f3bc65dull,
+		0xb4e3b8f06b94a351ull, 0x3ac2eb7c4d91a864ull, 0x657ab040b82e0e6dull, 0xeb5be3cc9e2b0558ull,
+		0x167d4c113e8f0697ull, 0x985c1f9d188a0da2ull, 0xc7e444a1ed35ababull, 0x49c5172dcb30a09eull,
+		0xa044d83fc9d1431eull, 0x2e658bb3efd4482bull, 0x71ddd08f1a6bee22ull, 0xfffc83033c6ee517ull,
+		0x02da2cde9ccae6d8ull, 0x8cfb7f52bacfededull, 0xd343246e4f704be4ull, 0x5d6277e2697540d1ull,
+		0xff5c61892dda25ddull, 0x717d32050bdf2ee8ull, 0x2ec56939fe6088e1ull, 0xa0e43ab5d86583d4ull,
+		0x5dc2956878c1801bull, 0xd3e3c6e45ec48b2eull, 0x8c5b9dd8ab7b2d27ull, 0x027ace548d7e2612ull,
+		0x4bbfd979464e868cull, 0xc59e8af5604b8db9ull, 0x9a26d1c995f42bb0ull, 0x14078245b3f12085ull,
+		0xe9212d981355234aull, 0x67007e143550287full, 0x38b82528c0ef8e76ull, 0xb69976a4e6ea8543ull,
+		0x14a760cfa245e04full, 0x9a8633438440eb7aull, 0xc53e687f71ff4d73ull, 0x4b1f3bf357fa4646ull,
+		0xb639942ef75e4589ull, 0x3818c7a2d15b4ebcull, 0x67a09c9e24e4e8b5ull, 0xe981cf1202e1e380ull,
+		0x570f5858a45dcda1ull, 0xd92e0bd48258c694ull, 0x869650e877e7609dull, 0x08b7036451e26ba8ull,
+		0xf591acb9f1466867ull, 0x7bb0ff35d7436352ull, 0x2408a40922fcc55bull, 0xaa29f78504f9ce6eull,
+		0x0817e1ee4056ab62ull, 0x8636b2626653a057ull, 0xd98ee95e93ec065eull, 0x57afbad2b5e90d6bull,
+		0xaa89150f154d0ea4ull, 0x24a8468333480591ull, 0x7b101dbfc6f7a398ull, 0xf5314e33e0f2a8adull,
+		0xbcf4591e2bc20833ull, 0x32d50a920dc70306ull, 0x6d6d51aef878a50full, 0xe34c0222de7dae3aull,
+		0x1e6aadff7ed9adf5ull, 0x904bfe7358dca6c0ull, 0xcff3a54fad6300c9ull, 0x41d2f6c38b660bfcull,
+		0xe3ece0a8cfc96ef0ull, 0x6dcdb324e9cc65c5ull, 0x3275e8181c73c3ccull, 0xbc54bb943a76c8f9ull,
+		0x417214499ad2cb36ull, 0xcf5347c5bcd7c003ull, 0x90eb1cf94968660aull, 0x1eca4f756f6d6d3full,
+		0xf74b80676d8c8ebfull, 0x796ad3eb4b89858aull, 0x26d288d7be362383ull, 0xa8f3db5b983328b6ull,
+		0x55d5748638972b79ull, 0xdbf4270a1e92204cull, 0x844c7c36eb2d8645ull, 0x0a6d2fbacd288d70ull,
+		0xa85339d18987e87cull, 0x26726a5daf82e349ull, 0x79ca31615a3d4540ull, 0xf7eb62ed7c384e75ull,
+		0x0acdcd30dc9c4dbaull, 0x84ec9ebcfa99468full, 0xdb54c5800f26e086ull, 0x5575960c2923ebb3ull,
+		0x1cb08121e2134b2dull, 0x9291d2adc4164018ull, 0xcd29899131a9e611ull, 0x4308da1d17aced24ull,
+		0xbe2e75c0b708eeebull, 0x300f264c910de5deull, 0x6fb77d7064b243d7ull, 0xe1962efc42b748e2ull,
+		0x43a8389706182deeull, 0xcd896b1b201d26dbull, 0x92313027d5a280d2ull, 0x1c1063abf3a78be7ull,
+		0xe136cc7653038828ull, 0x6f179ffa7506831dull, 0x30afc4c680b92514ull, 0xbe8e974aa6bc2e21ull,
+		0x2de5fbba3f89979cull, 0xa3c4a836198c9ca9ull, 0xfc7cf30aec333aa0ull, 0x725da086ca363195ull,
+		0x8f7b0f5b6a92325aull, 0x015a5cd74c97396full, 0x5ee207ebb9289f66ull, 0xd0c354679f2d9453ull,
+		0x72fd420cdb82f15full, 0xfcdc1180fd87fa6aull, 0xa3644abc08385c63ull, 0x2d4519302e3d5756ull,
+		0xd063b6ed8e995499ull, 0x5e42e561a89c5facull, 0x01fabe5d5d23f9a5ull, 0x8fdbedd17b26f290ull,
+		0xc61efafcb016520eull, 0x483fa9709613593bull, 0x1787f24c63acff32ull, 0x99a6a1c045a9f407ull,
+		0x64800e1de50df7c8ull, 0xeaa15d91c308fcfdull, 0xb51906ad36b75af4ull, 0x3b38552110b251c1ull,
+		0x9906434a541d34cdull, 0x172710c672183ff8ull, 0x489f4bfa87a799f1ull, 0xc6be1876a1a292c4ull,
+		0x3b98b7ab0106910bull, 0xb5b9e42727039a3eull, 0xea01bf1bd2bc3c37ull, 0x6420ec97f4b93702ull,
+		0x8da12385f658d482ull, 0x03807009d05ddfb7ull, 0x5c382b3525e279beull, 0xd21978b903e7728bull,
+		0x2f3fd764a3437144ull, 0xa11e84e885467a71ull, 0xfea6dfd470f9dc78ull, 0x70878c5856fcd74dull,
+		0xd2b99a331253b241ull, 0x5c98c9bf3456b974ull, 0x03209283c1e91f7dull, 0x8d01c10fe7ec1448ull,
+		0x70276ed247481787ull, 0xfe063d5e614d1cb2ull, 0xa1be666294f2babbull, 0x2f9f35eeb2f7b18eull,
+		0x665a22c379c71110ull, 0xe87b714f5fc21a25ull, 0xb7c32a73aa7dbc2cull, 0x39e279ff8c78b719ull,
+		0xc4c4d6222cdcb4d6ull, 0x4ae585ae0ad9bfe3ull, 0x155dde92ff6619eaull, 0x9b7c8d1ed96312dfull,
+		0x39429b759dcc77d3ull, 0xb763c8f9bbc97ce6ull, 0xe8db93c54e76daefull, 0x66fac0496873d1daull,
+		0x9bdc6f94c8d7d215ull, 0x15fd3c18eed2d920ull, 0x4a4567241b6d7f29ull, 0xc46434a83d68741cull,
+		0x7aeaa3e29bd45a3dull, 0xf4cbf06ebdd15108ull, 0xab73ab52486ef701ull, 0x2552f8de6e6bfc34ull,
+		0xd8745703cecffffbull, 0x5655048fe8caf4ceull, 0x09ed5fb31d7552c7ull, 0x87cc0c3f3b7059f2ull,
+		0x25f21a547fdf3cfeull, 0xabd349d859da37cbull, 0xf46b12e4ac6591c2ull, 0x7a4a41688a609af7ull,
+		0x876ceeb52ac49938ull, 0x094dbd390cc1920dull, 0x56f5e605f97e3404ull, 0xd8d4b589df7b3f31ull,
+		0x9111a2a4144b9fafull, 0x1f30f128324e949aull, 0x4088aa14c7f13293ull, 0xcea9f998e1f439a6ull,
+		0x338f564541503a69ull, 0xbdae05c96755315cull, 0xe2165ef592ea9755ull, 0x6c370d79b4ef9c60ull,
+		0xce091b12f040f96cull, 0x4028489ed645f259ull, 0x1f9013a223fa5450ull, 0x91b1402e05ff5f65ull,
+		0x6c97eff3a55b5caaull, 0xe2b6bc7f835e579full, 0xbd0ee74376e1f196ull, 0x332fb4cf50e4faa3ull,
+		0xdaae7bdd52051923ull, 0x548f285174001216ull, 0x0b37736d81bfb41full, 0x851620e1a7babf2aull,
+		0x78308f3c071ebce5ull, 0xf611dcb0211bb7d0ull, 0xa9a9878cd4a411d9ull, 0x2788d400f2a11aecull,
+		0x85b6c26bb60e7fe0ull, 0x0b9791e7900b74d5ull, 0x542fcadb65b4d2dcull, 0xda0e995743b1d9e9ull,
+		0x2728368ae315da26ull, 0xa9096506c510d113ull, 0xf6b13e3a30af771aull, 0x78906db616aa7c2full,
+		0x31557a9bdd9adcb1ull, 0xbf742917fb9fd784ull, 0xe0cc722b0e20718dull, 0x6eed21a728257ab8ull,
+		0x93cb8e7a88817977ull, 0x1deaddf6ae847242ull, 0x425286ca5b3bd44bull, 0xcc73d5467d3edf7eull,
+		0x6e4dc32d3991ba72ull, 0xe06c90a11f94b147ull, 0xbfd4cb9dea2b174eull, 0x31f59811cc2e1c7bull,
+		0xccd337cc6c8a1fb4ull, 0x42f264404a8f1481ull, 0x1d4a3f7cbf30b288ull, 0x936b6cf09935b9bdull,
+	},
+	{
+		0x0000000000000000ull, 0xa10a2ffd9aac5176ull, 0x71c3bac7133601fdull, 0xd0c9953a899a508bull,
+		0xe08fdcb32b9dcfbeull, 0x4185f34eb1319ec8ull, 0x914c667438abce43ull, 0x30464989a2079f35ull,
+		0xebb1dd50db840531ull, 0x4abbf2ad41285447ull, 0x9a726797c8b204ccull, 0x3b78486a521e55baull,
+		0x0b3e01e3f019ca8full, 0xaa342e1e6ab59bf9ull, 0x7afdbb24e32fcb72ull, 0xdbf794d979839a04ull,
+		0x15cda5e9f88803c1ull, 0xb4c78a14622452b7ull, 0x640e1f2eebbe023cull, 0xc50430d37112534aull,
+		0xf542795ad315cc7full, 0x544856a749b99d09ull, 0x8481c39dc023cd82ull, 0x258bec605a8f9cf4ull,
+		0xfe7c78b9230c06f0ull, 0x5f765744b9a05786ull, 0x8fbfc27e303a070dull, 0x2eb5ed83aa96567bull,
+		0x1ef3a40a0891c94eull, 0xbff98bf7923d9838ull, 0x6f301ecd1ba7c8b3ull, 0xce3a3130810b99c5ull,
+		0x3829553fee3b0cebull, 0x99237ac274975d9dull, 0x49eaeff8fd0d0d16ull, 0xe8e0c00567a15c60ull,
+		0xd8a6898cc5a6c355ull, 0x79aca6715f0a9223ull, 0xa965334bd690c2a8ull, 0x086f1cb64c3c93deull,
+		0xd398886f35bf09daull, 0x7292a792af1358acull, 0xa25b32a826890827ull, 0x03511d55bc255951ull,
+		0x331754dc1e22c664ull, 0x921d7b21848e9712ull, 0x42d4ee1b0d14c799ull, 0xe3dec1e697b896efull,
+		0x2de4f0d616b30f2aull, 0x8ceedf2b8c1f5e5cull, 0x5c274a1105850ed7ull, 0xfd2d65ec9f295fa1ull,
+		0xcd6b2c653d2ec094ull, 0x6c610398a78291e2ull, 0xbca896a22e18c169ull, 0x1da2b95fb4b4901full,
+		0xc6552d86cd370a1bull, 0x675f027b579b5b6dull, 0xb7969741de010be6ull, 0x169cb8bc44ad5a90ull,
+		0x26daf135e6aac5a5ull, 0x87d0dec87c0694d3ull, 0x57194bf2f59cc458ull, 0xf613640f6f30952eull,
+		0x7827fa8cadbf144dull, 0xd92dd5713713453bull, 0x09e4404bbe8915b0ull, 0xa8ee6fb6242544c6ull,
+		0x98a8263f8622dbf3ull, 0x39a209c21c8e8a85ull, 0xe96b9cf89514da0eull, 0x4861b3050fb88b78ull,
+		0x939627dc763b117cull, 0x329c0821ec97400aull, 0xe2559d1b650d1081ull, 0x435fb2e6ffa141f7ull,
+		0x7319fb6f5da6dec2ull, 0xd213d492c70a8fb4ull, 0x02da41a84e90df3full, 0xa3d06e55d43c8e49ull,
+		0x6dea5f655537178cull, 0xcce07098cf9b46faull, 0x1c29e5a246011671ull, 0xbd23ca5fdcad4707ull,
+		0x8d6583d67eaad832ull, 0x2c6fac2be4068944ull, 0xfca639116d9cd9cfull, 0x5dac16ecf73088b9ull,
+		0x865b82358eb312bdull, 0x2751adc8141f43cbull, 0xf79838f29d851340ull, 0x5692170f07294236ull,
+		0x66d45e86a52edd03ull, 0xc7de717b3f828c75ull, 0x1717e441b618dcfeull, 0xb61dcbbc2cb48d88ull,
+		0x400eafb3438418a6ull, 0xe104804ed92849d0ull, 0x31cd157450b2195bull, 0x90c73a89ca1e482dull,
+		0xa08173006819d718ull, 0x018b5cfdf2b5866eull, 0xd142c9c77b2fd6e5ull, 0x7048e63ae1838793ull,
+		0xabbf72e398001d97ull, 0x0ab55d1e02ac4ce1ull, 0xda7cc8248b361c6aull, 0x7b76e7d9119a4d1cull,
+		0x4b30ae50b39dd229ull, 0xea3a81ad2931835full, 0x3af31497a0abd3d4ull, 0x9bf93b6a3a0782a2ull,
+		0x55c30a5abb0c1b67ull, 0xf4c925a721a04a11ull, 0x2400b09da83a1a9aull, 0x850a9f6032964becull,
+		0xb54cd6e99091d4d9ull, 0x1446f9140a3d85afull, 0xc48f6c2e83a7d524ull, 0x658543d3190b8452ull,
+		0xbe72d70a60881e56ull, 0x1f78f8f7fa244f20ull, 0xcfb16dcd73be1fabull, 0x6ebb4230e9124eddull,
+		0x5efd0bb94b15d1e8ull, 0xfff72444d1b9809eull, 0x2f3eb17e5823d015ull, 0x8e349e83c28f8163ull,
+		0x4bbfd20b452b4dd4ull, 0xeab5fdf6df871ca2ull, 0x3a7c68cc561d4c29ull, 0x9b764731ccb11d5full,
+		0xab300eb86eb6826aull, 0x0a3a2145f41ad31cull, 0xdaf3b47f7d808397ull, 0x7bf99b82e72cd2e1ull,
+		0xa00e0f5b9eaf48e5ull, 0x010420a604031993ull, 0xd1cdb59c8d994918ull, 0x70c79a611735186eull,
+		0x4081d3e8b532875bull, 0xe18bfc152f9ed62dull, 0x3142692fa60486a6ull, 0x904846d23ca8d7d0ull,
+		0x5e7277e2bda34e15ull, 0xff78581f270f1f63ull, 0x2fb1cd25ae954fe8ull, 0x8ebbe2d834391e9eull,
+		0xbefdab51963e81abull, 0x1ff784ac0c92d0ddull, 0xcf3e119685088056ull, 0x6e343e6b1fa4d120ull,
+		0xb5c3aab266274b24ull, 0x14c9854ffc8b1a52ull, 0xc400107575114ad9ull, 0x650a3f88efbd1bafull,
+		0x554c76014dba849aull, 0xf44659fcd716d5ecull, 0x248fccc65e8c8567ull, 0x8585e33bc420d411ull,
+		0x73968734ab10413full, 0xd29ca8c931bc1049ull, 0x02553df3b82640c2ull, 0xa35f120e228a11b4ull,
+		0x93195b87808d8e81ull, 0x3213747a1a21dff7ull, 0xe2dae14093bb8f7cull, 0x43d0cebd0917de0aull,
+		0x98275a647094440eull, 0x392d7599ea381578ull, 0xe9e4e0a363a245f3ull, 0x48eecf5ef90e1485ull,
+		0x78a886d75b098bb0ull, 0xd9a2a92ac1a5dac6ull, 0x096b3c10483f8a4dull, 0xa86113edd293db3bull,
+		0x665b22dd539842feull, 0xc7510d20c9341388ull, 0x1798981a40ae4303ull, 0xb692b7e7da021275ull,
+		0x86d4fe6e78058d40ull, 0x27ded193e2a9dc36ull, 0xf71744a96b338cbdull, 0x561d6b54f19fddcbull,
+		0x8deaff8d881c47cfull, 0x2ce0d07012b016b9ull, 0xfc29454a9b2a4632ull, 0x5d236ab701861744ull,
+		0x6d65233ea3818871ull, 0xcc6f0cc3392dd907ull, 0x1ca699f9b0b7898cull, 0xbdacb6042a1bd8faull,
+		0x33982887e8945999ull, 0x9292077a723808efull, 0x425b9240fba25864ull, 0xe351bdbd610e0912ull,
+		0xd317f434c3099627ull, 0x721ddbc959a5c751ull, 0xa2d44ef3d03f97daull, 0x03de610e4a93c6acull,
+		0xd829f5d733105ca8ull, 0x7923da2aa9bc0ddeull, 0xa9ea4f1020265d55ull, 0x08e060edba8a0c23ull,
+		0x38a62964188d9316ull, 0x99ac06998221c260ull, 0x496593a30bbb92ebull, 0xe86fbc5e9117c39dull,
+		0x26558d6e101c5a58ull, 0x875fa2938ab00b2eull, 0x579637a9032a5ba5ull, 0xf69c185499860ad3ull,
+		0xc6da51dd3b8195e6ull, 0x67d07e20a12dc490ull, 0xb719eb1a28b7941bull, 0x1613c4e7b21bc56dull,
+		0xcde4503ecb985f69ull, 0x6cee7fc351340e1full, 0xbc27eaf9d8ae5e94ull, 0x1d2dc50442020fe2ull,
+		0x2d6b8c8de00590d7ull, 0x8c61a3707aa9c1a1ull, 0x5ca8364af333912aull, 0xfda219b7699fc05cull,
+		0x0bb17db806af5572ull, 0xaabb52459c030404ull, 0x7a72c77f1599548full, 0xdb78e8828f3505f9ull,
+		0xeb3ea10b2d329accull, 0x4a348ef6b79ecbbaull, 0x9afd1bcc3e049b31ull, 0x3bf73431a4a8ca47ull,
+		0xe000a0e8dd2b5043ull, 0x410a8f1547870135ull, 0x91c31a2fce1d51beull, 0x30c935d254b100c8ull,
+		0x008f7c5bf6b69ffdull, 0xa18553a66c1ace8bull, 0x714cc69ce5809e00ull, 0xd046e9617f2ccf76ull,
+		0x1e7cd851fe2756b3ull, 0xbf76f7ac648b07c5ull, 0x6fbf6296ed11574eull, 0xceb54d6b77bd0638ull,
+		0xfef304e2d5ba990dull, 0x5ff92b1f4f16c87bull, 0x8f30be25c68c98f0ull, 0x2e3a91d85c20c986ull,
+		0xf5cd050125a35382ull, 0x54c72afcbf0f02f4ull, 0x840ebfc63695527full, 0x2504903bac390309ull,
+		0x1542d9b20e3e9c3cull, 0xb448f64f9492cd4aull, 0x648163751d089dc1ull, 0xc58b4c8887a4ccb7ull,
+	},
+};
+
+#if !defined(__BYTE_ORDER__) || (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define GB__CRC_SLICE_BY_8 1
+#endif
+
+gb_internal u32 gb__crc32_slice8(u32 crc, u8 const *c, isize len) {
+	for (; len > 0 && (cast(uintptr)c & 7); len--, c++)
+		crc = (crc >> 8) ^ GB__CRC32_TABLE[(crc ^ *c) & 0xff];
+#if defined(GB__CRC_SLICE_BY_8)
+	for (; len >= 8; len -= 8, c += 8) {
+		u32 one = gb__load_u32(c+0) ^ crc;
+		u32 two = gb__load_u32(c+4);
+		crc = gb__crc32_slices[7][ one        & 0xff] ^
+		      gb__crc32_slices[6][(one >>  8) & 0xff] ^
+		      gb__crc32_slices[5][(one >> 16) & 0xff] ^
+		      gb__crc32_slices[4][ one >> 24        ] ^
+		      gb__crc32_slices[3][ two        & 0xff] ^
+		      gb__crc32_slices[2][(two >>  8) & 0xff] ^
+		      gb__crc32_slices[1][(two >> 16) & 0xff] ^
+		      gb__crc32_slices[0][ two >> 24        ];
+	}
+#endif
+	for (; len > 0; len--, c++)
+		crc = (crc >> 8) ^ GB__CRC32_TABLE[(crc ^ *c) & 0xff];
+	return crc;
+}
+
+gb_internal u64 gb__crc64_slice8(u64 crc, u8 const *c, isize len) {
+	for (; len > 0 && (cast(uintptr)c & 7); len--, c++)
+		crc = (crc >> 8) ^ GB__CRC64_TABLE[(crc ^ *c) & 0xff];
+#if defined(GB__CRC_SLICE_BY_8)
+	for (; len >= 8; len -= 8, c += 8) {
+		u64 v = gb__load_u64(c) ^ crc;
+		crc = gb__crc64_slices[7][ v        & 0xff] ^
+		      gb__crc64_slices[6][(v >>  8) & 0xff] ^
+		      gb__crc64_slices[5][(v >> 16) & 0xff] ^
+		      gb__crc64_slices[4][(v >> 24) & 0xff] ^
+		      gb__crc64_slices[3][(v >> 32) & 0xff] ^
+		      gb__crc64_slices[2][(v >> 40) & 0xff] ^
+		      gb__crc64_slices[1][(v >> 48) & 0xff] ^
+		      gb__crc64_slices[0][ v >> 56        ];
+	}
+#endif
+	for (; len > 0; len--, c++)
+		crc = (crc >> 8) ^ GB__CRC64_TABLE[(crc ^ *c) & 0xff];
+	return crc;
+}
+
+#if defined(GB_SIMD_AVX2) // NOTE(bill): i.e. the compiler supports target specific procedures
+#define GB__CRC32_PCLMUL 1
+#if defined(GB_COMPILER_MSVC)
+	#define GB__TARGET_PCLMUL
+#else
+	#define GB__TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+#endif
+
+// NOTE(bill): Folding with carry-less multiplication, from Intel's
+// "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+// len must be >= 64 and a multiple of 16
+GB__TARGET_PCLMUL gb_internal u32 gb__crc32_pclmul(u32 crc, u8 const *buf, isize len) {
+	gb_local_persist u64 const k1k2[2] = {0x0154442bd4ull, 0x01c6e41596ull};
+	gb_local_persist u64 const k3k4[2] = {0x01751997d0ull, 0x00ccaa009eull};
+	gb_local_persist u64 const k5k0[2] = {0x0163cd6124ull, 0x0000000000ull};
+	gb_local_persist u64 const poly[2] = {0x01db710641ull, 0x01f7011641ull};
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+	x1 = _mm_loadu_si128(cast(__m128i const *)(buf+0x00));
+	x2 = _mm_loadu_si128(cast(__m128i const *)(buf+0x10));
+	x3 = _mm_loadu_si128(cast(__m128i const *)(buf+0x20));
+	x4 = _mm_loadu_si128(cast(__m128i const *)(buf+0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(cast(i32)crc));
+	x0 = _mm_loadu_si128(cast(__m128i const *)k1k2);
+	buf += 64, len -= 64;
+
+	// NOTE(bill): Fold 4x128 bits at a time
+	for (; len >= 64; buf += 64, len -= 64) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+		y5 = _mm_loadu_si128(cast(__m128i const *)(buf+0x00));
+		y6 = _mm_loadu_si128(cast(__m128i const *)(buf+0x10));
+		y7 = _mm_loadu_si128(cast(__m128i const *)(buf+0x20));
+		y8 = _mm_loadu_si128(cast(__m128i const *)(buf+0x30));
+
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+	}
+
+	// NOTE(bill): Fold into 128 bits
+	x0 = _mm_loadu_si128(cast(__m128i const *)k3k4);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	for (; len >= 16; buf += 16, len -= 16) {
+		x2 = _mm_loadu_si128(cast(__m128i const *)buf);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	}
+
+	// NOTE(bill): Fold 128 bits to 64 bits
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+
+	x0 = _mm_loadl_epi64(cast(__m128i const *)k5k0);
+
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	// NOTE(bill): Barrett reduction to 32 bits
+	x0 = _mm_loadu_si128(cast(__m128i const *)poly);
+
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return cast(u32)_mm_extract_epi32(x1, 1);
+}
+
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+
+// NOTE(bill): The ARMv8 crc32 instructions use the same (reflected) polynomial as gb_crc32
+gb_internal u32 gb__crc32_arm(u32 crc, u8 const *c, isize len) {
+	for (; len > 0 && (cast(uintptr)c & 7); len--, c++)
+		crc = __crc32b(crc, *c);
+	for (; len >= 8; len -= 8, c += 8)
+		crc = __crc32d(crc, gb__load_u64(c));
+	for (; len > 0; len--, c++)
+		crc = __crc32b(crc, *c);
+	return crc;
+}
+#endif
+
+gb_internal u32 gb__crc32_update(u32 crc, void const *data, isize len) {
 	u8 const *c = cast(u8 const *)data;
-	for (remaining = len; remaining--; c++)
-		result = (result >> 8) ^ (GB__CRC32_TABLE[(result ^ *c) & 0xff]);
-	return ~result;
+#if defined(GB__CRC32_PCLMUL)
+	u32 const needed = gbCpuFeature_PCLMUL | gbCpuFeature_SSE41;
+	if (len >= 64 && (gb_cpu_features() & needed) == needed) {
+		isize chunk = len & ~cast(isize)15;
+		crc = gb__crc32_pclmul(crc, c, chunk);
+		c   += chunk;
+		len -= chunk;
+	}
+#elif defined(__ARM_FEATURE_CRC32)
+	return gb__crc32_arm(crc, c, len);
+#endif
+	return gb__crc32_slice8(crc, c, len);
+}
+
+
+gb_inline void gb_crc32_init  (gbCrc32 *s)                               { s->state = ~(cast(u32)0); }
+gb_inline void gb_crc32_update(gbCrc32 *s, void const *data, isize len) { s->state = gb__crc32_update(s->state, data, len); }
+gb_inline u32  gb_crc32_final (gbCrc32 *s)                               { return ~s->state; }
+
+gb_inline void gb_crc64_init  (gbCrc64 *s)                               { s->state = ~(cast(u64)0); }
+gb_inline void gb_crc64_update(gbCrc64 *s, void const *data, isize len) { s->state = gb__crc64_slice8(s->state, cast(u8 const *)data, len); }
+gb_inline u64  gb_crc64_final (gbCrc64 *s)                               { return ~s->state; }
+
+u32 gb_crc32(void const *data, isize len) {
+	return ~gb__crc32_update(~(cast(u32)0), data, len);
 }
 
 u64 gb_crc64(void const *data, isize len) {
-	isize remaining;
-	u64 result = ~(cast(u64)0);
-	u8 const *c = cast(u8 const *)data;
-	for (remaining = len; remaining--; c++)
-		result = (result >> 8) ^ (GB__CRC64_TABLE[(result ^ *c) & 0xff]);
-	return ~result;
+	return ~gb__crc64_slice8(~(cast(u64)0), cast(u8 const *)data, len);
 }
 
-u32 gb_fnv32(void const *data, isize len) {
+
+gb_inline void gb_fnv32_init(gbFnv32 *s) { s->hash = 0x811c9dc5; }
+
+void gb_fnv32_update(gbFnv32 *s, void const *data, isize len) {
 	isize i;
-	u32 h = 0x811c9dc5;
+	u32 h = s->hash;
 	u8 const *c = cast(u8 const *)data;
 
 	for (i = 0; i < len; i++)
 		h = (h * 0x01000193) ^ c[i];
 
-	return h;
+	s->hash = h;
 }
 
-u64 gb_fnv64(void const *data, isize len) {
+void gb_fnv32a_update(gbFnv32 *s, void const *data, isize len) {
 	isize i;
-	u64 h = 0xcbf29ce484222325ull;
+	u32 h = s->hash;
 	u8 const *c = cast(u8 const *)data;
 
 	for (i = 0; i < len; i++)
-		h = (h * 0x100000001b3ll) ^ c[i];
+		h = (h ^ c[i]) * 0x01000193;
 
-	return h;
+	s->hash = h;
 }
 
-u32 gb_fnv32a(void const *data, isize len) {
+gb_inline u32 gb_fnv32_final(gbFnv32 *s) { return s->hash; }
+
+
+gb_inline void gb_fnv64_init(gbFnv64 *s) { s->hash = 0xcbf29ce484222325ull; }
+
+void gb_fnv64_update(gbFnv64 *s, void const *data, isize len) {
 	isize i;
-	u32 h = 0x811c9dc5;
+	u64 h = s->hash;
 	u8 const *c = cast(u8 const *)data;
 
 	for (i = 0; i < len; i++)
-		h = (h ^ c[i]) * 0x01000193;
+		h = (h * 0x100000001b3ll) ^ c[i];
 
-	return h;
+	s->hash = h;
 }
 
-u64 gb_fnv64a(void const *data, isize len) {
+void gb_fnv64a_update(gbFnv64 *s, void const *data, isize len) {
 	isize i;
-	u64 h = 0xcbf29ce484222325ull;
+	u64 h = s->hash;
 	u8 const *c = cast(u8 const *)data;
 
 	for (i = 0; i < len; i++)
 		h = (h ^ c[i]) * 0x100000001b3ll;
 
-	return h;
+	s->hash = h;
+}
+
+gb_inline u64 gb_fnv64_final(gbFnv64 *s) { return s->hash; }
+
+
+u32 gb_fnv32(void const *data, isize len) {
+	gbFnv32 s;
+	gb_fnv32_init(&s);
+	gb_fnv32_update(&s, data, len);
+	return gb_fnv32_final(&s);
+}
+
+u64 gb_fnv64(void const *data, isize len) {
+	gbFnv64 s;
+	gb_fnv64_init(&s);
+	gb_fnv64_update(&s, data, len);
+	return gb_fnv64_final(&s);
+}
+
+u32 gb_fnv32a(void const *data, isize len) {
+	gbFnv32 s;
+	gb_fnv32_init(&s);
+	gb_fnv32a_update(&s, data, len);
+	return gb_fnv32_final(&s);
+}
+
+u64 gb_fnv64a(void const *data, isize len) {
+	gbFnv64 s;
+	gb_fnv64_init(&s);
+	gb_fnv64a_update(&s, data, len);
+	return gb_fnv64_final(&s);
 }
 
 gb_inline u32 gb_murmur32(void const *data, isize len) { return gb_murmur32_seed(data, len, 0x9747b28c); }
@@ -7088,7 +13738,7 @@ u64 gb_murmur64_seed(void const *data_, isize len, u64 seed) {
 	u64 h = seed ^ (len * m);
 
 	u64 const *data = cast(u64 const *)data_;
-	u8  const *data2 = cast(u8 const *)data_;
+	u8  const *data2;
 	u64 const* end = data + (len / 8);
 
 	while (data != end) {
@@ -7102,6 +13752,7 @@ u64 gb_murmur64_seed(void const *data_, isize len, u64 seed) {
 		h *= m;
 	}
 
+	data2 = cast(u8 const *)end; // NOTE(bill): The tail is after the last block
 	switch (len & 7) {
 	case 7: h ^= cast(u64)(data2[6]) << 48;
 	case 6: h ^= cast(u64)(data2[5]) << 40;
@@ -7157,10 +13808,197 @@ u64 gb_murmur64_seed(void const *data_, isize len, u64 seed) {
 		len -= 4;
 	}
 
-	switch (len) {
-	case 3: h2 ^= (cast(u8 const *)data)[2] << 16;
-	case 2: h2 ^= (cast(u8 const *)data)[1] <<  8;
-	case 1: h2 ^= (cast(u8 const *)data)[0] <<  0;
+	switch (len) {
+	case 3: h2 ^= (cast(u8 const *)data)[2] << 16;
+	case 2: h2 ^= (cast(u8 const *)data)[1] <<  8;
+	case 1: h2 ^= (cast(u8 const *)data)[0] <<  0;
+		h2 *= m;
+	};
+
+	h1 ^= h2 >> 18;
+	h1 *= m;
+	h2 ^= h1 >> 22;
+	h2 *= m;
+	h1 ^= h2 >> 17;
+	h1 *= m;
+	h2 ^= h1 >> 19;
+	h2 *= m;
+
+	h = h1;
+	h = (h << 32) | h2;
+
+	return h;
+#endif
+}
+
+
+gb_internal gb_inline u32 gb__murmur32_block(u32 hash, u32 k) {
+	k *= 0xcc9e2d51;
+	k = (k << 15) | (k >> 17);
+	k *= 0x1b873593;
+	hash ^= k;
+	return ((hash << 13) | (hash >> 19)) * 5 + 0xe6546b64;
+}
+
+void gb_murmur32_init(gbMurmur32 *s, u32 seed) {
+	gb_zero_item(s);
+	s->hash = seed;
+}
+
+void gb_murmur32_update(gbMurmur32 *s, void const *data, isize len) {
+	u8 const *bytes = cast(u8 const *)data;
+	s->len += len;
+	if (s->tail_len > 0) {
+		u32 k;
+		while (s->tail_len < 4 && len > 0) {
+			s->tail[s->tail_len++] = *bytes++;
+			len--;
+		}
+		if (s->tail_len < 4)
+			return;
+		gb_memcopy(&k, s->tail, 4);
+		s->hash = gb__murmur32_block(s->hash, k);
+		s->tail_len = 0;
+	}
+	for (; len >= 4; bytes += 4, len -= 4) {
+		u32 k;
+		gb_memcopy(&k, bytes, 4);
+		s->hash = gb__murmur32_block(s->hash, k);
+	}
+	while (len-- > 0)
+		s->tail[s->tail_len++] = *bytes++;
+}
+
+u32 gb_murmur32_final(gbMurmur32 *s) {
+	u32 hash = s->hash, k1 = 0;
+	switch (s->tail_len) {
+	case 3:
+		k1 ^= s->tail[2] << 16;
+		// fallthrough
+	case 2:
+		k1 ^= s->tail[1] << 8;
+		// fallthrough
+	case 1:
+		k1 ^= s->tail[0];
+
+		k1 *= 0xcc9e2d51;
+		k1 = (k1 << 15) | (k1 >> 17);
+		k1 *= 0x1b873593;
+		hash ^= k1;
+	}
+
+	hash ^= s->len;
+	hash ^= (hash >> 16);
+	hash *= 0x85ebca6b;
+	hash ^= (hash >> 13);
+	hash *= 0xc2b2ae35;
+	hash ^= (hash >> 16);
+
+	return hash;
+}
+
+
+#if defined(GB_ARCH_64_BIT)
+#define GB__MURMUR64_BLOCK 8
+#else
+#define GB__MURMUR64_BLOCK 4 // NOTE(bill): Alternates between h1 and h2
+#endif
+
+gb_internal gb_inline void gb__murmur64_block(gbMurmur64 *s, u8 const *block, isize block_index) {
+#if defined(GB_ARCH_64_BIT)
+	u64 const m = 0xc6a4a7935bd1e995ULL;
+	u64 k;
+	gb_memcopy(&k, block, 8);
+	k *= m;
+	k ^= k >> 47;
+	k *= m;
+	s->hash ^= k;
+	s->hash *= m;
+	gb_unused(block_index);
+#else
+	u32 const m = 0x5bd1e995;
+	u32 k;
+	gb_memcopy(&k, block, 4);
+	k *= m;
+	k ^= k >> 24;
+	k *= m;
+	if (block_index & 1) {
+		s->h2 *= m;
+		s->h2 ^= k;
+	} else {
+		s->h1 *= m;
+		s->h1 ^= k;
+	}
+#endif
+}
+
+void gb_murmur64_init(gbMurmur64 *s, isize total_len, u64 seed) {
+	gb_zero_item(s);
+	s->total_len = total_len;
+#if defined(GB_ARCH_64_BIT)
+	s->hash = seed ^ (total_len * 0xc6a4a7935bd1e995ULL);
+#else
+	s->h1 = cast(u32)(seed) ^ cast(u32)(total_len);
+	s->h2 = cast(u32)(seed >> 32);
+#endif
+}
+
+void gb_murmur64_update(gbMurmur64 *s, void const *data, isize len) {
+	u8 const *bytes = cast(u8 const *)data;
+	isize block_index = (s->len - s->tail_len) / GB__MURMUR64_BLOCK;
+	s->len += len;
+	if (s->tail_len > 0) {
+		while (s->tail_len < GB__MURMUR64_BLOCK && len > 0) {
+			s->tail[s->tail_len++] = *bytes++;
+			len--;
+		}
+		if (s->tail_len < GB__MURMUR64_BLOCK)
+			return;
+		gb__murmur64_block(s, s->tail, block_index++);
+		s->tail_len = 0;
+	}
+	for (; len >= GB__MURMUR64_BLOCK; bytes += GB__MURMUR64_BLOCK, len -= GB__MURMUR64_BLOCK)
+		gb__murmur64_block(s, bytes, block_index++);
+	while (len-- > 0)
+		s->tail[s->tail_len++] = *bytes++;
+}
+
+u64 gb_murmur64_final(gbMurmur64 *s) {
+#if defined(GB_ARCH_64_BIT)
+	u64 const m = 0xc6a4a7935bd1e995ULL;
+	i32 const r = 47;
+	u64 h = s->hash;
+	u8 const *data2 = s->tail;
+
+	GB_ASSERT_MSG(s->len == s->total_len, "gb_murmur64_init was given a different length");
+
+	switch (s->tail_len) {
+	case 7: h ^= cast(u64)(data2[6]) << 48; // fallthrough
+	case 6: h ^= cast(u64)(data2[5]) << 40; // fallthrough
+	case 5: h ^= cast(u64)(data2[4]) << 32; // fallthrough
+	case 4: h ^= cast(u64)(data2[3]) << 24; // fallthrough
+	case 3: h ^= cast(u64)(data2[2]) << 16; // fallthrough
+	case 2: h ^= cast(u64)(data2[1]) << 8; // fallthrough
+	case 1: h ^= cast(u64)(data2[0]);
+		h *= m;
+	};
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return h;
+#else
+	u64 h;
+	u32 const m = 0x5bd1e995;
+	u32 h1 = s->h1, h2 = s->h2;
+
+	GB_ASSERT_MSG(s->len == s->total_len, "gb_murmur64_init was given a different length");
+
+	switch (s->tail_len) {
+	case 3: h2 ^= s->tail[2] << 16; // fallthrough
+	case 2: h2 ^= s->tail[1] <<  8; // fallthrough
+	case 1: h2 ^= s->tail[0] <<  0;
 		h2 *= m;
 	};
 
@@ -7318,6 +14156,10 @@ u64 gb_murmur64_seed(void const *data_, isize len, u64 seed) {
 
 	gb_internal GB_FILE_READ_AT_PROC(gb__posix_file_read) {
 		isize res = pread(fd.i, buffer, size, offset);
+		if (res < 0 && errno == ESPIPE) {
+			// NOTE(bill): Pipes, sockets et al. cannot be read at an offset, just read what comes next
+			res = read(fd.i, buffer, size);
+		}
 		if (res < 0) return false;
 		if (bytes_read) *bytes_read = res;
 		return true;
@@ -7672,14 +14514,132 @@ gb_inline b32 gb_file_move(char const *existing_filename, char const *new_filena
 
 
 
-gbFileContents gb_file_read_contents(gbAllocator a, b32 zero_terminate, char const *filepath) {
+#if defined(GB_SYSTEM_WINDOWS)
+b32 gb_file_map(gbFileMap *map, gbFile *file, gbFileMapHint hint) {
+	i64 size;
+	gb_zero_item(map);
+	if (file->ops.read_at != gbDefaultFileOperations.read_at)
+		return false;
+
+	size = gb_file_size(file);
+	if (size <= 0 || size > ISIZE_MAX)
+		return false;
+
+	map->handle = CreateFileMappingW(file->fd.p, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (map->handle == NULL)
+		return false;
+
+	map->data = MapViewOfFile(map->handle, FILE_MAP_READ, 0, 0, 0);
+	if (map->data == NULL) {
+		CloseHandle(map->handle);
+		map->handle = NULL;
+		return false;
+	}
+	map->size = cast(isize)size;
+
+	gb_file_map_advise(map, 0, map->size, hint);
+	return true;
+}
+
+void gb_file_unmap(gbFileMap *map) {
+	if (map->data)   UnmapViewOfFile(map->data);
+	if (map->handle) CloseHandle(map->handle);
+	gb_zero_item(map);
+}
+
+void gb_file_map_advise(gbFileMap *map, isize offset, isize size, gbFileMapHint hint) {
+	GB_ASSERT(offset >= 0 && offset+size <= map->size);
+	// NOTE(bill): Windows only takes access pattern hints when the file is opened. Prefetching needs
+	// PrefetchVirtualMemory (Windows 8) and dropping pages needs OfferVirtualMemory, so they are only
+	// used when targeting Windows 8 or later
+#if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+	if (hint == gbFileMapHint_WillNeed && size > 0) {
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress = cast(void *)(cast(u8 const *)map->data + offset);
+		range.NumberOfBytes  = size;
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+#else
+	gb_unused(offset); gb_unused(size); gb_unused(hint);
+#endif
+}
+
+#else
+b32 gb_file_map(gbFileMap *map, gbFile *file, gbFileMapHint hint) {
+	i64 size;
+	void *data;
+	gb_zero_item(map);
+	if (file->ops.read_at != gbDefaultFileOperations.read_at)
+		return false;
+
+	size = gb_file_size(file);
+	if (size <= 0 || size > ISIZE_MAX)
+		return false;
+
+	data = mmap(NULL, cast(size_t)size, PROT_READ, MAP_PRIVATE, cast(int)file->fd.i, 0);
+	if (data == MAP_FAILED)
+		return false;
+
+	map->data = data;
+	map->size = cast(isize)size;
+	gb_file_map_advise(map, 0, map->size, hint);
+	return true;
+}
+
+void gb_file_unmap(gbFileMap *map) {
+	if (map->data)
+		munmap(cast(void *)map->data, map->size);
+	gb_zero_item(map);
+}
+
+void gb_file_map_advise(gbFileMap *map, isize offset, isize size, gbFileMapHint hint) {
+	isize page_size = gb_virtual_memory_page_size(NULL);
+	uintptr start, end;
+	int advice;
+
+	GB_ASSERT(offset >= 0 && offset+size <= map->size);
+	if (size <= 0) return;
+
+	switch (hint) {
+	case gbFileMapHint_Sequential: advice = MADV_SEQUENTIAL; break;
+	case gbFileMapHint_Random:     advice = MADV_RANDOM;     break;
+	case gbFileMapHint_WillNeed:   advice = MADV_WILLNEED;   break;
+	case gbFileMapHint_DontNeed:   advice = MADV_DONTNEED;   break;
+	default:                       advice = MADV_NORMAL;     break;
+	}
+
+	// NOTE(bill): madvise needs a page aligned address
+	start = cast(uintptr)map->data + offset;
+	end   = start + size;
+	start &= ~cast(uintptr)(page_size-1);
+	madvise(cast(void *)start, end-start, advice);
+}
+#endif
+
+
+gbFileContents gb_file_read_contents(gbAllocator a, gbFileContentsFlags flags, char const *filepath) {
 	gbFileContents result = {0};
 	gbFile file = {0};
+	b32 zero_terminate = (flags & gbFileContents_ZeroTerminate) != 0;
+	GB_PROFILE_BEGIN("gb_file_read_contents");
 
 	result.allocator = a;
 
 	if (gb_file_open(&file, filepath) == gbFileError_None) {
 		isize file_size = cast(isize)gb_file_size(&file);
+		if (file_size > 0 && (flags & gbFileContents_Mapped)) {
+			isize page_size = gb_virtual_memory_page_size(NULL);
+			if (!zero_terminate || (file_size % page_size) != 0) {
+				if (gb_file_map(&result.map, &file, gbFileMapHint_Sequential)) {
+					result.data = cast(void *)result.map.data;
+					result.size = result.map.size;
+					// NOTE(bill): The mapping stays valid after the file is closed
+					gb_file_close(&file);
+					GB_PROFILE_END();
+					return result;
+				}
+			}
+		}
 		if (file_size > 0) {
 			result.data = gb_alloc(a, zero_terminate ? file_size+1 : file_size);
 			result.size = file_size;
@@ -7692,18 +14652,186 @@ gbFileContents gb_file_read_contents(gbAllocator a, b32 zero_terminate, char con
 		gb_file_close(&file);
 	}
 
+	GB_PROFILE_END();
 	return result;
 }
 
 void gb_file_free_contents(gbFileContents *fc) {
 	GB_ASSERT_NOT_NULL(fc->data);
-	gb_free(fc->allocator, fc->data);
+	if (fc->map.data) {
+		gb_file_unmap(&fc->map);
+	} else {
+		gb_free(fc->allocator, fc->data);
+	}
 	fc->data = NULL;
 	fc->size = 0;
 }
 
 
 
+gb_internal void gb__async_file_run(gbAsyncFileQueue *q, gbAsyncFileOp *op) {
+	b32 ok;
+	i32 waiters;
+	gb_atomic32_store(&op->status, gbAsyncFileStatus_Running);
+	op->bytes_transferred = 0;
+	if (op->type == gbAsyncFileOp_Read) {
+		ok = op->file->ops.read_at(op->file->fd, op->buffer, op->size, op->offset, &op->bytes_transferred);
+	} else {
+		ok = op->file->ops.write_at(op->file->fd, op->buffer, op->size, op->offset, &op->bytes_transferred);
+	}
+	// NOTE(bill): The callback is called before the request is marked as finished so that the op may
+	// be reused or freed as soon as a waiting thread sees it has finished
+	if (op->callback)
+		op->callback(op, ok);
+	gb_atomic32_store(&op->status, ok ? gbAsyncFileStatus_Done : gbAsyncFileStatus_Failed);
+	gb_atomic32_fetch_add(&q->pending_count, -1);
+	// NOTE(bill): The fetch_add is a full barrier so a waiter either is counted here or sees the new
+	// status before it blocks. Every waiter is woken to check its own request
+	waiters = gb_atomic32_load(&q->waiter_count);
+	if (waiters > 0)
+		gb_fast_semaphore_post(&q->done_semaphore, waiters);
+}
+
+gb_internal gbAsyncFileOp *gb__async_file_pop(gbAsyncFileQueue *q, gbAsyncFileOp *wanted) {
+	gbAsyncFileOp *op = NULL, *prev = NULL;
+	gb_mutex_lock(&q->mutex);
+	if (wanted == NULL) {
+		op = q->head;
+	} else {
+		for (op = q->head; op != NULL && op != wanted; op = op->next)
+			prev = op;
+	}
+	if (op) {
+		if (prev) prev->next = op->next;
+		else      q->head    = op->next;
+		if (q->tail == op) q->tail = prev;
+		op->next = NULL;
+	}
+	gb_mutex_unlock(&q->mutex);
+	return op;
+}
+
+gb_internal GB_THREAD_PROC(gb__async_file_thread_proc) {
+	gbAsyncFileQueue *q = cast(gbAsyncFileQueue *)data;
+	for (;;) {
+		gbAsyncFileOp *op;
+		gb_fast_semaphore_wait(&q->semaphore);
+		op = gb__async_file_pop(q, NULL);
+		if (op) {
+			gb__async_file_run(q, op);
+		} else if (!gb_atomic32_load(&q->is_running)) {
+			break;
+		}
+		// NOTE(bill): Otherwise a waiting thread took the request
+	}
+}
+
+void gb_async_file_queue_init(gbAsyncFileQueue *q, isize thread_count) {
+	isize i;
+	gb_zero_item(q);
+	if (thread_count <= 0) thread_count = 2;
+	if (thread_count > GB_ASYNC_FILE_MAX_THREADS) thread_count = GB_ASYNC_FILE_MAX_THREADS;
+
+	gb_mutex_init(&q->mutex);
+	gb_fast_semaphore_init(&q->semaphore);
+	gb_fast_semaphore_init(&q->done_semaphore);
+	gb_atomic32_store(&q->is_running, true);
+
+	q->thread_count = thread_count;
+	for (i = 0; i < thread_count; i++) {
+		gb_thread_init(&q->threads[i]);
+		gb_thread_start(&q->threads[i], gb__async_file_thread_proc, q);
+	}
+}
+
+void gb_async_file_queue_destroy(gbAsyncFileQueue *q) {
+	isize i;
+	gb_async_file_queue_wait_all(q);
+	gb_atomic32_store(&q->is_running, false);
+	gb_fast_semaphore_post(&q->semaphore, cast(i32)q->thread_count);
+	for (i = 0; i < q->thread_count; i++)
+		gb_thread_destory(&q->threads[i]);
+	gb_fast_semaphore_destroy(&q->done_semaphore);
+	gb_fast_semaphore_destroy(&q->semaphore);
+	gb_mutex_destroy(&q->mutex);
+}
+
+void gb_async_file_queue_wait_all(gbAsyncFileQueue *q) {
+	gbAsyncFileOp *op;
+	// NOTE(bill): Help out with the requests which have not been picked up yet
+	while ((op = gb__async_file_pop(q, NULL)) != NULL)
+		gb__async_file_run(q, op);
+	gb_atomic32_fetch_add(&q->waiter_count, 1);
+	while (gb_atomic32_load(&q->pending_count) > 0)
+		gb_fast_semaphore_wait(&q->done_semaphore);
+	gb_atomic32_fetch_add(&q->waiter_count, -1);
+}
+
+void gb_async_file_submit(gbAsyncFileQueue *q, gbAsyncFileOp *op) {
+	GB_ASSERT_NOT_NULL(op->file);
+	GB_ASSERT(gb_atomic32_load(&q->is_running));
+
+	op->next = NULL;
+	op->bytes_transferred = 0;
+	gb_atomic32_store(&op->status, gbAsyncFileStatus_Pending);
+	gb_atomic32_fetch_add(&q->pending_count, 1);
+
+	gb_mutex_lock(&q->mutex);
+	if (q->tail) q->tail->next = op;
+	else         q->head       = op;
+	q->tail = op;
+	gb_mutex_unlock(&q->mutex);
+
+	gb_fast_semaphore_release(&q->semaphore);
+}
+
+gb_inline void gb_async_file_read_at(gbAsyncFileQueue *q, gbAsyncFileOp *op, gbFile *file, void *buffer, isize size, i64 offset,
+                                     gbAsyncFileCallback *callback, void *user_data) {
+	op->type      = gbAsyncFileOp_Read;
+	op->file      = file;
+	op->buffer    = buffer;
+	op->size      = size;
+	op->offset    = offset;
+	op->callback  = callback;
+	op->user_data = user_data;
+	gb_async_file_submit(q, op);
+}
+
+gb_inline void gb_async_file_write_at(gbAsyncFileQueue *q, gbAsyncFileOp *op, gbFile *file, void const *buffer, isize size, i64 offset,
+                                      gbAsyncFileCallback *callback, void *user_data) {
+	op->type      = gbAsyncFileOp_Write;
+	op->file      = file;
+	op->buffer    = cast(void *)buffer;
+	op->size      = size;
+	op->offset    = offset;
+	op->callback  = callback;
+	op->user_data = user_data;
+	gb_async_file_submit(q, op);
+}
+
+gb_inline gbAsyncFileStatus gb_async_file_op_status(gbAsyncFileOp *op) {
+	return cast(gbAsyncFileStatus)gb_atomic32_load(&op->status);
+}
+
+b32 gb_async_file_op_wait(gbAsyncFileQueue *q, gbAsyncFileOp *op) {
+	gbAsyncFileStatus status = gb_async_file_op_status(op);
+	if (status == gbAsyncFileStatus_Pending) {
+		if (gb__async_file_pop(q, op) == op)
+			gb__async_file_run(q, op);
+	}
+	gb_atomic32_fetch_add(&q->waiter_count, 1);
+	for (;;) {
+		status = gb_async_file_op_status(op);
+		if (status == gbAsyncFileStatus_Done || status == gbAsyncFileStatus_Failed || status == gbAsyncFileStatus_Idle)
+			break;
+		gb_fast_semaphore_wait(&q->done_semaphore);
+	}
+	gb_atomic32_fetch_add(&q->waiter_count, -1);
+	return status == gbAsyncFileStatus_Done;
+}
+
+
+
 
 
 gb_inline b32 gb_path_is_absolute(char const *path) {
@@ -7766,6 +14894,151 @@ char *gb_path_get_full_name(gbAllocator a, char const *path) {
 
 
 
+//
+// Buffered File IO
+//
+
+void gb_file_writer_init(gbFileWriter *w, gbFile *f, void *buffer, isize capacity, gbFileBufferMode mode) {
+	GB_ASSERT(capacity >= GB_FILE_WRITER_MIN_CAPACITY);
+	gb_zero_item(w);
+	w->file     = f;
+	w->buffer   = cast(u8 *)buffer;
+	w->capacity = capacity;
+	w->mode     = mode;
+}
+
+b32 gb_file_writer_flush(gbFileWriter *w) {
+	if (w->count > 0) {
+		if (!gb_file_write(w->file, w->buffer, w->count))
+			w->failed = true;
+		w->count = 0;
+	}
+	return !w->failed;
+}
+
+gb_internal void gb__file_writer_end_write(gbFileWriter *w) {
+	if (w->mode == gbFileBuffer_None ||
+	    (w->mode == gbFileBuffer_Line && gb_memrchr(w->buffer, '\n', w->count) != NULL)) {
+		// NOTE(bill): In line mode the buffer never holds a newline before this write so the
+		// whole buffer can be searched
+		gb_file_writer_flush(w);
+	}
+}
+
+b32 gb_file_writer_write(gbFileWriter *w, void const *data, isize size) {
+	if (size > w->capacity - w->count)
+		gb_file_writer_flush(w);
+	if (size >= w->capacity) {
+		// NOTE(bill): Too big to be worth buffering
+		if (!gb_file_write(w->file, data, size))
+			w->failed = true;
+		return !w->failed;
+	}
+	gb_memcopy(w->buffer + w->count, data, size);
+	w->count += size;
+	gb__file_writer_end_write(w);
+	return !w->failed;
+}
+
+
+void gb_file_reader_init(gbFileReader *r, gbFile *f, void *buffer, isize capacity) {
+	GB_ASSERT(capacity >= GB_FILE_READER_MIN_CAPACITY);
+	gb_zero_item(r);
+	r->file     = f;
+	r->buffer   = cast(u8 *)buffer;
+	r->capacity = capacity;
+	r->offset   = gb_file_tell(f);
+}
+
+// NOTE(bill): Moves the unread bytes to the front and reads as much as fits after them.
+// Returns false at the end of the file or if the buffer is full.
+gb_internal b32 gb__file_reader_fill(gbFileReader *r) {
+	isize bytes_read = 0;
+	if (r->eof)
+		return false;
+	if (r->start > 0) {
+		gb_memmove(r->buffer, r->buffer + r->start, r->end - r->start);
+		r->end -= r->start;
+		r->start = 0;
+	}
+	if (r->end == r->capacity)
+		return false;
+	if (!gb_file_read_at_check(r->file, r->buffer + r->end, r->capacity - r->end, r->offset, &bytes_read) ||
+	    bytes_read <= 0) {
+		r->eof = true;
+		return false;
+	}
+	r->end    += bytes_read;
+	r->offset += bytes_read;
+	return true;
+}
+
+isize gb_file_reader_read(gbFileReader *r, void *data, isize size) {
+	u8 *dest = cast(u8 *)data;
+	isize total = 0;
+	r->split_line = false;
+	while (size > 0) {
+		isize available = r->end - r->start;
+		if (available > 0) {
+			isize n = gb_min(available, size);
+			gb_memcopy(dest, r->buffer + r->start, n);
+			r->start += n;
+			dest += n, total += n, size -= n;
+		} else if (size >= r->capacity && !r->eof) {
+			// NOTE(bill): Large reads skip the buffer
+			isize bytes_read = 0;
+			if (!gb_file_read_at_check(r->file, dest, size, r->offset, &bytes_read) || bytes_read <= 0) {
+				r->eof = true;
+				break;
+			}
+			r->offset += bytes_read;
+			dest += bytes_read, total += bytes_read, size -= bytes_read;
+		} else if (!gb__file_reader_fill(r)) {
+			break;
+		}
+	}
+	return total;
+}
+
+b32 gb_file_reader_read_line(gbFileReader *r, char const **line, isize *length) {
+	isize searched = 0;
+	r->split_line = false;
+	for (;;) {
+		u8 *begin = r->buffer + r->start;
+		isize available = r->end - r->start;
+		u8 const *newline = cast(u8 const *)gb_memchr(begin + searched, '\n', available - searched);
+		if (newline) {
+			isize len = newline - begin;
+			r->start += len+1;
+			if (len > 0 && begin[len-1] == '\r')
+				len--;
+			*line   = cast(char const *)begin;
+			*length = len;
+			return true;
+		}
+		searched = available;
+		if (!gb__file_reader_fill(r)) {
+			// NOTE(bill): The last line has no newline or the line does not fit in the buffer
+			available = r->end - r->start;
+			if (available == 0)
+				return false;
+			if (!r->eof) {
+				// NOTE(bill): The buffer is full and holds no \n. Hold back its last byte, and the one
+				// before if the last is a \r which may start a \r\n, so the piece is always followed
+				// by a byte of the same line and never ends exactly where the line does
+				available -= (r->buffer[r->end-1] == '\r') ? 2 : 1;
+				r->split_line = true;
+			}
+			*line   = cast(char const *)(r->buffer + r->start);
+			*length = available;
+			r->start += available;
+			return true;
+		}
+	}
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////
 //
@@ -7811,6 +15084,15 @@ char *gb_bprintf(char const *fmt, ...) {
 	return str;
 }
 
+isize gb_file_writer_printf(gbFileWriter *w, char const *fmt, ...) {
+	isize res;
+	va_list va;
+	va_start(va, fmt);
+	res = gb_file_writer_printf_va(w, fmt, va);
+	va_end(va);
+	return res;
+}
+
 isize gb_snprintf(char *str, isize n, char const *fmt, ...) {
 	isize res;
 	va_list va;
@@ -7831,9 +15113,12 @@ gb_inline isize gb_printf_err_va(char const *fmt, va_list va) {
 }
 
 gb_inline isize gb_fprintf_va(struct gbFile *f, char const *fmt, va_list va) {
-	gb_local_persist char buf[4096];
-	isize len = gb_snprintf_va(buf, gb_size_of(buf), fmt, va);
-	gb_file_write(f, buf, len-1); // NOTE(bill): prevent extra whitespace
+	char buffer[1024];
+	gbFileWriter w;
+	isize len;
+	gb_file_writer_init(&w, f, buffer, gb_size_of(buffer), gbFileBuffer_Full);
+	len = gb_file_writer_printf_va(&w, fmt, va);
+	gb_file_writer_flush(&w);
 	return len;
 }
 
@@ -7863,7 +15148,8 @@ enum {
 	gbFmt_Unsigned  = GB_BIT(12),
 	gbFmt_Lower     = GB_BIT(13),
 	gbFmt_Upper     = GB_BIT(14),
-
+	gbFmt_Exponent  = GB_BIT(15),
+	gbFmt_General   = GB_BIT(16),
 
 	gbFmt_Done      = GB_BIT(30),
 
@@ -7879,45 +15165,37 @@ typedef struct {
 
 
 gb_internal isize gb__print_string(char *text, isize max_len, gbprivFmtInfo *info, char const *str) {
-	// TODO(bill): Get precision and width to work correctly. How does it actually work?!
-	// TODO(bill): This looks very buggy indeed.
-	isize res = 0, len;
-	isize remaining = max_len;
+	char *start = text;
+	isize res = 0, len, padding = 0;
+	char pad = ' ';
+	max_len--; // NOTE(bill): Leave room for the null terminator
 
+	if (str == NULL)
+		str = "(null)";
 	if (info && info->precision >= 0)
 		len = gb_strnlen(str, info->precision);
 	else
 		len = gb_strlen(str);
 
-	if (info && (info->width == 0 || info->flags & gbFmt_Minus)) {
-		if (info->precision > 0)
-			len = info->precision < len ? info->precision : len;
-
-		res += gb_strlcpy(text, str, len);
-
-		if (info->width > res) {
-			isize padding = info->width - len;
-			char pad = (info->flags & gbFmt_Zero) ? '0' : ' ';
-			while (padding --> 0 && remaining --> 0)
-				*text++ = pad, res++;
-		}
-	} else {
-		if (info && (info->width > res)) {
-			isize padding = info->width - len;
-			char pad = (info->flags & gbFmt_Zero) ? '0' : ' ';
-			while (padding --> 0 && remaining --> 0)
-				*text++ = pad, res++;
-		}
-
-		res += gb_strlcpy(text, str, len);
+	if (info && info->width > len) {
+		padding = info->width - len;
+		if (info->flags & gbFmt_Zero && !(info->flags & gbFmt_Minus))
+			pad = '0';
 	}
 
+	if (!(info && info->flags & gbFmt_Minus)) {
+		while (padding > 0 && res < max_len)
+			*text++ = pad, res++, padding--;
+	}
+	while (len > 0 && res < max_len)
+		*text++ = *str++, res++, len--;
+	while (padding > 0 && res < max_len)
+		*text++ = pad, res++, padding--;
 
-	if (info) {
-		if (info->flags & gbFmt_Upper)
-			gb_str_to_upper(text);
-		else if (info->flags & gbFmt_Lower)
-			gb_str_to_lower(text);
+	if (info && info->flags & (gbFmt_Upper|gbFmt_Lower)) {
+		isize i;
+		for (i = 0; i < res; i++)
+			start[i] = (info->flags & gbFmt_Upper) ? gb_char_to_upper(start[i]) : gb_char_to_lower(start[i]);
 	}
 
 	return res;
@@ -7943,127 +15221,206 @@ gb_internal isize gb__print_u64(char *text, isize max_len, gbprivFmtInfo *info,
 }
 
 
+gb_internal gb_inline isize gb__print_repeat(char *text, isize n, isize max_len, char c, isize count) {
+	for (; count > 0; count--, n++) {
+		if (n < max_len-1)
+			text[n] = c;
+	}
+	return n;
+}
+
+// NOTE(bill): The digits come from the shortest round trip form rounded to the precision asked for,
+// only a precision past the shortest digits needs the (slow) exact expansion. Unlike C, %g with no
+// precision (and no #) gives the shortest form which reads back exactly rather than 6 significant digits.
 gb_internal isize gb__print_f64(char *text, isize max_len, gbprivFmtInfo *info, f64 arg) {
-	// TODO(bill): Handle exponent notation
-	isize width, len, remaining = max_len;
-	char *text_begin = text;
-
-	if (arg) {
-		u64 value;
-		if (arg < 0) {
-			if (remaining > 1)
-				*text = '-', remaining--;
-			text++;
-			arg = -arg;
-		} else if (info->flags & gbFmt_Minus) {
-			if (remaining > 1)
-				*text = '+', remaining--;
-			text++;
-		}
-
-		value = cast(u64)arg;
-		len = gb__print_u64(text, remaining, NULL, value);
-		text += len;
-
-		if (len >= remaining)
-			remaining = gb_min(remaining, 1);
-		else
-			remaining -= len;
-		arg -= value;
-
-		if (info->precision < 0)
-			info->precision = 6;
-
-		if ((info->flags & gbFmt_Alt) || info->precision > 0) {
-			i64 mult = 10;
-			if (remaining > 1)
-				*text = '.', remaining--;
-			text++;
-			while (info->precision-- > 0) {
-				value = cast(u64)(arg * mult);
-				len = gb__print_u64(text, remaining, NULL, value);
-				text += len;
-				if (len >= remaining)
-					remaining = gb_min(remaining, 1);
-				else
-					remaining -= len;
-				arg -= cast(f64)value / mult;
-				mult *= 10;
-			}
-		}
+	char digits[GB__FLOAT_EXACT_DIGITS], body[720];
+	char sign = 0;
+	isize len, pad, i, n = 0;
+	i32 count = 0, point = 1, precision = gb_min(info->precision, 340);
+	b32 upper = (info->flags & gbFmt_Upper) != 0;
+	b32 alt   = (info->flags & gbFmt_Alt)   != 0;
+	b32 general = (info->flags & gbFmt_General) != 0;
+	b32 fixed   = !general && !(info->flags & gbFmt_Exponent);
+	b32 finite;
+	u64 bits = gb__f64_bits(arg);
+
+	if (bits >> 63)                     sign = '-';
+	else if (info->flags & gbFmt_Plus)  sign = '+';
+	else if (info->flags & gbFmt_Space) sign = ' ';
+
+	finite = (bits & 0x7ff0000000000000ull) != 0x7ff0000000000000ull;
+	if (!finite) {
+		char const *s = (bits & 0xfffffffffffffull) ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+		gb_memcopy(body, s, 3);
+		len = 3;
 	} else {
-		if (remaining > 1)
-			*text = '0', remaining--;
-		text++;
-		if (info->flags & gbFmt_Alt) {
-			if (remaining > 1)
-				*text = '.', remaining--;
-			text++;
+		if (arg != 0) {
+			count = gb__f64_shortest_digits(arg, digits, &point);
+			point += count;
 		}
-	}
 
-	width = info->width - (text - text_begin);
-	if (width > 0) {
-		char fill = (info->flags & gbFmt_Zero) ? '0' : ' ';
-		char *end = text+remaining-1;
-		len = (text - text_begin);
-
-		for (len = (text - text_begin); len--; ) {
-			if ((text_begin+len+width) < end)
-				*(text_begin+len+width) = *(text_begin+len);
+		if (general && precision < 0 && !alt) {
+			len = gb__float_write_shortest(body, digits, count, point, upper);
+		} else {
+			i32 keep;
+			if (precision < 0)             precision = 6;
+			if (general && precision == 0) precision = 1;
+			keep = general ? precision : fixed ? point + precision : precision + 1;
+
+			// NOTE(bill): The shortest digits are within half an ulp of the value and up to 15 digits
+			// that can never cross a rounding boundary, so they are padded or rounded as they are
+			if (count && (keep > 15 || gb_abs(arg) < 2.2250738585072014e-308))
+				count = gb__float_exact_digits(arg, digits, fixed ? precision : keep, fixed, &point);
+			else
+				count = gb__float_round_digits(arg, digits, count, keep, &point);
+
+			if (general) {
+				i32 exponent = count ? point-1 : 0;
+				if (exponent >= -4 && exponent < precision) {
+					i32 fraction = alt ? precision-1-exponent : gb_max(count - point, 0);
+					len = gb__float_write_fixed(body, digits, count, point, fraction, alt);
+				} else {
+					i32 fraction = alt ? precision-1 : gb_max(count-1, 0);
+					len = gb__float_write_exponent(body, digits, count, point, fraction, alt, upper);
+				}
+			} else if (fixed) {
+				len = gb__float_write_fixed(body, digits, count, point, precision, alt);
+			} else {
+				len = gb__float_write_exponent(body, digits, count, point, precision, alt, upper);
+			}
 		}
+	}
 
-		len = width;
-		text += len;
-		if (len >= remaining)
-			remaining = gb_min(remaining, 1);
-		else
-			remaining -= len;
-
-		while (len--) {
-			if (text_begin+len < end)
-				text_begin[len] = fill;
+	pad = info->width - len - (sign != 0);
+	if (!(info->flags & gbFmt_Minus) && !((info->flags & gbFmt_Zero) && finite))
+		n = gb__print_repeat(text, n, max_len, ' ', pad);
+	if (sign)
+		n = gb__print_repeat(text, n, max_len, sign, 1);
+	if (!(info->flags & gbFmt_Minus) && (info->flags & gbFmt_Zero) && finite)
+		n = gb__print_repeat(text, n, max_len, '0', pad);
+	for (i = 0; i < len; i++)
+		n = gb__print_repeat(text, n, max_len, body[i], 1);
+	if (info->flags & gbFmt_Minus)
+		n = gb__print_repeat(text, n, max_len, ' ', pad);
+
+	return gb_min(n, gb_max(max_len-1, 0));
+}
+
+
+
+typedef union gbprivFmtArg {
+	i64         i;
+	u64         u;
+	f64         f;
+	char        c;
+	char const *s;
+} gbprivFmtArg;
+
+// NOTE(bill): Where the formatted text goes. A writer is flushed when its buffer is full,
+// a plain buffer is truncated.
+typedef struct gbprivFmtOutput {
+	char *        text;
+	isize         remaining; // NOTE(bill): Including the space for the null terminator
+	gbFileWriter *writer;
+	isize         written;
+	b32           truncated;
+} gbprivFmtOutput;
+
+gb_internal void gb__fmt_output_write(gbprivFmtOutput *out, char const *str, isize len) {
+	while (len > 0) {
+		isize n = gb_min(len, out->remaining-1);
+		if (n > 0) {
+			gb_memcopy(out->text, str, n);
+			out->text      += n;
+			out->remaining -= n;
+			out->written   += n;
+			str += n, len -= n;
+		}
+		if (len > 0) {
+			gbFileWriter *w = out->writer;
+			if (w == NULL) {
+				out->truncated = true;
+				break;
+			}
+			w->count = cast(u8 *)out->text - w->buffer;
+			gb_file_writer_flush(w);
+			out->text      = cast(char *)w->buffer;
+			out->remaining = w->capacity+1; // NOTE(bill): A writer needs no null terminator
 		}
 	}
-
-	return (text - text_begin);
 }
 
+gb_internal void gb__fmt_output_fill(gbprivFmtOutput *out, char c, isize count) {
+	char fill[32];
+	gb_memset(fill, c, gb_size_of(fill));
+	while (count > 0) {
+		isize n = gb_min(count, gb_size_of(fill));
+		gb__fmt_output_write(out, fill, n);
+		count -= n;
+	}
+}
 
+gb_internal void gb__fmt_output_arg(gbprivFmtOutput *out, gbprivFmtInfo *info, char kind, gbprivFmtArg arg) {
+	char piece[512];
+	isize len = 0;
+	if (kind == 's') {
+		// NOTE(bill): Strings go straight through so they can be of any length
+		char const *str = arg.s ? arg.s : "(null)";
+		isize padding = 0;
+		char pad = (info->flags & gbFmt_Zero && !(info->flags & gbFmt_Minus)) ? '0' : ' ';
+		len = info->precision >= 0 ? gb_strnlen(str, info->precision) : gb_strlen(str);
+		if (info->width > len)
+			padding = info->width - len;
+		if (!(info->flags & gbFmt_Minus))
+			gb__fmt_output_fill(out, pad, padding);
+		gb__fmt_output_write(out, str, len);
+		if (info->flags & gbFmt_Minus)
+			gb__fmt_output_fill(out, pad, padding);
+		return;
+	}
 
-gb_no_inline isize gb_snprintf_va(char *text, isize max_len, char const *fmt, va_list va) {
-	char const *text_begin = text;
-	isize remaining = max_len, res;
+	switch (kind) {
+	case 'c': len = gb__print_char(piece, gb_size_of(piece), info, arg.c); break;
+	case 'i': len = gb__print_i64 (piece, gb_size_of(piece), info, arg.i); break;
+	case 'u': len = gb__print_u64 (piece, gb_size_of(piece), info, arg.u); break;
+	case 'f': len = gb__print_f64 (piece, gb_size_of(piece), info, arg.f); break;
+	}
+	gb__fmt_output_write(out, piece, gb_clamp(len, 0, gb_size_of(piece)-1));
+}
 
+gb_internal void gb__fmt_va(gbprivFmtOutput *out, char const *fmt, va_list va) {
 	while (*fmt) {
 		gbprivFmtInfo info = {0};
-		isize len = 0;
+		gbprivFmtArg arg = {0};
+		char kind = 0;
+		char const *literal = fmt;
 		info.precision = -1;
 
-		while (*fmt && *fmt != '%' && remaining)
-			*text++ = *fmt++;
-
-		if (*fmt == '%') {
-			do {
-				switch (*++fmt) {
-				case '-': info.flags |= gbFmt_Minus; break;
-				case '+': info.flags |= gbFmt_Plus;  break;
-				case '#': info.flags |= gbFmt_Alt;   break;
-				case ' ': info.flags |= gbFmt_Space; break;
-				case '0': info.flags |= gbFmt_Zero;  break;
-				default:  info.flags |= gbFmt_Done;  break;
-				}
-			} while (!(info.flags & gbFmt_Done));
-		}
+		while (*fmt && *fmt != '%')
+			fmt++;
+		gb__fmt_output_write(out, literal, fmt - literal);
+		if (*fmt != '%')
+			break;
+
+		do {
+			switch (*++fmt) {
+			case '-': info.flags |= gbFmt_Minus; break;
+			case '+': info.flags |= gbFmt_Plus;  break;
+			case '#': info.flags |= gbFmt_Alt;   break;
+			case ' ': info.flags |= gbFmt_Space; break;
+			case '0': info.flags |= gbFmt_Zero;  break;
+			default:  info.flags |= gbFmt_Done;  break;
+			}
+		} while (!(info.flags & gbFmt_Done));
 
 		// NOTE(bill): Optional Width
 		if (*fmt == '*') {
 			int width = va_arg(va, int);
 			if (width < 0) {
 				info.flags |= gbFmt_Minus;
-				info.width = -info.width;
+				info.width = -width;
 			} else {
-				info.width = -info.width;
+				info.width = width;
 			}
 			fmt++;
 		} else {
@@ -8079,7 +15436,9 @@ gb_no_inline isize gb_snprintf_va(char *text, isize max_len, char const *fmt, va
 			} else {
 				info.precision = cast(i32)gb_str_to_i64(fmt, cast(char **)&fmt, 10);
 			}
-			info.flags &= ~gbFmt_Zero;
+			// NOTE(bill): A precision turns off zero padding, except for floats
+			if (*fmt != 'f' && *fmt != 'F' && *fmt != 'e' && *fmt != 'E' && *fmt != 'g' && *fmt != 'G')
+				info.flags &= ~gbFmt_Zero;
 		}
 
 
@@ -8102,8 +15461,6 @@ gb_no_inline isize gb_snprintf_va(char *text, isize max_len, char const *fmt, va
 			}
 			break;
 
-			break;
-
 		case 'z': // NOTE(bill): usize
 			info.flags |= gbFmt_Unsigned;
 			// fallthrough
@@ -8140,9 +15497,15 @@ gb_no_inline isize gb_snprintf_va(char *text, isize max_len, char const *fmt, va
 
 		case 'f':
 		case 'F':
+		case 'e':
+		case 'E':
 		case 'g':
 		case 'G':
-			len = gb__print_f64(text, remaining, &info, va_arg(va, f64));
+			if (*fmt == 'e' || *fmt == 'E') info.flags |= gbFmt_Exponent;
+			if (*fmt == 'g' || *fmt == 'G') info.flags |= gbFmt_General;
+			if (*fmt == 'F' || *fmt == 'E' || *fmt == 'G') info.flags |= gbFmt_Upper;
+			kind  = 'f';
+			arg.f = va_arg(va, f64);
 			break;
 
 		case 'a':
@@ -8151,11 +15514,13 @@ gb_no_inline isize gb_snprintf_va(char *text, isize max_len, char const *fmt, va
 			break;
 
 		case 'c':
-			len = gb__print_char(text, remaining, &info, cast(char)va_arg(va, int));
+			kind  = 'c';
+			arg.c = cast(char)va_arg(va, int);
 			break;
 
 		case 's':
-			len = gb__print_string(text, remaining, &info, va_arg(va, char *));
+			kind  = 's';
+			arg.s = va_arg(va, char const *);
 			break;
 
 		case 'p':
@@ -8164,7 +15529,8 @@ gb_no_inline isize gb_snprintf_va(char *text, isize max_len, char const *fmt, va
 			break;
 
 		case '%':
-			len = gb__print_char(text, remaining, &info, '%');
+			kind  = 'c';
+			arg.c = '%';
 			break;
 
 		default: fmt--; break;
@@ -8174,46 +15540,55 @@ gb_no_inline isize gb_snprintf_va(char *text, isize max_len, char const *fmt, va
 
 		if (info.base != 0) {
 			if (info.flags & gbFmt_Unsigned) {
-				u64 value = 0;
+				kind = 'u';
 				switch (info.flags & gbFmt_Ints) {
-				case gbFmt_Char:   value = cast(u64)cast(u8) va_arg(va, int);       break;
-				case gbFmt_Short:  value = cast(u64)cast(u16)va_arg(va, int);       break;
-				case gbFmt_Long:   value = cast(u64)va_arg(va, unsigned long);      break;
-				case gbFmt_Llong:  value = cast(u64)va_arg(va, unsigned long long); break;
-				case gbFmt_Size:   value = cast(u64)va_arg(va, usize);              break;
-				case gbFmt_Intptr: value = cast(u64)va_arg(va, uintptr);            break;
-				default:             value = cast(u64)va_arg(va, unsigned int);       break;
+				case gbFmt_Char:   arg.u = cast(u64)cast(u8) va_arg(va, int);       break;
+				case gbFmt_Short:  arg.u = cast(u64)cast(u16)va_arg(va, int);       break;
+				case gbFmt_Long:   arg.u = cast(u64)va_arg(va, unsigned long);      break;
+				case gbFmt_Llong:  arg.u = cast(u64)va_arg(va, unsigned long long); break;
+				case gbFmt_Size:   arg.u = cast(u64)va_arg(va, usize);              break;
+				case gbFmt_Intptr: arg.u = cast(u64)va_arg(va, uintptr);            break;
+				default:           arg.u = cast(u64)va_arg(va, unsigned int);       break;
 				}
-
-				len = gb__print_u64(text, remaining, &info, value);
-
 			} else {
-				i64 value = 0;
+				kind = 'i';
 				switch (info.flags & gbFmt_Ints) {
-				case gbFmt_Char:   value = cast(i64)cast(i8) va_arg(va, int); break;
-				case gbFmt_Short:  value = cast(i64)cast(i16)va_arg(va, int); break;
-				case gbFmt_Long:   value = cast(i64)va_arg(va, long);         break;
-				case gbFmt_Llong:  value = cast(i64)va_arg(va, long long);    break;
-				case gbFmt_Size:   value = cast(i64)va_arg(va, usize);        break;
-				case gbFmt_Intptr: value = cast(i64)va_arg(va, uintptr);      break;
-				default:             value = cast(i64)va_arg(va, int);          break;
+				case gbFmt_Char:   arg.i = cast(i64)cast(i8) va_arg(va, int); break;
+				case gbFmt_Short:  arg.i = cast(i64)cast(i16)va_arg(va, int); break;
+				case gbFmt_Long:   arg.i = cast(i64)va_arg(va, long);         break;
+				case gbFmt_Llong:  arg.i = cast(i64)va_arg(va, long long);    break;
+				case gbFmt_Size:   arg.i = cast(i64)va_arg(va, usize);        break;
+				case gbFmt_Intptr: arg.i = cast(i64)va_arg(va, uintptr);      break;
+				default:           arg.i = cast(i64)va_arg(va, int);          break;
 				}
-
-				len = gb__print_i64(text, remaining, &info, value);
 			}
 		}
 
-
-		text += len;
-		if (len >= remaining)
-			remaining = gb_min(remaining, 1);
-		else
-			remaining -= len;
+		if (kind)
+			gb__fmt_output_arg(out, &info, kind, arg);
 	}
+}
+
+gb_no_inline isize gb_snprintf_va(char *text, isize max_len, char const *fmt, va_list va) {
+	gbprivFmtOutput out = {0};
+	if (max_len <= 0)
+		return -1;
+	out.text      = text;
+	out.remaining = max_len;
+	gb__fmt_va(&out, fmt, va);
+	*out.text = '\0';
+	return out.truncated ? -1 : out.written+1; // NOTE(bill): Including the null terminator
+}
 
-	*text++ = '\0';
-	res = (text - text_begin);
-	return (res >= max_len || res < 0) ? -1 : res;
+isize gb_file_writer_printf_va(gbFileWriter *w, char const *fmt, va_list va) {
+	gbprivFmtOutput out = {0};
+	out.text      = cast(char *)w->buffer + w->count;
+	out.remaining = w->capacity - w->count + 1;
+	out.writer    = w;
+	gb__fmt_va(&out, fmt, va);
+	w->count = cast(u8 *)out.text - w->buffer;
+	gb__file_writer_end_write(w);
+	return out.written;
 }
 
 
@@ -8373,6 +15748,244 @@ gb_inline gbDllProc gb_dll_proc_address(gbDllHandle dll, char const *proc_name)
 
 
 
+////////////////////////////////////////////////////////////////
+//
+// Profiling
+//
+//
+
+gb_global gbAtomicPtr      gb__profile_threads = {0};
+gb_global gbAtomic32       gb__profile_state   = {0}; // NOTE(bill): 0 - no zones yet, 1 - starting, 2 - started
+gb_global u64              gb__profile_base_tsc;
+gb_global f64              gb__profile_base_time;
+gb_global u64              gb__profile_frame_tsc;
+gb_global gbProfileFrame   gb__profile_frame;
+gb_global i16              gb__profile_zone_slots[2*GB_PROFILE_MAX_ZONES];
+gb_global gb_thread_local gbProfileThread *gb__profile_thread = NULL;
+
+GB_STATIC_ASSERT((GB_PROFILE_EVENT_COUNT & (GB_PROFILE_EVENT_COUNT-1)) == 0);
+
+
+gb_internal gbProfileThread *gb__profile_register_thread(void) {
+	// NOTE(bill): Straight from the OS so the instrumented allocators are never reentered
+	gbVirtualMemory vm = gb_vm_reserve(NULL, gb_size_of(gbProfileThread));
+	gbProfileThread *t;
+	void *head;
+	if (vm.data == NULL || !gb_vm_commit(vm))
+		return NULL;
+
+	t = cast(gbProfileThread *)vm.data;
+	t->thread_id = gb_thread_current_id();
+	if (gb_atomic32_compare_exchange(&gb__profile_state, 0, 1) == 0) {
+		gb__profile_base_tsc  = gb_rdtsc();
+		gb__profile_base_time = gb_time_now();
+		gb_atomic32_store(&gb__profile_state, 2);
+	}
+
+	do {
+		head = gb_atomic_ptr_load(&gb__profile_threads);
+		t->next = cast(gbProfileThread *)head;
+	} while (gb_atomic_ptr_compare_exchange(&gb__profile_threads, head, t) != head);
+
+	gb__profile_thread = t;
+	return t;
+}
+
+gb_internal gb_inline void gb__profile_push(char const *name) {
+	gbProfileThread *t = gb__profile_thread;
+	gbProfileEvent *e;
+	i64 index;
+	if (t == NULL) {
+		t = gb__profile_register_thread();
+		if (t == NULL)
+			return;
+	}
+	index = t->write_index.value;
+	e = &t->events[index & (GB_PROFILE_EVENT_COUNT-1)];
+	e->name = name;
+	e->tsc  = gb_rdtsc();
+	gb_sfence();
+	gb_atomic64_store(&t->write_index, index+1);
+}
+
+void gb_profile_begin(char const *name) { GB_ASSERT_NOT_NULL(name); gb__profile_push(name); }
+void gb_profile_end(void)               { gb__profile_push(NULL); }
+
+
+f64 gb_profile_cycles_per_second(void) {
+	f64 seconds;
+	if (gb_atomic32_load(&gb__profile_state) != 2)
+		return 0;
+	seconds = gb_time_now() - gb__profile_base_time;
+	if (seconds <= 0)
+		return 0;
+	return cast(f64)(gb_rdtsc() - gb__profile_base_tsc) / seconds;
+}
+
+gb_internal void gb__profile_record_zone(gbProfileFrame *frame, char const *name, u64 cycles) {
+	isize mask = gb_count_of(gb__profile_zone_slots)-1;
+	isize slot = cast(isize)gb_fnv32a(name, gb_strlen(name)) & mask;
+	gbProfileZone *zone;
+
+	// NOTE(bill): Matched by contents as the same literal may have a different address in each translation unit
+	for (;;) {
+		i16 index = gb__profile_zone_slots[slot];
+		if (index == 0) {
+			if (frame->zone_count >= GB_PROFILE_MAX_ZONES)
+				return;
+			zone = &frame->zones[frame->zone_count++];
+			zone->name         = name;
+			zone->count        = 0;
+			zone->total_cycles = 0;
+			zone->max_cycles   = 0;
+			gb__profile_zone_slots[slot] = cast(i16)frame->zone_count;
+			break;
+		}
+		zone = &frame->zones[index-1];
+		if (zone->name == name || gb_strcmp(zone->name, name) == 0)
+			break;
+		slot = (slot+1) & mask;
+	}
+
+	zone->count++;
+	zone->total_cycles += cycles;
+	if (zone->max_cycles < cycles)
+		zone->max_cycles = cycles;
+}
+
+gbProfileFrame const *gb_profile_frame_end(void) {
+	gbProfileFrame *frame = &gb__profile_frame;
+	gbProfileThread *t;
+	isize i, j;
+	u64 end_tsc = gb_rdtsc();
+
+	frame->begin_tsc = gb__profile_frame_tsc ? gb__profile_frame_tsc : gb__profile_base_tsc;
+	frame->end_tsc = end_tsc;
+	frame->cycles_per_second = gb_profile_cycles_per_second();
+	frame->dropped_event_count = 0;
+	frame->zone_count = 0;
+	gb_zero_array(gb__profile_zone_slots, gb_count_of(gb__profile_zone_slots));
+	if (gb_atomic32_load(&gb__profile_state) != 2) {
+		frame->begin_tsc = end_tsc;
+		return frame;
+	}
+
+	for (t = cast(gbProfileThread *)gb_atomic_ptr_load(&gb__profile_threads); t != NULL; t = t->next) {
+		i64 write_index = gb_atomic64_load(&t->write_index);
+		i64 index = t->read_index;
+		gb_lfence();
+
+		if (write_index - index > GB_PROFILE_EVENT_COUNT) {
+			frame->dropped_event_count += write_index - index - GB_PROFILE_EVENT_COUNT;
+			index = write_index - GB_PROFILE_EVENT_COUNT;
+			t->depth = 0; // NOTE(bill): The begins of the open zones may have been lost
+		}
+
+		for (; index < write_index; index++) {
+			gbProfileEvent e = t->events[index & (GB_PROFILE_EVENT_COUNT-1)];
+			if (e.name != NULL) {
+				if (t->depth < GB_PROFILE_MAX_DEPTH)
+					t->stack[t->depth] = e;
+				t->depth++;
+			} else if (t->depth > 0) {
+				t->depth--;
+				if (t->depth < GB_PROFILE_MAX_DEPTH) {
+					gbProfileEvent begin = t->stack[t->depth];
+					gb__profile_record_zone(frame, begin.name, e.tsc - begin.tsc);
+				}
+			}
+		}
+		t->read_index = write_index;
+
+		// NOTE(bill): Anything the writer lapped while it was being read is unreliable
+		write_index = gb_atomic64_load(&t->write_index);
+		if (write_index - t->read_index > GB_PROFILE_EVENT_COUNT) {
+			frame->dropped_event_count += write_index - t->read_index - GB_PROFILE_EVENT_COUNT;
+		}
+	}
+
+	// NOTE(bill): Not gb_sort as that is a zone itself
+	for (i = 1; i < frame->zone_count; i++) {
+		gbProfileZone zone = frame->zones[i];
+		for (j = i; j > 0 && frame->zones[j-1].total_cycles < zone.total_cycles; j--)
+			frame->zones[j] = frame->zones[j-1];
+		frame->zones[j] = zone;
+	}
+
+	gb__profile_frame_tsc = end_tsc;
+	return frame;
+}
+
+void gb_profile_print_frame(gbProfileFrame const *frame, gbFile *f) {
+	f64 ms_per_cycle = frame->cycles_per_second > 0 ? 1000.0 / frame->cycles_per_second : 0;
+	isize i;
+	if (f == NULL)
+		f = gb_file_get_standard(gbFileStandard_Output);
+
+	gb_fprintf(f, "Profile frame %.3f ms, %lld zones, %lld dropped events\n",
+	           cast(f64)(frame->end_tsc - frame->begin_tsc) * ms_per_cycle,
+	           cast(long long)frame->zone_count,
+	           cast(long long)frame->dropped_event_count);
+	gb_fprintf(f, "  %-32s %10s %12s %12s %12s\n", "zone", "count", "total ms", "average us", "max us");
+	for (i = 0; i < frame->zone_count; i++) {
+		gbProfileZone const *zone = &frame->zones[i];
+		gb_fprintf(f, "  %-32s %10lld %12.3f %12.3f %12.3f\n", zone->name,
+		           cast(long long)zone->count,
+		           cast(f64)zone->total_cycles * ms_per_cycle,
+		           cast(f64)zone->total_cycles * ms_per_cycle * 1000.0 / cast(f64)zone->count,
+		           cast(f64)zone->max_cycles * ms_per_cycle * 1000.0);
+	}
+}
+
+b32 gb_profile_write_chrome_trace(char const *filepath) {
+	gbFile file;
+	gbFileWriter w;
+	char buffer[4096];
+	gbProfileThread *t;
+	f64 cycles_per_second = gb_profile_cycles_per_second();
+	f64 us_per_cycle = cycles_per_second > 0 ? 1.0e6 / cycles_per_second : 0;
+	b32 first = true, ok;
+
+	if (gb_file_create(&file, filepath) != gbFileError_None)
+		return false;
+	gb_file_writer_init(&w, &file, buffer, gb_size_of(buffer), gbFileBuffer_Full);
+
+	gb_file_writer_printf(&w, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	for (t = cast(gbProfileThread *)gb_atomic_ptr_load(&gb__profile_threads); t != NULL; t = t->next) {
+		i64 write_index = gb_atomic64_load(&t->write_index);
+		i64 index = gb_max(write_index - GB_PROFILE_EVENT_COUNT, 0);
+		gb_lfence();
+
+		for (; index < write_index; index++) {
+			gbProfileEvent e = t->events[index & (GB_PROFILE_EVENT_COUNT-1)];
+			f64 ts = cast(f64)cast(i64)(e.tsc - gb__profile_base_tsc) * us_per_cycle;
+			gb_file_writer_printf(&w, first ? "\n" : ",\n");
+			first = false;
+			if (e.name != NULL) {
+				char const *c;
+				gb_file_writer_printf(&w, "{\"ph\":\"B\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"name\":\"", t->thread_id, ts);
+				for (c = e.name; *c; c++) {
+					if (*c == '"' || *c == '\\')
+						gb_file_writer_printf(&w, "\\%c", *c);
+					else if (cast(u8)*c < 0x20)
+						gb_file_writer_printf(&w, "\\u%04x", cast(u32)cast(u8)*c);
+					else
+						gb_file_writer_write(&w, c, 1);
+				}
+				gb_file_writer_printf(&w, "\"}");
+			} else {
+				gb_file_writer_printf(&w, "{\"ph\":\"E\",\"pid\":0,\"tid\":%u,\"ts\":%.3f}", t->thread_id, ts);
+			}
+		}
+	}
+	gb_file_writer_printf(&w, "\n]}\n");
+
+	ok = gb_file_writer_flush(&w) && !w.failed;
+	gb_file_close(&file);
+	return ok;
+}
+
+
 ////////////////////////////////////////////////////////////////
 //
 // Miscellany
@@ -0,0 +1,1294 @@
+/* gb_bench.c - Micro-benchmarks for the gb libraries - public domain
+               - no warranty implied; use at your own risk
+
+	Times the hot paths of gb.h and gb_regex.h against the libc equivalents (where there
+	is one) over a range of sizes and input distributions.
+
+===========================================================================
+	Build it like the headers, there is nothing else to it:
+
+		cc -O2 gb_bench.c -o gb_bench -lm -lpthread -ldl   (Linux)
+		cc -O2 gb_bench.c -o gb_bench                      (OSX)
+		cl /O2 gb_bench.c                                  (Windows)
+
+	Usage:
+
+		gb_bench [-filter text] [-csv file] [-quick] [-time ms] [-threads n]
+
+		-filter  - Only run the groups/benchmarks whose name contains text e.g. "sort" or "memcopy"
+		-csv     - Also write every result to file as CSV ("-" for stdout), to compare versions
+		-quick   - Smaller sizes and shorter runs, for a quick check
+		-time    - Minimum time of one measurement in milliseconds (default 50)
+		-threads - Most threads for the scaling runs (default all the hardware threads)
+===========================================================================
+
+NOTES
+	Every benchmark is timed for at least -time, the best of 3 measurements is kept.
+	ns/op is per item: a call for the memory, hash and print procedures, an element for
+	the sorts, a key for the hash tables, an alloc/free pair for the allocators and a
+	byte of text for the regular expressions. The utf8 procedures are a call over the whole
+	text. MB/s is the bytes processed (10^6 bytes).
+	The sorts include copying the unsorted input into place each time.
+
+	The multi-threaded runs start all the threads together and report the total ns/op
+	(i.e. wall time / (threads * ops)), so perfect scaling halves it as the threads double.
+
+CSV columns
+	group,name,case,threads,ns_per_op,mb_per_s,items
+*/
+
+#define GB_IMPLEMENTATION
+#include "gb.h"
+
+#define GB_REGEX_IMPLEMENTATION
+#include "gb_regex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(GB_SYSTEM_WINDOWS)
+#include <regex.h>
+#endif
+
+
+////////////////////////////////////////////////////////////////
+//
+// Harness
+//
+//
+
+#define BENCH_PROC(name) void name(void *data, isize iterations)
+typedef BENCH_PROC(BenchProc);
+
+typedef struct BenchOptions {
+	char const *filter;
+	gbFile *    csv;
+	gbFile      csv_file;
+	b32         quick;
+	f64         min_time;
+	isize       max_threads;
+} BenchOptions;
+
+gb_global BenchOptions    g_bench;
+gb_global u64 volatile    g_bench_sink; // NOTE(bill): Results go here so they cannot be optimized out
+gb_global char const *    g_bench_group = "";
+gb_global f64             g_bench_elapsed = -1; // NOTE(bill): Set by procedures which time themselves
+
+gb_internal b32 bench_wanted(char const *name) {
+	if (g_bench.filter == NULL)
+		return true;
+	return strstr(g_bench_group, g_bench.filter) != NULL || strstr(name, g_bench.filter) != NULL;
+}
+
+gb_internal f64 bench_time(BenchProc *proc, void *data, isize iterations) {
+	f64 start = gb_time_now(), elapsed;
+	g_bench_elapsed = -1;
+	proc(data, iterations);
+	elapsed = gb_time_now() - start;
+	return g_bench_elapsed >= 0 ? g_bench_elapsed : elapsed;
+}
+
+// NOTE(bill): items - operations done by one iteration, bytes - bytes processed by one iteration (0 if it does not apply)
+gb_internal void bench_run(char const *name, char const *label, isize threads, isize items, isize bytes, BenchProc *proc, void *data) {
+	isize iterations = 1, i;
+	f64 best, ns_per_op, mb_per_s;
+
+	if (!bench_wanted(name))
+		return;
+
+	proc(data, 1); // NOTE(bill): Warm up
+	for (;;) {
+		f64 t = bench_time(proc, data, iterations);
+		f64 scale;
+		if (t >= g_bench.min_time)
+			break;
+		scale = t > 0 ? 1.2 * g_bench.min_time / t : 100;
+		scale = gb_clamp(scale, 2, 100);
+		iterations = cast(isize)(cast(f64)iterations * scale);
+	}
+	best = bench_time(proc, data, iterations);
+	for (i = 1; i < 3; i++) {
+		f64 t = bench_time(proc, data, iterations);
+		if (best > t) best = t;
+	}
+
+	ns_per_op = best * 1.0e9 / (cast(f64)iterations * cast(f64)items);
+	mb_per_s  = bytes > 0 ? cast(f64)bytes * cast(f64)iterations / best * 1.0e-6 : 0;
+
+	if (bytes > 0)
+		gb_printf("  %-28s %-22s %3td %12.2f ns/op %12.1f MB/s\n", name, label, threads, ns_per_op, mb_per_s);
+	else
+		gb_printf("  %-28s %-22s %3td %12.2f ns/op\n", name, label, threads, ns_per_op);
+
+	if (g_bench.csv) {
+		gb_fprintf(g_bench.csv, "%s,%s,%s,%td,%.3f,%.3f,%td\n",
+		           g_bench_group, name, label, threads, ns_per_op, mb_per_s, items);
+	}
+}
+
+gb_internal void bench_group(char const *group) {
+	g_bench_group = group;
+	gb_printf("\n%s\n", group);
+}
+
+
+// NOTE(bill): Deterministic so every run (and version) sees the same data
+gb_global u64 g_bench_random_state = 0x9e3779b97f4a7c15ull;
+
+gb_internal u64 bench_random(void) {
+	u64 z = (g_bench_random_state += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+typedef enum BenchDistribution {
+	BenchDistribution_Random,
+	BenchDistribution_Sorted,
+	BenchDistribution_Reversed,
+	BenchDistribution_FewUnique,
+	BenchDistribution_NearlySorted,
+
+	BenchDistribution_Count,
+} BenchDistribution;
+
+gb_global char const *g_bench_distribution_names[BenchDistribution_Count] = {
+	"random", "sorted", "reversed", "few_unique", "nearly_sorted",
+};
+
+gb_internal void bench_fill_i32(i32 *items, isize count, BenchDistribution d) {
+	isize i;
+	for (i = 0; i < count; i++) {
+		switch (d) {
+		case BenchDistribution_Random:       items[i] = cast(i32)(bench_random() & 0x7fffffff); break;
+		case BenchDistribution_Sorted:       items[i] = cast(i32)i;                             break;
+		case BenchDistribution_Reversed:     items[i] = cast(i32)(count-i);                     break;
+		case BenchDistribution_FewUnique:    items[i] = cast(i32)(bench_random() % 16);         break;
+		case BenchDistribution_NearlySorted: items[i] = cast(i32)i;                             break;
+		default: break;
+		}
+	}
+	if (d == BenchDistribution_NearlySorted) {
+		for (i = 0; i < count/100 + 1; i++) {
+			isize a = cast(isize)(bench_random() % cast(u64)count);
+			isize b = cast(isize)(bench_random() % cast(u64)count);
+			gb_swap(i32, items[a], items[b]);
+		}
+	}
+}
+
+
+// NOTE(bill): Runs proc on `count` threads at once, the calling thread is one of them
+typedef struct BenchThreads {
+	BenchProc *proc;
+	void *     data;
+	isize      iterations;
+	gbAtomic32 ready;
+	gbAtomic32 go;
+} BenchThreads;
+
+gb_global BenchThreads g_bench_threads;
+
+gb_internal GB_THREAD_PROC(bench_thread_proc) {
+	BenchThreads *bt = cast(BenchThreads *)data;
+	gb_atomic32_fetch_add(&bt->ready, 1);
+	while (gb_atomic32_load(&bt->go) == 0)
+		gb_yield_thread();
+	bt->proc(bt->data, bt->iterations);
+}
+
+typedef struct BenchThreaded {
+	BenchProc *proc;
+	void *     data;
+	isize      thread_count;
+} BenchThreaded;
+
+gb_internal BENCH_PROC(bench_threaded_proc) {
+	BenchThreaded *t = cast(BenchThreaded *)data;
+	BenchThreads *bt = &g_bench_threads;
+	gbThread threads[GB_JOB_MAX_WORKERS];
+	isize i;
+	f64 start;
+
+	bt->proc       = t->proc;
+	bt->data       = t->data;
+	bt->iterations = iterations;
+	gb_atomic32_store(&bt->ready, 0);
+	gb_atomic32_store(&bt->go, 0);
+	for (i = 1; i < t->thread_count; i++) {
+		gb_thread_init(&threads[i]);
+		gb_thread_start(&threads[i], bench_thread_proc, bt);
+	}
+	while (gb_atomic32_load(&bt->ready) != t->thread_count-1)
+		gb_yield_thread();
+	// NOTE(bill): Starting the threads is not part of the time
+	start = gb_time_now();
+	gb_atomic32_store(&bt->go, 1);
+	t->proc(t->data, iterations);
+	for (i = 1; i < t->thread_count; i++)
+		gb_thread_join(&threads[i]);
+	g_bench_elapsed = gb_time_now() - start;
+	for (i = 1; i < t->thread_count; i++)
+		gb_thread_destory(&threads[i]);
+}
+
+gb_internal void bench_run_threads(char const *name, char const *label, isize thread_count, BenchProc *proc, void *data) {
+	BenchThreaded t;
+	t.proc = proc;
+	t.data = data;
+	t.thread_count = thread_count;
+	bench_run(name, label, thread_count, thread_count, 0, bench_threaded_proc, &t);
+}
+
+gb_internal char const *bench_size_label(isize size) {
+	gb_local_persist char buffers[4][32];
+	gb_local_persist isize index = 0;
+	char *buf = buffers[index++ & 3];
+	if (size >= (1<<20) && (size & ((1<<20)-1)) == 0)
+		gb_snprintf(buf, 32, "%tdM", size >> 20);
+	else if (size >= (1<<10) && (size & ((1<<10)-1)) == 0)
+		gb_snprintf(buf, 32, "%tdK", size >> 10);
+	else
+		gb_snprintf(buf, 32, "%td", size);
+	return buf;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Memory
+//
+//
+
+typedef struct BenchMemory {
+	u8 *  dest;
+	u8 *  src;
+	isize size;
+} BenchMemory;
+
+gb_internal BENCH_PROC(bench_gb_memcopy)    { BenchMemory *m = cast(BenchMemory *)data; while (iterations--) { gb_memcopy(m->dest, m->src, m->size); g_bench_sink += m->dest[0]; } }
+gb_internal BENCH_PROC(bench_libc_memcpy)   { BenchMemory *m = cast(BenchMemory *)data; while (iterations--) { memcpy(m->dest, m->src, m->size);     g_bench_sink += m->dest[0]; } }
+gb_internal BENCH_PROC(bench_gb_memmove)    { BenchMemory *m = cast(BenchMemory *)data; while (iterations--) { gb_memmove(m->dest+1, m->dest, m->size); g_bench_sink += m->dest[1]; } }
+gb_internal BENCH_PROC(bench_libc_memmove)  { BenchMemory *m = cast(BenchMemory *)data; while (iterations--) { memmove(m->dest+1, m->dest, m->size);    g_bench_sink += m->dest[1]; } }
+gb_internal BENCH_PROC(bench_gb_memset)     { BenchMemory *m = cast(BenchMemory *)data; while (iterations--) { gb_memset(m->dest, cast(u8)iterations, m->size); g_bench_sink += m->dest[0]; } }
+gb_internal BENCH_PROC(bench_libc_memset)   { BenchMemory *m = cast(BenchMemory *)data; while (iterations--) { memset(m->dest, cast(u8)iterations, m->size);    g_bench_sink += m->dest[0]; } }
+gb_internal BENCH_PROC(bench_gb_memcompare) { BenchMemory *m = cast(BenchMemory *)data; while (iterations--) { g_bench_sink += gb_memcompare(m->dest, m->src, m->size); } }
+gb_internal BENCH_PROC(bench_libc_memcmp)   { BenchMemory *m = cast(BenchMemory *)data; while (iterations--) { g_bench_sink += memcmp(m->dest, m->src, m->size); } }
+
+gb_internal void bench_memory(void) {
+	isize sizes[] = {16, 256, 4<<10, 64<<10, 1<<20, 16<<20};
+	isize size_count = g_bench.quick ? 4 : gb_count_of(sizes);
+	isize max_size = sizes[size_count-1];
+	u8 *dest = cast(u8 *)malloc(max_size + 64);
+	u8 *src  = cast(u8 *)malloc(max_size + 64);
+	isize i, offset;
+
+	bench_group("memory");
+	for (i = 0; i < max_size + 64; i++) src[i] = cast(u8)bench_random();
+
+	for (offset = 0; offset < 2; offset++) {
+		for (i = 0; i < size_count; i++) {
+			BenchMemory m;
+			char label[32];
+			m.dest = dest;
+			m.src  = src + offset*3; // NOTE(bill): Misaligned source for the second pass
+			m.size = sizes[i];
+			gb_memcopy(dest, m.src, m.size);
+			gb_snprintf(label, gb_size_of(label), "%s%s", bench_size_label(m.size), offset ? " unaligned" : "");
+
+			bench_run("gb_memcopy",    label, 1, 1, m.size, bench_gb_memcopy,    &m);
+			bench_run("memcpy",        label, 1, 1, m.size, bench_libc_memcpy,   &m);
+			bench_run("gb_memmove",    label, 1, 1, m.size, bench_gb_memmove,    &m);
+			bench_run("memmove",       label, 1, 1, m.size, bench_libc_memmove,  &m);
+			bench_run("gb_memset",     label, 1, 1, m.size, bench_gb_memset,     &m);
+			bench_run("memset",        label, 1, 1, m.size, bench_libc_memset,   &m);
+			gb_memcopy(dest, m.src, m.size);
+			bench_run("gb_memcompare", label, 1, 1, m.size, bench_gb_memcompare, &m);
+			bench_run("memcmp",        label, 1, 1, m.size, bench_libc_memcmp,   &m);
+		}
+	}
+
+	free(src);
+	free(dest);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Sorting
+//
+//
+
+typedef struct BenchSort {
+	i32 * input;
+	i32 * items;
+	i32 * temp;
+	isize count;
+} BenchSort;
+
+gb_internal int bench_qsort_cmp(void const *a, void const *b) {
+	i32 x = *cast(i32 const *)a, y = *cast(i32 const *)b;
+	return (x > y) - (x < y);
+}
+
+gb_internal BENCH_PROC(bench_qsort) {
+	BenchSort *s = cast(BenchSort *)data;
+	while (iterations--) {
+		gb_memcopy(s->items, s->input, s->count*gb_size_of(i32));
+		qsort(s->items, s->count, gb_size_of(i32), bench_qsort_cmp);
+		g_bench_sink += s->items[0];
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_sort) {
+	BenchSort *s = cast(BenchSort *)data;
+	while (iterations--) {
+		gb_memcopy(s->items, s->input, s->count*gb_size_of(i32));
+		gb_sort_array(s->items, s->count, gb_i32_cmp(0));
+		g_bench_sink += s->items[0];
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_sort_i32) {
+	BenchSort *s = cast(BenchSort *)data;
+	while (iterations--) {
+		gb_memcopy(s->items, s->input, s->count*gb_size_of(i32));
+		gb_sort_i32(s->items, s->count);
+		g_bench_sink += s->items[0];
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_radix_sort_i32) {
+	BenchSort *s = cast(BenchSort *)data;
+	while (iterations--) {
+		gb_memcopy(s->items, s->input, s->count*gb_size_of(i32));
+		gb_radix_sort(i32)(s->items, s->temp, s->count);
+		g_bench_sink += s->items[0];
+	}
+}
+
+gb_internal void bench_sort(void) {
+	isize counts[] = {1000, 64<<10, 1<<20};
+	isize count_count = g_bench.quick ? 2 : gb_count_of(counts);
+	isize max_count = counts[count_count-1];
+	BenchSort s;
+	isize i, d;
+
+	bench_group("sort");
+	s.input = cast(i32 *)malloc(max_count*gb_size_of(i32));
+	s.items = cast(i32 *)malloc(max_count*gb_size_of(i32));
+	s.temp  = cast(i32 *)malloc(max_count*gb_size_of(i32));
+
+	for (i = 0; i < count_count; i++) {
+		for (d = 0; d < BenchDistribution_Count; d++) {
+			char label[32];
+			s.count = counts[i];
+			bench_fill_i32(s.input, s.count, cast(BenchDistribution)d);
+			gb_snprintf(label, gb_size_of(label), "%s %s", bench_size_label(s.count), g_bench_distribution_names[d]);
+
+			bench_run("qsort",              label, 1, s.count, s.count*gb_size_of(i32), bench_qsort,             &s);
+			bench_run("gb_sort",            label, 1, s.count, s.count*gb_size_of(i32), bench_gb_sort,           &s);
+			bench_run("gb_sort_i32",        label, 1, s.count, s.count*gb_size_of(i32), bench_gb_sort_i32,       &s);
+			bench_run("gb_radix_sort(i32)", label, 1, s.count, s.count*gb_size_of(i32), bench_gb_radix_sort_i32, &s);
+		}
+	}
+
+	free(s.temp);
+	free(s.items);
+	free(s.input);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Hash Tables
+//
+//
+
+GB_TABLE(extern, BenchTable, bench_table_, u64);
+GB_TABLE_OA(extern, BenchTableOA, bench_table_oa_, u64);
+
+typedef struct BenchHashTable {
+	u64 *        keys;
+	u64 *        missing_keys;
+	u64 *        sorted_keys;
+	isize        count;
+	BenchTable   table;
+	BenchTableOA table_oa;
+} BenchHashTable;
+
+gb_internal BENCH_PROC(bench_gb_table_set) {
+	BenchHashTable *h = cast(BenchHashTable *)data;
+	while (iterations--) {
+		BenchTable t;
+		isize i;
+		bench_table_init(&t, gb_heap_allocator());
+		for (i = 0; i < h->count; i++)
+			bench_table_set(&t, h->keys[i], h->keys[i]);
+		g_bench_sink += gb_array_count(t.entries);
+		bench_table_destroy(&t);
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_table_oa_set) {
+	BenchHashTable *h = cast(BenchHashTable *)data;
+	while (iterations--) {
+		BenchTableOA t;
+		isize i;
+		bench_table_oa_init(&t, gb_heap_allocator());
+		for (i = 0; i < h->count; i++)
+			bench_table_oa_set(&t, h->keys[i], h->keys[i]);
+		g_bench_sink += t.count;
+		bench_table_oa_destroy(&t);
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_table_get) {
+	BenchHashTable *h = cast(BenchHashTable *)data;
+	u64 const *keys = cast(u64 const *)h->missing_keys;
+	while (iterations--) {
+		isize i;
+		for (i = 0; i < h->count; i++) {
+			u64 *v = bench_table_get(&h->table, keys[i]);
+			g_bench_sink += v ? *v : 1;
+		}
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_table_oa_get) {
+	BenchHashTable *h = cast(BenchHashTable *)data;
+	u64 const *keys = cast(u64 const *)h->missing_keys;
+	while (iterations--) {
+		isize i;
+		for (i = 0; i < h->count; i++) {
+			u64 *v = bench_table_oa_get(&h->table_oa, keys[i]);
+			g_bench_sink += v ? *v : 1;
+		}
+	}
+}
+
+gb_internal int bench_u64_cmp(void const *a, void const *b) {
+	u64 x = *cast(u64 const *)a, y = *cast(u64 const *)b;
+	return (x > y) - (x < y);
+}
+
+gb_internal BENCH_PROC(bench_libc_bsearch) {
+	BenchHashTable *h = cast(BenchHashTable *)data;
+	u64 const *keys = cast(u64 const *)h->missing_keys;
+	while (iterations--) {
+		isize i;
+		for (i = 0; i < h->count; i++) {
+			u64 *v = cast(u64 *)bsearch(&keys[i], h->sorted_keys, h->count, gb_size_of(u64), bench_u64_cmp);
+			g_bench_sink += v ? *v : 1;
+		}
+	}
+}
+
+gb_internal void bench_hash_table(void) {
+	isize counts[] = {1000, 64<<10, 1<<20};
+	isize count_count = g_bench.quick ? 2 : gb_count_of(counts);
+	isize max_count = counts[count_count-1];
+	BenchHashTable h;
+	isize i, j, sequential;
+
+	bench_group("hash_table");
+	h.keys         = cast(u64 *)malloc(max_count*gb_size_of(u64));
+	h.missing_keys = cast(u64 *)malloc(max_count*gb_size_of(u64));
+	h.sorted_keys  = cast(u64 *)malloc(max_count*gb_size_of(u64));
+
+	for (sequential = 0; sequential < 2; sequential++) {
+		for (i = 0; i < count_count; i++) {
+			u64 *found_keys;
+			char label[32];
+			h.count = counts[i];
+			for (j = 0; j < h.count; j++) {
+				// NOTE(bill): The missing keys have the top bit set, the present keys never do
+				h.keys[j]         = sequential ? cast(u64)j : bench_random() >> 1;
+				h.missing_keys[j] = sequential ? cast(u64)(h.count+j) | (1ull<<63) : bench_random() | (1ull<<63);
+			}
+			gb_memcopy(h.sorted_keys, h.keys, h.count*gb_size_of(u64));
+			qsort(h.sorted_keys, h.count, gb_size_of(u64), bench_u64_cmp);
+
+			bench_table_init(&h.table, gb_heap_allocator());
+			bench_table_oa_init(&h.table_oa, gb_heap_allocator());
+			for (j = 0; j < h.count; j++) {
+				bench_table_set(&h.table, h.keys[j], h.keys[j]);
+				bench_table_oa_set(&h.table_oa, h.keys[j], h.keys[j]);
+			}
+
+			gb_snprintf(label, gb_size_of(label), "%s %s", bench_size_label(h.count), sequential ? "sequential" : "random");
+			bench_run("GB_TABLE set",    label, 1, h.count, 0, bench_gb_table_set,    &h);
+			bench_run("GB_TABLE_OA set", label, 1, h.count, 0, bench_gb_table_oa_set, &h);
+
+			// NOTE(bill): The get procedures look up `missing_keys`, swap in the present keys for the hits
+			found_keys = h.missing_keys;
+			h.missing_keys = h.keys;
+			gb_snprintf(label, gb_size_of(label), "%s %s hit", bench_size_label(h.count), sequential ? "sequential" : "random");
+			bench_run("GB_TABLE get",    label, 1, h.count, 0, bench_gb_table_get,    &h);
+			bench_run("GB_TABLE_OA get", label, 1, h.count, 0, bench_gb_table_oa_get, &h);
+			bench_run("bsearch",         label, 1, h.count, 0, bench_libc_bsearch,    &h);
+			h.missing_keys = found_keys;
+
+			gb_snprintf(label, gb_size_of(label), "%s %s miss", bench_size_label(h.count), sequential ? "sequential" : "random");
+			bench_run("GB_TABLE get",    label, 1, h.count, 0, bench_gb_table_get,    &h);
+			bench_run("GB_TABLE_OA get", label, 1, h.count, 0, bench_gb_table_oa_get, &h);
+			bench_run("bsearch",         label, 1, h.count, 0, bench_libc_bsearch,    &h);
+
+			bench_table_destroy(&h.table);
+			bench_table_oa_destroy(&h.table_oa);
+		}
+	}
+
+	free(h.sorted_keys);
+	free(h.missing_keys);
+	free(h.keys);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Hash Functions
+//
+//
+
+typedef struct BenchHash {
+	u8 *  data;
+	isize size;
+} BenchHash;
+
+#define BENCH_HASH_PROC(name, call) \
+gb_internal BENCH_PROC(name) { \
+	BenchHash *h = cast(BenchHash *)data; \
+	while (iterations--) { g_bench_sink += call(h->data, h->size); } \
+}
+
+BENCH_HASH_PROC(bench_gb_adler32,  gb_adler32);
+BENCH_HASH_PROC(bench_gb_crc32,    gb_crc32);
+BENCH_HASH_PROC(bench_gb_crc64,    gb_crc64);
+BENCH_HASH_PROC(bench_gb_fnv32a,   gb_fnv32a);
+BENCH_HASH_PROC(bench_gb_fnv64a,   gb_fnv64a);
+BENCH_HASH_PROC(bench_gb_murmur32, gb_murmur32);
+BENCH_HASH_PROC(bench_gb_murmur64, gb_murmur64);
+
+gb_internal void bench_hash(void) {
+	isize sizes[] = {8, 64, 1<<10, 64<<10};
+	BenchHash h;
+	isize i;
+
+	// NOTE(bill): There is no libc equivalent, these are measured against each other
+	bench_group("hash");
+	h.data = cast(u8 *)malloc(sizes[gb_count_of(sizes)-1]);
+	for (i = 0; i < sizes[gb_count_of(sizes)-1]; i++) h.data[i] = cast(u8)bench_random();
+
+	for (i = 0; i < gb_count_of(sizes); i++) {
+		char const *label = bench_size_label(sizes[i]);
+		h.size = sizes[i];
+		bench_run("gb_adler32",  label, 1, 1, h.size, bench_gb_adler32,  &h);
+		bench_run("gb_crc32",    label, 1, 1, h.size, bench_gb_crc32,    &h);
+		bench_run("gb_crc64",    label, 1, 1, h.size, bench_gb_crc64,    &h);
+		bench_run("gb_fnv32a",   label, 1, 1, h.size, bench_gb_fnv32a,   &h);
+		bench_run("gb_fnv64a",   label, 1, 1, h.size, bench_gb_fnv64a,   &h);
+		bench_run("gb_murmur32", label, 1, 1, h.size, bench_gb_murmur32, &h);
+		bench_run("gb_murmur64", label, 1, 1, h.size, bench_gb_murmur64, &h);
+	}
+
+	free(h.data);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// UTF-8
+//
+//
+
+typedef struct BenchUtf8 {
+	u8 *  text;
+	u16 * wide;
+	u8 *  out;
+	isize size;
+	isize wide_count;
+} BenchUtf8;
+
+gb_internal BENCH_PROC(bench_gb_utf8_validate) {
+	BenchUtf8 *u = cast(BenchUtf8 *)data;
+	while (iterations--) { g_bench_sink += gb_utf8_validate(u->text, u->size); }
+}
+gb_internal BENCH_PROC(bench_gb_utf8_count) {
+	BenchUtf8 *u = cast(BenchUtf8 *)data;
+	while (iterations--) { g_bench_sink += gb_utf8_count(u->text, u->size); }
+}
+// NOTE(bill): What walking the text one codepoint at a time costs
+gb_internal BENCH_PROC(bench_gb_utf8_decode) {
+	BenchUtf8 *u = cast(BenchUtf8 *)data;
+	while (iterations--) {
+		isize i = 0;
+		Rune r, sum = 0;
+		while (i < u->size) {
+			i += gb_utf8_decode(u->text+i, u->size-i, &r);
+			sum += r;
+		}
+		g_bench_sink += sum;
+	}
+}
+gb_internal BENCH_PROC(bench_gb_utf8_to_utf16) {
+	BenchUtf8 *u = cast(BenchUtf8 *)data;
+	while (iterations--) { g_bench_sink += gb_utf8_to_utf16(u->wide, u->size, u->text, u->size, NULL); }
+}
+gb_internal BENCH_PROC(bench_gb_utf16_to_utf8) {
+	BenchUtf8 *u = cast(BenchUtf8 *)data;
+	while (iterations--) { g_bench_sink += gb_utf16_to_utf8(u->out, u->size, u->wide, u->wide_count, NULL); }
+}
+
+gb_internal void bench_utf8(void) {
+	// NOTE(bill): English is nearly all ASCII, the mixed text is 1, 2 and 3 byte codepoints and a few 4 byte ones
+	gb_local_persist Rune const mixed[] = {'a', 'b', ' ', 0xe9, 0x3b1, 0x436, 0x4e2d, 0x6587, 0x20ac, 0x1f600};
+	char const *kinds[] = {"ascii", "mixed"};
+	isize sizes[] = {1<<10, 64<<10};
+	isize max_size = sizes[gb_count_of(sizes)-1];
+	BenchUtf8 u;
+	isize i, k;
+
+	bench_group("utf8");
+	u.text = cast(u8 *) malloc(max_size);
+	u.wide = cast(u16 *)malloc(max_size*gb_size_of(u16));
+	u.out  = cast(u8 *) malloc(max_size);
+
+	for (k = 0; k < gb_count_of(kinds); k++) {
+		for (i = 0; i < gb_count_of(sizes); i++) {
+			char label[32];
+			isize n = 0;
+			while (n < sizes[i]) {
+				Rune r = k == 0 ? cast(Rune)(' ' + bench_random() % 95) : mixed[bench_random() % gb_count_of(mixed)];
+				if (n+4 > sizes[i])
+					break;
+				n += gb_utf8_encode_rune(u.text+n, r);
+			}
+			u.size = n;
+			u.wide_count = gb_utf8_to_utf16(u.wide, max_size, u.text, u.size, NULL);
+			GB_ASSERT(u.wide_count >= 0);
+
+			gb_snprintf(label, gb_size_of(label), "%s %s", kinds[k], bench_size_label(sizes[i]));
+			bench_run("gb_utf8_validate", label, 1, 1, u.size, bench_gb_utf8_validate, &u);
+			bench_run("gb_utf8_count",    label, 1, 1, u.size, bench_gb_utf8_count,    &u);
+			bench_run("gb_utf8_decode",   label, 1, 1, u.size, bench_gb_utf8_decode,   &u);
+			bench_run("gb_utf8_to_utf16", label, 1, 1, u.size, bench_gb_utf8_to_utf16, &u);
+			bench_run("gb_utf16_to_utf8", label, 1, 1, u.size, bench_gb_utf16_to_utf8, &u);
+		}
+	}
+
+	free(u.out);
+	free(u.wide);
+	free(u.text);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Printing
+//
+//
+
+typedef enum BenchFormat {
+	BenchFormat_Int,
+	BenchFormat_String,
+	BenchFormat_Float,
+	BenchFormat_Exponent,
+	BenchFormat_Mixed,
+
+	BenchFormat_Count,
+} BenchFormat;
+
+gb_global char const *g_bench_format_names[BenchFormat_Count] = {
+	"%d", "%s", "%.3f", "%e", "%-8s|%5d|%08.3f|%x",
+};
+
+typedef struct BenchPrint {
+	BenchFormat format;
+	i32         ints[64];
+	f64         floats[64];
+	char        buffer[256];
+} BenchPrint;
+
+// NOTE(bill): The formats are written out at each call so the compilers can check them
+#define BENCH_PRINT_PROC(name, print) \
+gb_internal BENCH_PROC(name) { \
+	BenchPrint *p = cast(BenchPrint *)data; \
+	isize n = 0; \
+	while (iterations--) { \
+		i32 x = p->ints[iterations & 63]; \
+		f64 f = p->floats[iterations & 63]; \
+		switch (p->format) { \
+		case BenchFormat_Int:      n += print(p->buffer, gb_size_of(p->buffer), "%d", x);                                    break; \
+		case BenchFormat_String:   n += print(p->buffer, gb_size_of(p->buffer), "%s", "gb_snprintf");                        break; \
+		case BenchFormat_Float:    n += print(p->buffer, gb_size_of(p->buffer), "%.3f", f);                                  break; \
+		case BenchFormat_Exponent: n += print(p->buffer, gb_size_of(p->buffer), "%e", f);                                    break; \
+		case BenchFormat_Mixed:    n += print(p->buffer, gb_size_of(p->buffer), "%-8s|%5d|%08.3f|%x", "name", x, f, x);      break; \
+		default: break; \
+		} \
+	} \
+	g_bench_sink += cast(u64)n + cast(u8)p->buffer[0]; \
+}
+
+BENCH_PRINT_PROC(bench_gb_snprintf,   gb_snprintf);
+BENCH_PRINT_PROC(bench_libc_snprintf, snprintf);
+
+gb_internal void bench_print(void) {
+	BenchPrint p;
+	isize i;
+
+	bench_group("print");
+	for (i = 0; i < 64; i++) {
+		p.ints[i]   = cast(i32)(bench_random() % 2000001) - 1000000;
+		p.floats[i] = cast(f64)(bench_random() % 10000000) / 997.0 - 5000.0;
+	}
+	for (i = 0; i < BenchFormat_Count; i++) {
+		p.format = cast(BenchFormat)i;
+		bench_run("gb_snprintf", g_bench_format_names[i], 1, 1, 0, bench_gb_snprintf,   &p);
+		bench_run("snprintf",    g_bench_format_names[i], 1, 1, 0, bench_libc_snprintf, &p);
+	}
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Allocators
+//
+//
+
+#define BENCH_ALLOCATION_BATCH 1024
+
+typedef struct BenchAllocator {
+	gbAllocator allocator;
+	isize       size;
+	b32         free_all; // NOTE(bill): The arena and scratch memory cannot free one allocation
+	isize       order[BENCH_ALLOCATION_BATCH]; // NOTE(bill): Order the batch is freed in
+	void *      ptrs[BENCH_ALLOCATION_BATCH];
+} BenchAllocator;
+
+// NOTE(bill): Without gbAllocatorFlag_ClearToZero (which gb_alloc uses by default) to match malloc
+gb_internal void *bench_alloc(gbAllocator a, isize size) {
+	return a.proc(a.data, gbAllocation_Alloc, size, GB_DEFAULT_MEMORY_ALIGNMENT, NULL, 0, 0);
+}
+
+gb_internal BENCH_PROC(bench_malloc_pair) {
+	BenchAllocator *b = cast(BenchAllocator *)data;
+	while (iterations--) {
+		void *p = malloc(b->size);
+		g_bench_sink += cast(uintptr)p;
+		free(p);
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_alloc_pair) {
+	BenchAllocator *b = cast(BenchAllocator *)data;
+	while (iterations--) {
+		void *p = bench_alloc(b->allocator, b->size);
+		g_bench_sink += cast(uintptr)p;
+		if (b->free_all)
+			gb_free_all(b->allocator);
+		else
+			gb_free(b->allocator, p);
+	}
+}
+
+gb_internal BENCH_PROC(bench_malloc_batch) {
+	BenchAllocator *b = cast(BenchAllocator *)data;
+	while (iterations--) {
+		isize i;
+		for (i = 0; i < BENCH_ALLOCATION_BATCH; i++)
+			b->ptrs[i] = malloc(b->size);
+		g_bench_sink += cast(uintptr)b->ptrs[0];
+		for (i = 0; i < BENCH_ALLOCATION_BATCH; i++)
+			free(b->ptrs[b->order[i]]);
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_alloc_batch) {
+	BenchAllocator *b = cast(BenchAllocator *)data;
+	while (iterations--) {
+		isize i;
+		for (i = 0; i < BENCH_ALLOCATION_BATCH; i++)
+			b->ptrs[i] = bench_alloc(b->allocator, b->size);
+		g_bench_sink += cast(uintptr)b->ptrs[0];
+		if (b->free_all) {
+			gb_free_all(b->allocator);
+		} else {
+			for (i = 0; i < BENCH_ALLOCATION_BATCH; i++)
+				gb_free(b->allocator, b->ptrs[b->order[i]]);
+		}
+	}
+}
+
+gb_internal void bench_allocator_pair(BenchAllocator *b, char const *name, char const *size_label, gbAllocator a, b32 free_all) {
+	char label[48];
+	b->allocator = a;
+	b->free_all  = free_all;
+	gb_snprintf(label, gb_size_of(label), "%s pair", size_label);
+	bench_run(name, label, 1, 1, 0, bench_gb_alloc_pair, b);
+	gb_snprintf(label, gb_size_of(label), "%s batch", size_label);
+	bench_run(name, label, 1, BENCH_ALLOCATION_BATCH, 0, bench_gb_alloc_batch, b);
+}
+
+gb_internal void bench_allocators(void) {
+	isize sizes[] = {16, 64, 256, 4096};
+	isize region_size = (BENCH_ALLOCATION_BATCH+16) * (4096+64);
+	void *region = malloc(region_size);
+	BenchAllocator *b = cast(BenchAllocator *)malloc(gb_size_of(BenchAllocator));
+	isize i, j;
+
+	bench_group("allocator");
+	for (i = 0; i < BENCH_ALLOCATION_BATCH; i++)
+		b->order[i] = i;
+	for (i = BENCH_ALLOCATION_BATCH-1; i > 0; i--) {
+		j = cast(isize)(bench_random() % cast(u64)(i+1));
+		gb_swap(isize, b->order[i], b->order[j]);
+	}
+
+	for (i = 0; i < gb_count_of(sizes); i++) {
+		char const *size_label = bench_size_label(sizes[i]);
+		char label[48];
+		gbArena arena;
+		gbPool pool;
+		gbFreeList free_list;
+		gbScratchMemory scratch;
+		gbCachedAllocator cached;
+
+		b->size = sizes[i];
+		gb_snprintf(label, gb_size_of(label), "%s pair", size_label);
+		bench_run("malloc", label, 1, 1, 0, bench_malloc_pair, b);
+		gb_snprintf(label, gb_size_of(label), "%s batch", size_label);
+		bench_run("malloc", label, 1, BENCH_ALLOCATION_BATCH, 0, bench_malloc_batch, b);
+
+		bench_allocator_pair(b, "gb_heap_allocator", size_label, gb_heap_allocator(), false);
+
+		gb_arena_init_from_memory(&arena, region, region_size);
+		bench_allocator_pair(b, "gb_arena_allocator", size_label, gb_arena_allocator(&arena), true);
+
+		gb_pool_init(&pool, gb_heap_allocator(), BENCH_ALLOCATION_BATCH, b->size);
+		bench_allocator_pair(b, "gb_pool_allocator", size_label, gb_pool_allocator(&pool), false);
+		gb_pool_free(&pool);
+
+		gb_free_list_init_mode(&free_list, region, region_size, gbFreeListMode_Tlsf);
+		bench_allocator_pair(b, "gb_free_list tlsf", size_label, gb_free_list_allocator(&free_list), false);
+		gb_free_list_init_mode(&free_list, region, region_size, gbFreeListMode_FirstFit);
+		bench_allocator_pair(b, "gb_free_list first_fit", size_label, gb_free_list_allocator(&free_list), false);
+
+		// NOTE(bill): Scratch memory frees in order, so only the pairs are fair to it
+		gb_scratch_memory_init(&scratch, region, region_size);
+		b->allocator = gb_scratch_allocator(&scratch);
+		b->free_all = false;
+		gb_snprintf(label, gb_size_of(label), "%s pair", size_label);
+		bench_run("gb_scratch_allocator", label, 1, 1, 0, bench_gb_alloc_pair, b);
+
+		gb_cached_allocator_init(&cached, gb_heap_allocator());
+		bench_allocator_pair(b, "gb_cached_allocator", size_label, gb_cached_allocator(&cached), false);
+		gb_cached_allocator_destroy(&cached);
+	}
+
+	free(b);
+	free(region);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Regular Expressions
+//
+//
+
+typedef struct BenchRegex {
+	char const *text;
+	isize       text_len;
+	gbRegex     re;
+#if !defined(GB_SYSTEM_WINDOWS)
+	regex_t     posix;
+#endif
+} BenchRegex;
+
+gb_internal BENCH_PROC(bench_gbre_match) {
+	BenchRegex *r = cast(BenchRegex *)data;
+	while (iterations--) {
+		gbreCapture capture;
+		g_bench_sink += gbre_match(&r->re, r->text, r->text_len, &capture, 1);
+		g_bench_sink += cast(uintptr)capture.str;
+	}
+}
+
+#if !defined(GB_SYSTEM_WINDOWS)
+gb_internal BENCH_PROC(bench_regexec) {
+	BenchRegex *r = cast(BenchRegex *)data;
+	while (iterations--) {
+		regmatch_t match;
+		g_bench_sink += regexec(&r->posix, r->text, 1, &match, 0);
+		g_bench_sink += match.rm_so;
+	}
+}
+#endif
+
+gb_internal void bench_regex(void) {
+	// NOTE(bill): Written in the common subset of gb_regex and POSIX extended regular expressions
+	gb_local_persist char const *patterns[][2] = {
+		{"literal",     "status=timeout"},
+		{"class",       "[0-9]+\\.[0-9]+\\.[0-9]+\\.[0-9]+"},
+		{"alternation", "(fatal|panic|abort): [a-z]+"},
+		{"anchored",    "error\n +$"},
+		{"no_match",    "x[0-9]y[0-9]z"},
+	};
+	gb_local_persist char const *words[] = {
+		"request", "served", "user", "cache", "miss", "hit", "status=ok", "latency",
+		"GET", "POST", "session", "worker", "queue", "retry", "done", "info:",
+	};
+	isize text_len = g_bench.quick ? (16<<10) : (256<<10);
+	char *text = cast(char *)malloc(text_len+1);
+	BenchRegex r;
+	isize i, n = 0;
+
+	bench_group("regex");
+	while (n < text_len - 128) {
+		char const *word = words[bench_random() % gb_count_of(words)];
+		isize len = gb_strlen(word);
+		gb_memcopy(text+n, word, len);
+		n += len;
+		text[n++] = (bench_random() % 12) == 0 ? '\n' : ' ';
+	}
+	// NOTE(bill): The matches are at the end so the whole text is searched
+	n += gb_snprintf(text+n, text_len+1-n, "10.0.0.1 status=timeout fatal: error\n") - 1;
+	gb_memset(text+n, ' ', text_len-n);
+	text[text_len] = '\0';
+	r.text = text;
+	r.text_len = text_len;
+
+	for (i = 0; i < gb_count_of(patterns); i++) {
+		char const *pattern = patterns[i][1];
+		char label[64];
+		gb_snprintf(label, gb_size_of(label), "%s %s", patterns[i][0], bench_size_label(text_len));
+
+		if (gbre_compile(&r.re, pattern, gb_strlen(pattern)) == GBRE_ERROR_NONE) {
+			bench_run("gbre_match", label, 1, text_len, text_len, bench_gbre_match, &r);
+			gbre_destroy(&r.re);
+		}
+	#if !defined(GB_SYSTEM_WINDOWS)
+		if (regcomp(&r.posix, pattern, REG_EXTENDED) == 0) {
+			bench_run("regexec", label, 1, text_len, text_len, bench_regexec, &r);
+			regfree(&r.posix);
+		}
+	#endif
+	}
+
+	free(text);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Concurrency
+//
+//
+
+typedef struct BenchShared {
+	gbAtomic64  counter;
+	u8          padding0[GB_CACHE_LINE_SIZE];
+	gbMutex     mutex;
+	u8          padding1[GB_CACHE_LINE_SIZE];
+#if defined(GB_SYSTEM_WINDOWS)
+	SRWLOCK         os_mutex;
+#else
+	pthread_mutex_t os_mutex;
+#endif
+	u8          padding2[GB_CACHE_LINE_SIZE];
+	i64         value;
+	gbMpmcQueue mpmc;
+	gbSpscQueue spsc;
+	gbAtomic32  spsc_done;
+} BenchShared;
+
+gb_global BenchShared g_bench_shared;
+
+gb_internal BENCH_PROC(bench_atomic_fetch_add) {
+	gb_unused(data);
+	while (iterations--)
+		gb_atomic64_fetch_add(&g_bench_shared.counter, 1);
+}
+
+gb_internal BENCH_PROC(bench_gb_mutex) {
+	gb_unused(data);
+	while (iterations--) {
+		gb_mutex_lock(&g_bench_shared.mutex);
+		g_bench_shared.value++;
+		gb_mutex_unlock(&g_bench_shared.mutex);
+	}
+}
+
+gb_internal BENCH_PROC(bench_os_mutex) {
+	gb_unused(data);
+	while (iterations--) {
+	#if defined(GB_SYSTEM_WINDOWS)
+		AcquireSRWLockExclusive(&g_bench_shared.os_mutex);
+		g_bench_shared.value++;
+		ReleaseSRWLockExclusive(&g_bench_shared.os_mutex);
+	#else
+		pthread_mutex_lock(&g_bench_shared.os_mutex);
+		g_bench_shared.value++;
+		pthread_mutex_unlock(&g_bench_shared.os_mutex);
+	#endif
+	}
+}
+
+// NOTE(bill): Every thread pushes then pops so the queue never runs dry or fills up for long
+gb_internal BENCH_PROC(bench_gb_mpmc_queue) {
+	i64 value = 0;
+	gb_unused(data);
+	while (iterations--) {
+		while (!gb_mpmc_queue_push(&g_bench_shared.mpmc, &value))
+			gb_yield_thread();
+		while (!gb_mpmc_queue_pop(&g_bench_shared.mpmc, &value))
+			gb_yield_thread();
+		value++;
+	}
+	g_bench_sink += value;
+}
+
+// NOTE(bill): Run on 2 threads, the first one to start is the producer
+gb_internal BENCH_PROC(bench_gb_spsc_queue) {
+	i64 value;
+	gb_unused(data);
+	if (gb_atomic32_fetch_add(&g_bench_shared.spsc_done, 1) == 0) {
+		// NOTE(bill): Each thread counts its own ops as consumed so both push and pop `iterations` each
+		for (value = 0; value < iterations; value++) {
+			while (!gb_spsc_queue_push(&g_bench_shared.spsc, &value))
+				gb_yield_thread();
+		}
+	} else {
+		isize i;
+		for (i = 0; i < iterations; i++) {
+			while (!gb_spsc_queue_pop(&g_bench_shared.spsc, &value))
+				gb_yield_thread();
+		}
+		g_bench_sink += value;
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_spsc_queue_2) {
+	gb_atomic32_store(&g_bench_shared.spsc_done, 0);
+	bench_threaded_proc(data, iterations);
+}
+
+
+typedef struct BenchJobs {
+	gbJobSystem *js;
+	f64 *        items;
+	u32 *        keys;
+	u32 *        temp;
+	u32 *        input;
+	i32 *        sort_items;
+	i32 *        sort_input;
+	isize        count;
+} BenchJobs;
+
+gb_internal GB_JOB_PROC(bench_job_proc) {
+	gb_unused(data);
+	gb_atomic64_fetch_add(&g_bench_shared.counter, 1);
+}
+
+gb_internal BENCH_PROC(bench_gb_job_run) {
+	BenchJobs *b = cast(BenchJobs *)data;
+	while (iterations--) {
+		gbJobCounter counter = {0};
+		gbJob jobs[64];
+		isize i;
+		for (i = 0; i < gb_count_of(jobs); i++) {
+			jobs[i].proc    = bench_job_proc;
+			jobs[i].data    = NULL;
+			jobs[i].counter = NULL;
+		}
+		gb_job_system_run_jobs(b->js, jobs, gb_count_of(jobs), &counter);
+		gb_job_system_wait(b->js, &counter);
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_parallel_sum) {
+	BenchJobs *b = cast(BenchJobs *)data;
+	while (iterations--)
+		g_bench_sink += cast(u64)gb_parallel_sum(f64)(b->js, b->items, b->count);
+}
+
+gb_internal BENCH_PROC(bench_gb_sort_parallel) {
+	BenchJobs *b = cast(BenchJobs *)data;
+	while (iterations--) {
+		gb_memcopy(b->sort_items, b->sort_input, b->count*gb_size_of(i32));
+		gb_sort_array_parallel(b->js, b->sort_items, b->count, gb_i32_cmp(0));
+		g_bench_sink += b->sort_items[0];
+	}
+}
+
+gb_internal BENCH_PROC(bench_gb_radix_sort_parallel) {
+	BenchJobs *b = cast(BenchJobs *)data;
+	while (iterations--) {
+		gb_memcopy(b->keys, b->input, b->count*gb_size_of(u32));
+		gb_radix_sort_parallel(u32)(b->js, b->keys, b->temp, NULL, NULL, b->count);
+		g_bench_sink += b->keys[0];
+	}
+}
+
+gb_internal void bench_concurrency(void) {
+	BenchShared *s = &g_bench_shared;
+	BenchJobs b;
+	isize thread_counts[64];
+	isize thread_count_count = 0;
+	isize threads, i, t;
+
+	bench_group("concurrency");
+	gb_mutex_init(&s->mutex);
+#if defined(GB_SYSTEM_WINDOWS)
+	InitializeSRWLock(&s->os_mutex);
+#else
+	pthread_mutex_init(&s->os_mutex, NULL);
+#endif
+	gb_mpmc_queue_init(&s->mpmc, gb_heap_allocator(), 1024, gb_size_of(i64));
+	gb_spsc_queue_init(&s->spsc, gb_heap_allocator(), 1024, gb_size_of(i64));
+
+	b.count = g_bench.quick ? (256<<10) : (4<<20);
+	b.items      = cast(f64 *)malloc(b.count*gb_size_of(f64));
+	b.keys       = cast(u32 *)malloc(b.count*gb_size_of(u32));
+	b.temp       = cast(u32 *)malloc(b.count*gb_size_of(u32));
+	b.input      = cast(u32 *)malloc(b.count*gb_size_of(u32));
+	b.sort_items = cast(i32 *)malloc(b.count*gb_size_of(i32));
+	b.sort_input = cast(i32 *)malloc(b.count*gb_size_of(i32));
+	for (i = 0; i < b.count; i++) {
+		b.items[i] = cast(f64)(i & 1023);
+		b.input[i] = cast(u32)bench_random();
+	}
+	bench_fill_i32(b.sort_input, b.count, BenchDistribution_Random);
+
+	// NOTE(bill): Powers of two and then always finish on all the threads
+	for (threads = 1; threads < g_bench.max_threads; threads *= 2)
+		thread_counts[thread_count_count++] = threads;
+	thread_counts[thread_count_count++] = g_bench.max_threads;
+
+	for (t = 0; t < thread_count_count; t++) {
+		gbJobSystem *js;
+		char label[32];
+		threads = thread_counts[t];
+		gb_snprintf(label, gb_size_of(label), "%td threads", threads);
+
+		bench_run_threads("gb_atomic64_fetch_add", label, threads, bench_atomic_fetch_add, NULL);
+		bench_run_threads("gb_mutex",              label, threads, bench_gb_mutex,         NULL);
+	#if defined(GB_SYSTEM_WINDOWS)
+		bench_run_threads("SRWLOCK",               label, threads, bench_os_mutex,         NULL);
+	#else
+		bench_run_threads("pthread_mutex",         label, threads, bench_os_mutex,         NULL);
+	#endif
+		bench_run_threads("gb_mpmc_queue",         label, threads, bench_gb_mpmc_queue,    NULL);
+
+		// NOTE(bill): The job system is big and only needed by the procedures below
+		js = cast(gbJobSystem *)malloc(gb_size_of(gbJobSystem));
+		gb_job_system_init(js, threads, gb_heap_allocator());
+		b.js = js;
+		gb_snprintf(label, gb_size_of(label), "%td workers", threads);
+		bench_run("gb_job_system_run_jobs",       label, threads, 64,       0,                         bench_gb_job_run,             &b);
+		gb_snprintf(label, gb_size_of(label), "%s %td workers", bench_size_label(b.count), threads);
+		bench_run("gb_parallel_sum(f64)",         label, threads, b.count, b.count*gb_size_of(f64), bench_gb_parallel_sum,        &b);
+		bench_run("gb_sort_parallel",             label, threads, b.count, b.count*gb_size_of(i32), bench_gb_sort_parallel,       &b);
+		bench_run("gb_radix_sort_parallel(u32)",  label, threads, b.count, b.count*gb_size_of(u32), bench_gb_radix_sort_parallel, &b);
+		gb_job_system_destroy(js);
+		free(js);
+	}
+
+	if (bench_wanted("gb_spsc_queue")) {
+		BenchThreaded t;
+		t.proc = bench_gb_spsc_queue;
+		t.data = NULL;
+		t.thread_count = 2;
+		bench_run("gb_spsc_queue", "producer+consumer", 2, 1, 0, bench_gb_spsc_queue_2, &t);
+	}
+
+	free(b.sort_input);
+	free(b.sort_items);
+	free(b.input);
+	free(b.temp);
+	free(b.keys);
+	free(b.items);
+	gb_spsc_queue_destroy(&s->spsc);
+	gb_mpmc_queue_destroy(&s->mpmc);
+#if !defined(GB_SYSTEM_WINDOWS)
+	pthread_mutex_destroy(&s->os_mutex);
+#endif
+	gb_mutex_destroy(&s->mutex);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// Main
+//
+//
+
+int main(int argc, char **argv) {
+	gbAffinity affinity;
+	isize i;
+
+	g_bench.min_time = 0.05;
+	gb_affinity_init(&affinity);
+	g_bench.max_threads = gb_clamp(affinity.thread_count, 1, GB_JOB_MAX_WORKERS);
+	gb_affinity_destroy(&affinity);
+
+	for (i = 1; i < argc; i++) {
+		char const *arg = argv[i];
+		char const *value = i+1 < argc ? argv[i+1] : NULL;
+		if (gb_strcmp(arg, "-quick") == 0) {
+			g_bench.quick = true;
+			g_bench.min_time = 0.01;
+		} else if (gb_strcmp(arg, "-filter") == 0 && value) {
+			g_bench.filter = value; i++;
+		} else if (gb_strcmp(arg, "-time") == 0 && value) {
+			g_bench.min_time = cast(f64)gb_str_to_i64(value, NULL, 10) * 0.001; i++;
+		} else if (gb_strcmp(arg, "-threads") == 0 && value) {
+			g_bench.max_threads = gb_clamp(cast(isize)gb_str_to_i64(value, NULL, 10), 1, GB_JOB_MAX_WORKERS); i++;
+		} else if (gb_strcmp(arg, "-csv") == 0 && value) {
+			if (gb_strcmp(value, "-") == 0) {
+				g_bench.csv = gb_file_get_standard(gbFileStandard_Output);
+			} else if (gb_file_create(&g_bench.csv_file, value) == gbFileError_None) {
+				g_bench.csv = &g_bench.csv_file;
+			} else {
+				gb_printf_err("Could not create %s\n", value);
+				return 1;
+			}
+			i++;
+		} else {
+			gb_printf_err("Usage: %s [-filter text] [-csv file] [-quick] [-time ms] [-threads n]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	gb_printf("gb_bench: %d bit, %td threads, %.0f ms per measurement\n",
+	          cast(int)(8*gb_size_of(void *)), g_bench.max_threads, g_bench.min_time*1000.0);
+	gb_printf("  %-28s %-22s %3s %18s\n", "name", "case", "thr", "time");
+	if (g_bench.csv)
+		gb_fprintf(g_bench.csv, "group,name,case,threads,ns_per_op,mb_per_s,items\n");
+
+	bench_memory();
+	bench_sort();
+	bench_hash_table();
+	bench_hash();
+	bench_utf8();
+	bench_print();
+	bench_allocators();
+	bench_regex();
+	bench_concurrency();
+
+	if (g_bench.csv == &g_bench.csv_file)
+		gb_file_close(&g_bench.csv_file);
+	return cast(int)(g_bench_sink & 0); // NOTE(bill): Keep the sink alive
+}
@@ -1,4 +1,4 @@
-/* gb.h - v0.05  - OpenGL Helper Library - public domain
+/* gb.h - v0.11  - OpenGL Helper Library - public domain
                  - no warranty implied; use at your own risk
 
 	This is a single header file with a bunch of useful stuff
@@ -24,7 +24,6 @@
 		This library REQUIRES "gb.h" at this moment in time.
 		If you are using the font library (e.g. GBGL_NO_FONTS is _not_ defined):
 			This library then REQUIRES "stb_truetype.h" for ttf handling
-			This library then REQUIRES "stb_rect_pack.h"
 
 			NOTE(bill): I may remove these dependencies for the font handling by
 			embedding the needed types and procedures.
@@ -55,6 +54,11 @@ Conventions used:
 
 
 Version History:
+	0.11  - Profile zone for gbgl_bs_end
+	0.10  - On demand LRU glyph atlas and hashed glyph lookup
+	0.09  - Persistently mapped stream buffers
+	0.08  - Hashed uniform table and location based uniform setters
+	0.07  - Batched Basic State rendering
 	0.06  - Enum convention change
 	0.05  - gbglColour
 	0.04e - Change brace style because why not?
@@ -95,10 +99,6 @@ CREDITS
 
 
 #if !defined(GBGL_NO_FONTS)
-	#ifndef STB_RECT_PACK_IMPLEMENTATION
-	#include "stb_rect_pack.h"
-	#endif
-
 	#ifndef STB_TRUETYPE_IMPLEMENTATION
 	#include "stb_truetype.h"
 	#endif
@@ -350,16 +350,19 @@ typedef struct gbglTBO {
 // NOTE(bill): usage_hint == (GL_STATIC_DRAW, GL_STREAM_DRAW, GL_DYNAMIC_DRAW)
 GBGL_DEF u32     gbgl_make_vbo(void const *data, isize size, i32 usage_hint);
 GBGL_DEF u32     gbgl_make_ebo(void const *data, isize size, i32 usage_hint);
+GBGL_DEF u32     gbgl_make_ubo(void const *data, isize size, i32 usage_hint);
 GBGL_DEF gbglTBO gbgl_make_tbo(gbglBufferDataType data_type, i32 channel_count, void const *data, isize size, i32 usage_hint);
 
 GBGL_DEF void gbgl_vbo_copy(u32 vbo_handle, void *const data, isize size, isize offset);
 GBGL_DEF void gbgl_ebo_copy(u32 ebo_handle, void *const data, isize size, isize offset);
+GBGL_DEF void gbgl_ubo_copy(u32 ubo_handle, void *const data, isize size, isize offset);
 GBGL_DEF void gbgl_tbo_copy(gbglTBO tbo,    void *const data, isize size, isize offset);
 
 
 
 GBGL_DEF void gbgl_bind_vbo(u32 vbo_handle);
 GBGL_DEF void gbgl_bind_ebo(u32 ebo_handle);
+GBGL_DEF void gbgl_bind_ubo(u32 ubo_handle, u32 binding); // NOTE(bill): See gbgl_set_uniform_block_binding
 GBGL_DEF void gbgl_bind_tbo(gbglTBO tbo, i32 sampler_handle, i32 tex_unit);
 
 // NOTE(bill): access = GL_WRITE_ONLY, etc.
@@ -370,6 +373,58 @@ GBGL_DEF void gbgl_unmap_ebo(void);
 
 
 
+////////////////////////////////////////////////////////////////
+//
+// Stream Buffer
+//
+// A buffer for data which is rewritten every frame (vertices, indices, uniforms) split into a ring
+// of GBGL_STREAM_BUFFER_SEGMENT_COUNT segments.
+//
+// With GL 4.4 (glBufferStorage) the whole buffer is persistently and coherently mapped, and each
+// segment is guarded by a fence so the CPU never writes to memory the GPU may still be reading.
+// Otherwise it falls back to unsynchronized glMapBufferRange writes into unused space and orphans
+// the buffer when the ring wraps around. Define GBGL_NO_PERSISTENT_MAPPING to force the fallback.
+//
+// Usage:
+//	ptr = gbgl_stream_buffer_map(&sb, max_size, alignment, &offset);
+//	// write at most max_size bytes to ptr
+//	gbgl_stream_buffer_unmap(&sb, used_size);
+//	// draw with the buffer bound and the data at `offset`
+//	gbgl_stream_buffer_end_frame(&sb); // once all the draws for the frame have been issued
+//
+// NOTE(bill): The buffer is only ever bound to GL_COPY_WRITE_BUFFER internally so it will not change
+// the bindings of the vao in use.
+//
+
+#ifndef GBGL_STREAM_BUFFER_SEGMENT_COUNT
+#define GBGL_STREAM_BUFFER_SEGMENT_COUNT 3
+#endif
+
+typedef struct gbglStreamBuffer {
+	u32    handle;
+	isize  segment_size;
+	isize  segment_index;
+	isize  offset; // NOTE(bill): Within the current segment
+	u8 *   persistent_ptr; // NOTE(bill): NULL if using the fallback
+	GLsync fences[GBGL_STREAM_BUFFER_SEGMENT_COUNT];
+
+	b32    is_mapped;
+	isize  map_offset;
+	isize  map_size;
+} gbglStreamBuffer;
+
+GBGL_DEF b32   gbgl_init_stream_buffer   (gbglStreamBuffer *sb, isize segment_size);
+GBGL_DEF void  gbgl_destroy_stream_buffer(gbglStreamBuffer *sb);
+GBGL_DEF b32   gbgl_is_stream_buffer_persistent(gbglStreamBuffer const *sb);
+
+// NOTE(bill): `alignment` does not need to be a power of two (e.g. the size of a vertex)
+// `max_size` plus the alignment padding must fit within a segment
+GBGL_DEF void *gbgl_stream_buffer_map      (gbglStreamBuffer *sb, isize max_size, isize alignment, isize *offset);
+GBGL_DEF void  gbgl_stream_buffer_unmap    (gbglStreamBuffer *sb, isize used_size);
+GBGL_DEF void  gbgl_stream_buffer_end_frame(gbglStreamBuffer *sb);
+
+
+
 ////////////////////////////////////////////////////////////////
 //
 // Shader
@@ -399,17 +454,40 @@ typedef enum gbglShaderError {
 	gbglShaderError_Count,
 } gbglShaderError;
 
+// NOTE(bill): The active uniforms are enumerated when the program is linked and are stored in an
+// open addressed hash table (by fnv32a of the name) so that gbgl_get_uniform does not need to
+// scan the names or call into GL. Use gbgl_get_uniform once and the gbgl_set_uniform_*_loc
+// procedures to skip the lookup entirely.
+
 #ifndef GBGL_MAX_UNIFORM_COUNT
-#define GBGL_MAX_UNIFORM_COUNT 32
+#define GBGL_MAX_UNIFORM_COUNT 64
+#endif
+
+#ifndef GBGL_MAX_UNIFORM_NAME_LENGTH
+#define GBGL_MAX_UNIFORM_NAME_LENGTH 64
+#endif
+
+// NOTE(bill): Must be a power of two and larger than GBGL_MAX_UNIFORM_COUNT
+#ifndef GBGL_UNIFORM_TABLE_SIZE
+#define GBGL_UNIFORM_TABLE_SIZE (2*GBGL_MAX_UNIFORM_COUNT)
 #endif
 
+GB_STATIC_ASSERT(((GBGL_UNIFORM_TABLE_SIZE & (GBGL_UNIFORM_TABLE_SIZE-1)) == 0) && GBGL_UNIFORM_TABLE_SIZE > GBGL_MAX_UNIFORM_COUNT);
+
+typedef struct gbglUniform {
+	u32  hash; // NOTE(bill): 0 is an empty slot
+	i32  loc;
+	i32  size; // NOTE(bill): Array element count
+	u32  type; // NOTE(bill): GL_FLOAT_VEC4, GL_SAMPLER_2D, etc.
+	char name[GBGL_MAX_UNIFORM_NAME_LENGTH];
+} gbglUniform;
+
 typedef struct gbglShader {
 	u32 shaders[gbglShader_Count];
 	u32 program;
 
-	i32   uniform_locs[GBGL_MAX_UNIFORM_COUNT];
-	char *uniform_names[GBGL_MAX_UNIFORM_COUNT];
-	i32   uniform_count;
+	gbglUniform uniforms[GBGL_UNIFORM_TABLE_SIZE];
+	i32         uniform_count;
 
 	u32   type_flags;
 
@@ -436,6 +514,7 @@ GBGL_DEF b32  gbgl_reload_shader     (gbglShader *shader); // TODO(bill): Return
 GBGL_DEF void gbgl_use_shader        (gbglShader *shader);
 GBGL_DEF b32  gbgl_is_shader_in_use  (gbglShader *shader);
 
+// NOTE(bill): Returns -1 if the uniform does not exist (which GL ignores)
 GBGL_DEF i32 gbgl_get_uniform(gbglShader *shader, char const *name);
 
 GBGL_DEF void gbgl_set_uniform_int       (gbglShader *s, char const *name, i32 i);
@@ -447,6 +526,19 @@ GBGL_DEF void gbgl_set_uniform_mat4      (gbglShader *s, char const *name, f32 c
 GBGL_DEF void gbgl_set_uniform_mat4_count(gbglShader *s, char const *name, f32 const *m, isize count);
 GBGL_DEF void gbgl_set_uniform_colour    (gbglShader *s, char const *name, gbglColour col);
 
+// NOTE(bill): These set the uniform on the shader currently in use
+GBGL_DEF void gbgl_set_uniform_int_loc       (i32 loc, i32 i);
+GBGL_DEF void gbgl_set_uniform_float_loc     (i32 loc, f32 f);
+GBGL_DEF void gbgl_set_uniform_vec2_loc      (i32 loc, f32 const *v);
+GBGL_DEF void gbgl_set_uniform_vec3_loc      (i32 loc, f32 const *v);
+GBGL_DEF void gbgl_set_uniform_vec4_loc      (i32 loc, f32 const *v);
+GBGL_DEF void gbgl_set_uniform_mat4_loc      (i32 loc, f32 const *m);
+GBGL_DEF void gbgl_set_uniform_mat4_count_loc(i32 loc, f32 const *m, isize count);
+GBGL_DEF void gbgl_set_uniform_colour_loc    (i32 loc, gbglColour col);
+
+// NOTE(bill): Binds the uniform block `name` to the binding point used by gbgl_bind_ubo
+GBGL_DEF b32 gbgl_set_uniform_block_binding(gbglShader *s, char const *name, u32 binding);
+
 
 ////////////////////////////////////////////////////////////////
 //
@@ -536,25 +628,60 @@ GBGL_DEF void gbgl_render_to_screen(i32 width, i32 height);
 
 #if !defined(GBGL_NO_FONTS)
 
-typedef struct gbglGlyphMapKVPair {
-	char32 codepoint;
-	u16    index;
-} gbglGlyphMapKVPair;
+// NOTE(bill): Glyphs are rasterised the first time they are used into square atlas pages which are
+// shared by every font in a gbglFontCache. When all GBGL_FONT_MAX_PAGES pages are full, the least
+// recently used page is evicted and its glyphs are rasterised again when they are next needed.
+// Glyphs are found through an open addressed hash table per font (with a direct table for ASCII)
+// and kerning pairs are cached in the same way as they are first looked up.
+
+#ifndef GBGL_FONT_PAGE_SIZE
+#define GBGL_FONT_PAGE_SIZE 512
+#endif
+
+#ifndef GBGL_FONT_MAX_PAGES
+#define GBGL_FONT_MAX_PAGES 8
+#endif
+
+#ifndef GBGL_FONT_GLYPH_BLOCK_SIZE
+#define GBGL_FONT_GLYPH_BLOCK_SIZE 256
+#endif
 
 typedef struct gbglGlyphInfo {
-	f32 s0, t0, s1, t1;
+	f32 s0, t0, s1, t1; // NOTE(bill): In pixels within the page
 	i16 xoff, yoff;
 	f32 xadv;
+
+	Rune   codepoint;
+	i32    glyph_index; // NOTE(bill): TrueType glyph index, 0 if the font does not have the codepoint
+	i16    width, height;
+	i32    page;        // NOTE(bill): -1 if the glyph has never been rasterised (or has no bitmap)
+	u32    generation;  // NOTE(bill): The glyph is only valid while this matches the generation of the page
 } gbglGlyphInfo;
 
+typedef struct gbglGlyphMapKVPair {
+	Rune           codepoint;
+	gbglGlyphInfo *glyph; // NOTE(bill): NULL is an empty slot
+} gbglGlyphMapKVPair;
+
+// NOTE(bill): Glyphs are allocated in blocks so that gbglGlyphInfo pointers are never invalidated
+typedef struct gbglGlyphBlock {
+	gbglGlyphInfo          glyphs[GBGL_FONT_GLYPH_BLOCK_SIZE];
+	isize                  count;
+	struct gbglGlyphBlock *next;
+} gbglGlyphBlock;
+
 typedef struct gbglKernPair {
-	union {
-		i32 packed;
-		struct { u16 i0, i1; };
-	};
+	u32 key; // NOTE(bill): (left_index << 16) | right_index, 0xffffffff is an empty slot
 	f32 kern;
 } gbglKernPair;
 
+typedef struct gbglFontPage {
+	gbglTexture texture;
+	i32 shelf_x, shelf_y, shelf_height; // NOTE(bill): Glyphs are packed left to right into shelves
+	u32 generation; // NOTE(bill): Incremented every time the page is evicted
+	u64 last_used;
+} gbglFontPage;
+
 typedef enum gbglJustifyType {
 	gbglJustify_Left,
 	gbglJustify_Centre,
@@ -581,15 +708,20 @@ typedef struct gbglTextParam {
 typedef struct gbglFont {
 	isize glyph_count;
 	isize kern_pair_count;
-	i32 bitmap_width, bitmap_height;
-	f32 size;
+	i32 bitmap_width, bitmap_height; // NOTE(bill): Size of the atlas pages
+	f32 size, scale;
 	i32 ascent, descent, line_gap;
 	char *ttf_filename;
-	gbglTexture texture;
 
+	struct gbglFontCachedTTF *ttf;
+	struct gbglFontCache *    cache;
+
+	gbglGlyphInfo *     ascii_glyphs[128];
 	gbglGlyphMapKVPair *glyph_map;
-	gbglGlyphInfo *     glyphs;
+	isize               glyph_map_capacity; // NOTE(bill): Always zero or a power of two
+	gbglGlyphBlock *    glyph_blocks;
 	gbglKernPair *      kern_table;
+	isize               kern_table_capacity; // NOTE(bill): Always zero or a power of two
 
 	struct gbglFont *next; // NOTE(bill): Allow as linked list
 } gbglFont;
@@ -601,25 +733,28 @@ typedef struct gbglFontCachedTTF {
 	struct gbglFontCachedTTF *next;
 } gbglFontCachedTTF;
 
+#define GBGL_FONT_FLUSH_PROC(name) void name(void *user_data)
+typedef GBGL_FONT_FLUSH_PROC(gbglFontFlushProc);
+
 typedef struct gbglFontCache {
-	isize font_char_list_count;
-	char *font_char_list;
+	gbglFontPage pages[GBGL_FONT_MAX_PAGES];
+	isize        page_count;
+	u64          use_counter; // NOTE(bill): Clock for the least recently used page
 
-	isize   codepoint_count;
-	char32 *codepoints;
+	u8 *  scratch; // NOTE(bill): Rasterisation buffer
+	isize scratch_size;
 
-	stbtt_pack_range *ranges;
-	stbtt_packedchar *packed_char_data;
-	stbrp_rect *      rect_cache;
+	// NOTE(bill): Called before a page is evicted so that pending draws which still use the page can
+	// be submitted. gbgl_bs_init sets this for the font cache of the basic state.
+	gbglFontFlushProc *flush_proc;
+	void *             flush_user_data;
 
 	gbglFontCachedTTF *ttf_buffer;
 	gbglFont *         fonts;
 } gbglFontCache;
 
 
-#if 0
 GBGL_DEF void gbgl_destroy_font_cache(gbglFontCache *fc);
-#endif
 
 // NOTE(bill): gbgl_load_font_from_file will load from file if it is not found
 GBGL_DEF gbglFont *gbgl_load_font_from_file     (gbglFontCache *fc, char const *ttf_filename, f32 font_size);
@@ -627,8 +762,12 @@ GBGL_DEF gbglFont *gbgl_get_font_only_from_cache(gbglFontCache *fc, char const *
 GBGL_DEF gbglFont *gbgl_cache_font              (gbglFontCache *fc, char const *ttf_filename, f32 font_size);
 
 
-GBGL_DEF b32            gbgl_get_packed_font_dim                (gbglFontCache *cache, gbglFontCachedTTF *ttf, i32 *width, i32 *height);
-GBGL_DEF gbglGlyphInfo *gbgl_get_glyph_info                     (gbglFont *font, char32 codepoint, isize *out_index);
+// NOTE(bill): gbgl_get_glyph_info rasterises the glyph into the atlas if needed. gbgl_get_glyph_metrics
+// does not touch the atlas so only the metrics, not s0..t1 and page, are valid.
+// `out_index` is set to the TrueType glyph index which is what the kerning lookup takes
+GBGL_DEF gbglGlyphInfo *gbgl_get_glyph_info                     (gbglFont *font, Rune codepoint, isize *out_index);
+GBGL_DEF gbglGlyphInfo *gbgl_get_glyph_metrics                  (gbglFont *font, Rune codepoint, isize *out_index);
+GBGL_DEF gbglTexture *  gbgl_get_glyph_texture                  (gbglFont *font, gbglGlyphInfo const *glyph); // NOTE(bill): NULL if there is nothing to draw
 GBGL_DEF f32            gbgl_get_font_kerning_from_glyph_indices(gbglFont *font, isize left_index, isize right_index);
 GBGL_DEF void           gbgl_get_string_dimensions              (gbglFont *font, char const *str, f32 *out_width, f32 *out_height);
 GBGL_DEF f32            gbgl_get_sub_string_width               (gbglFont *font, char const *str, isize char_count);
@@ -646,14 +785,28 @@ GBGL_DEF f32            gbgl_get_string_width                   (gbglFont *font,
 
 #if !defined(GBGL_NO_BASIC_STATE)
 
+// NOTE(bill): All the gbgl_bs_draw_* procedures are deferred. The vertices are written straight
+// into a gbglStreamBuffer and adjacent draws which share the same shader, texture, sampler and
+// primitive type are merged into a single draw call. The batch is flushed at gbgl_bs_end, when it
+// is full, or by calling gbgl_bs_flush (e.g. before issuing your own GL calls in between).
+// Draws are never reordered as that would break the blending of overlapping draws.
+
 #ifndef GBGL_BS_MAX_VERTEX_COUNT
-#define GBGL_BS_MAX_VERTEX_COUNT 32
+#define GBGL_BS_MAX_VERTEX_COUNT 8192
 #endif
 
 #ifndef GBGL_BS_MAX_INDEX_COUNT
-#define GBGL_BS_MAX_INDEX_COUNT 6
+#define GBGL_BS_MAX_INDEX_COUNT (3*GBGL_BS_MAX_VERTEX_COUNT)
 #endif
 
+#ifndef GBGL_BS_MAX_BATCH_COUNT
+#define GBGL_BS_MAX_BATCH_COUNT 256
+#endif
+
+// NOTE(bill): Indices are u16 and the largest single shape needs 32 vertices
+GB_STATIC_ASSERT(GBGL_BS_MAX_VERTEX_COUNT >= 64 && GBGL_BS_MAX_VERTEX_COUNT <= 65536);
+GB_STATIC_ASSERT(GBGL_BS_MAX_INDEX_COUNT >= 96);
+
 
 #if !defined(GBGL_NO_FONTS)
 
@@ -665,15 +818,6 @@ GBGL_DEF f32            gbgl_get_string_width                   (gbglFont *font,
 #define gbglTextParam_Stack_size 128
 #endif
 
-#ifndef GBGL_FONT_CHAR_LIST
-#define GBGL_FONT_CHAR_LIST \
-	"ĀāăĄąĆćĈĉĊċČčĎďĐđĒēĔĕĖėĘęĚěĜĝĞğĠġĢģĤĥĨĩĪīĬĭĮįİıĲĳĴĵĶķĸĹĺĻļĽľŁł"\
-	"ŃńŅņņŇňŉŊŋŌōōŎŏŐőŒœŕŖŗŘřŚśŜŝŞşŠšŢţŤťŨũŪūŬŭŮůŰűŲųŴŵŶŷŸŹźŻżŽža!ö"\
-	"\"#$%%&\'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~"\
-	"ŠšŒœŸÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖØÙÚÛÜÝÞßàáâãäåæçèéêëìíîïðñòóôõøùúûüýþÿ®™£"\
-	" \t\r\n"
-#endif
-
 #ifndef GBGL_PT_TO_PX_SCALE
 #define GBGL_PT_TO_PX_SCALE (96.0f / 72.0f)
 #endif
@@ -687,17 +831,46 @@ GBGL_DEF f32            gbgl_get_string_width                   (gbglFont *font,
 typedef struct gbglBasicVertex {
 	f32 x, y;
 	f32 u, v;
+	gbglColour col;
 } gbglBasicVertex;
 
-typedef struct gbglBasicState {
-	gbglBasicVertex vertices[GBGL_BS_MAX_VERTEX_COUNT];
-	u16 indices[GBGL_BS_MAX_INDEX_COUNT];
+typedef enum gbglBasicBatchKind {
+	gbglBasicBatch_Sprite, // NOTE(bill): texture * colour (untextured shapes use a white texture)
+	gbglBasicBatch_Text,   // NOTE(bill): colour * texture.r
 
-	u32 vao, vbo, ebo;
+	gbglBasicBatch_Count,
+} gbglBasicBatchKind;
+
+typedef struct gbglBasicBatch {
+	gbglBasicBatchKind kind;
+	u32   primitive; // NOTE(bill): GL_TRIANGLES or GL_LINES
+	u32   texture;
+	u32   sampler;
+	f32   line_width;
+	isize index_offset;
+	isize index_count;
+} gbglBasicBatch;
+
+typedef struct gbglBasicState {
+	// NOTE(bill): These point straight into the mapped stream buffers while a batch is being built
+	gbglBasicVertex *vertices;
+	u16 *            indices;
+	isize            vertex_stream_offset;
+	isize            index_stream_offset;
+	gbglStreamBuffer vertex_stream;
+	gbglStreamBuffer index_stream;
+
+	gbglBasicBatch batches[GBGL_BS_MAX_BATCH_COUNT];
+	isize vertex_count;
+	isize index_count;
+	isize batch_count;
+	isize draw_call_count; // NOTE(bill): Draw calls issued since gbgl_bs_begin
+
+	u32 vao;
 	u32 nearest_sampler;
 	u32 linear_sampler;
-	gbglShader ortho_tex_shader;
-	gbglShader ortho_col_shader;
+	gbglTexture white_texture;
+	gbglShader  ortho_tex_shader;
 
 	f32 ortho_mat[16];
 	i32 width, height;
@@ -705,9 +878,6 @@ typedef struct gbglBasicState {
 #if !defined(GBGL_NO_FONTS)
 	gbglFontCache   font_cache;
 	gbglShader      font_shader;
-	gbglBasicVertex font_vertices[GBGL_MAX_RENDER_STRING_LENGTH * 4];
-	u16             font_indices[GBGL_MAX_RENDER_STRING_LENGTH * 6];
-	u32             font_vao, font_vbo, font_ebo;
 	char            font_text_buffer[GBGL_MAX_RENDER_STRING_LENGTH * 4]; // NOTE(bill): Maximum of 4 bytes per char for utf-8
 	u32             font_samplers[2];
 
@@ -721,6 +891,7 @@ GBGL_DEF void gbgl_bs_init(gbglBasicState *bs, i32 window_width, i32 window_heig
 GBGL_DEF void gbgl_bs_set_resolution(gbglBasicState *bs, i32 window_width, i32 window_height);
 GBGL_DEF void gbgl_bs_begin(gbglBasicState *bs, i32 window_width, i32 window_height);
 GBGL_DEF void gbgl_bs_end(gbglBasicState *bs);
+GBGL_DEF void gbgl_bs_flush(gbglBasicState *bs); // NOTE(bill): Submits all the pending draws
 
 GBGL_DEF void gbgl_bs_draw_textured_rect(gbglBasicState *bs, gbglTexture *tex, f32 x, f32 y, f32 w, f32 h, b32 v_up);
 GBGL_DEF void gbgl_bs_draw_rect(gbglBasicState *bs, f32 x, f32 y, f32 w, f32 h, gbglColour col);
@@ -876,6 +1047,10 @@ gb_inline u32 gbgl_make_ebo(void const *data, isize size, i32 usage_hint) {
 	return gbgl__make_buffer(size, data, GL_ELEMENT_ARRAY_BUFFER, usage_hint);
 }
 
+gb_inline u32 gbgl_make_ubo(void const *data, isize size, i32 usage_hint) {
+	return gbgl__make_buffer(size, data, GL_UNIFORM_BUFFER, usage_hint);
+}
+
 gb_inline gbglTBO gbgl_make_tbo(gbglBufferDataType data_type, i32 channel_count, void const *data, isize size, i32 usage_hint) {
 	gbglTBO tbo;
 	i32 internal_format;
@@ -897,12 +1072,17 @@ gb_inline void gbgl_ebo_copy(u32 ebo_handle, void *const data, isize size, isize
 	gbgl__buffer_copy(ebo_handle, GL_ELEMENT_ARRAY_BUFFER, data, size, offset);
 }
 
+gb_inline void gbgl_ubo_copy(u32 ubo_handle, void *const data, isize size, isize offset) {
+	gbgl__buffer_copy(ubo_handle, GL_UNIFORM_BUFFER, data, size, offset);
+}
+
 gb_inline void gbgl_tbo_copy(gbglTBO tbo, void *const data, isize size, isize offset) {
 	gbgl__buffer_copy(tbo.buffer_obj_handle, GL_TEXTURE_BUFFER, data, size, offset);
 }
 
 gb_inline void gbgl_bind_vbo(u32 vbo_handle) { glBindBuffer(GL_ARRAY_BUFFER, vbo_handle); }
 gb_inline void gbgl_bind_ebo(u32 ebo_handle) { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_handle); }
+gb_inline void gbgl_bind_ubo(u32 ubo_handle, u32 binding) { glBindBufferBase(GL_UNIFORM_BUFFER, binding, ubo_handle); }
 
 gb_inline void gbgl_bind_tbo(gbglTBO tbo, i32 sampler_handle, i32 tex_unit) {
 	glActiveTexture(GL_TEXTURE0 + tex_unit);
@@ -926,6 +1106,161 @@ gb_inline void gbgl_unmap_ebo(void) { glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER); }
 
 
 
+////////////////////////////////////////////////////////////////
+//
+// Stream Buffer
+//
+//
+
+#if defined(GL_MAP_PERSISTENT_BIT) && !defined(GBGL_NO_PERSISTENT_MAPPING)
+#define GBGL__STREAM_BUFFER_PERSISTENT 1
+#endif
+
+gb_internal b32 gbgl__has_buffer_storage(void) {
+#if defined(GBGL__STREAM_BUFFER_PERSISTENT)
+	i32 major = 0, minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	return (major > 4) || (major == 4 && minor >= 4);
+#else
+	return false;
+#endif
+}
+
+b32 gbgl_init_stream_buffer(gbglStreamBuffer *sb, isize segment_size) {
+	isize total_size = segment_size * GBGL_STREAM_BUFFER_SEGMENT_COUNT;
+
+	gb_zero_item(sb);
+	sb->segment_size = segment_size;
+
+	glGenBuffers(1, &sb->handle);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, sb->handle);
+
+#if defined(GBGL__STREAM_BUFFER_PERSISTENT)
+	if (gbgl__has_buffer_storage()) {
+		u32 flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, total_size, NULL, flags);
+		sb->persistent_ptr = cast(u8 *)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total_size, flags);
+		if (sb->persistent_ptr != NULL)
+			return true;
+
+		// NOTE(bill): The storage is immutable now so the fallback needs a new buffer
+		glDeleteBuffers(1, &sb->handle);
+		glGenBuffers(1, &sb->handle);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, sb->handle);
+	}
+#endif
+
+	glBufferData(GL_COPY_WRITE_BUFFER, total_size, NULL, GL_STREAM_DRAW);
+	return sb->handle != 0;
+}
+
+void gbgl_destroy_stream_buffer(gbglStreamBuffer *sb) {
+	isize i;
+	for (i = 0; i < GBGL_STREAM_BUFFER_SEGMENT_COUNT; i++) {
+		if (sb->fences[i])
+			glDeleteSync(sb->fences[i]);
+	}
+	if (sb->handle) {
+		if (sb->persistent_ptr || sb->is_mapped) {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, sb->handle);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		}
+		glDeleteBuffers(1, &sb->handle);
+	}
+	gb_zero_item(sb);
+}
+
+gb_inline b32 gbgl_is_stream_buffer_persistent(gbglStreamBuffer const *sb) { return sb->persistent_ptr != NULL; }
+
+gb_internal void gbgl__stream_buffer_next_segment(gbglStreamBuffer *sb) {
+	if (sb->persistent_ptr) {
+		GLsync fence;
+		if (sb->fences[sb->segment_index])
+			glDeleteSync(sb->fences[sb->segment_index]);
+		sb->fences[sb->segment_index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		sb->segment_index = (sb->segment_index+1) % GBGL_STREAM_BUFFER_SEGMENT_COUNT;
+		sb->offset = 0;
+
+		// NOTE(bill): This only blocks if the GPU is more than GBGL_STREAM_BUFFER_SEGMENT_COUNT-1 segments behind
+		fence = sb->fences[sb->segment_index];
+		if (fence) {
+			for (;;) {
+				u32 res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+				if (res != GL_TIMEOUT_EXPIRED)
+					break;
+			}
+			glDeleteSync(fence);
+			sb->fences[sb->segment_index] = NULL;
+		}
+	} else {
+		sb->segment_index = (sb->segment_index+1) % GBGL_STREAM_BUFFER_SEGMENT_COUNT;
+		sb->offset = 0;
+
+		if (sb->segment_index == 0) {
+			// NOTE(bill): Orphan the storage rather than wait for the GPU to finish with it
+			glBindBuffer(GL_COPY_WRITE_BUFFER, sb->handle);
+			glBufferData(GL_COPY_WRITE_BUFFER, sb->segment_size * GBGL_STREAM_BUFFER_SEGMENT_COUNT, NULL, GL_STREAM_DRAW);
+		}
+	}
+}
+
+void *gbgl_stream_buffer_map(gbglStreamBuffer *sb, isize max_size, isize alignment, isize *offset) {
+	isize segment_start, start;
+
+	GB_ASSERT(!sb->is_mapped);
+	GB_ASSERT(max_size <= sb->segment_size);
+	if (alignment < 1) alignment = 1;
+
+	segment_start = sb->segment_index * sb->segment_size;
+	start = segment_start + sb->offset;
+	start = ((start + alignment-1) / alignment) * alignment;
+	if (start + max_size > segment_start + sb->segment_size) {
+		gbgl__stream_buffer_next_segment(sb);
+		segment_start = sb->segment_index * sb->segment_size;
+		start = ((segment_start + alignment-1) / alignment) * alignment;
+		GB_ASSERT_MSG(start + max_size <= segment_start + sb->segment_size,
+		              "Stream buffer segment too small for %td bytes aligned to %td", max_size, alignment);
+	}
+
+	sb->is_mapped  = true;
+	sb->map_offset = start;
+	sb->map_size   = max_size;
+	if (offset) *offset = start;
+
+	if (sb->persistent_ptr)
+		return sb->persistent_ptr + start;
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, sb->handle);
+	return glMapBufferRange(GL_COPY_WRITE_BUFFER, start, max_size,
+	                        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+	                        GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+}
+
+void gbgl_stream_buffer_unmap(gbglStreamBuffer *sb, isize used_size) {
+	GB_ASSERT(sb->is_mapped);
+	GB_ASSERT(used_size <= sb->map_size);
+
+	if (!sb->persistent_ptr) {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, sb->handle);
+		if (used_size > 0)
+			glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, 0, used_size);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	}
+
+	sb->offset    = sb->map_offset + used_size - sb->segment_index*sb->segment_size;
+	sb->is_mapped = false;
+}
+
+void gbgl_stream_buffer_end_frame(gbglStreamBuffer *sb) {
+	GB_ASSERT(!sb->is_mapped);
+	if (sb->offset > 0)
+		gbgl__stream_buffer_next_segment(sb);
+}
+
+
+
 ////////////////////////////////////////////////////////////////
 //
 // Shader
@@ -999,6 +1334,69 @@ gbglShaderError gbgl__load_single_shader_from_memory(gbglShader *s, gbglShaderTy
 	return err;
 }
 
+gb_internal u32 gbgl__uniform_hash(char const *name, isize len) {
+	u32 hash = gb_fnv32a(name, len);
+	return hash ? hash : 1; // NOTE(bill): 0 is reserved for empty slots
+}
+
+gb_internal gbglUniform *gbgl__find_uniform(gbglShader *s, char const *name, isize len, u32 hash) {
+	u32 mask = GBGL_UNIFORM_TABLE_SIZE-1;
+	u32 i = hash & mask;
+	for (;;) {
+		gbglUniform *u = &s->uniforms[i];
+		if (u->hash == 0)
+			return u; // NOTE(bill): Empty slot where it would be inserted
+		if (u->hash == hash && gb_strncmp(u->name, name, len) == 0 && u->name[len] == '\0')
+			return u;
+		i = (i+1) & mask;
+	}
+}
+
+gb_internal void gbgl__add_uniform(gbglShader *s, char const *name, isize len, i32 loc, i32 size, u32 type) {
+	u32 hash;
+	gbglUniform *u;
+	if (len >= GBGL_MAX_UNIFORM_NAME_LENGTH || s->uniform_count >= GBGL_MAX_UNIFORM_COUNT)
+		return;
+	hash = gbgl__uniform_hash(name, len);
+	u = gbgl__find_uniform(s, name, len, hash);
+	if (u->hash == 0) {
+		u->hash = hash;
+		gb_memcopy(u->name, name, len);
+		u->name[len] = '\0';
+		s->uniform_count++;
+	}
+	u->loc  = loc;
+	u->size = size;
+	u->type = type;
+}
+
+gb_internal void gbgl__enumerate_uniforms(gbglShader *s) {
+	i32 i, active_count = 0;
+
+	gb_zero_array(s->uniforms, gb_count_of(s->uniforms));
+	s->uniform_count = 0;
+
+	glGetProgramiv(s->program, GL_ACTIVE_UNIFORMS, &active_count);
+	for (i = 0; i < active_count; i++) {
+		char name[GBGL_MAX_UNIFORM_NAME_LENGTH];
+		i32 len = 0, size = 0, loc;
+		u32 type = 0;
+
+		glGetActiveUniform(s->program, i, gb_size_of(name), &len, &size, &type, name);
+		if (len <= 0 || len >= gb_size_of(name)-1)
+			continue; // NOTE(bill): Truncated names are looked up lazily instead
+
+		loc = glGetUniformLocation(s->program, name);
+		if (loc < 0)
+			continue; // NOTE(bill): Members of uniform blocks
+
+		// NOTE(bill): Arrays are reported as "name[0]" but are usually referred to as "name"
+		if (len > 3 && gb_strncmp(name+len-3, "[0]", 3) == 0)
+			len -= 3;
+		gbgl__add_uniform(s, name, len, loc, size, type);
+	}
+}
+
 gbglShaderError gbgl__link_shader(gbglShader *shader) {
 	gbglShaderError err = gbglShaderError_None;
 	i32 i, status;
@@ -1023,6 +1421,9 @@ gbglShaderError gbgl__link_shader(gbglShader *shader) {
 			glDetachShader(shader->program, shader->shaders[i]);
 	}
 
+	if (err == gbglShaderError_None)
+		gbgl__enumerate_uniforms(shader);
+
 	return err;
 }
 
@@ -1097,10 +1498,6 @@ gb_inline void gbgl_destroy_shader(gbglShader *shader) {
 	}
 
 	glDeleteProgram(shader->program);
-
-	for (i = 0; i < shader->uniform_count; i++) {
-		gbgl_free(shader->uniform_names[i]);
-	}
 }
 
 
@@ -1126,13 +1523,10 @@ b32 gbgl_reload_shader(gbglShader *shader) {
 		}
 	}
 
+	// NOTE(bill): Relinking enumerates the uniforms again
 	if (gbgl__link_shader(shader) != gbglShaderError_None)
 		return false;
 
-	for (i = 0; i < shader->uniform_count; i++)
-		shader->uniform_locs[i] = glGetUniformLocation(shader->program, shader->uniform_names[i]);
-
-
 	return true;
 }
 
@@ -1149,62 +1543,81 @@ gb_inline b32 gbgl_is_shader_in_use(gbglShader *s) {
 
 
 i32 gbgl_get_uniform(gbglShader *s, char const *name) {
-	i32 i, loc = -1;
-	for (i = 0; i < s->uniform_count; i++) {
-		if (gb_strcmp(s->uniform_names[i], name) == 0) {
-			return s->uniform_locs[i];
-		}
-	}
-
-	GB_ASSERT_MSG(s->uniform_count < GBGL_MAX_UNIFORM_COUNT,
-	              "Uniform array for shader is full");
-
+	isize len = gb_strlen(name);
+	u32 hash = gbgl__uniform_hash(name, len);
+	gbglUniform *u = gbgl__find_uniform(s, name, len, hash);
+	i32 loc;
+	if (u->hash != 0)
+		return u->loc;
+
+	// NOTE(bill): Not an active uniform from the link (e.g. "array[3]"), ask GL once and cache it
 	loc = glGetUniformLocation(s->program, name);
-	s->uniform_names[s->uniform_count] = gb_alloc_str(gb_heap_allocator(), name);
-	s->uniform_locs[s->uniform_count] = loc;
-	s->uniform_count++;
-
+	gbgl__add_uniform(s, name, len, loc, 1, 0);
 	return loc;
 }
 
 
 
 gb_inline void gbgl_set_uniform_int(gbglShader *s, char const *name, i32 i) {
-	glUniform1i(gbgl_get_uniform(s, name), i);
+	gbgl_set_uniform_int_loc(gbgl_get_uniform(s, name), i);
 }
 
 gb_inline void gbgl_set_uniform_float(gbglShader *s, char const *name, f32 f) {
-	glUniform1f(gbgl_get_uniform(s, name), f);
+	gbgl_set_uniform_float_loc(gbgl_get_uniform(s, name), f);
 }
 
 gb_inline void gbgl_set_uniform_vec2(gbglShader *s, char const *name, f32 const *v) {
-	glUniform2fv(gbgl_get_uniform(s, name), 1, v);
+	gbgl_set_uniform_vec2_loc(gbgl_get_uniform(s, name), v);
 }
 
 gb_inline void gbgl_set_uniform_vec3(gbglShader *s, char const *name, f32 const *v) {
-	glUniform3fv(gbgl_get_uniform(s, name), 1, v);
+	gbgl_set_uniform_vec3_loc(gbgl_get_uniform(s, name), v);
 }
 
 gb_inline void gbgl_set_uniform_vec4(gbglShader *s, char const *name, f32 const *v) {
-	glUniform4fv(gbgl_get_uniform(s, name), 1, v);
+	gbgl_set_uniform_vec4_loc(gbgl_get_uniform(s, name), v);
 }
 
 gb_inline void gbgl_set_uniform_mat4(gbglShader *s, char const *name, f32 const *m) {
-	gbgl_set_uniform_mat4_count(s, name, m, 1);
+	gbgl_set_uniform_mat4_count_loc(gbgl_get_uniform(s, name), m, 1);
 }
 
 gb_inline void gbgl_set_uniform_mat4_count(gbglShader *s, char const *name, f32 const *m, isize count) {
-	glUniformMatrix4fv(gbgl_get_uniform(s, name), count, false, m);
+	gbgl_set_uniform_mat4_count_loc(gbgl_get_uniform(s, name), m, count);
 }
 
-
 gb_inline void gbgl_set_uniform_colour(gbglShader *s, char const *name, gbglColour col) {
+	gbgl_set_uniform_colour_loc(gbgl_get_uniform(s, name), col);
+}
+
+
+gb_inline void gbgl_set_uniform_int_loc  (i32 loc, i32 i)        { glUniform1i(loc, i); }
+gb_inline void gbgl_set_uniform_float_loc(i32 loc, f32 f)        { glUniform1f(loc, f); }
+gb_inline void gbgl_set_uniform_vec2_loc (i32 loc, f32 const *v) { glUniform2fv(loc, 1, v); }
+gb_inline void gbgl_set_uniform_vec3_loc (i32 loc, f32 const *v) { glUniform3fv(loc, 1, v); }
+gb_inline void gbgl_set_uniform_vec4_loc (i32 loc, f32 const *v) { glUniform4fv(loc, 1, v); }
+gb_inline void gbgl_set_uniform_mat4_loc (i32 loc, f32 const *m) { glUniformMatrix4fv(loc, 1, false, m); }
+
+gb_inline void gbgl_set_uniform_mat4_count_loc(i32 loc, f32 const *m, isize count) {
+	glUniformMatrix4fv(loc, cast(i32)count, false, m);
+}
+
+gb_inline void gbgl_set_uniform_colour_loc(i32 loc, gbglColour col) {
 	f32 v[4];
 	v[0] = col.r / 255.0f;
 	v[1] = col.g / 255.0f;
 	v[2] = col.b / 255.0f;
 	v[3] = col.a / 255.0f;
-	gbgl_set_uniform_vec4(s, name, v);
+	glUniform4fv(loc, 1, v);
+}
+
+
+b32 gbgl_set_uniform_block_binding(gbglShader *s, char const *name, u32 binding) {
+	u32 index = glGetUniformBlockIndex(s->program, name);
+	if (index == GL_INVALID_INDEX)
+		return false;
+	glUniformBlockBinding(s->program, index, binding);
+	return true;
 }
 
 
@@ -1330,7 +1743,7 @@ b32 gbgl_load_texture2d_from_file(gbglTexture *texture, b32 flip_vertically, cha
 	return result;
 }
 
-gb_inline b32 gbgl_make_texture2d_coloured(gbglTexture *t, gbglColour colour) {
+gb_inline b32 gbgl_init_texture2d_coloured(gbglTexture *t, gbglColour colour) {
 	return gbgl_load_texture2d_from_memory(t, &colour.rgba, 1, 1, 4);
 }
 
@@ -1364,92 +1777,226 @@ gb_inline void gbgl_destroy_texture(gbglTexture *t) {
 //
 //
 #if !defined(GBGL_NO_FONTS)
-gb_inline GB_COMPARE_PROC(gbgl__kern_pair_compare) {
-	gbglKernPair *kp0 = cast(gbglKernPair *)a;
-	gbglKernPair *kp1 = cast(gbglKernPair *)b;
-	return kp0->packed - kp1->packed;
+gb_internal u32 gbgl__font_hash(u32 x) {
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+gb_internal gbglGlyphMapKVPair *gbgl__font_glyph_slot(gbglGlyphMapKVPair *map, isize capacity, Rune codepoint) {
+	isize mask = capacity-1;
+	isize i = gbgl__font_hash(cast(u32)codepoint) & mask;
+	for (;;) {
+		gbglGlyphMapKVPair *kv = &map[i];
+		if (kv->glyph == NULL || kv->codepoint == codepoint)
+			return kv;
+		i = (i+1) & mask;
+	}
 }
 
+gb_internal gbglKernPair *gbgl__font_kern_slot(gbglKernPair *table, isize capacity, u32 key) {
+	isize mask = capacity-1;
+	isize i = gbgl__font_hash(key) & mask;
+	for (;;) {
+		gbglKernPair *kp = &table[i];
+		if (kp->key == 0xffffffffu || kp->key == key)
+			return kp;
+		i = (i+1) & mask;
+	}
+}
+
+gb_internal b32 gbgl__font_grow_glyph_map(gbglFont *font) {
+	isize i, new_capacity = font->glyph_map_capacity ? 2*font->glyph_map_capacity : 256;
+	gbglGlyphMapKVPair *new_map = cast(gbglGlyphMapKVPair *)gbgl_malloc(gb_size_of(gbglGlyphMapKVPair) * new_capacity);
+	if (!new_map)
+		return false;
+	gb_zero_array(new_map, new_capacity);
 
-gb_inline GB_COMPARE_PROC(gbgl__glyph_map_compare) {
-	gbglGlyphMapKVPair g0 = *cast(gbglGlyphMapKVPair *)a;
-	gbglGlyphMapKVPair g1 = *cast(gbglGlyphMapKVPair *)b;
-	return g0.codepoint - g1.codepoint;
+	for (i = 0; i < font->glyph_map_capacity; i++) {
+		gbglGlyphMapKVPair *kv = &font->glyph_map[i];
+		if (kv->glyph)
+			*gbgl__font_glyph_slot(new_map, new_capacity, kv->codepoint) = *kv;
+	}
+
+	if (font->glyph_map)
+		gbgl_free(font->glyph_map);
+	font->glyph_map = new_map;
+	font->glyph_map_capacity = new_capacity;
+	return true;
 }
 
+gb_internal b32 gbgl__font_grow_kern_table(gbglFont *font) {
+	isize i, new_capacity = font->kern_table_capacity ? 2*font->kern_table_capacity : 512;
+	gbglKernPair *new_table = cast(gbglKernPair *)gbgl_malloc(gb_size_of(gbglKernPair) * new_capacity);
+	if (!new_table)
+		return false;
+	gb_memset(new_table, 0xff, gb_size_of(gbglKernPair) * new_capacity);
+
+	for (i = 0; i < font->kern_table_capacity; i++) {
+		gbglKernPair *kp = &font->kern_table[i];
+		if (kp->key != 0xffffffffu)
+			*gbgl__font_kern_slot(new_table, new_capacity, kp->key) = *kp;
+	}
 
+	if (font->kern_table)
+		gbgl_free(font->kern_table);
+	font->kern_table = new_table;
+	font->kern_table_capacity = new_capacity;
+	return true;
+}
 
+gb_internal gbglGlyphInfo *gbgl__font_add_glyph(gbglFont *font, Rune codepoint) {
+	stbtt_fontinfo *finfo = &font->ttf->finfo;
+	gbglGlyphInfo *gi;
+	int advance, lsb, ix0, iy0, ix1, iy1;
 
-b32 gbgl_get_packed_font_dim(gbglFontCache *cache, gbglFontCachedTTF *ttf, i32 *width, i32 *height) {
-	b32 result = true;
-	stbtt_pack_context spc;
-	b32 ext_w = true;
-	isize sanity_counter = 0, i, j;
-	*width = *height = (1<<5);
-	for (j = 0; j < cache->codepoint_count; j++) {
-		cache->rect_cache[j].x = cache->rect_cache[j].y = 0;
+	if (cast(u32)codepoint >= gb_count_of(font->ascii_glyphs) &&
+	    2*(font->glyph_count+1) > font->glyph_map_capacity) {
+		if (!gbgl__font_grow_glyph_map(font))
+			return NULL;
 	}
 
-	for (;;) {
-		i32 res = stbtt_PackBegin(&spc, NULL, *width, *height, 0, 1, 0);
-		GB_ASSERT(res == 1);
-		if (res != 1) {
+	if (!font->glyph_blocks || font->glyph_blocks->count == GBGL_FONT_GLYPH_BLOCK_SIZE) {
+		gbglGlyphBlock *block = cast(gbglGlyphBlock *)gbgl_malloc(gb_size_of(gbglGlyphBlock));
+		if (!block)
+			return NULL;
+		block->count = 0;
+		block->next  = font->glyph_blocks;
+		font->glyph_blocks = block;
+	}
+
+	gi = &font->glyph_blocks->glyphs[font->glyph_blocks->count++];
+	gb_zero_item(gi);
+	gi->codepoint   = codepoint;
+	gi->glyph_index = stbtt_FindGlyphIndex(finfo, codepoint);
+	gi->page        = -1;
+
+	stbtt_GetGlyphHMetrics(finfo, gi->glyph_index, &advance, &lsb);
+	stbtt_GetGlyphBitmapBox(finfo, gi->glyph_index, font->scale, font->scale, &ix0, &iy0, &ix1, &iy1);
+	gi->xadv   = cast(f32)advance * font->scale;
+	gi->xoff   = cast(i16)ix0;
+	gi->yoff   = cast(i16)iy0;
+	gi->width  = cast(i16)(ix1 - ix0);
+	gi->height = cast(i16)(iy1 - iy0);
+
+	if (cast(u32)codepoint < gb_count_of(font->ascii_glyphs)) {
+		font->ascii_glyphs[codepoint] = gi;
+	} else {
+		gbglGlyphMapKVPair *kv = gbgl__font_glyph_slot(font->glyph_map, font->glyph_map_capacity, codepoint);
+		kv->codepoint = codepoint;
+		kv->glyph     = gi;
+	}
+	font->glyph_count++;
+
+	return gi;
+}
+
+gb_internal b32 gbgl__font_page_alloc(gbglFontPage *page, i32 w, i32 h, i32 *x, i32 *y) {
+	if (page->shelf_x + w > GBGL_FONT_PAGE_SIZE || page->shelf_y + h > GBGL_FONT_PAGE_SIZE) {
+		// NOTE(bill): Start a new shelf below the current one
+		i32 next_y = page->shelf_y + page->shelf_height;
+		if (next_y + h > GBGL_FONT_PAGE_SIZE)
 			return false;
-		} else {
-			stbrp_context *rp_ctx;
-			b32 fit = true;
-
-			gb_zero_array(cache->rect_cache, cache->codepoint_count);
-			rp_ctx = cast(stbrp_context *)spc.pack_info;
-			stbtt_PackFontRangesGatherRects(&spc, &ttf->finfo, cache->ranges, cache->codepoint_count, cache->rect_cache);
-			gb_sort_array(cache->rect_cache, cache->codepoint_count, rect_height_compare);
-
-			for (i = 0; i < cache->codepoint_count; i++) {
-				stbrp__findresult fr = stbrp__skyline_pack_rectangle(rp_ctx, cache->rect_cache[i].w, cache->rect_cache[i].h);
-				if (fr.prev_link) {
-					cache->rect_cache[i].x = cast(stbrp_coord)fr.x;
-					cache->rect_cache[i].y = cast(stbrp_coord)fr.y;
-				} else {
-					int res;
-					if (ext_w) {
-						ext_w = false;
-						*width <<= 1;
-					} else {
-						ext_w = true;
-						*height <<= 1;
-					}
-					fit = false;
-					for (j = 0; j < cache->codepoint_count; j++) {
-						cache->rect_cache[j].x = cache->rect_cache[j].y = 0;
-					}
-					stbtt_PackEnd(&spc);
-					res = stbtt_PackBegin(&spc, NULL, *width, *height, 0, 1, 0);
-					GB_ASSERT(res == 1);
-					if (res != 1) {
-						result = false;
-						goto done;
-					}
-					break;
-				}
-			}
-			if (fit) {
-				result = true;
-				goto done;
-			}
-			if (++sanity_counter > 32) {
-				result = false;
-				goto done;
-			}
+		page->shelf_x      = 0;
+		page->shelf_y      = next_y;
+		page->shelf_height = 0;
+	}
+	*x = page->shelf_x;
+	*y = page->shelf_y;
+	page->shelf_x += w;
+	if (page->shelf_height < h)
+		page->shelf_height = h;
+	return true;
+}
+
+gb_internal isize gbgl__font_cache_alloc(gbglFontCache *fc, i32 w, i32 h, i32 *x, i32 *y) {
+	gbglFontPage *page;
+	isize i;
+
+	if (w > GBGL_FONT_PAGE_SIZE || h > GBGL_FONT_PAGE_SIZE)
+		return -1;
+
+	for (i = fc->page_count-1; i >= 0; i--) {
+		if (gbgl__font_page_alloc(&fc->pages[i], w, h, x, y))
+			return i;
+	}
+
+	if (fc->page_count < GBGL_FONT_MAX_PAGES) {
+		page = &fc->pages[fc->page_count];
+		gb_zero_item(page);
+		if (!gbgl_load_texture2d_from_memory(&page->texture, NULL, GBGL_FONT_PAGE_SIZE, GBGL_FONT_PAGE_SIZE, 1))
+			return -1;
+		fc->page_count++;
+	} else {
+		isize lru = 0;
+		for (i = 1; i < fc->page_count; i++) {
+			if (fc->pages[i].last_used < fc->pages[lru].last_used)
+				lru = i;
 		}
+		page = &fc->pages[lru];
+
+		// NOTE(bill): Pending draws may still be using the glyphs in this page
+		if (fc->flush_proc)
+			fc->flush_proc(fc->flush_user_data);
+
+		page->generation++;
+		page->shelf_x = page->shelf_y = page->shelf_height = 0;
 	}
 
-done:
-	stbtt_PackEnd(&spc);
+	// NOTE(bill): An empty page always has room for w by h, but x and y must never be left unset
+	if (!gbgl__font_page_alloc(page, w, h, x, y))
+		return -1;
+	return page - fc->pages;
+}
+
+gb_internal b32 gbgl__font_rasterise_glyph(gbglFont *font, gbglGlyphInfo *gi) {
+	gbglFontCache *fc = font->cache;
+	gbglFontPage *page;
+	// NOTE(bill): 1 pixel of empty padding around every glyph so filtering does not bleed
+	i32 w = gi->width  + 2;
+	i32 h = gi->height + 2;
+	i32 x, y;
+	isize page_index;
+
+	if (fc->scratch_size < w*h) {
+		if (fc->scratch)
+			gbgl_free(fc->scratch);
+		fc->scratch_size = 0;
+		fc->scratch = cast(u8 *)gbgl_malloc(w*h);
+		if (!fc->scratch)
+			return false;
+		fc->scratch_size = w*h;
+	}
 
-	return result;
+	page_index = gbgl__font_cache_alloc(fc, w, h, &x, &y);
+	if (page_index < 0)
+		return false;
+	page = &fc->pages[page_index];
+
+	gb_zero_size(fc->scratch, w*h);
+	stbtt_MakeGlyphBitmap(&font->ttf->finfo, fc->scratch + w + 1, gi->width, gi->height, w,
+	                      font->scale, font->scale, gi->glyph_index);
+
+	glBindTexture(GL_TEXTURE_2D, page->texture.handle);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RED, GL_UNSIGNED_BYTE, fc->scratch);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	gi->s0 = cast(f32)(x + 1);
+	gi->t0 = cast(f32)(y + 1);
+	gi->s1 = gi->s0 + cast(f32)gi->width;
+	gi->t1 = gi->t0 + cast(f32)gi->height;
+	gi->page       = cast(i32)page_index;
+	gi->generation = page->generation;
+
+	return true;
 }
 
-#if 0
+
 void gbgl_destroy_font_cache(gbglFontCache *fc) {
 	gbglFontCachedTTF *curr_ttf = fc->ttf_buffer;
 	gbglFontCachedTTF *next_ttf = NULL;
@@ -1457,11 +2004,7 @@ void gbgl_destroy_font_cache(gbglFontCache *fc) {
 	gbglFont *curr_font = fc->fonts;
 	gbglFont *next_font = NULL;
 
-	gbgl_free(fc->font_char_list);
-	gbgl_free(fc->codepoints);
-	gbgl_free(fc->ranges);
-	gbgl_free(fc->packed_char_data);
-	gbgl_free(fc->rect_cache);
+	isize i;
 
 	// NOTE(bill): Free all linked listed ttfs
 	while (curr_ttf) {
@@ -1475,18 +2018,32 @@ void gbgl_destroy_font_cache(gbglFontCache *fc) {
 
 	// NOTE(bill): Free all linked listed fonts
 	while (curr_font) {
+		gbglGlyphBlock *block = curr_font->glyph_blocks;
+		while (block) {
+			gbglGlyphBlock *next_block = block->next;
+			gbgl_free(block);
+			block = next_block;
+		}
 		gbgl_free(curr_font->ttf_filename);
-		gbgl_destroy_texture(&curr_font->texture);
-		gbgl_free(curr_font->glyph_map);
-		gbgl_free(curr_font->glyphs);
-		gbgl_free(curr_font->kern_table);
+		if (curr_font->glyph_map)  gbgl_free(curr_font->glyph_map);
+		if (curr_font->kern_table) gbgl_free(curr_font->kern_table);
 
 		next_font = curr_font->next;
 		gbgl_free(curr_font);
 		curr_font = next_font;
 	}
+
+	for (i = 0; i < fc->page_count; i++)
+		gbgl_destroy_texture(&fc->pages[i].texture);
+	if (fc->scratch)
+		gbgl_free(fc->scratch);
+
+	fc->ttf_buffer   = NULL;
+	fc->fonts        = NULL;
+	fc->page_count   = 0;
+	fc->scratch      = NULL;
+	fc->scratch_size = 0;
 }
-#endif
 
 
 gb_inline gbglFont * gbgl_load_font_from_file(gbglFontCache *fc, char const *ttf_filename, f32 font_size) {
@@ -1510,7 +2067,6 @@ gb_inline gbglFont * gbgl_get_font_only_from_cache(gbglFontCache *fc, char const
 gbglFont * gbgl_cache_font(gbglFontCache *fc, char const *ttf_filename, f32 font_size) {
 	gbglFont *f = gbgl_get_font_only_from_cache(fc, ttf_filename, font_size);
 	gbglFontCachedTTF *ttf = NULL;
-	isize i;
 
 	if (f) { // NOTE(bill): The font is already cached
 		return f;
@@ -1534,43 +2090,6 @@ gbglFont * gbgl_cache_font(gbglFontCache *fc, char const *ttf_filename, f32 font
 
 	gb_zero_item(f);
 
-	// NOTE(bill): Make sure the character list file has been loaded
-	if (!fc->font_char_list) {
-		isize codepoint_count = 0, cpi = 0;
-		fc->font_char_list = GBGL_FONT_CHAR_LIST;
-		fc->font_char_list_count = gb_strlen(GBGL_FONT_CHAR_LIST);
-
-		for (i = 0; i < fc->font_char_list_count; i++) {
-			char32 c;
-			isize utf8_len = gb_utf8_decode_len(fc->font_char_list + i, fc->font_char_list_count, &c);
-			i += utf8_len-1;
-			codepoint_count++;
-		}
-
-		fc->codepoint_count = codepoint_count;
-		fc->ranges           = cast(stbtt_pack_range *)gbgl_malloc(gb_size_of(stbtt_pack_range) * codepoint_count);
-		fc->codepoints       = cast(char32 *)          gbgl_malloc(gb_size_of(char32)           * codepoint_count);
-		fc->packed_char_data = cast(stbtt_packedchar *)gbgl_malloc(gb_size_of(stbtt_packedchar) * codepoint_count);
-		fc->rect_cache       = cast(stbrp_rect *)      gbgl_malloc(gb_size_of(stbrp_rect)       * codepoint_count);
-
-		if (!fc->ranges || !fc->codepoints || !fc->packed_char_data) {
-			gb_printf_err("Unable to get memory for fonts");
-		}
-
-		for (i = 0; i < fc->font_char_list_count; i++) {
-			isize utf8_len = gb_utf8_decode_len(fc->font_char_list+i, fc->font_char_list_count, fc->codepoints+cpi);
-			i += utf8_len-1;
-			cpi++;
-		}
-		GB_ASSERT(cpi == fc->codepoint_count);
-		for (i = 0; i < fc->codepoint_count; i++) {
-			fc->ranges[i].first_unicode_codepoint_in_range = fc->codepoints[i];
-			fc->ranges[i].array_of_unicode_codepoints = 0;
-			fc->ranges[i].num_chars = 1;
-			fc->ranges[i].chardata_for_range = fc->packed_char_data + i;
-		}
-	}
-
 	{
 		gbglFontCachedTTF **ttf_cache = &fc->ttf_buffer;
 
@@ -1615,144 +2134,87 @@ gbglFont * gbgl_cache_font(gbglFontCache *fc, char const *ttf_filename, f32 font
 		GB_ASSERT_NOT_NULL(ttf);
 	}
 
-	// NOTE(bill): Set the range for the this look up
-	for (i = 0; i < fc->codepoint_count; i++)
-		fc->ranges[i].font_size = font_size;
-
-	{ // NOTE(bill): Figure out smallest non-square power of 2 texture size
-		i32 w, h;
-		if (gbgl_get_packed_font_dim(fc, ttf, &w, &h)) {
-			isize str_len, i, j;
-
-			// NOTE(bill): Setup the font data
-			f->glyph_count   = fc->codepoint_count;
-			f->bitmap_width  = w;
-			f->bitmap_height = h;
-			f->size          = font_size;
+	{ // NOTE(bill): Setup the font data, the glyphs are rasterised as they are used
+		isize str_len = gb_strlen(ttf_filename);
+		f->ttf_filename = cast(char *)gbgl_malloc(str_len+1);
+		gb_memcopy(f->ttf_filename, ttf_filename, str_len);
+		f->ttf_filename[str_len] = '\0';
+
+		f->ttf           = ttf;
+		f->cache         = fc;
+		f->size          = font_size;
+		f->bitmap_width  = GBGL_FONT_PAGE_SIZE;
+		f->bitmap_height = GBGL_FONT_PAGE_SIZE;
+
+		f->scale = stbtt_ScaleForPixelHeight(&ttf->finfo, font_size);
+		stbtt_GetFontVMetrics(&ttf->finfo, &f->ascent, &f->descent, &f->line_gap);
+		f->ascent   = cast(i32)(cast(f32)f->ascent   * f->scale);
+		f->descent  = cast(i32)(cast(f32)f->descent  * f->scale);
+		f->line_gap = cast(i32)(cast(f32)f->line_gap * f->scale);
+	}
+	return f;
+}
 
-			str_len = gb_strlen(ttf_filename);
-			f->ttf_filename = cast(char *)gbgl_malloc(str_len+1);
-			gb_strncpy(f->ttf_filename, ttf_filename, str_len);
 
-			f->glyph_map = cast(gbglGlyphMapKVPair *)gbgl_malloc(gb_size_of(*f->glyph_map) * f->glyph_count);
-			f->glyphs    = cast(gbglGlyphInfo *)     gbgl_malloc(gb_size_of(*f->glyphs)    * f->glyph_count);
-			if (!f->glyph_map || !f->glyphs) {
-				f = NULL;
-				return f;
-			} else {
-				stbtt_pack_context spc;
-				u8 *px;
-				i32 res;
-				f32 scale;
-
-				px = cast(u8 *)gbgl_malloc(w * h);
-				res = stbtt_PackBegin(&spc, px, w, h, 0, 1, NULL);
-				GB_ASSERT(res == 1);
-				res = stbtt_PackFontRanges(&spc, ttf->ttf, 0, fc->ranges, fc->codepoint_count);
-				GB_ASSERT(res == 1);
-				stbtt_PackEnd(&spc);
-
-				gbgl_load_texture2d_from_memory(&f->texture, px, w, h, 1);
-
-				gbgl_free(px);
-
-				scale = stbtt_ScaleForPixelHeight(&ttf->finfo, font_size);
-				stbtt_GetFontVMetrics(&ttf->finfo, &f->ascent, &f->descent, &f->line_gap);
-				f->ascent   = cast(i32)(cast(f32)f->ascent   * scale);
-				f->descent  = cast(i32)(cast(f32)f->descent  * scale);
-				f->line_gap = cast(i32)(cast(f32)f->line_gap * scale);
-
-				for (i = 0; i < f->glyph_count; i++) {
-					gbglGlyphInfo *gi = f->glyphs + i;
-					gi->s0 = cast(f32)fc->packed_char_data[i].x0;
-					gi->t0 = cast(f32)fc->packed_char_data[i].y0;
-					gi->s1 = cast(f32)fc->packed_char_data[i].x1;
-					gi->t1 = cast(f32)fc->packed_char_data[i].y1;
-
-					gi->xoff = cast(i16)fc->packed_char_data[i].xoff;
-					gi->yoff = cast(i16)fc->packed_char_data[i].yoff;
-					gi->xadv = fc->packed_char_data[i].xadvance;
-				}
+gbglGlyphInfo *gbgl_get_glyph_metrics(gbglFont *font, Rune codepoint, isize *out_index) {
+	gbglGlyphInfo *gi = NULL;
+	if (cast(u32)codepoint < gb_count_of(font->ascii_glyphs))
+		gi = font->ascii_glyphs[codepoint];
+	else if (font->glyph_map_capacity > 0)
+		gi = gbgl__font_glyph_slot(font->glyph_map, font->glyph_map_capacity, codepoint)->glyph;
 
-				for (i = 0; i < f->glyph_count; i++) {
-					f->glyph_map[i].codepoint = fc->codepoints[i];
-					f->glyph_map[i].index = i;
-				}
+	if (!gi)
+		gi = gbgl__font_add_glyph(font, codepoint);
+	if (!gi || gi->glyph_index == 0)
+		return NULL;
 
-				gb_sort_array(f->glyph_map, f->glyph_count, gbgl__glyph_map_compare);
+	if (out_index)
+		*out_index = gi->glyph_index;
+	return gi;
+}
 
-				{ // Kerning Table
-					isize kps_count = 0;
-					for (i = 0; i < f->glyph_count; i++) {
-						for (j = 0; j < f->glyph_count; j++) {
-							i32 kern = stbtt_GetCodepointKernAdvance(&ttf->finfo, fc->codepoints[i], fc->codepoints[j]);
-							if (kern != 0)
-								kps_count++;
-						}
-					}
-					f->kern_pair_count = kps_count;
-					if (kps_count > 0) {
-						int ikp = 0;
-						f->kern_table = cast(gbglKernPair *)gbgl_malloc(gb_size_of(*f->kern_table) * kps_count);
-						for (i = 0; i < f->glyph_count; i++) {
-							for (j = 0; j < f->glyph_count; j++) {
-								isize kern = stbtt_GetCodepointKernAdvance(&ttf->finfo, fc->codepoints[i], fc->codepoints[j]);
-								if (kern != 0) {
-									gbglKernPair *kp = f->kern_table + ikp++;
-									kp->i0 = cast(u16)i;
-									kp->i1 = cast(u16)j;
-									kp->kern = cast(f32)kern * scale;
-								}
-							}
-						}
-						gb_sort_array(f->kern_table, f->kern_pair_count, gbgl__kern_pair_compare);
-					}
-				}
+gbglGlyphInfo *gbgl_get_glyph_info(gbglFont *font, Rune codepoint, isize *out_index) {
+	gbglGlyphInfo *gi = gbgl_get_glyph_metrics(font, codepoint, out_index);
+	if (gi && gi->width > 0 && gi->height > 0) {
+		gbglFontCache *fc = font->cache;
+		if (gi->page < 0 || fc->pages[gi->page].generation != gi->generation) {
+			if (!gbgl__font_rasterise_glyph(font, gi)) {
+				gi->page = -1; // NOTE(bill): Too large for a page, there is nothing to draw
+				return gi;
 			}
-		} else {
-			GB_PANIC("Failure loading font");
-			gb_zero_item(&f);
 		}
+		fc->pages[gi->page].last_used = ++fc->use_counter;
 	}
-	return f;
+	return gi;
 }
 
-
-gb_inline GB_COMPARE_PROC(gbgl__font_glyph_map_search_proc) {
-	gbglGlyphMapKVPair const *gm = cast(gbglGlyphMapKVPair const *)a;
-	char32 ucp = *cast(char32 const *)b;
-	return cast(i32)(cast(i64)gm->codepoint - cast(i64)ucp);
+gb_inline gbglTexture *gbgl_get_glyph_texture(gbglFont *font, gbglGlyphInfo const *glyph) {
+	gbglFontCache *fc = font->cache;
+	if (glyph == NULL || glyph->page < 0 || fc->pages[glyph->page].generation != glyph->generation)
+		return NULL;
+	return &fc->pages[glyph->page].texture;
 }
 
-gb_inline gbglGlyphInfo * gbgl_get_glyph_info(gbglFont *font, char32 codepoint, isize *out_index) {
-	isize index = gb_binary_search_array(font->glyph_map, font->glyph_count, &codepoint, gbgl__font_glyph_map_search_proc);
-	if (index >= 0) {
-		GB_ASSERT(codepoint == font->glyph_map[index].codepoint);
-		if (out_index)
-			*out_index = font->glyph_map[index].index;
-		return font->glyphs + font->glyph_map[index].index;
-	}
-	return NULL;
-}
+f32 gbgl_get_font_kerning_from_glyph_indices(gbglFont *font, isize left_index, isize right_index) {
+	gbglKernPair *kp;
+	u32 key;
 
-gb_inline f32 gbgl_get_font_kerning_from_glyph_indices(gbglFont *font, isize left_index, isize right_index) {
-	isize needle = (right_index << 16) | (left_index & 0xff);
+	if (left_index <= 0 || right_index <= 0)
+		return 0.0f;
 
-	isize f = 0;
-	isize l = font->kern_pair_count - 1;
-	isize m = (f + l) >> 1;
+	key = (cast(u32)left_index << 16) | (cast(u32)right_index & 0xffff);
+	if (key == 0xffffffffu ||
+	    (2*(font->kern_pair_count+1) > font->kern_table_capacity && !gbgl__font_grow_kern_table(font))) {
+		return cast(f32)stbtt_GetGlyphKernAdvance(&font->ttf->finfo, cast(int)left_index, cast(int)right_index) * font->scale;
+	}
 
-	while (f <= l) {
-		isize cmp = font->kern_table[m].packed - needle;
-		if (cmp < 0)
-			f = m + 1;
-		else if (cmp > 0)
-			l = m - 1;
-		else
-			return font->kern_table[m].kern;
-		m = (f + l) >> 1;
+	kp = gbgl__font_kern_slot(font->kern_table, font->kern_table_capacity, key);
+	if (kp->key != key) {
+		kp->key  = key;
+		kp->kern = cast(f32)stbtt_GetGlyphKernAdvance(&font->ttf->finfo, cast(int)left_index, cast(int)right_index) * font->scale;
+		font->kern_pair_count++;
 	}
-	return 0.0f;
+	return kp->kern;
 }
 
 void gbgl_get_string_dimensions(gbglFont *font, char const *str, f32 *out_width, f32 *out_height) {
@@ -1763,24 +2225,24 @@ void gbgl_get_string_dimensions(gbglFont *font, char const *str, f32 *out_width,
 	char const *ptr = str;
 
 	len = gb_strlen(str);
-	char_count = gb_utf8_strnlen(str, len);
+	char_count = gb_utf8_strnlen(cast(u8 const *)str, len);
 
 	for (i = 0; i < char_count; i++) {
-		char32 cp;
-		isize byte_len, curr_index;
+		Rune cp;
+		isize byte_len, curr_index = 0;
 		gbglGlyphInfo *gi;
 
-		byte_len = gb_utf8_decode_len(ptr, len-(ptr-str), &cp);
+		byte_len = gb_utf8_decode(cast(u8 const *)ptr, len-(ptr-str), &cp);
 		ptr += byte_len;
-		gi = gbgl_get_glyph_info(font, cp, &curr_index);
+		gi = gbgl_get_glyph_metrics(font, cp, &curr_index);
 		if (gi) {
 			f32 kern = 0;
 			if (i < char_count-1) {
-				isize next_index;
-				char32 next_cp = 0;
+				isize next_index = 0;
+				Rune next_cp = 0;
 				gbglGlyphInfo *ngi;
-				gb_utf8_decode_len(ptr, len-(ptr-str), &next_cp);
-				ngi = gbgl_get_glyph_info(font, next_cp, &next_index);
+				gb_utf8_decode(cast(u8 const *)ptr, len-(ptr-str), &next_cp);
+				ngi = gbgl_get_glyph_metrics(font, next_cp, &next_index);
 				if (ngi) kern = gbgl_get_font_kerning_from_glyph_indices(font, curr_index, next_index);
 			}
 			w += gi->xadv + kern;
@@ -1800,25 +2262,26 @@ f32 gbgl_get_sub_string_width(gbglFont *font, char const *str, isize char_count)
 		if (*ptr == 0) {
 			break;
 		} else {
-			char32 cp;
-			isize byte_len, curr_index;
+			Rune cp;
+			isize byte_len, curr_index = 0;
 			f32 kern = 0;
 			gbglGlyphInfo *gi;
 
-			byte_len = gb_utf8_decode_len(ptr, len-(ptr-str), &cp);
+			byte_len = gb_utf8_decode(cast(u8 const *)ptr, len-(ptr-str), &cp);
 			ptr += byte_len;
 			if (ptr - str > char_count)
 				break;
 
-			gi = gbgl_get_glyph_info(font, cp, &curr_index);
+			gi = gbgl_get_glyph_metrics(font, cp, &curr_index);
 			if (i < char_count-1) {
-				isize next_index;
-				char32 next_cp = 0;
-				gb_utf8_decode_len(ptr, len-(ptr-str), &next_cp);
-				gbgl_get_glyph_info(font, next_cp, &next_index);
+				isize next_index = 0;
+				Rune next_cp = 0;
+				gb_utf8_decode(cast(u8 const *)ptr, len-(ptr-str), &next_cp);
+				gbgl_get_glyph_metrics(font, next_cp, &next_index);
 				kern = gbgl_get_font_kerning_from_glyph_indices(font, curr_index, next_index);
 			}
-			w += gi->xadv + kern;
+			if (gi)
+				w += gi->xadv + kern;
 		}
 
 	}
@@ -1831,21 +2294,21 @@ i32 gbgl_get_wrapped_line_count(gbglFont *font, char const *str, isize max_len,
 	char const *ptr = str;
 
 	str_len = gb_strnlen(str, max_len);
-	char_count = gb_utf8_strnlen(str, str_len);
+	char_count = gb_utf8_strnlen(cast(u8 const *)str, str_len);
 
 	for (i = 0; i < char_count; i++) {
-		char32 cp;
-		isize byte_len, curr_index;
+		Rune cp;
+		isize byte_len, curr_index = 0;
 		gbglGlyphInfo *gi;
 		f32 kern = 0;
 
-		byte_len = gb_utf8_decode_len(ptr, str_len-(ptr-str), &cp);
+		byte_len = gb_utf8_decode(cast(u8 const *)ptr, str_len-(ptr-str), &cp);
 		ptr += byte_len;
 		// NOTE(bill): Check calculation here
 		if (ptr-str >= max_len-6)
 			break;
 
-		gi = gbgl_get_glyph_info(font, cp, &curr_index);
+		gi = gbgl_get_glyph_metrics(font, cp, &curr_index);
 		if (gi) {
 			if (w + gi->xadv >= cast(f32)max_width) {
 				line_count++;
@@ -1854,11 +2317,11 @@ i32 gbgl_get_wrapped_line_count(gbglFont *font, char const *str, isize max_len,
 		}
 
 		if (i < char_count-1) {
-			char32 next_cp;
-			isize next_index;
-			gb_utf8_decode_len(ptr, str_len-(ptr-str), &next_cp);
+			Rune next_cp;
+			isize next_index = 0;
+			gb_utf8_decode(cast(u8 const *)ptr, str_len-(ptr-str), &next_cp);
 
-			gbgl_get_glyph_info(font, next_cp, &next_index);
+			gbgl_get_glyph_metrics(font, next_cp, &next_index);
 			kern = gbgl_get_font_kerning_from_glyph_indices(font, curr_index, next_index);
 		}
 
@@ -1872,7 +2335,7 @@ i32 gbgl_get_wrapped_line_count(gbglFont *font, char const *str, isize max_len,
 
 gb_inline f32 gbgl_get_string_width(gbglFont *font, char const *str, isize max_len) {
 	isize len = gb_strnlen(str, max_len);
-	isize char_count = gb_utf8_strnlen(str, len);
+	isize char_count = gb_utf8_strnlen(cast(u8 const *)str, len);
 	return gbgl_get_sub_string_width(font, str, char_count);
 }
 
@@ -1888,63 +2351,64 @@ gb_inline f32 gbgl_get_string_width(gbglFont *font, char const *str, isize max_l
 #if !defined(GBGL_NO_BASIC_STATE)
 
 
+#if !defined(GBGL_NO_FONTS)
+gb_internal GBGL_FONT_FLUSH_PROC(gbgl__bs_font_flush_proc) {
+	gbgl_bs_flush(cast(gbglBasicState *)user_data);
+}
+#endif
+
 void gbgl_bs_init(gbglBasicState *bs, i32 window_width, i32 window_height) {
-	isize i;
+	bs->vertices        = NULL;
+	bs->indices         = NULL;
+	bs->vertex_count    = 0;
+	bs->index_count     = 0;
+	bs->batch_count     = 0;
+	bs->draw_call_count = 0;
 
 	gbgl_bs_set_resolution(bs, window_width, window_height);
+
+	// NOTE(bill): Room for two full batches per segment
+	gbgl_init_stream_buffer(&bs->vertex_stream, 2 * gb_size_of(gbglBasicVertex) * GBGL_BS_MAX_VERTEX_COUNT);
+	gbgl_init_stream_buffer(&bs->index_stream,  2 * gb_size_of(u16) * GBGL_BS_MAX_INDEX_COUNT);
+
 	glGenVertexArrays(1, &bs->vao);
 	glBindVertexArray(bs->vao);
+	gbgl_bind_vbo(bs->vertex_stream.handle);
+	gbgl_bind_ebo(bs->index_stream.handle);
 
-	bs->vbo = gbgl_make_vbo(NULL, gb_size_of(gbglBasicVertex) * GBGL_BS_MAX_VERTEX_COUNT, GL_DYNAMIC_DRAW);
-
-	for (i = 0; i < GBGL_BS_MAX_INDEX_COUNT / 6; i++) {
-		bs->indices[i*6 + 0] = i*4 + 0;
-		bs->indices[i*6 + 1] = i*4 + 1;
-		bs->indices[i*6 + 2] = i*4 + 2;
-		bs->indices[i*6 + 3] = i*4 + 2;
-		bs->indices[i*6 + 4] = i*4 + 3;
-		bs->indices[i*6 + 5] = i*4 + 0;
-	}
-	bs->ebo = gbgl_make_ebo(bs->indices, gb_size_of(u16) * GBGL_BS_MAX_INDEX_COUNT, GL_STATIC_DRAW);
+	// NOTE(bill): The vertex layout and the ebo binding are stored in the vao
+	gbgl_vert_ptr_aa    (0, 2, gbglBasicVertex, x);
+	gbgl_vert_ptr_aa    (1, 2, gbglBasicVertex, u);
+	gbgl_vert_ptr_aa_u8n(2, 4, gbglBasicVertex, col);
+	glBindVertexArray(0);
 
 	bs->nearest_sampler = gbgl_make_sampler(GL_NEAREST, GL_NEAREST, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
 	bs->linear_sampler  = gbgl_make_sampler(GL_LINEAR,  GL_LINEAR,  GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
 
+	gbgl_init_texture2d_coloured(&bs->white_texture, gbglColour_White);
+
 	gbgl_load_shader_from_memory_vf(&bs->ortho_tex_shader,
 		"#version 410 core\n"
 		"layout (location = 0) in vec4 a_position;\n"
 		"layout (location = 1) in vec2 a_tex_coord;\n"
+		"layout (location = 2) in vec4 a_colour;\n"
 		"uniform mat4 u_ortho_mat;\n"
 		"out vec2 v_tex_coord;\n"
+		"out vec4 v_colour;\n"
 		"void main(void) {\n"
 		"	gl_Position = u_ortho_mat * a_position;\n"
 		"	v_tex_coord = a_tex_coord;\n"
+		"	v_colour    = a_colour;\n"
 		"}\n",
 
 		"#version 410 core\n"
 		"precision mediump float;"
 		"in vec2 v_tex_coord;\n"
+		"in vec4 v_colour;\n"
 		"layout (binding = 0) uniform sampler2D u_tex;\n"
 		"out vec4 o_colour;\n"
 		"void main(void) {\n"
-		"	o_colour = texture2D(u_tex, v_tex_coord);\n"
-		"}\n"
-	);
-
-	gbgl_load_shader_from_memory_vf(&bs->ortho_col_shader,
-		"#version 410 core\n"
-		"precision mediump float;"
-		"layout (location = 0) in vec4 a_position;\n"
-		"uniform mat4 u_ortho_mat;\n"
-		"void main(void) {\n"
-		"	gl_Position = u_ortho_mat * a_position;\n"
-		"}\n",
-
-		"#version 410 core\n"
-		"uniform vec4 u_colour;\n"
-		"out vec4 o_colour;\n"
-		"void main(void) {\n"
-		"	o_colour = u_colour;\n"
+		"	o_colour = v_colour * texture2D(u_tex, v_tex_coord);\n"
 		"}\n"
 	);
 
@@ -1954,41 +2418,32 @@ void gbgl_bs_init(gbglBasicState *bs, i32 window_width, i32 window_height) {
 		"#version 410 core\n"
 		"layout (location = 0) in vec4 a_position;\n"
 		"layout (location = 1) in vec2 a_tex_coord;\n"
+		"layout (location = 2) in vec4 a_colour;\n"
 		"uniform mat4 u_ortho_mat;\n"
 		"out vec2 v_tex_coord;\n"
+		"out vec4 v_colour;\n"
 		"void main(void) {\n"
 		"	gl_Position = u_ortho_mat * a_position;\n"
 		"	v_tex_coord = a_tex_coord;\n"
+		"	v_colour    = a_colour;\n"
 		"}\n",
 
 		"#version 410 core\n"
 		"in vec2 v_tex_coord;\n"
-		"uniform vec4 u_colour;\n"
+		"in vec4 v_colour;\n"
 		"layout (binding = 0) uniform sampler2D u_tex;\n"
 		"out vec4 o_colour;\n"
 		"void main(void) {\n"
-		"	o_colour = u_colour * texture2D(u_tex, v_tex_coord).r;\n"
+		"	o_colour = v_colour * texture2D(u_tex, v_tex_coord).r;\n"
 		"}\n"
 	);
 
-	glGenVertexArrays(1, &bs->font_vao);
-	glBindVertexArray(bs->font_vao);
-
-	bs->font_vbo = gbgl_make_vbo(NULL, gb_size_of(gbglBasicVertex) * GBGL_MAX_RENDER_STRING_LENGTH * 4, GL_DYNAMIC_DRAW);
-
-	for (i = 0; i < GBGL_MAX_RENDER_STRING_LENGTH; i++) {
-		bs->font_indices[i*6 + 0] = i*4 + 0;
-		bs->font_indices[i*6 + 1] = i*4 + 1;
-		bs->font_indices[i*6 + 2] = i*4 + 2;
-		bs->font_indices[i*6 + 3] = i*4 + 2;
-		bs->font_indices[i*6 + 4] = i*4 + 3;
-		bs->font_indices[i*6 + 5] = i*4 + 0;
-	}
-	bs->font_ebo = gbgl_make_ebo(bs->font_indices, gb_size_of(u16) * GBGL_MAX_RENDER_STRING_LENGTH * 6, GL_STATIC_DRAW);
-
 	bs->font_samplers[0] = gbgl_make_sampler(GL_NEAREST, GL_NEAREST, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
 	bs->font_samplers[1] = gbgl_make_sampler(GL_LINEAR,  GL_LINEAR,  GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
 
+	bs->font_cache.flush_proc      = gbgl__bs_font_flush_proc;
+	bs->font_cache.flush_user_data = bs;
+
 	bs->text_params[gbglTextParam_MaxWidth]     .val_i32 = 0;
 	bs->text_params[gbglTextParam_Justify]       .val_i32 = gbglJustify_Left;
 	bs->text_params[gbglTextParam_TextureFilter].val_i32 = 0;
@@ -2003,6 +2458,10 @@ gb_inline void gbgl_bs_set_resolution(gbglBasicState *bs, i32 window_width, i32
 	f32 znear  = 0.0f;
 	f32 zfar   = 1.0f;
 
+	// NOTE(bill): Pending draws must use the matrix they were submitted with
+	if (bs->batch_count > 0 && (bs->width != window_width || bs->height != window_height))
+		gbgl_bs_flush(bs);
+
 	bs->width  = window_width;
 	bs->height = window_height;
 
@@ -2031,51 +2490,224 @@ gb_inline void gbgl_bs_begin(gbglBasicState *bs, i32 window_width, i32 window_he
 	glBindVertexArray(bs->vao);
 	glDisable(GL_SCISSOR_TEST);
 	gbgl_bs_set_resolution(bs, window_width, window_height);
+	bs->draw_call_count = 0;
 }
 
 gb_inline void gbgl_bs_end(gbglBasicState *bs) {
+	GB_PROFILE_BEGIN("gbgl_bs_end");
+	gbgl_bs_flush(bs);
+	gbgl_stream_buffer_end_frame(&bs->vertex_stream);
+	gbgl_stream_buffer_end_frame(&bs->index_stream);
 	glBindVertexArray(0);
+	GB_PROFILE_END();
 }
 
+void gbgl_bs_flush(gbglBasicState *bs) {
+	gbglShader *curr_shader = NULL;
+	u32 curr_texture = 0, curr_sampler = 0;
+	f32 curr_line_width = 0.0f;
+	isize i;
 
+	if (bs->vertices != NULL) {
+		gbgl_stream_buffer_unmap(&bs->vertex_stream, bs->vertex_count * gb_size_of(gbglBasicVertex));
+		gbgl_stream_buffer_unmap(&bs->index_stream,  bs->index_count  * gb_size_of(u16));
+		bs->vertices = NULL;
+		bs->indices  = NULL;
+	}
 
+	if (bs->batch_count > 0) {
+		i32 base_vertex = cast(i32)(bs->vertex_stream_offset / gb_size_of(gbglBasicVertex));
+
+		glBindVertexArray(bs->vao);
+		glEnable(GL_BLEND);
+		glBlendEquation(GL_FUNC_ADD);
+		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		glActiveTexture(GL_TEXTURE0);
+
+		for (i = 0; i < bs->batch_count; i++) {
+			gbglBasicBatch *b = &bs->batches[i];
+			gbglShader *shader = &bs->ortho_tex_shader;
+		#if !defined(GBGL_NO_FONTS)
+			if (b->kind == gbglBasicBatch_Text)
+				shader = &bs->font_shader;
+		#endif
+
+			if (shader != curr_shader) {
+				gbgl_use_shader(shader);
+				gbgl_set_uniform_mat4(shader, "u_ortho_mat", bs->ortho_mat);
+				curr_shader = shader;
+			}
+			if (i == 0 || b->texture != curr_texture) {
+				glBindTexture(GL_TEXTURE_2D, b->texture);
+				curr_texture = b->texture;
+			}
+			if (i == 0 || b->sampler != curr_sampler) {
+				glBindSampler(0, b->sampler);
+				curr_sampler = b->sampler;
+			}
+			if (b->primitive == GL_LINES && b->line_width != curr_line_width) {
+				glLineWidth(b->line_width);
+				curr_line_width = b->line_width;
+			}
 
-void gbgl_bs_draw_textured_rect(gbglBasicState *bs, gbglTexture *tex, f32 x, f32 y, f32 w, f32 h, b32 v_up) {
-	bs->vertices[0].x = x;
-	bs->vertices[0].y = y;
-	bs->vertices[0].u = 0.0f;
-	bs->vertices[0].v = v_up ? 0.0f : 1.0f;
+			glDrawElementsBaseVertex(b->primitive, cast(i32)b->index_count, GL_UNSIGNED_SHORT,
+			                         cast(void const *)(bs->index_stream_offset + b->index_offset*gb_size_of(u16)),
+			                         base_vertex);
+			bs->draw_call_count++;
+		}
+	}
+
+	bs->vertex_count = 0;
+	bs->index_count  = 0;
+	bs->batch_count  = 0;
+}
+
+
+// NOTE(bill): Reserves space in the batch for a shape and merges it with the previous batch if the
+// state matches. The indices returned are relative to the first vertex returned.
+gb_internal gbglBasicVertex *gbgl__bs_reserve(gbglBasicState *bs, gbglBasicBatchKind kind, u32 primitive,
+                                              u32 texture, u32 sampler, f32 line_width,
+                                              isize vertex_count, isize index_count,
+                                              u16 **indices, u16 *base_index) {
+	gbglBasicBatch *b = NULL;
+	gbglBasicVertex *vertices;
+
+	GB_ASSERT(vertex_count <= GBGL_BS_MAX_VERTEX_COUNT && index_count <= GBGL_BS_MAX_INDEX_COUNT);
+
+	if (bs->vertex_count + vertex_count > GBGL_BS_MAX_VERTEX_COUNT ||
+	    bs->index_count  + index_count  > GBGL_BS_MAX_INDEX_COUNT) {
+		gbgl_bs_flush(bs);
+	}
+
+	if (bs->batch_count > 0) {
+		b = &bs->batches[bs->batch_count-1];
+		if (b->kind != kind || b->primitive != primitive ||
+		    b->texture != texture || b->sampler != sampler ||
+		    b->line_width != line_width) {
+			b = NULL;
+		}
+	}
+
+	if (b == NULL) {
+		if (bs->batch_count == GBGL_BS_MAX_BATCH_COUNT)
+			gbgl_bs_flush(bs);
+		if (bs->vertices == NULL) {
+			bs->vertices = cast(gbglBasicVertex *)gbgl_stream_buffer_map(&bs->vertex_stream,
+			                                                              gb_size_of(gbglBasicVertex) * GBGL_BS_MAX_VERTEX_COUNT,
+			                                                              gb_size_of(gbglBasicVertex),
+			                                                              &bs->vertex_stream_offset);
+			bs->indices = cast(u16 *)gbgl_stream_buffer_map(&bs->index_stream,
+			                                                gb_size_of(u16) * GBGL_BS_MAX_INDEX_COUNT,
+			                                                gb_size_of(u16),
+			                                                &bs->index_stream_offset);
+		}
+		b = &bs->batches[bs->batch_count++];
+		b->kind         = kind;
+		b->primitive    = primitive;
+		b->texture      = texture;
+		b->sampler      = sampler;
+		b->line_width   = line_width;
+		b->index_offset = bs->index_count;
+		b->index_count  = 0;
+	}
+
+	vertices    = bs->vertices + bs->vertex_count;
+	*indices    = bs->indices  + bs->index_count;
+	*base_index = cast(u16)bs->vertex_count;
+
+	b->index_count   += index_count;
+	bs->vertex_count += vertex_count;
+	bs->index_count  += index_count;
+
+	return vertices;
+}
+
+gb_internal gbglBasicVertex *gbgl__bs_push_quad(gbglBasicState *bs, gbglBasicBatchKind kind, u32 texture, u32 sampler) {
+	u16 *indices, base;
+	gbglBasicVertex *v = gbgl__bs_reserve(bs, kind, GL_TRIANGLES, texture, sampler, 0.0f, 4, 6, &indices, &base);
+	indices[0] = base + 0;
+	indices[1] = base + 1;
+	indices[2] = base + 2;
+	indices[3] = base + 2;
+	indices[4] = base + 3;
+	indices[5] = base + 0;
+	return v;
+}
+
+// NOTE(bill): `points` is a triangle fan with points[0] as the centre
+gb_internal void gbgl__bs_push_fan(gbglBasicState *bs, gbglBasicVertex const *points, isize count, gbglColour col) {
+	u16 *indices, base;
+	gbglBasicVertex *v;
+	isize i;
+
+	if (count < 3) return;
+	v = gbgl__bs_reserve(bs, gbglBasicBatch_Sprite, GL_TRIANGLES,
+	                     bs->white_texture.handle, bs->nearest_sampler, 0.0f,
+	                     count, 3*(count-2), &indices, &base);
+	for (i = 0; i < count; i++) {
+		v[i].x = points[i].x;
+		v[i].y = points[i].y;
+		v[i].u = 0.5f;
+		v[i].v = 0.5f;
+		v[i].col = col;
+	}
+	for (i = 0; i < count-2; i++) {
+		indices[i*3 + 0] = base;
+		indices[i*3 + 1] = base + cast(u16)(i+1);
+		indices[i*3 + 2] = base + cast(u16)(i+2);
+	}
+}
 
-	bs->vertices[1].x = x + w;
-	bs->vertices[1].y = y;
-	bs->vertices[1].u = 1.0f;
-	bs->vertices[1].v = v_up ? 0.0f : 1.0f;
+gb_internal void gbgl__bs_push_lines(gbglBasicState *bs, gbglBasicVertex const *points, isize count, b32 closed,
+                                     gbglColour col, f32 thickness) {
+	u16 *indices, base;
+	gbglBasicVertex *v;
+	isize i, segment_count;
+
+	if (count < 2) return;
+	segment_count = closed ? count : count-1;
+	v = gbgl__bs_reserve(bs, gbglBasicBatch_Sprite, GL_LINES,
+	                     bs->white_texture.handle, bs->nearest_sampler, thickness,
+	                     count, 2*segment_count, &indices, &base);
+	for (i = 0; i < count; i++) {
+		v[i].x = points[i].x;
+		v[i].y = points[i].y;
+		v[i].u = 0.5f;
+		v[i].v = 0.5f;
+		v[i].col = col;
+	}
+	for (i = 0; i < segment_count; i++) {
+		indices[i*2 + 0] = base + cast(u16)i;
+		indices[i*2 + 1] = base + cast(u16)((i+1) % count);
+	}
+}
 
-	bs->vertices[2].x = x + w;
-	bs->vertices[2].y = y + h;
-	bs->vertices[2].u = 1.0f;
-	bs->vertices[2].v = v_up ? 1.0f : 0.0f;
 
-	bs->vertices[3].x = x;
-	bs->vertices[3].y = y + h;
-	bs->vertices[3].u = 0.0f;
-	bs->vertices[3].v = v_up ? 1.0f : 0.0f;
 
-	gbgl_use_shader(&bs->ortho_tex_shader);
-	gbgl_set_uniform_mat4(&bs->ortho_tex_shader, "u_ortho_mat", bs->ortho_mat);
-	gbgl_bind_texture2d(tex, 0, bs->nearest_sampler);
+void gbgl_bs_draw_textured_rect(gbglBasicState *bs, gbglTexture *tex, f32 x, f32 y, f32 w, f32 h, b32 v_up) {
+	gbglBasicVertex *v = gbgl__bs_push_quad(bs, gbglBasicBatch_Sprite, tex->handle, bs->nearest_sampler);
+
+	v[0].x = x;
+	v[0].y = y;
+	v[0].u = 0.0f;
+	v[0].v = v_up ? 0.0f : 1.0f;
 
-	gbgl_vbo_copy(bs->vbo, bs->vertices, 4*gb_size_of(bs->vertices[0]), 0);
+	v[1].x = x + w;
+	v[1].y = y;
+	v[1].u = 1.0f;
+	v[1].v = v_up ? 0.0f : 1.0f;
 
-	gbgl_vert_ptr_aa(0, 2, gbglBasicVertex, x);
-	gbgl_vert_ptr_aa(1, 2, gbglBasicVertex, u);
+	v[2].x = x + w;
+	v[2].y = y + h;
+	v[2].u = 1.0f;
+	v[2].v = v_up ? 1.0f : 0.0f;
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bs->ebo);
+	v[3].x = x;
+	v[3].y = y + h;
+	v[3].u = 0.0f;
+	v[3].v = v_up ? 1.0f : 0.0f;
 
-	glEnable(GL_BLEND);
-	glBlendEquationi(0, GL_FUNC_ADD);
-	glBlendFunci(0, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, NULL);
+	v[0].col = v[1].col = v[2].col = v[3].col = gbglColour_White;
 }
 
 gb_inline void gbgl_bs_draw_rect(gbglBasicState *bs, f32 x, f32 y, f32 w, f32 h, gbglColour col) {
@@ -2098,41 +2730,32 @@ gb_inline void gbgl_bs_draw_rect_outline(gbglBasicState *bs, f32 x, f32 y, f32 w
 }
 
 
-gb_internal void gbgl__bs_setup_ortho_colour_state(gbglBasicState *bs, isize vertex_count, gbglColour col) {
-
-	gbgl_use_shader(&bs->ortho_col_shader);
-	gbgl_set_uniform_mat4(&bs->ortho_col_shader, "u_ortho_mat", bs->ortho_mat);
-	gbgl_set_uniform_colour(&bs->ortho_col_shader, "u_colour", col);
-
-	gbgl_vbo_copy(bs->vbo, bs->vertices, vertex_count*gb_size_of(bs->vertices[0]), 0);
-	gbgl_vert_ptr_aa(0, 2, gbglBasicVertex, x);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bs->ebo);
-
-	glEnable(GL_BLEND);
-	glBlendEquation(GL_FUNC_ADD);
-	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-}
-
 gb_inline void gbgl_bs_draw_quad(gbglBasicState *bs,
                                  f32 x0, f32 y0,
                                  f32 x1, f32 y1,
                                  f32 x2, f32 y2,
                                  f32 x3, f32 y3,
                                  gbglColour col) {
-	bs->vertices[0].x = x0;
-	bs->vertices[0].y = y0;
+	gbglBasicVertex *v = gbgl__bs_push_quad(bs, gbglBasicBatch_Sprite, bs->white_texture.handle, bs->nearest_sampler);
+	isize i;
 
-	bs->vertices[1].x = x1;
-	bs->vertices[1].y = y1;
+	v[0].x = x0;
+	v[0].y = y0;
 
-	bs->vertices[2].x = x2;
-	bs->vertices[2].y = y2;
+	v[1].x = x1;
+	v[1].y = y1;
 
-	bs->vertices[3].x = x3;
-	bs->vertices[3].y = y3;
+	v[2].x = x2;
+	v[2].y = y2;
 
-	gbgl__bs_setup_ortho_colour_state(bs, 4, col);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, NULL);
+	v[3].x = x3;
+	v[3].y = y3;
+
+	for (i = 0; i < 4; i++) {
+		v[i].u = 0.5f;
+		v[i].v = 0.5f;
+		v[i].col = col;
+	}
 }
 
 gb_inline void gbgl_bs_draw_quad_outline(gbglBasicState *bs,
@@ -2141,57 +2764,58 @@ gb_inline void gbgl_bs_draw_quad_outline(gbglBasicState *bs,
                                          f32 x2, f32 y2,
                                          f32 x3, f32 y3,
                                          gbglColour col, f32 thickness) {
-	bs->vertices[0].x = x0;
-	bs->vertices[0].y = y0;
+	gbglBasicVertex points[4];
+
+	points[0].x = x0;
+	points[0].y = y0;
 
-	bs->vertices[1].x = x1;
-	bs->vertices[1].y = y1;
+	points[1].x = x1;
+	points[1].y = y1;
 
-	bs->vertices[2].x = x2;
-	bs->vertices[2].y = y2;
+	points[2].x = x2;
+	points[2].y = y2;
 
-	bs->vertices[3].x = x3;
-	bs->vertices[3].y = y3;
+	points[3].x = x3;
+	points[3].y = y3;
 
-	gbgl__bs_setup_ortho_colour_state(bs, 4, col);
-	glLineWidth(thickness);
-	glDrawArrays(GL_LINE_LOOP, 0, 4);
+	gbgl__bs_push_lines(bs, points, 4, true, col, thickness);
 }
 
 gb_inline void gbgl_bs_draw_line(gbglBasicState *bs, f32 x0, f32 y0, f32 x1, f32 y1, gbglColour col, f32 thickness) {
-	bs->vertices[0].x = x0;
-	bs->vertices[0].y = y0;
+	gbglBasicVertex points[2];
 
-	bs->vertices[1].x = x1;
-	bs->vertices[1].y = y1;
+	points[0].x = x0;
+	points[0].y = y0;
 
-	gbgl__bs_setup_ortho_colour_state(bs, 2, col);
-	glLineWidth(thickness);
-	glDrawArrays(GL_LINES, 0, 2);
+	points[1].x = x1;
+	points[1].y = y1;
+
+	gbgl__bs_push_lines(bs, points, 2, false, col, thickness);
 }
 
 gb_inline void gbgl_bs_draw_elliptical_arc(gbglBasicState *bs, f32 x, f32 y, f32 radius_a, f32 radius_b,
                                            f32 min_angle, f32 max_angle, gbglColour col) {
+	gbglBasicVertex points[32];
 	isize i;
 
-	bs->vertices[0].x = x;
-	bs->vertices[0].y = y;
+	points[0].x = x;
+	points[0].y = y;
 
 	for (i = 0; i < 31; i++) {
 		f32 t = cast(f32)i / 30.0f;
 		f32 a = gbgl_lerp(min_angle, max_angle, t);
 		f32 c = gbgl_cos(a);
 		f32 s = gbgl_sin(a);
-		bs->vertices[i+1].x = x + c*radius_a;
-		bs->vertices[i+1].y = y + s*radius_b;
+		points[i+1].x = x + c*radius_a;
+		points[i+1].y = y + s*radius_b;
 	}
 
-	gbgl__bs_setup_ortho_colour_state(bs, 32, col);
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 32);
+	gbgl__bs_push_fan(bs, points, 32, col);
 }
 
 gb_inline void gbgl_bs_draw_elliptical_arc_outline(gbglBasicState *bs, f32 x, f32 y, f32 radius_a, f32 radius_b,
                                                    f32 min_angle, f32 max_angle, gbglColour col, f32 thickness) {
+	gbglBasicVertex points[32];
 	isize i;
 
 	for (i = 0; i < 32; i++) {
@@ -2199,17 +2823,16 @@ gb_inline void gbgl_bs_draw_elliptical_arc_outline(gbglBasicState *bs, f32 x, f3
 		f32 a = gbgl_lerp(min_angle, max_angle, t);
 		f32 c = gbgl_cos(a);
 		f32 s = gbgl_sin(a);
-		bs->vertices[i+1].x = x + c*radius_a;
-		bs->vertices[i+1].y = y + s*radius_b;
+		points[i].x = x + c*radius_a;
+		points[i].y = y + s*radius_b;
 	}
 
-	gbgl__bs_setup_ortho_colour_state(bs, 32, col);
-	glLineWidth(thickness);
-	glDrawArrays(GL_LINES, 0, 32);
+	gbgl__bs_push_lines(bs, points, 32, false, col, thickness);
 }
 
 
 
+
 gb_inline void gbgl_bs_draw_circle(gbglBasicState *bs, f32 x, f32 y, f32 radius, gbglColour col) {
 	gbgl_bs_draw_elliptical_arc(bs, x, y, radius, radius, 0, GBGL_TAU, col);
 }
@@ -2227,10 +2850,11 @@ void gbgl_bs_draw_rounded_rect_corners(gbglBasicState *bs, f32 x, f32 y, f32 w,
 	if (roundness == 0 || corners == 0) {
 		gbgl_bs_draw_rect(bs, x, y, w, h, col);
 	} else {
+		gbglBasicVertex points[32];
 		isize i, vc = 0;
 
-		bs->vertices[vc].x = x + 0.5f*w;
-		bs->vertices[vc].y = y + 0.5f*h;
+		points[vc].x = x + 0.5f*w;
+		points[vc].y = y + 0.5f*h;
 		vc++;
 
 		if (corners & 1) {
@@ -2239,13 +2863,13 @@ void gbgl_bs_draw_rounded_rect_corners(gbglBasicState *bs, f32 x, f32 y, f32 w,
 				f32 a = gbgl_lerp(0.5f*GBGL_TAU, 0.75f*GBGL_TAU, t);
 				f32 c = gbgl_cos(a);
 				f32 s = gbgl_sin(a);
-				bs->vertices[vc].x = x + roundness + c*roundness;
-				bs->vertices[vc].y = y + roundness + s*roundness;
+				points[vc].x = x + roundness + c*roundness;
+				points[vc].y = y + roundness + s*roundness;
 				vc++;
 			}
 		} else {
-			bs->vertices[vc].x = x;
-			bs->vertices[vc].y = y;
+			points[vc].x = x;
+			points[vc].y = y;
 			vc++;
 		}
 
@@ -2255,13 +2879,13 @@ void gbgl_bs_draw_rounded_rect_corners(gbglBasicState *bs, f32 x, f32 y, f32 w,
 				f32 a = gbgl_lerp(0.75f*GBGL_TAU, 1.00f*GBGL_TAU, t);
 				f32 c = gbgl_cos(a);
 				f32 s = gbgl_sin(a);
-				bs->vertices[vc].x = x + w - roundness + c*roundness;
-				bs->vertices[vc].y = y + roundness + s*roundness;
+				points[vc].x = x + w - roundness + c*roundness;
+				points[vc].y = y + roundness + s*roundness;
 				vc++;
 			}
 		} else {
-			bs->vertices[vc].x = x + w;
-			bs->vertices[vc].y = y;
+			points[vc].x = x + w;
+			points[vc].y = y;
 			vc++;
 		}
 
@@ -2272,13 +2896,13 @@ void gbgl_bs_draw_rounded_rect_corners(gbglBasicState *bs, f32 x, f32 y, f32 w,
 				f32 a = gbgl_lerp(0.00f*GBGL_TAU, 0.25f*GBGL_TAU, t);
 				f32 c = gbgl_cos(a);
 				f32 s = gbgl_sin(a);
-				bs->vertices[vc].x = x + w - roundness + c*roundness;
-				bs->vertices[vc].y = y + h - roundness + s*roundness;
+				points[vc].x = x + w - roundness + c*roundness;
+				points[vc].y = y + h - roundness + s*roundness;
 				vc++;
 			}
 		} else {
-			bs->vertices[vc].x = x + w;
-			bs->vertices[vc].y = y + h;
+			points[vc].x = x + w;
+			points[vc].y = y + h;
 			vc++;
 		}
 
@@ -2288,27 +2912,26 @@ void gbgl_bs_draw_rounded_rect_corners(gbglBasicState *bs, f32 x, f32 y, f32 w,
 				f32 a = gbgl_lerp(0.25f*GBGL_TAU, 0.50f*GBGL_TAU, t);
 				f32 c = gbgl_cos(a);
 				f32 s = gbgl_sin(a);
-				bs->vertices[vc].x = x + roundness + c*roundness;
-				bs->vertices[vc].y = y + h - roundness + s*roundness;
+				points[vc].x = x + roundness + c*roundness;
+				points[vc].y = y + h - roundness + s*roundness;
 				vc++;
 			}
 		} else {
-			bs->vertices[vc].x = x;
-			bs->vertices[vc].y = y + h;
+			points[vc].x = x;
+			points[vc].y = y + h;
 			vc++;
 		}
 
 		if (corners & 1) {
-			bs->vertices[vc].x = x;
-			bs->vertices[vc].y = y + roundness;
+			points[vc].x = x;
+			points[vc].y = y + roundness;
 		} else {
-			bs->vertices[vc].x = x;
-			bs->vertices[vc].y = y;
+			points[vc].x = x;
+			points[vc].y = y;
 		}
 		vc++;
 
-		gbgl__bs_setup_ortho_colour_state(bs, vc, col);
-		glDrawArrays(GL_TRIANGLE_FAN, 0, vc);
+		gbgl__bs_push_fan(bs, points, vc, col);
 	}
 }
 
@@ -2326,6 +2949,7 @@ void gbgl_bs_draw_rounded_rect_corners_outline(gbglBasicState *bs, f32 x, f32 y,
 	if (roundness == 0 || corners == 0) {
 		gbgl_bs_draw_rect_outline(bs, x, y, w, h, col, thickness);
 	} else {
+		gbglBasicVertex points[32];
 		isize i, vc = 0;
 
 		if (corners & 1) {
@@ -2334,13 +2958,13 @@ void gbgl_bs_draw_rounded_rect_corners_outline(gbglBasicState *bs, f32 x, f32 y,
 				f32 a = gbgl_lerp(0.5f*GBGL_TAU, 0.75f*GBGL_TAU, t);
 				f32 c = gbgl_cos(a);
 				f32 s = gbgl_sin(a);
-				bs->vertices[vc].x = x + roundness + c*roundness;
-				bs->vertices[vc].y = y + roundness + s*roundness;
+				points[vc].x = x + roundness + c*roundness;
+				points[vc].y = y + roundness + s*roundness;
 				vc++;
 			}
 		} else {
-			bs->vertices[vc].x = x;
-			bs->vertices[vc].y = y;
+			points[vc].x = x;
+			points[vc].y = y;
 			vc++;
 		}
 
@@ -2350,13 +2974,13 @@ void gbgl_bs_draw_rounded_rect_corners_outline(gbglBasicState *bs, f32 x, f32 y,
 				f32 a = gbgl_lerp(0.75f*GBGL_TAU, 1.00f*GBGL_TAU, t);
 				f32 c = gbgl_cos(a);
 				f32 s = gbgl_sin(a);
-				bs->vertices[vc].x = x + w - roundness + c*roundness;
-				bs->vertices[vc].y = y + roundness + s*roundness;
+				points[vc].x = x + w - roundness + c*roundness;
+				points[vc].y = y + roundness + s*roundness;
 				vc++;
 			}
 		} else {
-			bs->vertices[vc].x = x + w;
-			bs->vertices[vc].y = y;
+			points[vc].x = x + w;
+			points[vc].y = y;
 			vc++;
 		}
 
@@ -2367,13 +2991,13 @@ void gbgl_bs_draw_rounded_rect_corners_outline(gbglBasicState *bs, f32 x, f32 y,
 				f32 a = gbgl_lerp(0.00f*GBGL_TAU, 0.25f*GBGL_TAU, t);
 				f32 c = gbgl_cos(a);
 				f32 s = gbgl_sin(a);
-				bs->vertices[vc].x = x + w - roundness + c*roundness;
-				bs->vertices[vc].y = y + h - roundness + s*roundness;
+				points[vc].x = x + w - roundness + c*roundness;
+				points[vc].y = y + h - roundness + s*roundness;
 				vc++;
 			}
 		} else {
-			bs->vertices[vc].x = x + w;
-			bs->vertices[vc].y = y + h;
+			points[vc].x = x + w;
+			points[vc].y = y + h;
 			vc++;
 		}
 
@@ -2383,19 +3007,17 @@ void gbgl_bs_draw_rounded_rect_corners_outline(gbglBasicState *bs, f32 x, f32 y,
 				f32 a = gbgl_lerp(0.25f*GBGL_TAU, 0.50f*GBGL_TAU, t);
 				f32 c = gbgl_cos(a);
 				f32 s = gbgl_sin(a);
-				bs->vertices[vc].x = x + roundness + c*roundness;
-				bs->vertices[vc].y = y + h - roundness + s*roundness;
+				points[vc].x = x + roundness + c*roundness;
+				points[vc].y = y + h - roundness + s*roundness;
 				vc++;
 			}
 		} else {
-			bs->vertices[vc].x = x;
-			bs->vertices[vc].y = y + h;
+			points[vc].x = x;
+			points[vc].y = y + h;
 			vc++;
 		}
 
-		gbgl__bs_setup_ortho_colour_state(bs, vc, col);
-		glLineWidth(thickness);
-		glDrawArrays(GL_LINE_LOOP, 0, vc);
+		gbgl__bs_push_lines(bs, points, vc, true, col, thickness);
 	}
 }
 
@@ -2410,7 +3032,7 @@ gb_inline void gbgl_bs_draw_rounded_rect_outline(gbglBasicState *bs, f32 x, f32
 
 
 isize gbgl_bs_draw_substring(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, gbglColour col, char const *str, isize len) {
-	isize char_count = gb_utf8_strnlen(str, len);
+	isize char_count = gb_utf8_strnlen(cast(u8 const *)str, len);
 	isize line_count = 0;
 	if (char_count > 0) {
 		char const *ptr = str;
@@ -2421,7 +3043,8 @@ isize gbgl_bs_draw_substring(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, g
 		f32 ox, oy;
 		f32 px, py;
 
-		isize glyph_count = 0, i;
+		isize glyph_count = 0, i, sampler_index = 0;
+		u32 font_sampler;
 		f32 font_height = font->size;
 		i32 max_width = bs->text_params[gbglTextParam_MaxWidth].val_i32;
 
@@ -2436,6 +3059,11 @@ isize gbgl_bs_draw_substring(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, g
 			x = gbgl_round(x - width);
 		}
 
+		GB_ASSERT(bs->text_params[gbglTextParam_TextureFilter].val_i32 < gb_count_of(bs->font_samplers));
+		if (bs->text_params[gbglTextParam_TextureFilter].val_i32 < gb_count_of(bs->font_samplers))
+			sampler_index = bs->text_params[gbglTextParam_TextureFilter].val_i32;
+		font_sampler = bs->font_samplers[sampler_index];
+
 		line_count = 1;
 
 		ox = x;
@@ -2444,11 +3072,12 @@ isize gbgl_bs_draw_substring(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, g
 		py = oy;
 
 		for (i = 0; i < char_count; i++) {
-			char32 cp;
-			isize byte_len, curr_index, draw_this_glyph_count = 1, j;
+			Rune cp;
+			isize byte_len, curr_index = 0, draw_this_glyph_count = 1, j;
 			gbglGlyphInfo *gi;
+			gbglTexture *tex;
 
-			byte_len = gb_utf8_decode_len(ptr, len-(ptr-str), &cp);
+			byte_len = gb_utf8_decode(cast(u8 const *)ptr, len-(ptr-str), &cp);
 			ptr += byte_len;
 			if (ptr - str > len)
 				break;
@@ -2465,10 +3094,12 @@ isize gbgl_bs_draw_substring(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, g
 			}
 
 			if (gi) {
+				tex = gbgl_get_glyph_texture(font, gi);
 				for (j = 0; j < draw_this_glyph_count; j++) {
 					f32 s0, t0, s1, t1;
 					f32 x0, y0, x1, y1;
 					f32 kern = 0.0f;
+					gbglBasicVertex *v;
 
 
 					if (cp == '\r' || cp == '\n' ||
@@ -2485,6 +3116,9 @@ isize gbgl_bs_draw_substring(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, g
 						}
 					}
 
+					if (tex == NULL) // NOTE(bill): Nothing to draw (e.g. a space)
+						goto advance;
+
 					s0 = cast(f32)gi->s0 * sf;
 					t0 = cast(f32)gi->t0 * tf;
 					s1 = cast(f32)gi->s1 * sf;
@@ -2495,35 +3129,41 @@ isize gbgl_bs_draw_substring(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, g
 					x1 = x0 + (gi->s1 - gi->s0);
 					y1 = y0 + (gi->t0 - gi->t1);
 
-					bs->font_vertices[glyph_count*4 + 0].x = x0;
-					bs->font_vertices[glyph_count*4 + 0].y = y0;
-					bs->font_vertices[glyph_count*4 + 0].u = s0;
-					bs->font_vertices[glyph_count*4 + 0].v = t0;
+					// NOTE(bill): Consecutive glyphs in the same page are merged into one batch
+					v = gbgl__bs_push_quad(bs, gbglBasicBatch_Text, tex->handle, font_sampler);
+
+					v[0].x = x0;
+					v[0].y = y0;
+					v[0].u = s0;
+					v[0].v = t0;
 
-					bs->font_vertices[glyph_count*4 + 1].x = x1;
-					bs->font_vertices[glyph_count*4 + 1].y = y0;
-					bs->font_vertices[glyph_count*4 + 1].u = s1;
-					bs->font_vertices[glyph_count*4 + 1].v = t0;
+					v[1].x = x1;
+					v[1].y = y0;
+					v[1].u = s1;
+					v[1].v = t0;
 
-					bs->font_vertices[glyph_count*4 + 2].x = x1;
-					bs->font_vertices[glyph_count*4 + 2].y = y1;
-					bs->font_vertices[glyph_count*4 + 2].u = s1;
-					bs->font_vertices[glyph_count*4 + 2].v = t1;
+					v[2].x = x1;
+					v[2].y = y1;
+					v[2].u = s1;
+					v[2].v = t1;
 
-					bs->font_vertices[glyph_count*4 + 3].x = x0;
-					bs->font_vertices[glyph_count*4 + 3].y = y1;
-					bs->font_vertices[glyph_count*4 + 3].u = s0;
-					bs->font_vertices[glyph_count*4 + 3].v = t1;
+					v[3].x = x0;
+					v[3].y = y1;
+					v[3].u = s0;
+					v[3].v = t1;
+
+					v[0].col = v[1].col = v[2].col = v[3].col = col;
 
 					glyph_count++;
 
+				advance:
 					if (i < char_count-1) {
-						isize next_index;
-						char32 next_cp = 0;
+						isize next_index = 0;
+						Rune next_cp = 0;
 						gbglGlyphInfo *ngi;
 
-						gb_utf8_decode_len(ptr, len-(ptr-str), &next_cp);
-						ngi = gbgl_get_glyph_info(font, next_cp, &next_index);
+						gb_utf8_decode(cast(u8 const *)ptr, len-(ptr-str), &next_cp);
+						ngi = gbgl_get_glyph_metrics(font, next_cp, &next_index);
 						if (ngi) {
 							kern = gbgl_get_font_kerning_from_glyph_indices(font, curr_index, next_index);
 						}
@@ -2533,32 +3173,6 @@ isize gbgl_bs_draw_substring(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, g
 				}
 			}
 		}
-
-
-		if (glyph_count > 0) {
-			isize sampler_index = 0;
-
-			gbgl_use_shader(&bs->font_shader);
-			gbgl_set_uniform_mat4(&bs->font_shader, "u_ortho_mat", bs->ortho_mat);
-			gbgl_set_uniform_colour(&bs->font_shader, "u_colour", col);
-			GB_ASSERT(bs->text_params[gbglTextParam_TextureFilter].val_i32 < gb_count_of(bs->font_samplers));
-			if (bs->text_params[gbglTextParam_TextureFilter].val_i32 < gb_count_of(bs->font_samplers))
-				sampler_index = bs->text_params[gbglTextParam_TextureFilter].val_i32;
-
-			gbgl_bind_texture2d(&font->texture, 0, bs->font_samplers[sampler_index]);
-			gbgl_vbo_copy(bs->font_vbo, bs->font_vertices, gb_size_of(bs->font_vertices[0]) * glyph_count * 4, 0);
-
-			gbgl_vert_ptr_aa(0, 2, gbglBasicVertex, x);
-			gbgl_vert_ptr_aa(1, 2, gbglBasicVertex, u);
-
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bs->font_ebo);
-
-			glEnable(GL_BLEND);
-			glBlendEquation(GL_FUNC_ADD);
-			glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-			glDrawElements(GL_TRIANGLES, glyph_count*6, GL_UNSIGNED_SHORT, NULL);
-
-		}
 	}
 	return line_count;
 }
@@ -2575,7 +3189,7 @@ isize gbgl_bs_draw_string(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, gbgl
 gb_inline isize gbgl_bs_draw_string_va(gbglBasicState *bs, gbglFont *font, f32 x, f32 y, gbglColour col, char const *fmt, va_list va) {
 	isize len = gb_snprintf_va(bs->font_text_buffer, gb_size_of(bs->font_text_buffer),
 	                           fmt, va);
-	isize char_count = gb_utf8_strnlen(bs->font_text_buffer, len);
+	isize char_count = gb_utf8_strnlen(cast(u8 const *)bs->font_text_buffer, len);
 	if (char_count <= 0)
 		return 0;
 	return gbgl_bs_draw_substring(bs, font, x, y, col, bs->font_text_buffer, len);
@@ -1,7 +1,8 @@
-/* gb_ini.h - v0.93 - public domain ini file loader library - no warranty implied; use at your own risk
+/* gb_ini.h - v0.94 - public domain ini file loader library - no warranty implied; use at your own risk
 	A Simple Ini File Loader Library for C and C++
 
 		Version History:
+			0.94  - Zero-copy gb_ini_parse_memory, hashed gbIni lookup table & no line length limit
 			0.93  - C90 support
 			0.92  - ??
 			0.91  - New styling
@@ -34,6 +35,8 @@
 			i.e it should look like this:
 			#define GB_INI_CPP
 			#include "gb_ini.h"
+
+		You can #define GB_INI_ALLOC, and GB_INI_FREE to avoid using malloc,free.
 */
 
 /* Examples: */
@@ -156,7 +159,7 @@ int main(int argc, char** argv)
 
 	using namespace gb;
 
-	Ini_Error err = ini_parse("test.ini", &test_ini_handler, &lib);
+	IniError err = ini_parse("test.ini", &test_ini_handler, &lib);
 	if (err.type != INI_ERROR_NONE) {
 		if (err.line_num > 0)
 			printf("Line (%d): ", err.line_num);
@@ -174,21 +177,38 @@ int main(int argc, char** argv)
 }
 #endif
 
-#ifndef GB_INI_INCLUDE_GB_INI_H
-#define GB_INI_INCLUDE_GB_INI_H
+/* In memory example */
+#if 0
+#define GB_INI_IMPLEMENTATION
+#include "gb_ini.h"
 
-#ifndef GB_INI_MAX_LINE_LENGTH
-#define GB_INI_MAX_LINE_LENGTH 1024
-#endif
+#include <stdio.h>
 
-#ifndef GB_INI_MAX_SECTION_LENGTH
-#define GB_INI_MAX_SECTION_LENGTH 256
-#endif
+int main(int argc, char **argv)
+{
+	/* NOTE(bill): The text could be a mapped file, it must outlive `ini` as nothing is copied */
+	char const *text = "name=gb_ini.h\n[author]\nname = Ginger Bill\n";
+	gbIniSlice const *author;
+	gbIni ini;
 
-#ifndef GB_INI_MAX_NAME_LENGTH
-#define GB_INI_MAX_NAME_LENGTH 256
+	gbIniError err = gb_ini_load_memory(&ini, text, strlen(text));
+	if (err.type != GB_INI_ERROR_NONE) {
+		printf("Line (%d): %s\n", (int)err.line_num, gb_ini_error_string(err));
+		return 1;
+	}
+
+	author = gb_ini_find(&ini, "author", "name");
+	if (author)
+		printf("Author  : %.*s\n", (int)author->len, author->text); // Author  : Ginger Bill
+
+	gb_ini_free(&ini);
+	return 0;
+}
 #endif
 
+#ifndef GB_INI_INCLUDE_GB_INI_H
+#define GB_INI_INCLUDE_GB_INI_H
+
 #ifndef GB_INI_CHECK_FOR_UTF8_BOM
 #define GB_INI_CHECK_FOR_UTF8_BOM 1
 #endif
@@ -217,6 +237,7 @@ enum {
 	GB_INI_ERROR_MISSING_SECTION_BRACKET,
 	GB_INI_ERROR_ASSIGNMENT_MISSING,
 	GB_INI_ERROR_HANDLER_ERROR,
+	GB_INI_ERROR_OUT_OF_MEMORY,
 
 	GB_INI_ERROR_COUNT
 };
@@ -237,11 +258,47 @@ typedef int gbIniHRT;
 #define GB_INI_HANDLER(func_name) gbIniHRT func_name(void *data, char const *section, char const *name, char const *value)
 typedef GB_INI_HANDLER(gbIniHandler);
 
+/* A pointer into the parsed text and its length, it is _not_ NUL terminated */
+typedef struct gbIniSlice {
+	char const *text;
+	size_t      len;
+} gbIniSlice;
+
+#define GB_INI_SLICE_HANDLER(func_name) gbIniHRT func_name(void *data, gbIniSlice section, gbIniSlice name, gbIniSlice value)
+typedef GB_INI_SLICE_HANDLER(gbIniSliceHandler);
+
+typedef struct gbIniEntry {
+	gbIniSlice section, name, value;
+} gbIniEntry;
+
+/* Every name=value pair in order and a hash table of them by section & name */
+typedef struct gbIni {
+	gbIniEntry       *entries;
+	size_t            count;
+
+	struct gbIniSlot *slots;
+	size_t            slot_count; /* Power of two */
+} gbIni;
+
 extern char const *GB_ERROR_STRINGS[GB_INI_ERROR_COUNT];
 
 gbIniError gb_ini_parse(char const *filename, gbIniHandler* handler_func, void *data);
 gbIniError gb_ini_parse_file(FILE *file, gbIniHandler* handler_func, void *data);
 
+/* Nothing is copied or allocated, the slices point into `text` which does not need a NUL
+ * The global section is an empty slice
+ */
+gbIniError gb_ini_parse_memory(void const *text, size_t len, gbIniSliceHandler *handler_func, void *data);
+
+/* `text` must outlive `ini`, later duplicates of a name in a section are the ones found */
+gbIniError        gb_ini_load_memory(gbIni *ini, void const *text, size_t len);
+void              gb_ini_free       (gbIni *ini);
+gbIniSlice const *gb_ini_find       (gbIni const *ini, char const *section, char const *name); /* NULL if not found */
+gbIniSlice const *gb_ini_find_slice (gbIni const *ini, gbIniSlice section, gbIniSlice name);
+
+gbIniSlice gb_ini_slice       (char const *str);
+int        gb_ini_slice_equals(gbIniSlice a, gbIniSlice b);
+
 gbini_inline char const *gb_ini_error_string(gbIniError const err) { return GB_ERROR_STRINGS[err.type]; }
 
 #ifdef __cplusplus
@@ -255,8 +312,11 @@ gbini_inline char const *gb_ini_error_string(gbIniError const err) { return GB_E
 
 namespace gb
 {
-typedef gbIniError   IniError;
-typedef gbIniHandler IniHandler;
+typedef gbIniError        IniError;
+typedef gbIniHandler      IniHandler;
+typedef gbIniSlice        IniSlice;
+typedef gbIniSliceHandler IniSliceHandler;
+typedef gbIni             Ini;
 
 /* Just a copy but with the GB_ prefix stripped */
 enum {
@@ -265,14 +325,20 @@ enum {
 	INI_ERROR_FILE_ERROR,
 	INI_ERROR_MISSING_SECTION_BRACKET,
 	INI_ERROR_ASSIGNMENT_MISSING,
-	INI_ERROR_HANDLER_ERROR
+	INI_ERROR_HANDLER_ERROR,
+	INI_ERROR_OUT_OF_MEMORY
 
 	/* No need for enum count */
 };
 
-inline Ini_Error ini_parse(char const *filename, Ini_Handler *handler_func, void *data) { return gb_ini_parse(filename, handler_func, data); }
-inline Ini_Error ini_parse(FILE *file, Ini_Handler *handler_func, void *data) { return gb_ini_parse_file(file, handler_func, data); }
-inline char const *ini_error_string(const Ini_Error err) { return GB_ERROR_STRINGS[err.type]; }
+inline IniError ini_parse(char const *filename, IniHandler *handler_func, void *data) { return gb_ini_parse(filename, handler_func, data); }
+inline IniError ini_parse(FILE *file, IniHandler *handler_func, void *data) { return gb_ini_parse_file(file, handler_func, data); }
+inline IniError ini_parse(void const *text, size_t len, IniSliceHandler *handler_func, void *data) { return gb_ini_parse_memory(text, len, handler_func, data); }
+inline char const *ini_error_string(const IniError err) { return GB_ERROR_STRINGS[err.type]; }
+
+inline IniError        ini_load(Ini *ini, void const *text, size_t len) { return gb_ini_load_memory(ini, text, len); }
+inline void            ini_free(Ini *ini) { gb_ini_free(ini); }
+inline IniSlice const *ini_find(Ini const *ini, char const *section, char const *name) { return gb_ini_find(ini, section, name); }
 
 } /* namespace gb */
 #endif /* GB_INI_CPP */
@@ -282,6 +348,18 @@ inline char const *ini_error_string(const Ini_Error err) { return GB_ERROR_STRIN
 #include <ctype.h>
 #include <string.h>
 
+#if !defined(GB_INI_ALLOC) || !defined(GB_INI_FREE)
+#include <stdlib.h>
+#endif
+
+#ifndef GB_INI_ALLOC
+#define GB_INI_ALLOC(sz) malloc(sz)
+#endif
+
+#ifndef GB_INI_FREE
+#define GB_INI_FREE(ptr) free(ptr)
+#endif
+
 char const *GB_ERROR_STRINGS[GB_INI_ERROR_COUNT] = {
 	"",
 
@@ -289,120 +367,103 @@ char const *GB_ERROR_STRINGS[GB_INI_ERROR_COUNT] = {
 	"Missing closing section bracket ']'",
 	"Missing assignment operator '='",
 	"Error in handler function",
+	"Out of memory",
 };
 
-static gbini_inline char*
-gb__left_whitespace_skip(char const *str)
+static gbini_inline char const *
+gb__left_whitespace_skip(char const *str, char const *end)
 {
-	while (*str && isspace((unsigned char)(*str)))
+	while (str < end && isspace((unsigned char)(*str)))
 		str++;
-	return (char*)str;
+	return str;
 }
 
-static gbini_inline char*
-gb__right_whitespace_strip(char* str)
+static gbini_inline char const *
+gb__right_whitespace_strip(char const *str, char const *end)
 {
-	char* end = str + strlen(str);
-	while (end > str && isspace((unsigned char)(*--end)))
-		*end = '\0';
-	return str;
+	while (end > str && isspace((unsigned char)end[-1]))
+		end--;
+	return end;
 }
 
-static gbini_inline char*
-gb__find_char_or_comment_in_string(char const *str, char c)
+/* NOTE(bill): A ';' only starts a comment after whitespace, returns `end` if neither is found */
+static gbini_inline char const *
+gb__find_char_or_comment_in_string(char const *str, char const *end, char c)
 {
 	int was_whitespace = 0;
-	while (*str && *str != c && !(was_whitespace && *str == ';')) {
+	while (str < end && *str != c && !(was_whitespace && *str == ';')) {
 		was_whitespace = isspace((unsigned char)(*str));
 		str++;
 	}
 
-	return (char*)str;
+	return str;
 }
 
-static gbini_inline char*
-gb__string_copy(char* dst, char const *src, size_t size)
+static gbini_inline gbIniSlice
+gb__ini_slice(char const *start, char const *end)
 {
-	strncpy(dst, src, size);
-	dst[size - 1] = '\0';
-	return dst;
+	gbIniSlice s;
+	s.text = start;
+	s.len  = (size_t)(end - start);
+	return s;
 }
 
 
 gbIniError
-gb_ini_parse(char const *filename, gbIniHandler *handler_func, void *data)
-{
-	gbIniError err = {GB_INI_ERROR_FILE_ERROR, 0};
-
-	FILE *file = fopen(filename, "r");
-	if (!file)
-		return err;
-
-	err = gb_ini_parse_file(file, handler_func, data);
-	fclose(file);
-	return err;
-}
-
-gbIniError
-gb_ini_parse_file(FILE *file, gbIniHandler *handler_func, void *data)
+gb_ini_parse_memory(void const *text, size_t len, gbIniSliceHandler *handler_func, void *data)
 {
-	char line[GB_INI_MAX_LINE_LENGTH] = "";
+	char const *str = (char const *)text;
+	char const *str_end = str + len;
 	size_t line_num = 0;
 
-	char section[GB_INI_MAX_SECTION_LENGTH] = "";
-	char prev_name[GB_INI_MAX_NAME_LENGTH]  = "";
+	gbIniSlice section = {"", 0};
 
-	char *start;
-	char *end;
+	char const *start;
+	char const *end;
 
 	struct gbIniError err = {GB_INI_ERROR_NONE, 0};
 
-	while (fgets(line, GB_INI_MAX_LINE_LENGTH, file) != 0) {
-		line_num++;
-
-		start = line;
-
 #if GB_INI_CHECK_FOR_UTF8_BOM
-		/* Check for UTF-8 Byte Order Mark */
-		if (line_num == 1 &&
-		    (unsigned char)start[0] == 0xef &&
-		    (unsigned char)start[1] == 0xbb &&
-		    (unsigned char)start[2] == 0xbf) {
-			start += 3;
-		}
+	/* Check for UTF-8 Byte Order Mark */
+	if (len >= 3 &&
+	    (unsigned char)str[0] == 0xef &&
+	    (unsigned char)str[1] == 0xbb &&
+	    (unsigned char)str[2] == 0xbf) {
+		str += 3;
+	}
 #endif
 
-		start = gb__left_whitespace_skip(gb__right_whitespace_strip(start));
+	while (str < str_end) {
+		char const *line_end = (char const *)memchr(str, '\n', (size_t)(str_end - str));
+		if (!line_end)
+			line_end = str_end;
+		line_num++;
+
+		start = gb__left_whitespace_skip(str, line_end);
+		end   = gb__right_whitespace_strip(start, line_end);
+		str   = line_end < str_end ? line_end + 1 : str_end;
 
-		if (start[0] == ';' || start[0] == '#')
+		if (start == end || start[0] == ';' || start[0] == '#')
 			continue; /* Allow '#' and ';' comments at start of line */
 
 		if (start[0] == '[') { /* [section] */
-			end = gb__find_char_or_comment_in_string(start+1, ']');
-			if (*end == ']') {
-				char *sect = start + 1;
-				*end = '\0';
-				sect = gb__left_whitespace_skip(gb__right_whitespace_strip(sect));
-
-				gb__string_copy(section, sect, sizeof(section));
-				*prev_name = '\0';
+			char const *close = gb__find_char_or_comment_in_string(start+1, end, ']');
+			if (close < end && *close == ']') {
+				char const *sect = gb__left_whitespace_skip(start+1, close);
+				section = gb__ini_slice(sect, gb__right_whitespace_strip(sect, close));
 			} else if (!err.type) {
 				err.type = GB_INI_ERROR_MISSING_SECTION_BRACKET;
 				err.line_num = line_num;
 			}
-		} else if (start[0] && start[0] != ';') {
-			end = gb__find_char_or_comment_in_string(start, '=');
-			if (*end == '=') {
-				char *name, *value;
-				*end = '\0';
-				name = gb__right_whitespace_strip(start);
-				value = gb__left_whitespace_skip(end + 1);
-				end = gb__find_char_or_comment_in_string(value, '\0');
-				if (*end == ';')
-					*end = '\0';
-				gb__right_whitespace_strip(value);
-
-				gb__string_copy(prev_name, name, sizeof(prev_name));
+		} else {
+			char const *assign = gb__find_char_or_comment_in_string(start, end, '=');
+			if (assign < end && *assign == '=') {
+				gbIniSlice name, value;
+				char const *value_start = gb__left_whitespace_skip(assign + 1, end);
+				char const *value_end   = gb__find_char_or_comment_in_string(value_start, end, '\0');
+				name  = gb__ini_slice(start, gb__right_whitespace_strip(start, assign));
+				value = gb__ini_slice(value_start, gb__right_whitespace_strip(value_start, value_end));
+
 				if (!handler_func(data, section, name, value) && !err.type) {
 					err.type = GB_INI_ERROR_HANDLER_ERROR;
 					err.line_num = line_num;
@@ -411,7 +472,6 @@ gb_ini_parse_file(FILE *file, gbIniHandler *handler_func, void *data)
 				/* No '=' found on name=value line */
 				err.type = GB_INI_ERROR_ASSIGNMENT_MISSING;
 				err.line_num = line_num;
-				continue;
 			}
 		}
 
@@ -422,4 +482,217 @@ gb_ini_parse_file(FILE *file, gbIniHandler *handler_func, void *data)
 	return err;
 }
 
+
+typedef struct gb__IniCStringHandler {
+	gbIniHandler *handler_func;
+	void         *data;
+} gb__IniCStringHandler;
+
+/* NOTE(bill): The text is a copy which has been read to the end of the line so the character
+ * after each slice can be overwritten to make them NUL terminated
+ */
+static GB_INI_SLICE_HANDLER(gb__ini_cstring_handler)
+{
+	gb__IniCStringHandler *h = (gb__IniCStringHandler *)data;
+	if (section.len > 0)
+		((char *)section.text)[section.len] = '\0';
+	((char *)name.text)[name.len]   = '\0';
+	((char *)value.text)[value.len] = '\0';
+	return h->handler_func(h->data, section.len > 0 ? section.text : "", name.text, value.text);
+}
+
+gbIniError
+gb_ini_parse(char const *filename, gbIniHandler *handler_func, void *data)
+{
+	gbIniError err = {GB_INI_ERROR_FILE_ERROR, 0};
+
+	FILE *file = fopen(filename, "r");
+	if (!file)
+		return err;
+
+	err = gb_ini_parse_file(file, handler_func, data);
+	fclose(file);
+	return err;
+}
+
+gbIniError
+gb_ini_parse_file(FILE *file, gbIniHandler *handler_func, void *data)
+{
+	gbIniError err = {GB_INI_ERROR_NONE, 0};
+	gb__IniCStringHandler h;
+	size_t len = 0, cap = 4096;
+	char *text = (char *)GB_INI_ALLOC(cap);
+
+	/* NOTE(bill): Read it all so lines can be of any length, with a byte spare for a '\0' */
+	for (;;) {
+		size_t read;
+		if (!text) {
+			err.type = GB_INI_ERROR_OUT_OF_MEMORY;
+			return err;
+		}
+		read = fread(text + len, 1, cap-1 - len, file);
+		len += read;
+		if (len < cap-1)
+			break;
+		{
+			char *new_text = (char *)GB_INI_ALLOC(cap*2);
+			if (new_text)
+				memcpy(new_text, text, len);
+			GB_INI_FREE(text);
+			text = new_text;
+			cap *= 2;
+		}
+	}
+	if (ferror(file)) {
+		GB_INI_FREE(text);
+		err.type = GB_INI_ERROR_FILE_ERROR;
+		return err;
+	}
+	text[len] = '\0';
+
+	h.handler_func = handler_func;
+	h.data = data;
+	err = gb_ini_parse_memory(text, len, &gb__ini_cstring_handler, &h);
+	GB_INI_FREE(text);
+	return err;
+}
+
+
+struct gbIniSlot {
+	unsigned int entry_index_plus_one; /* 0 is empty */
+	unsigned int hash;
+};
+
+gbIniSlice
+gb_ini_slice(char const *str)
+{
+	return gb__ini_slice(str, str + strlen(str));
+}
+
+int
+gb_ini_slice_equals(gbIniSlice a, gbIniSlice b)
+{
+	return a.len == b.len && (a.len == 0 || memcmp(a.text, b.text, a.len) == 0);
+}
+
+/* NOTE(bill): FNV-1a of the section, a separator then the name */
+static unsigned int
+gb__ini_hash(gbIniSlice section, gbIniSlice name)
+{
+	unsigned int h = 2166136261u;
+	size_t i;
+	for (i = 0; i < section.len; i++)
+		h = (h ^ (unsigned char)section.text[i]) * 16777619u;
+	h = (h ^ 0xffu) * 16777619u;
+	for (i = 0; i < name.len; i++)
+		h = (h ^ (unsigned char)name.text[i]) * 16777619u;
+	return h;
+}
+
+static struct gbIniSlot *
+gb__ini_find_slot(gbIni const *ini, gbIniSlice section, gbIniSlice name, unsigned int hash)
+{
+	size_t mask = ini->slot_count - 1;
+	size_t i = hash & mask;
+	for (;;) {
+		struct gbIniSlot *slot = &ini->slots[i];
+		if (slot->entry_index_plus_one == 0)
+			return slot;
+		if (slot->hash == hash) {
+			gbIniEntry const *e = &ini->entries[slot->entry_index_plus_one - 1];
+			if (gb_ini_slice_equals(e->section, section) && gb_ini_slice_equals(e->name, name))
+				return slot;
+		}
+		i = (i + 1) & mask;
+	}
+}
+
+static GB_INI_SLICE_HANDLER(gb__ini_load_handler)
+{
+	gbIni *ini = (gbIni *)data;
+	gbIniEntry *e;
+	/* NOTE(bill): The capacity is 16 then doubles so it is full when the count is a power of two */
+	if (ini->count == 0 || (ini->count >= 16 && (ini->count & (ini->count - 1)) == 0)) {
+		size_t cap = ini->count ? ini->count*2 : 16;
+		gbIniEntry *entries = (gbIniEntry *)GB_INI_ALLOC(cap * sizeof(gbIniEntry));
+		if (!entries)
+			return 0;
+		if (ini->entries) {
+			memcpy(entries, ini->entries, ini->count * sizeof(gbIniEntry));
+			GB_INI_FREE(ini->entries);
+		}
+		ini->entries = entries;
+	}
+	e = &ini->entries[ini->count++];
+	e->section = section;
+	e->name    = name;
+	e->value   = value;
+	return 1;
+}
+
+gbIniError
+gb_ini_load_memory(gbIni *ini, void const *text, size_t len)
+{
+	gbIniError err;
+	size_t i;
+
+	memset(ini, 0, sizeof(*ini));
+	err = gb_ini_parse_memory(text, len, &gb__ini_load_handler, ini);
+	if (err.type == GB_INI_ERROR_HANDLER_ERROR)
+		err.type = GB_INI_ERROR_OUT_OF_MEMORY;
+	if (err.type != GB_INI_ERROR_NONE) {
+		gb_ini_free(ini);
+		return err;
+	}
+
+	if (ini->count > 0) {
+		ini->slot_count = 16;
+		while (ini->slot_count < ini->count*2)
+			ini->slot_count *= 2;
+		ini->slots = (struct gbIniSlot *)GB_INI_ALLOC(ini->slot_count * sizeof(struct gbIniSlot));
+		if (!ini->slots) {
+			gb_ini_free(ini);
+			err.type = GB_INI_ERROR_OUT_OF_MEMORY;
+			return err;
+		}
+		memset(ini->slots, 0, ini->slot_count * sizeof(struct gbIniSlot));
+
+		for (i = 0; i < ini->count; i++) {
+			gbIniEntry const *e = &ini->entries[i];
+			unsigned int hash = gb__ini_hash(e->section, e->name);
+			struct gbIniSlot *slot = gb__ini_find_slot(ini, e->section, e->name, hash);
+			slot->entry_index_plus_one = (unsigned int)(i+1);
+			slot->hash = hash;
+		}
+	}
+
+	return err;
+}
+
+void
+gb_ini_free(gbIni *ini)
+{
+	if (ini->entries) GB_INI_FREE(ini->entries);
+	if (ini->slots)   GB_INI_FREE(ini->slots);
+	memset(ini, 0, sizeof(*ini));
+}
+
+gbIniSlice const *
+gb_ini_find_slice(gbIni const *ini, gbIniSlice section, gbIniSlice name)
+{
+	struct gbIniSlot const *slot;
+	if (ini->count == 0)
+		return NULL;
+	slot = gb__ini_find_slot(ini, section, name, gb__ini_hash(section, name));
+	if (slot->entry_index_plus_one == 0)
+		return NULL;
+	return &ini->entries[slot->entry_index_plus_one - 1].value;
+}
+
+gbIniSlice const *
+gb_ini_find(gbIni const *ini, char const *section, char const *name)
+{
+	return gb_ini_find_slice(ini, gb_ini_slice(section ? section : ""), gb_ini_slice(name));
+}
+
 #endif /* GB_INI_IMPLEMENTATION */
@@ -1,8 +1,10 @@
-/* gb_math.h - v0.07c - public domain C math library - no warranty implied; use at your own risk
+/* gb_math.h - v0.09  - public domain C math library - no warranty implied; use at your own risk
    A C math library geared towards game development
    use '#define GB_MATH_IMPLEMENTATION' before including to create the implementation in _ONE_ file
 
 Version History:
+	0.09  - Planes, spheres, frustums & batched frustum culling
+	0.08  - Batched AoS/SoA procedures with SSE/AVX/NEON, SIMD Mat4 mul & inverse, fix slerp & inverse
 	0.07c - Add gb_random01
 	0.07b - Fix mat4_inverse
 	0.07a - Fix Mat2
@@ -43,11 +45,24 @@ CONTENTS
 		- gbRect(2,3)
 		- gbAabb(2,3)
 		- gbHalf (16-bit floating point) (storage only)
+		- gbVec(3,4)SoA & gbQuatSoA
+		- gbPlane
+		- gbSphere
+		- gbFrustum
 	- Operations
 	- Functions
 	- Type Functions
+	- Batches
+	- Culling
 	- Random
 	- Hash
+
+SIMD
+	The batch procedures work on 8 values at a time with AVX, 4 with SSE or NEON
+	(AArch64 only) and one at a time otherwise, whichever the compiler targets.
+	So do the frustum culling procedures.
+	gb_mat4_mul & gb_mat4_inverse use SSE or NEON too.
+	#define GB_MATH_NO_SIMD to use none of them.
 */
 
 #ifndef GB_MATH_INCLUDE_GB_MATH_H
@@ -124,6 +139,13 @@ typedef union gbQuat {
 	float e[4];
 } gbQuat;
 
+/* NOTE(bill): A point p is in front of (inside) a plane when dot(normal, p) + d >= 0 */
+typedef union gbPlane {
+	struct { gbVec3 normal; float d; };
+	gbVec4 xyzw;
+	float e[4];
+} gbPlane;
+
 
 #if defined(_MSC_VER)
 #pragma warning(pop)
@@ -140,6 +162,16 @@ typedef struct gbRect3 { gbVec3 pos, dim; } gbRect3;
 typedef struct gbAabb2 { gbVec2 centre, half_size; } gbAabb2;
 typedef struct gbAabb3 { gbVec3 centre, half_size; } gbAabb3;
 
+/* NOTE(bill): Structure of arrays for the batch procedures, each is an array of `count` floats */
+typedef struct gbVec3SoA { float *x, *y, *z; }     gbVec3SoA;
+typedef struct gbVec4SoA { float *x, *y, *z, *w; } gbVec4SoA;
+typedef gbVec4SoA gbQuatSoA;
+
+typedef struct gbSphere  { gbVec3 centre; float radius; } gbSphere;
+
+/* NOTE(bill): Left, right, bottom, top, near & far with the normals pointing inwards */
+typedef struct gbFrustum { gbPlane planes[6]; } gbFrustum;
+
 #if defined(_MSC_VER)
 	typedef unsigned __int32 gb_math_u32;
 	typedef unsigned __int64 gb_math_u64;
@@ -490,6 +522,61 @@ GB_MATH_DEF int gb_rect2_intersects         (gbRect2 a, gbRect2 b);
 GB_MATH_DEF int gb_rect2_intersection_result(gbRect2 a, gbRect2 b, gbRect2 *intersection);
 
 
+/* Batches */
+/* NOTE(bill): Each does the same as its single value version over `count` values. `out` may be
+ * the same array as an input but must not overlap it otherwise. Points are transformed
+ * with w = 1 and no divide. The batched slerp is a polynomial fit (error ~1e-7) not sin/arccos.
+ */
+GB_MATH_DEF void gb_mat4_mul_vec4_array   (gbVec4 *out, gbMat4 *m, gbVec4 const *in, size_t count);
+GB_MATH_DEF void gb_mat4_mul_point3_array (gbVec3 *out, gbMat4 *m, gbVec3 const *in, size_t count);
+GB_MATH_DEF void gb_vec3_norm_array       (gbVec3 *out, gbVec3 const *in, size_t count);
+GB_MATH_DEF void gb_vec3_lerp_array       (gbVec3 *out, gbVec3 const *a, gbVec3 const *b, float t, size_t count);
+GB_MATH_DEF void gb_quat_mul_array        (gbQuat *out, gbQuat const *a, gbQuat const *b, size_t count);
+GB_MATH_DEF void gb_quat_norm_array       (gbQuat *out, gbQuat const *in, size_t count);
+GB_MATH_DEF void gb_quat_nlerp_array      (gbQuat *out, gbQuat const *a, gbQuat const *b, float t, size_t count);
+GB_MATH_DEF void gb_quat_slerp_array      (gbQuat *out, gbQuat const *a, gbQuat const *b, float t, size_t count);
+GB_MATH_DEF void gb_quat_rotate_vec3_array(gbVec3 *out, gbQuat const *q, gbVec3 const *v, size_t count);
+
+GB_MATH_DEF void gb_mat4_mul_vec4_soa   (gbVec4SoA out, gbMat4 *m, gbVec4SoA in, size_t count);
+GB_MATH_DEF void gb_mat4_mul_point3_soa (gbVec3SoA out, gbMat4 *m, gbVec3SoA in, size_t count);
+GB_MATH_DEF void gb_vec3_norm_soa       (gbVec3SoA out, gbVec3SoA in, size_t count);
+GB_MATH_DEF void gb_vec3_lerp_soa       (gbVec3SoA out, gbVec3SoA a, gbVec3SoA b, float t, size_t count);
+GB_MATH_DEF void gb_quat_mul_soa        (gbQuatSoA out, gbQuatSoA a, gbQuatSoA b, size_t count);
+GB_MATH_DEF void gb_quat_norm_soa       (gbQuatSoA out, gbQuatSoA in, size_t count);
+GB_MATH_DEF void gb_quat_nlerp_soa      (gbQuatSoA out, gbQuatSoA a, gbQuatSoA b, float t, size_t count);
+GB_MATH_DEF void gb_quat_slerp_soa      (gbQuatSoA out, gbQuatSoA a, gbQuatSoA b, float t, size_t count);
+GB_MATH_DEF void gb_quat_rotate_vec3_soa(gbVec3SoA out, gbQuatSoA q, gbVec3SoA v, size_t count);
+
+/* Culling */
+GB_MATH_DEF gbPlane gb_plane(gbVec3 normal, float d);
+GB_MATH_DEF gbPlane gb_plane_from_point(gbVec3 normal, gbVec3 point);
+GB_MATH_DEF void    gb_plane_norm      (gbPlane *out, gbPlane p);
+GB_MATH_DEF float   gb_plane_distance  (gbPlane p, gbVec3 point);
+
+GB_MATH_DEF gbAabb3 gb_aabb3_from_min_max   (gbVec3 min, gbVec3 max);
+GB_MATH_DEF int     gb_aabb3_contains_vec3  (gbAabb3 a, gbVec3 p);
+GB_MATH_DEF int     gb_aabb3_intersects     (gbAabb3 a, gbAabb3 b);
+GB_MATH_DEF void    gb_aabb3_transform      (gbAabb3 *out, gbMat4 *m, gbAabb3 a);
+GB_MATH_DEF int     gb_sphere_intersects    (gbSphere a, gbSphere b);
+
+/* NOTE(bill): Extracts the planes of the clip space cube, -w <= x,y,z <= w, of a projection (or view-projection) */
+GB_MATH_DEF void gb_frustum_from_mat4         (gbFrustum *out, gbMat4 *view_projection);
+GB_MATH_DEF int  gb_frustum_contains_vec3     (gbFrustum const *f, gbVec3 p);
+GB_MATH_DEF int  gb_frustum_intersects_sphere (gbFrustum const *f, gbSphere s);
+GB_MATH_DEF int  gb_frustum_intersects_aabb3  (gbFrustum const *f, gbAabb3 a);
+
+/* NOTE(bill): Returns the number of the `count` boxes (or spheres) which are (at least partly)
+ * inside the frustum. `visible_bits` (if not NULL) has (count+31)/32 words with bit i%32 of
+ * word i/32 set if i is visible. `visible_indices` (if not NULL) has room for `count`, the
+ * visible indices are written in order. Like gb_frustum_intersects_*, it is conservative
+ * and may keep a box which is just outside near a corner of the frustum.
+ */
+GB_MATH_DEF size_t gb_frustum_cull_aabbs      (gbFrustum const *f, gbAabb3 const *boxes, size_t count, gb_math_u32 *visible_bits, gb_math_u32 *visible_indices);
+GB_MATH_DEF size_t gb_frustum_cull_spheres    (gbFrustum const *f, gbSphere const *spheres, size_t count, gb_math_u32 *visible_bits, gb_math_u32 *visible_indices);
+GB_MATH_DEF size_t gb_frustum_cull_aabbs_soa  (gbFrustum const *f, gbVec3SoA centres, gbVec3SoA half_sizes, size_t count, gb_math_u32 *visible_bits, gb_math_u32 *visible_indices);
+GB_MATH_DEF size_t gb_frustum_cull_spheres_soa(gbFrustum const *f, gbVec3SoA centres, float const *radii, size_t count, gb_math_u32 *visible_bits, gb_math_u32 *visible_indices);
+
+
 #ifndef	GB_MURMUR64_DEFAULT_SEED
 #define GB_MURMUR64_DEFAULT_SEED 0x9747b28c
 #endif
@@ -777,6 +864,92 @@ inline gbVec3 operator*(gbQuat q, gbVec3 v) { gbVec3 r; gb_quat_rotate_vec3(&r,
  #endif
 
 
+#if !defined(GB_MATH_NO_SIMD)
+	#if defined(__AVX__)
+		#include <immintrin.h>
+		#define GB_MATH_AVX
+	#endif
+	#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+		#include <xmmintrin.h>
+		#define GB_MATH_SSE
+	#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+		#include <arm_neon.h>
+		#define GB_MATH_NEON
+	#endif
+#endif
+
+/* NOTE(bill): As many floats as the widest registers hold, for the batch procedures */
+#if defined(GB_MATH_AVX)
+	typedef __m256 gb__Lanes;
+	typedef __m256 gb__LaneMask;
+	#define GB__LANE_COUNT 8
+	#define gb__lanes_load(p)         _mm256_loadu_ps(p)
+	#define gb__lanes_store(p, a)     _mm256_storeu_ps(p, a)
+	#define gb__lanes_set1(s)         _mm256_set1_ps(s)
+	#define gb__lanes_add(a, b)       _mm256_add_ps(a, b)
+	#define gb__lanes_sub(a, b)       _mm256_sub_ps(a, b)
+	#define gb__lanes_mul(a, b)       _mm256_mul_ps(a, b)
+	#define gb__lanes_div(a, b)       _mm256_div_ps(a, b)
+	#define gb__lanes_sqrt(a)         _mm256_sqrt_ps(a)
+	#define gb__lanes_less(a, b)      _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+	#define gb__lanes_select(m, a, b) _mm256_blendv_ps(b, a, m)
+	#define gb__lanes_or(a, b)        _mm256_or_ps(a, b)
+	#define gb__lanes_bits(m)         _mm256_movemask_ps(m)
+#elif defined(GB_MATH_SSE)
+	typedef __m128 gb__Lanes;
+	typedef __m128 gb__LaneMask;
+	#define GB__LANE_COUNT 4
+	#define gb__lanes_load(p)         _mm_loadu_ps(p)
+	#define gb__lanes_store(p, a)     _mm_storeu_ps(p, a)
+	#define gb__lanes_set1(s)         _mm_set1_ps(s)
+	#define gb__lanes_add(a, b)       _mm_add_ps(a, b)
+	#define gb__lanes_sub(a, b)       _mm_sub_ps(a, b)
+	#define gb__lanes_mul(a, b)       _mm_mul_ps(a, b)
+	#define gb__lanes_div(a, b)       _mm_div_ps(a, b)
+	#define gb__lanes_sqrt(a)         _mm_sqrt_ps(a)
+	#define gb__lanes_less(a, b)      _mm_cmplt_ps(a, b)
+	#define gb__lanes_select(m, a, b) _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+	#define gb__lanes_or(a, b)        _mm_or_ps(a, b)
+	#define gb__lanes_bits(m)         _mm_movemask_ps(m)
+#elif defined(GB_MATH_NEON)
+	typedef float32x4_t gb__Lanes;
+	typedef uint32x4_t  gb__LaneMask;
+	#define GB__LANE_COUNT 4
+	#define gb__lanes_load(p)         vld1q_f32(p)
+	#define gb__lanes_store(p, a)     vst1q_f32(p, a)
+	#define gb__lanes_set1(s)         vdupq_n_f32(s)
+	#define gb__lanes_add(a, b)       vaddq_f32(a, b)
+	#define gb__lanes_sub(a, b)       vsubq_f32(a, b)
+	#define gb__lanes_mul(a, b)       vmulq_f32(a, b)
+	#define gb__lanes_div(a, b)       vdivq_f32(a, b)
+	#define gb__lanes_sqrt(a)         vsqrtq_f32(a)
+	#define gb__lanes_less(a, b)      vcltq_f32(a, b)
+	#define gb__lanes_select(m, a, b) vbslq_f32(m, a, b)
+	#define gb__lanes_or(a, b)        vorrq_u32(a, b)
+	#define gb__lanes_bits(m)         gb__neon_bits(m)
+	static int gb__neon_bits(uint32x4_t m) {
+		static gb_math_u32 const bit[4] = {1, 2, 4, 8};
+		return (int)vaddvq_u32(vandq_u32(m, vld1q_u32(bit)));
+	}
+#else
+	typedef float gb__Lanes;
+	typedef int   gb__LaneMask;
+	#define GB__LANE_COUNT 1
+	#define gb__lanes_load(p)         (*(p))
+	#define gb__lanes_store(p, a)     (*(p) = (a))
+	#define gb__lanes_set1(s)         (s)
+	#define gb__lanes_add(a, b)       ((a) + (b))
+	#define gb__lanes_sub(a, b)       ((a) - (b))
+	#define gb__lanes_mul(a, b)       ((a) * (b))
+	#define gb__lanes_div(a, b)       ((a) / (b))
+	#define gb__lanes_sqrt(a)         gb_sqrt(a)
+	#define gb__lanes_less(a, b)      ((a) < (b))
+	#define gb__lanes_select(m, a, b) ((m) ? (a) : (b))
+	#define gb__lanes_or(a, b)        ((a) | (b))
+	#define gb__lanes_bits(m)         (m)
+#endif
+
+
 /* NOTE(bill): To remove the need for memcpy */
 static void gb__memcpy_4byte(void *dest, void const *src, size_t size) {
 	size_t i;
@@ -1465,7 +1638,44 @@ void gb_mat3_inverse(gbMat3 *out, gbMat3 *in) {
 
 void gb_mat4_transpose(gbMat4 *m) { gb_float44_transpose(gb_float44_m(m)); }
 void gb_mat4_identity(gbMat4 *m)  { gb_float44_identity(gb_float44_m(m));  }
+
+#if defined(GB_MATH_SSE)
+void gb_mat4_mul(gbMat4 *out, gbMat4 *m1, gbMat4 *m2) {
+	__m128 c0 = _mm_loadu_ps(m1->e+0);
+	__m128 c1 = _mm_loadu_ps(m1->e+4);
+	__m128 c2 = _mm_loadu_ps(m1->e+8);
+	__m128 c3 = _mm_loadu_ps(m1->e+12);
+	__m128 r[4];
+	int j;
+	for (j = 0; j < 4; j++) {
+		float const *b = m2->e + 4*j;
+		r[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(b[0])), _mm_mul_ps(c1, _mm_set1_ps(b[1]))),
+		                  _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(b[2])), _mm_mul_ps(c3, _mm_set1_ps(b[3]))));
+	}
+	for (j = 0; j < 4; j++)
+		_mm_storeu_ps(out->e + 4*j, r[j]);
+}
+#elif defined(GB_MATH_NEON)
+void gb_mat4_mul(gbMat4 *out, gbMat4 *m1, gbMat4 *m2) {
+	float32x4_t c0 = vld1q_f32(m1->e+0);
+	float32x4_t c1 = vld1q_f32(m1->e+4);
+	float32x4_t c2 = vld1q_f32(m1->e+8);
+	float32x4_t c3 = vld1q_f32(m1->e+12);
+	float32x4_t r[4];
+	int j;
+	for (j = 0; j < 4; j++) {
+		float32x4_t b = vld1q_f32(m2->e + 4*j);
+		r[j] = vmulq_laneq_f32(c0, b, 0);
+		r[j] = vfmaq_laneq_f32(r[j], c1, b, 1);
+		r[j] = vfmaq_laneq_f32(r[j], c2, b, 2);
+		r[j] = vfmaq_laneq_f32(r[j], c3, b, 3);
+	}
+	for (j = 0; j < 4; j++)
+		vst1q_f32(out->e + 4*j, r[j]);
+}
+#else
 void gb_mat4_mul(gbMat4 *out, gbMat4 *m1, gbMat4 *m2) { gb_float44_mul(gb_float44_m(out), gb_float44_m(m1), gb_float44_m(m2)); }
+#endif
 
 void gb_float44_identity(float m[4][4]) {
 	m[0][0] = 1; m[0][1] = 0; m[0][2] = 0; m[0][3] = 0;
@@ -1517,83 +1727,116 @@ void gb_float44_mul_vec4(gbVec4 *out, float m[4][4], gbVec4 v) {
 	out->w = m[0][3]*v.x + m[1][3]*v.y + m[2][3]*v.z + m[3][3]*v.w;
 }
 
-void gb_mat4_inverse(gbMat4 *out, gbMat4 *in) {
-	gbFloat4 *o = gb_float44_m(out);
-	gbFloat4 *m = gb_float44_m(in);
+#if defined(GB_MATH_SSE)
+/* NOTE(bill): The inverse by 2x2 blocks, each block is held as | x y | in one register
+ *                                                                | z w |
+ * which needs no transposing as the inverse of the transpose is the transpose of the inverse
+ */
+#define GB__SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#define GB__SWIZZLE(a, x, y, z, w)    GB__SHUFFLE(a, a, x, y, z, w)
+
+/* NOTE(bill): A*B, A#*B & A*B# where # is the adjugate */
+static __m128 gb__mat2_mul_sse(__m128 a, __m128 b) {
+	return _mm_add_ps(_mm_mul_ps(a, GB__SWIZZLE(b, 0,3,0,3)),
+	                  _mm_mul_ps(GB__SWIZZLE(a, 1,0,3,2), GB__SWIZZLE(b, 2,1,2,1)));
+}
+static __m128 gb__mat2_adj_mul_sse(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(GB__SWIZZLE(a, 3,3,0,0), b),
+	                  _mm_mul_ps(GB__SWIZZLE(a, 1,1,2,2), GB__SWIZZLE(b, 2,3,0,1)));
+}
+static __m128 gb__mat2_mul_adj_sse(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(a, GB__SWIZZLE(b, 3,0,3,0)),
+	                  _mm_mul_ps(GB__SWIZZLE(a, 1,0,3,2), GB__SWIZZLE(b, 2,1,2,1)));
+}
 
+void gb_mat4_inverse(gbMat4 *out, gbMat4 *in) {
+	__m128 r0 = _mm_loadu_ps(in->e+0);
+	__m128 r1 = _mm_loadu_ps(in->e+4);
+	__m128 r2 = _mm_loadu_ps(in->e+8);
+	__m128 r3 = _mm_loadu_ps(in->e+12);
+
+	__m128 a = _mm_movelh_ps(r0, r1);
+	__m128 b = _mm_movehl_ps(r1, r0);
+	__m128 c = _mm_movelh_ps(r2, r3);
+	__m128 d = _mm_movehl_ps(r3, r2);
+
+	/* NOTE(bill): |A| |B| |C| |D| */
+	__m128 det_sub = _mm_sub_ps(_mm_mul_ps(GB__SHUFFLE(r0, r2, 0,2,0,2), GB__SHUFFLE(r1, r3, 1,3,1,3)),
+	                            _mm_mul_ps(GB__SHUFFLE(r0, r2, 1,3,1,3), GB__SHUFFLE(r1, r3, 0,2,0,2)));
+	__m128 det_a = GB__SWIZZLE(det_sub, 0,0,0,0);
+	__m128 det_b = GB__SWIZZLE(det_sub, 1,1,1,1);
+	__m128 det_c = GB__SWIZZLE(det_sub, 2,2,2,2);
+	__m128 det_d = GB__SWIZZLE(det_sub, 3,3,3,3);
+
+	__m128 d_c = gb__mat2_adj_mul_sse(d, c);
+	__m128 a_b = gb__mat2_adj_mul_sse(a, b);
+
+	/* NOTE(bill): The inverse is 1/|M| * | X Y | with X# = |D|A - B(D#C),     Y# = |B|C - D(A#B)#
+	 *                                    | Z W |      Z# = |C|B - A(D#C)#,    W# = |A|D - C(A#B)
+	 */
+	__m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), gb__mat2_mul_sse(b, d_c));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), gb__mat2_mul_sse(c, a_b));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), gb__mat2_mul_adj_sse(d, a_b));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), gb__mat2_mul_adj_sse(a, d_c));
+
+	/* NOTE(bill): |M| = |A||D| + |B||C| - tr((A#B)(D#C)) */
+	__m128 det_m = _mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c));
+	__m128 tr = _mm_mul_ps(a_b, GB__SWIZZLE(d_c, 0,2,1,3));
+	tr = _mm_add_ps(tr, GB__SWIZZLE(tr, 2,3,0,1));
+	tr = _mm_add_ps(tr, GB__SWIZZLE(tr, 1,0,3,2));
+	det_m = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), _mm_sub_ps(det_m, tr));
+
+	x = _mm_mul_ps(x, det_m);
+	y = _mm_mul_ps(y, det_m);
+	z = _mm_mul_ps(z, det_m);
+	w = _mm_mul_ps(w, det_m);
+
+	/* NOTE(bill): The adjugate of each block as it is put back */
+	_mm_storeu_ps(out->e+0,  GB__SHUFFLE(x, y, 3,1,3,1));
+	_mm_storeu_ps(out->e+4,  GB__SHUFFLE(x, y, 2,0,2,0));
+	_mm_storeu_ps(out->e+8,  GB__SHUFFLE(z, w, 3,1,3,1));
+	_mm_storeu_ps(out->e+12, GB__SHUFFLE(z, w, 2,0,2,0));
+}
+
+#undef GB__SWIZZLE
+#undef GB__SHUFFLE
+#else
+void gb_mat4_inverse(gbMat4 *out, gbMat4 *in) {
+	/* NOTE(bill): The adjugate by cofactor expansion, the same either way up as the
+	 *             inverse of the transpose is the transpose of the inverse
+	 */
+	float const *m = in->e;
+	float o[16];
 	float ood;
-	float tmp;
+	int i;
+
+	o[0]  =  m[5]*m[10]*m[15] - m[5]*m[11]*m[14] - m[9]*m[6]*m[15] + m[9]*m[7]*m[14] + m[13]*m[6]*m[11] - m[13]*m[7]*m[10];
+	o[4]  = -m[4]*m[10]*m[15] + m[4]*m[11]*m[14] + m[8]*m[6]*m[15] - m[8]*m[7]*m[14] - m[12]*m[6]*m[11] + m[12]*m[7]*m[10];
+	o[8]  =  m[4]*m[9] *m[15] - m[4]*m[11]*m[13] - m[8]*m[5]*m[15] + m[8]*m[7]*m[13] + m[12]*m[5]*m[11] - m[12]*m[7]*m[9];
+	o[12] = -m[4]*m[9] *m[14] + m[4]*m[10]*m[13] + m[8]*m[5]*m[14] - m[8]*m[6]*m[13] - m[12]*m[5]*m[10] + m[12]*m[6]*m[9];
+
+	o[1]  = -m[1]*m[10]*m[15] + m[1]*m[11]*m[14] + m[9]*m[2]*m[15] - m[9]*m[3]*m[14] - m[13]*m[2]*m[11] + m[13]*m[3]*m[10];
+	o[5]  =  m[0]*m[10]*m[15] - m[0]*m[11]*m[14] - m[8]*m[2]*m[15] + m[8]*m[3]*m[14] + m[12]*m[2]*m[11] - m[12]*m[3]*m[10];
+	o[9]  = -m[0]*m[9] *m[15] + m[0]*m[11]*m[13] + m[8]*m[1]*m[15] - m[8]*m[3]*m[13] - m[12]*m[1]*m[11] + m[12]*m[3]*m[9];
+	o[13] =  m[0]*m[9] *m[14] - m[0]*m[10]*m[13] - m[8]*m[1]*m[14] + m[8]*m[2]*m[13] + m[12]*m[1]*m[10] - m[12]*m[2]*m[9];
+
+	o[2]  =  m[1]*m[6]*m[15] - m[1]*m[7]*m[14] - m[5]*m[2]*m[15] + m[5]*m[3]*m[14] + m[13]*m[2]*m[7] - m[13]*m[3]*m[6];
+	o[6]  = -m[0]*m[6]*m[15] + m[0]*m[7]*m[14] + m[4]*m[2]*m[15] - m[4]*m[3]*m[14] - m[12]*m[2]*m[7] + m[12]*m[3]*m[6];
+	o[10] =  m[0]*m[5]*m[15] - m[0]*m[7]*m[13] - m[4]*m[1]*m[15] + m[4]*m[3]*m[13] + m[12]*m[1]*m[7] - m[12]*m[3]*m[5];
+	o[14] = -m[0]*m[5]*m[14] + m[0]*m[6]*m[13] + m[4]*m[1]*m[14] - m[4]*m[2]*m[13] - m[12]*m[1]*m[6] + m[12]*m[2]*m[5];
+
+	o[3]  = -m[1]*m[6]*m[11] + m[1]*m[7]*m[10] + m[5]*m[2]*m[11] - m[5]*m[3]*m[10] - m[9]*m[2]*m[7] + m[9]*m[3]*m[6];
+	o[7]  =  m[0]*m[6]*m[11] - m[0]*m[7]*m[10] - m[4]*m[2]*m[11] + m[4]*m[3]*m[10] + m[8]*m[2]*m[7] - m[8]*m[3]*m[6];
+	o[11] = -m[0]*m[5]*m[11] + m[0]*m[7]*m[9]  + m[4]*m[1]*m[11] - m[4]*m[3]*m[9]  - m[8]*m[1]*m[7] + m[8]*m[3]*m[5];
+	o[15] =  m[0]*m[5]*m[10] - m[0]*m[6]*m[9]  - m[4]*m[1]*m[10] + m[4]*m[2]*m[9]  + m[8]*m[1]*m[6] - m[8]*m[2]*m[5];
 
-	float sf00 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
-	float sf01 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
-	float sf02 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
-	float sf03 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
-	float sf04 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
-	float sf05 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
-	float sf06 = m[1][2] * m[3][3] - m[3][2] * m[1][3];
-	float sf07 = m[1][1] * m[3][3] - m[3][1] * m[1][3];
-	float sf08 = m[1][1] * m[3][2] - m[3][1] * m[1][2];
-	float sf09 = m[1][0] * m[3][3] - m[3][0] * m[1][3];
-	float sf10 = m[1][0] * m[3][2] - m[3][0] * m[1][2];
-	float sf11 = m[1][1] * m[3][3] - m[3][1] * m[1][3];
-	float sf12 = m[1][0] * m[3][1] - m[3][0] * m[1][1];
-	float sf13 = m[1][2] * m[2][3] - m[2][2] * m[1][3];
-	float sf14 = m[1][1] * m[2][3] - m[2][1] * m[1][3];
-	float sf15 = m[1][1] * m[2][2] - m[2][1] * m[1][2];
-	float sf16 = m[1][0] * m[2][3] - m[2][0] * m[1][3];
-	float sf17 = m[1][0] * m[2][2] - m[2][0] * m[1][2];
-	float sf18 = m[1][0] * m[2][1] - m[2][0] * m[1][1];
-
-	o[0][0] = +(m[1][1] * sf00 - m[1][2] * sf01 + m[1][3] * sf02);
-	o[1][0] = -(m[1][0] * sf00 - m[1][2] * sf03 + m[1][3] * sf04);
-	o[2][0] = +(m[1][0] * sf01 - m[1][1] * sf03 + m[1][3] * sf05);
-	o[3][0] = -(m[1][0] * sf02 - m[1][1] * sf04 + m[1][2] * sf05);
-
-	o[0][1] = -(m[0][1] * sf00 - m[0][2] * sf01 + m[0][3] * sf02);
-	o[1][1] = +(m[0][0] * sf00 - m[0][2] * sf03 + m[0][3] * sf04);
-	o[2][1] = -(m[0][0] * sf01 - m[0][1] * sf03 + m[0][3] * sf05);
-	o[3][1] = +(m[0][0] * sf02 - m[0][1] * sf04 + m[0][2] * sf05);
-
-	o[0][2] = +(m[0][1] * sf06 - m[0][2] * sf07 + m[0][3] * sf08);
-	o[1][2] = -(m[0][0] * sf06 - m[0][2] * sf09 + m[0][3] * sf10);
-	o[2][2] = +(m[0][0] * sf11 - m[0][1] * sf09 + m[0][3] * sf12);
-	o[3][2] = -(m[0][0] * sf08 - m[0][1] * sf10 + m[0][2] * sf12);
-
-	o[0][3] = -(m[0][1] * sf13 - m[0][2] * sf14 + m[0][3] * sf15);
-	o[1][3] = +(m[0][0] * sf13 - m[0][2] * sf16 + m[0][3] * sf17);
-	o[2][3] = -(m[0][0] * sf14 - m[0][1] * sf16 + m[0][3] * sf18);
-	o[3][3] = +(m[0][0] * sf15 - m[0][1] * sf17 + m[0][2] * sf18);
-
-	ood = 1.0f / (m[0][0] * o[0][0] +
-	              m[1][0] * o[1][0] +
-	              m[2][0] * o[2][0] +
-	              m[3][0] * o[3][0]);
-
-	o[0][0] *= ood;
-	o[0][1] *= ood;
-	o[0][2] *= ood;
-	o[0][3] *= ood;
-	o[1][0] *= ood;
-	o[1][1] *= ood;
-	o[1][2] *= ood;
-	o[1][3] *= ood;
-	o[2][0] *= ood;
-	o[2][1] *= ood;
-	o[2][2] *= ood;
-	o[2][3] *= ood;
-	o[3][0] *= ood;
-	o[3][1] *= ood;
-	o[3][2] *= ood;
-	o[3][3] *= ood;
-
-	/* Transpose */
-	tmp = o[1][0]; o[1][0] = o[0][1]; o[0][1] = tmp;
-	tmp = o[2][0]; o[2][0] = o[0][2]; o[0][2] = tmp;
-	tmp = o[3][0]; o[3][0] = o[0][3]; o[0][3] = tmp;
-	tmp = o[2][1]; o[2][1] = o[1][2]; o[1][2] = tmp;
-	tmp = o[3][1]; o[3][1] = o[1][3]; o[1][3] = tmp;
-	tmp = o[3][2]; o[3][2] = o[2][3]; o[2][3] = tmp;
+	ood = 1.0f / (m[0]*o[0] + m[1]*o[4] + m[2]*o[8] + m[3]*o[12]);
+
+	/* NOTE(bill): Written after reading as `out` may be `in` */
+	for (i = 0; i < 16; i++)
+		out->e[i] = o[i] * ood;
 }
+#endif
 
 
 
@@ -1974,17 +2217,18 @@ void gb_quat_slerp(gbQuat *d, gbQuat a, gbQuat b, float t) {
 		cos_theta = -cos_theta;
 	}
 
-	if (cos_theta > 1.0f) {
-		/* NOTE(bill): Use lerp not nlerp as it's not a real angle or they are not normalized */
-		gb_quat_lerp(d, a, b, t);
+	if (cos_theta > 0.9995f) {
+		/* NOTE(bill): Use nlerp as sin(angle) is too small to divide by, or they are not normalized */
+		gb_quat_nlerp(d, a, z, t);
+		return;
 	}
 
 	angle = gb_arccos(cos_theta);
 
-	s1 = gb_sin(1.0f - t*angle);
+	s1 = gb_sin((1.0f - t)*angle);
 	s0 = gb_sin(t*angle);
 	is = 1.0f/gb_sin(angle);
-	gb_quat_mulf(&x, z, s1);
+	gb_quat_mulf(&x, a, s1);
 	gb_quat_mulf(&y, z, s0);
 	gb_quat_add(d, x, y);
 	gb_quat_muleqf(d, is);
@@ -2083,6 +2327,697 @@ int gb_rect2_intersection_result(gbRect2 a, gbRect2 b, gbRect2 *intersection) {
 }
 
 
+
+/* NOTE(bill): Each batch kernel does `n` values (a multiple of GB__LANE_COUNT) with each
+ * component, of each argument, as its own array in `in` and likewise for `out`
+ */
+typedef void gb__BatchKernel(float *const *out, float const *const *in, void const *data, size_t n);
+
+#define GB__BATCH_MAX_IN  8
+#define GB__BATCH_MAX_OUT 4
+#define GB__BATCH_BLOCK   64
+
+static void gb__batch_soa(gb__BatchKernel *kernel, float *const *out, int out_count, float const *const *in, int in_count, void const *data, size_t count) {
+	float tail_in[GB__BATCH_MAX_IN][GB__LANE_COUNT], tail_out[GB__BATCH_MAX_OUT][GB__LANE_COUNT];
+	float const *ti[GB__BATCH_MAX_IN];
+	float *to[GB__BATCH_MAX_OUT];
+	size_t body = count - count%GB__LANE_COUNT;
+	size_t rem = count - body, j;
+	int k;
+
+	if (body > 0)
+		kernel(out, in, data, body);
+	if (rem == 0)
+		return;
+
+	/* NOTE(bill): Pad the remainder out to a full set of lanes */
+	for (k = 0; k < in_count; k++) {
+		for (j = 0; j < GB__LANE_COUNT; j++)
+			tail_in[k][j] = j < rem ? in[k][body+j] : 1.0f;
+		ti[k] = tail_in[k];
+	}
+	for (k = 0; k < out_count; k++)
+		to[k] = tail_out[k];
+	kernel(to, ti, data, GB__LANE_COUNT);
+	for (k = 0; k < out_count; k++) {
+		for (j = 0; j < rem; j++)
+			out[k][body+j] = tail_out[k][j];
+	}
+}
+
+static void gb__deinterleave(float *const *dst, float const *src, int w, size_t n) {
+	size_t j = 0;
+	int c;
+#if defined(GB_MATH_SSE)
+	if (w == 4) {
+		for (; j+4 <= n; j += 4) {
+			__m128 a = _mm_loadu_ps(src + 4*j+0), b = _mm_loadu_ps(src + 4*j+4);
+			__m128 e = _mm_loadu_ps(src + 4*j+8), f = _mm_loadu_ps(src + 4*j+12);
+			_MM_TRANSPOSE4_PS(a, b, e, f);
+			_mm_storeu_ps(dst[0]+j, a); _mm_storeu_ps(dst[1]+j, b);
+			_mm_storeu_ps(dst[2]+j, e); _mm_storeu_ps(dst[3]+j, f);
+		}
+	} else if (w == 3) {
+		for (; j+4 <= n; j += 4) {
+			/* NOTE(bill): x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 */
+			__m128 a = _mm_loadu_ps(src + 3*j+0), b = _mm_loadu_ps(src + 3*j+4), e = _mm_loadu_ps(src + 3*j+8);
+			__m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, e, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,3,0));
+			__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)), _mm_shuffle_ps(b, e, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+			__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)), e, _MM_SHUFFLE(3,0,2,0));
+			_mm_storeu_ps(dst[0]+j, x); _mm_storeu_ps(dst[1]+j, y); _mm_storeu_ps(dst[2]+j, z);
+		}
+	}
+#endif
+	for (; j < n; j++) {
+		for (c = 0; c < w; c++)
+			dst[c][j] = src[j*w + c];
+	}
+}
+
+static void gb__interleave(float *dst, float const *const *src, int w, size_t n) {
+	size_t j = 0;
+	int c;
+#if defined(GB_MATH_SSE)
+	if (w == 4) {
+		for (; j+4 <= n; j += 4) {
+			__m128 a = _mm_loadu_ps(src[0]+j), b = _mm_loadu_ps(src[1]+j);
+			__m128 e = _mm_loadu_ps(src[2]+j), f = _mm_loadu_ps(src[3]+j);
+			_MM_TRANSPOSE4_PS(a, b, e, f);
+			_mm_storeu_ps(dst + 4*j+0, a); _mm_storeu_ps(dst + 4*j+4,  b);
+			_mm_storeu_ps(dst + 4*j+8, e); _mm_storeu_ps(dst + 4*j+12, f);
+		}
+	} else if (w == 3) {
+		for (; j+4 <= n; j += 4) {
+			__m128 x = _mm_loadu_ps(src[0]+j), y = _mm_loadu_ps(src[1]+j), z = _mm_loadu_ps(src[2]+j);
+			__m128 a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0,0,0,0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1,1,0,0)), _MM_SHUFFLE(2,0,2,0));
+			__m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1,1,1,1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2,2,2,2)), _MM_SHUFFLE(2,0,2,0));
+			__m128 e = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3,3,2,2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(2,0,2,0));
+			_mm_storeu_ps(dst + 3*j+0, a); _mm_storeu_ps(dst + 3*j+4, b); _mm_storeu_ps(dst + 3*j+8, e);
+		}
+	}
+#endif
+	for (; j < n; j++) {
+		for (c = 0; c < w; c++)
+			dst[j*w + c] = src[c][j];
+	}
+}
+
+/* NOTE(bill): Splits each interleaved array into its components a block at a time */
+static void gb__batch_aos(gb__BatchKernel *kernel, float *out, int out_width, float const *const *in, int const *in_widths, int in_count, void const *data, size_t count) {
+	float src[GB__BATCH_MAX_IN][GB__BATCH_BLOCK], dst[GB__BATCH_MAX_OUT][GB__BATCH_BLOCK];
+	float *s[GB__BATCH_MAX_IN];
+	float *d[GB__BATCH_MAX_OUT];
+	size_t base, n, padded, j;
+	int a, c, k;
+
+	for (k = 0; k < GB__BATCH_MAX_IN; k++)  s[k] = src[k];
+	for (k = 0; k < GB__BATCH_MAX_OUT; k++) d[k] = dst[k];
+
+	for (base = 0; base < count; base += n) {
+		n = count - base;
+		if (n > GB__BATCH_BLOCK) n = GB__BATCH_BLOCK;
+		padded = (n + GB__LANE_COUNT-1) / GB__LANE_COUNT * GB__LANE_COUNT;
+
+		k = 0;
+		for (a = 0; a < in_count; a++) {
+			gb__deinterleave(s+k, in[a] + base*in_widths[a], in_widths[a], n);
+			for (c = 0; c < in_widths[a]; c++, k++) {
+				for (j = n; j < padded; j++)
+					src[k][j] = 1.0f;
+			}
+		}
+
+		kernel(d, (float const *const *)s, data, padded);
+		gb__interleave(out + base*out_width, (float const *const *)d, out_width, n);
+	}
+}
+
+
+static void gb__batch_mat4_mul_vec4(float *const *o, float const *const *in, void const *data, size_t n) {
+	float const *e = ((gbMat4 const *)data)->e;
+	gb__Lanes m[16], v[4], r[4];
+	size_t i;
+	int k;
+	for (k = 0; k < 16; k++)
+		m[k] = gb__lanes_set1(e[k]);
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		for (k = 0; k < 4; k++)
+			v[k] = gb__lanes_load(in[k]+i);
+		for (k = 0; k < 4; k++) {
+			r[k] = gb__lanes_add(gb__lanes_add(gb__lanes_mul(m[k],   v[0]), gb__lanes_mul(m[4+k],  v[1])),
+			                     gb__lanes_add(gb__lanes_mul(m[8+k], v[2]), gb__lanes_mul(m[12+k], v[3])));
+		}
+		for (k = 0; k < 4; k++)
+			gb__lanes_store(o[k]+i, r[k]);
+	}
+}
+
+static void gb__batch_mat4_mul_point3(float *const *o, float const *const *in, void const *data, size_t n) {
+	float const *e = ((gbMat4 const *)data)->e;
+	gb__Lanes m[16], v[3], r[3];
+	size_t i;
+	int k;
+	for (k = 0; k < 16; k++)
+		m[k] = gb__lanes_set1(e[k]);
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		for (k = 0; k < 3; k++)
+			v[k] = gb__lanes_load(in[k]+i);
+		for (k = 0; k < 3; k++) {
+			r[k] = gb__lanes_add(gb__lanes_add(gb__lanes_mul(m[k], v[0]), gb__lanes_mul(m[4+k], v[1])),
+			                     gb__lanes_add(gb__lanes_mul(m[8+k], v[2]), m[12+k]));
+		}
+		for (k = 0; k < 3; k++)
+			gb__lanes_store(o[k]+i, r[k]);
+	}
+}
+
+static void gb__batch_vec3_norm(float *const *o, float const *const *in, void const *data, size_t n) {
+	size_t i;
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		gb__Lanes x = gb__lanes_load(in[0]+i);
+		gb__Lanes y = gb__lanes_load(in[1]+i);
+		gb__Lanes z = gb__lanes_load(in[2]+i);
+		gb__Lanes mag = gb__lanes_sqrt(gb__lanes_add(gb__lanes_add(gb__lanes_mul(x, x), gb__lanes_mul(y, y)), gb__lanes_mul(z, z)));
+		gb__lanes_store(o[0]+i, gb__lanes_div(x, mag));
+		gb__lanes_store(o[1]+i, gb__lanes_div(y, mag));
+		gb__lanes_store(o[2]+i, gb__lanes_div(z, mag));
+	}
+	(void)data;
+}
+
+static void gb__batch_vec3_lerp(float *const *o, float const *const *in, void const *data, size_t n) {
+	gb__Lanes t = gb__lanes_set1(*(float const *)data);
+	gb__Lanes r[3];
+	size_t i;
+	int k;
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		for (k = 0; k < 3; k++) {
+			gb__Lanes a = gb__lanes_load(in[k]+i);
+			gb__Lanes b = gb__lanes_load(in[3+k]+i);
+			r[k] = gb__lanes_add(a, gb__lanes_mul(gb__lanes_sub(b, a), t));
+		}
+		for (k = 0; k < 3; k++)
+			gb__lanes_store(o[k]+i, r[k]);
+	}
+}
+
+static void gb__batch_quat_mul(float *const *o, float const *const *in, void const *data, size_t n) {
+	size_t i;
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		gb__Lanes ax = gb__lanes_load(in[0]+i), ay = gb__lanes_load(in[1]+i), az = gb__lanes_load(in[2]+i), aw = gb__lanes_load(in[3]+i);
+		gb__Lanes bx = gb__lanes_load(in[4]+i), by = gb__lanes_load(in[5]+i), bz = gb__lanes_load(in[6]+i), bw = gb__lanes_load(in[7]+i);
+		gb__Lanes x = gb__lanes_sub(gb__lanes_add(gb__lanes_add(gb__lanes_mul(aw, bx), gb__lanes_mul(ax, bw)), gb__lanes_mul(ay, bz)), gb__lanes_mul(az, by));
+		gb__Lanes y = gb__lanes_add(gb__lanes_add(gb__lanes_sub(gb__lanes_mul(aw, by), gb__lanes_mul(ax, bz)), gb__lanes_mul(ay, bw)), gb__lanes_mul(az, bx));
+		gb__Lanes z = gb__lanes_add(gb__lanes_sub(gb__lanes_add(gb__lanes_mul(aw, bz), gb__lanes_mul(ax, by)), gb__lanes_mul(ay, bx)), gb__lanes_mul(az, bw));
+		gb__Lanes w = gb__lanes_sub(gb__lanes_sub(gb__lanes_sub(gb__lanes_mul(aw, bw), gb__lanes_mul(ax, bx)), gb__lanes_mul(ay, by)), gb__lanes_mul(az, bz));
+		gb__lanes_store(o[0]+i, x);
+		gb__lanes_store(o[1]+i, y);
+		gb__lanes_store(o[2]+i, z);
+		gb__lanes_store(o[3]+i, w);
+	}
+	(void)data;
+}
+
+static void gb__batch_quat_norm(float *const *o, float const *const *in, void const *data, size_t n) {
+	size_t i;
+	int k;
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		gb__Lanes q[4], dot;
+		for (k = 0; k < 4; k++)
+			q[k] = gb__lanes_load(in[k]+i);
+		dot = gb__lanes_add(gb__lanes_add(gb__lanes_mul(q[0], q[0]), gb__lanes_mul(q[1], q[1])),
+		                    gb__lanes_add(gb__lanes_mul(q[2], q[2]), gb__lanes_mul(q[3], q[3])));
+		dot = gb__lanes_sqrt(dot);
+		for (k = 0; k < 4; k++)
+			gb__lanes_store(o[k]+i, gb__lanes_div(q[k], dot));
+	}
+	(void)data;
+}
+
+static void gb__batch_quat_nlerp(float *const *o, float const *const *in, void const *data, size_t n) {
+	gb__Lanes t = gb__lanes_set1(*(float const *)data);
+	size_t i;
+	int k;
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		gb__Lanes q[4], dot;
+		for (k = 0; k < 4; k++) {
+			gb__Lanes a = gb__lanes_load(in[k]+i);
+			gb__Lanes b = gb__lanes_load(in[4+k]+i);
+			q[k] = gb__lanes_add(a, gb__lanes_mul(gb__lanes_sub(b, a), t));
+		}
+		dot = gb__lanes_add(gb__lanes_add(gb__lanes_mul(q[0], q[0]), gb__lanes_mul(q[1], q[1])),
+		                    gb__lanes_add(gb__lanes_mul(q[2], q[2]), gb__lanes_mul(q[3], q[3])));
+		dot = gb__lanes_sqrt(dot);
+		for (k = 0; k < 4; k++)
+			gb__lanes_store(o[k]+i, gb__lanes_div(q[k], dot));
+	}
+}
+
+/* NOTE(bill): slerp without any trigonometry from
+ *             "A Fast and Accurate Algorithm for Computing SLERP" by David Eberly
+ *             sin(t*angle)/sin(angle) is a series in (cos(angle) - 1) with the last term fudged.
+ *             The series is only good to 1e-7 for angles up to ~100 degrees so this slerps
+ *             half way, with m = the normalized a + b, from a to m or from m to b
+ */
+static void gb__batch_quat_slerp(float *const *o, float const *const *in, void const *data, size_t n) {
+	/* NOTE(bill): u[i] = 1/(i*(2i+1)), v[i] = i/(2i+1) and the last are scaled by mu = 1.90110745351730037 */
+	static float const u[8] = {1.0f/3.0f, 1.0f/10.0f, 1.0f/21.0f, 1.0f/36.0f, 1.0f/55.0f, 1.0f/78.0f, 1.0f/105.0f, 1.90110745351730037f/136.0f};
+	static float const v[8] = {1.0f/3.0f, 2.0f/5.0f,  3.0f/7.0f,  4.0f/9.0f,  5.0f/11.0f, 6.0f/13.0f, 7.0f/15.0f,  1.90110745351730037f*8.0f/17.0f};
+	float t = *(float const *)data;
+	int second_half = t >= 0.5f;
+	float d;
+	gb__Lanes ct[8], cd[8];
+	gb__Lanes one  = gb__lanes_set1(1.0f);
+	gb__Lanes two  = gb__lanes_set1(2.0f);
+	gb__Lanes zero = gb__lanes_set1(0.0f);
+	gb__Lanes lt, ld;
+	size_t i;
+	int k;
+
+	t = second_half ? 2.0f*t - 1.0f : 2.0f*t;
+	d = 1.0f - t;
+	lt = gb__lanes_set1(t);
+	ld = gb__lanes_set1(d);
+	for (k = 0; k < 8; k++) {
+		ct[k] = gb__lanes_set1(u[k]*t*t - v[k]);
+		cd[k] = gb__lanes_set1(u[k]*d*d - v[k]);
+	}
+
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		gb__Lanes a[4], b[4], m[4], dot, h, xm1, st, sd;
+		gb__LaneMask neg;
+		for (k = 0; k < 4; k++) {
+			a[k] = gb__lanes_load(in[k]+i);
+			b[k] = gb__lanes_load(in[4+k]+i);
+		}
+		dot = gb__lanes_add(gb__lanes_add(gb__lanes_mul(a[0], b[0]), gb__lanes_mul(a[1], b[1])),
+		                    gb__lanes_add(gb__lanes_mul(a[2], b[2]), gb__lanes_mul(a[3], b[3])));
+		/* NOTE(bill): Take the shorter path */
+		neg = gb__lanes_less(dot, zero);
+		dot = gb__lanes_select(neg, gb__lanes_sub(zero, dot), dot);
+		for (k = 0; k < 4; k++)
+			b[k] = gb__lanes_select(neg, gb__lanes_sub(zero, b[k]), b[k]);
+
+		/* NOTE(bill): |a + b| = sqrt(2 + 2*dot) and dot(a, m) = dot(m, b) = (1 + dot)/|a + b| */
+		h = gb__lanes_div(one, gb__lanes_sqrt(gb__lanes_mul(two, gb__lanes_add(one, dot))));
+		for (k = 0; k < 4; k++)
+			m[k] = gb__lanes_mul(gb__lanes_add(a[k], b[k]), h);
+		xm1 = gb__lanes_sub(gb__lanes_mul(gb__lanes_add(one, dot), h), one);
+
+		st = one;
+		sd = one;
+		for (k = 7; k >= 0; k--) {
+			st = gb__lanes_add(one, gb__lanes_mul(gb__lanes_mul(ct[k], xm1), st));
+			sd = gb__lanes_add(one, gb__lanes_mul(gb__lanes_mul(cd[k], xm1), sd));
+		}
+		st = gb__lanes_mul(st, lt);
+		sd = gb__lanes_mul(sd, ld);
+
+		if (second_half) {
+			for (k = 0; k < 4; k++)
+				gb__lanes_store(o[k]+i, gb__lanes_add(gb__lanes_mul(sd, m[k]), gb__lanes_mul(st, b[k])));
+		} else {
+			for (k = 0; k < 4; k++)
+				gb__lanes_store(o[k]+i, gb__lanes_add(gb__lanes_mul(sd, a[k]), gb__lanes_mul(st, m[k])));
+		}
+	}
+}
+
+static void gb__batch_quat_rotate_vec3(float *const *o, float const *const *in, void const *data, size_t n) {
+	gb__Lanes two = gb__lanes_set1(2.0f);
+	size_t i;
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		gb__Lanes qx = gb__lanes_load(in[0]+i), qy = gb__lanes_load(in[1]+i), qz = gb__lanes_load(in[2]+i), qw = gb__lanes_load(in[3]+i);
+		gb__Lanes vx = gb__lanes_load(in[4]+i), vy = gb__lanes_load(in[5]+i), vz = gb__lanes_load(in[6]+i);
+		/* NOTE(bill): t = 2*cross(q.xyz, v); d = q.w*t + v + cross(q.xyz, t) */
+		gb__Lanes tx = gb__lanes_mul(two, gb__lanes_sub(gb__lanes_mul(qy, vz), gb__lanes_mul(qz, vy)));
+		gb__Lanes ty = gb__lanes_mul(two, gb__lanes_sub(gb__lanes_mul(qz, vx), gb__lanes_mul(qx, vz)));
+		gb__Lanes tz = gb__lanes_mul(two, gb__lanes_sub(gb__lanes_mul(qx, vy), gb__lanes_mul(qy, vx)));
+		gb__Lanes dx = gb__lanes_add(gb__lanes_add(gb__lanes_mul(qw, tx), vx), gb__lanes_sub(gb__lanes_mul(qy, tz), gb__lanes_mul(qz, ty)));
+		gb__Lanes dy = gb__lanes_add(gb__lanes_add(gb__lanes_mul(qw, ty), vy), gb__lanes_sub(gb__lanes_mul(qz, tx), gb__lanes_mul(qx, tz)));
+		gb__Lanes dz = gb__lanes_add(gb__lanes_add(gb__lanes_mul(qw, tz), vz), gb__lanes_sub(gb__lanes_mul(qx, ty), gb__lanes_mul(qy, tx)));
+		gb__lanes_store(o[0]+i, dx);
+		gb__lanes_store(o[1]+i, dy);
+		gb__lanes_store(o[2]+i, dz);
+	}
+	(void)data;
+}
+
+
+void gb_mat4_mul_vec4_array(gbVec4 *out, gbMat4 *m, gbVec4 const *in, size_t count) {
+	float const *a[1]; int w[1] = {4};
+	a[0] = (float const *)in;
+	gb__batch_aos(gb__batch_mat4_mul_vec4, (float *)out, 4, a, w, 1, m, count);
+}
+void gb_mat4_mul_point3_array(gbVec3 *out, gbMat4 *m, gbVec3 const *in, size_t count) {
+	float const *a[1]; int w[1] = {3};
+	a[0] = (float const *)in;
+	gb__batch_aos(gb__batch_mat4_mul_point3, (float *)out, 3, a, w, 1, m, count);
+}
+void gb_vec3_norm_array(gbVec3 *out, gbVec3 const *in, size_t count) {
+	float const *a[1]; int w[1] = {3};
+	a[0] = (float const *)in;
+	gb__batch_aos(gb__batch_vec3_norm, (float *)out, 3, a, w, 1, NULL, count);
+}
+void gb_vec3_lerp_array(gbVec3 *out, gbVec3 const *a, gbVec3 const *b, float t, size_t count) {
+	float const *ab[2]; int w[2] = {3, 3};
+	ab[0] = (float const *)a; ab[1] = (float const *)b;
+	gb__batch_aos(gb__batch_vec3_lerp, (float *)out, 3, ab, w, 2, &t, count);
+}
+void gb_quat_mul_array(gbQuat *out, gbQuat const *a, gbQuat const *b, size_t count) {
+	float const *ab[2]; int w[2] = {4, 4};
+	ab[0] = (float const *)a; ab[1] = (float const *)b;
+	gb__batch_aos(gb__batch_quat_mul, (float *)out, 4, ab, w, 2, NULL, count);
+}
+void gb_quat_norm_array(gbQuat *out, gbQuat const *in, size_t count) {
+	float const *a[1]; int w[1] = {4};
+	a[0] = (float const *)in;
+	gb__batch_aos(gb__batch_quat_norm, (float *)out, 4, a, w, 1, NULL, count);
+}
+void gb_quat_nlerp_array(gbQuat *out, gbQuat const *a, gbQuat const *b, float t, size_t count) {
+	float const *ab[2]; int w[2] = {4, 4};
+	ab[0] = (float const *)a; ab[1] = (float const *)b;
+	gb__batch_aos(gb__batch_quat_nlerp, (float *)out, 4, ab, w, 2, &t, count);
+}
+void gb_quat_slerp_array(gbQuat *out, gbQuat const *a, gbQuat const *b, float t, size_t count) {
+	float const *ab[2]; int w[2] = {4, 4};
+	ab[0] = (float const *)a; ab[1] = (float const *)b;
+	gb__batch_aos(gb__batch_quat_slerp, (float *)out, 4, ab, w, 2, &t, count);
+}
+void gb_quat_rotate_vec3_array(gbVec3 *out, gbQuat const *q, gbVec3 const *v, size_t count) {
+	float const *qv[2]; int w[2] = {4, 3};
+	qv[0] = (float const *)q; qv[1] = (float const *)v;
+	gb__batch_aos(gb__batch_quat_rotate_vec3, (float *)out, 3, qv, w, 2, NULL, count);
+}
+
+
+#define GB__SOA3(p, v, o) (p)[(o)+0] = (v).x; (p)[(o)+1] = (v).y; (p)[(o)+2] = (v).z
+#define GB__SOA4(p, v, o) GB__SOA3(p, v, o); (p)[(o)+3] = (v).w
+
+void gb_mat4_mul_vec4_soa(gbVec4SoA out, gbMat4 *m, gbVec4SoA in, size_t count) {
+	float *o[4]; float const *a[4];
+	GB__SOA4(o, out, 0); GB__SOA4(a, in, 0);
+	gb__batch_soa(gb__batch_mat4_mul_vec4, o, 4, a, 4, m, count);
+}
+void gb_mat4_mul_point3_soa(gbVec3SoA out, gbMat4 *m, gbVec3SoA in, size_t count) {
+	float *o[3]; float const *a[3];
+	GB__SOA3(o, out, 0); GB__SOA3(a, in, 0);
+	gb__batch_soa(gb__batch_mat4_mul_point3, o, 3, a, 3, m, count);
+}
+void gb_vec3_norm_soa(gbVec3SoA out, gbVec3SoA in, size_t count) {
+	float *o[3]; float const *a[3];
+	GB__SOA3(o, out, 0); GB__SOA3(a, in, 0);
+	gb__batch_soa(gb__batch_vec3_norm, o, 3, a, 3, NULL, count);
+}
+void gb_vec3_lerp_soa(gbVec3SoA out, gbVec3SoA a, gbVec3SoA b, float t, size_t count) {
+	float *o[3]; float const *ab[6];
+	GB__SOA3(o, out, 0); GB__SOA3(ab, a, 0); GB__SOA3(ab, b, 3);
+	gb__batch_soa(gb__batch_vec3_lerp, o, 3, ab, 6, &t, count);
+}
+void gb_quat_mul_soa(gbQuatSoA out, gbQuatSoA a, gbQuatSoA b, size_t count) {
+	float *o[4]; float const *ab[8];
+	GB__SOA4(o, out, 0); GB__SOA4(ab, a, 0); GB__SOA4(ab, b, 4);
+	gb__batch_soa(gb__batch_quat_mul, o, 4, ab, 8, NULL, count);
+}
+void gb_quat_norm_soa(gbQuatSoA out, gbQuatSoA in, size_t count) {
+	float *o[4]; float const *a[4];
+	GB__SOA4(o, out, 0); GB__SOA4(a, in, 0);
+	gb__batch_soa(gb__batch_quat_norm, o, 4, a, 4, NULL, count);
+}
+void gb_quat_nlerp_soa(gbQuatSoA out, gbQuatSoA a, gbQuatSoA b, float t, size_t count) {
+	float *o[4]; float const *ab[8];
+	GB__SOA4(o, out, 0); GB__SOA4(ab, a, 0); GB__SOA4(ab, b, 4);
+	gb__batch_soa(gb__batch_quat_nlerp, o, 4, ab, 8, &t, count);
+}
+void gb_quat_slerp_soa(gbQuatSoA out, gbQuatSoA a, gbQuatSoA b, float t, size_t count) {
+	float *o[4]; float const *ab[8];
+	GB__SOA4(o, out, 0); GB__SOA4(ab, a, 0); GB__SOA4(ab, b, 4);
+	gb__batch_soa(gb__batch_quat_slerp, o, 4, ab, 8, &t, count);
+}
+void gb_quat_rotate_vec3_soa(gbVec3SoA out, gbQuatSoA q, gbVec3SoA v, size_t count) {
+	float *o[3]; float const *qv[7];
+	GB__SOA3(o, out, 0); GB__SOA4(qv, q, 0); GB__SOA3(qv, v, 4);
+	gb__batch_soa(gb__batch_quat_rotate_vec3, o, 3, qv, 7, NULL, count);
+}
+
+#undef GB__SOA4
+#undef GB__SOA3
+
+
+
+gbPlane gb_plane(gbVec3 normal, float d) {
+	gbPlane p;
+	p.normal = normal;
+	p.d = d;
+	return p;
+}
+
+gbPlane gb_plane_from_point(gbVec3 normal, gbVec3 point) { return gb_plane(normal, -gb_vec3_dot(normal, point)); }
+
+void gb_plane_norm(gbPlane *out, gbPlane p) {
+	float mag = gb_vec3_mag(p.normal);
+	if (mag > 0) {
+		gb_vec4_div(&out->xyzw, p.xyzw, mag);
+	} else {
+		/* NOTE(bill): e.g. the far plane of an infinite perspective, everything is in front of it */
+		*out = gb_plane(gb_vec3_zero(), 1.0f);
+	}
+}
+
+float gb_plane_distance(gbPlane p, gbVec3 point) { return gb_vec3_dot(p.normal, point) + p.d; }
+
+
+gbAabb3 gb_aabb3_from_min_max(gbVec3 min, gbVec3 max) {
+	gbAabb3 a;
+	gb_vec3_add(&a.centre, min, max);
+	gb_vec3_muleq(&a.centre, 0.5f);
+	gb_vec3_sub(&a.half_size, max, min);
+	gb_vec3_muleq(&a.half_size, 0.5f);
+	return a;
+}
+
+int gb_aabb3_contains_vec3(gbAabb3 a, gbVec3 p) {
+	return gb_abs(p.x - a.centre.x) <= a.half_size.x &&
+	       gb_abs(p.y - a.centre.y) <= a.half_size.y &&
+	       gb_abs(p.z - a.centre.z) <= a.half_size.z;
+}
+
+int gb_aabb3_intersects(gbAabb3 a, gbAabb3 b) {
+	return gb_abs(a.centre.x - b.centre.x) <= a.half_size.x + b.half_size.x &&
+	       gb_abs(a.centre.y - b.centre.y) <= a.half_size.y + b.half_size.y &&
+	       gb_abs(a.centre.z - b.centre.z) <= a.half_size.z + b.half_size.z;
+}
+
+void gb_aabb3_transform(gbAabb3 *out, gbMat4 *m, gbAabb3 a) {
+	/* NOTE(bill): From "Transforming Axis-Aligned Bounding Boxes" by James Arvo
+	 *             The new half size is the absolute matrix times the old one
+	 */
+	gbAabb3 r;
+	int i;
+	for (i = 0; i < 3; i++) {
+		r.centre.e[i] = m->e[12+i] + m->e[i]*a.centre.x + m->e[4+i]*a.centre.y + m->e[8+i]*a.centre.z;
+		r.half_size.e[i] = gb_abs(m->e[i])*a.half_size.x + gb_abs(m->e[4+i])*a.half_size.y + gb_abs(m->e[8+i])*a.half_size.z;
+	}
+	*out = r;
+}
+
+int gb_sphere_intersects(gbSphere a, gbSphere b) {
+	float r = a.radius + b.radius;
+	gbVec3 d;
+	gb_vec3_sub(&d, a.centre, b.centre);
+	return gb_vec3_dot(d, d) <= r*r;
+}
+
+
+void gb_frustum_from_mat4(gbFrustum *out, gbMat4 *view_projection) {
+	/* NOTE(bill): From "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+	 *             by Gil Gribb & Klaus Hartmann, each plane is the last row plus or minus another row
+	 */
+	float const *e = view_projection->e;
+	int i;
+	for (i = 0; i < 6; i++) {
+		int r = i/2;
+		float s = (i & 1) ? -1.0f : 1.0f;
+		gbPlane p;
+		p.xyzw = gb_vec4(e[3] + s*e[r], e[7] + s*e[4+r], e[11] + s*e[8+r], e[15] + s*e[12+r]);
+		gb_plane_norm(&out->planes[i], p);
+	}
+}
+
+int gb_frustum_contains_vec3(gbFrustum const *f, gbVec3 p) {
+	int i;
+	for (i = 0; i < 6; i++) {
+		if (gb_plane_distance(f->planes[i], p) < 0.0f)
+			return 0;
+	}
+	return 1;
+}
+
+int gb_frustum_intersects_sphere(gbFrustum const *f, gbSphere s) {
+	int i;
+	for (i = 0; i < 6; i++) {
+		if (gb_plane_distance(f->planes[i], s.centre) < -s.radius)
+			return 0;
+	}
+	return 1;
+}
+
+int gb_frustum_intersects_aabb3(gbFrustum const *f, gbAabb3 a) {
+	int i;
+	for (i = 0; i < 6; i++) {
+		gbVec3 n = f->planes[i].normal;
+		float r = gb_abs(n.x)*a.half_size.x + gb_abs(n.y)*a.half_size.y + gb_abs(n.z)*a.half_size.z;
+		if (gb_plane_distance(f->planes[i], a.centre) < -r)
+			return 0;
+	}
+	return 1;
+}
+
+
+/* NOTE(bill): `in` is the centre x, y & z then the half size x, y & z (or the radius), `n` is a
+ * multiple of GB__LANE_COUNT of which the first `valid` are real, the rest are padding
+ */
+static size_t gb__frustum_cull(gbFrustum const *f, float const *const *in, int spheres, size_t base, size_t n, size_t valid,
+                               gb_math_u32 *visible_bits, gb_math_u32 *visible_indices, size_t visible) {
+	gb__Lanes pn[6][3], pa[6][3], pd[6];
+	gb__Lanes zero = gb__lanes_set1(0.0f);
+	size_t i;
+	int k, c;
+
+	for (k = 0; k < 6; k++) {
+		for (c = 0; c < 3; c++) {
+			pn[k][c] = gb__lanes_set1(f->planes[k].e[c]);
+			pa[k][c] = gb__lanes_set1(gb_abs(f->planes[k].e[c]));
+		}
+		pd[k] = gb__lanes_set1(f->planes[k].d);
+	}
+
+	for (i = 0; i < n; i += GB__LANE_COUNT) {
+		gb__Lanes cx = gb__lanes_load(in[0]+i);
+		gb__Lanes cy = gb__lanes_load(in[1]+i);
+		gb__Lanes cz = gb__lanes_load(in[2]+i);
+		gb__Lanes hx = gb__lanes_load(in[3]+i), hy = hx, hz = hx;
+		gb__LaneMask outside;
+		gb_math_u32 bits;
+		int l;
+		if (!spheres) {
+			hy = gb__lanes_load(in[4]+i);
+			hz = gb__lanes_load(in[5]+i);
+		}
+
+		for (k = 0; k < 6; k++) {
+			/* NOTE(bill): Outside when dot(n, centre) + d + (the box's (or sphere's) extent along n) < 0 */
+			gb__Lanes dist = gb__lanes_add(gb__lanes_add(gb__lanes_mul(pn[k][0], cx), gb__lanes_mul(pn[k][1], cy)),
+			                               gb__lanes_add(gb__lanes_mul(pn[k][2], cz), pd[k]));
+			gb__Lanes r = hx;
+			gb__LaneMask m;
+			if (!spheres) {
+				r = gb__lanes_add(gb__lanes_add(gb__lanes_mul(pa[k][0], hx), gb__lanes_mul(pa[k][1], hy)),
+				                  gb__lanes_mul(pa[k][2], hz));
+			}
+			m = gb__lanes_less(gb__lanes_add(dist, r), zero);
+			outside = k == 0 ? m : gb__lanes_or(outside, m);
+		}
+
+		bits = ~(gb_math_u32)gb__lanes_bits(outside) & ((1u << GB__LANE_COUNT) - 1u);
+		if (i + GB__LANE_COUNT > valid)
+			bits &= (1u << (valid - i)) - 1u;
+
+		if (visible_bits) {
+			size_t j = base + i;
+			if (j % 32 == 0)
+				visible_bits[j/32] = 0;
+			visible_bits[j/32] |= bits << (j % 32);
+		}
+		for (l = 0; bits != 0 && l < GB__LANE_COUNT && i+l < valid; l++) {
+			gb_math_u32 b = (bits >> l) & 1u;
+			if (visible_indices)
+				visible_indices[visible] = (gb_math_u32)(base + i + l);
+			visible += b;
+		}
+	}
+	return visible;
+}
+
+static size_t gb__frustum_cull_soa(gbFrustum const *f, float const *const *in, int in_count, size_t count,
+                                   gb_math_u32 *visible_bits, gb_math_u32 *visible_indices) {
+	float tail[6][GB__LANE_COUNT];
+	float const *t[6];
+	size_t body = count - count%GB__LANE_COUNT;
+	size_t visible = 0, j;
+	int k;
+
+	visible = gb__frustum_cull(f, in, in_count == 4, 0, body, body, visible_bits, visible_indices, visible);
+	if (body < count) {
+		for (k = 0; k < in_count; k++) {
+			for (j = 0; j < GB__LANE_COUNT; j++)
+				tail[k][j] = body+j < count ? in[k][body+j] : 0.0f;
+			t[k] = tail[k];
+		}
+		visible = gb__frustum_cull(f, t, in_count == 4, body, GB__LANE_COUNT, count-body, visible_bits, visible_indices, visible);
+	}
+	return visible;
+}
+
+static size_t gb__frustum_cull_aos(gbFrustum const *f, float const *in, int width, size_t count,
+                                   gb_math_u32 *visible_bits, gb_math_u32 *visible_indices) {
+	float src[6][GB__BATCH_BLOCK];
+	float *s[6];
+	size_t base, n, j, visible = 0;
+	int k;
+
+	for (k = 0; k < 6; k++) s[k] = src[k];
+
+	for (base = 0; base < count; base += n) {
+		size_t padded;
+		n = count - base;
+		if (n > GB__BATCH_BLOCK) n = GB__BATCH_BLOCK;
+		padded = (n + GB__LANE_COUNT-1) / GB__LANE_COUNT * GB__LANE_COUNT;
+
+		if (width == 6) {
+			/* NOTE(bill): The centres & half sizes are each a vec3 at a stride of two */
+			for (j = 0; j < n; j++) {
+				float const *p = in + (base+j)*6;
+				src[0][j] = p[0]; src[1][j] = p[1]; src[2][j] = p[2];
+				src[3][j] = p[3]; src[4][j] = p[4]; src[5][j] = p[5];
+			}
+		} else {
+			gb__deinterleave(s, in + base*width, width, n);
+		}
+		for (k = 0; k < width; k++) {
+			for (j = n; j < padded; j++)
+				src[k][j] = 0.0f;
+		}
+
+		visible = gb__frustum_cull(f, (float const *const *)s, width == 4, base, padded, n, visible_bits, visible_indices, visible);
+	}
+	return visible;
+}
+
+size_t gb_frustum_cull_aabbs(gbFrustum const *f, gbAabb3 const *boxes, size_t count, gb_math_u32 *visible_bits, gb_math_u32 *visible_indices) {
+	return gb__frustum_cull_aos(f, (float const *)boxes, 6, count, visible_bits, visible_indices);
+}
+
+size_t gb_frustum_cull_spheres(gbFrustum const *f, gbSphere const *spheres, size_t count, gb_math_u32 *visible_bits, gb_math_u32 *visible_indices) {
+	return gb__frustum_cull_aos(f, (float const *)spheres, 4, count, visible_bits, visible_indices);
+}
+
+size_t gb_frustum_cull_aabbs_soa(gbFrustum const *f, gbVec3SoA centres, gbVec3SoA half_sizes, size_t count, gb_math_u32 *visible_bits, gb_math_u32 *visible_indices) {
+	float const *in[6];
+	in[0] = centres.x;    in[1] = centres.y;    in[2] = centres.z;
+	in[3] = half_sizes.x; in[4] = half_sizes.y; in[5] = half_sizes.z;
+	return gb__frustum_cull_soa(f, in, 6, count, visible_bits, visible_indices);
+}
+
+size_t gb_frustum_cull_spheres_soa(gbFrustum const *f, gbVec3SoA centres, float const *radii, size_t count, gb_math_u32 *visible_bits, gb_math_u32 *visible_indices) {
+	float const *in[4];
+	in[0] = centres.x; in[1] = centres.y; in[2] = centres.z;
+	in[3] = radii;
+	return gb__frustum_cull_soa(f, in, 4, count, visible_bits, visible_indices);
+}
+
+
+
 #if defined(_WIN64) || defined(__x86_64__) || defined(__ppc64__)
 	gb_math_u64 gb_hash_murmur64(void const *key, size_t num_bytes, gb_math_u64 seed) {
 		gb_math_u64 const m = 0xc6a4a7935bd1e995ULL;
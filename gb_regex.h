@@ -1,4 +1,4 @@
-/* gb_regex.h - v0.01d - Regular Expressions Library - public domain
+/* gb_regex.h - v0.03  - Regular Expressions Library - public domain
                        - no warranty implied; use at your own risk
 
 	This is a single header file with a bunch of useful stuff
@@ -20,6 +20,8 @@
 
 
 Version History:
+	0.03  - Literal prefilter, gbre_find_all, iterators and streams
+	0.02  - Linear time matching (lazy DFA & Pike VM), alternation fixes
 	0.01d - Change brace style because why not?
 	0.01c - Capture length fix and little more documentation
 	0.01b - Code readjustment
@@ -71,6 +73,35 @@ NOTES
 		\v      - Vertical Tab
 		\f      - Form feed
 
+	Matching:
+		gbre_match runs in time linear in the length of the text whatever the
+		pattern. gbre_compile also builds a matching machine (freed by
+		gbre_destroy) which a match never changes, so a compiled gbRegex may be
+		matched on any number of threads at once. A lazy DFA answers whether
+		there is a match at all, a Pike VM then finds the captures. With
+		GBRE_NO_MALLOC the original backtracking matcher is used instead.
+
+		The working memory of a match, and the DFA states it has built, is a
+		gbreScratch. gbre_match makes one for each call; to keep the DFA between
+		matches make one per thread with gbre_scratch_make and use
+		gbre_match_scratch (or set gbreIter.scratch).
+
+		GBRE_DFA_MAX_STATES - DFA states to cache before starting again (default 128)
+
+		gbre_compile looks for a run of bytes every match must contain and for
+		one every match must start with. A search first checks the text holds
+		the former and jumps between occurrences of the latter with memchr, so
+		a pattern like "GET /api/\w+" costs little more than memchr on "G".
+
+	Finding more than one match:
+		gbre_iter_next and gbre_find_all step through the leftmost matches one
+		after another, resuming where the last one ended (an empty match moves
+		on one byte), so a large buffer is only ever scanned once.
+
+		gbreStream runs the DFA over a text given in chunks (e.g. read from a
+		file) and reports where the first match ends. Captures cannot be found
+		this way as nothing before the current chunk is kept.
+
 TODO
 	{m,n}       - Ranges
 	(?:)        - Non capturing groups
@@ -125,11 +156,23 @@ typedef int       gbreBool;
 #define GBRE_TRUE  (0 == 0)
 #define GBRE_FALSE (0 != 0)
 
+#ifndef GBRE_DFA_MAX_STATES
+#define GBRE_DFA_MAX_STATES 128
+#endif
+
+typedef struct gbreMachine gbreMachine; /* NOTE(bill): Built by gbre_compile, read only after that */
+typedef struct gbreScratch gbreScratch; /* NOTE(bill): Working memory for matching on one thread */
+
 typedef struct gbRegex {
 	isize capture_count;
 	unsigned char *buf;
 	isize          buf_len, buf_cap;
 	gbreBool       can_realloc;
+	gbreMachine   *machine;
+
+	/* NOTE(bill): Offsets into `buf` of bytes every match starts with/contains, found by gbre_compile */
+	isize          prefix, prefix_len;
+	isize          literal, literal_len;
 } gbRegex;
 
 typedef struct gbreCapture {
@@ -137,6 +180,23 @@ typedef struct gbreCapture {
 	isize len;
 } gbreCapture;
 
+typedef struct gbreIter {
+	gbRegex     *re;
+	gbreScratch *scratch; /* NOTE(bill): NULL after gbre_iter_init, set it to keep the DFA between matches */
+	char const  *str;
+	isize        str_len;
+	isize        offset; /* NOTE(bill): Where the next search starts */
+	gbreCapture  match;  /* NOTE(bill): The whole of the last match */
+} gbreIter;
+
+typedef struct gbreStream {
+	gbRegex     *re;
+	gbreScratch *scratch; /* NOTE(bill): Its own, so nothing else can flush its DFA state */
+	isize        offset;    /* NOTE(bill): Bytes fed so far */
+	isize        match_end; /* NOTE(bill): Offset just past the first match to end, -1 until then */
+	int          state;
+} gbreStream;
+
 typedef enum gbreError {
 	GBRE_ERROR_NONE,
 	GBRE_ERROR_NO_MATCH,
@@ -156,8 +216,33 @@ GBRE_DEF gbreError gbre_compile_from_buffer(gbRegex *re, char const *pattern, is
 GBRE_DEF void      gbre_destroy            (gbRegex *re);
 
 GBRE_DEF isize     gbre_capture_count      (gbRegex *re); /* TODO(bill): Should this be a function or just get the "raw" variable? */
+/* NOTE(bill): Captures which took no part in the match are set to {NULL, 0} */
 GBRE_DEF gbreBool  gbre_match              (gbRegex *re, char const *str, isize str_len, gbreCapture *captures, isize max_capture_count);
 
+/* NOTE(bill): A scratch belongs to one gbRegex and may only be used by one thread at a time. It is
+ * NULL if the regex has no machine, and a NULL scratch is the same as gbre_match */
+#if !defined(GBRE_NO_MALLOC)
+GBRE_DEF gbreScratch *gbre_scratch_make    (gbRegex *re);
+GBRE_DEF void         gbre_scratch_free    (gbreScratch *scratch);
+#endif
+GBRE_DEF gbreBool  gbre_match_scratch      (gbRegex *re, gbreScratch *scratch, char const *str, isize str_len, gbreCapture *captures, isize max_capture_count);
+
+/* NOTE(bill): Every match from left to right without overlapping. Returns the number of matches
+ * found, of which only the first `max_match_count` are stored */
+GBRE_DEF isize     gbre_find_all           (gbRegex *re, char const *str, isize str_len, gbreCapture *matches, isize max_match_count);
+
+GBRE_DEF void      gbre_iter_init          (gbreIter *it, gbRegex *re, char const *str, isize str_len);
+GBRE_DEF gbreBool  gbre_iter_next          (gbreIter *it, gbreCapture *captures, isize max_capture_count);
+
+/* NOTE(bill): gbre_stream_feed returns true once a match has been seen, the rest is then ignored.
+ * gbre_stream_finish must be called after the last chunk for $ to match. */
+#if !defined(GBRE_NO_MALLOC)
+GBRE_DEF gbreBool  gbre_stream_init        (gbreStream *s, gbRegex *re);
+GBRE_DEF gbreBool  gbre_stream_feed        (gbreStream *s, char const *chunk, isize chunk_len);
+GBRE_DEF gbreBool  gbre_stream_finish      (gbreStream *s);
+GBRE_DEF void      gbre_stream_destroy     (gbreStream *s);
+#endif
+
 
 #if defined(__cplusplus)
 }
@@ -337,6 +422,11 @@ static gbreBool gbre__match_escape(char c, int code) {
 }
 
 
+/* NOTE(bill): No match & failures have negative offsets */
+static gbreBool gbre__context_ok(gbreContext c, isize str_len) {
+	return c.offset >= 0 && c.offset <= str_len;
+}
+
 static gbreContext gbre__consume(gbRegex *re, isize op, char const *str, isize str_len, isize offset,
                                  gbreCapture *captures, isize max_capture_count,
                                  gbreBool is_greedy) {
@@ -352,11 +442,11 @@ static gbreContext gbre__consume(gbRegex *re, isize op, char const *str, isize s
 
 	for (;;) {
 		c = gbre__exec_single(re, op, str, str_len, c.offset, 0, 0);
-		if (c.offset > str_len) break;
+		if (!gbre__context_ok(c, str_len)) break;
 		if (c.op >= re->buf_len) return c;
 
 		next_c = gbre__exec(re, c.op, str, str_len, c.offset, 0, 0);
-		if (next_c.offset <= str_len) {
+		if (gbre__context_ok(next_c, str_len)) {
 			if (captures)
 				gbre__exec(re, c.op, str, str_len, c.offset, captures, max_capture_count);
 			best_c = next_c;
@@ -364,7 +454,7 @@ static gbreContext gbre__consume(gbRegex *re, isize op, char const *str, isize s
 		}
 	}
 
-	if (best_c.op > re->buf_len)
+	if (best_c.op < 0 || best_c.op > re->buf_len)
 		best_c.op = c.op;
 
 	return best_c;
@@ -404,7 +494,7 @@ static gbreContext gbre__exec_single(gbRegex *re, isize op, char const *str, isi
 	case GBRE_OP_BRANCH_START: {
 		skip = re->buf[op++];
 		context = gbre__exec(re, op, str, str_len, offset, captures, max_capture_count);
-		if (context.offset <= str_len) {
+		if (gbre__context_ok(context, str_len)) {
 			offset = context.offset;
 			op = context.op;
 		} else {
@@ -429,11 +519,12 @@ static gbreContext gbre__exec_single(gbRegex *re, isize op, char const *str, isi
 
 	case GBRE_OP_ANY_OF: {
 		isize i;
-		char cin = str[offset];
+		char cin;
 		buffer_len = re->buf[op++];
 
 		if (offset >= str_len)
 			return gbre__context_no_match(op + buffer_len);
+		cin = str[offset];
 
 		for (i = 0; i < buffer_len; i++) {
 			char cmatch = (char)re->buf[op+i];
@@ -455,11 +546,12 @@ static gbreContext gbre__exec_single(gbRegex *re, isize op, char const *str, isi
 
 	case GBRE_OP_ANY_BUT: {
 		isize i;
-		char cin = str[offset];
+		char cin;
 		buffer_len = re->buf[op++];
 
 		if (offset >= str_len)
 			return gbre__context_no_match(op + buffer_len);
+		cin = str[offset];
 
 		for (i = 0; i < buffer_len; i++) {
 			char cmatch = (char)re->buf[op + i];
@@ -487,7 +579,10 @@ static gbreContext gbre__exec_single(gbRegex *re, isize op, char const *str, isi
 
 	case GBRE_OP_META_MATCH: {
 		char cin = (char)re->buf[op++];
-		char cmatch = str[offset++];
+		char cmatch;
+		if (offset >= str_len)
+			return gbre__context_no_match(op + (cin ? 0 : 1));
+		cmatch = str[offset++];
 		if (!cin) {
 			if (gbre__match_escape(cmatch, re->buf[op++] << 8))
 				break;
@@ -505,7 +600,7 @@ static gbreContext gbre__exec_single(gbRegex *re, isize op, char const *str, isi
 
 	case GBRE_OP_ONE_OR_MORE: {
 		context = gbre__exec_single(re, op, str, str_len, offset, captures, max_capture_count);
-		if (context.offset > str_len)
+		if (!gbre__context_ok(context, str_len))
 			return context;
 		context = gbre__consume(re, op, str, str_len, context.offset, captures, max_capture_count, GBRE_TRUE);
 		offset = context.offset;
@@ -520,7 +615,7 @@ static gbreContext gbre__exec_single(gbRegex *re, isize op, char const *str, isi
 
 	case GBRE_OP_ONE_OR_MORE_SHORTEST: {
 		context = gbre__exec_single(re, op, str, str_len, offset, captures, max_capture_count);
-		if (context.offset > str_len)
+		if (!gbre__context_ok(context, str_len))
 			return context;
 		context = gbre__consume(re, op, str, str_len, context.offset, captures, max_capture_count, GBRE_FALSE);
 		offset = context.offset;
@@ -529,10 +624,10 @@ static gbreContext gbre__exec_single(gbRegex *re, isize op, char const *str, isi
 
 	case GBRE_OP_ZERO_OR_ONE: {
 		context = gbre__exec_single(re, op, str, str_len, offset, captures, max_capture_count);
-		if (context.offset <= str_len) {
+		if (gbre__context_ok(context, str_len)) {
 			gbreContext maybe_context = gbre__exec(re, context.op, str, str_len, context.offset,
 			                                       captures, max_capture_count);
-			if (maybe_context.offset <= str_len) {
+			if (gbre__context_ok(maybe_context, str_len)) {
 				op = maybe_context.op;
 				offset = maybe_context.offset;
 				break;
@@ -541,7 +636,7 @@ static gbreContext gbre__exec_single(gbRegex *re, isize op, char const *str, isi
 
 		next_op = context.op;
 		context = gbre__exec(re, next_op, str, str_len, offset, captures, max_capture_count);
-		if (context.offset <= str_len) {
+		if (gbre__context_ok(context, str_len)) {
 			op = context.op;
 			offset = context.offset;
 			break;
@@ -568,7 +663,7 @@ static gbreContext gbre__exec(gbRegex *re, isize op, char const *str, isize str_
 	c.offset = offset;
 	while (c.op < re->buf_len) {
 		c = gbre__exec_single(re, c.op, str, str_len, c.offset, captures, max_capture_count);
-		if (c.offset > str_len)
+		if (!gbre__context_ok(c, str_len))
 			break;
 	}
 
@@ -589,7 +684,7 @@ static gbreError gbre__emit_ops(gbRegex *re, isize op_count, ...) {
 			re->buf = (unsigned char *)GBRE_REALLOC(re->buf, new_cap);
 			re->buf_cap = new_cap;
 #else
-#error GBRE_NO_MALLOC defined
+			return GBRE_ERROR_TOO_LONG;
 #endif
 		}
 	}
@@ -618,7 +713,7 @@ static gbreError gbre__emit_ops_buffer(gbRegex *re, isize op_count, unsigned cha
 			re->buf = (unsigned char *)GBRE_REALLOC(re->buf, new_cap);
 			re->buf_cap = new_cap;
 #else
-#error GBRE_NO_MALLOC defined
+			return GBRE_ERROR_TOO_LONG;
 #endif
 		}
 	}
@@ -746,6 +841,17 @@ static gbreError gbre__compile_quantifier(gbRegex *re, isize last_buf_len, unsig
 }
 
 
+/* NOTE(bill): Branch skips are a single byte */
+static gbreError gbre__patch_branch(gbRegex *re, isize branch_op) {
+	if (branch_op != -1) {
+		isize skip = re->buf_len - (branch_op+2);
+		if (skip > 0xff)
+			return GBRE_ERROR_TOO_LONG;
+		re->buf[branch_op + 1] = (unsigned char)skip;
+	}
+	return GBRE_ERROR_NONE;
+}
+
 static gbreError gbre__parse(gbRegex *re, char const *pattern, isize len, isize offset, isize level, isize *new_offset) {
 	gbreError err = GBRE_ERROR_NONE;
 	isize last_buf_len = re->buf_len;
@@ -780,8 +886,8 @@ static gbreError gbre__parse(gbRegex *re, char const *pattern, isize len, isize
 		} break;
 
 		case ')': {
-			if (branch_op != -1)
-				re->buf[branch_op + 1] = (unsigned char)(re->buf_len - (branch_op+2));
+			err = gbre__patch_branch(re, branch_op);
+			if (err) return err;
 
 			if (level == 0)
 				return GBRE_ERROR_MISMATCHED_CAPTURES;
@@ -801,7 +907,13 @@ static gbreError gbre__parse(gbRegex *re, char const *pattern, isize len, isize
 			if (branch_begin >= re->buf_len) {
 				return GBRE_ERROR_BRANCH_FAILURE;
 			} else {
-				isize size = re->buf_len - branch_begin;
+				isize size;
+				/* NOTE(bill): The last branch ends here, it is wrapped along with the rest */
+				err = gbre__patch_branch(re, branch_op);
+				if (err) return err;
+				size = re->buf_len - branch_begin;
+				if (size+2 > 0xff)
+					return GBRE_ERROR_TOO_LONG;
 				err = gbre__emit_ops(re, 4, 0, 0, GBRE_OP_BRANCH_END, 0);
 				if (err) return err;
 
@@ -832,9 +944,10 @@ static gbreError gbre__parse(gbRegex *re, char const *pattern, isize len, isize
 				return GBRE_ERROR_INVALID_QUANTIFIER;
 
 			if ((offset < len) && (pattern[offset] == '?')) {
-				quantifier = GBRE_OP_ONE_OR_MORE_SHORTEST;
 				if (quantifier == GBRE_OP_ZERO_OR_MORE)
 					quantifier = GBRE_OP_ZERO_OR_MORE_SHORTEST;
+				else
+					quantifier = GBRE_OP_ONE_OR_MORE_SHORTEST;
 				offset++;
 			}
 
@@ -893,10 +1006,909 @@ static gbreError gbre__parse(gbRegex *re, char const *pattern, isize len, isize
 		}
 	}
 
+	err = gbre__patch_branch(re, branch_op);
+	if (err) return err;
+
 	if (new_offset) *new_offset = offset;
 	return GBRE_ERROR_NONE;
 }
 
+/****************************************************************
+ * NOTE(bill): Matching Machine
+ *
+ * The bytecode is translated into a Thompson NFA (the `re->buf` ops stay as the
+ * compiled form). Yes/no questions are answered by a DFA built lazily from it, a
+ * state for each set of NFA threads actually reached, with its transitions cached
+ * as they are taken. Captures come from a Pike VM over the same program, which
+ * runs every thread in lock step with its own capture slots.
+ * Both are O(pattern * text) at worst and neither recurses.
+ ***************************************************************/
+
+typedef enum gbreInstKind {
+	GBRE_INST_MATCH,
+	GBRE_INST_BYTE,
+	GBRE_INST_CLASS,
+	GBRE_INST_SPLIT, /* NOTE(bill): x is preferred over y */
+	GBRE_INST_JUMP,
+	GBRE_INST_SAVE,
+	GBRE_INST_BEGINNING_OF_LINE,
+	GBRE_INST_END_OF_LINE
+} gbreInstKind;
+
+typedef struct gbreInst {
+	int kind;
+	int x, y; /* NOTE(bill): Byte, class index, capture slot or targets */
+} gbreInst;
+
+typedef struct gbreSparseSet {
+	int *sparse, *dense;
+	int  count;
+} gbreSparseSet;
+
+typedef struct gbreStackEntry {
+	int   pc;
+	int   slot; /* NOTE(bill): >= 0 to restore `value` into that slot instead */
+	isize value;
+} gbreStackEntry;
+
+typedef struct gbreDfaState {
+	int next[256]; /* NOTE(bill): -1 until the transition is first taken */
+	int pc_offset, pc_count;
+	int flags;
+	unsigned int hash;
+} gbreDfaState;
+
+enum {
+	GBRE__DFA_MATCH       = 1,
+	GBRE__DFA_END_OF_LINE = 2, /* NOTE(bill): Has threads waiting on $ */
+	GBRE__DFA_START       = 4  /* NOTE(bill): Nothing but a new thread, the prefix can be skipped to */
+};
+
+/* NOTE(bill): `re->machine` only has the program (up to `empty_slots` and the prefix). A scratch
+ * is a copy of it, sharing the program, with the rest as its own working memory. */
+struct gbreMachine {
+	gbreInst      *insts;
+	int            inst_count;
+	unsigned char *classes; /* NOTE(bill): 256 bits each */
+	int            slot_count; /* NOTE(bill): 0 & 1 are the whole match, then 2 for each capture */
+
+	/* NOTE(bill): Pike VM */
+	gbreSparseSet   lists[2];
+	isize          *list_slots[2];
+	isize          *slots, *empty_slots, *match_slots;
+	gbreStackEntry *stack;
+
+	/* NOTE(bill): Lazy DFA, allocated the first time a scratch needs it */
+	gbreSparseSet  set;
+	int           *temp;
+	gbreDfaState  *states;
+	int            state_count, reset_count;
+	int           *pcs;
+	int            pc_count, pc_cap;
+	int           *table, table_mask;
+	gbreBool       search_can_die;
+	int           *start_pcs, start_count; /* NOTE(bill): The state when no thread is alive yet */
+
+	/* NOTE(bill): Bytes every match starts with, from `re->buf` */
+	unsigned char const *prefix;
+	isize                prefix_len, prefix_rare;
+};
+
+struct gbreScratch {
+	gbreMachine machine;
+};
+
+
+static gbreBool gbre__set_has(gbreSparseSet *s, int pc) {
+	int i = s->sparse[pc];
+	return i < s->count && s->dense[i] == pc;
+}
+
+static int gbre__set_add(gbreSparseSet *s, int pc) {
+	s->sparse[pc] = s->count;
+	s->dense[s->count] = pc;
+	return s->count++;
+}
+
+static gbreBool gbre__class_has(gbreMachine *m, int class_index, unsigned char c) {
+	return (m->classes[class_index*32 + (c >> 3)] >> (c & 7)) & 1;
+}
+
+#if !defined(GBRE_NO_MALLOC)
+static void *gbre__carve(unsigned char **cursor, isize size) {
+	void *ptr = *cursor;
+	*cursor += (size + 15) & ~(isize)15;
+	return ptr;
+}
+#endif
+
+/* NOTE(bill): Size of an op and how many instructions it becomes, 0 if it is not valid */
+static isize gbre__op_size(gbRegex *re, isize op, int *inst_count) {
+	unsigned char const *b = re->buf + op;
+	isize size = 0, left = re->buf_len - op;
+	int count = 1;
+
+	switch (b[0]) {
+	case GBRE_OP_BEGIN_CAPTURE:
+	case GBRE_OP_END_CAPTURE:
+	case GBRE_OP_BRANCH_START:
+	case GBRE_OP_BRANCH_END:
+		size = 2;
+		break;
+
+	case GBRE_OP_BEGINNING_OF_LINE:
+	case GBRE_OP_END_OF_LINE:
+	case GBRE_OP_ANY:
+		size = 1;
+		break;
+
+	case GBRE_OP_EXACT_MATCH:
+		if (left < 2) return 0;
+		size = 2 + b[1];
+		count = b[1];
+		break;
+
+	case GBRE_OP_META_MATCH:
+		if (left < 2) return 0;
+		size = b[1] ? 2 : 3;
+		break;
+
+	case GBRE_OP_ANY_OF:
+	case GBRE_OP_ANY_BUT:
+		if (left < 2) return 0;
+		size = 2 + b[1];
+		break;
+
+	case GBRE_OP_ZERO_OR_MORE:
+	case GBRE_OP_ZERO_OR_MORE_SHORTEST:
+	case GBRE_OP_ONE_OR_MORE:
+	case GBRE_OP_ONE_OR_MORE_SHORTEST:
+	case GBRE_OP_ZERO_OR_ONE:
+		if (left < 2 || b[1] < GBRE_OP_EXACT_MATCH || b[1] > GBRE_OP_ANY_BUT)
+			return 0;
+		size = 1 + gbre__op_size(re, op+1, &count);
+		if (size == 1) return 0;
+		count += (b[0] == GBRE_OP_ZERO_OR_MORE || b[0] == GBRE_OP_ZERO_OR_MORE_SHORTEST) ? 2 : 1;
+		break;
+
+	default:
+		return 0;
+	}
+
+	if (size > left) return 0;
+	if (inst_count) *inst_count = count;
+	return size;
+}
+
+
+/* NOTE(bill): Lower case letters & spaces are the most common bytes in text, punctuation the least */
+static isize gbre__rare_byte(unsigned char const *lit, isize len) {
+	isize i, best = 0;
+	int best_rank = 4;
+	for (i = 0; i < len; i++) {
+		unsigned char c = lit[i];
+		int rank = 1;
+		if ((c >= 'a' && c <= 'z') || c == ' ')
+			rank = 3;
+		else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '\t' || c == '\n' || c == '\r')
+			rank = 2;
+		if (rank < best_rank) {
+			best_rank = rank;
+			best = i;
+		}
+	}
+	return best;
+}
+
+/* NOTE(bill): First offset at or after `from` where `lit` appears, -1 if it does not. The
+ * rare byte is found with memchr then the rest is compared. */
+static isize gbre__memmem(char const *str, isize from, isize len, unsigned char const *lit, isize lit_len, isize rare) {
+	isize at = from + rare, last = len - lit_len + rare;
+	while (at <= last) {
+		char const *p = (char const *)memchr(str + at, lit[rare], (size_t)(last - at + 1));
+		if (!p)
+			break;
+		at = p - str;
+		if (memcmp(p - rare, lit, (size_t)lit_len) == 0)
+			return at - rare;
+		at++;
+	}
+	return -1;
+}
+
+/* NOTE(bill): Anything inside a branch or under a quantifier is optional, the longest exact
+ * match outside of those is in every match. It is also a prefix when only zero width ops
+ * come before it. */
+static void gbre__find_literals(gbRegex *re) {
+	isize op, size, optional_end = 0;
+	gbreBool at_start = GBRE_TRUE;
+
+	re->prefix = re->prefix_len = 0;
+	re->literal = re->literal_len = 0;
+
+	for (op = 0; op < re->buf_len; op += size) {
+		unsigned char const *b = re->buf + op;
+		size = gbre__op_size(re, op, NULL);
+		if (size == 0) {
+			re->prefix_len = re->literal_len = 0;
+			return;
+		}
+
+		if (b[0] == GBRE_OP_BRANCH_START) {
+			/* NOTE(bill): The first alternative ends with a BRANCH_END skipping the second */
+			isize branch_end = op + b[1], end = re->buf_len;
+			if (branch_end+1 < re->buf_len && re->buf[branch_end] == GBRE_OP_BRANCH_END)
+				end = branch_end + 2 + re->buf[branch_end+1];
+			if (end > optional_end)
+				optional_end = end;
+		}
+		if (op < optional_end) {
+			at_start = GBRE_FALSE;
+			continue;
+		}
+
+		switch (b[0]) {
+		case GBRE_OP_BEGIN_CAPTURE:
+		case GBRE_OP_END_CAPTURE:
+		case GBRE_OP_BEGINNING_OF_LINE:
+			break;
+
+		case GBRE_OP_EXACT_MATCH:
+			if (b[1] > re->literal_len) {
+				re->literal     = op+2;
+				re->literal_len = b[1];
+			}
+			if (at_start && b[1] > 0) {
+				re->prefix     = op+2;
+				re->prefix_len = b[1];
+			}
+			at_start = GBRE_FALSE;
+			break;
+
+		default:
+			at_start = GBRE_FALSE;
+			break;
+		}
+	}
+}
+
+#if !defined(GBRE_NO_MALLOC)
+static void gbre__emit_class(gbreMachine *m, int *pc, int *class_count, unsigned char const *b) {
+	unsigned char *bits = m->classes + (*class_count)*32;
+	int c;
+	memset(bits, 0, 32);
+
+	if (b[0] == GBRE_OP_ANY) {
+		memset(bits, 0xff, 32);
+	} else if (b[0] == GBRE_OP_META_MATCH) {
+		for (c = 0; c < 256; c++) {
+			if (gbre__match_escape((char)c, b[2] << 8))
+				bits[c >> 3] |= (unsigned char)(1 << (c & 7));
+		}
+	} else {
+		isize i, len = b[1];
+		for (i = 0; i < len; i++) {
+			unsigned char cmatch = b[2+i];
+			if (!cmatch && i+1 < len) {
+				int code = b[2 + ++i] << 8;
+				for (c = 0; c < 256; c++) {
+					if (gbre__match_escape((char)c, code))
+						bits[c >> 3] |= (unsigned char)(1 << (c & 7));
+				}
+			} else {
+				bits[cmatch >> 3] |= (unsigned char)(1 << (cmatch & 7));
+			}
+		}
+		if (b[0] == GBRE_OP_ANY_BUT) {
+			for (c = 0; c < 32; c++)
+				bits[c] = (unsigned char)~bits[c];
+		}
+	}
+
+	m->insts[*pc].kind = GBRE_INST_CLASS;
+	m->insts[*pc].x = (*class_count)++;
+	(*pc)++;
+}
+
+static void gbre__emit_atom(gbreMachine *m, int *pc, int *class_count, unsigned char const *b) {
+	if (b[0] == GBRE_OP_EXACT_MATCH) {
+		int i;
+		for (i = 0; i < b[1]; i++) {
+			m->insts[*pc].kind = GBRE_INST_BYTE;
+			m->insts[*pc].x = b[2+i];
+			(*pc)++;
+		}
+	} else if (b[0] == GBRE_OP_META_MATCH && b[1]) {
+		m->insts[*pc].kind = GBRE_INST_BYTE;
+		m->insts[*pc].x = b[1];
+		(*pc)++;
+	} else {
+		gbre__emit_class(m, pc, class_count, b);
+	}
+}
+
+static void gbre__emit_inst(gbreMachine *m, int pc, int kind, int x, int y) {
+	m->insts[pc].kind = kind;
+	m->insts[pc].x = x;
+	m->insts[pc].y = y;
+}
+#endif /* !defined(GBRE_NO_MALLOC) */
+
+static gbreMachine *gbre__machine_make(gbRegex *re) {
+#if !defined(GBRE_NO_MALLOC)
+	gbreMachine *m;
+	int *map, inst_count = 1, class_count = 0, slot_count = 2 + 2*(int)re->capture_count, pc, i;
+	isize op, size, total;
+	unsigned char *cursor;
+
+	/* NOTE(bill): First pass, where each op starts in the program */
+	map = (int *)GBRE_MALLOC((re->buf_len+1) * gbre_size_of(int));
+	if (!map) return NULL;
+	for (op = 0; op <= re->buf_len; op++)
+		map[op] = -1;
+	for (op = 0; op < re->buf_len; op += size) {
+		int count = 0;
+		unsigned char kind;
+		size = gbre__op_size(re, op, &count);
+		if (size == 0) {
+			GBRE_FREE(map);
+			return NULL;
+		}
+		kind = re->buf[op];
+		if (kind >= GBRE_OP_ZERO_OR_MORE && kind <= GBRE_OP_ZERO_OR_ONE)
+			kind = re->buf[op+1];
+		if (kind >= GBRE_OP_META_MATCH && kind <= GBRE_OP_ANY_BUT)
+			class_count++;
+		map[op] = inst_count;
+		inst_count += count;
+	}
+	map[re->buf_len] = inst_count;
+	inst_count += 2;
+
+	total = gbre_size_of(gbreMachine) + 16*4
+	      + inst_count * gbre_size_of(gbreInst)
+	      + class_count * 32
+	      + slot_count * gbre_size_of(isize);
+	cursor = (unsigned char *)GBRE_MALLOC(total);
+	if (!cursor) {
+		GBRE_FREE(map);
+		return NULL;
+	}
+	memset(cursor, 0, total);
+
+	m = (gbreMachine *)gbre__carve(&cursor, gbre_size_of(gbreMachine));
+	m->inst_count        = inst_count;
+	m->slot_count        = slot_count;
+	m->insts             = (gbreInst *)gbre__carve(&cursor, inst_count * gbre_size_of(gbreInst));
+	m->classes           = (unsigned char *)gbre__carve(&cursor, class_count * 32);
+	m->empty_slots       = (isize *)gbre__carve(&cursor, slot_count * gbre_size_of(isize));
+	for (i = 0; i < slot_count; i++)
+		m->empty_slots[i] = -1;
+	if (re->prefix_len > 0) {
+		m->prefix      = re->buf + re->prefix;
+		m->prefix_len  = re->prefix_len;
+		m->prefix_rare = gbre__rare_byte(m->prefix, m->prefix_len);
+	}
+
+	/* NOTE(bill): Second pass, emit the program */
+	class_count = 0;
+	gbre__emit_inst(m, 0, GBRE_INST_SAVE, 0, 0);
+	for (op = 0; op < re->buf_len; op += size) {
+		unsigned char const *b = re->buf + op;
+		int count = 0, target;
+		size = gbre__op_size(re, op, &count);
+		pc = map[op];
+
+		switch (b[0]) {
+		case GBRE_OP_BEGIN_CAPTURE:
+		case GBRE_OP_END_CAPTURE:
+			if (b[1] >= re->capture_count)
+				goto invalid;
+			gbre__emit_inst(m, pc, GBRE_INST_SAVE, 2 + 2*b[1] + (b[0] == GBRE_OP_END_CAPTURE), 0);
+			break;
+
+		case GBRE_OP_BEGINNING_OF_LINE: gbre__emit_inst(m, pc, GBRE_INST_BEGINNING_OF_LINE, 0, 0); break;
+		case GBRE_OP_END_OF_LINE:       gbre__emit_inst(m, pc, GBRE_INST_END_OF_LINE, 0, 0);       break;
+
+		case GBRE_OP_BRANCH_START:
+		case GBRE_OP_BRANCH_END:
+			if (op + 2 + b[1] > re->buf_len || (target = map[op + 2 + b[1]]) < 0)
+				goto invalid;
+			if (b[0] == GBRE_OP_BRANCH_START)
+				gbre__emit_inst(m, pc, GBRE_INST_SPLIT, pc+1, target);
+			else
+				gbre__emit_inst(m, pc, GBRE_INST_JUMP, target, 0);
+			break;
+
+		case GBRE_OP_ZERO_OR_MORE:
+		case GBRE_OP_ZERO_OR_MORE_SHORTEST:
+			gbre__emit_inst(m, pc, GBRE_INST_SPLIT, pc+1, pc+count);
+			if (b[0] == GBRE_OP_ZERO_OR_MORE_SHORTEST)
+				gbre__emit_inst(m, pc, GBRE_INST_SPLIT, pc+count, pc+1);
+			target = pc+1;
+			gbre__emit_atom(m, &target, &class_count, b+1);
+			gbre__emit_inst(m, target, GBRE_INST_JUMP, pc, 0);
+			break;
+
+		case GBRE_OP_ONE_OR_MORE:
+		case GBRE_OP_ONE_OR_MORE_SHORTEST:
+			target = pc;
+			gbre__emit_atom(m, &target, &class_count, b+1);
+			if (b[0] == GBRE_OP_ONE_OR_MORE)
+				gbre__emit_inst(m, target, GBRE_INST_SPLIT, pc, target+1);
+			else
+				gbre__emit_inst(m, target, GBRE_INST_SPLIT, target+1, pc);
+			break;
+
+		case GBRE_OP_ZERO_OR_ONE:
+			gbre__emit_inst(m, pc, GBRE_INST_SPLIT, pc+1, pc+count);
+			target = pc+1;
+			gbre__emit_atom(m, &target, &class_count, b+1);
+			break;
+
+		default:
+			target = pc;
+			gbre__emit_atom(m, &target, &class_count, b);
+			break;
+		}
+	}
+	pc = map[re->buf_len];
+	gbre__emit_inst(m, pc,   GBRE_INST_SAVE, 1, 0);
+	gbre__emit_inst(m, pc+1, GBRE_INST_MATCH, 0, 0);
+
+	GBRE_FREE(map);
+	return m;
+
+invalid:
+	GBRE_FREE(map);
+	GBRE_FREE(m);
+	return NULL;
+#else
+	(void)re;
+	return NULL;
+#endif
+}
+
+static void gbre__machine_free(gbreMachine *m) {
+#if !defined(GBRE_NO_MALLOC)
+	if (m)
+		GBRE_FREE(m);
+#else
+	(void)m;
+#endif
+}
+
+#if !defined(GBRE_NO_MALLOC)
+static isize gbre__scratch_size(gbreMachine const *p) {
+	return gbre_size_of(gbreScratch) + 16*14
+	     + 8 * p->inst_count * gbre_size_of(int)
+	     + 2 * p->inst_count * p->slot_count * gbre_size_of(isize)
+	     + 2 * p->slot_count * gbre_size_of(isize)
+	     + (2*p->inst_count + 2) * gbre_size_of(gbreStackEntry);
+}
+
+/* NOTE(bill): `memory` must hold gbre__scratch_size bytes */
+static gbreScratch *gbre__scratch_init(gbreMachine const *p, void *memory) {
+	unsigned char *cursor = (unsigned char *)memory;
+	int inst_count = p->inst_count, slot_count = p->slot_count;
+	gbreScratch *s;
+	gbreMachine *m;
+
+	memset(memory, 0, gbre__scratch_size(p));
+	s = (gbreScratch *)gbre__carve(&cursor, gbre_size_of(gbreScratch));
+	m = &s->machine;
+	*m = *p;
+	m->lists[0].sparse   = (int *)gbre__carve(&cursor, inst_count * gbre_size_of(int));
+	m->lists[0].dense    = (int *)gbre__carve(&cursor, inst_count * gbre_size_of(int));
+	m->lists[1].sparse   = (int *)gbre__carve(&cursor, inst_count * gbre_size_of(int));
+	m->lists[1].dense    = (int *)gbre__carve(&cursor, inst_count * gbre_size_of(int));
+	m->list_slots[0]     = (isize *)gbre__carve(&cursor, inst_count * slot_count * gbre_size_of(isize));
+	m->list_slots[1]     = (isize *)gbre__carve(&cursor, inst_count * slot_count * gbre_size_of(isize));
+	m->slots             = (isize *)gbre__carve(&cursor, slot_count * gbre_size_of(isize));
+	m->match_slots       = (isize *)gbre__carve(&cursor, slot_count * gbre_size_of(isize));
+	m->stack             = (gbreStackEntry *)gbre__carve(&cursor, (2*inst_count + 2) * gbre_size_of(gbreStackEntry));
+	m->set.sparse        = (int *)gbre__carve(&cursor, inst_count * gbre_size_of(int));
+	m->set.dense         = (int *)gbre__carve(&cursor, inst_count * gbre_size_of(int));
+	m->temp              = (int *)gbre__carve(&cursor, inst_count * gbre_size_of(int));
+	m->start_pcs         = (int *)gbre__carve(&cursor, inst_count * gbre_size_of(int));
+	return s;
+}
+#endif /* !defined(GBRE_NO_MALLOC) */
+
+static gbreScratch *gbre__scratch_make(gbRegex *re) {
+#if !defined(GBRE_NO_MALLOC)
+	void *memory;
+	if (!re->machine)
+		return NULL;
+	memory = GBRE_MALLOC(gbre__scratch_size(re->machine));
+	if (!memory)
+		return NULL;
+	return gbre__scratch_init(re->machine, memory);
+#else
+	(void)re;
+	return NULL;
+#endif
+}
+
+/* NOTE(bill): Only the DFA states if the scratch is not from gbre__scratch_make */
+static void gbre__scratch_free(gbreScratch *s, gbreBool free_memory) {
+#if !defined(GBRE_NO_MALLOC)
+	if (s) {
+		if (s->machine.states)
+			GBRE_FREE(s->machine.states);
+		s->machine.states = NULL;
+		if (free_memory)
+			GBRE_FREE(s);
+	}
+#else
+	(void)s, (void)free_memory;
+#endif
+}
+
+
+/* NOTE(bill): Where the next match can start when no thread is alive, a prefix which is not in
+ * the text may still begin in its last few bytes (the end of a chunk) */
+static isize gbre__skip_to_prefix(gbreMachine *m, char const *str, isize offset, isize len) {
+	isize at = gbre__memmem(str, offset, len, m->prefix, m->prefix_len, m->prefix_rare);
+	if (at < 0)
+		at = len - m->prefix_len + 1;
+	return at > offset ? at : offset;
+}
+
+/* NOTE(bill): Adds the thread at `pc` and everything it reaches without consuming
+ * input, in priority order. Threads already in the list were added by a higher
+ * priority thread so they stay as they are. */
+static void gbre__pike_add(gbreMachine *m, int list, int pc, isize const *slots, isize offset, isize len) {
+	gbreSparseSet *set = &m->lists[list];
+	gbreStackEntry *stack = m->stack;
+	int sp = 0;
+
+	memcpy(m->slots, slots, m->slot_count * gbre_size_of(isize));
+	stack[sp].pc = pc;
+	stack[sp].slot = -1;
+	sp++;
+
+	while (sp > 0) {
+		gbreStackEntry e = stack[--sp];
+		gbreInst *inst;
+		int i;
+		if (e.slot >= 0) {
+			m->slots[e.slot] = e.value;
+			continue;
+		}
+		if (gbre__set_has(set, e.pc))
+			continue;
+
+		i = gbre__set_add(set, e.pc);
+		inst = &m->insts[e.pc];
+
+		switch (inst->kind) {
+		case GBRE_INST_JUMP:
+			stack[sp].pc = inst->x; stack[sp].slot = -1; sp++;
+			break;
+
+		case GBRE_INST_SPLIT:
+			stack[sp].pc = inst->y; stack[sp].slot = -1; sp++;
+			stack[sp].pc = inst->x; stack[sp].slot = -1; sp++;
+			break;
+
+		case GBRE_INST_SAVE:
+			stack[sp].slot = inst->x; stack[sp].value = m->slots[inst->x]; sp++;
+			m->slots[inst->x] = offset;
+			stack[sp].pc = e.pc+1; stack[sp].slot = -1; sp++;
+			break;
+
+		case GBRE_INST_BEGINNING_OF_LINE:
+			if (offset == 0) {
+				stack[sp].pc = e.pc+1; stack[sp].slot = -1; sp++;
+			}
+			break;
+
+		case GBRE_INST_END_OF_LINE:
+			if (offset == len) {
+				stack[sp].pc = e.pc+1; stack[sp].slot = -1; sp++;
+			}
+			break;
+
+		default:
+			memcpy(m->list_slots[list] + i*m->slot_count, m->slots, m->slot_count * gbre_size_of(isize));
+			break;
+		}
+	}
+}
+
+/* NOTE(bill): Leftmost match starting at or after `from`, with the same preferences as
+ * the backtracker. The slots go into `m->match_slots`. */
+static gbreBool gbre__pike_search(gbreMachine *m, char const *str, isize len, isize from) {
+	int clist = 0, nlist = 1;
+	gbreBool matched = GBRE_FALSE;
+	isize offset;
+
+	m->lists[0].count = 0;
+	m->lists[1].count = 0;
+
+	for (offset = from; ; offset++) {
+		int i, count;
+		if (!matched) {
+			if (m->prefix_len > 0 && m->lists[clist].count == 0)
+				offset = gbre__skip_to_prefix(m, str, offset, len);
+			gbre__pike_add(m, clist, 0, m->empty_slots, offset, len);
+		}
+
+		count = m->lists[clist].count;
+		if (count == 0)
+			break;
+
+		for (i = 0; i < count; i++) {
+			int pc = m->lists[clist].dense[i];
+			gbreInst *inst = &m->insts[pc];
+			isize *slots = m->list_slots[clist] + i*m->slot_count;
+
+			if (inst->kind == GBRE_INST_MATCH) {
+				/* NOTE(bill): Lower priority threads are cut off */
+				memcpy(m->match_slots, slots, m->slot_count * gbre_size_of(isize));
+				matched = GBRE_TRUE;
+				break;
+			}
+			if (offset < len) {
+				unsigned char c = (unsigned char)str[offset];
+				if ((inst->kind == GBRE_INST_BYTE  && inst->x == c) ||
+				    (inst->kind == GBRE_INST_CLASS && gbre__class_has(m, inst->x, c))) {
+					gbre__pike_add(m, nlist, pc+1, slots, offset+1, len);
+				}
+			}
+		}
+
+		if (offset >= len)
+			break;
+		clist ^= 1;
+		nlist ^= 1;
+		m->lists[nlist].count = 0;
+	}
+
+	return matched;
+}
+
+
+static void gbre__dfa_closure(gbreMachine *m, int pc, gbreBool at_beginning, gbreBool at_end) {
+	gbreStackEntry *stack = m->stack;
+	int sp = 0;
+	stack[sp++].pc = pc;
+
+	while (sp > 0) {
+		gbreInst *inst;
+		pc = stack[--sp].pc;
+		if (gbre__set_has(&m->set, pc))
+			continue;
+		gbre__set_add(&m->set, pc);
+		inst = &m->insts[pc];
+
+		switch (inst->kind) {
+		case GBRE_INST_JUMP:
+			stack[sp++].pc = inst->x;
+			break;
+		case GBRE_INST_SPLIT:
+			stack[sp++].pc = inst->y;
+			stack[sp++].pc = inst->x;
+			break;
+		case GBRE_INST_SAVE:
+			stack[sp++].pc = pc+1;
+			break;
+		case GBRE_INST_BEGINNING_OF_LINE:
+			if (at_beginning)
+				stack[sp++].pc = pc+1;
+			break;
+		case GBRE_INST_END_OF_LINE:
+			if (at_end)
+				stack[sp++].pc = pc+1;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+static void gbre__dfa_reset(gbreMachine *m) {
+	memset(m->table, 0, (m->table_mask+1) * gbre_size_of(int));
+	m->state_count = 0;
+	m->pc_count = 0;
+	m->reset_count++;
+}
+
+static gbreBool gbre__dfa_init(gbreMachine *m) {
+#if !defined(GBRE_NO_MALLOC)
+	isize table_count = 1, total;
+	unsigned char *cursor;
+	while (table_count < 2*GBRE_DFA_MAX_STATES)
+		table_count <<= 1;
+
+	m->pc_cap = GBRE_DFA_MAX_STATES*16 + 2*m->inst_count;
+	total = GBRE_DFA_MAX_STATES * gbre_size_of(gbreDfaState) + 16*4
+	      + m->pc_cap * gbre_size_of(int)
+	      + table_count * gbre_size_of(int);
+	cursor = (unsigned char *)GBRE_MALLOC(total);
+	if (!cursor) return GBRE_FALSE;
+
+	m->states     = (gbreDfaState *)gbre__carve(&cursor, GBRE_DFA_MAX_STATES * gbre_size_of(gbreDfaState));
+	m->pcs        = (int *)gbre__carve(&cursor, m->pc_cap * gbre_size_of(int));
+	m->table      = (int *)gbre__carve(&cursor, table_count * gbre_size_of(int));
+	m->table_mask = (int)table_count - 1;
+	gbre__dfa_reset(m);
+
+	/* NOTE(bill): Once nothing is left and a new thread cannot start (e.g. ^abc) there is no match */
+	m->set.count = 0;
+	gbre__dfa_closure(m, 0, GBRE_FALSE, GBRE_FALSE);
+	m->search_can_die = GBRE_TRUE;
+	m->start_count = 0;
+	{
+		int pc;
+		for (pc = 0; pc < m->inst_count; pc++) {
+			int kind;
+			if (!gbre__set_has(&m->set, pc))
+				continue;
+			kind = m->insts[pc].kind;
+			if (kind == GBRE_INST_BYTE || kind == GBRE_INST_CLASS || kind == GBRE_INST_MATCH || kind == GBRE_INST_END_OF_LINE)
+				m->search_can_die = GBRE_FALSE;
+			if (kind == GBRE_INST_BYTE || kind == GBRE_INST_CLASS || kind == GBRE_INST_END_OF_LINE)
+				m->start_pcs[m->start_count++] = pc;
+		}
+	}
+	return GBRE_TRUE;
+#else
+	(void)m;
+	return GBRE_FALSE;
+#endif
+}
+
+/* NOTE(bill): The state for the threads in `m->set`, only the instructions which consume
+ * input, match or wait on $ matter and they are kept in program order */
+static int gbre__dfa_state(gbreMachine *m) {
+	unsigned int hash = 2166136261u;
+	int pc, count = 0, flags = 0, index, i;
+	gbreDfaState *s;
+
+	for (pc = 0; pc < m->inst_count; pc++) {
+		if (gbre__set_has(&m->set, pc)) {
+			int kind = m->insts[pc].kind;
+			if (kind == GBRE_INST_MATCH)       flags |= GBRE__DFA_MATCH;
+			if (kind == GBRE_INST_END_OF_LINE) flags |= GBRE__DFA_END_OF_LINE;
+			if (kind == GBRE_INST_BYTE || kind == GBRE_INST_CLASS || kind == GBRE_INST_END_OF_LINE) {
+				m->temp[count++] = pc;
+				hash = (hash ^ (unsigned int)pc) * 16777619u;
+			}
+		}
+	}
+	if (!(flags & GBRE__DFA_MATCH) && count == m->start_count &&
+	    memcmp(m->temp, m->start_pcs, count * gbre_size_of(int)) == 0)
+		flags |= GBRE__DFA_START;
+	hash = (hash ^ (unsigned int)flags) * 16777619u;
+
+	for (i = (int)(hash & (unsigned int)m->table_mask); m->table[i]; i = (i+1) & m->table_mask) {
+		s = &m->states[m->table[i]-1];
+		if (s->hash == hash && s->flags == flags && s->pc_count == count &&
+		    memcmp(m->pcs + s->pc_offset, m->temp, count * gbre_size_of(int)) == 0)
+			return m->table[i]-1;
+	}
+
+	if (m->state_count == GBRE_DFA_MAX_STATES || m->pc_count + count > m->pc_cap) {
+		/* NOTE(bill): The cache is full, start again from this state */
+		gbre__dfa_reset(m);
+		i = (int)(hash & (unsigned int)m->table_mask);
+	}
+
+	index = m->state_count++;
+	s = &m->states[index];
+	memset(s->next, 0xff, gbre_size_of(s->next));
+	s->pc_offset = m->pc_count;
+	s->pc_count  = count;
+	s->flags     = flags;
+	s->hash      = hash;
+	memcpy(m->pcs + m->pc_count, m->temp, count * gbre_size_of(int));
+	m->pc_count += count;
+	m->table[i] = index+1;
+	return index;
+}
+
+static int gbre__dfa_step(gbreMachine *m, int state, unsigned char c) {
+	gbreDfaState *s = &m->states[state];
+	int *pcs = m->pcs + s->pc_offset;
+	int i, next, reset_count = m->reset_count;
+
+	m->set.count = 0;
+	for (i = 0; i < s->pc_count; i++) {
+		gbreInst *inst = &m->insts[pcs[i]];
+		if ((inst->kind == GBRE_INST_BYTE  && inst->x == c) ||
+		    (inst->kind == GBRE_INST_CLASS && gbre__class_has(m, inst->x, c))) {
+			gbre__dfa_closure(m, pcs[i]+1, GBRE_FALSE, GBRE_FALSE);
+		}
+	}
+	/* NOTE(bill): A new thread may start at every offset */
+	gbre__dfa_closure(m, 0, GBRE_FALSE, GBRE_FALSE);
+
+	next = gbre__dfa_state(m);
+	if (reset_count == m->reset_count)
+		m->states[state].next[c] = next;
+	return next;
+}
+
+static int gbre__dfa_start(gbreMachine *m, gbreBool at_beginning) {
+	m->set.count = 0;
+	gbre__dfa_closure(m, 0, at_beginning, GBRE_FALSE);
+	return gbre__dfa_state(m);
+}
+
+static gbreBool gbre__dfa_dead(gbreMachine *m, int state) {
+	return m->search_can_die && m->states[state].pc_count == 0;
+}
+
+/* NOTE(bill): Steps over `str` from `*offset` until the state matches, dies or the text ends.
+ * `*offset` is left where it stopped. */
+static int gbre__dfa_run(gbreMachine *m, int state, char const *str, isize *offset, isize len) {
+	isize at = *offset;
+	while (at < len) {
+		gbreDfaState *s = &m->states[state];
+		int next;
+		if (s->flags & GBRE__DFA_MATCH)
+			break;
+		if (gbre__dfa_dead(m, state))
+			break;
+		if ((s->flags & GBRE__DFA_START) && m->prefix_len > 0) {
+			at = gbre__skip_to_prefix(m, str, at, len);
+			if (at >= len)
+				break;
+		}
+		next = s->next[(unsigned char)str[at]];
+		if (next < 0)
+			next = gbre__dfa_step(m, state, (unsigned char)str[at]);
+		state = next;
+		at++;
+	}
+	*offset = at;
+	return state;
+}
+
+/* NOTE(bill): At the end of the text so $ holds */
+static gbreBool gbre__dfa_end(gbreMachine *m, int state, gbreBool at_beginning) {
+	gbreDfaState *s = &m->states[state];
+	int i;
+
+	if (s->flags & GBRE__DFA_MATCH)
+		return GBRE_TRUE;
+	if (!(s->flags & GBRE__DFA_END_OF_LINE))
+		return GBRE_FALSE;
+
+	m->set.count = 0;
+	for (i = 0; i < s->pc_count; i++) {
+		int pc = m->pcs[s->pc_offset + i];
+		if (m->insts[pc].kind == GBRE_INST_END_OF_LINE)
+			gbre__dfa_closure(m, pc+1, at_beginning, GBRE_TRUE);
+	}
+	for (i = 0; i < m->set.count; i++) {
+		if (m->insts[m->set.dense[i]].kind == GBRE_INST_MATCH)
+			return GBRE_TRUE;
+	}
+	return GBRE_FALSE;
+}
+
+/* NOTE(bill): 1 if there is a match starting at or after `from`, 0 if not and -1 if the
+ * DFA is not available */
+static int gbre__dfa_search(gbreMachine *m, char const *str, isize len, isize from) {
+	isize offset = from;
+	int state;
+
+	if (!m->states && !gbre__dfa_init(m))
+		return -1;
+
+	state = gbre__dfa_start(m, from == 0);
+	state = gbre__dfa_run(m, state, str, &offset, len);
+	if (m->states[state].flags & GBRE__DFA_MATCH)
+		return 1;
+	if (offset < len)
+		return 0;
+	return gbre__dfa_end(m, state, len == 0);
+}
+
+
 gbreError gbre_compile_from_buffer(gbRegex *re, char const *pattern, isize pattern_len, void *buffer, isize buffer_len) {
 	gbreError err;
 	re->capture_count = 0;
@@ -904,8 +1916,15 @@ gbreError gbre_compile_from_buffer(gbRegex *re, char const *pattern, isize patte
 	re->buf_len       = 0;
 	re->buf_cap       = buffer_len;
 	re->can_realloc   = GBRE_FALSE;
+	re->machine       = NULL;
+	re->prefix        = re->prefix_len  = 0;
+	re->literal       = re->literal_len = 0;
 
 	err = gbre__parse(re, pattern, pattern_len, 0, 0, 0);
+	if (!err) {
+		gbre__find_literals(re);
+		re->machine = gbre__machine_make(re);
+	}
 	return err;
 }
 
@@ -920,17 +1939,29 @@ gbreError gbre_compile(gbRegex *re, char const *pattern, isize len) {
 	re->buf_len       = 0;
 	re->buf_cap       = cap;
 	re->can_realloc   = GBRE_TRUE;
+	re->machine       = NULL;
+	re->prefix        = re->prefix_len  = 0;
+	re->literal       = re->literal_len = 0;
 
 
 	err = gbre__parse(re, pattern, len, 0, 0, &offset);
-	if (offset != len)
+	if (err || offset != len) {
 		GBRE_FREE(re->buf);
+		re->buf = NULL;
+		re->buf_len = 0;
+	} else {
+		gbre__find_literals(re);
+		re->machine = gbre__machine_make(re);
+	}
 	return err;
 }
 #endif
 void gbre_destroy(gbRegex *re) {
 	(void)gbre_size_of(re);
 
+	gbre__machine_free(re->machine);
+	re->machine = NULL;
+
 #if !defined(GBRE_NO_MALLOC)
 	if (re->can_realloc && re->buf) {
 		GBRE_FREE(re->buf);
@@ -941,25 +1972,231 @@ void gbre_destroy(gbRegex *re) {
 
 isize gbre_capture_count(gbRegex *re) { return re->capture_count; }
 
-gbreBool gbre_match(gbRegex *re, char const *str, isize len, gbreCapture *captures, isize max_capture_count) {
-	if (re && re->buf_len > 0) {
-		if (re->buf[0] == GBRE_OP_BEGINNING_OF_LINE) {
-			gbreContext c = gbre__exec(re, 0, str, len, 0, captures, max_capture_count);
-			if (c.offset >= 0 && c.offset <= len)   return GBRE_TRUE;
+/* NOTE(bill): The original recursive matcher, for when there is no machine */
+static gbreBool gbre__backtrack_match(gbRegex *re, char const *str, isize len, isize from,
+                                      gbreCapture *captures, isize max_capture_count, isize *span) {
+	isize i;
+	if (re->buf[0] == GBRE_OP_BEGINNING_OF_LINE) {
+		gbreContext c;
+		if (from > 0)
+			return GBRE_FALSE;
+		c = gbre__exec(re, 0, str, len, 0, captures, max_capture_count);
+		if (c.offset >= 0 && c.offset <= len) {
+			if (span) span[0] = 0, span[1] = c.offset;
+			return GBRE_TRUE;
+		}
+		if (c.offset == GBRE__INTERNAL_FAILURE) return GBRE_FALSE;
+	} else {
+		unsigned char const *prefix = re->buf + re->prefix;
+		isize rare = gbre__rare_byte(prefix, re->prefix_len);
+		for (i = from; i < len; i++) {
+			gbreContext c;
+			if (re->prefix_len > 0) {
+				i = gbre__memmem(str, i, len, prefix, re->prefix_len, rare);
+				if (i < 0)
+					break;
+			}
+			c = gbre__exec(re, 0, str, len, i, captures, max_capture_count);
+			if (c.offset >= 0 && c.offset <= len) {
+				if (span) span[0] = i, span[1] = c.offset;
+				return GBRE_TRUE;
+			}
 			if (c.offset == GBRE__INTERNAL_FAILURE) return GBRE_FALSE;
+		}
+	}
+	return GBRE_FALSE;
+}
+
+#ifndef GBRE__TEMP_DFA_MIN_LEN
+#define GBRE__TEMP_DFA_MIN_LEN 1024
+#endif
+#define GBRE__LOCAL_SCRATCH_SIZE 4096
+
+/* NOTE(bill): The leftmost match starting at or after `from`, its bounds go in `span` when given */
+static gbreBool gbre__search(gbRegex *re, gbreScratch *scratch, char const *str, isize len, isize from,
+                             gbreCapture *captures, isize max_capture_count, isize *span) {
+#if !defined(GBRE_NO_MALLOC)
+	union { void *p; isize i; unsigned char bytes[GBRE__LOCAL_SCRATCH_SIZE]; } local;
+#endif
+	gbreScratch *temp = NULL;
+	gbreMachine *m;
+	gbreBool result = GBRE_FALSE, temp_on_heap = GBRE_FALSE;
+	isize i;
+	int found = -1;
+
+	if (re->literal_len > 0 &&
+	    gbre__memmem(str, from, len, re->buf + re->literal, re->literal_len,
+	                 gbre__rare_byte(re->buf + re->literal, re->literal_len)) < 0)
+		return GBRE_FALSE;
+
+	if (!re->machine)
+		return gbre__backtrack_match(re, str, len, from, captures, max_capture_count, span);
+	if (!scratch) {
+#if !defined(GBRE_NO_MALLOC)
+		/* NOTE(bill): Nothing is shared between calls, small programs do not even need the heap */
+		if (gbre__scratch_size(re->machine) <= gbre_size_of(local)) {
+			temp = gbre__scratch_init(re->machine, &local);
 		} else {
-			isize i;
-			for (i = 0; i < len; i++) {
-				gbreContext c = gbre__exec(re, 0, str, len, i, captures, max_capture_count);
-				if (c.offset >= 0 && c.offset <= len)   return GBRE_TRUE;
-				if (c.offset == GBRE__INTERNAL_FAILURE) return GBRE_FALSE;
-			}
+			temp = gbre__scratch_make(re);
+			temp_on_heap = GBRE_TRUE;
+		}
+#endif
+		if (!temp)
+			return gbre__backtrack_match(re, str, len, from, captures, max_capture_count, span);
+		scratch = temp;
+	}
+	m = &scratch->machine;
+
+	/* NOTE(bill): A scratch for just this call starts without any DFA states, which only pays off
+	 * on a long text */
+	if (!temp || len - from >= GBRE__TEMP_DFA_MIN_LEN)
+		found = gbre__dfa_search(m, str, len, from);
+	if (found == 0)
+		goto done;
+	if (found > 0 && !span && (!captures || max_capture_count <= 0)) {
+		result = GBRE_TRUE;
+		goto done;
+	}
+	if (!gbre__pike_search(m, str, len, from))
+		goto done;
+	result = GBRE_TRUE;
+
+	for (i = 0; i < max_capture_count; i++) {
+		isize start = -1, end = -1;
+		if (i < re->capture_count) {
+			start = m->match_slots[2 + 2*i];
+			end   = m->match_slots[3 + 2*i];
+		}
+		if (start >= 0 && end >= start) {
+			captures[i].str = str + start;
+			captures[i].len = end - start;
+		} else {
+			captures[i].str = NULL;
+			captures[i].len = 0;
 		}
+	}
+	if (span) {
+		span[0] = m->match_slots[0];
+		span[1] = m->match_slots[1];
+	}
+
+done:
+	gbre__scratch_free(temp, temp_on_heap);
+	return result;
+}
+
+gbreBool gbre_match(gbRegex *re, char const *str, isize len, gbreCapture *captures, isize max_capture_count) {
+	return gbre_match_scratch(re, NULL, str, len, captures, max_capture_count);
+}
+
+gbreBool gbre_match_scratch(gbRegex *re, gbreScratch *scratch, char const *str, isize len, gbreCapture *captures, isize max_capture_count) {
+	if (re && re->buf_len > 0)
+		return gbre__search(re, scratch, str, len, 0, captures, max_capture_count, NULL);
+	return GBRE_TRUE;
+}
+
+#if !defined(GBRE_NO_MALLOC)
+gbreScratch *gbre_scratch_make(gbRegex *re) { return re ? gbre__scratch_make(re) : NULL; }
+void         gbre_scratch_free(gbreScratch *scratch) { gbre__scratch_free(scratch, GBRE_TRUE); }
+#endif
+
+
+void gbre_iter_init(gbreIter *it, gbRegex *re, char const *str, isize str_len) {
+	it->re        = re;
+	it->scratch   = NULL;
+	it->str       = str;
+	it->str_len   = str_len;
+	it->offset    = 0;
+	it->match.str = NULL;
+	it->match.len = 0;
+}
+
+gbreBool gbre_iter_next(gbreIter *it, gbreCapture *captures, isize max_capture_count) {
+	isize span[2];
+	if (!it->re || it->offset > it->str_len)
+		return GBRE_FALSE;
+	if (!gbre__search(it->re, it->scratch, it->str, it->str_len, it->offset, captures, max_capture_count, span)) {
+		it->offset = it->str_len+1;
 		return GBRE_FALSE;
 	}
+	it->match.str = it->str + span[0];
+	it->match.len = span[1] - span[0];
+	/* NOTE(bill): An empty match would be found again */
+	it->offset = span[1] > span[0] ? span[1] : span[1]+1;
 	return GBRE_TRUE;
 }
 
+isize gbre_find_all(gbRegex *re, char const *str, isize str_len, gbreCapture *matches, isize max_match_count) {
+	gbreIter it;
+	isize count = 0;
+	gbre_iter_init(&it, re, str, str_len);
+	if (re)
+		it.scratch = gbre__scratch_make(re);
+	while (gbre_iter_next(&it, NULL, 0)) {
+		if (matches && count < max_match_count)
+			matches[count] = it.match;
+		count++;
+	}
+	gbre__scratch_free(it.scratch, GBRE_TRUE);
+	return count;
+}
+
+
+#if !defined(GBRE_NO_MALLOC)
+gbreBool gbre_stream_init(gbreStream *s, gbRegex *re) {
+	gbreMachine *m;
+	s->re        = re;
+	s->scratch   = NULL;
+	s->offset    = 0;
+	s->match_end = -1;
+	s->state     = 0;
+
+	if (!re || !re->buf)
+		return GBRE_FALSE;
+	s->scratch = gbre__scratch_make(re);
+	if (!s->scratch)
+		return GBRE_FALSE;
+	m = &s->scratch->machine;
+	if (!gbre__dfa_init(m)) {
+		gbre_stream_destroy(s);
+		return GBRE_FALSE;
+	}
+	s->state = gbre__dfa_start(m, GBRE_TRUE);
+	return GBRE_TRUE;
+}
+
+gbreBool gbre_stream_feed(gbreStream *s, char const *chunk, isize chunk_len) {
+	gbreMachine *m;
+	isize at = 0;
+
+	if (!s->scratch)
+		return GBRE_FALSE;
+	if (s->match_end >= 0)
+		return GBRE_TRUE;
+	m = &s->scratch->machine;
+
+	s->state = gbre__dfa_run(m, s->state, chunk, &at, chunk_len);
+	if (m->states[s->state].flags & GBRE__DFA_MATCH)
+		s->match_end = s->offset + at;
+	s->offset += chunk_len;
+	return s->match_end >= 0;
+}
+
+gbreBool gbre_stream_finish(gbreStream *s) {
+	if (!s->scratch)
+		return GBRE_FALSE;
+	if (s->match_end >= 0)
+		return GBRE_TRUE;
+	if (gbre__dfa_end(&s->scratch->machine, s->state, s->offset == 0))
+		s->match_end = s->offset;
+	return s->match_end >= 0;
+}
+
+void gbre_stream_destroy(gbreStream *s) {
+	gbre__scratch_free(s->scratch, GBRE_TRUE);
+	s->scratch = NULL;
+}
+#endif
 
 #if defined(__cplusplus)
 }
@@ -1,7 +1,8 @@
-/* gb_string.h - v0.95a - public domain string library - no warranty implied; use at your own risk
+/* gb_string.h - v0.96  - public domain string library - no warranty implied; use at your own risk
 	A Simple Dynamic Strings Library for C and C++
 
 	Version History:
+		0.96  - Geometric growth, gb_string_reserve, buffer backed strings and string interning
 		0.95a - Change brace style because why not?
 		0.95  - C90 Support
 	    0.94  - Remove "declare anywhere"
@@ -31,6 +32,9 @@
 
 	    You can #define GB_ALLOC, and GB_FREE to avoid using malloc,free.
 
+    You can #define GB_STRING_GROW_FORMULA(cap) to change how the capacity grows
+    when a string runs out of space (default: 2*cap + 8).
+
 	    If you prefer to use C++, you can use all the same functions in a
 	    namespace instead, do this:
 	        #define GB_STRING_CPP
@@ -151,6 +155,26 @@ int main(int argc, char **argv) {
 	gb_free_string(str);
 	gb_free_string(other_str);
 
+	{
+		/* Short strings can live in a caller provided buffer and will only be
+		 * moved to the heap once they outgrow it */
+		char buffer[64];
+		gbString small = gb_make_string_in_buffer(buffer, sizeof(buffer), "Hello");
+		small = gb_append_cstring(small, ", world!");
+		gb_free_string(small); /* Does nothing if it never left the buffer */
+	}
+
+	{
+		/* Interned strings with the same contents are the same pointer */
+		gbStringInterner interner;
+		gbString a, b;
+		gb_init_string_interner(&interner);
+		a = gb_intern_cstring(&interner, "identifier");
+		b = gb_intern_cstring(&interner, "identifier");
+		if (a == b)
+			printf("Same string\n");
+		gb_destroy_string_interner(&interner);
+	}
 }
 #endif
 
@@ -202,6 +226,10 @@ int main(int argc, char **argv) {
 #define GB_FREE(ptr) free(ptr)
 #endif
 
+#ifndef GB_STRING_GROW_FORMULA
+#define GB_STRING_GROW_FORMULA(x) (2*(x) + 8)
+#endif
+
 #ifndef _MSC_VER
 	#ifdef __cplusplus
 	#define gb_inline inline
@@ -246,12 +274,17 @@ typedef size_t gbUsize;
 typedef struct gbStringHeader {
 	gbUsize len;
 	gbUsize cap;
+	gbBool  in_buffer; /* Memory is owned by the user, see gb_make_string_in_buffer */
 } gbStringHeader;
 
 #define GB_STRING_HEADER(s) ((gbStringHeader *)s - 1)
 
 gbString gb_make_string(char const *str);
 gbString gb_make_string_length(void const *str, gbUsize len);
+/* NOTE: Places the string in the user's buffer if it fits (else it is allocated)
+ * The string is moved to allocated memory once it outgrows the buffer
+ * gb_free_string does nothing to a string that is still in its buffer */
+gbString gb_make_string_in_buffer(void *buffer, gbUsize buffer_size, char const *str);
 void gb_free_string(gbString str);
 
 gbString gb_duplicate_string(gbString const str);
@@ -269,6 +302,7 @@ gbString gb_append_cstring(gbString str, char const *other);
 gbString gb_set_string(gbString str, char const *cstr);
 
 gbString gb_string_make_space_for(gbString str, gbUsize add_len);
+gbString gb_string_reserve(gbString str, gbUsize capacity);
 gbUsize gb_string_allocation_size(gbString const str);
 
 gbBool gb_strings_are_equal(gbString const lhs, gbString const rhs);
@@ -276,6 +310,22 @@ gbBool gb_strings_are_equal(gbString const lhs, gbString const rhs);
 gbString gb_trim_string(gbString str, char const *cut_set);
 
 
+/* String Interning
+ * Each distinct string is stored once so interned strings can be compared by pointer
+ * Interned strings are owned by the interner and must not be modified or freed */
+typedef struct gbStringInterner {
+	gbString *slots;
+	gbUsize   count;
+	gbUsize   capacity; /* NOTE: Always zero or a power of two */
+} gbStringInterner;
+
+void gb_init_string_interner(gbStringInterner *interner);
+void gb_destroy_string_interner(gbStringInterner *interner);
+
+gbString gb_intern_string_length(gbStringInterner *interner, void const *str, gbUsize len);
+gbString gb_intern_cstring(gbStringInterner *interner, char const *str);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -290,9 +340,11 @@ namespace gb
 {
 typedef gbString String;
 typedef gbUsize usize;
+typedef gbStringInterner StringInterner;
 
 gb_inline String make_string(char const *str = "") { return gb_make_string(str); }
 gb_inline String make_string(void const *str, usize len) { return gb_make_string_length(str, len); }
+gb_inline String make_string_in_buffer(void *buffer, usize buffer_size, char const *str = "") { return gb_make_string_in_buffer(buffer, buffer_size, str); }
 gb_inline void free_string(String& str) { gb_free_string(str); str = GB_NULLPTR; }
 gb_inline String duplicate_string(const String str) { return gb_duplicate_string(str); }
 gb_inline usize string_length(const String str) { return gb_string_length(str); }
@@ -304,9 +356,14 @@ gb_inline void append_string(String& str, const String other) { str = gb_append_
 gb_inline void append_cstring(String& str, char const *other) { str = gb_append_cstring(str, other); }
 gb_inline void set_string(String& str, char const *cstr) { str = gb_set_string(str, cstr); }
 gb_inline void string_make_space_for(String& str, usize add_len) { str = gb_string_make_space_for(str, add_len); }
+gb_inline void string_reserve(String& str, usize capacity) { str = gb_string_reserve(str, capacity); }
 gb_inline usize string_allocation_size(const String str) { return gb_string_allocation_size(str); }
 gb_inline bool strings_are_equal(const String lhs, const String rhs) { return gb_strings_are_equal(lhs, rhs) == GB_TRUE; }
 gb_inline void trim_string(String& str, char const *cut_set) { str = gb_trim_string(str, cut_set); }
+gb_inline void init_string_interner(StringInterner *interner) { gb_init_string_interner(interner); }
+gb_inline void destroy_string_interner(StringInterner *interner) { gb_destroy_string_interner(interner); }
+gb_inline String intern_string(StringInterner *interner, void const *str, usize len) { return gb_intern_string_length(interner, str, len); }
+gb_inline String intern_cstring(StringInterner *interner, char const *str) { return gb_intern_cstring(interner, str); }
 } /* namespace gb */
 #endif /* GB_STRING_CPP */
 #endif /* GB_STRING_H */
@@ -325,16 +382,17 @@ gbString gb_make_string_length(void const *init_str, gbUsize len) {
 	gbStringHeader *header;
 	gbUsize header_size = sizeof(gbStringHeader);
 	void *ptr = GB_ALLOC(header_size + len + 1);
-	if (!init_str)
-		memset(ptr, 0, header_size + len + 1);
-
 	if (ptr == GB_NULLPTR)
 		return GB_NULLPTR;
 
+	if (!init_str)
+		memset(ptr, 0, header_size + len + 1);
+
 	str = (char *)ptr + header_size;
 	header = GB_STRING_HEADER(str);
 	header->len = len;
 	header->cap = len;
+	header->in_buffer = GB_FALSE;
 	if (len && init_str)
 		memcpy(str, init_str, len);
 	str[len] = '\0';
@@ -342,13 +400,35 @@ gbString gb_make_string_length(void const *init_str, gbUsize len) {
 	return str;
 }
 
+gbString gb_make_string_in_buffer(void *buffer, gbUsize buffer_size, char const *init_str) {
+	gbString str;
+	gbStringHeader *header;
+	gbUsize len = init_str ? strlen(init_str) : 0;
+	/* NOTE: Align the header to a gbUsize as the buffer may be a char array */
+	gbUsize offset = (gbUsize)(-(gbUsize)buffer) & (sizeof(gbUsize)-1);
+
+	if (buffer == GB_NULLPTR || buffer_size < offset + sizeof(gbStringHeader) + len + 1)
+		return gb_make_string_length(init_str, len);
+
+	str = (char *)buffer + offset + sizeof(gbStringHeader);
+	header = GB_STRING_HEADER(str);
+	header->len = len;
+	header->cap = buffer_size - offset - sizeof(gbStringHeader) - 1;
+	header->in_buffer = GB_TRUE;
+	if (len)
+		memcpy(str, init_str, len);
+	str[len] = '\0';
+
+	return str;
+}
+
 gbString gb_make_string(char const *str) {
 	gbUsize len = str ? strlen(str) : 0;
 	return gb_make_string_length(str, len);
 }
 
 void gb_free_string(gbString str) {
-	if (str == GB_NULLPTR)
+	if (str == GB_NULLPTR || GB_STRING_HEADER(str)->in_buffer)
 		return;
 
 	GB_FREE((gbStringHeader *)str - 1);
@@ -415,51 +495,44 @@ gbString gb_set_string(gbString str, char const *cstr) {
 	return str;
 }
 
-static gb_inline void *gb__string_realloc(void *ptr, gbUsize old_size, gbUsize new_size) {
+gbString gb_string_reserve(gbString str, gbUsize capacity) {
+	gbUsize len = gb_string_length(str);
+	gbStringHeader *header = GB_STRING_HEADER(str);
 	void *new_ptr;
-	if (!ptr)
-		return GB_ALLOC(new_size);
-
-	if (new_size < old_size)
-		new_size = old_size;
+	gbString new_str;
 
-	if (old_size == new_size)
-		return ptr;
+	if (header->cap >= capacity)
+		return str;
 
-	new_ptr = GB_ALLOC(new_size);
-	if (!new_ptr)
+	/* NOTE: realloc is not used so that GB_ALLOC and GB_FREE are all that is needed */
+	new_ptr = GB_ALLOC(sizeof(gbStringHeader) + capacity + 1);
+	if (new_ptr == GB_NULLPTR)
 		return GB_NULLPTR;
 
-	memcpy(new_ptr, ptr, old_size);
+	new_str = (char *)new_ptr + sizeof(gbStringHeader);
+	memcpy(new_str, str, len + 1);
+	gb_set_string_length(new_str, len);
+	gb_set_string_capacity(new_str, capacity);
+	GB_STRING_HEADER(new_str)->in_buffer = GB_FALSE;
 
-	GB_FREE(ptr);
+	gb_free_string(str);
 
-	return new_ptr;
+	return new_str;
 }
 
 gbString gb_string_make_space_for(gbString str, gbUsize add_len) {
-	gbUsize len = gb_string_length(str);
-	gbUsize new_len = len + add_len;
-	void *ptr, *new_ptr;
-	gbUsize available, old_size, new_size;
+	gbUsize new_len = gb_string_length(str) + add_len;
+	gbUsize new_cap;
 
-	available = gb_string_available_space(str);
-	if (available >= add_len) /* Return if there is enough space left */
+	if (gb_string_available_space(str) >= add_len) /* Return if there is enough space left */
 		return str;
 
+	/* NOTE: Grow geometrically so that repeated appends are amortized O(1) */
+	new_cap = GB_STRING_GROW_FORMULA(gb_string_capacity(str));
+	if (new_cap < new_len)
+		new_cap = new_len;
 
-	ptr = (char *)str - sizeof(gbStringHeader);
-	old_size = sizeof(gbStringHeader) + gb_string_length(str) + 1;
-	new_size = sizeof(gbStringHeader) + new_len + 1;
-
-	new_ptr = gb__string_realloc(ptr, old_size, new_size);
-	if (new_ptr == GB_NULLPTR)
-		return GB_NULLPTR;
-	str = (char *)new_ptr + sizeof(gbStringHeader);
-
-	gb_set_string_capacity(str, new_len);
-
-	return str;
+	return gb_string_reserve(str, new_cap);
 }
 
 gbUsize gb_string_allocation_size(gbString const s) {
@@ -506,6 +579,93 @@ gbString gb_trim_string(gbString str, char const *cut_set) {
 }
 
 
+static gbUsize gb__string_hash(void const *str, gbUsize len) {
+	/* NOTE: FNV-1a */
+	unsigned char const *s = (unsigned char const *)str;
+	unsigned long hash = 2166136261ul;
+	gbUsize i;
+	for (i = 0; i < len; i++) {
+		hash ^= s[i];
+		hash *= 16777619ul;
+		hash &= 0xfffffffful;
+	}
+	return (gbUsize)hash;
+}
+
+static gbString *gb__string_interner_slot(gbString *slots, gbUsize capacity, void const *str, gbUsize len) {
+	gbUsize mask = capacity - 1;
+	gbUsize index = gb__string_hash(str, len) & mask;
+	for (;;) {
+		gbString slot = slots[index];
+		if (slot == GB_NULLPTR)
+			return &slots[index];
+		if (gb_string_length(slot) == len && memcmp(slot, str, len) == 0)
+			return &slots[index];
+		index = (index + 1) & mask;
+	}
+}
+
+static gbBool gb__string_interner_grow(gbStringInterner *interner) {
+	gbUsize new_capacity = interner->capacity ? 2*interner->capacity : 64;
+	gbString *new_slots = (gbString *)GB_ALLOC(new_capacity * sizeof(gbString));
+	gbUsize i;
+	if (new_slots == GB_NULLPTR)
+		return GB_FALSE;
+	memset(new_slots, 0, new_capacity * sizeof(gbString));
+
+	for (i = 0; i < interner->capacity; i++) {
+		gbString str = interner->slots[i];
+		if (str != GB_NULLPTR)
+			*gb__string_interner_slot(new_slots, new_capacity, str, gb_string_length(str)) = str;
+	}
+
+	if (interner->slots != GB_NULLPTR)
+		GB_FREE(interner->slots);
+	interner->slots    = new_slots;
+	interner->capacity = new_capacity;
+	return GB_TRUE;
+}
+
+void gb_init_string_interner(gbStringInterner *interner) {
+	interner->slots    = GB_NULLPTR;
+	interner->count    = 0;
+	interner->capacity = 0;
+}
+
+void gb_destroy_string_interner(gbStringInterner *interner) {
+	gbUsize i;
+	for (i = 0; i < interner->capacity; i++)
+		gb_free_string(interner->slots[i]);
+	if (interner->slots != GB_NULLPTR)
+		GB_FREE(interner->slots);
+	gb_init_string_interner(interner);
+}
+
+gbString gb_intern_string_length(gbStringInterner *interner, void const *str, gbUsize len) {
+	gbString *slot;
+
+	/* NOTE: Keep the load factor at or below 1/2 */
+	if (2*(interner->count + 1) > interner->capacity) {
+		if (!gb__string_interner_grow(interner))
+			return GB_NULLPTR;
+	}
+
+	slot = gb__string_interner_slot(interner->slots, interner->capacity, str, len);
+	if (*slot == GB_NULLPTR) {
+		*slot = gb_make_string_length(str, len);
+		if (*slot == GB_NULLPTR)
+			return GB_NULLPTR;
+		interner->count++;
+	}
+
+	return *slot;
+}
+
+gbString gb_intern_cstring(gbStringInterner *interner, char const *str) {
+	return gb_intern_string_length(interner, str, strlen(str));
+}
+
+
 
 #endif /* GB_STRING_IMPLEMENTATION */
 